@@ -70,5 +70,9 @@
 			int *piType,
 			int *piSubtype);
 
+	int meRQueryTopology(char *location, char *pcBuffer, int *piSize);
+	int meRQueryDiscover(meRQueryHost_t *pHosts, int iCount, int iTimeout);
+	int meRQueryDiscoverFree(meRQueryHost_t *pHosts, int iCount);
+	int meRQueryClose(char *location);
 
 #endif
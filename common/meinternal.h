@@ -670,5 +670,10 @@
 #define MEFF00_NAME_DEVICE_MEFF00			"ME-FPGA"
 #define MEFF00_DESCRIPTION_DEVICE_MEFF00	"ME-FPGA, FPGA board."
 
+/* Virtual loopback board (no hardware) defines */
+#define PCI_DEVICE_ID_MEILHAUS_MEVIRTUAL	0xFFF0
+#define MEVIRTUAL_NAME_DEVICE				"ME-VIRTUAL"
+#define MEVIRTUAL_DESCRIPTION_DEVICE		"ME-VIRTUAL loopback device, timer driven analog inputs and outputs, digital i/o lines, external interrupt."
+
 
 #endif
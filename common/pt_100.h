@@ -173,7 +173,7 @@ static double pt_100[] =
     81.894,
     82.290,
     82.687,
-    82.083,
+    83.083,
     83.479,
     83.875,
     84.271,
@@ -0,0 +1,644 @@
+/*
+ * Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * Source File : convert.tst.c
+ *
+ * Checks and benchmark for batch conversion utilities. No hardware needed.
+ * Batch results are compared with the scalar utilities first (exit code 1 on mismatch).
+ * Temperature conversion is checked against the sensor tables over their full range.
+ * meUtilityDeinterleave() is checked value by value against meUtilityExtractValues().
+ * Then prints conversions per second for 1M-sample buffers.
+ *
+ * Author      : KG (Krzysztof Gantzke)     <k.gantzke@meilhaus.de>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+#include <medriver.h>
+
+#include "../common/pt_100.h"
+#include "../common/te_type_b.h"
+#include "../common/te_type_e.h"
+#include "../common/te_type_j.h"
+#include "../common/te_type_k.h"
+#include "../common/te_type_n.h"
+#include "../common/te_type_r.h"
+#include "../common/te_type_s.h"
+#include "../common/te_type_t.h"
+
+#define BufferSize	0x100000
+#define Loops		20
+
+#define MinValue	-10.0
+#define MaxValue	10.0
+#define MaxData		0xFFFF
+
+#define Channels	32
+
+/// Lengths 1..TailMax and start offsets 0..OffsetMax cover every tail of 4 (SSE2) and 8 (AVX2) wide kernels.
+#define TailMax		37
+#define OffsetMax	7
+/// Batch double result may differ from scalar one only by rounding of scale/offset (volts).
+#define ToleranceDouble	1E-9
+/// Float has 24 bit mantissa: 10 V * 2^-24 = 0.6 uV. Allowed: 2 uV.
+#define ToleranceFloat	2E-6
+#define Sentinel	-12345.0
+
+/// Temperature check: 30 bit codes, so quantization is far below table's resolution.
+#define TempMaxData		0x3FFFFFFF
+/// Steps per degree of the temperature sweep.
+#define TempSteps		10
+/// Allowed error: half of code's step seen through local table slope plus this (degree Celsius).
+#define ToleranceTemp	1E-6
+/// Default RTD current (meUtilityDigitalToPhysical() with dRefValue=0).
+#define RTDCurrent		0.0005
+
+/// Deinterleave check: full frames, partial frame at the end and input split at odd places.
+#define DeintFrames		1000
+#define DeintRest		5
+#define DeintValues		(DeintFrames * Channels + DeintRest)
+
+#define SensorTable(table) table, sizeof(table) / sizeof(double)
+
+typedef struct
+{
+	char* name;
+	int iModuleType;
+	double* pdTable;
+	int iTableCount;
+	double dMinTemp;
+	double dScale;		// Table value (uV or ohms) to volts.
+} sensor_t;
+
+static sensor_t Sensors[] =
+{
+	{"PT100", ME_MODULE_TYPE_MULTISIG_RTD8_PT100, SensorTable(pt_100), ME_PT_100_TEMP_OFFSET, 40 * RTDCurrent},
+	{"PT500", ME_MODULE_TYPE_MULTISIG_RTD8_PT500, SensorTable(pt_100), ME_PT_100_TEMP_OFFSET, 8 * RTDCurrent},
+	{"PT1000", ME_MODULE_TYPE_MULTISIG_RTD8_PT1000, SensorTable(pt_100), ME_PT_100_TEMP_OFFSET, 4 * RTDCurrent},
+	{"TE B", ME_MODULE_TYPE_MULTISIG_TE8_TYPE_B, SensorTable(te_type_b), ME_TE_TYPE_B_MIN_TEMP, ME_TE_TYPE_B_GAIN / 1E6},
+	{"TE E", ME_MODULE_TYPE_MULTISIG_TE8_TYPE_E, SensorTable(te_type_e), ME_TE_TYPE_E_MIN_TEMP, ME_TE_TYPE_E_GAIN / 1E6},
+	{"TE J", ME_MODULE_TYPE_MULTISIG_TE8_TYPE_J, SensorTable(te_type_j), ME_TE_TYPE_J_MIN_TEMP, ME_TE_TYPE_J_GAIN / 1E6},
+	{"TE K", ME_MODULE_TYPE_MULTISIG_TE8_TYPE_K, SensorTable(te_type_k), ME_TE_TYPE_K_MIN_TEMP, ME_TE_TYPE_K_GAIN / 1E6},
+	{"TE N", ME_MODULE_TYPE_MULTISIG_TE8_TYPE_N, SensorTable(te_type_n), ME_TE_TYPE_N_MIN_TEMP, ME_TE_TYPE_N_GAIN / 1E6},
+	{"TE R", ME_MODULE_TYPE_MULTISIG_TE8_TYPE_R, SensorTable(te_type_r), ME_TE_TYPE_R_MIN_TEMP, ME_TE_TYPE_R_GAIN / 1E6},
+	{"TE S", ME_MODULE_TYPE_MULTISIG_TE8_TYPE_S, SensorTable(te_type_s), ME_TE_TYPE_S_MIN_TEMP, ME_TE_TYPE_S_GAIN / 1E6},
+	{"TE T", ME_MODULE_TYPE_MULTISIG_TE8_TYPE_T, SensorTable(te_type_t), ME_TE_TYPE_T_MIN_TEMP, ME_TE_TYPE_T_GAIN / 1E6},
+};
+
+static double elapsed(struct timespec* pre, struct timespec* post)
+{
+	return (post->tv_sec - pre->tv_sec) + (post->tv_nsec - pre->tv_nsec) / 1E9;
+}
+
+static void report(char* name, struct timespec* pre, struct timespec* post, int count)
+{
+	double t = elapsed(pre, post);
+
+	printf("%-40s %10.3f ms  %12.0f conversions/s\n", name, t * 1000 / Loops, (double)count * Loops / t);
+}
+
+static int checkVectorKernels(void)
+{
+	int piRaw[TailMax + OffsetMax];
+	int piBack[TailMax + OffsetMax + 1];
+	double pdOut[TailMax + 1];
+	float pfOut[TailMax + 1];
+	int piSaturated[] = {INT_MIN, -1, 0, MaxData, MaxData + 1, INT_MAX};
+	double pdSaturated[] = {-1E3, MinValue - 1.0, MinValue, MaxValue, MaxValue + 1.0, 1E3};
+	int piExpected[] = {0, 0, 0, MaxData, MaxData, MaxData};
+	double dScalar;
+	int iScalar;
+	int errors = 0;
+	int offset;
+	int n;
+	int i;
+
+	// Both ends of the range are in every batch.
+	for (i = 0; i < TailMax + OffsetMax; i++)
+	{
+		piRaw[i] = (i * 4099) % (MaxData + 1);
+	}
+	piRaw[0] = MaxData;
+	piRaw[TailMax + OffsetMax - 1] = 0;
+	for (i = 1; i < TailMax + OffsetMax - 1; i += 5)
+	{
+		piRaw[i] = (i % 2) ? 0 : MaxData;
+	}
+
+	for (offset = 0; offset <= OffsetMax; offset++)
+	{
+		for (n = 1; n + offset <= TailMax + OffsetMax && n <= TailMax; n++)
+		{
+			for (i = 0; i <= n; i++)
+			{
+				pdOut[i] = Sentinel;
+				pfOut[i] = Sentinel;
+				piBack[i] = -1;
+			}
+
+			meUtilityDigitalToPhysicalV(MinValue, MaxValue, MaxData, piRaw + offset, n, ME_MODULE_TYPE_MULTISIG_NONE, 0, pdOut);
+			meUtilityDigitalToPhysicalFloatV(MinValue, MaxValue, MaxData, piRaw + offset, n, ME_MODULE_TYPE_MULTISIG_NONE, 0, pfOut);
+			if ((pdOut[n] != Sentinel) || (pfOut[n] != (float)Sentinel))
+			{
+				printf("D2P: offset=%d n=%d writes behind the end.\n", offset, n);
+				errors++;
+			}
+
+			for (i = 0; i < n; i++)
+			{
+				meUtilityDigitalToPhysical(MinValue, MaxValue, MaxData, piRaw[offset + i], ME_MODULE_TYPE_MULTISIG_NONE, 0, &dScalar);
+				if ((fabs(pdOut[i] - dScalar) > ToleranceDouble) || (fabs(pfOut[i] - dScalar) > ToleranceFloat))
+				{
+					printf("D2P: offset=%d n=%d [%d] raw=%d scalar=%.9f double=%.9f float=%.9f\n", offset, n, i, piRaw[offset + i], dScalar, pdOut[i], pfOut[i]);
+					errors++;
+				}
+			}
+
+			// Physical values of raw codes must give the same codes back.
+			meUtilityPhysicalToDigitalV(MinValue, MaxValue, MaxData, pdOut, n, piBack);
+			if (piBack[n] != -1)
+			{
+				printf("P2D: offset=%d n=%d writes behind the end.\n", offset, n);
+				errors++;
+			}
+			for (i = 0; i < n; i++)
+			{
+				meUtilityPhysicalToDigital(MinValue, MaxValue, MaxData, pdOut[i], &iScalar);
+				if ((piBack[i] != piRaw[offset + i]) || (iScalar != piRaw[offset + i]))
+				{
+					printf("P2D: offset=%d n=%d [%d] raw=%d scalar=%d double=%d\n", offset, n, i, piRaw[offset + i], iScalar, piBack[i]);
+					errors++;
+				}
+			}
+
+			meUtilityPhysicalToDigitalFloatV(MinValue, MaxValue, MaxData, pfOut, n, piBack);
+			for (i = 0; i < n; i++)
+			{
+				if (piBack[i] != piRaw[offset + i])
+				{
+					printf("P2D float: offset=%d n=%d [%d] raw=%d float=%d\n", offset, n, i, piRaw[offset + i], piBack[i]);
+					errors++;
+				}
+			}
+		}
+	}
+
+	// Saturation. Scalar utilities report out of range values, batch ones clip them.
+	n = sizeof(piSaturated) / sizeof(int);
+	meUtilityDigitalToPhysicalV(MinValue, MaxValue, MaxData, piSaturated, n, ME_MODULE_TYPE_MULTISIG_NONE, 0, pdOut);
+	meUtilityDigitalToPhysicalFloatV(MinValue, MaxValue, MaxData, piSaturated, n, ME_MODULE_TYPE_MULTISIG_NONE, 0, pfOut);
+	for (i = 0; i < n; i++)
+	{
+		meUtilityDigitalToPhysical(MinValue, MaxValue, MaxData, piSaturated[i], ME_MODULE_TYPE_MULTISIG_NONE, 0, &dScalar);
+		if ((fabs(pdOut[i] - dScalar) > ToleranceDouble) || (fabs(pfOut[i] - dScalar) > ToleranceFloat))
+		{
+			printf("D2P saturation: raw=%d scalar=%.9f double=%.9f float=%.9f\n", piSaturated[i], dScalar, pdOut[i], pfOut[i]);
+			errors++;
+		}
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		pfOut[i] = pdSaturated[i];
+	}
+	meUtilityPhysicalToDigitalV(MinValue, MaxValue, MaxData, pdSaturated, n, piBack);
+	meUtilityPhysicalToDigitalFloatV(MinValue, MaxValue, MaxData, pfOut, n, piBack + n);
+	for (i = 0; i < n; i++)
+	{
+		meUtilityPhysicalToDigital(MinValue, MaxValue, MaxData, pdSaturated[i], &iScalar);
+		if ((piBack[i] != piExpected[i]) || (piBack[n + i] != piExpected[i]) || (iScalar != piExpected[i]))
+		{
+			printf("P2D saturation: physical=%f expected=%d scalar=%d double=%d float=%d\n", pdSaturated[i], piExpected[i], iScalar, piBack[i], piBack[n + i]);
+			errors++;
+		}
+	}
+
+	printf("Batch vs scalar conversion: %s (%d errors)\n", (errors) ? "FAILED" : "OK", errors);
+	return errors;
+}
+
+/// Sweeps every table from its minimum (type B dips below 0 uV near 0 C, that part is ambiguous) to its end.
+/// Expected temperature is the swept one, raw code is made from table's value interpolated at it.
+static int checkTemperature(void)
+{
+	sensor_t* sensor;
+	int* piRaw;
+	double* pdTemp;
+	double* pdOut;
+	double dLsb = (MaxValue - MinValue) / TempMaxData;
+	double dFrac;
+	double dValue;
+	double dSlope;
+	double dScalar;
+	double dWorst;
+	int first;
+	int index;
+	int count;
+	int errors = 0;
+	int s;
+	int i;
+
+	for (s = 0; s < sizeof(Sensors) / sizeof(sensor_t); s++)
+	{
+		sensor = &Sensors[s];
+
+		first = 0;
+		for (i = 1; i < sensor->iTableCount; i++)
+		{
+			if (sensor->pdTable[i] < sensor->pdTable[first])
+				first = i;
+		}
+
+		count = (sensor->iTableCount - 1 - first) * TempSteps + 1;
+		piRaw = malloc(count * sizeof(int));
+		pdTemp = malloc(count * sizeof(double));
+		pdOut = malloc(count * sizeof(double));
+		if (!piRaw || !pdTemp || !pdOut)
+		{
+			fprintf(stderr, "Can not allocate buffers.\n");
+			return 1;
+		}
+
+		for (i = 0; i < count; i++)
+		{
+			index = first + i / TempSteps;
+			dFrac = (double)(i % TempSteps) / TempSteps;
+			if (index == sensor->iTableCount - 1)
+			{
+				index--;
+				dFrac = 1.0;
+			}
+			dValue = sensor->pdTable[index] + (sensor->pdTable[index + 1] - sensor->pdTable[index]) * dFrac;
+			pdTemp[i] = sensor->dMinTemp + index + dFrac;
+			piRaw[i] = (int)((dValue * sensor->dScale - MinValue) / dLsb + 0.5);
+		}
+
+		meUtilityTemperatureV(MinValue, MaxValue, TempMaxData, piRaw, count, sensor->iModuleType, 0, pdOut);
+
+		dWorst = 0;
+		for (i = 0; i < count; i++)
+		{
+			index = first + i / TempSteps;
+			if (index == sensor->iTableCount - 1)
+				index--;
+			dSlope = (sensor->pdTable[index + 1] - sensor->pdTable[index]) * sensor->dScale;
+			if ((i % TempSteps == 0) && (index > first))
+			{// On table's entry: flatter of both neighbouring segments.
+				dScalar = (sensor->pdTable[index] - sensor->pdTable[index - 1]) * sensor->dScale;
+				if (dScalar < dSlope)
+					dSlope = dScalar;
+			}
+
+			meUtilityDigitalToPhysical(MinValue, MaxValue, TempMaxData, piRaw[i], sensor->iModuleType, 0, &dScalar);
+			if ((fabs(pdOut[i] - pdTemp[i]) > dLsb / 2 / dSlope + ToleranceTemp) || (fabs(dScalar - pdTemp[i]) > dLsb / 2 / dSlope + ToleranceTemp))
+			{
+				if (errors < 10)
+					printf("%s: %.1f C scalar=%.6f batch=%.6f\n", sensor->name, pdTemp[i], dScalar, pdOut[i]);
+				errors++;
+			}
+
+			if (fabs(pdOut[i] - pdTemp[i]) > dWorst)
+				dWorst = fabs(pdOut[i] - pdTemp[i]);
+		}
+		printf("%-8s %8.1f .. %6.1f C  max error %.2e C\n", sensor->name, sensor->dMinTemp + first, sensor->dMinTemp + sensor->iTableCount - 1, dWorst);
+
+		free(piRaw);
+		free(pdTemp);
+		free(pdOut);
+	}
+
+	printf("Temperature vs tables: %s (%d errors)\n", (errors) ? "FAILED" : "OK", errors);
+	return errors;
+}
+
+/// Even entries are scaled to double, odd ones are raw. Input is given in pieces, frame position is carried between calls.
+static int checkDeinterleave(void)
+{
+	int iPieces[] = {1, 7, Channels + 3, 300 * Channels + 11, 2 * Channels - 1};
+	int* piInput;
+	int* piExtract;
+	int* piRaw;
+	double* pdScaled;
+	meIOStreamConfig_t ConfigList[Channels];
+	meDeinterleave_t ChannelList[Channels];
+	int iWritten[Channels];
+	int iConsumed;
+	int iCount;
+	int iPosition;
+	int iPiece;
+	double dScalar;
+	int errors = 0;
+	int err;
+	int c;
+	int p;
+	int i;
+
+	piInput = malloc(DeintValues * sizeof(int));
+	piExtract = malloc(Channels * (DeintFrames + 1) * sizeof(int));
+	piRaw = malloc(Channels * (DeintFrames + 1) * sizeof(int));
+	pdScaled = malloc(Channels * (DeintFrames + 1) * sizeof(double));
+	if (!piInput || !piExtract || !piRaw || !pdScaled)
+	{
+		fprintf(stderr, "Can not allocate buffers.\n");
+		return 1;
+	}
+
+	for (i = 0; i < DeintValues; i++)
+	{
+		piInput[i] = (i * 7919) % (MaxData + 1);
+	}
+
+	for (c = 0; c < Channels; c++)
+	{
+		ConfigList[c].iChannel = c;
+		ConfigList[c].iStreamConfig = 0;
+		ConfigList[c].iRef = ME_REF_AI_GROUND;
+		ConfigList[c].iFlags = ME_IO_STREAM_CONFIG_NO_FLAGS;
+
+		ChannelList[c].pvBuffer = NULL;
+		ChannelList[c].iFormat = (c % 2) ? ME_DEINTERLEAVE_FORMAT_INT : ME_DEINTERLEAVE_FORMAT_DOUBLE;
+		ChannelList[c].dMin = MinValue;
+		ChannelList[c].dMax = MaxValue;
+		ChannelList[c].iMaxData = MaxData;
+		ChannelList[c].iFlags = ME_DEINTERLEAVE_NO_FLAGS;
+		iWritten[c] = 0;
+	}
+
+	iConsumed = 0;
+	iPosition = 0;
+	for (p = 0; iConsumed < DeintValues; p++)
+	{
+		iPiece = iPieces[p % (sizeof(iPieces) / sizeof(int))];
+		if (iPiece > DeintValues - iConsumed)
+			iPiece = DeintValues - iConsumed;
+
+		for (c = 0; c < Channels; c++)
+		{
+			if (c % 2)
+				ChannelList[c].pvBuffer = piRaw + c * (DeintFrames + 1) + iWritten[c];
+			else
+				ChannelList[c].pvBuffer = pdScaled + c * (DeintFrames + 1) + iWritten[c];
+			ChannelList[c].iCount = DeintFrames + 1 - iWritten[c];
+		}
+
+		iCount = iPiece;
+		err = meUtilityDeinterleave(piInput + iConsumed, &iCount, ChannelList, Channels, &iPosition, ME_DEINTERLEAVE_NO_FLAGS);
+		if (err || (iCount != iPiece))
+		{
+			printf("Deinterleave: piece %d of %d values: err=%d consumed=%d\n", p, iPiece, err, iCount);
+			errors++;
+			break;
+		}
+
+		for (c = 0; c < Channels; c++)
+		{
+			iWritten[c] += ChannelList[c].iCount;
+		}
+		iConsumed += iCount;
+	}
+
+	for (c = 0; c < Channels; c++)
+	{
+		iCount = DeintFrames + 1;
+		meUtilityExtractValues(c, piInput, DeintValues, ConfigList, Channels, piExtract + c * (DeintFrames + 1), &iCount);
+		if (iWritten[c] != iCount)
+		{
+			printf("Deinterleave: channel %d: %d values, meUtilityExtractValues() %d\n", c, iWritten[c], iCount);
+			errors++;
+			continue;
+		}
+
+		for (i = 0; i < iCount; i++)
+		{
+			if (c % 2)
+			{
+				if (piRaw[c * (DeintFrames + 1) + i] != piExtract[c * (DeintFrames + 1) + i])
+				{
+					printf("Deinterleave: channel %d [%d] raw=%d expected=%d\n", c, i, piRaw[c * (DeintFrames + 1) + i], piExtract[c * (DeintFrames + 1) + i]);
+					errors++;
+				}
+			}
+			else
+			{
+				meUtilityDigitalToPhysical(MinValue, MaxValue, MaxData, piExtract[c * (DeintFrames + 1) + i], ME_MODULE_TYPE_MULTISIG_NONE, 0, &dScalar);
+				if (fabs(pdScaled[c * (DeintFrames + 1) + i] - dScalar) > ToleranceDouble)
+				{
+					printf("Deinterleave: channel %d [%d] double=%.9f expected=%.9f\n", c, i, pdScaled[c * (DeintFrames + 1) + i], dScalar);
+					errors++;
+				}
+			}
+		}
+	}
+
+	// Full output stops processing: channel 3 takes 10 values, so 10 frames and 3 values of 11th are consumed.
+	for (c = 0; c < Channels; c++)
+	{
+		ChannelList[c].pvBuffer = piRaw + c * (DeintFrames + 1);
+		ChannelList[c].iFormat = ME_DEINTERLEAVE_FORMAT_INT;
+		ChannelList[c].iCount = (c == 3) ? 10 : DeintFrames + 1;
+	}
+	iCount = DeintValues;
+	iPosition = 0;
+	err = meUtilityDeinterleave(piInput, &iCount, ChannelList, Channels, &iPosition, ME_DEINTERLEAVE_NO_FLAGS);
+	if (err || (iCount != 10 * Channels + 3) || (iPosition != 3) || (ChannelList[3].iCount != 10) || (ChannelList[2].iCount != 11))
+	{
+		printf("Deinterleave full output: err=%d consumed=%d position=%d\n", err, iCount, iPosition);
+		errors++;
+	}
+
+	// Invalid entry: error and nothing is touched.
+	for (c = 0; c < Channels; c++)
+	{
+		ChannelList[c].iCount = 77;
+	}
+	ChannelList[5].iFlags = 1;
+	iCount = DeintValues;
+	iPosition = 0;
+	err = meUtilityDeinterleave(piInput, &iCount, ChannelList, Channels, &iPosition, ME_DEINTERLEAVE_NO_FLAGS);
+	if (err != ME_ERRNO_INVALID_FLAGS)
+	{
+		printf("Deinterleave invalid entry flags: err=%d\n", err);
+		errors++;
+	}
+	for (c = 0; c < Channels; c++)
+	{
+		if (ChannelList[c].iCount != 77)
+		{
+			printf("Deinterleave invalid entry flags: channel %d count changed to %d\n", c, ChannelList[c].iCount);
+			errors++;
+		}
+	}
+	if (iCount != DeintValues)
+	{
+		printf("Deinterleave invalid entry flags: input count changed to %d\n", iCount);
+		errors++;
+	}
+
+	free(piInput);
+	free(piExtract);
+	free(piRaw);
+	free(pdScaled);
+
+	printf("Deinterleave vs extract: %s (%d errors)\n", (errors) ? "FAILED" : "OK", errors);
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	int* piData;
+	double* pdPhysical;
+	float* pfPhysical;
+	struct timespec pre;
+	struct timespec post;
+	meIOStreamConfig_t ConfigList[Channels];
+	meDeinterleave_t ChannelList[Channels];
+	int iCount;
+	int iPosition;
+	int i;
+	int l;
+
+	piData = malloc(BufferSize * sizeof(int));
+	pdPhysical = malloc(BufferSize * sizeof(double));
+	pfPhysical = malloc(BufferSize * sizeof(float));
+	if (!piData || !pdPhysical || !pfPhysical)
+	{
+		fprintf(stderr, "Can not allocate buffers.\n");
+		return 1;
+	}
+
+	for (i = 0; i < BufferSize; i++)
+	{
+		piData[i] = (i * 7) & MaxData;
+	}
+
+	if (checkVectorKernels() || checkTemperature() || checkDeinterleave())
+	{
+		return 1;
+	}
+
+	printf("Buffer: %d samples, %d loops.\n", BufferSize, Loops);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		for (i = 0; i < BufferSize; i++)
+		{
+			meUtilityDigitalToPhysical(MinValue, MaxValue, MaxData, piData[i], ME_MODULE_TYPE_MULTISIG_NONE, 0, &pdPhysical[i]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityDigitalToPhysical() loop", &pre, &post, BufferSize);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		meUtilityDigitalToPhysicalV(MinValue, MaxValue, MaxData, piData, BufferSize, ME_MODULE_TYPE_MULTISIG_NONE, 0, pdPhysical);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityDigitalToPhysicalV()", &pre, &post, BufferSize);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		meUtilityDigitalToPhysicalFloatV(MinValue, MaxValue, MaxData, piData, BufferSize, ME_MODULE_TYPE_MULTISIG_NONE, 0, pfPhysical);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityDigitalToPhysicalFloatV()", &pre, &post, BufferSize);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		for (i = 0; i < BufferSize; i++)
+		{
+			meUtilityDigitalToPhysical(MinValue, MaxValue, MaxData, piData[i], ME_MODULE_TYPE_MULTISIG_TE8_TYPE_K, 0, &pdPhysical[i]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityDigitalToPhysical() loop, TE K", &pre, &post, BufferSize);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		meUtilityTemperatureV(MinValue, MaxValue, MaxData, piData, BufferSize, ME_MODULE_TYPE_MULTISIG_TE8_TYPE_K, 25.0, pdPhysical);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityTemperatureV(), TE K", &pre, &post, BufferSize);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		for (i = 0; i < BufferSize; i++)
+		{
+			meUtilityPhysicalToDigital(MinValue, MaxValue, MaxData, pdPhysical[i], &piData[i]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityPhysicalToDigital() loop", &pre, &post, BufferSize);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		meUtilityPhysicalToDigitalV(MinValue, MaxValue, MaxData, pdPhysical, BufferSize, piData);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityPhysicalToDigitalV()", &pre, &post, BufferSize);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		meUtilityPhysicalToDigitalFloatV(MinValue, MaxValue, MaxData, pfPhysical, BufferSize, piData);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityPhysicalToDigitalFloatV()", &pre, &post, BufferSize);
+
+	for (i = 0; i < Channels; i++)
+	{
+		ConfigList[i].iChannel = i;
+		ConfigList[i].iStreamConfig = 0;
+		ConfigList[i].iRef = ME_REF_AI_GROUND;
+		ConfigList[i].iFlags = ME_IO_STREAM_CONFIG_NO_FLAGS;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		for (i = 0; i < Channels; i++)
+		{
+			iCount = BufferSize / Channels;
+			meUtilityExtractValues(i, piData, BufferSize, ConfigList, Channels, (int *)pfPhysical + i * (BufferSize / Channels), &iCount);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityExtractValues() x 32 channels", &pre, &post, BufferSize);
+
+	clock_gettime(CLOCK_MONOTONIC, &pre);
+	for (l = 0; l < Loops; l++)
+	{
+		for (i = 0; i < Channels; i++)
+		{
+			ChannelList[i].pvBuffer = pdPhysical + i * (BufferSize / Channels);
+			ChannelList[i].iFormat = ME_DEINTERLEAVE_FORMAT_DOUBLE;
+			ChannelList[i].iCount = BufferSize / Channels;
+			ChannelList[i].dMin = MinValue;
+			ChannelList[i].dMax = MaxValue;
+			ChannelList[i].iMaxData = MaxData;
+			ChannelList[i].iFlags = ME_DEINTERLEAVE_NO_FLAGS;
+		}
+
+		iCount = BufferSize;
+		iPosition = 0;
+		meUtilityDeinterleave(piData, &iCount, ChannelList, Channels, &iPosition, ME_DEINTERLEAVE_NO_FLAGS);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &post);
+	report("meUtilityDeinterleave() 32 channels, double", &pre, &post, BufferSize);
+
+	free(piData);
+	free(pdPhysical);
+	free(pfPhysical);
+
+	return 0;
+}
@@ -0,0 +1,566 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Krzysztof Gantzke     <k.gantzke@meilhaus.de>   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/* irqlatency - end-to-end interrupt latency over a DO -> interrupt input loopback.
+ *
+ * Line 0 of a digital output is wired to an external interrupt input
+ * (ME-4680: DIO port -> EXT_IRQ, ME-8200: DO -> DI). Every iteration sets the
+ * line and waits for the interrupt in user space, by meIOIrqWait() or by an
+ * IRQ callback (-c). The driver's latency probe (meQueryLatencyProbe()) gives
+ * kernel time stamps of the register write, the interrupt handler entry and
+ * the waiter's wake-up. All stamps are CLOCK_MONOTONIC, so they are compared
+ * with user space time directly:
+ *
+ *   write -> ISR        register write to interrupt handler entry (hardware + interrupt delivery)
+ *   ISR -> wakeup       interrupt handler entry to waiting thread running in the driver
+ *   wakeup -> user      waiting thread in the driver to return of meIOIrqWait() (wait mode)
+ *   wakeup -> callback  waiting thread in the driver to entry of the callback (callback mode)
+ *   total               meIOSingle() called to interrupt seen in user space
+ *
+ * Latencies are collected in histograms, so millions of iterations need no
+ * memory. Without driver support for the probe only 'total' is reported.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+#include "medriver.h"
+
+#define WARMUP_ITERATIONS		1000
+#define LOOP_TIMEOUT			1000	// ms
+#define MAX_TIMEOUTS			10
+
+/// 8 sub-buckets per power of 2: resolution is better than 12.5% over the whole 64 bit range.
+#define HISTOGRAM_SUB_BITS		3
+#define HISTOGRAM_SUB_COUNT		(1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_COUNT			((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT)
+#define HISTOGRAM_BAR			50
+
+/// Command line options.
+static struct
+{
+	unsigned long long iterations;
+	int callback;
+	int priority;
+	int verbose;
+	int doDevice;
+	int doSubdevice;
+	int irqDevice;
+	int irqSubdevice;
+} opt = {100000, 0, 0, 0, -1, -1, -1, -1};
+
+typedef struct histogram
+{
+	const char* name;
+	unsigned long long count;
+	unsigned long long min;
+	unsigned long long max;
+	double sum;
+	unsigned long long bucket[HISTOGRAM_COUNT];
+} histogram_t;
+
+enum
+{
+	SERIES_ISR = 0,
+	SERIES_WAKEUP,
+	SERIES_USER,
+	SERIES_TOTAL,
+	SERIES_COUNT
+};
+
+static histogram_t series[SERIES_COUNT];
+
+/// Seen by waiting thread or callback.
+typedef struct loop_event
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int seen;
+	int err;
+	int count;
+	volatile int stop;
+	unsigned long long time;
+} loop_event_t;
+
+static loop_event_t loopEvent = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0, 0, 0};
+
+static unsigned long long nowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*===========================================================================
+  Histograms
+  =========================================================================*/
+
+static int histogramIndex(unsigned long long value)
+{
+	int msb;
+
+	if (value < HISTOGRAM_SUB_COUNT)
+		return (int)value;
+
+	msb = 63 - __builtin_clzll(value);
+	return (msb - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT + (int)((value >> (msb - HISTOGRAM_SUB_BITS)) & (HISTOGRAM_SUB_COUNT - 1));
+}
+
+/// Lowest value counted in bucket.
+static unsigned long long histogramValue(int index)
+{
+	int msb;
+
+	if (index < HISTOGRAM_SUB_COUNT)
+		return index;
+
+	msb = index / HISTOGRAM_SUB_COUNT + HISTOGRAM_SUB_BITS - 1;
+	return (1ULL << msb) | ((unsigned long long)(index % HISTOGRAM_SUB_COUNT) << (msb - HISTOGRAM_SUB_BITS));
+}
+
+static void histogramAdd(histogram_t* h, unsigned long long value)
+{
+	if (!h->count || (value < h->min))
+		h->min = value;
+	if (value > h->max)
+		h->max = value;
+	h->count++;
+	h->sum += value;
+	h->bucket[histogramIndex(value)]++;
+}
+
+/// Upper edge of bucket holding the percentile. Never above real maximum.
+static unsigned long long histogramPercentile(const histogram_t* h, double percent)
+{
+	unsigned long long rank;
+	unsigned long long seen = 0;
+	unsigned long long value;
+	int i;
+
+	if (!h->count)
+		return 0;
+
+	rank = (unsigned long long)(percent / 100.0 * (h->count - 1)) + 1;
+	for (i = 0; i < HISTOGRAM_COUNT; i++)
+	{
+		seen += h->bucket[i];
+		if (seen >= rank)
+			break;
+	}
+
+	value = (i + 1 < HISTOGRAM_COUNT) ? histogramValue(i + 1) - 1 : h->max;
+	return (value > h->max) ? h->max : value;
+}
+
+static void printSummaryHeader(void)
+{
+	printf("%-20s %10s %9s %9s %9s %9s %9s %9s %9s\n", "[us]", "count", "min", "mean", "p50", "p90", "p99", "p99.9", "max");
+}
+
+static void printSummary(const histogram_t* h)
+{
+	if (!h->count)
+	{
+		printf("%-20s %10s\n", h->name, "-");
+		return;
+	}
+
+	printf("%-20s %10llu %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n", h->name, h->count,
+			h->min / 1000.0, h->sum / h->count / 1000.0,
+			histogramPercentile(h, 50.0) / 1000.0, histogramPercentile(h, 90.0) / 1000.0,
+			histogramPercentile(h, 99.0) / 1000.0, histogramPercentile(h, 99.9) / 1000.0,
+			h->max / 1000.0);
+}
+
+/// Prints power of 2 buckets (or all buckets with -v) between first and last used one.
+static void printHistogram(const histogram_t* h)
+{
+	unsigned long long count;
+	unsigned long long peak = 0;
+	int step = opt.verbose ? 1 : HISTOGRAM_SUB_COUNT;
+	int first = -1;
+	int last = 0;
+	int i;
+	int j;
+
+	if (!h->count)
+		return;
+
+	for (i = 0; i < HISTOGRAM_COUNT; i += step)
+	{
+		for (count = 0, j = i; j < i + step; j++)
+			count += h->bucket[j];
+
+		if (count)
+		{
+			if (first < 0)
+				first = i;
+			last = i;
+			if (count > peak)
+				peak = count;
+		}
+	}
+
+	printf("\n%s\n", h->name);
+	for (i = first; i <= last; i += step)
+	{
+		for (count = 0, j = i; j < i + step; j++)
+			count += h->bucket[j];
+
+		printf("  >= %10.2f us %10llu |%.*s\n", histogramValue(i) / 1000.0, count,
+				(int)((count * HISTOGRAM_BAR + peak - 1) / peak),
+				"##################################################");
+	}
+}
+
+/*===========================================================================
+  Loopback
+  =========================================================================*/
+
+static void loopSignal(unsigned long long time, int count, int err)
+{
+	pthread_mutex_lock(&loopEvent.mutex);
+		if (!loopEvent.seen)
+		{
+			loopEvent.time = time;
+			loopEvent.count = count;
+			loopEvent.err = err;
+			loopEvent.seen = 1;
+			pthread_cond_signal(&loopEvent.cond);
+		}
+	pthread_mutex_unlock(&loopEvent.mutex);
+}
+
+static void* loopWaitThread(void* arg)
+{
+	int count = 0;
+	int value;
+	int err;
+
+	while (!loopEvent.stop)
+	{
+		err = meIOIrqWait(opt.irqDevice, opt.irqSubdevice, 0, &count, &value, LOOP_TIMEOUT, ME_IO_IRQ_WAIT_NO_FLAGS);
+		if (err == ME_ERRNO_TIMEOUT)
+			continue;
+
+		loopSignal(nowNs(), count, err);
+		if (err)
+			break;
+	}
+
+	return NULL;
+}
+
+static int loopCallback(int device, int subdevice, int channel, int count, int value, void* context, int status)
+{
+	loopSignal(nowNs(), count, status);
+
+	return 0;
+}
+
+static int loopWriteDO(int value)
+{
+	meIOSingle_t single;
+
+	single.iDevice = opt.doDevice;
+	single.iSubdevice = opt.doSubdevice;
+	single.iChannel = 0;
+	single.iDir = ME_DIR_OUTPUT;
+	single.iValue = value;
+	single.iTimeOut = 0;
+	single.iFlags = ME_IO_SINGLE_TYPE_NO_FLAGS;
+	single.iErrno = ME_ERRNO_SUCCESS;
+
+	return meIOSingle(&single, 1, ME_IO_SINGLE_NO_FLAGS);
+}
+
+/// Sorts time stamps of one iteration into histograms. Returns 0 when probe does not belong to this interrupt.
+static int loopRecord(unsigned long long start, const meLatencyProbe_t* out, const meLatencyProbe_t* in)
+{
+	int matched;
+
+	histogramAdd(&series[SERIES_TOTAL], loopEvent.time - start);
+
+	matched = out->ullWriteTime && in->ullIrqTime && in->ullWakeTime
+			&& (in->iIrqCount == loopEvent.count)
+			&& (start <= out->ullWriteTime)
+			&& (out->ullWriteTime <= in->ullIrqTime)
+			&& (in->ullIrqTime <= in->ullWakeTime)
+			&& (in->ullWakeTime <= loopEvent.time);
+
+	if (matched)
+	{
+		histogramAdd(&series[SERIES_ISR], in->ullIrqTime - out->ullWriteTime);
+		histogramAdd(&series[SERIES_WAKEUP], in->ullWakeTime - in->ullIrqTime);
+		histogramAdd(&series[SERIES_USER], loopEvent.time - in->ullWakeTime);
+	}
+
+	return matched;
+}
+
+static int loopRun(unsigned long long* unmatched, unsigned long long* timeouts)
+{
+	meLatencyProbe_t out;
+	meLatencyProbe_t in;
+	unsigned long long start;
+	unsigned long long i;
+	struct timespec deadline;
+	pthread_t thread;
+	int threadStarted = 0;
+	int probe = 1;
+	int warmup = WARMUP_ITERATIONS;
+	int type;
+	int subtype;
+	int err;
+
+	// IRQ subdevice first. It can be the same one as DO (DIO with interrupt line).
+	meIOResetSubdevice(opt.irqDevice, opt.irqSubdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+	meIOResetSubdevice(opt.doDevice, opt.doSubdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+
+	err = meQuerySubdeviceType(opt.doDevice, opt.doSubdevice, &type, &subtype);
+	if (!err && (type != ME_TYPE_DO) && (type != ME_TYPE_DIO))
+		err = ME_ERRNO_INVALID_SUBDEVICE;
+	if (!err)
+		err = meIOSingleConfig(opt.doDevice, opt.doSubdevice, 0, ME_SINGLE_CONFIG_DIO_OUTPUT, ME_REF_NONE, ME_TRIG_CHAN_NONE, ME_TRIG_TYPE_NONE, ME_TRIG_EDGE_NONE, ME_IO_SINGLE_CONFIG_NO_FLAGS);
+	if (!err)
+		err = loopWriteDO(0);
+	if (err)
+		goto ERROR;
+
+	if (meQueryLatencyProbe(opt.irqDevice, opt.irqSubdevice, &in, ME_QUERY_NO_FLAGS)
+		|| meQueryLatencyProbe(opt.doDevice, opt.doSubdevice, &out, ME_QUERY_NO_FLAGS))
+	{
+		fprintf(stderr, "Driver has no latency probe. Only 'total' is measured.\n");
+		probe = 0;
+	}
+
+	loopEvent.stop = 0;
+	loopEvent.seen = 0;
+	if (opt.callback)
+	{
+		err = meIOIrqSetCallback(opt.irqDevice, opt.irqSubdevice, loopCallback, NULL, ME_IO_IRQ_SET_CALLBACK_NO_FLAGS);
+		if (err)
+			goto ERROR;
+	}
+
+	err = meIOIrqStart(opt.irqDevice, opt.irqSubdevice, 0, ME_IRQ_SOURCE_DIO_LINE, ME_IRQ_EDGE_RISING, ME_VALUE_NOT_USED, ME_IO_IRQ_START_NO_FLAGS);
+	if (err)
+		goto ERROR;
+
+	if (!opt.callback)
+	{
+		if (pthread_create(&thread, NULL, loopWaitThread, NULL))
+		{
+			err = ME_ERRNO_INTERNAL;
+			goto ERROR;
+		}
+		threadStarted = 1;
+	}
+
+	for (i = 0; i < opt.iterations; )
+	{
+		pthread_mutex_lock(&loopEvent.mutex);
+			loopEvent.seen = 0;
+		pthread_mutex_unlock(&loopEvent.mutex);
+
+		start = nowNs();
+		err = loopWriteDO(1);
+		if (err)
+			break;
+
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += LOOP_TIMEOUT / 1000;
+		pthread_mutex_lock(&loopEvent.mutex);
+			while (!loopEvent.seen)
+			{
+				if (pthread_cond_timedwait(&loopEvent.cond, &loopEvent.mutex, &deadline) == ETIMEDOUT)
+					break;
+			}
+		pthread_mutex_unlock(&loopEvent.mutex);
+
+		if (!loopEvent.seen)
+		{
+			// Wiring is missing. Do not wait for every iteration.
+			if ((++*timeouts >= MAX_TIMEOUTS) && !series[SERIES_TOTAL].count)
+				err = ME_ERRNO_TIMEOUT;
+		}
+		else if (loopEvent.err)
+		{
+			err = loopEvent.err;
+		}
+		else if (warmup)
+		{
+			warmup--;
+		}
+		else
+		{
+			// Probe is read before next write overwrites it.
+			if (probe)
+			{
+				err = meQueryLatencyProbe(opt.doDevice, opt.doSubdevice, &out, ME_QUERY_NO_FLAGS);
+				if (!err)
+					err = meQueryLatencyProbe(opt.irqDevice, opt.irqSubdevice, &in, ME_QUERY_NO_FLAGS);
+				if (err)
+					break;
+			}
+			else
+			{
+				memset(&out, 0, sizeof(out));
+				memset(&in, 0, sizeof(in));
+			}
+
+			if (!loopRecord(start, &out, &in) && probe)
+				++*unmatched;
+
+			if (!(++i % (opt.iterations / 10 ? opt.iterations / 10 : 1)))
+				fprintf(stderr, "%llu/%llu\n", i, opt.iterations);
+		}
+
+		if (!err)
+			err = loopWriteDO(0);
+		if (err)
+			break;
+	}
+
+ERROR:
+	loopEvent.stop = 1;
+	meIOIrqStop(opt.irqDevice, opt.irqSubdevice, 0, ME_IO_IRQ_STOP_NO_FLAGS);
+	if (threadStarted)
+		pthread_join(thread, NULL);
+	if (opt.callback)
+		meIOIrqSetCallback(opt.irqDevice, opt.irqSubdevice, NULL, NULL, ME_IO_IRQ_SET_CALLBACK_NO_FLAGS);
+	meIOResetSubdevice(opt.irqDevice, opt.irqSubdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+	meIOResetSubdevice(opt.doDevice, opt.doSubdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+
+	return err;
+}
+
+static void usage(const char* name)
+{
+	fprintf(stderr, "Usage: %s [options] do_device:do_subdevice:irq_device:irq_subdevice\n", name);
+	fprintf(stderr, "  Line 0 of DO subdevice must be wired to interrupt input of IRQ subdevice.\n");
+	fprintf(stderr, "  -n iterations    measured iterations (default %llu)\n", opt.iterations);
+	fprintf(stderr, "  -c               wait by IRQ callback instead of meIOIrqWait()\n");
+	fprintf(stderr, "  -p priority      run with SCHED_FIFO priority and locked memory\n");
+	fprintf(stderr, "  -v               print histograms with full resolution\n");
+}
+
+int main(int argc, char *argv[])
+{
+	struct sched_param param;
+	unsigned long long unmatched = 0;
+	unsigned long long timeouts = 0;
+	char errorText[ME_ERROR_MSG_MAX_COUNT];
+	int err;
+	int c;
+	int i;
+
+	while ((c = getopt(argc, argv, "n:cp:vh")) != -1)
+	{
+		switch (c)
+		{
+			case 'n':
+				opt.iterations = strtoull(optarg, NULL, 0);
+				break;
+
+			case 'c':
+				opt.callback = 1;
+				break;
+
+			case 'p':
+				opt.priority = atoi(optarg);
+				break;
+
+			case 'v':
+				opt.verbose = 1;
+				break;
+
+			default:
+				usage(argv[0]);
+				return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if ((optind + 1 != argc) || !opt.iterations
+		|| (sscanf(argv[optind], "%d:%d:%d:%d", &opt.doDevice, &opt.doSubdevice, &opt.irqDevice, &opt.irqSubdevice) != 4))
+	{
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (opt.priority)
+	{
+		// Threads created later (waiting thread, library's callback thread) inherit the policy.
+		param.sched_priority = opt.priority;
+		if (sched_setscheduler(0, SCHED_FIFO, &param) || mlockall(MCL_CURRENT | MCL_FUTURE))
+		{
+			perror("SCHED_FIFO");
+			return EXIT_FAILURE;
+		}
+	}
+
+	series[SERIES_ISR].name = "write -> ISR";
+	series[SERIES_WAKEUP].name = "ISR -> wakeup";
+	series[SERIES_USER].name = opt.callback ? "wakeup -> callback" : "wakeup -> user";
+	series[SERIES_TOTAL].name = "total";
+
+	meErrorSetDefaultProc(ME_SWITCH_DISABLE);
+
+	if (meOpen(ME_OPEN_NO_FLAGS))
+	{
+		fprintf(stderr, "Can not open driver system.\n");
+		return EXIT_FAILURE;
+	}
+
+	fprintf(stderr, "DO [%d,%d] -> IRQ [%d,%d], %s, %llu iterations\n", opt.doDevice, opt.doSubdevice, opt.irqDevice, opt.irqSubdevice,
+			opt.callback ? "callback" : "meIOIrqWait()", opt.iterations);
+
+	err = loopRun(&unmatched, &timeouts);
+
+	meClose(ME_CLOSE_NO_FLAGS);
+
+	printSummaryHeader();
+	for (i = 0; i < SERIES_COUNT; i++)
+		printSummary(&series[i]);
+	printf("timeouts: %llu  unmatched probes: %llu\n", timeouts, unmatched);
+
+	for (i = 0; i < SERIES_COUNT; i++)
+		printHistogram(&series[i]);
+
+	if (err)
+	{
+		meErrorGetMessage(err, errorText, sizeof(errorText));
+		fprintf(stderr, "Measurement stopped: %s\n", errorText);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,1247 @@
+/***************************************************************************
+ *   Copyright (C) 2009 by Krzysztof Gantzke     <k.gantzke@meilhaus.de>   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/* mebench - throughput and latency benchmarks of the driver system.
+ *
+ * Results are written as one JSON document (stdout or -o file), so runs on
+ * different driver versions and kernels can be compared. Progress and errors
+ * go to stderr. Scenarios that drive outputs (AO, DO, loopback) run only with -w.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/utsname.h>
+
+#include "medriver.h"
+
+#define MEBENCH_FORMAT_VERSION	1
+
+#define WARMUP_ITERATIONS		100
+#define LIST_MAX_COUNT			64
+#define STREAM_CHUNK_MAX		0x10000
+#define AO_CHUNK				0x400
+#define LOOP_TIMEOUT			1000	// ms
+
+static const int streamChunks[] = {0x40, 0x100, 0x400, 0x1000, 0x4000, 0x10000};
+static const int underrunGaps[] = {0, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000};	// us
+
+/// Command line options.
+static struct
+{
+	int iterations;
+	double seconds;
+	double rate;
+	int device;			// -1: all devices
+	int outputs;		// Scenarios are allowed to drive outputs.
+	int loop;			// Loopback wiring given.
+	int loopDODevice;
+	int loopDOSubdevice;
+	int loopIrqDevice;
+	int loopIrqSubdevice;
+	char* host;
+} opt = {10000, 2.0, 100000.0, -1, 0, 0, 0, 0, 0, 0, NULL};
+
+typedef struct scenario
+{
+	const char* name;
+	void (*run)(void);
+	const char* help;
+} scenario_t;
+
+/*===========================================================================
+  JSON output
+  =========================================================================*/
+
+static FILE* out;
+static int level;
+static int comma[16];
+
+static void jsonIndent(void)
+{
+	fprintf(out, "\n%*s", level * 2, "");
+}
+
+static void jsonQuoted(const char* text)
+{
+	fputc('"', out);
+	for (; *text; text++)
+	{
+		if ((*text == '"') || (*text == '\\'))
+			fputc('\\', out);
+
+		if ((unsigned char)*text < 0x20)
+			fprintf(out, "\\u%04x", (unsigned char)*text);
+		else
+			fputc(*text, out);
+	}
+	fputc('"', out);
+}
+
+/// Starts new member (key != NULL) or array element.
+static void jsonKey(const char* key)
+{
+	if (comma[level])
+		fputc(',', out);
+	comma[level] = 1;
+
+	jsonIndent();
+	if (key)
+	{
+		jsonQuoted(key);
+		fputs(": ", out);
+	}
+}
+
+static void jsonOpen(const char* key, char bracket)
+{
+	jsonKey(key);
+	fputc(bracket, out);
+	comma[++level] = 0;
+}
+
+static void jsonClose(char bracket)
+{
+	level--;
+	jsonIndent();
+	fputc(bracket, out);
+}
+
+static void jsonString(const char* key, const char* value)
+{
+	jsonKey(key);
+	jsonQuoted(value);
+}
+
+static void jsonInt(const char* key, long long value)
+{
+	jsonKey(key);
+	fprintf(out, "%lld", value);
+}
+
+static void jsonDouble(const char* key, double value)
+{
+	jsonKey(key);
+	if (value != value)
+		fputs("null", out);
+	else
+		fprintf(out, "%.3f", value);
+}
+
+static void jsonBool(const char* key, int value)
+{
+	jsonKey(key);
+	fputs(value ? "true" : "false", out);
+}
+
+/// Adds "error" and "message" of driver system's error.
+static void jsonError(int err)
+{
+	char message[ME_ERROR_MSG_MAX_COUNT] = "";
+
+	meErrorGetMessage(err, message, sizeof(message));
+	jsonInt("error", err);
+	jsonString("message", message);
+}
+
+static void jsonResultBegin(const char* scenario)
+{
+	jsonOpen(NULL, '{');
+	jsonString("scenario", scenario);
+}
+
+static void jsonSkipped(const char* scenario, const char* reason)
+{
+	jsonResultBegin(scenario);
+	jsonString("skipped", reason);
+	jsonClose('}');
+	fprintf(stderr, "%s: skipped (%s)\n", scenario, reason);
+}
+
+/*===========================================================================
+  Timing
+  =========================================================================*/
+
+static unsigned long long nowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int compareSamples(const void* a, const void* b)
+{
+	unsigned long long x = *(const unsigned long long *)a;
+	unsigned long long y = *(const unsigned long long *)b;
+
+	return (x > y) - (x < y);
+}
+
+static unsigned long long percentile(const unsigned long long* sorted, int count, double p)
+{
+	int index = (int)(p * (count - 1) + 0.5);
+
+	return sorted[index];
+}
+
+/// Writes statistics of latency samples (ns). Samples are sorted in place.
+static void jsonLatency(const char* key, unsigned long long* samples, int count)
+{
+	unsigned long long sum = 0;
+	int i;
+
+	jsonOpen(key, '{');
+	jsonInt("count", count);
+	if (count > 0)
+	{
+		qsort(samples, count, sizeof(*samples), compareSamples);
+		for (i = 0; i < count; i++)
+			sum += samples[i];
+
+		jsonInt("min", samples[0]);
+		jsonDouble("mean", (double)sum / count);
+		jsonInt("p50", percentile(samples, count, 0.50));
+		jsonInt("p90", percentile(samples, count, 0.90));
+		jsonInt("p99", percentile(samples, count, 0.99));
+		jsonInt("p999", percentile(samples, count, 0.999));
+		jsonInt("max", samples[count - 1]);
+	}
+	jsonClose('}');
+}
+
+/*===========================================================================
+  Helpers
+  =========================================================================*/
+
+static const char* typeName(int type)
+{
+	switch (type)
+	{
+		case ME_TYPE_AO:		return "AO";
+		case ME_TYPE_AI:		return "AI";
+		case ME_TYPE_DIO:		return "DIO";
+		case ME_TYPE_DO:		return "DO";
+		case ME_TYPE_DI:		return "DI";
+		case ME_TYPE_CTR:		return "CTR";
+		case ME_TYPE_EXT_IRQ:	return "EXT_IRQ";
+		case ME_TYPE_FREQ_IO:	return "FREQ_IO";
+		case ME_TYPE_FREQ_O:	return "FREQ_O";
+		case ME_TYPE_FREQ_I:	return "FREQ_I";
+		case ME_TYPE_FPGA:		return "FPGA";
+	}
+
+	return "UNKNOWN";
+}
+
+static int numberDevices(void)
+{
+	int count = 0;
+
+	meQueryNumberDevices(&count);
+	return count;
+}
+
+static int deviceSelected(int device)
+{
+	return (opt.device < 0) || (opt.device == device);
+}
+
+static int deviceRemote(int device)
+{
+	int vendor, id, serial, bus = 0, busNo, devNo, funcNo, plugged;
+
+	meQueryInfoDevice(device, &vendor, &id, &serial, &bus, &busNo, &devNo, &funcNo, &plugged);
+	return (bus == ME_BUS_TYPE_LAN_PCI) || (bus == ME_BUS_TYPE_LAN_USB);
+}
+
+/// Configures subdevice for single reads (dir == ME_DIR_INPUT) or writes. Returns value to write in *value.
+static int singlePrepare(int device, int subdevice, int type, int* dir, int* value)
+{
+	int unit;
+	double min;
+	double max;
+	int maxData = 0;
+
+	*value = 0;
+	meIOResetSubdevice(device, subdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+
+	switch (type)
+	{
+		case ME_TYPE_AI:
+			*dir = ME_DIR_INPUT;
+			return meIOSingleConfig(device, subdevice, 0, 0, ME_REF_AI_GROUND, ME_TRIG_CHAN_DEFAULT, ME_TRIG_TYPE_SW, ME_TRIG_EDGE_NONE, ME_IO_SINGLE_CONFIG_NO_FLAGS);
+
+		case ME_TYPE_DI:
+			*dir = ME_DIR_INPUT;
+			return ME_ERRNO_SUCCESS;
+
+		case ME_TYPE_DIO:
+			*dir = ME_DIR_INPUT;
+			return meIOSingleConfig(device, subdevice, 0, ME_SINGLE_CONFIG_DIO_INPUT, ME_REF_NONE, ME_TRIG_CHAN_NONE, ME_TRIG_TYPE_NONE, ME_TRIG_EDGE_NONE, ME_IO_SINGLE_CONFIG_NO_FLAGS);
+
+		case ME_TYPE_AO:
+			*dir = ME_DIR_OUTPUT;
+			// Mid scale. 0V for bipolar ranges.
+			meQueryRangeInfo(device, subdevice, 0, &unit, &min, &max, &maxData);
+			*value = maxData / 2;
+			return meIOSingleConfig(device, subdevice, 0, 0, ME_REF_AO_GROUND, ME_TRIG_CHAN_DEFAULT, ME_TRIG_TYPE_SW, ME_TRIG_EDGE_NONE, ME_IO_SINGLE_CONFIG_NO_FLAGS);
+
+		case ME_TYPE_DO:
+			*dir = ME_DIR_OUTPUT;
+			return meIOSingleConfig(device, subdevice, 0, ME_SINGLE_CONFIG_DIO_OUTPUT, ME_REF_NONE, ME_TRIG_CHAN_NONE, ME_TRIG_TYPE_NONE, ME_TRIG_EDGE_NONE, ME_IO_SINGLE_CONFIG_NO_FLAGS);
+	}
+
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+static void singleEntry(meIOSingle_t* single, int device, int subdevice, int dir, int value)
+{
+	single->iDevice = device;
+	single->iSubdevice = subdevice;
+	single->iChannel = 0;
+	single->iDir = dir;
+	single->iValue = value;
+	single->iTimeOut = 0;
+	single->iFlags = ME_IO_SINGLE_TYPE_NO_FLAGS;
+	single->iErrno = ME_ERRNO_SUCCESS;
+}
+
+/// Free running stream of channel 0, range 0 at opt.rate. Achieved rate is returned in *rate.
+static int streamConfigure(int device, int subdevice, int type, double* rate)
+{
+	meIOStreamConfig_t config;
+	meIOStreamTrigger_t trigger;
+	int err;
+
+	memset(&trigger, 0, sizeof(trigger));
+	*rate = opt.rate;
+	err = meIOStreamFrequencyToTicks(device, subdevice, ME_TIMER_CONV_START, rate, &trigger.iConvStartTicksLow, &trigger.iConvStartTicksHigh, ME_IO_STREAM_FREQUENCY_TO_TICKS_NO_FLAGS);
+	if (err)
+		return err;
+
+	trigger.iAcqStartTrigType = ME_TRIG_TYPE_SW;
+	trigger.iAcqStartTrigEdge = ME_TRIG_EDGE_NONE;
+	trigger.iAcqStartTrigChan = ME_TRIG_CHAN_DEFAULT;
+	trigger.iScanStartTrigType = ME_TRIG_TYPE_FOLLOW;
+	trigger.iConvStartTrigType = ME_TRIG_TYPE_TIMER;
+	trigger.iScanStopTrigType = ME_TRIG_TYPE_NONE;
+	trigger.iAcqStopTrigType = ME_TRIG_TYPE_NONE;
+	trigger.iFlags = ME_IO_STREAM_TRIGGER_TYPE_NO_FLAGS;
+
+	config.iChannel = 0;
+	config.iStreamConfig = 0;
+	config.iRef = (type == ME_TYPE_AO) ? ME_REF_AO_GROUND : ME_REF_AI_GROUND;
+	config.iFlags = ME_IO_STREAM_CONFIG_TYPE_NO_FLAGS;
+
+	meIOResetSubdevice(device, subdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+	return meIOStreamConfig(device, subdevice, &config, 1, &trigger, 0, ME_IO_STREAM_CONFIG_NO_FLAGS);
+}
+
+static int streamStart(int device, int subdevice, int mode)
+{
+	meIOStreamStart_t start;
+
+	start.iDevice = device;
+	start.iSubdevice = subdevice;
+	start.iStartMode = mode;
+	start.iTimeOut = LOOP_TIMEOUT;
+	start.iFlags = ME_IO_STREAM_START_TYPE_NO_FLAGS;
+	start.iErrno = ME_ERRNO_SUCCESS;
+
+	return meIOStreamStart(&start, 1, ME_IO_STREAM_START_NO_FLAGS);
+}
+
+static void streamStop(int device, int subdevice)
+{
+	meIOStreamStop_t stop;
+
+	stop.iDevice = device;
+	stop.iSubdevice = subdevice;
+	stop.iStopMode = ME_STOP_MODE_IMMEDIATE;
+	stop.iFlags = ME_IO_STREAM_STOP_TYPE_NO_FLAGS;
+	stop.iErrno = ME_ERRNO_SUCCESS;
+
+	meIOStreamStop(&stop, 1, ME_IO_STREAM_STOP_NO_FLAGS);
+	meIOResetSubdevice(device, subdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+}
+
+/*===========================================================================
+  Scenarios
+  =========================================================================*/
+
+/// Latency of one meIOSingle() entry for every single capable subdevice.
+static void benchSingle(void)
+{
+	unsigned long long* samples;
+	unsigned long long start;
+	meIOSingle_t single;
+	int devices = numberDevices();
+	int subdevices;
+	int device;
+	int subdevice;
+	int type;
+	int subtype;
+	int dir;
+	int value;
+	int errors;
+	int err;
+	int i;
+
+	samples = calloc(opt.iterations, sizeof(*samples));
+	if (!samples)
+		return;
+
+	for (device = 0; device < devices; device++)
+	{
+		if (!deviceSelected(device) || meQueryNumberSubdevices(device, &subdevices))
+			continue;
+
+		for (subdevice = 0; subdevice < subdevices; subdevice++)
+		{
+			if (meQuerySubdeviceType(device, subdevice, &type, &subtype))
+				continue;
+
+			if ((type != ME_TYPE_AI) && (type != ME_TYPE_AO) && (type != ME_TYPE_DI) && (type != ME_TYPE_DO) && (type != ME_TYPE_DIO))
+				continue;
+
+			if (((type == ME_TYPE_AO) || (type == ME_TYPE_DO)) && !opt.outputs)
+				continue;
+
+			fprintf(stderr, "single: [%d,%d] %s\n", device, subdevice, typeName(type));
+
+			jsonResultBegin("single");
+			jsonInt("device", device);
+			jsonInt("subdevice", subdevice);
+			jsonString("type", typeName(type));
+			jsonBool("remote", deviceRemote(device));
+
+			err = singlePrepare(device, subdevice, type, &dir, &value);
+			if (err)
+			{
+				jsonError(err);
+				jsonClose('}');
+				continue;
+			}
+			jsonString("dir", (dir == ME_DIR_INPUT) ? "input" : "output");
+
+			for (i = 0; i < WARMUP_ITERATIONS; i++)
+			{
+				singleEntry(&single, device, subdevice, dir, value);
+				meIOSingle(&single, 1, ME_IO_SINGLE_NO_FLAGS);
+			}
+
+			errors = 0;
+			err = ME_ERRNO_SUCCESS;
+			for (i = 0; i < opt.iterations; i++)
+			{
+				singleEntry(&single, device, subdevice, dir, value);
+				start = nowNs();
+				if (meIOSingle(&single, 1, ME_IO_SINGLE_NO_FLAGS))
+				{
+					errors++;
+					err = single.iErrno;
+				}
+				samples[i] = nowNs() - start;
+			}
+
+			jsonInt("errors", errors);
+			if (err)
+				jsonError(err);
+			jsonLatency("latency_ns", samples, opt.iterations);
+			jsonClose('}');
+
+			meIOResetSubdevice(device, subdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+		}
+	}
+
+	free(samples);
+}
+
+/// meIOSingle() time vs. number of entries. List reads channel 0 of all input subdevices of device round robin.
+static void benchSingleList(void)
+{
+	unsigned long long* samples;
+	unsigned long long start;
+	unsigned long long sum;
+	meIOSingle_t list[LIST_MAX_COUNT];
+	int inputs[LIST_MAX_COUNT];
+	int inputCount;
+	int devices = numberDevices();
+	int subdevices;
+	int device;
+	int subdevice;
+	int type;
+	int subtype;
+	int dir;
+	int value;
+	int count;
+	int errors;
+	int i;
+	int n;
+
+	samples = calloc(opt.iterations, sizeof(*samples));
+	if (!samples)
+		return;
+
+	for (device = 0; device < devices; device++)
+	{
+		if (!deviceSelected(device) || meQueryNumberSubdevices(device, &subdevices))
+			continue;
+
+		inputCount = 0;
+		for (subdevice = 0; (subdevice < subdevices) && (inputCount < LIST_MAX_COUNT); subdevice++)
+		{
+			if (meQuerySubdeviceType(device, subdevice, &type, &subtype))
+				continue;
+
+			if ((type != ME_TYPE_AI) && (type != ME_TYPE_DI) && (type != ME_TYPE_DIO))
+				continue;
+
+			if (!singlePrepare(device, subdevice, type, &dir, &value))
+				inputs[inputCount++] = subdevice;
+		}
+
+		if (!inputCount)
+			continue;
+
+		fprintf(stderr, "single_list: device %d, %d input subdevice%s\n", device, inputCount, (inputCount > 1) ? "s" : "");
+
+		jsonResultBegin("single_list");
+		jsonInt("device", device);
+		jsonInt("subdevices", inputCount);
+		jsonBool("remote", deviceRemote(device));
+		jsonOpen("lists", '[');
+
+		for (count = 1; count <= LIST_MAX_COUNT; count *= 2)
+		{
+			errors = 0;
+			sum = 0;
+			for (i = -WARMUP_ITERATIONS; i < opt.iterations; i++)
+			{
+				for (n = 0; n < count; n++)
+					singleEntry(&list[n], device, inputs[n % inputCount], ME_DIR_INPUT, 0);
+
+				start = nowNs();
+				if (meIOSingle(list, count, ME_IO_SINGLE_NO_FLAGS) && (i >= 0))
+					errors++;
+				if (i >= 0)
+				{
+					samples[i] = nowNs() - start;
+					sum += samples[i];
+				}
+			}
+
+			jsonOpen(NULL, '{');
+			jsonInt("count", count);
+			jsonInt("errors", errors);
+			jsonDouble("ns_per_entry", (double)sum / opt.iterations / count);
+			jsonLatency("latency_ns", samples, opt.iterations);
+			jsonClose('}');
+		}
+
+		jsonClose(']');
+		jsonClose('}');
+
+		for (i = 0; i < inputCount; i++)
+			meIOResetSubdevice(device, inputs[i], ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+	}
+
+	free(samples);
+}
+
+/// Sustained AI stream throughput vs. size of meIOStreamRead() chunk.
+static void benchAIStream(void)
+{
+	unsigned long long* samples;
+	unsigned long long start;
+	unsigned long long end;
+	unsigned long long call;
+	long long values;
+	int* buffer;
+	int devices = numberDevices();
+	int device;
+	int subdevice;
+	int chunk;
+	int count;
+	int reads;
+	int found = 0;
+	int maxReads;
+	double rate;
+	int err;
+	int c;
+
+	buffer = malloc(STREAM_CHUNK_MAX * sizeof(int));
+	// Faster than one read per 10us is not expected.
+	maxReads = (int)(opt.seconds * 100000) + 1;
+	samples = calloc(maxReads, sizeof(*samples));
+	if (!buffer || !samples)
+		goto EXIT;
+
+	for (device = 0; device < devices; device++)
+	{
+		if (!deviceSelected(device) || meQuerySubdeviceByType(device, -1, ME_TYPE_AI, ME_SUBTYPE_STREAMING, &subdevice))
+			continue;
+
+		found = 1;
+		jsonResultBegin("ai_stream");
+		jsonInt("device", device);
+		jsonInt("subdevice", subdevice);
+		jsonBool("remote", deviceRemote(device));
+		jsonDouble("requested_rate_hz", opt.rate);
+		jsonOpen("chunks", '[');
+
+		for (c = 0; c < sizeof(streamChunks) / sizeof(*streamChunks); c++)
+		{
+			chunk = streamChunks[c];
+			fprintf(stderr, "ai_stream: [%d,%d] chunk %d\n", device, subdevice, chunk);
+
+			jsonOpen(NULL, '{');
+			jsonInt("chunk", chunk);
+
+			err = streamConfigure(device, subdevice, ME_TYPE_AI, &rate);
+			if (!err)
+				err = streamStart(device, subdevice, ME_START_MODE_BLOCKING);
+
+			values = 0;
+			reads = 0;
+			start = nowNs();
+			end = start + (unsigned long long)(opt.seconds * 1e9);
+			while (!err && (nowNs() < end) && (reads < maxReads))
+			{
+				count = chunk;
+				call = nowNs();
+				err = meIOStreamRead(device, subdevice, ME_READ_MODE_BLOCKING, buffer, &count, ME_IO_STREAM_READ_NO_FLAGS);
+				samples[reads++] = nowNs() - call;
+				values += count;
+			}
+			end = nowNs();
+			streamStop(device, subdevice);
+
+			jsonDouble("rate_hz", rate);
+			jsonInt("values", values);
+			jsonDouble("seconds", (end - start) / 1e9);
+			jsonDouble("values_per_s", values / ((end - start) / 1e9));
+			jsonDouble("bytes_per_s", values * sizeof(int) / ((end - start) / 1e9));
+			if (err)
+				jsonError(err);
+			jsonLatency("read_ns", samples, reads);
+			jsonClose('}');
+		}
+
+		jsonClose(']');
+		jsonClose('}');
+	}
+
+	if (!found)
+		jsonSkipped("ai_stream", "no streaming AI subdevice");
+
+EXIT:
+	free(samples);
+	free(buffer);
+}
+
+/// Longest pause between two AO writes that does not underrun the stream.
+static void benchAOUnderrun(void)
+{
+	unsigned long long end;
+	int buffer[AO_CHUNK];
+	int devices = numberDevices();
+	int device;
+	int subdevice;
+	int threshold;
+	int underrun;
+	int status;
+	int count;
+	int unit;
+	double min;
+	double max;
+	int maxData = 0;
+	double rate;
+	int found = 0;
+	int err;
+	int g;
+	int i;
+
+	if (!opt.outputs)
+	{
+		jsonSkipped("ao_underrun", "drives outputs, needs -w");
+		return;
+	}
+
+	for (device = 0; device < devices; device++)
+	{
+		if (!deviceSelected(device) || meQuerySubdeviceByType(device, -1, ME_TYPE_AO, ME_SUBTYPE_STREAMING, &subdevice))
+			continue;
+
+		found = 1;
+		meQueryRangeInfo(device, subdevice, 0, &unit, &min, &max, &maxData);
+		for (i = 0; i < AO_CHUNK; i++)
+			buffer[i] = maxData / 2;
+
+		jsonResultBegin("ao_underrun");
+		jsonInt("device", device);
+		jsonInt("subdevice", subdevice);
+		jsonBool("remote", deviceRemote(device));
+		jsonInt("chunk", AO_CHUNK);
+		jsonDouble("requested_rate_hz", opt.rate);
+		jsonOpen("gaps", '[');
+
+		threshold = -1;
+		rate = opt.rate;
+		for (g = 0; g < sizeof(underrunGaps) / sizeof(*underrunGaps); g++)
+		{
+			fprintf(stderr, "ao_underrun: [%d,%d] gap %dus\n", device, subdevice, underrunGaps[g]);
+
+			err = streamConfigure(device, subdevice, ME_TYPE_AO, &rate);
+			for (i = 0; !err && (i < 4); i++)
+			{
+				count = AO_CHUNK;
+				err = meIOStreamWrite(device, subdevice, ME_WRITE_MODE_PRELOAD, buffer, &count, ME_IO_STREAM_WRITE_NO_FLAGS);
+			}
+			if (!err)
+				err = streamStart(device, subdevice, ME_START_MODE_BLOCKING);
+
+			underrun = 0;
+			end = nowNs() + (unsigned long long)(opt.seconds * 1e9);
+			while (!err && (nowNs() < end))
+			{
+				count = AO_CHUNK;
+				err = meIOStreamWrite(device, subdevice, ME_WRITE_MODE_BLOCKING, buffer, &count, ME_IO_STREAM_WRITE_NO_FLAGS);
+				if (!err)
+					err = meIOStreamStatus(device, subdevice, ME_WAIT_NONE, &status, &count, ME_IO_STREAM_STATUS_NO_FLAGS);
+				if (!err && (status != ME_STATUS_BUSY))
+				{
+					underrun = 1;
+					break;
+				}
+
+				if (underrunGaps[g])
+					usleep(underrunGaps[g]);
+			}
+			streamStop(device, subdevice);
+
+			if ((err == ME_ERRNO_SOFTWARE_BUFFER_UNDERFLOW) || (err == ME_ERRNO_HARDWARE_BUFFER_UNDERFLOW))
+				underrun = 1;
+
+			jsonOpen(NULL, '{');
+			jsonInt("gap_us", underrunGaps[g]);
+			jsonBool("underrun", underrun);
+			if (err && !underrun)
+				jsonError(err);
+			jsonClose('}');
+
+			if (underrun || err)
+				break;
+
+			threshold = underrunGaps[g];
+		}
+
+		jsonClose(']');
+		jsonDouble("rate_hz", rate);
+		jsonDouble("chunk_period_us", AO_CHUNK * 1e6 / rate);
+		jsonInt("threshold_us", threshold);
+		jsonClose('}');
+	}
+
+	if (!found)
+		jsonSkipped("ao_underrun", "no streaming AO subdevice");
+}
+
+/*---------------------------------------------------------------------------
+  Loopback: DO line 0 wired to interrupt input of opt.loopIrqDevice/Subdevice
+  -------------------------------------------------------------------------*/
+
+typedef struct loop_event
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int seen;
+	int err;
+	volatile int stop;
+	unsigned long long time;
+} loop_event_t;
+
+static loop_event_t loopEvent = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0, 0};
+
+static void loopSignal(unsigned long long time, int err)
+{
+	pthread_mutex_lock(&loopEvent.mutex);
+		if (!loopEvent.seen)
+		{
+			loopEvent.time = time;
+			loopEvent.err = err;
+			loopEvent.seen = 1;
+			pthread_cond_signal(&loopEvent.cond);
+		}
+	pthread_mutex_unlock(&loopEvent.mutex);
+}
+
+static void* loopWaitThread(void* arg)
+{
+	int count;
+	int value;
+	int err;
+
+	while (!loopEvent.stop)
+	{
+		err = meIOIrqWait(opt.loopIrqDevice, opt.loopIrqSubdevice, 0, &count, &value, LOOP_TIMEOUT, ME_IO_IRQ_WAIT_NO_FLAGS);
+		if (err == ME_ERRNO_TIMEOUT)
+			continue;
+
+		loopSignal(nowNs(), err);
+		if (err)
+			break;
+	}
+
+	return NULL;
+}
+
+static int loopCallback(int device, int subdevice, int channel, int count, int value, void* context, int status)
+{
+	loopSignal(nowNs(), status);
+
+	return 0;
+}
+
+static int loopWriteDO(int value)
+{
+	meIOSingle_t single;
+
+	singleEntry(&single, opt.loopDODevice, opt.loopDOSubdevice, ME_DIR_OUTPUT, value);
+	return meIOSingle(&single, 1, ME_IO_SINGLE_NO_FLAGS);
+}
+
+/// Time from DO write issued to user space seeing the interrupt (meIOIrqWait() or callback).
+static void benchLoop(const char* scenario, int callback)
+{
+	unsigned long long* samples;
+	unsigned long long start;
+	struct timespec deadline;
+	pthread_t thread;
+	int threadStarted = 0;
+	int timeouts = 0;
+	int count = 0;
+	int type;
+	int subtype;
+	int dir;
+	int value;
+	int err;
+	int i;
+
+	if (!opt.loop || !opt.outputs)
+	{
+		jsonSkipped(scenario, "needs loopback wiring -l and -w");
+		return;
+	}
+
+	samples = calloc(opt.iterations, sizeof(*samples));
+	if (!samples)
+		return;
+
+	fprintf(stderr, "%s: DO [%d,%d] -> IRQ [%d,%d]\n", scenario, opt.loopDODevice, opt.loopDOSubdevice, opt.loopIrqDevice, opt.loopIrqSubdevice);
+
+	jsonResultBegin(scenario);
+	jsonInt("do_device", opt.loopDODevice);
+	jsonInt("do_subdevice", opt.loopDOSubdevice);
+	jsonInt("irq_device", opt.loopIrqDevice);
+	jsonInt("irq_subdevice", opt.loopIrqSubdevice);
+
+	// IRQ subdevice first. It can be the same one as DO (DIO with interrupt line).
+	meIOResetSubdevice(opt.loopIrqDevice, opt.loopIrqSubdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+
+	err = meQuerySubdeviceType(opt.loopDODevice, opt.loopDOSubdevice, &type, &subtype);
+	if (!err && (type != ME_TYPE_DO) && (type != ME_TYPE_DIO))
+		err = ME_ERRNO_INVALID_SUBDEVICE;
+	if (!err)
+		err = singlePrepare(opt.loopDODevice, opt.loopDOSubdevice, ME_TYPE_DO, &dir, &value);
+	if (!err)
+		err = loopWriteDO(0);
+	if (err)
+		goto ERROR;
+
+	loopEvent.stop = 0;
+	loopEvent.seen = 0;
+	if (callback)
+	{
+		err = meIOIrqSetCallback(opt.loopIrqDevice, opt.loopIrqSubdevice, loopCallback, NULL, ME_IO_IRQ_SET_CALLBACK_NO_FLAGS);
+		if (err)
+			goto ERROR;
+	}
+
+	err = meIOIrqStart(opt.loopIrqDevice, opt.loopIrqSubdevice, 0, ME_IRQ_SOURCE_DIO_LINE, ME_IRQ_EDGE_RISING, ME_VALUE_NOT_USED, ME_IO_IRQ_START_NO_FLAGS);
+	if (err)
+		goto ERROR;
+
+	if (!callback)
+	{
+		if (pthread_create(&thread, NULL, loopWaitThread, NULL))
+		{
+			err = ME_ERRNO_INTERNAL;
+			goto ERROR;
+		}
+		threadStarted = 1;
+	}
+
+	for (i = -WARMUP_ITERATIONS; i < opt.iterations; i++)
+	{
+		pthread_mutex_lock(&loopEvent.mutex);
+			loopEvent.seen = 0;
+		pthread_mutex_unlock(&loopEvent.mutex);
+
+		start = nowNs();
+		err = loopWriteDO(1);
+		if (err)
+			break;
+
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += LOOP_TIMEOUT / 1000;
+		pthread_mutex_lock(&loopEvent.mutex);
+			while (!loopEvent.seen)
+			{
+				if (pthread_cond_timedwait(&loopEvent.cond, &loopEvent.mutex, &deadline) == ETIMEDOUT)
+					break;
+			}
+
+			if (!loopEvent.seen)
+			{
+				// Wiring is missing. Do not wait for every iteration.
+				if ((++timeouts >= 10) && !count)
+					err = ME_ERRNO_TIMEOUT;
+			}
+			else if (loopEvent.err)
+				err = loopEvent.err;
+			else if (i >= 0)
+				samples[count++] = loopEvent.time - start;
+		pthread_mutex_unlock(&loopEvent.mutex);
+
+		if (!err)
+			err = loopWriteDO(0);
+		if (err)
+			break;
+	}
+
+ERROR:
+	loopEvent.stop = 1;
+	meIOIrqStop(opt.loopIrqDevice, opt.loopIrqSubdevice, 0, ME_IO_IRQ_STOP_NO_FLAGS);
+	if (threadStarted)
+		pthread_join(thread, NULL);
+	if (callback)
+		meIOIrqSetCallback(opt.loopIrqDevice, opt.loopIrqSubdevice, NULL, NULL, ME_IO_IRQ_SET_CALLBACK_NO_FLAGS);
+	meIOResetSubdevice(opt.loopIrqDevice, opt.loopIrqSubdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+	meIOResetSubdevice(opt.loopDODevice, opt.loopDOSubdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+
+	jsonInt("timeouts", timeouts);
+	if (err)
+		jsonError(err);
+	jsonLatency("latency_ns", samples, count);
+	jsonClose('}');
+
+	free(samples);
+}
+
+static void benchIrq(void)
+{
+	benchLoop("irq", 0);
+}
+
+static void benchCallback(void)
+{
+	benchLoop("callback", 1);
+}
+
+/// Round trip of a minimal request to remote host. Stream throughput of remote devices is in "ai_stream".
+static void benchRPC(void)
+{
+	unsigned long long* samples;
+	unsigned long long start;
+	unsigned long long total;
+	int number;
+	int errors = 0;
+	int err = ME_ERRNO_SUCCESS;
+	int i;
+
+	if (!opt.host)
+	{
+		jsonSkipped("rpc", "needs remote host -r");
+		return;
+	}
+
+	samples = calloc(opt.iterations, sizeof(*samples));
+	if (!samples)
+		return;
+
+	fprintf(stderr, "rpc: %s\n", opt.host);
+
+	jsonResultBegin("rpc");
+	jsonString("host", opt.host);
+
+	total = 0;
+	for (i = -WARMUP_ITERATIONS; i < opt.iterations; i++)
+	{
+		start = nowNs();
+		if (meRQueryNumberDevices(opt.host, &number))
+		{
+			errors++;
+			meErrorGetLast(&err, 0);
+		}
+		if (i >= 0)
+		{
+			samples[i] = nowNs() - start;
+			total += samples[i];
+		}
+	}
+
+	jsonString("call", "meRQueryNumberDevices");
+	jsonInt("errors", errors);
+	if (err)
+		jsonError(err);
+	jsonDouble("calls_per_s", opt.iterations / (total / 1e9));
+	jsonLatency("latency_ns", samples, opt.iterations);
+	jsonClose('}');
+
+	free(samples);
+}
+
+static const scenario_t scenarios[] =
+{
+	{"single",		benchSingle,		"meIOSingle() latency per subdevice (AO/DO with -w)"},
+	{"single_list",	benchSingleList,	"meIOSingle() time vs. number of list entries"},
+	{"ai_stream",	benchAIStream,		"AI stream throughput vs. read chunk size"},
+	{"ao_underrun",	benchAOUnderrun,	"longest AO write pause without underrun (-w)"},
+	{"irq",			benchIrq,			"DO write to meIOIrqWait() return latency (-l, -w)"},
+	{"callback",	benchCallback,		"DO write to IRQ callback latency (-l, -w)"},
+	{"rpc",			benchRPC,			"remote request round trip (-r)"},
+};
+
+#define SCENARIOS_COUNT (sizeof(scenarios) / sizeof(*scenarios))
+
+/*===========================================================================
+  Main
+  =========================================================================*/
+
+static void usage(const char* name)
+{
+	int i;
+
+	fprintf(stderr, "Usage: %s [options] [scenario ...]\n", name);
+	fprintf(stderr, "  -n iterations   latency samples per measurement (%d)\n", opt.iterations);
+	fprintf(stderr, "  -t seconds      duration of one stream measurement (%.1f)\n", opt.seconds);
+	fprintf(stderr, "  -f rate         stream rate in Hz (%.0f)\n", opt.rate);
+	fprintf(stderr, "  -d device       benchmark only this device (all)\n");
+	fprintf(stderr, "  -w              allow scenarios that drive outputs\n");
+	fprintf(stderr, "  -l d:s:d:s      loopback: DO device:subdevice (line 0) wired to IRQ device:subdevice\n");
+	fprintf(stderr, "  -r host         remote host for rpc scenario\n");
+	fprintf(stderr, "  -o file         write JSON to file (stdout)\n");
+	fprintf(stderr, "Scenarios (all when none given):\n");
+	for (i = 0; i < SCENARIOS_COUNT; i++)
+		fprintf(stderr, "  %-12s  %s\n", scenarios[i].name, scenarios[i].help);
+}
+
+static void jsonEnvironment(void)
+{
+	struct utsname uts;
+	char name[ME_DEVICE_NAME_MAX_COUNT];
+	char date[32];
+	time_t now = time(NULL);
+	int vendor, id, serial, bus, busNo, devNo, funcNo, plugged;
+	int version;
+	int devices = numberDevices();
+	int i;
+
+	jsonInt("format", MEBENCH_FORMAT_VERSION);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+	jsonString("date", date);
+
+	if (!uname(&uts))
+	{
+		jsonString("kernel", uts.release);
+		jsonString("machine", uts.machine);
+		jsonString("host", uts.nodename);
+	}
+
+	if (!meQueryVersionLibrary(&version))
+		jsonInt("library_version", version);
+	if (!meQueryVersionMainDriver(&version))
+		jsonInt("driver_version", version);
+
+	jsonOpen("options", '{');
+	jsonInt("iterations", opt.iterations);
+	jsonDouble("seconds", opt.seconds);
+	jsonDouble("rate_hz", opt.rate);
+	jsonInt("device", opt.device);
+	jsonBool("outputs", opt.outputs);
+	jsonClose('}');
+
+	jsonOpen("devices", '[');
+	for (i = 0; i < devices; i++)
+	{
+		jsonOpen(NULL, '{');
+		jsonInt("device", i);
+		if (!meQueryNameDevice(i, name, sizeof(name)))
+			jsonString("name", name);
+		if (!meQueryNameDeviceDriver(i, name, sizeof(name)))
+			jsonString("driver", name);
+		if (!meQueryVersionDeviceDriver(i, &version))
+			jsonInt("driver_version", version);
+		if (!meQueryInfoDevice(i, &vendor, &id, &serial, &bus, &busNo, &devNo, &funcNo, &plugged))
+		{
+			jsonInt("device_id", id);
+			jsonInt("serial", serial);
+			jsonInt("bus_type", bus);
+			jsonBool("plugged", plugged == ME_PLUGGED_IN);
+		}
+		jsonBool("remote", deviceRemote(i));
+		jsonClose('}');
+	}
+	jsonClose(']');
+}
+
+int main(int argc, char *argv[])
+{
+	const char* file = NULL;
+	int selected[SCENARIOS_COUNT];
+	int c;
+	int i;
+	int n;
+
+	while ((c = getopt(argc, argv, "n:t:f:d:wl:r:o:h")) != -1)
+	{
+		switch (c)
+		{
+			case 'n':
+				opt.iterations = atoi(optarg);
+				break;
+
+			case 't':
+				opt.seconds = atof(optarg);
+				break;
+
+			case 'f':
+				opt.rate = atof(optarg);
+				break;
+
+			case 'd':
+				opt.device = atoi(optarg);
+				break;
+
+			case 'w':
+				opt.outputs = 1;
+				break;
+
+			case 'l':
+				if (sscanf(optarg, "%d:%d:%d:%d", &opt.loopDODevice, &opt.loopDOSubdevice, &opt.loopIrqDevice, &opt.loopIrqSubdevice) != 4)
+				{
+					usage(argv[0]);
+					return EXIT_FAILURE;
+				}
+				opt.loop = 1;
+				break;
+
+			case 'r':
+				opt.host = optarg;
+				break;
+
+			case 'o':
+				file = optarg;
+				break;
+
+			default:
+				usage(argv[0]);
+				return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if ((opt.iterations <= 0) || (opt.seconds <= 0) || (opt.rate <= 0))
+	{
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < SCENARIOS_COUNT; i++)
+		selected[i] = (optind == argc);
+
+	for (n = optind; n < argc; n++)
+	{
+		for (i = 0; i < SCENARIOS_COUNT; i++)
+		{
+			if (!strcmp(argv[n], scenarios[i].name))
+				break;
+		}
+
+		if (i == SCENARIOS_COUNT)
+		{
+			fprintf(stderr, "Unknown scenario '%s'.\n", argv[n]);
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		selected[i] = 1;
+	}
+
+	out = stdout;
+	if (file)
+	{
+		out = fopen(file, "w");
+		if (!out)
+		{
+			perror(file);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Errors are reported in results.
+	meErrorSetDefaultProc(ME_SWITCH_DISABLE);
+
+	if (meOpen(ME_OPEN_NO_FLAGS))
+	{
+		fprintf(stderr, "Can not open driver system.\n");
+		return EXIT_FAILURE;
+	}
+
+	fputc('{', out);
+	level = 1;
+	jsonString("tool", "mebench");
+	jsonEnvironment();
+
+	jsonOpen("results", '[');
+	for (i = 0; i < SCENARIOS_COUNT; i++)
+	{
+		if (selected[i])
+			scenarios[i].run();
+	}
+	jsonClose(']');
+	jsonClose('}');
+	fputc('\n', out);
+
+	meClose(ME_CLOSE_NO_FLAGS);
+
+	if (out != stdout)
+		fclose(out);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * Source File : record.tst.c
+ *
+ * Recorder check on simulated device. No hardware needed.
+ * Finite AI stream (ramp waveform) is recorded to file, then file is read back:
+ * recording has to end cleanly, every value has to be either written or counted as dropped,
+ * written values have to continue the ramp.
+ *
+ * Usage: record.tst [file]	(default: /tmp/record.tst.dat)
+ * MEIDS_SIMULATION can be set to other simulation, waveform has to be 'ramp'.
+ *
+ * Author      : KG (Krzysztof Gantzke)     <k.gantzke@meilhaus.de>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <medriver.h>
+#include <meutility.h>
+
+#define Simulation	"sim:devices=1,ai_channels=4,ai_rate=500000,waveform=ramp"
+#define RecordFile	"/tmp/record.tst.dat"
+
+#define ChannelCount	2
+#define Scans		100000
+/// 2 us per conversion (33 MHz base clock).
+#define ConvTicks	66
+#define AIBufSize	0x1000
+
+#define BlockSize	(4 * ME_RECORD_ALIGNMENT)
+#define BlockCount	4
+
+/// Recording takes 0.4 s. Allowed: 10 s.
+#define WaitMax		1000
+#define WaitStep	10000
+
+static int checkFile(char* path, meRecordStatus_t* status)
+{
+	meRecordFileHeader_t* header;
+	meRecordBlockHeader_t* block;
+	uint16_t* samples;
+	FILE* file;
+	unsigned long long expected = 0;
+	unsigned long long dropped = 0;
+	unsigned long long blocks = 0;
+	unsigned int max_data;
+	int header_size;
+	int errors = 0;
+	int i;
+
+	file = fopen(path, "rb");
+	if (!file)
+	{
+		perror(path);
+		return 1;
+	}
+
+	header = malloc(ME_RECORD_ALIGNMENT);
+	block = malloc(BlockSize);
+	// Header with channel list fits into one alignment unit for ChannelCount channels.
+	if (!header || !block || (fread(header, ME_RECORD_ALIGNMENT, 1, file) != 1))
+	{
+		printf("Can not read file header.\n");
+		fclose(file);
+		return 1;
+	}
+
+	header_size = header->iHeaderSize;
+	if (memcmp(header->cMagic, ME_RECORD_FILE_MAGIC, sizeof(header->cMagic)) || (header->iBlockSize != BlockSize)
+		|| (header->iChannelCount != ChannelCount) || (header->iErrno != ME_ERRNO_SUCCESS)
+		|| (header->ullSamples != status->ullSamples) || (header->ullDroppedSamples != status->ullDroppedSamples))
+	{
+		printf("File header: block size=%d channels=%d errno=%d samples=%llu dropped=%llu\n",
+				header->iBlockSize, header->iChannelCount, header->iErrno, header->ullSamples, header->ullDroppedSamples);
+		errors++;
+	}
+
+	// Ramp: value is sample's index modulo (max_data + 1).
+	max_data = header->Channels[0].iMaxData;
+
+	fseek(file, header_size, SEEK_SET);
+	while (fread(block, BlockSize, 1, file) == 1)
+	{
+		samples = (uint16_t *)(block + 1);
+
+		if ((block->uiMagic != ME_RECORD_BLOCK_MAGIC) || (block->uiSequence != blocks))
+		{
+			printf("Block %llu: magic=0x%08x sequence=%u\n", blocks, block->uiMagic, block->uiSequence);
+			errors++;
+			break;
+		}
+
+		if (block->ullFirstSample != expected + block->ullDroppedBefore)
+		{
+			printf("Block %llu: first sample %llu, expected %llu + %llu dropped\n", blocks, block->ullFirstSample, expected, block->ullDroppedBefore);
+			errors++;
+		}
+		dropped += block->ullDroppedBefore;
+		expected = block->ullFirstSample;
+
+		for (i = 0; i < block->uiSampleCount; i++)
+		{
+			if (samples[i] != (expected + i) % (max_data + 1))
+			{
+				printf("Block %llu [%d]: %u, expected %llu\n", blocks, i, samples[i], (expected + i) % (max_data + 1));
+				errors++;
+				break;
+			}
+		}
+
+		expected += block->uiSampleCount;
+		blocks++;
+	}
+
+	if ((blocks != status->ullBlocks) || (expected - dropped != status->ullSamples))
+	{
+		printf("File: %llu blocks, %llu samples. Status: %llu blocks, %llu samples.\n", blocks, expected - dropped, status->ullBlocks, status->ullSamples);
+		errors++;
+	}
+
+	free(block);
+	free(header);
+	fclose(file);
+
+	return errors;
+}
+
+int main(int argc, char *argv[])
+{
+	char* path = (argc > 1) ? argv[1] : RecordFile;
+	meIOStreamConfig_t ConfigList[ChannelCount];
+	meIOStreamTrigger_t Trigger;
+	meIOStreamStart_t StartList;
+	meRecordOptions_t Options;
+	meRecordStatus_t Status;
+	int NoDev = 0;
+	int NoSubDev = 0;
+	int err;
+	int i;
+
+	setenv("MEIDS_SIMULATION", Simulation, 0);
+
+	if (meOpen(ME_OPEN_NO_FLAGS))
+		return EXIT_FAILURE;
+
+	if (meQuerySubdeviceByType(NoDev, NoSubDev, ME_TYPE_AI, ME_SUBTYPE_STREAMING, &NoSubDev))
+	{
+		printf("No AI streaming subdevice. Is MEIDS_SIMULATION set?\n");
+		meClose(ME_CLOSE_NO_FLAGS);
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < ChannelCount; i++)
+	{
+		ConfigList[i].iChannel = i;
+		ConfigList[i].iStreamConfig = 0;
+		ConfigList[i].iRef = ME_REF_AI_GROUND;
+		ConfigList[i].iFlags = ME_IO_STREAM_CONFIG_TYPE_NO_FLAGS;
+	}
+
+	memset(&Trigger, 0, sizeof(meIOStreamTrigger_t));
+	Trigger.iAcqStartTrigType = ME_TRIG_TYPE_SW;
+	Trigger.iAcqStartTrigEdge = ME_TRIG_EDGE_NONE;
+	Trigger.iAcqStartTrigChan = ME_TRIG_CHAN_DEFAULT;
+	Trigger.iScanStartTrigType = ME_TRIG_TYPE_FOLLOW;
+	Trigger.iConvStartTrigType = ME_TRIG_TYPE_TIMER;
+	Trigger.iConvStartTicksLow = ConvTicks;
+	Trigger.iScanStopTrigType = ME_TRIG_TYPE_NONE;
+	Trigger.iAcqStopTrigType = ME_TRIG_TYPE_COUNT;
+	Trigger.iAcqStopCount = Scans;
+	Trigger.iFlags = ME_IO_STREAM_TRIGGER_TYPE_NO_FLAGS;
+
+	meIOResetSubdevice(NoDev, NoSubDev, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+	err = meIOStreamConfig(NoDev, NoSubDev, ConfigList, ChannelCount, &Trigger, AIBufSize, ME_IO_STREAM_CONFIG_NO_FLAGS);
+	if (err)
+		goto EXIT;
+
+	memset(&Options, 0, sizeof(meRecordOptions_t));
+	Options.pConfigList = ConfigList;
+	Options.iConfigListCount = ChannelCount;
+	Options.dConvRate = 33E6 / ConvTicks;
+	Options.iBlockSize = BlockSize;
+	Options.iBlockCount = BlockCount;
+	Options.iFlags = ME_RECORD_NO_FLAGS;
+
+	err = meRecordStart(NoDev, NoSubDev, path, &Options);
+	if (err)
+		goto EXIT;
+
+	StartList.iDevice = NoDev;
+	StartList.iSubdevice = NoSubDev;
+	StartList.iStartMode = ME_START_MODE_BLOCKING;
+	StartList.iTimeOut = 0;
+	StartList.iFlags = ME_IO_STREAM_START_TYPE_NO_FLAGS;
+	StartList.iErrno = ME_ERRNO_SUCCESS;
+	err = meIOStreamStart(&StartList, 1, ME_IO_STREAM_START_NO_FLAGS);
+	if (err)
+	{
+		meRecordStop(NoDev, NoSubDev, NULL);
+		goto EXIT;
+	}
+
+	// Recorder ends itself with the stream.
+	for (i = 0; i < WaitMax; i++)
+	{
+		meRecordStatus(NoDev, NoSubDev, &Status);
+		if (Status.iStatus != ME_STATUS_BUSY)
+			break;
+		usleep(WaitStep);
+	}
+
+	err = meRecordStop(NoDev, NoSubDev, &Status);
+	printf("Recorder: status=%s errno=%d samples=%llu blocks=%llu dropped=%llu in %llu gaps\n",
+			(Status.iStatus == ME_STATUS_IDLE) ? "idle" : (Status.iStatus == ME_STATUS_BUSY) ? "busy" : "error",
+			Status.iErrno, Status.ullSamples, Status.ullBlocks, Status.ullDroppedSamples, Status.ullDroppedBlocks);
+
+	if (i == WaitMax)
+	{
+		printf("Recorder did not end with the stream.\n");
+		err = ME_ERRNO_TIMEOUT;
+	}
+	else if (err || (Status.iStatus != ME_STATUS_IDLE) || Status.iErrno)
+	{
+		printf("End of stream is reported as error.\n");
+		if (!err)
+			err = Status.iErrno ? Status.iErrno : ME_ERRNO_INTERNAL;
+	}
+	else if (Status.ullSamples + Status.ullDroppedSamples != (unsigned long long)Scans * ChannelCount)
+	{
+		printf("Lost values: %llu written + %llu dropped, expected %d.\n", Status.ullSamples, Status.ullDroppedSamples, Scans * ChannelCount);
+		err = ME_ERRNO_INTERNAL;
+	}
+	else if (checkFile(path, &Status))
+	{
+		err = ME_ERRNO_INTERNAL;
+	}
+
+EXIT:
+	meIOResetSubdevice(NoDev, NoSubDev, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+	meClose(ME_CLOSE_NO_FLAGS);
+
+	printf("Recorder on simulated device: %s\n", (err) ? "FAILED" : "OK");
+	return (err) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
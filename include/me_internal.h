@@ -87,6 +87,10 @@
 #   define ME_NAME_DRIVER							"meMEPHISTO"
 #   define ME_NAME_NODE								"mephistoSC"
 #   define MEPHISTO_NAME							"MephistoScope"
+#  elif defined(ME_VIRTUAL)
+#   define ME_NAME_DRIVER							"meVIRTUAL"
+#   define ME_NAME_NODE								"medriverVIRTUAL"
+#   define MEVIRTUAL_NAME							"meVIRTUAL"
 #  else
 #   error NO VALID DRIVER TYPE declared!
 #  endif
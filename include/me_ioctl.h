@@ -97,6 +97,12 @@
 
 # define ME_SET_OFFSET						_IOW (MEMAIN_MAGIC, 45, me_set_offset_t)
 
+# define ME_QUERY_TOPOLOGY					_IOWR(MEMAIN_MAGIC, 46, me_query_topology_t)
+
+# define ME_QUERY_LATENCY_PROBE				_IOWR(MEMAIN_MAGIC, 47, me_query_latency_probe_t)
+
+# define ME_IO_STREAM_READER				_IOWR(MEMAIN_MAGIC, 48, me_io_stream_reader_t)
+
 # define ME_CONFIG_LOAD						_IOWR(MEMAIN_MAGIC, 63, me_extra_param_set_t)
 
 #endif
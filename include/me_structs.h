@@ -184,6 +184,17 @@ typedef struct //me_io_stream_status
 	int err_no;
 } me_io_stream_status_t;
 
+typedef struct //me_io_stream_reader
+{
+	int device;
+	int subdevice;
+	int mode;
+	int policy;
+	int dropped;
+	int flags;
+	int err_no;
+} me_io_stream_reader_t;
+
 typedef struct //me_io_stream_stop_simple
 {
 	int device;
@@ -457,4 +468,99 @@ typedef struct //me_query_type_driver
 	int type;
 } me_query_type_driver_t;
 
+///  Types for the topology snapshot
+/**
+ * The snapshot is a packed, versioned blob. All fields are 32 bit wide, so the layout is the same for 32 and 64 bit applications.
+ * It is serialized sequentially (records are not aligned):
+ *	me_topology_header_t
+ *	for every device:		me_topology_device_t
+ *		for every subdevice:	me_topology_subdevice_t
+ *			for every range:	me_topology_range_t
+ */
+# define ME_TOPOLOGY_MAGIC					0x4D45544F	// "METO"
+# define ME_TOPOLOGY_VERSION				0x00010000
+
+# define ME_TOPOLOGY_NAME_COUNT				64
+# define ME_TOPOLOGY_DESCRIPTION_COUNT		256
+
+/// ME_TIMER_ACQ_START, ME_TIMER_SCAN_START and ME_TIMER_CONV_START.
+# define ME_TOPOLOGY_TIMERS					3
+
+typedef struct //me_topology_header
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int size;					/**< Size of whole snapshot in bytes. Header included. */
+	unsigned int number_devices;
+} me_topology_header_t;
+
+typedef struct //me_topology_device
+{
+	int err_no;							/**< Error of device queries. */
+	int vendor_id;
+	int device_id;
+	int serial_no;
+	int bus_type;
+	int bus_no;
+	int dev_no;
+	int func_no;
+	int plugged;
+	int version;						/**< Version of device driver. */
+	char name[ME_TOPOLOGY_NAME_COUNT];
+	char description[ME_TOPOLOGY_DESCRIPTION_COUNT];
+	char driver_name[ME_TOPOLOGY_NAME_COUNT];
+	unsigned int number_subdevices;
+} me_topology_device_t;
+
+typedef struct //me_topology_timer
+{
+	int err_no;							/**< ME_ERRNO_INVALID_TIMER when subdevice has not this timer. */
+	int base_frequency;
+	unsigned int min_ticks_low;
+	unsigned int min_ticks_high;
+	unsigned int max_ticks_low;
+	unsigned int max_ticks_high;
+} me_topology_timer_t;
+
+typedef struct //me_topology_subdevice
+{
+	int err_no;							/**< Error of type, channels or ranges queries. */
+	int type;
+	int subtype;
+	int number_channels;
+	int caps;
+	me_topology_timer_t timer[ME_TOPOLOGY_TIMERS];
+	unsigned int number_ranges;
+} me_topology_subdevice_t;
+
+typedef struct //me_topology_range
+{
+	int unit;
+	int min;							/**< [uV] */
+	int max;							/**< [uV] */
+	int max_data;
+} me_topology_range_t;
+
+typedef struct //me_query_topology
+{
+	char* buffer;
+	int size;							/**< In: size of buffer. Out: size of snapshot. */
+	int err_no;
+} me_query_topology_t;
+
+///  Types for the latency probe
+/**
+ * Time stamps are CLOCK_MONOTONIC in ns, the clock of clock_gettime(CLOCK_MONOTONIC) in user space. 0 means 'not yet'.
+ */
+typedef struct //me_query_latency_probe
+{
+	uint64_t write_time;				/**< Output subdevices: last single write, taken just before the register write. */
+	uint64_t irq_time;					/**< Interrupt subdevices: entry of the last handled interrupt. */
+	uint64_t wake_time;					/**< Interrupt subdevices: last waiter woken up by an interrupt, before leaving the driver. */
+	int irq_count;						/**< Interrupt count at irq_time. */
+	int device;
+	int subdevice;
+	int err_no;
+} me_query_latency_probe_t;
+
 #endif	//_ME_STRUCTS_H_
@@ -38,6 +38,7 @@ typedef struct meids_calls
 	int  (*QueryRangeInfo)(void*, int, int, int, int*, double* min, double*, unsigned int*, int);
 	int  (*QueryRangeByMinMax)(void*, int, int, int, double* min, double*, int*, int*, int);
 	int  (*QuerySubdeviceTimer)(void*, int, int, int, int*, int*, int*, int*, int*, int);
+	int  (*QueryLatencyProbe)(void*, int, int, meLatencyProbe_t*, int);
 
 //Input/Output
 	int  (*IrqStart)(void*, int, int, int, int, int, int, int);
@@ -62,6 +63,7 @@ typedef struct meids_calls
 	int  (*StreamStart)(void*, int, int, int, int, int);
 	int  (*StreamStartList)(void*, meIOStreamStart_t*, int, int);
 	int  (*StreamStatus)(void*, int, int, int, int*, int*, int);
+	int  (*StreamReader)(void*, int, int, int, int, int*, int);
 	int  (*StreamStop)(void*, int, int, int, int, int);
 	int  (*StreamStopList)(void*, meIOStreamStop_t*, int, int);
 
@@ -116,6 +118,7 @@ typedef enum me_context_type
 	me_context_type_invalid = 0,	//Begin of enumeration
 	me_context_type_local,		//PCI and USB
 	me_context_type_remote,		//RPC
+	me_context_type_simulated,	//In-process simulated devices
 	me_context_type_max			//End of enumeration
 }me_context_type_t;
 
@@ -167,6 +170,10 @@ typedef struct ME_RPC_Context
 	CLIENT* fd;
 	// Protect RPC context
 	pthread_mutex_t rpc_mutex;
+	// Compact stream encodings accepted by server (ME_RPC_ENCODING_*). 0: plain XDR transfers.
+	int stream_encodings;
+	// Pushed IRQ and stream events (meids_rpc_event.c). NULL till first callback is registered.
+	struct me_rpc_event_channel* event_channel;
 
 	pthread_mutex_t callbackContextMutex;
 	threadsList_t* activeThreads;
@@ -179,6 +186,24 @@ typedef struct ME_RPC_Context
 	pid_t pid;
 }me_rpc_context_t;
 
+struct ME_Sim_Device;
+
+typedef struct ME_Sim_Context
+{
+	/// @note Table of calls MUST BE a first element in context struct!
+	meids_calls_t* context_calls;
+	me_context_type_t context_type;
+
+	pthread_mutex_t callbackContextMutex;
+	threadsList_t* activeThreads;
+
+	// Simulated hardware. Built from address by Open_Sim().
+	int device_count;
+	struct ME_Sim_Device* device_list;
+	// Time spent in every call [us].
+	int latency;
+}me_sim_context_t;
+
 typedef enum me_cfg_extention_type
 {
 	me_cfg_extention_type_invalid =		0x00000000,
@@ -197,6 +222,7 @@ typedef enum me_access_type
 	me_access_type_TCPIP,					//Synapse-LAN
 	me_access_type_USB,						//Synapse-USB & Mephisto-Family
 	me_access_type_USB_MephistoScope,		//Mephisto-Scope
+	me_access_type_simulated,				//In-process simulated devices
 	me_access_type_max						//End of enumeration
 }me_access_type_t;
 
@@ -290,12 +316,63 @@ typedef struct me_cfg_subdevice_info
 }
 me_cfg_subdevice_info_t;
 
+// Query cache. Immutable answers of driver. Plain data only - entries are copied with memcpy().
+# define ME_CFG_CACHE_TYPE				0x00000001
+# define ME_CFG_CACHE_CHANNELS			0x00000002
+# define ME_CFG_CACHE_CAPS				0x00000004
+# define ME_CFG_CACHE_RANGES_NUMBER		0x00000008
+# define ME_CFG_CACHE_TIMER				0x00000010	// First of ME_CFG_CACHE_TIMERS bits.
+
+# define ME_CFG_CACHE_TIMERS			3			// ME_TIMER_ACQ_START, ME_TIMER_SCAN_START and ME_TIMER_CONV_START.
+# define ME_CFG_CACHE_RANGES			16
+# define ME_CFG_CACHE_CAPS_ARGS			8
+# define ME_CFG_CACHE_ARGS				4
+
+typedef struct me_cfg_timer_cache
+{
+	int base;
+	int min_ticks_low;
+	int min_ticks_high;
+	int max_ticks_low;
+	int max_ticks_high;
+}
+me_cfg_timer_cache_t;
+
+typedef struct me_cfg_caps_args_cache
+{
+	int cap;
+	int count;
+	int args[ME_CFG_CACHE_ARGS];
+}
+me_cfg_caps_args_cache_t;
+
+typedef struct me_cfg_query_cache
+{
+	unsigned int valid;						// ME_CFG_CACHE_* bits.
+	unsigned int ranges_valid;				// 1 bit for every range.
+
+	int type;
+	int sub_type;
+	unsigned int channels;
+	int caps;
+	int ranges_number;						// For ME_UNIT_ANY.
+
+	me_cfg_range_info_t ranges[ME_CFG_CACHE_RANGES];
+	me_cfg_timer_cache_t timers[ME_CFG_CACHE_TIMERS];
+
+	me_cfg_caps_args_cache_t caps_args[ME_CFG_CACHE_CAPS_ARGS];
+	unsigned int caps_args_count;
+}
+me_cfg_query_cache_t;
+
 typedef struct me_cfg_subdevice_entry
 {
 	int locked;
 	me_cfg_subdevice_info_t info;
 
 	me_cfg_extention_t extention;
+
+	me_cfg_query_cache_t cache;
 }
 me_cfg_subdevice_entry_t;
 
@@ -1,9 +1,260 @@
 #include <stdlib.h>
+#include <pthread.h>
 #include <jni.h>
 #include "MeDriver.h"
 #include <medriver/medriver.h>
 
 
+/*===========================================================================
+  Callbacks called from the library's threads
+  =========================================================================*/
+
+/* Global references to Java callbacks registered for one subdevice.
+ * Entries are never freed. The library's threads keep a pointer to them. */
+typedef struct me_java_callbacks {
+	struct me_java_callbacks *next;
+	int iDevice;
+	int iSubdevice;
+	jobject irqCB;
+	jobject startCB;
+	jobject newValuesCB;
+	jobject endCB;
+} me_java_callbacks_t;
+
+static JavaVM *me_java_vm = NULL;
+static jmethodID me_java_irq_mid = NULL;
+static jmethodID me_java_stream_mid = NULL;
+static jmethodID me_java_new_values_mid = NULL;
+
+static pthread_mutex_t me_java_callbacks_mutex = PTHREAD_MUTEX_INITIALIZER;
+static me_java_callbacks_t *me_java_callbacks_list = NULL;
+
+static pthread_key_t me_java_thread_key;
+static pthread_once_t me_java_thread_once = PTHREAD_ONCE_INIT;
+
+static void me_java_DetachThread(void *arg){
+	(*me_java_vm)->DetachCurrentThread(me_java_vm);
+}
+
+static void me_java_CreateThreadKey(void){
+	pthread_key_create(&me_java_thread_key, me_java_DetachThread);
+}
+
+/* Library's thread is attached once and detached when it ends. */
+static JNIEnv *me_java_AttachThread(void){
+	JNIEnv *env;
+
+	if((*me_java_vm)->GetEnv(me_java_vm, (void **) &env, JNI_VERSION_1_4) == JNI_OK)
+		return env;
+
+	if((*me_java_vm)->AttachCurrentThreadAsDaemon(me_java_vm, (void **) &env, NULL) != JNI_OK)
+		return NULL;
+
+	pthread_setspecific(me_java_thread_key, env);
+
+	return env;
+}
+
+/* Method IDs are taken here. Classes can not be found from the library's threads. */
+static int me_java_InitCallbacks(JNIEnv *env){
+	jclass cls;
+
+	if(!me_java_vm && (*env)->GetJavaVM(env, &me_java_vm))
+		return -1;
+
+	pthread_once(&me_java_thread_once, me_java_CreateThreadKey);
+
+	if(!me_java_irq_mid){
+		if(!(cls = (*env)->FindClass(env, "de/meilhaus/medriver/MeIrqCallback"))) return -1;
+		if(!(me_java_irq_mid = (*env)->GetMethodID(env, cls, "irq", "(IIIIII)I"))) return -1;
+	}
+
+	if(!me_java_stream_mid){
+		if(!(cls = (*env)->FindClass(env, "de/meilhaus/medriver/MeIOStreamCallback"))) return -1;
+		if(!(me_java_stream_mid = (*env)->GetMethodID(env, cls, "stream", "(IIII)I"))) return -1;
+	}
+
+	if(!me_java_new_values_mid){
+		if(!(cls = (*env)->FindClass(env, "de/meilhaus/medriver/MeIOStreamNewValuesCallback"))) return -1;
+		if(!(me_java_new_values_mid = (*env)->GetMethodID(env, cls, "newValues", "(II[II)I"))) return -1;
+	}
+
+	return 0;
+}
+
+static me_java_callbacks_t *me_java_GetCallbacks(int iDevice, int iSubdevice){
+	me_java_callbacks_t *callbacks;
+
+	pthread_mutex_lock(&me_java_callbacks_mutex);
+		for(callbacks = me_java_callbacks_list; callbacks; callbacks = callbacks->next){
+			if((callbacks->iDevice == iDevice) && (callbacks->iSubdevice == iSubdevice))
+				break;
+		}
+
+		if(!callbacks && (callbacks = calloc(1, sizeof(me_java_callbacks_t)))){
+			callbacks->iDevice = iDevice;
+			callbacks->iSubdevice = iSubdevice;
+			callbacks->next = me_java_callbacks_list;
+			me_java_callbacks_list = callbacks;
+		}
+	pthread_mutex_unlock(&me_java_callbacks_mutex);
+
+	return callbacks;
+}
+
+/* Stores new global reference in slot. Old one is returned. */
+static jobject me_java_SwapCallback(jobject *slot, jobject callback){
+	jobject old;
+
+	pthread_mutex_lock(&me_java_callbacks_mutex);
+		old = *slot;
+		*slot = callback;
+	pthread_mutex_unlock(&me_java_callbacks_mutex);
+
+	return old;
+}
+
+/* Local reference to callback in slot. Callback can replace itself while it runs. */
+static jobject me_java_GetCallback(JNIEnv *env, jobject *slot){
+	jobject callback = NULL;
+
+	pthread_mutex_lock(&me_java_callbacks_mutex);
+		if(*slot)
+			callback = (*env)->NewLocalRef(env, *slot);
+	pthread_mutex_unlock(&me_java_callbacks_mutex);
+
+	return callback;
+}
+
+/* Exceptions can not be thrown to anybody. They are reported. */
+static int me_java_CheckException(JNIEnv *env){
+	if(!(*env)->ExceptionCheck(env))
+		return 0;
+
+	(*env)->ExceptionDescribe(env);
+	(*env)->ExceptionClear(env);
+
+	return 1;
+}
+
+static int me_java_IrqCB(int iDevice, int iSubdevice, int iChannel, int iIrqCount, int iValue, void *pvContext, int iErrorCode){
+	me_java_callbacks_t *callbacks = pvContext;
+	JNIEnv *env;
+	jobject callback;
+	int iResult = 0;
+
+	if(!(env = me_java_AttachThread()))
+		return iResult;
+
+	if((callback = me_java_GetCallback(env, &callbacks->irqCB))){
+		iResult = (*env)->CallIntMethod(env, callback, me_java_irq_mid, iDevice, iSubdevice, iChannel, iIrqCount, iValue, iErrorCode);
+		if(me_java_CheckException(env))
+			iResult = 0;
+		(*env)->DeleteLocalRef(env, callback);
+	}
+
+	return iResult;
+}
+
+static int me_java_StreamCB(jobject *slot, int iDevice, int iSubdevice, int iCount, int iErrorCode){
+	JNIEnv *env;
+	jobject callback;
+	int iResult = 0;
+
+	if(!(env = me_java_AttachThread()))
+		return iResult;
+
+	if((callback = me_java_GetCallback(env, slot))){
+		iResult = (*env)->CallIntMethod(env, callback, me_java_stream_mid, iDevice, iSubdevice, iCount, iErrorCode);
+		if(me_java_CheckException(env))
+			iResult = 0;
+		(*env)->DeleteLocalRef(env, callback);
+	}
+
+	return iResult;
+}
+
+static int me_java_StreamStartCB(int iDevice, int iSubdevice, int iCount, void *pvContext, int iErrorCode){
+	return me_java_StreamCB(&((me_java_callbacks_t *) pvContext)->startCB, iDevice, iSubdevice, iCount, iErrorCode);
+}
+
+static int me_java_StreamEndCB(int iDevice, int iSubdevice, int iCount, void *pvContext, int iErrorCode){
+	return me_java_StreamCB(&((me_java_callbacks_t *) pvContext)->endCB, iDevice, iSubdevice, iCount, iErrorCode);
+}
+
+/* Values are read here. Java gets them in one array, with one call. */
+static int me_java_StreamNewValuesCB(int iDevice, int iSubdevice, int iCount, void *pvContext, int iErrorCode){
+	me_java_callbacks_t *callbacks = pvContext;
+	JNIEnv *env;
+	jobject callback;
+	jintArray valuesArray;
+	int *piValues = NULL;
+	int iResult = 1;
+
+	if(!(env = me_java_AttachThread()))
+		return iResult;
+
+	if(!(callback = me_java_GetCallback(env, &callbacks->newValuesCB)))
+		return iResult;
+
+	if(iErrorCode || (iCount < 0))
+		iCount = 0;
+
+	if(iCount){
+		if((piValues = malloc(sizeof(int) * iCount))){
+			iErrorCode = meIOStreamRead(iDevice, iSubdevice, ME_READ_MODE_NONBLOCKING, piValues, &iCount, ME_IO_STREAM_READ_NO_FLAGS);
+			if(iErrorCode)
+				iCount = 0;
+		}
+		else{
+			iErrorCode = ME_ERRNO_INTERNAL;
+			iCount = 0;
+		}
+	}
+
+	if((valuesArray = (*env)->NewIntArray(env, iCount))){
+		if(iCount)
+			(*env)->SetIntArrayRegion(env, valuesArray, 0, iCount, piValues);
+
+		iResult = (*env)->CallIntMethod(env, callback, me_java_new_values_mid, iDevice, iSubdevice, valuesArray, iErrorCode);
+		if(me_java_CheckException(env))
+			iResult = 1;
+		(*env)->DeleteLocalRef(env, valuesArray);
+	}
+	else{
+		me_java_CheckException(env);
+	}
+
+	free(piValues);
+	(*env)->DeleteLocalRef(env, callback);
+
+	return iResult;
+}
+
+/* Library cancels all callbacks of subdevice at once. */
+static void me_java_ClearCallbacks(JNIEnv *env, me_java_callbacks_t *callbacks){
+	jobject *slots[] = {&callbacks->irqCB, &callbacks->startCB, &callbacks->newValuesCB, &callbacks->endCB};
+	jobject old;
+	int i;
+
+	for(i = 0; i < (int) (sizeof(slots) / sizeof(slots[0])); i++){
+		if((old = me_java_SwapCallback(slots[i], NULL)))
+			(*env)->DeleteGlobalRef(env, old);
+	}
+}
+
+/* Throws java.io.IOException for driver's error. */
+static void me_java_ThrowError(JNIEnv *env, int err){
+	char error[ME_ERROR_MSG_MAX_COUNT];
+	jclass exc;
+
+	meErrorGetMessage(err, error, sizeof(error));
+	exc = (*env)->FindClass(env, "java/io/IOException");
+	if(!exc) return;
+	(*env)->ThrowNew(env, exc, error);
+}
+
+
 JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meOpen(JNIEnv *env, jobject obj, jint iFlags){
 	int err;
 	char error[ME_ERROR_MSG_MAX_COUNT];
@@ -198,6 +449,57 @@ JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOIrqWait(
 }
 
 
+JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOIrqSetCallback(
+		JNIEnv *env,
+	   	jobject obj,
+	   	jint iDevice,
+	   	jint iSubdevice,
+	   	jobject callback,
+	   	jint iFlags){
+	int err;
+	me_java_callbacks_t *callbacks;
+	jobject old;
+	jclass exc;
+
+	if(me_java_InitCallbacks(env))
+		return;
+
+	if(!(callbacks = me_java_GetCallbacks(iDevice, iSubdevice))){
+		exc = (*env)->FindClass(env, "java/lang/OutOfMemoryError");
+		if(!exc) return;
+		(*env)->ThrowNew(env, exc, "Cannot get memory for callbacks");
+		return;
+	}
+
+	if(!callback){
+		/* Cancels all callbacks of subdevice. */
+		err = meIOIrqSetCallback(iDevice, iSubdevice, NULL, NULL, iFlags);
+		if(!err)
+			me_java_ClearCallbacks(env, callbacks);
+	}
+	else{
+		/* Set before the thread is created. Restored on error. */
+		if(!(callback = (*env)->NewGlobalRef(env, callback)))
+			return;
+		old = me_java_SwapCallback(&callbacks->irqCB, callback);
+
+		err = meIOIrqSetCallback(iDevice, iSubdevice, me_java_IrqCB, callbacks, iFlags);
+		if(err)
+			old = me_java_SwapCallback(&callbacks->irqCB, old);
+
+		if(old)
+			(*env)->DeleteGlobalRef(env, old);
+	}
+
+	if(err){
+		me_java_ThrowError(env, err);
+		return;
+	}
+
+	return;
+}
+
+
 JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOResetDevice(
 		JNIEnv *env,
 	   	jobject obj,
@@ -673,6 +975,213 @@ JNIEXPORT jintArray JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamWrite(
 }
 
 
+/* Values moved at once between Java arrays (or 16 bit buffers) and the driver system. */
+#define ME_JAVA_CHUNK_COUNT		4096
+
+/* Stream is read in chunks through the stack. Java array is not pinned while the driver waits. */
+JNIEXPORT jint JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamReadArray(
+		JNIEnv *env,
+	   	jobject obj,
+	   	jint iDevice,
+	   	jint iSubdevice,
+	   	jint iReadMode,
+	   	jintArray valuesArray,
+	   	jint iOffset,
+	   	jint iCount,
+	   	jint iFlags){
+	int err = ME_ERRNO_SUCCESS;
+	int piChunk[ME_JAVA_CHUNK_COUNT];
+	int iRequested;
+	int iChunk;
+	int iRead = 0;
+
+	while(iRead < iCount){
+		iRequested = (iCount - iRead < ME_JAVA_CHUNK_COUNT) ? (iCount - iRead) : ME_JAVA_CHUNK_COUNT;
+		iChunk = iRequested;
+		err = meIOStreamRead(iDevice, iSubdevice, iReadMode, piChunk, &iChunk, iFlags);
+		if(err)
+			break;
+
+		(*env)->SetIntArrayRegion(env, valuesArray, iOffset + iRead, iChunk, piChunk);
+		iRead += iChunk;
+
+		if(iChunk < iRequested)
+			break;
+	}
+
+	if(err){
+		me_java_ThrowError(env, err);
+		return 0;
+	}
+
+	return iRead;
+}
+
+
+JNIEXPORT jint JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamWriteArray(
+		JNIEnv *env,
+	   	jobject obj,
+	   	jint iDevice,
+	   	jint iSubdevice,
+	   	jint iWriteMode,
+	   	jintArray valuesArray,
+	   	jint iOffset,
+	   	jint iCount,
+	   	jint iFlags){
+	int err = ME_ERRNO_SUCCESS;
+	int piChunk[ME_JAVA_CHUNK_COUNT];
+	int iRequested;
+	int iChunk;
+	int iWritten = 0;
+
+	while(iWritten < iCount){
+		iRequested = (iCount - iWritten < ME_JAVA_CHUNK_COUNT) ? (iCount - iWritten) : ME_JAVA_CHUNK_COUNT;
+		(*env)->GetIntArrayRegion(env, valuesArray, iOffset + iWritten, iRequested, piChunk);
+
+		iChunk = iRequested;
+		err = meIOStreamWrite(iDevice, iSubdevice, iWriteMode, piChunk, &iChunk, iFlags);
+		if(err)
+			break;
+
+		iWritten += iChunk;
+
+		if(iChunk < iRequested)
+			break;
+	}
+
+	if(err){
+		me_java_ThrowError(env, err);
+		return 0;
+	}
+
+	return iWritten;
+}
+
+
+/* 32 bit values go straight to/from the buffer. 16 bit values are converted in chunks through the stack. */
+JNIEXPORT jint JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamReadDirect(
+		JNIEnv *env,
+	   	jobject obj,
+	   	jint iDevice,
+	   	jint iSubdevice,
+	   	jint iReadMode,
+	   	jobject buffer,
+	   	jint iByteOffset,
+	   	jint iCount,
+	   	jint iElementSize,
+	   	jint iFlags){
+	int err = ME_ERRNO_SUCCESS;
+	char *pcBuffer;
+	unsigned short *psValues;
+	int piChunk[ME_JAVA_CHUNK_COUNT];
+	int iRequested;
+	int iChunk;
+	int iRead = 0;
+	int i;
+	jclass exc;
+
+	pcBuffer = (*env)->GetDirectBufferAddress(env, buffer);
+	if(!pcBuffer){
+		exc = (*env)->FindClass(env, "java/lang/IllegalArgumentException");
+		if(!exc) return 0;
+		(*env)->ThrowNew(env, exc, "Direct buffer expected");
+		return 0;
+	}
+	pcBuffer += iByteOffset;
+
+	if(iElementSize == sizeof(int)){
+		iRead = iCount;
+		err = meIOStreamRead(iDevice, iSubdevice, iReadMode, (int *) pcBuffer, &iRead, iFlags);
+	}
+	else{
+		psValues = (unsigned short *) pcBuffer;
+		while(iRead < iCount){
+			iRequested = (iCount - iRead < ME_JAVA_CHUNK_COUNT) ? (iCount - iRead) : ME_JAVA_CHUNK_COUNT;
+			iChunk = iRequested;
+			err = meIOStreamRead(iDevice, iSubdevice, iReadMode, piChunk, &iChunk, iFlags);
+			if(err)
+				break;
+
+			for(i = 0; i < iChunk; i++)
+				psValues[iRead + i] = (unsigned short) piChunk[i];
+			iRead += iChunk;
+
+			if(iChunk < iRequested)
+				break;
+		}
+	}
+
+	if(err){
+		me_java_ThrowError(env, err);
+		return 0;
+	}
+
+	return iRead;
+}
+
+
+JNIEXPORT jint JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamWriteDirect(
+		JNIEnv *env,
+	   	jobject obj,
+	   	jint iDevice,
+	   	jint iSubdevice,
+	   	jint iWriteMode,
+	   	jobject buffer,
+	   	jint iByteOffset,
+	   	jint iCount,
+	   	jint iElementSize,
+	   	jint iFlags){
+	int err = ME_ERRNO_SUCCESS;
+	char *pcBuffer;
+	unsigned short *psValues;
+	int piChunk[ME_JAVA_CHUNK_COUNT];
+	int iRequested;
+	int iChunk;
+	int iWritten = 0;
+	int i;
+	jclass exc;
+
+	pcBuffer = (*env)->GetDirectBufferAddress(env, buffer);
+	if(!pcBuffer){
+		exc = (*env)->FindClass(env, "java/lang/IllegalArgumentException");
+		if(!exc) return 0;
+		(*env)->ThrowNew(env, exc, "Direct buffer expected");
+		return 0;
+	}
+	pcBuffer += iByteOffset;
+
+	if(iElementSize == sizeof(int)){
+		iWritten = iCount;
+		err = meIOStreamWrite(iDevice, iSubdevice, iWriteMode, (int *) pcBuffer, &iWritten, iFlags);
+	}
+	else{
+		psValues = (unsigned short *) pcBuffer;
+		while(iWritten < iCount){
+			iRequested = (iCount - iWritten < ME_JAVA_CHUNK_COUNT) ? (iCount - iWritten) : ME_JAVA_CHUNK_COUNT;
+			for(i = 0; i < iRequested; i++)
+				piChunk[i] = psValues[iWritten + i];
+
+			iChunk = iRequested;
+			err = meIOStreamWrite(iDevice, iSubdevice, iWriteMode, piChunk, &iChunk, iFlags);
+			if(err)
+				break;
+
+			iWritten += iChunk;
+
+			if(iChunk < iRequested)
+				break;
+		}
+	}
+
+	if(err){
+		me_java_ThrowError(env, err);
+		return 0;
+	}
+
+	return iWritten;
+}
+
+
 JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamStart(
 		JNIEnv *env,
 	   	jobject obj,
@@ -882,6 +1391,96 @@ JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamStatus(
 }
 
 
+JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamSetCallbacks(
+		JNIEnv *env,
+	   	jobject obj,
+	   	jint iDevice,
+	   	jint iSubdevice,
+	   	jobject startCallback,
+	   	jobject newValuesCallback,
+	   	jobject endCallback,
+	   	jint iFlags){
+	int err;
+	me_java_callbacks_t *callbacks;
+	jobject oldStart = NULL;
+	jobject oldNewValues = NULL;
+	jobject oldEnd = NULL;
+	jclass exc;
+
+	if(me_java_InitCallbacks(env))
+		return;
+
+	if(!(callbacks = me_java_GetCallbacks(iDevice, iSubdevice))){
+		exc = (*env)->FindClass(env, "java/lang/OutOfMemoryError");
+		if(!exc) return;
+		(*env)->ThrowNew(env, exc, "Cannot get memory for callbacks");
+		return;
+	}
+
+	if(!startCallback && !newValuesCallback && !endCallback){
+		/* Cancels all callbacks of subdevice. */
+		err = meIOStreamSetCallbacks(iDevice, iSubdevice, NULL, NULL, NULL, NULL, NULL, NULL, iFlags);
+		if(!err)
+			me_java_ClearCallbacks(env, callbacks);
+	}
+	else{
+		/* Set before the threads are created. Restored on error. */
+		if(startCallback){
+			if(!(startCallback = (*env)->NewGlobalRef(env, startCallback)))
+				return;
+			oldStart = me_java_SwapCallback(&callbacks->startCB, startCallback);
+		}
+		if(newValuesCallback){
+			if(!(newValuesCallback = (*env)->NewGlobalRef(env, newValuesCallback))){
+				if(startCallback)
+					(*env)->DeleteGlobalRef(env, me_java_SwapCallback(&callbacks->startCB, oldStart));
+				return;
+			}
+			oldNewValues = me_java_SwapCallback(&callbacks->newValuesCB, newValuesCallback);
+		}
+		if(endCallback){
+			if(!(endCallback = (*env)->NewGlobalRef(env, endCallback))){
+				if(startCallback)
+					(*env)->DeleteGlobalRef(env, me_java_SwapCallback(&callbacks->startCB, oldStart));
+				if(newValuesCallback)
+					(*env)->DeleteGlobalRef(env, me_java_SwapCallback(&callbacks->newValuesCB, oldNewValues));
+				return;
+			}
+			oldEnd = me_java_SwapCallback(&callbacks->endCB, endCallback);
+		}
+
+		err = meIOStreamSetCallbacks(iDevice, iSubdevice,
+				(startCallback) ? me_java_StreamStartCB : NULL, callbacks,
+				(newValuesCallback) ? me_java_StreamNewValuesCB : NULL, callbacks,
+				(endCallback) ? me_java_StreamEndCB : NULL, callbacks,
+				iFlags);
+		if(err){
+			if(startCallback)
+				oldStart = me_java_SwapCallback(&callbacks->startCB, oldStart);
+			if(newValuesCallback)
+				oldNewValues = me_java_SwapCallback(&callbacks->newValuesCB, oldNewValues);
+			if(endCallback)
+				oldEnd = me_java_SwapCallback(&callbacks->endCB, oldEnd);
+		}
+
+		/* Replaced (or not accepted) callbacks. */
+		if(oldStart)
+			(*env)->DeleteGlobalRef(env, oldStart);
+		if(oldNewValues)
+			(*env)->DeleteGlobalRef(env, oldNewValues);
+		if(oldEnd)
+			(*env)->DeleteGlobalRef(env, oldEnd);
+	}
+
+	if(err){
+		me_java_ThrowError(env, err);
+		return;
+	}
+
+	return;
+}
+
+
 JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamFrequencyToTicks(
 		JNIEnv *env,
 	   	jobject obj,
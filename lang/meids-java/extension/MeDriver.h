@@ -71,6 +71,14 @@ JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOIrqStop
 JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOIrqWait
   (JNIEnv *, jobject, jint, jint, jint, jobject, jint, jint);
 
+/*
+ * Class:     de_meilhaus_medriver_MeDriver
+ * Method:    meIOIrqSetCallback
+ * Signature: (IILde/meilhaus/medriver/MeIrqCallback;I)V
+ */
+JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOIrqSetCallback
+  (JNIEnv *, jobject, jint, jint, jobject, jint);
+
 /*
  * Class:     de_meilhaus_medriver_MeDriver
  * Method:    meIOResetDevice
@@ -127,6 +135,38 @@ JNIEXPORT jintArray JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamRead
 JNIEXPORT jintArray JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamWrite
   (JNIEnv *, jobject, jint, jint, jint, jintArray, jint);
 
+/*
+ * Class:     de_meilhaus_medriver_MeDriver
+ * Method:    meIOStreamReadArray
+ * Signature: (III[IIII)I
+ */
+JNIEXPORT jint JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamReadArray
+  (JNIEnv *, jobject, jint, jint, jint, jintArray, jint, jint, jint);
+
+/*
+ * Class:     de_meilhaus_medriver_MeDriver
+ * Method:    meIOStreamWriteArray
+ * Signature: (III[IIII)I
+ */
+JNIEXPORT jint JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamWriteArray
+  (JNIEnv *, jobject, jint, jint, jint, jintArray, jint, jint, jint);
+
+/*
+ * Class:     de_meilhaus_medriver_MeDriver
+ * Method:    meIOStreamReadDirect
+ * Signature: (IIILjava/nio/Buffer;IIII)I
+ */
+JNIEXPORT jint JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamReadDirect
+  (JNIEnv *, jobject, jint, jint, jint, jobject, jint, jint, jint, jint);
+
+/*
+ * Class:     de_meilhaus_medriver_MeDriver
+ * Method:    meIOStreamWriteDirect
+ * Signature: (IIILjava/nio/Buffer;IIII)I
+ */
+JNIEXPORT jint JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamWriteDirect
+  (JNIEnv *, jobject, jint, jint, jint, jobject, jint, jint, jint, jint);
+
 /*
  * Class:     de_meilhaus_medriver_MeDriver
  * Method:    meIOStreamStart
@@ -151,6 +191,14 @@ JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamStop
 JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamStatus
   (JNIEnv *, jobject, jint, jint, jint, jobject, jint);
 
+/*
+ * Class:     de_meilhaus_medriver_MeDriver
+ * Method:    meIOStreamSetCallbacks
+ * Signature: (IILde/meilhaus/medriver/MeIOStreamCallback;Lde/meilhaus/medriver/MeIOStreamNewValuesCallback;Lde/meilhaus/medriver/MeIOStreamCallback;I)V
+ */
+JNIEXPORT void JNICALL Java_de_meilhaus_medriver_MeDriver_meIOStreamSetCallbacks
+  (JNIEnv *, jobject, jint, jint, jobject, jobject, jobject, jint);
+
 /*
  * Class:     de_meilhaus_medriver_MeDriver
  * Method:    meIOStreamFrequencyToTicks
@@ -364,6 +364,11 @@ public class MeDriver {
 			MeIrq irq,
 			int iTimeOut,
 			int iFlags) throws java.io.IOException;
+	public native void meIOIrqSetCallback(
+			int iDevice,
+			int iSubdevice,
+			MeIrqCallback callback,
+			int iFlags) throws java.io.IOException;
 
 	public native void meIOResetDevice(int iDevice, int iFlags) throws java.io.IOException;
 	public native void meIOResetSubdevice(int iDevice, int iSubdevice, int iFlags) throws java.io.IOException;
@@ -399,6 +404,141 @@ public class MeDriver {
 			int iWriteMode,
 			int[] values,
 			int iFlags) throws java.io.IOException;
+
+	/* Reads into values[iOffset] .. values[iOffset + iCount - 1]. Returns number of values read. */
+	public int meIOStreamRead(
+			int iDevice,
+			int iSubdevice,
+			int iReadMode,
+			int[] values,
+			int iOffset,
+			int iCount,
+			int iFlags) throws java.io.IOException{
+		if((iOffset < 0) || (iCount < 0) || (iOffset > values.length - iCount))
+			throw new IndexOutOfBoundsException();
+		return meIOStreamReadArray(iDevice, iSubdevice, iReadMode, values, iOffset, iCount, iFlags);
+	}
+	/* Writes values[iOffset] .. values[iOffset + iCount - 1]. Returns number of values written. */
+	public int meIOStreamWrite(
+			int iDevice,
+			int iSubdevice,
+			int iWriteMode,
+			int[] values,
+			int iOffset,
+			int iCount,
+			int iFlags) throws java.io.IOException{
+		if((iOffset < 0) || (iCount < 0) || (iOffset > values.length - iCount))
+			throw new IndexOutOfBoundsException();
+		return meIOStreamWriteArray(iDevice, iSubdevice, iWriteMode, values, iOffset, iCount, iFlags);
+	}
+
+	/* Direct ByteBuffer (int values), IntBuffer or ShortBuffer in native byte order.
+	 * Reads from position up to limit. Position is moved behind the values read. Returns number of values read. */
+	public int meIOStreamRead(
+			int iDevice,
+			int iSubdevice,
+			int iReadMode,
+			java.nio.Buffer buffer,
+			int iFlags) throws java.io.IOException{
+		int iSize = directBufferElementSize(buffer);
+		int iUnit = (buffer instanceof java.nio.ByteBuffer) ? 1 : iSize;
+		int n = meIOStreamReadDirect(
+				iDevice,
+				iSubdevice,
+				iReadMode,
+				buffer,
+				buffer.position() * iUnit,
+				buffer.remaining() * iUnit / iSize,
+				iSize,
+				iFlags);
+		buffer.position(buffer.position() + n * iSize / iUnit);
+		return n;
+	}
+	/* Writes from position up to limit. Position is moved behind the values written. Returns number of values written. */
+	public int meIOStreamWrite(
+			int iDevice,
+			int iSubdevice,
+			int iWriteMode,
+			java.nio.Buffer buffer,
+			int iFlags) throws java.io.IOException{
+		int iSize = directBufferElementSize(buffer);
+		int iUnit = (buffer instanceof java.nio.ByteBuffer) ? 1 : iSize;
+		int n = meIOStreamWriteDirect(
+				iDevice,
+				iSubdevice,
+				iWriteMode,
+				buffer,
+				buffer.position() * iUnit,
+				buffer.remaining() * iUnit / iSize,
+				iSize,
+				iFlags);
+		buffer.position(buffer.position() + n * iSize / iUnit);
+		return n;
+	}
+
+	private static int directBufferElementSize(java.nio.Buffer buffer){
+		java.nio.ByteOrder order;
+		int iSize;
+
+		if(buffer instanceof java.nio.ByteBuffer){
+			order = ((java.nio.ByteBuffer) buffer).order();
+			iSize = 4;
+		}
+		else if(buffer instanceof java.nio.IntBuffer){
+			order = ((java.nio.IntBuffer) buffer).order();
+			iSize = 4;
+		}
+		else if(buffer instanceof java.nio.ShortBuffer){
+			order = ((java.nio.ShortBuffer) buffer).order();
+			iSize = 2;
+		}
+		else{
+			throw new IllegalArgumentException("ByteBuffer, IntBuffer or ShortBuffer expected");
+		}
+
+		if(!buffer.isDirect())
+			throw new IllegalArgumentException("Direct buffer expected");
+		if(order != java.nio.ByteOrder.nativeOrder())
+			throw new IllegalArgumentException("Buffer in native byte order expected");
+
+		return iSize;
+	}
+
+	private native int meIOStreamReadArray(
+			int iDevice,
+			int iSubdevice,
+			int iReadMode,
+			int[] values,
+			int iOffset,
+			int iCount,
+			int iFlags) throws java.io.IOException;
+	private native int meIOStreamWriteArray(
+			int iDevice,
+			int iSubdevice,
+			int iWriteMode,
+			int[] values,
+			int iOffset,
+			int iCount,
+			int iFlags) throws java.io.IOException;
+	private native int meIOStreamReadDirect(
+			int iDevice,
+			int iSubdevice,
+			int iReadMode,
+			java.nio.Buffer buffer,
+			int iByteOffset,
+			int iCount,
+			int iElementSize,
+			int iFlags) throws java.io.IOException;
+	private native int meIOStreamWriteDirect(
+			int iDevice,
+			int iSubdevice,
+			int iWriteMode,
+			java.nio.Buffer buffer,
+			int iByteOffset,
+			int iCount,
+			int iElementSize,
+			int iFlags) throws java.io.IOException;
+
 	public native void meIOStreamStart(MeIOStreamStart[] startList, int iFlags) throws java.io.IOException;
 	public native void meIOStreamStop(MeIOStreamStop[] stopList, int iFlags) throws java.io.IOException;
 	public native void meIOStreamStatus(
@@ -407,6 +547,13 @@ public class MeDriver {
 			int iWait,
 			MeStatus status,
 			int iFlags) throws java.io.IOException;
+	public native void meIOStreamSetCallbacks(
+			int iDevice,
+			int iSubdevice,
+			MeIOStreamCallback startCallback,
+			MeIOStreamNewValuesCallback newValuesCallback,
+			MeIOStreamCallback endCallback,
+			int iFlags) throws java.io.IOException;
 	public native void meIOStreamFrequencyToTicks(
 			int iDevice,
 			int iSubdevice,
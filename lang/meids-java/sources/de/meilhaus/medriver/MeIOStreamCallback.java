@@ -0,0 +1,7 @@
+package de.meilhaus.medriver;
+
+/* Called from the driver system's thread on stream start and end.
+ * Return non zero from start callback to stop the stream. */
+public interface MeIOStreamCallback{
+	public int stream(int iDevice, int iSubdevice, int iCount, int iErrorCode);
+}
@@ -0,0 +1,7 @@
+package de.meilhaus.medriver;
+
+/* Called from the driver system's thread with the new values already read from the stream.
+ * Return zero to stop the stream. */
+public interface MeIOStreamNewValuesCallback{
+	public int newValues(int iDevice, int iSubdevice, int[] values, int iErrorCode);
+}
@@ -0,0 +1,6 @@
+package de.meilhaus.medriver;
+
+/* Called from the driver system's thread. Return non zero to stop the interrupts. */
+public interface MeIrqCallback{
+	public int irq(int iDevice, int iSubdevice, int iChannel, int iIrqCount, int iValue, int iErrorCode);
+}
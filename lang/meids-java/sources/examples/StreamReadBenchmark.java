@@ -0,0 +1,152 @@
+package examples;
+
+import java.lang.management.ManagementFactory;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.ShortBuffer;
+
+import de.meilhaus.medriver.*;
+
+/* Compares time and Java heap allocated per meIOStreamRead() call for
+ * fresh int[] (old API), reused int[], direct ByteBuffer and direct ShortBuffer.
+ * Runs on first streaming analog input subdevice. Warm-up and measurement
+ * iterations are done like in JMH. */
+public class StreamReadBenchmark {
+	static final int BLOCK = 1000;
+	static final int WARMUP_ITERATIONS = 3;
+	static final int MEASUREMENT_ITERATIONS = 5;
+	static final int OPERATIONS = 200;
+
+	interface Operation {
+		void run() throws java.io.IOException;
+	}
+
+	static MeDriver drv;
+	static int ns;
+
+	public static void main(String[] args){
+		drv = new MeDriver();
+		int[] acqArgs = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		int[] scanArgs = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+		int[] convArgs = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+		try{
+			drv.meOpen(0);
+
+			if(drv.meQueryNumberDevices() <= 0){
+				System.out.println("No devices detected by driver system.");
+				return;
+			}
+
+			ns = drv.meQuerySubdeviceByType(0, 0, MeDriver.ME_TYPE_AI, MeDriver.ME_SUBTYPE_STREAMING);
+			MeRange range = new MeRange(MeDriver.ME_UNIT_VOLT, -10.0, 10.0);
+			drv.meQueryRangeByMinMax(0, ns, 0, range);
+
+			MeIOStreamConfig[] configList = { new MeIOStreamConfig(0, range.getRange(), MeDriver.ME_REF_AI_GROUND, MeDriver.ME_IO_STREAM_CONFIG_TYPE_NO_FLAGS) };
+
+			MeTicks acqStartTicks = new MeTicks();
+			acqStartTicks.setTime(0.0);
+			drv.meIOStreamTimeToTicks(0, ns, MeDriver.ME_TIMER_ACQ_START, acqStartTicks, MeDriver.ME_IO_STREAM_TIME_TO_TICKS_NO_FLAGS);
+
+			MeTicks convStartTicks = new MeTicks();
+			convStartTicks.setTime(0.00001);
+			drv.meIOStreamTimeToTicks(0, ns, MeDriver.ME_TIMER_CONV_START, convStartTicks, MeDriver.ME_IO_STREAM_TIME_TO_TICKS_NO_FLAGS);
+
+			/* Runs until stopped. */
+			MeIOStreamTrigger trigger = new MeIOStreamTrigger(
+					MeDriver.ME_TRIG_TYPE_SW,
+					0,
+					MeDriver.ME_TRIG_CHAN_DEFAULT,
+					acqStartTicks.getTicks(),
+					acqArgs,
+					MeDriver.ME_TRIG_TYPE_FOLLOW,
+					0,
+					scanArgs,
+					MeDriver.ME_TRIG_TYPE_TIMER,
+					convStartTicks.getTicks(),
+					convArgs,
+					MeDriver.ME_TRIG_TYPE_NONE,
+					0,
+					MeDriver.ME_TRIG_TYPE_NONE,
+					0,
+					MeDriver.ME_IO_STREAM_TRIGGER_TYPE_NO_FLAGS);
+
+			drv.meIOStreamConfig(0, ns, configList, trigger, 0, MeDriver.ME_IO_STREAM_CONFIG_NO_FLAGS);
+
+			MeIOStreamStart[] startList = { new MeIOStreamStart(0, ns, MeDriver.ME_START_MODE_BLOCKING, 0, MeDriver.ME_IO_STREAM_START_TYPE_NO_FLAGS) };
+			drv.meIOStreamStart(startList, MeDriver.ME_IO_STREAM_START_NO_FLAGS);
+
+			final int[] values = new int[BLOCK];
+			final ByteBuffer bytes = ByteBuffer.allocateDirect(BLOCK * 4).order(ByteOrder.nativeOrder());
+			final ShortBuffer shorts = ByteBuffer.allocateDirect(BLOCK * 2).order(ByteOrder.nativeOrder()).asShortBuffer();
+
+			System.out.println("Benchmark                 ns/op        B/op");
+
+			run("int[] per call", new Operation(){
+				public void run() throws java.io.IOException{
+					drv.meIOStreamRead(0, ns, MeDriver.ME_READ_MODE_BLOCKING, BLOCK, MeDriver.ME_IO_STREAM_READ_NO_FLAGS);
+				}
+			});
+
+			run("reused int[]", new Operation(){
+				public void run() throws java.io.IOException{
+					drv.meIOStreamRead(0, ns, MeDriver.ME_READ_MODE_BLOCKING, values, 0, BLOCK, MeDriver.ME_IO_STREAM_READ_NO_FLAGS);
+				}
+			});
+
+			run("direct ByteBuffer", new Operation(){
+				public void run() throws java.io.IOException{
+					bytes.clear();
+					drv.meIOStreamRead(0, ns, MeDriver.ME_READ_MODE_BLOCKING, bytes, MeDriver.ME_IO_STREAM_READ_NO_FLAGS);
+				}
+			});
+
+			run("direct ShortBuffer", new Operation(){
+				public void run() throws java.io.IOException{
+					shorts.clear();
+					drv.meIOStreamRead(0, ns, MeDriver.ME_READ_MODE_BLOCKING, shorts, MeDriver.ME_IO_STREAM_READ_NO_FLAGS);
+				}
+			});
+
+			MeIOStreamStop[] stopList = { new MeIOStreamStop(0, ns, MeDriver.ME_STOP_MODE_IMMEDIATE, MeDriver.ME_IO_STREAM_STOP_TYPE_NO_FLAGS) };
+			drv.meIOStreamStop(stopList, MeDriver.ME_IO_STREAM_STOP_NO_FLAGS);
+
+			drv.meClose(0);
+		}
+		catch(java.io.IOException e){
+			e.printStackTrace(System.err);
+		}
+	}
+
+	/* Heap allocated by this thread. -1 when JVM can not tell. */
+	static long allocatedBytes(){
+		java.lang.management.ThreadMXBean bean = ManagementFactory.getThreadMXBean();
+
+		if(bean instanceof com.sun.management.ThreadMXBean)
+			return ((com.sun.management.ThreadMXBean) bean).getThreadAllocatedBytes(Thread.currentThread().getId());
+
+		return -1;
+	}
+
+	static void run(String name, Operation operation) throws java.io.IOException{
+		long time = 0;
+		long bytes = 0;
+
+		for(int i = 0; i < WARMUP_ITERATIONS; i++){
+			for(int n = 0; n < OPERATIONS; n++)
+				operation.run();
+		}
+
+		for(int i = 0; i < MEASUREMENT_ITERATIONS; i++){
+			long startBytes = allocatedBytes();
+			long startTime = System.nanoTime();
+			for(int n = 0; n < OPERATIONS; n++)
+				operation.run();
+			time += System.nanoTime() - startTime;
+			bytes += allocatedBytes() - startBytes;
+		}
+
+		long ops = (long) MEASUREMENT_ITERATIONS * OPERATIONS;
+		System.out.println(String.format("%-20s %10d %11s", name, time / ops, (allocatedBytes() < 0) ? "n/a" : Long.toString(bytes / ops)));
+	}
+}
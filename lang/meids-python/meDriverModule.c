@@ -25,6 +25,19 @@
 #include <numpy/arrayobject.h>
 #include <medriver.h>
 
+#ifdef ME_POSIX
+# include <unistd.h>
+# include <errno.h>
+# include <sys/eventfd.h>
+#endif
+
+#if PY_MAJOR_VERSION >= 3
+# define PyInt_Check PyLong_Check
+# define PyInt_AsLong PyLong_AsLong
+# define PyInt_FromLong PyLong_FromLong
+# define PyString_FromString PyUnicode_FromString
+#endif
+
 #ifdef ME_WINDOWS
 	typedef __int64 int64_t;
 #else
@@ -34,7 +47,11 @@
 #endif
 
 
+#if PY_MAJOR_VERSION >= 3
+PyMODINIT_FUNC PyInit_meDriver(void);
+#else
 void initmeDriver(void);
+#endif
 
 /* Module specific error exception */
 static PyObject *meError;
@@ -214,6 +231,9 @@ static me_const_info_t me_const_table[] = {
 	{ ME_PY_INT, "ME_IO_STREAM_CONFIG_SAMPLE_AND_HOLD", (long) ME_IO_STREAM_CONFIG_SAMPLE_AND_HOLD, 0 },
 #ifdef ME_IO_STREAM_CONFIG_HARDWARE_ONLY
 	{ ME_PY_INT, "ME_IO_STREAM_CONFIG_HARDWARE_ONLY", (long) ME_IO_STREAM_CONFIG_HARDWARE_ONLY, 0 },
+#endif
+#ifdef ME_IO_STREAM_CONFIG_FLIGHT_RECORDER
+	{ ME_PY_INT, "ME_IO_STREAM_CONFIG_FLIGHT_RECORDER", (long) ME_IO_STREAM_CONFIG_FLIGHT_RECORDER, 0 },
 #endif
 	{ ME_PY_INT, "ME_IO_STREAM_CONFIG_TYPE_NO_FLAGS", (long) ME_IO_STREAM_CONFIG_TYPE_NO_FLAGS, 0 },
 	{ ME_PY_INT, "ME_IO_STREAM_TRIGGER_TYPE_NO_FLAGS", (long) ME_IO_STREAM_TRIGGER_TYPE_NO_FLAGS, 0 },
@@ -221,6 +241,10 @@ static me_const_info_t me_const_table[] = {
 	{ ME_PY_INT, "ME_READ_MODE_NONBLOCKING", (long) ME_READ_MODE_NONBLOCKING, 0 },
 	{ ME_PY_INT, "ME_IO_STREAM_READ_FRAMES", (long) ME_IO_STREAM_READ_FRAMES, 0 },
 	{ ME_PY_INT, "ME_IO_STREAM_READ_NO_FLAGS", (long) ME_IO_STREAM_READ_NO_FLAGS, 0 },
+#ifdef ME_IO_STREAM_READ_GAP_MARKER
+	{ ME_PY_INT, "ME_IO_STREAM_READ_GAP_MARKER", (long) ME_IO_STREAM_READ_GAP_MARKER, 0 },
+	{ ME_PY_INT, "ME_IO_STREAM_READ_GAP_RECORD_SIZE", (long) ME_IO_STREAM_READ_GAP_RECORD_SIZE, 0 },
+#endif
 	{ ME_PY_INT, "ME_WRITE_MODE_BLOCKING", (long) ME_WRITE_MODE_BLOCKING, 0 },
 	{ ME_PY_INT, "ME_WRITE_MODE_NONBLOCKING", (long) ME_WRITE_MODE_NONBLOCKING, 0 },
 	{ ME_PY_INT, "ME_WRITE_MODE_PRELOAD", (long) ME_WRITE_MODE_PRELOAD, 0 },
@@ -363,6 +387,9 @@ static me_const_info_t me_const_table[] = {
 #endif
 	{ ME_PY_INT, "ME_BUS_TYPE_PCI", (long) ME_BUS_TYPE_PCI, 0 },
 	{ ME_PY_INT, "ME_BUS_TYPE_USB", (long) ME_BUS_TYPE_USB, 0 },
+#ifdef ME_BUS_TYPE_SIMULATED
+	{ ME_PY_INT, "ME_BUS_TYPE_SIMULATED", (long) ME_BUS_TYPE_SIMULATED, 0 },
+#endif
 #ifdef ME_BUS_TYPE_LAN_PCI
 	{ ME_PY_INT, "ME_BUS_TYPE_LAN_PCI", (long) ME_BUS_TYPE_LAN_PCI, 0 },
 #endif
@@ -466,6 +493,289 @@ static void me_InstallConstants(PyObject *d, me_const_info_t *constants) {
 }
 
 
+/*===========================================================================
+  Callbacks called from the library's threads
+  =========================================================================*/
+
+/* Python objects registered for one subdevice.
+ * Entries are never freed. The library's threads keep a pointer to them.
+ * Slots are changed and read with the interpreter lock held only. */
+typedef struct me_py_callbacks {
+	struct me_py_callbacks *next;
+	int iDevice;
+	int iSubdevice;
+	PyObject *objIrqCB;
+	PyObject *objIrqContext;
+	PyObject *objStartCB;
+	PyObject *objStartContext;
+	PyObject *objNewValuesCB;
+	PyObject *objNewValuesContext;
+	PyObject *objEndCB;
+	PyObject *objEndContext;
+	/* Stream notifications (meIOStreamNotifyOpen). Written by the library's threads without the interpreter lock. */
+	int iNotifyFd;
+	volatile int iNotifyError;
+} me_py_callbacks_t;
+
+static me_py_callbacks_t *me_py_callbacks_list = NULL;
+
+static me_py_callbacks_t *me_py_GetCallbacks(int iDevice, int iSubdevice){
+	me_py_callbacks_t *callbacks;
+
+	for(callbacks = me_py_callbacks_list; callbacks; callbacks = callbacks->next){
+		if((callbacks->iDevice == iDevice) && (callbacks->iSubdevice == iSubdevice))
+			return callbacks;
+	}
+
+	callbacks = PyMem_Malloc(sizeof(me_py_callbacks_t));
+	if(!callbacks){
+		PyErr_NoMemory();
+		return NULL;
+	}
+
+	memset(callbacks, 0, sizeof(me_py_callbacks_t));
+	callbacks->iDevice = iDevice;
+	callbacks->iSubdevice = iSubdevice;
+	callbacks->iNotifyFd = -1;
+	callbacks->next = me_py_callbacks_list;
+	me_py_callbacks_list = callbacks;
+
+	return callbacks;
+}
+
+/* Stores new callable and context in slot. Old ones are returned in place of the new ones. */
+static void me_py_SwapCallback(PyObject **pobjSlotCB, PyObject **pobjSlotContext, PyObject **pobjCB, PyObject **pobjContext){
+	PyObject *objCB = *pobjSlotCB;
+	PyObject *objContext = *pobjSlotContext;
+
+	*pobjSlotCB = *pobjCB;
+	*pobjSlotContext = *pobjContext;
+	*pobjCB = objCB;
+	*pobjContext = objContext;
+}
+
+/* Calls Python callback. Exceptions can not be raised to anybody, they are reported and iDefault is returned. */
+static int me_py_CallCallback(PyObject *objCB, PyObject *objArgs, int iDefault){
+	PyObject *objResult;
+	int iResult = iDefault;
+
+	if(!objArgs){
+		PyErr_WriteUnraisable(objCB);
+		return iDefault;
+	}
+
+	objResult = PyObject_CallObject(objCB, objArgs);
+	Py_DECREF(objArgs);
+	if(!objResult){
+		PyErr_WriteUnraisable(objCB);
+		return iDefault;
+	}
+
+	if(objResult != Py_None){
+		iResult = PyInt_AsLong(objResult);
+		if((iResult == -1) && PyErr_Occurred()){
+			PyErr_WriteUnraisable(objCB);
+			iResult = iDefault;
+		}
+	}
+	Py_DECREF(objResult);
+
+	return iResult;
+}
+
+/* Callback returns non zero to stop interrupts. */
+static int me_py_IrqCB(int iDevice, int iSubdevice, int iChannel, int iIrqCount, int iValue, void *pvContext, int iErrorCode){
+	me_py_callbacks_t *callbacks = pvContext;
+	PyGILState_STATE state;
+	PyObject *objCB;
+	PyObject *objContext;
+	int iResult = 0;
+
+	if(!Py_IsInitialized())
+		return iResult;
+
+	state = PyGILState_Ensure();
+	objCB = callbacks->objIrqCB;
+	objContext = callbacks->objIrqContext;
+	if(objCB){
+		/* Callback can replace itself. */
+		Py_INCREF(objCB);
+		Py_INCREF(objContext);
+		iResult = me_py_CallCallback(objCB,
+				Py_BuildValue("(iiiiIOi)", iDevice, iSubdevice, iChannel, iIrqCount, (unsigned int) iValue, objContext, iErrorCode),
+				iResult);
+		Py_DECREF(objCB);
+		Py_DECREF(objContext);
+	}
+	PyGILState_Release(state);
+
+	return iResult;
+}
+
+/* Callback returns non zero to stop the stream. */
+static int me_py_StreamStartCB(int iDevice, int iSubdevice, int iCount, void *pvContext, int iErrorCode){
+	me_py_callbacks_t *callbacks = pvContext;
+	PyGILState_STATE state;
+	PyObject *objCB;
+	PyObject *objContext;
+	int iResult = 0;
+
+	if(!Py_IsInitialized())
+		return iResult;
+
+	state = PyGILState_Ensure();
+	objCB = callbacks->objStartCB;
+	objContext = callbacks->objStartContext;
+	if(objCB){
+		Py_INCREF(objCB);
+		Py_INCREF(objContext);
+		iResult = me_py_CallCallback(objCB, Py_BuildValue("(iiiOi)", iDevice, iSubdevice, iCount, objContext, iErrorCode), iResult);
+		Py_DECREF(objCB);
+		Py_DECREF(objContext);
+	}
+	PyGILState_Release(state);
+
+	return iResult;
+}
+
+/* Callback gets new values as an array. Slot is checked with the interpreter lock held,
+ * values are read with it released. Callback returns zero to stop the stream. */
+static int me_py_StreamNewValuesCB(int iDevice, int iSubdevice, int iCount, void *pvContext, int iErrorCode){
+	me_py_callbacks_t *callbacks = pvContext;
+	PyGILState_STATE state;
+	PyObject *objCB;
+	PyObject *objContext;
+	PyArrayObject *objArray;
+	int *piValues;
+	int n_dimensions = 1;
+	npy_intp dimensions[1];
+	int iResult = 1;
+
+	if(!Py_IsInitialized())
+		return iResult;
+
+	if(iErrorCode || (iCount < 0))
+		iCount = 0;
+
+	/* Owned by the array. Numpy frees its data with free(). */
+	piValues = malloc(sizeof(int) * (iCount + 1));
+	if(!piValues){
+		iErrorCode = ME_ERRNO_INTERNAL;
+		iCount = 0;
+	}
+
+	state = PyGILState_Ensure();
+	if(piValues && iCount && callbacks->objNewValuesCB){
+		/* Values are not taken away, when nobody wants them. */
+		Py_BEGIN_ALLOW_THREADS
+		iErrorCode = meIOStreamRead(iDevice, iSubdevice, ME_READ_MODE_NONBLOCKING, piValues, &iCount, ME_IO_STREAM_READ_NO_FLAGS);
+		Py_END_ALLOW_THREADS
+		if(iErrorCode)
+			iCount = 0;
+	}
+
+	objCB = callbacks->objNewValuesCB;
+	objContext = callbacks->objNewValuesContext;
+	if(objCB){
+		dimensions[0] = iCount;
+		objArray = NULL;
+		if(piValues){
+			objArray = (PyArrayObject *) PyArray_SimpleNewFromData(n_dimensions, dimensions, NPY_INT, (char *) piValues);
+		}
+		if(objArray){
+			PyArray_ENABLEFLAGS(objArray, NPY_ARRAY_OWNDATA);
+			piValues = NULL;
+
+			Py_INCREF(objCB);
+			Py_INCREF(objContext);
+			iResult = me_py_CallCallback(objCB, Py_BuildValue("(iiNOi)", iDevice, iSubdevice, objArray, objContext, iErrorCode), iResult);
+			Py_DECREF(objCB);
+			Py_DECREF(objContext);
+		}
+		else if(PyErr_Occurred()){
+			PyErr_WriteUnraisable(objCB);
+		}
+	}
+	PyGILState_Release(state);
+
+	free(piValues);
+
+	return iResult;
+}
+
+/* Return value is ignored by the library. */
+static int me_py_StreamEndCB(int iDevice, int iSubdevice, int iCount, void *pvContext, int iErrorCode){
+	me_py_callbacks_t *callbacks = pvContext;
+	PyGILState_STATE state;
+	PyObject *objCB;
+	PyObject *objContext;
+	int iResult = 0;
+
+	if(!Py_IsInitialized())
+		return iResult;
+
+	state = PyGILState_Ensure();
+	objCB = callbacks->objEndCB;
+	objContext = callbacks->objEndContext;
+	if(objCB){
+		Py_INCREF(objCB);
+		Py_INCREF(objContext);
+		iResult = me_py_CallCallback(objCB, Py_BuildValue("(iiiOi)", iDevice, iSubdevice, iCount, objContext, iErrorCode), iResult);
+		Py_DECREF(objCB);
+		Py_DECREF(objContext);
+	}
+	PyGILState_Release(state);
+
+	return iResult;
+}
+
+/* Library cancels all callbacks of subdevice at once. */
+static void me_py_ClearCallbacks(me_py_callbacks_t *callbacks){
+	Py_CLEAR(callbacks->objIrqCB);
+	Py_CLEAR(callbacks->objIrqContext);
+	Py_CLEAR(callbacks->objStartCB);
+	Py_CLEAR(callbacks->objStartContext);
+	Py_CLEAR(callbacks->objNewValuesCB);
+	Py_CLEAR(callbacks->objNewValuesContext);
+	Py_CLEAR(callbacks->objEndCB);
+	Py_CLEAR(callbacks->objEndContext);
+}
+
+#ifdef ME_POSIX
+/* Stream notifications only wake up the event loop. Values are not read and the interpreter lock is not taken,
+ * so nothing is taken away from the driver's buffer until the consumer asks for it. */
+static void me_py_Notify(me_py_callbacks_t *callbacks){
+	uint64_t ullOne = 1;
+	ssize_t iWritten;
+	int iFd = callbacks->iNotifyFd;
+
+	if(iFd >= 0){
+		/* Fails (EAGAIN) only when the counter is saturated. A wake up is pending then anyway. */
+		iWritten = write(iFd, &ullOne, sizeof(ullOne));
+		(void) iWritten;
+	}
+}
+
+/* Callback returns non zero to keep the stream running. First error is kept until it is acknowledged. */
+static int me_py_NotifyNewValuesCB(int iDevice, int iSubdevice, int iCount, void *pvContext, int iErrorCode){
+	me_py_callbacks_t *callbacks = pvContext;
+
+	if(iErrorCode && !callbacks->iNotifyError)
+		callbacks->iNotifyError = iErrorCode;
+
+	me_py_Notify(callbacks);
+
+	return 1;
+}
+
+static int me_py_NotifyEndCB(int iDevice, int iSubdevice, int iCount, void *pvContext, int iErrorCode){
+	me_py_Notify(pvContext);
+
+	return 0;
+}
+#endif
+
+
 /*===========================================================================
   Functions to access the driver system
   =========================================================================*/
@@ -476,7 +786,9 @@ static PyObject *_wrap_meOpen(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args,"i:meOpen", &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meOpen(iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -494,7 +806,9 @@ static PyObject *_wrap_meClose(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args,"i:meClose", &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meClose(iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -513,7 +827,9 @@ static PyObject *_wrap_meLockDriver(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args,"ii:meLockDriver", &iLock, &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meLockDriver(iLock, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -533,7 +849,9 @@ static PyObject *_wrap_meLockDevice(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args,"iii:meLockDevice", &iDevice, &iLock, &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meLockDevice(iDevice, iLock, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -554,7 +872,9 @@ static PyObject *_wrap_meLockSubdevice(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args,"iiii:meLockSubdevice", &iDevice, &iSubdevice, &iLock, &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meLockSubdevice(iDevice, iSubdevice, iLock, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -606,6 +926,7 @@ static PyObject *_wrap_meIOIrqStart(PyObject *self, PyObject *args) {
 		return NULL;
 	}
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOIrqStart(
 			iDevice,
 			iSubdevice,
@@ -614,6 +935,7 @@ static PyObject *_wrap_meIOIrqStart(PyObject *self, PyObject *args) {
 			iIrqEdge,
 			iIrqArg,
 		   	iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -640,11 +962,13 @@ static PyObject *_wrap_meIOIrqStop(PyObject *self, PyObject *args) {
 			   	&iChannel,
 			   	&iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOIrqStop(
 			iDevice,
 			iSubdevice,
 			iChannel,
 		   	iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -679,6 +1003,7 @@ static PyObject *_wrap_meIOIrqWait(PyObject *self, PyObject *args) {
 				&iTimeOut,
 			   	&iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOIrqWait(
 			iDevice,
 			iSubdevice,
@@ -687,6 +1012,7 @@ static PyObject *_wrap_meIOIrqWait(PyObject *self, PyObject *args) {
 			&iValue,
 			iTimeOut,
 		   	iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -733,6 +1059,61 @@ static PyObject *_wrap_meIOIrqWait(PyObject *self, PyObject *args) {
 }
 
 
+static PyObject *_wrap_meIOIrqSetCallback(PyObject *self, PyObject *args) {
+	int iDevice;
+	int iSubdevice;
+	int iFlags;
+	int iResult;
+	me_py_callbacks_t *callbacks;
+	PyObject *objCB;
+	PyObject *objContext;
+
+	if(!PyArg_ParseTuple(args, "iiOOi:meIOIrqSetCallback", &iDevice, &iSubdevice, &objCB, &objContext, &iFlags)) return NULL;
+
+	if((objCB != Py_None) && !PyCallable_Check(objCB)){
+		PyErr_SetString(PyExc_TypeError, "'callable' or 'None' type expected as argument 3");
+		return NULL;
+	}
+
+	if(!(callbacks = me_py_GetCallbacks(iDevice, iSubdevice)))
+		return NULL;
+
+	if(objCB == Py_None){
+		/* Cancels all callbacks of subdevice. */
+		Py_BEGIN_ALLOW_THREADS
+		iResult = meIOIrqSetCallback(iDevice, iSubdevice, NULL, NULL, iFlags);
+		Py_END_ALLOW_THREADS
+		if(!iResult)
+			me_py_ClearCallbacks(callbacks);
+	}
+	else{
+		/* Set before the thread is created. Restored on error. */
+		Py_INCREF(objCB);
+		Py_INCREF(objContext);
+		me_py_SwapCallback(&callbacks->objIrqCB, &callbacks->objIrqContext, &objCB, &objContext);
+
+		/* Interpreter lock must be released. Cancel waits for callback in progress. */
+		Py_BEGIN_ALLOW_THREADS
+		iResult = meIOIrqSetCallback(iDevice, iSubdevice, me_py_IrqCB, callbacks, iFlags);
+		Py_END_ALLOW_THREADS
+		if(iResult)
+			me_py_SwapCallback(&callbacks->objIrqCB, &callbacks->objIrqContext, &objCB, &objContext);
+
+		Py_XDECREF(objCB);
+		Py_XDECREF(objContext);
+	}
+
+	if(iResult){
+
+		PyErr_SetObject(meError, me_int_CreateError(iResult));
+		return NULL;
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+
 static PyObject *_wrap_meIOResetDevice(PyObject *self, PyObject *args) {
 	int iDevice;
 	int iFlags;
@@ -740,7 +1121,9 @@ static PyObject *_wrap_meIOResetDevice(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args,"ii:meIOResetDevice", &iDevice, &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOResetDevice(iDevice, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -760,7 +1143,9 @@ static PyObject *_wrap_meIOResetSubdevice(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args,"iii:meIOResetSubdevice", &iDevice, &iSubdevice, &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOResetSubdevice(iDevice, iSubdevice, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -796,6 +1181,7 @@ static PyObject *_wrap_meIOSingleConfig(PyObject *self, PyObject *args){
 			   	&iFlags))
 	   	return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOSingleConfig(
 			iDevice,
 		   	iSubdevice,
@@ -806,6 +1192,7 @@ static PyObject *_wrap_meIOSingleConfig(PyObject *self, PyObject *args){
 		   	iTrigType,
 		   	iTrigEdge,
 		   	iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -1003,7 +1390,9 @@ static PyObject *_wrap_meIOSingle(PyObject *self, PyObject *args) {
 		}
 	}
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOSingle(singleList, iCount, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 		PyMem_Free(singleList);
 
@@ -1408,7 +1797,9 @@ static PyObject *_wrap_meIOStreamConfig(PyObject *self, PyObject *args) {
 		return NULL;
 	}
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOStreamConfig(iDevice, iSubdevice, pConfigList, iCount, &trigger, iFifoIrqThreshold, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 		PyMem_Free(pConfigList);
 
@@ -1433,8 +1824,8 @@ static PyObject *_wrap_meIOStreamRead(PyObject *self, PyObject *args) {
 	int iResult;
 	PyArrayObject *objArray = NULL;
 	int n_dimensions = 1;
-	int dimensions[1];
-	int type_num = PyArray_INT;
+	npy_intp dimensions[1];
+	int type_num = NPY_INT;
 
 	if(!PyArg_ParseTuple(args, "iiiii:meIOStreamRead", &iDevice, &iSubdevice, &iReadMode, &iCount, &iFlags)) return NULL;
 
@@ -1442,7 +1833,9 @@ static PyObject *_wrap_meIOStreamRead(PyObject *self, PyObject *args) {
 	if(!piValues)
 		return PyErr_NoMemory();
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOStreamRead(iDevice, iSubdevice, iReadMode, piValues, &iCount, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 		PyMem_Free(piValues);
 
@@ -1453,7 +1846,7 @@ static PyObject *_wrap_meIOStreamRead(PyObject *self, PyObject *args) {
 	piValues = PyMem_Realloc(piValues, sizeof(int) * iCount);
 
 	dimensions[0] = iCount;
-	if(!(objArray = (PyArrayObject *) PyArray_FromDimsAndData(n_dimensions, dimensions, type_num, (char *) piValues))){
+	if(!(objArray = (PyArrayObject *) PyArray_SimpleNewFromData(n_dimensions, dimensions, type_num, (char *) piValues))){
 		PyMem_Free(piValues);
 		return NULL;
 	}
@@ -1462,6 +1855,132 @@ static PyObject *_wrap_meIOStreamRead(PyObject *self, PyObject *args) {
 }
 
 
+/* Kinds of buffers accepted by meIOStreamReadInto() */
+#define ME_PY_BUFFER_INVALID	0
+#define ME_PY_BUFFER_INT32		1
+#define ME_PY_BUFFER_INT16		2
+#define ME_PY_BUFFER_FLOAT32	3
+#define ME_PY_BUFFER_FLOAT64	4
+
+/* Raw values read at once, when they do not fit into caller's buffer (int16) */
+#define ME_PY_READ_CHUNK		1024
+
+static int me_py_BufferKind(Py_buffer *view){
+	const char *format = (view->format) ? view->format : "B";
+	const int one = 1;
+	const char native = (*(const char *) &one) ? '<' : '>';
+
+	/* Native byte order only */
+	if((format[0] == '@') || (format[0] == '=') || (format[0] == native))
+		format++;
+	if(!format[0] || format[1])
+		return ME_PY_BUFFER_INVALID;
+
+	switch(format[0]){
+		case 'i':
+		case 'I':
+		case 'l':
+		case 'L':
+			return (view->itemsize == sizeof(int)) ? ME_PY_BUFFER_INT32 : ME_PY_BUFFER_INVALID;
+		case 'h':
+		case 'H':
+			return (view->itemsize == sizeof(short)) ? ME_PY_BUFFER_INT16 : ME_PY_BUFFER_INVALID;
+		case 'f':
+			return (view->itemsize == sizeof(int)) ? ME_PY_BUFFER_FLOAT32 : ME_PY_BUFFER_INVALID;
+		case 'd':
+			return (view->itemsize == sizeof(double)) ? ME_PY_BUFFER_FLOAT64 : ME_PY_BUFFER_INVALID;
+	}
+
+	return ME_PY_BUFFER_INVALID;
+}
+
+
+static PyObject *_wrap_meIOStreamReadInto(PyObject *self, PyObject *args) {
+	int iDevice;
+	int iSubdevice;
+	int iReadMode;
+	int iCount;
+	int iFlags;
+	int iResult;
+	int iKind;
+	int iRead;
+	int iChunk;
+	int iRequested;
+	int piChunk[ME_PY_READ_CHUNK];
+	int *piValues;
+	PyObject *objBuffer;
+	Py_buffer view;
+	char pcError[ME_ERROR_MSG_MAX_COUNT];
+	int i;
+
+	if(!PyArg_ParseTuple(args, "iiiOi:meIOStreamReadInto", &iDevice, &iSubdevice, &iReadMode, &objBuffer, &iFlags)) return NULL;
+
+	if(PyObject_GetBuffer(objBuffer, &view, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS))
+		return NULL;
+
+	if(!(iKind = me_py_BufferKind(&view))){
+		snprintf(pcError, sizeof(pcError), "'%s' type expected (not '%s') as argument 4",
+				"writable int16, int32, float32 or float64 buffer",
+			   	(view.format) ? view.format : "B");
+		PyBuffer_Release(&view);
+		PyErr_SetString(PyExc_TypeError, pcError);
+		return NULL;
+	}
+
+	iCount = view.len / view.itemsize;
+	iRead = 0;
+	iResult = ME_ERRNO_SUCCESS;
+
+	/* The buffer stays exported (can not be resized or freed) until it is released. */
+	Py_BEGIN_ALLOW_THREADS
+	if(iKind == ME_PY_BUFFER_INT16){
+		/* Raw values do not fit into the buffer. Read them in chunks through the stack. */
+		while(iRead < iCount){
+			iRequested = (iCount - iRead < ME_PY_READ_CHUNK) ? (iCount - iRead) : ME_PY_READ_CHUNK;
+			iChunk = iRequested;
+			iResult = meIOStreamRead(iDevice, iSubdevice, iReadMode, piChunk, &iChunk, iFlags);
+			if(iResult)
+				break;
+
+			for(i = 0; i < iChunk; i++)
+				((unsigned short *) view.buf)[iRead + i] = (unsigned short) piChunk[i];
+			iRead += iChunk;
+
+			if(iChunk < iRequested)
+				break;
+		}
+	}
+	else{
+		/* Raw values are read straight into the buffer and converted in place. */
+		piValues = (int *) view.buf;
+		iRead = iCount;
+		iResult = meIOStreamRead(iDevice, iSubdevice, iReadMode, piValues, &iRead, iFlags);
+		if(!iResult){
+			if(iKind == ME_PY_BUFFER_FLOAT32){
+				for(i = 0; i < iRead; i++)
+					((float *) view.buf)[i] = (float) piValues[i];
+			}
+			else if(iKind == ME_PY_BUFFER_FLOAT64){
+				/* Going backwards never overwrites a value that is not converted yet. */
+				for(i = iRead - 1; i >= 0; i--)
+					((double *) view.buf)[i] = (double) piValues[i];
+			}
+		}
+	}
+	Py_END_ALLOW_THREADS
+
+	PyBuffer_Release(&view);
+
+	if(iResult){
+
+		PyErr_SetObject(meError, me_int_CreateError(iResult));
+		return NULL;
+	}
+
+	return PyInt_FromLong(iRead);
+}
+
+
 static PyObject *_wrap_meIOStreamWrite(PyObject *self, PyObject *args) {
 	int iDevice;
 	int iSubdevice;
@@ -1475,18 +1994,20 @@ static PyObject *_wrap_meIOStreamWrite(PyObject *self, PyObject *args) {
 	PyArrayObject *objArray = NULL;
 	PyArrayObject *objReturnArray = NULL;
 	int n_dimensions = 1;
-	int dimensions[1];
-	int type_num = PyArray_INT;
+	npy_intp dimensions[1];
+	int type_num = NPY_INT;
 
 	if(!PyArg_ParseTuple(args, "iiiOi:meIOStreamWrite", &iDevice, &iSubdevice, &iWriteMode, &objInputArray, &iFlags)) return NULL;
 
-	objArray = (PyArrayObject *) PyArray_ContiguousFromObject(objInputArray, PyArray_INT, 1, 1);
+	objArray = (PyArrayObject *) PyArray_ContiguousFromObject(objInputArray, NPY_INT, 1, 1);
 	if(objArray == NULL)
 		return NULL;
 
 	iCount = objArray->dimensions[0];
 	piValues = (int *) objArray->data;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOStreamWrite(iDevice, iSubdevice, iWriteMode, piValues, &iCount, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		Py_DECREF(objArray);
@@ -1503,7 +2024,7 @@ static PyObject *_wrap_meIOStreamWrite(PyObject *self, PyObject *args) {
 	memcpy(piReturnValues, &piValues[iCount], (sizeof(int) * objArray->dimensions[0]) - (sizeof(int) * iCount));
 
 	dimensions[0] = objArray->dimensions[0] - iCount;
-	if(!(objReturnArray = (PyArrayObject *) PyArray_FromDimsAndData(n_dimensions, dimensions, type_num, (char *) piReturnValues))){
+	if(!(objReturnArray = (PyArrayObject *) PyArray_SimpleNewFromData(n_dimensions, dimensions, type_num, (char *) piReturnValues))){
 		Py_DECREF(objArray);
 		PyMem_Free(piReturnValues);
 		return NULL;
@@ -1662,7 +2183,9 @@ static PyObject *_wrap_meIOStreamStart(PyObject *self, PyObject *args) {
 		}
 	}
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOStreamStart(startList, iCount, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 		PyMem_Free(startList);
 
@@ -1810,7 +2333,9 @@ static PyObject *_wrap_meIOStreamStop(PyObject *self, PyObject *args) {
 		}
 	}
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOStreamStop(stopList, iCount, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 		PyMem_Free(stopList);
 
@@ -1842,7 +2367,9 @@ static PyObject *_wrap_meIOStreamStatus(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args, "iiii:meIOStreamStatus", &iDevice, &iSubdevice, &iWait, &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOStreamStatus(iDevice, iSubdevice, iWait, &iStatus, &iCount, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -1882,6 +2409,236 @@ static PyObject *_wrap_meIOStreamStatus(PyObject *self, PyObject *args) {
 }
 
 
+static PyObject *_wrap_meIOStreamSetCallbacks(PyObject *self, PyObject *args) {
+	int iDevice;
+	int iSubdevice;
+	int iFlags;
+	int iResult;
+	me_py_callbacks_t *callbacks;
+	meIOStreamCB_t pStartCB = NULL;
+	meIOStreamCB_t pNewValuesCB = NULL;
+	meIOStreamCB_t pEndCB = NULL;
+	PyObject *objStartCB;
+	PyObject *objStartContext;
+	PyObject *objNewValuesCB;
+	PyObject *objNewValuesContext;
+	PyObject *objEndCB;
+	PyObject *objEndContext;
+
+	if(!PyArg_ParseTuple(args, "iiOOOOOOi:meIOStreamSetCallbacks",
+				&iDevice,
+				&iSubdevice,
+				&objStartCB,
+				&objStartContext,
+				&objNewValuesCB,
+				&objNewValuesContext,
+				&objEndCB,
+				&objEndContext,
+				&iFlags)) return NULL;
+
+	if(((objStartCB != Py_None) && !PyCallable_Check(objStartCB))
+			|| ((objNewValuesCB != Py_None) && !PyCallable_Check(objNewValuesCB))
+			|| ((objEndCB != Py_None) && !PyCallable_Check(objEndCB))){
+		PyErr_SetString(PyExc_TypeError, "'callable' or 'None' type expected as arguments 3, 5 and 7");
+		return NULL;
+	}
+
+	if(!(callbacks = me_py_GetCallbacks(iDevice, iSubdevice)))
+		return NULL;
+
+	/* Set before the threads are created. Restored on error. */
+	if(objStartCB != Py_None){
+		pStartCB = me_py_StreamStartCB;
+		Py_INCREF(objStartCB);
+		Py_INCREF(objStartContext);
+		me_py_SwapCallback(&callbacks->objStartCB, &callbacks->objStartContext, &objStartCB, &objStartContext);
+	}
+	if(objNewValuesCB != Py_None){
+		pNewValuesCB = me_py_StreamNewValuesCB;
+		Py_INCREF(objNewValuesCB);
+		Py_INCREF(objNewValuesContext);
+		me_py_SwapCallback(&callbacks->objNewValuesCB, &callbacks->objNewValuesContext, &objNewValuesCB, &objNewValuesContext);
+	}
+	if(objEndCB != Py_None){
+		pEndCB = me_py_StreamEndCB;
+		Py_INCREF(objEndCB);
+		Py_INCREF(objEndContext);
+		me_py_SwapCallback(&callbacks->objEndCB, &callbacks->objEndContext, &objEndCB, &objEndContext);
+	}
+
+	/* Interpreter lock must be released. Cancel waits for callback in progress. */
+	Py_BEGIN_ALLOW_THREADS
+	iResult = meIOStreamSetCallbacks(iDevice, iSubdevice,
+			pStartCB, callbacks,
+			pNewValuesCB, callbacks,
+			pEndCB, callbacks,
+			iFlags);
+	Py_END_ALLOW_THREADS
+
+	if(!pStartCB && !pNewValuesCB && !pEndCB){
+		/* Cancels all callbacks of subdevice. */
+		if(!iResult)
+			me_py_ClearCallbacks(callbacks);
+	}
+	else{
+		if(iResult){
+			if(pStartCB)
+				me_py_SwapCallback(&callbacks->objStartCB, &callbacks->objStartContext, &objStartCB, &objStartContext);
+			if(pNewValuesCB)
+				me_py_SwapCallback(&callbacks->objNewValuesCB, &callbacks->objNewValuesContext, &objNewValuesCB, &objNewValuesContext);
+			if(pEndCB)
+				me_py_SwapCallback(&callbacks->objEndCB, &callbacks->objEndContext, &objEndCB, &objEndContext);
+		}
+
+		/* Replaced (or not accepted) objects. */
+		if(pStartCB){
+			Py_XDECREF(objStartCB);
+			Py_XDECREF(objStartContext);
+		}
+		if(pNewValuesCB){
+			Py_XDECREF(objNewValuesCB);
+			Py_XDECREF(objNewValuesContext);
+		}
+		if(pEndCB){
+			Py_XDECREF(objEndCB);
+			Py_XDECREF(objEndContext);
+		}
+	}
+
+	if(iResult){
+
+		PyErr_SetObject(meError, me_int_CreateError(iResult));
+		return NULL;
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+
+#ifdef ME_POSIX
+static PyObject *_wrap_meIOStreamNotifyOpen(PyObject *self, PyObject *args) {
+	int iDevice;
+	int iSubdevice;
+	int iFlags;
+	int iResult;
+	int iFd;
+	me_py_callbacks_t *callbacks;
+
+	if(!PyArg_ParseTuple(args, "iii:meIOStreamNotifyOpen", &iDevice, &iSubdevice, &iFlags)) return NULL;
+
+	if(!(callbacks = me_py_GetCallbacks(iDevice, iSubdevice)))
+		return NULL;
+
+	if(callbacks->iNotifyFd >= 0){
+
+		PyErr_SetObject(meError, me_int_CreateError(ME_ERRNO_SUBDEVICE_BUSY));
+		return NULL;
+	}
+
+	iFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(iFd < 0)
+		return PyErr_SetFromErrno(PyExc_OSError);
+
+	/* Set before the threads are created. */
+	callbacks->iNotifyError = ME_ERRNO_SUCCESS;
+	callbacks->iNotifyFd = iFd;
+
+	Py_BEGIN_ALLOW_THREADS
+	iResult = meIOStreamSetCallbacks(iDevice, iSubdevice,
+			NULL, NULL,
+			me_py_NotifyNewValuesCB, callbacks,
+			me_py_NotifyEndCB, callbacks,
+			iFlags);
+	Py_END_ALLOW_THREADS
+
+	if(iResult){
+		callbacks->iNotifyFd = -1;
+		close(iFd);
+
+		PyErr_SetObject(meError, me_int_CreateError(iResult));
+		return NULL;
+	}
+
+	return PyInt_FromLong(iFd);
+}
+
+
+static PyObject *_wrap_meIOStreamNotifyAck(PyObject *self, PyObject *args) {
+	int iDevice;
+	int iSubdevice;
+	int iError;
+	uint64_t ullCount = 0;
+	me_py_callbacks_t *callbacks;
+
+	if(!PyArg_ParseTuple(args, "ii:meIOStreamNotifyAck", &iDevice, &iSubdevice)) return NULL;
+
+	if(!(callbacks = me_py_GetCallbacks(iDevice, iSubdevice)))
+		return NULL;
+
+	if(callbacks->iNotifyFd < 0){
+
+		PyErr_SetObject(meError, me_int_CreateError(ME_ERRNO_SUBDEVICE_NOT_RUNNING));
+		return NULL;
+	}
+
+	/* Nothing pending is not an error. */
+	if((read(callbacks->iNotifyFd, &ullCount, sizeof(ullCount)) < 0) && (errno != EAGAIN))
+		return PyErr_SetFromErrno(PyExc_OSError);
+
+	iError = callbacks->iNotifyError;
+	if(iError){
+		callbacks->iNotifyError = ME_ERRNO_SUCCESS;
+
+		PyErr_SetObject(meError, me_int_CreateError(iError));
+		return NULL;
+	}
+
+	return PyInt_FromLong((long) ullCount);
+}
+
+
+static PyObject *_wrap_meIOStreamNotifyClose(PyObject *self, PyObject *args) {
+	int iDevice;
+	int iSubdevice;
+	int iResult;
+	int iFd;
+	me_py_callbacks_t *callbacks;
+
+	if(!PyArg_ParseTuple(args, "ii:meIOStreamNotifyClose", &iDevice, &iSubdevice)) return NULL;
+
+	if(!(callbacks = me_py_GetCallbacks(iDevice, iSubdevice)))
+		return NULL;
+
+	if(callbacks->iNotifyFd < 0){
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	/* Cancels all callbacks of subdevice. Waits for callback in progress. */
+	Py_BEGIN_ALLOW_THREADS
+	iResult = meIOStreamSetCallbacks(iDevice, iSubdevice, NULL, NULL, NULL, NULL, NULL, NULL, ME_IO_STREAM_SET_CALLBACKS_NO_FLAGS);
+	Py_END_ALLOW_THREADS
+
+	if(iResult){
+		/* Threads may still write to the descriptor. Keep it open. */
+		PyErr_SetObject(meError, me_int_CreateError(iResult));
+		return NULL;
+	}
+
+	me_py_ClearCallbacks(callbacks);
+
+	iFd = callbacks->iNotifyFd;
+	callbacks->iNotifyFd = -1;
+	callbacks->iNotifyError = ME_ERRNO_SUCCESS;
+	close(iFd);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+#endif
+
+
 static PyObject *_wrap_meIOStreamFrequencyToTicks(PyObject *self, PyObject *args) {
 	int iDevice;
 	int iSubdevice;
@@ -1898,7 +2655,9 @@ static PyObject *_wrap_meIOStreamFrequencyToTicks(PyObject *self, PyObject *args
 
 	if(!PyArg_ParseTuple(args, "iiidi:meIOStreamFrequencyToTicks", &iDevice, &iSubdevice, &iTimer, &dFrequency, &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOStreamFrequencyToTicks(iDevice, iSubdevice, iTimer, &dFrequency, &iTicksLow, &iTicksHigh, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -1955,7 +2714,9 @@ static PyObject *_wrap_meIOStreamTimeToTicks(PyObject *self, PyObject *args) {
 
 	if(!PyArg_ParseTuple(args, "iiidi:meIOStreamTimeToTicks", &iDevice, &iSubdevice, &iTimer, &dTime, &iFlags)) return NULL;
 
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meIOStreamTimeToTicks(iDevice, iSubdevice, iTimer, &dTime, &iTicksLow, &iTicksHigh, iFlags);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -2768,14 +3529,14 @@ static PyObject *_wrap_meUtilityExtractValues(PyObject *self, PyObject *args) {
 	PyObject *objConfigArg;
 	PyArrayObject *objReturnArray = NULL;
 	int n_dimensions = 1;
-	int dimensions[1];
-	int type_num = PyArray_INT;
+	npy_intp dimensions[1];
+	int type_num = NPY_INT;
 	char pcError[ME_ERROR_MSG_MAX_COUNT];
 	int i;
 
 	if(!PyArg_ParseTuple(args, "iOO:meUtilityExtractValues", &iChannel, &objAIBuffer, &objConfigList)) return NULL;
 
-	objAIArray = (PyArrayObject *) PyArray_ContiguousFromObject(objAIBuffer, PyArray_INT, 1, 1);
+	objAIArray = (PyArrayObject *) PyArray_ContiguousFromObject(objAIBuffer, NPY_INT, 1, 1);
 	if(objAIArray == NULL)
 		return NULL;
 
@@ -2858,7 +3619,7 @@ static PyObject *_wrap_meUtilityExtractValues(PyObject *self, PyObject *args) {
 	}
 
 	dimensions[0] = iChanBufferCount;
-	if(!(objReturnArray = (PyArrayObject *) PyArray_FromDimsAndData(n_dimensions, dimensions, type_num, (char *) piChanBuffer))){
+	if(!(objReturnArray = (PyArrayObject *) PyArray_SimpleNewFromData(n_dimensions, dimensions, type_num, (char *) piChanBuffer))){
 		PyMem_Free(pConfigList);
 		PyMem_Free(piChanBuffer);
 		Py_DECREF(objAIArray);
@@ -2935,7 +3696,9 @@ static PyObject *_wrap_meUtilityPWMStart(PyObject *self, PyObject *args) {
 	int iResult;
 
 	if(!PyArg_ParseTuple(args, "iiiiiiii:meUtilityPWMStart", &iDevice, &iSubdevice1, &iSubdevice2, &iSubdevice3, &iRef, &iPrescaler, &iDutyCycle, &iFlag)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meUtilityPWMStart(iDevice, iSubdevice1, iSubdevice2, iSubdevice3, iRef, iPrescaler, iDutyCycle, iFlag);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
 		return NULL;
@@ -2952,7 +3715,9 @@ static PyObject *_wrap_meUtilityPWMStop(PyObject *self, PyObject *args) {
 	int iResult;
 
 	if(!PyArg_ParseTuple(args, "ii:meUtilityPWMStop", &iDevice, &iSubdevice)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meUtilityPWMStop(iDevice, iSubdevice);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
 		return NULL;
@@ -3105,7 +3870,9 @@ static PyObject *_wrap_meConfigLoad(PyObject *self, PyObject *args) {
 	int iResult;
 
 	if(!PyArg_ParseTuple(args, "z:meConfigLoad", &pcFile)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meConfigLoad(pcFile);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3129,7 +3896,9 @@ static PyObject *_wrap_meRQueryDescriptionDevice(PyObject *self, PyObject *args)
 	PyObject *objDescription;
 
 	if(!PyArg_ParseTuple(args, "si:meRQueryDescriptionDevice", &pcHost, &iDevice)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQueryDescriptionDevice(pcHost, iDevice, pcDescription, sizeof(pcDescription));
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3167,7 +3936,9 @@ static PyObject *_wrap_meRQueryInfoDevice(PyObject *self, PyObject *args) {
 	PyObject *objResult;
 
 	if(!PyArg_ParseTuple(args, "si:meRQueryNumberSubdevices", &pcHost, &iDevice)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQueryInfoDevice(pcHost, iDevice, &iVendorId, &iDeviceId, &iSerialNo, &iBusType, &iBusNo, &iDevNo, &iFuncNo, &iPlugged);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3346,7 +4117,9 @@ static PyObject *_wrap_meRQueryNameDevice(PyObject *self, PyObject *args) {
 	PyObject *objName;
 
 	if(!PyArg_ParseTuple(args, "si:meRQueryNameDevice", &pcHost, &iDevice)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQueryNameDevice(pcHost, iDevice, pcName, sizeof(pcName));
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3368,7 +4141,9 @@ static PyObject *_wrap_meRQueryNumberDevices(PyObject *self, PyObject *args) {
 	PyObject *objNumber;
 
 	if(!PyArg_ParseTuple(args, "s:meRQueryNumberDevices", &pcHost)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQueryNumberDevices(pcHost, &iNumber);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3391,7 +4166,9 @@ static PyObject *_wrap_meRQueryNumberSubdevices(PyObject *self, PyObject *args)
 	PyObject *objNumber;
 
 	if(!PyArg_ParseTuple(args, "si:meRQueryNumberSubdevices", &pcHost, &iDevice)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQueryNumberSubdevices(pcHost, iDevice, &iNumber);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3415,7 +4192,9 @@ static PyObject *_wrap_meRQueryNumberChannels(PyObject *self, PyObject *args) {
 	PyObject *objNumber;
 
 	if(!PyArg_ParseTuple(args, "sii:meRQueryNumberChannels", &pcHost, &iDevice, &iSubdevice)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQueryNumberChannels(pcHost, iDevice, iSubdevice, &iNumber);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3441,7 +4220,9 @@ static PyObject *_wrap_meRQueryNumberRanges(PyObject *self, PyObject *args) {
 
 	iNumber = 0;
 	if(!PyArg_ParseTuple(args, "siii:meRQueryNumberRanges", &pcHost, &iDevice, &iSubdevice, &iUnit)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQueryNumberRanges(pcHost, iDevice, iSubdevice, iUnit, &iNumber);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3473,7 +4254,9 @@ static PyObject *_wrap_meRQueryRangeInfo(PyObject *self, PyObject *args) {
 	PyObject *objResult;
 
 	if(!PyArg_ParseTuple(args, "siii:meIORQueryRangeInfo", &pcHost, &iDevice, &iSubdevice, &iRange)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQueryRangeInfo(pcHost, iDevice, iSubdevice, iRange, &iUnit, &dMin, &dMax, &iMaxData);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3560,7 +4343,9 @@ static PyObject *_wrap_meRQuerySubdeviceType(PyObject *self, PyObject *args) {
 	PyObject *objResult;
 
 	if(!PyArg_ParseTuple(args, "sii:meRQuerySubdeviceType", &pcHost, &iDevice, &iSubdevice)) return NULL;
+	Py_BEGIN_ALLOW_THREADS
 	iResult = meRQuerySubdeviceType(pcHost, iDevice, iSubdevice, &iType, &iSubtype);
+	Py_END_ALLOW_THREADS
 	if(iResult){
 
 		PyErr_SetObject(meError, me_int_CreateError(iResult));
@@ -3613,16 +4398,24 @@ static PyMethodDef meMethods[] = {
 	{ "meIOIrqStart", _wrap_meIOIrqStart, METH_VARARGS },
 	{ "meIOIrqStop", _wrap_meIOIrqStop, METH_VARARGS },
 	{ "meIOIrqWait", _wrap_meIOIrqWait, METH_VARARGS },
+	{ "meIOIrqSetCallback", _wrap_meIOIrqSetCallback, METH_VARARGS },
 	{ "meIOResetDevice", _wrap_meIOResetDevice, METH_VARARGS },
 	{ "meIOResetSubdevice", _wrap_meIOResetSubdevice, METH_VARARGS },
 	{ "meIOSingleConfig", _wrap_meIOSingleConfig, METH_VARARGS },
 	{ "meIOSingle", _wrap_meIOSingle, METH_VARARGS },
 	{ "meIOStreamConfig", _wrap_meIOStreamConfig, METH_VARARGS },
 	{ "meIOStreamRead", _wrap_meIOStreamRead, METH_VARARGS },
+	{ "meIOStreamReadInto", _wrap_meIOStreamReadInto, METH_VARARGS },
 	{ "meIOStreamWrite", _wrap_meIOStreamWrite, METH_VARARGS },
 	{ "meIOStreamStart", _wrap_meIOStreamStart, METH_VARARGS },
 	{ "meIOStreamStop", _wrap_meIOStreamStop, METH_VARARGS },
 	{ "meIOStreamStatus", _wrap_meIOStreamStatus, METH_VARARGS },
+	{ "meIOStreamSetCallbacks", _wrap_meIOStreamSetCallbacks, METH_VARARGS },
+#ifdef ME_POSIX
+	{ "meIOStreamNotifyOpen", _wrap_meIOStreamNotifyOpen, METH_VARARGS },
+	{ "meIOStreamNotifyAck", _wrap_meIOStreamNotifyAck, METH_VARARGS },
+	{ "meIOStreamNotifyClose", _wrap_meIOStreamNotifyClose, METH_VARARGS },
+#endif
 	{ "meIOStreamFrequencyToTicks", _wrap_meIOStreamFrequencyToTicks, METH_VARARGS },
 	{ "meIOStreamTimeToTicks", _wrap_meIOStreamTimeToTicks, METH_VARARGS },
 	{ "meQueryDescriptionDevice", _wrap_meQueryDescriptionDevice, METH_VARARGS },
@@ -3671,11 +4464,34 @@ static PyMethodDef meMethods[] = {
   Library initialization
   =========================================================================*/
 
+#if PY_MAJOR_VERSION >= 3
+static struct PyModuleDef meModule = {
+	PyModuleDef_HEAD_INIT,
+	"meDriver",
+	NULL,
+	-1,
+	meMethods
+};
+
+PyMODINIT_FUNC PyInit_meDriver(void){
+#else
 void initmeDriver(void){
+#endif
 	PyObject *m, *d;
 
+#if PY_VERSION_HEX < 0x03070000
+	/* Callbacks are called from the library's threads */
+	PyEval_InitThreads();
+#endif
+
 	/* Initialize the module */
+#if PY_MAJOR_VERSION >= 3
+	m = PyModule_Create(&meModule);
+	if(!m)
+		return NULL;
+#else
 	m = Py_InitModule("meDriver", meMethods);
+#endif
 
 	/* Load numerical python extension */
 	import_array();
@@ -3689,4 +4505,8 @@ void initmeDriver(void){
 
 	/* Install the constants */
 	me_InstallConstants(d, me_const_table);
+#if PY_MAJOR_VERSION >= 3
+
+	return m;
+#endif
 }
@@ -0,0 +1,183 @@
+"""asyncio interface to the streaming subdevices of the Meilhaus driver system.
+
+    async with meids.stream(Device, Subdevice, cfg) as blocks:
+        async for block in blocks:
+            ...
+
+The driver system's callback thread only wakes up the event loop (eventfd).
+Values are read by the consumer, when it asks for the next block. A consumer
+that lags behind leaves the values in the driver's buffer. When this buffer
+overflows, the driver's error is raised as meDriver.error.
+
+Linux only. Requires Python 3.5 or newer.
+"""
+
+import asyncio
+
+import numpy
+
+import meDriver
+
+
+class stream(object):
+    """Asynchronous iterator over blocks of values of one running stream.
+
+    cfg is a dictionary with the arguments of meIOStreamConfig():
+        'ConfigList'        # Python list
+        'Trigger'           # Python dictionary
+        'FifoIrqThreshold'  # Python integer (optional, 0)
+        'Flags'             # Python integer (optional, ME_IO_STREAM_CONFIG_NO_FLAGS)
+
+    Stream is configured and started on first iteration (or when entering
+    'async with') and stopped, when it ends, on error or by aclose().
+    Every block is a new one dimensional numpy array of 'block' values of
+    type 'dtype' (int16, int32, float32 or float64). Last block can be shorter.
+    """
+
+    def __init__(self, device, subdevice, cfg, block=0x1000, dtype=numpy.int32):
+        if block <= 0:
+            raise ValueError("block must be positive")
+
+        self.device = device
+        self.subdevice = subdevice
+        self.cfg = cfg
+        self.block = block
+        self.dtype = dtype
+
+        self._fd = None
+        self._running = False
+        self._done = False
+        self._values = None
+        self._filled = 0
+
+    def _open(self):
+        cfg = self.cfg
+        meDriver.meIOStreamConfig(self.device, self.subdevice,
+                                  cfg['ConfigList'], cfg['Trigger'],
+                                  cfg.get('FifoIrqThreshold', 0),
+                                  cfg.get('Flags', meDriver.ME_IO_STREAM_CONFIG_NO_FLAGS))
+
+        meDriver.meIOStreamStart([{'Device': self.device,
+                                   'Subdevice': self.subdevice,
+                                   'StartMode': meDriver.ME_START_MODE_NONBLOCKING,
+                                   'TimeOut': 0,
+                                   'Flags': meDriver.ME_IO_STREAM_START_TYPE_NO_FLAGS,
+                                   'Errno': 0}],
+                                 meDriver.ME_IO_STREAM_START_NO_FLAGS)
+        self._running = True
+
+        # Registered after start. End of stream before registration is seen by the status check.
+        try:
+            self._fd = meDriver.meIOStreamNotifyOpen(self.device, self.subdevice,
+                                                     meDriver.ME_IO_STREAM_SET_CALLBACKS_NO_FLAGS)
+        except BaseException:
+            self._abort()
+            raise
+
+    def _close(self):
+        self._done = True
+
+        if self._fd is not None:
+            meDriver.meIOStreamNotifyClose(self.device, self.subdevice)
+            self._fd = None
+
+        if self._running:
+            self._running = False
+            meDriver.meIOStreamStop([{'Device': self.device,
+                                      'Subdevice': self.subdevice,
+                                      'StopMode': meDriver.ME_STOP_MODE_IMMEDIATE,
+                                      'Flags': meDriver.ME_IO_STREAM_STOP_TYPE_NO_FLAGS,
+                                      'Errno': 0}],
+                                    meDriver.ME_IO_STREAM_STOP_NO_FLAGS)
+
+    def _abort(self):
+        """Closes on error. Errors of close must not hide the original one."""
+        try:
+            self._close()
+        except meDriver.error:
+            pass
+
+    def _take(self):
+        values = self._values[:self._filled]
+        self._values = None
+        self._filled = 0
+        return values
+
+    async def _wait(self):
+        """Waits for notification. Descriptor is watched only while consumer waits for values."""
+        try:
+            loop = asyncio.get_running_loop()
+        except AttributeError:
+            loop = asyncio.get_event_loop()
+
+        ready = loop.create_future()
+
+        def wake():
+            if not ready.done():
+                ready.set_result(None)
+
+        loop.add_reader(self._fd, wake)
+        try:
+            await ready
+        finally:
+            loop.remove_reader(self._fd)
+
+    def __aiter__(self):
+        return self
+
+    async def __anext__(self):
+        if self._done:
+            raise StopAsyncIteration
+
+        try:
+            if not self._running:
+                self._open()
+
+            while True:
+                # Notifications are acknowledged before reading. Values written later wake up next wait.
+                meDriver.meIOStreamNotifyAck(self.device, self.subdevice)
+                (status, count) = meDriver.meIOStreamStatus(self.device, self.subdevice,
+                                                            meDriver.ME_WAIT_NONE,
+                                                            meDriver.ME_IO_STREAM_STATUS_NO_FLAGS)
+
+                if self._values is None:
+                    self._values = numpy.empty(self.block, dtype=self.dtype)
+                self._filled += meDriver.meIOStreamReadInto(self.device, self.subdevice,
+                                                            meDriver.ME_READ_MODE_NONBLOCKING,
+                                                            memoryview(self._values)[self._filled:],
+                                                            meDriver.ME_IO_STREAM_READ_NO_FLAGS)
+                if self._filled == self.block:
+                    return self._take()
+
+                if status != meDriver.ME_STATUS_BUSY:
+                    # Stream was already stopped before reading. Nothing more will come.
+                    self._close()
+                    if self._filled:
+                        return self._take()
+                    raise StopAsyncIteration
+
+                await self._wait()
+        except (meDriver.error, asyncio.CancelledError):
+            self._abort()
+            raise
+
+    async def aclose(self):
+        """Stops the stream. Values not read yet are lost."""
+        if not self._done:
+            self._close()
+
+    async def __aenter__(self):
+        if not self._running and not self._done:
+            try:
+                self._open()
+            except meDriver.error:
+                self._done = True
+                raise
+        return self
+
+    async def __aexit__(self, exc_type, exc, tb):
+        if exc_type is None:
+            await self.aclose()
+        else:
+            self._abort()
+        return False
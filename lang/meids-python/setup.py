@@ -16,9 +16,15 @@ elif os.name == 'posix':
 	macro = [('ME_POSIX', None)]
 	library = ['MEiDS']
 else:
-	print "Error: Unknown Operating System"
+	print("Error: Unknown Operating System")
 	sys.exit(1)
 
+# asyncio interface (meids.py) needs Python 3.5 and eventfd.
+if os.name == 'posix' and sys.version_info >= (3, 5):
+	py_modules = ['meids']
+else:
+	py_modules = []
+
 module = Extension(
 	'meDriver',
 	 define_macros = macro,
@@ -37,4 +43,5 @@ setup(
 	license="GNU LGPL",
 	long_description="""Extension module which enables access
 to the ME-iDS C-library providing the API described in the ME-iDS manual.""",
-	ext_modules = [module])
+	ext_modules = [module],
+	py_modules = py_modules)
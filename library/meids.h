@@ -43,6 +43,7 @@ int  ME_QueryRangesNumber(int device, int subdevice, int unit, int* no_ranges, i
 int  ME_QueryRangeInfo(int device, int subdevice, int range, int* unit, double* min, double* max, unsigned int* max_data, int iFlags);
 int  ME_QueryRangeByMinMax(int device, int subdevice, int unit, double* min, double* max, int* max_data, int* range, int iFlags);
 int  ME_QuerySubdeviceTimer(int device, int subdevice, int timer, int* base, int* min_ticks_low, int* min_ticks_high, int* max_ticks_low, int* max_ticks_high, int iFlags);
+int  ME_QueryLatencyProbe(int device, int subdevice, meLatencyProbe_t* probe, int iFlags);
 
 //Input/Output
 int  ME_IrqStart(int device, int subdevice, int channel, int source, int edge, int arg, int iFlags);
@@ -71,6 +72,7 @@ int  ME_StreamWrite(int device, int subdevice, int mode, int* values, int* count
 int  ME_StreamStart(int device, int subdevice, int mode, int timeout, int iFlags);
 int  ME_StreamStartList(meIOStreamStart_t* list, int count, int iFlags);
 int  ME_StreamStatus(int device, int subdevice, int wait, int* status, int* count, int iFlags);
+int  ME_StreamReader(int device, int subdevice, int mode, int policy, int* dropped, int iFlags);
 int  ME_StreamStop(int device, int subdevice, int mode, int timeout, int iFlags);
 int  ME_StreamStopList(meIOStreamStop_t* list, int count, int iFlags);
 
@@ -85,6 +87,11 @@ int  ME_StreamFrequencyToTicks(int device, int subdevice, int timer, double* fre
 
 int  ME_SetOffset(int device, int subdevice, int channel, int range, double* offset, int iFlags);
 
+/// Compound requests. Only calls to remote contexts are recorded.
+int  ME_BatchBegin(int iFlags);
+int  ME_BatchCommit(int* index, int iFlags);
+int  ME_BatchAbort(int iFlags);
+
 void ME_ConfigPrint(void);
 
 void ME_SetErrno(char* text, int err);
@@ -680,6 +680,9 @@ static int copy_me_cfg_entry(const me_cfg_device_entry_t* cfg_Source, me_config_
 							newEntry->info.usb.root_hub_no = cfg_Source->info.usb.root_hub_no;
 						break;
 
+					case me_access_type_simulated:
+						break;
+
 					default:
 						LIBPERROR("ACCESS TYPE 0x%04x NOT IMPLEMENTED!\n", newEntry->access_type);
 						err = ME_ERRNO_INTERNAL;
@@ -973,3 +976,36 @@ void ShortcutClean(me_config_shortcut_table_t* table)
 }
 
 
+
+void ConfigQueryCacheFill(me_cfg_subdevice_entry_t* subdevice)
+{
+	me_cfg_query_cache_t* cache = &subdevice->cache;
+	int i;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	// Info was just read from driver. It is the answer of queries.
+	cache->type = subdevice->info.type;
+	cache->sub_type = subdevice->info.sub_type;
+	cache->channels = subdevice->info.channels;
+	cache->valid |= ME_CFG_CACHE_TYPE | ME_CFG_CACHE_CHANNELS;
+
+	// No ranges can also mean ME_ERRNO_NOT_SUPPORTED. Leave that for driver.
+	if (subdevice->info.range_list_count && (subdevice->info.range_list_count <= ME_CFG_CACHE_RANGES))
+	{
+		for (i=0; i<subdevice->info.range_list_count; i++)
+		{
+			if (!subdevice->info.range_list[i])
+				break;
+
+			cache->ranges[i] = *subdevice->info.range_list[i];
+			cache->ranges_valid |= 0x1 << i;
+		}
+
+		if (i == subdevice->info.range_list_count)
+		{
+			cache->ranges_number = subdevice->info.range_list_count;
+			cache->valid |= ME_CFG_CACHE_RANGES_NUMBER;
+		}
+	}
+}
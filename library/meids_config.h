@@ -40,6 +40,8 @@ int  ShortcutResolve(const me_config_shortcut_table_t* table, const int logical_
 void ShortcutClean(me_config_shortcut_table_t* table);
 
 int  ConfigMaxNumber(const me_config_t* cfg, int* number, int flags);
+/// Take info of subdevice (freshly read from driver) as cached query results.
+void ConfigQueryCacheFill(me_cfg_subdevice_entry_t* subdevice);
 
 # endif	//_MEIDS_CONFIG_H_
 #endif	//__KERNEL__
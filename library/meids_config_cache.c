@@ -0,0 +1,790 @@
+/* Shared library for Meilhaus driver system (config cache).
+ * ==========================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <unistd.h>
+# include <stdio.h>
+# include <stdlib.h>
+# include <stdint.h>
+# include <string.h>
+# include <errno.h>
+# include <fcntl.h>
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+
+# include "me_error.h"
+# include "me_types.h"
+# include "me_defines.h"
+
+# include "meids_common.h"
+# include "meids_internal.h"
+# include "meids_config_structs.h"
+# include "meids_debug.h"
+
+# include "meids_config.h"
+# include "meids_config_cache.h"
+
+# define ME_CACHE_MAGIC			0x4D454343	// "MECC"
+# define ME_CACHE_VERSION		0x00010000
+
+# define ME_CACHE_NO_STRING		0xFFFFFFFF
+# define ME_CACHE_NO_CONTEXT	-1
+
+/// FNV-1a
+# define ME_CACHE_HASH_INIT		0xCBF29CE484222325ULL
+# define ME_CACHE_HASH_PRIME	0x00000100000001B3ULL
+
+/// All offsets are counted from begin of file.
+typedef struct me_cache_header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t library_version;
+	uint32_t size;
+
+	// XML key
+	int64_t xml_mtime_sec;
+	int64_t xml_mtime_nsec;
+	int64_t xml_size;
+	uint64_t xml_ino;
+	uint64_t xml_hash;
+
+	// Hardware key
+	uint64_t topology_hash;
+
+	uint32_t device_count;
+	uint32_t subdevice_count;
+	uint32_t range_count;
+	uint32_t strings_size;
+
+	uint32_t device_offset;
+	uint32_t subdevice_offset;
+	uint32_t range_offset;
+	uint32_t strings_offset;
+} me_cache_header_t;
+
+typedef struct me_cache_device
+{
+	int32_t context_index;
+	int32_t access_type;
+	int32_t logical_device_no;
+	int32_t plugged;
+
+	uint32_t vendor_id;
+	uint32_t device_id;
+	uint32_t serial_no;
+	int32_t device_no;
+
+	uint32_t hw_info[3];		// PCI: bus, device, function. USB: root hub.
+	uint32_t device_name;		// Offsets in string table.
+	uint32_t device_description;
+	uint32_t remote_host;
+
+	uint32_t subdevice_first;
+	uint32_t subdevice_count;
+} me_cache_device_t;
+
+typedef struct me_cache_subdevice
+{
+	int32_t locked;
+	int32_t type;
+	int32_t sub_type;
+	uint32_t channels;
+
+	uint32_t range_first;
+	uint32_t range_count;
+
+	me_cfg_extention_t extention;
+} me_cache_subdevice_t;
+
+typedef struct me_cache_range
+{
+	int32_t unit;
+	uint32_t max_data;
+	double min;
+	double max;
+} me_cache_range_t;
+
+typedef struct me_cache_xml_key
+{
+	int64_t mtime_sec;
+	int64_t mtime_nsec;
+	int64_t size;
+	uint64_t ino;
+} me_cache_xml_key_t;
+
+static const char* cache_file_name(char* buffer, int size);
+static uint64_t cache_hash(uint64_t hash, const void* data, size_t size);
+static uint64_t cache_hash_string(uint64_t hash, const char* str);
+static void cache_xml_key(const char* xml_file, me_cache_xml_key_t* key);
+static uint64_t cache_xml_hash(const char* xml_file);
+static uint64_t cache_topology_hash(const me_config_t* cfg);
+static int  cache_context_index(const me_config_t* cfg_Source, void* context);
+static int  cache_check(const char* xml_file, const me_config_t* cfg_Source, const char* cache, size_t size);
+static char* cache_string(const char* cache, const me_cache_header_t* header, uint32_t offset);
+static int  cache_build_device(const char* cache, const me_cache_header_t* header, const me_cache_device_t* record,
+								const me_config_t* cfg_Source, me_cfg_device_entry_t* device);
+
+static const char* cache_file_name(char* buffer, int size)
+{
+	const char* env = getenv("MEIDS_CONFIG_CACHE");
+
+	if (env)
+	{
+		if (!strlen(env) || !strcmp(env, "0"))
+			return NULL;
+
+		return env;
+	}
+
+	snprintf(buffer, size, MEIDS_CONFIG_CACHE_FILE, (unsigned int)getuid());
+	return buffer;
+}
+
+static uint64_t cache_hash(uint64_t hash, const void* data, size_t size)
+{
+	const unsigned char* pos = data;
+
+	while (size--)
+	{
+		hash ^= *pos++;
+		hash *= ME_CACHE_HASH_PRIME;
+	}
+
+	return hash;
+}
+
+static uint64_t cache_hash_string(uint64_t hash, const char* str)
+{
+	// Terminating zero is hashed too. NULL and "" must differ from each other.
+	if (!str)
+		return cache_hash(hash, "\xFF", 1);
+
+	return cache_hash(hash, str, strlen(str) + 1);
+}
+
+static void cache_xml_key(const char* xml_file, me_cache_xml_key_t* key)
+{
+	struct stat st;
+
+	memset(key, 0, sizeof(me_cache_xml_key_t));
+
+	if (stat(xml_file, &st))
+	{// No XML file is also valid configuration.
+		key->size = -1;
+		return;
+	}
+
+	key->mtime_sec = st.st_mtim.tv_sec;
+	key->mtime_nsec = st.st_mtim.tv_nsec;
+	key->size = st.st_size;
+	key->ino = st.st_ino;
+}
+
+static uint64_t cache_xml_hash(const char* xml_file)
+{
+	uint64_t hash = ME_CACHE_HASH_INIT;
+	char buffer[4096];
+	size_t count;
+	FILE* file;
+
+	file = fopen(xml_file, "r");
+	if (!file)
+		return 0;
+
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		hash = cache_hash(hash, buffer, count);
+	}
+
+	fclose(file);
+	return hash;
+}
+
+static int cache_context_index(const me_config_t* cfg_Source, void* context)
+{
+	int i;
+
+	if (!context)
+		return ME_CACHE_NO_CONTEXT;
+
+	for (i = 0; i < cfg_Source->device_list_count; i++)
+	{
+		if (cfg_Source->device_list[i]->context == context)
+			return i;
+	}
+
+	return ME_CACHE_NO_CONTEXT;
+}
+
+static uint64_t cache_topology_hash(const me_config_t* cfg)
+{
+	uint64_t hash = ME_CACHE_HASH_INIT;
+	me_cfg_device_entry_t* device;
+	me_cfg_subdevice_entry_t* subdevice;
+	me_cfg_range_info_t* range;
+	int context_index;
+	int i;
+	int s;
+	int r;
+
+	hash = cache_hash(hash, &cfg->device_list_count, sizeof(cfg->device_list_count));
+
+	for (i = 0; i < cfg->device_list_count; i++)
+	{
+		device = cfg->device_list[i];
+
+		// Context pointers differ from run to run. Only grouping of devices matters.
+		context_index = cache_context_index(cfg, device->context);
+		hash = cache_hash(hash, &context_index, sizeof(context_index));
+
+		hash = cache_hash(hash, &device->access_type, sizeof(device->access_type));
+		hash = cache_hash(hash, &device->logical_device_no, sizeof(device->logical_device_no));
+		hash = cache_hash(hash, &device->plugged, sizeof(device->plugged));
+		hash = cache_hash(hash, &device->info.vendor_id, sizeof(device->info.vendor_id));
+		hash = cache_hash(hash, &device->info.device_id, sizeof(device->info.device_id));
+		hash = cache_hash(hash, &device->info.serial_no, sizeof(device->info.serial_no));
+		hash = cache_hash(hash, &device->info.device_no, sizeof(device->info.device_no));
+		hash = cache_hash_string(hash, device->info.device_name);
+		hash = cache_hash_string(hash, device->info.device_description);
+
+		switch (device->access_type)
+		{
+			case me_access_type_PCI:
+				hash = cache_hash(hash, &device->info.pci, sizeof(device->info.pci));
+				break;
+
+			case me_access_type_USB:
+				hash = cache_hash(hash, &device->info.usb, sizeof(device->info.usb));
+				break;
+
+			case me_access_type_TCPIP:
+				hash = cache_hash_string(hash, device->info.tcpip.remote_host);
+				break;
+
+			default:
+				break;
+		}
+
+		hash = cache_hash(hash, &device->subdevice_list_count, sizeof(device->subdevice_list_count));
+		for (s = 0; s < device->subdevice_list_count; s++)
+		{
+			subdevice = device->subdevice_list[s];
+			hash = cache_hash(hash, &subdevice->info.type, sizeof(subdevice->info.type));
+			hash = cache_hash(hash, &subdevice->info.sub_type, sizeof(subdevice->info.sub_type));
+			hash = cache_hash(hash, &subdevice->info.channels, sizeof(subdevice->info.channels));
+			hash = cache_hash(hash, &subdevice->info.range_list_count, sizeof(subdevice->info.range_list_count));
+			for (r = 0; r < subdevice->info.range_list_count; r++)
+			{
+				range = subdevice->info.range_list[r];
+				hash = cache_hash(hash, &range->unit, sizeof(range->unit));
+				hash = cache_hash(hash, &range->min, sizeof(range->min));
+				hash = cache_hash(hash, &range->max, sizeof(range->max));
+				hash = cache_hash(hash, &range->max_data, sizeof(range->max_data));
+			}
+		}
+	}
+
+	return hash;
+}
+
+static int cache_check(const char* xml_file, const me_config_t* cfg_Source, const char* cache, size_t size)
+{
+	me_cache_header_t header;
+	me_cache_xml_key_t key;
+	uint64_t end;
+
+	if (size < sizeof(me_cache_header_t))
+		return ME_ERRNO_INTERNAL;
+
+	memcpy(&header, cache, sizeof(me_cache_header_t));
+
+	if ((header.magic != ME_CACHE_MAGIC) || (header.version != ME_CACHE_VERSION) || (header.library_version != MEIDS_VERSION_LIBRARY) || (header.size != size))
+	{
+		LIBPINFO("Cache has different format.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+
+	// Tables have to be inside of file.
+	end = (uint64_t)header.device_offset + (uint64_t)header.device_count * sizeof(me_cache_device_t);
+	if (end > size)
+		return ME_ERRNO_INTERNAL;
+	end = (uint64_t)header.subdevice_offset + (uint64_t)header.subdevice_count * sizeof(me_cache_subdevice_t);
+	if (end > size)
+		return ME_ERRNO_INTERNAL;
+	end = (uint64_t)header.range_offset + (uint64_t)header.range_count * sizeof(me_cache_range_t);
+	if (end > size)
+		return ME_ERRNO_INTERNAL;
+	end = (uint64_t)header.strings_offset + (uint64_t)header.strings_size;
+	if (end > size)
+		return ME_ERRNO_INTERNAL;
+
+	if (header.topology_hash != cache_topology_hash(cfg_Source))
+	{
+		LIBPINFO("Hardware changed.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+
+	// Same file, not touched. Content hash is checked only if time stamp changed.
+	cache_xml_key(xml_file, &key);
+	if ((key.size == header.xml_size) && (key.size < 0))
+		return ME_ERRNO_SUCCESS;
+
+	if ((key.mtime_sec == header.xml_mtime_sec) && (key.mtime_nsec == header.xml_mtime_nsec)
+		&& (key.size == header.xml_size) && (key.ino == header.xml_ino))
+		return ME_ERRNO_SUCCESS;
+
+	if ((key.size >= 0) && (key.size == header.xml_size) && (cache_xml_hash(xml_file) == header.xml_hash))
+		return ME_ERRNO_SUCCESS;
+
+	LIBPINFO("XML changed.\n");
+	return ME_ERRNO_INTERNAL;
+}
+
+static char* cache_string(const char* cache, const me_cache_header_t* header, uint32_t offset)
+{
+	const char* str;
+
+	if (offset == ME_CACHE_NO_STRING)
+		return NULL;
+
+	if (offset >= header->strings_size)
+		return NULL;
+
+	str = cache + header->strings_offset + offset;
+	if (!memchr(str, '\0', header->strings_size - offset))
+		return NULL;
+
+	return strdup(str);
+}
+
+static int cache_build_device(const char* cache, const me_cache_header_t* header, const me_cache_device_t* record,
+								const me_config_t* cfg_Source, me_cfg_device_entry_t* device)
+{
+	me_cache_subdevice_t subdevice_record;
+	me_cache_range_t range_record;
+	me_cfg_subdevice_entry_t* subdevice;
+	me_cfg_range_info_t* range;
+	int s;
+	int r;
+
+	if (((uint64_t)record->subdevice_first + record->subdevice_count) > header->subdevice_count)
+		return ME_ERRNO_INTERNAL;
+
+	if (record->context_index != ME_CACHE_NO_CONTEXT)
+	{
+		if ((record->context_index < 0) || (record->context_index >= cfg_Source->device_list_count))
+			return ME_ERRNO_INTERNAL;
+
+		device->context = cfg_Source->device_list[record->context_index]->context;
+	}
+
+	device->access_type = record->access_type;
+	device->logical_device_no = record->logical_device_no;
+	device->plugged = record->plugged;
+	device->info.vendor_id = record->vendor_id;
+	device->info.device_id = record->device_id;
+	device->info.serial_no = record->serial_no;
+	device->info.device_no = record->device_no;
+	device->info.device_name = cache_string(cache, header, record->device_name);
+	device->info.device_description = cache_string(cache, header, record->device_description);
+
+	switch (device->access_type)
+	{
+		case me_access_type_PCI:
+			device->info.pci.bus_no = record->hw_info[0];
+			device->info.pci.device_no = record->hw_info[1];
+			device->info.pci.function_no = record->hw_info[2];
+			break;
+
+		case me_access_type_USB:
+			device->info.usb.root_hub_no = record->hw_info[0];
+			break;
+
+		case me_access_type_TCPIP:
+			device->info.tcpip.remote_host = cache_string(cache, header, record->remote_host);
+			break;
+
+		default:
+			break;
+	}
+
+	device->subdevice_list = calloc(record->subdevice_count, sizeof(me_cfg_subdevice_entry_t*));
+	if (!device->subdevice_list && record->subdevice_count)
+		return ME_ERRNO_INTERNAL;
+
+	for (s = 0; s < record->subdevice_count; s++)
+	{
+		memcpy(&subdevice_record, cache + header->subdevice_offset + (record->subdevice_first + s) * sizeof(me_cache_subdevice_t), sizeof(me_cache_subdevice_t));
+		if (((uint64_t)subdevice_record.range_first + subdevice_record.range_count) > header->range_count)
+			return ME_ERRNO_INTERNAL;
+
+		subdevice = calloc(1, sizeof(me_cfg_subdevice_entry_t));
+		if (!subdevice)
+			return ME_ERRNO_INTERNAL;
+
+		device->subdevice_list[s] = subdevice;
+		device->subdevice_list_count = s + 1;
+
+		subdevice->locked = subdevice_record.locked;
+		subdevice->info.type = subdevice_record.type;
+		subdevice->info.sub_type = subdevice_record.sub_type;
+		subdevice->info.channels = subdevice_record.channels;
+		subdevice->extention = subdevice_record.extention;
+
+		subdevice->info.range_list = calloc(subdevice_record.range_count, sizeof(me_cfg_range_info_t*));
+		if (!subdevice->info.range_list && subdevice_record.range_count)
+			return ME_ERRNO_INTERNAL;
+
+		for (r = 0; r < subdevice_record.range_count; r++)
+		{
+			memcpy(&range_record, cache + header->range_offset + (subdevice_record.range_first + r) * sizeof(me_cache_range_t), sizeof(me_cache_range_t));
+
+			range = calloc(1, sizeof(me_cfg_range_info_t));
+			if (!range)
+				return ME_ERRNO_INTERNAL;
+
+			subdevice->info.range_list[r] = range;
+			subdevice->info.range_list_count = r + 1;
+
+			range->unit = range_record.unit;
+			range->min = range_record.min;
+			range->max = range_record.max;
+			range->max_data = range_record.max_data;
+		}
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int ConfigCacheLoad(const char* xml_file, const me_config_t* cfg_Source, me_config_t* cfg_Dest, int flags)
+{
+	char name_buffer[64];
+	const char* name;
+	me_cache_header_t header;
+	me_cache_device_t record;
+	me_cfg_device_entry_t* device;
+	struct stat st;
+	char* cache;
+	int fd;
+	int i;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (flags)
+	{
+		LIBPWARNING("Flags are not supported, yet.\n");
+	}
+
+	name = cache_file_name(name_buffer, sizeof(name_buffer));
+	if (!name)
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	fd = open(name, O_RDONLY);
+	if (fd < 0)
+		return ME_ERRNO_OPEN;
+
+	// Only own cache is trusted.
+	if (fstat(fd, &st) || (st.st_uid != getuid()) || (st.st_size < sizeof(me_cache_header_t)))
+	{
+		close(fd);
+		return ME_ERRNO_OPEN;
+	}
+
+	cache = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (cache == MAP_FAILED)
+	{
+		LIBPERROR("mmap(%s) failed: %s\n", name, strerror(errno));
+		return ME_ERRNO_OPEN;
+	}
+
+	err = cache_check(xml_file, cfg_Source, cache, st.st_size);
+	if (!err)
+	{
+		memcpy(&header, cache, sizeof(me_cache_header_t));
+
+		cfg_Dest->device_list = calloc(header.device_count, sizeof(me_cfg_device_entry_t*));
+		if (!cfg_Dest->device_list && header.device_count)
+		{
+			err = ME_ERRNO_INTERNAL;
+		}
+
+		for (i = 0; !err && (i < header.device_count); i++)
+		{
+			memcpy(&record, cache + header.device_offset + i * sizeof(me_cache_device_t), sizeof(me_cache_device_t));
+
+			device = calloc(1, sizeof(me_cfg_device_entry_t));
+			if (!device)
+			{
+				err = ME_ERRNO_INTERNAL;
+				break;
+			}
+
+			cfg_Dest->device_list[i] = device;
+			cfg_Dest->device_list_count = i + 1;
+
+			err = cache_build_device(cache, &header, &record, cfg_Source, device);
+		}
+
+		if (err)
+		{
+			LIBPERROR("Cache %s is corrupted.\n", name);
+			ConfigClean(cfg_Dest, ME_VALUE_NOT_USED);
+		}
+	}
+
+	munmap(cache, st.st_size);
+
+	LIBPDEBUG("ConfigCacheLoad(%s)=%d\n", name, err);
+	return err;
+}
+
+/// Appends string to table. Returns its offset.
+static uint32_t cache_put_string(char** strings, uint32_t* size, const char* str)
+{
+	uint32_t offset;
+	char* tmp;
+	size_t len;
+
+	if (!str)
+		return ME_CACHE_NO_STRING;
+
+	len = strlen(str) + 1;
+	tmp = realloc(*strings, *size + len);
+	if (!tmp)
+		return ME_CACHE_NO_STRING;
+
+	*strings = tmp;
+	offset = *size;
+	memcpy(*strings + offset, str, len);
+	*size += len;
+
+	return offset;
+}
+
+int ConfigCacheStore(const char* xml_file, const me_config_t* cfg_Source, const me_config_t* cfg_Bound, int flags)
+{
+	char name_buffer[64];
+	char tmp_name[128];
+	const char* name;
+	me_cache_header_t header;
+	me_cache_xml_key_t key;
+	me_cache_device_t* devices = NULL;
+	me_cache_subdevice_t* subdevices = NULL;
+	me_cache_range_t* ranges = NULL;
+	char* strings = NULL;
+	me_cfg_device_entry_t* device;
+	me_cfg_subdevice_entry_t* subdevice;
+	me_cfg_range_info_t* range;
+	FILE* file;
+	int fd;
+	int i;
+	int s;
+	int r;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (flags)
+	{
+		LIBPWARNING("Flags are not supported, yet.\n");
+	}
+
+	name = cache_file_name(name_buffer, sizeof(name_buffer));
+	if (!name)
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	memset(&header, 0, sizeof(me_cache_header_t));
+	header.magic = ME_CACHE_MAGIC;
+	header.version = ME_CACHE_VERSION;
+	header.library_version = MEIDS_VERSION_LIBRARY;
+
+	cache_xml_key(xml_file, &key);
+	header.xml_mtime_sec = key.mtime_sec;
+	header.xml_mtime_nsec = key.mtime_nsec;
+	header.xml_size = key.size;
+	header.xml_ino = key.ino;
+	header.xml_hash = (key.size >= 0) ? cache_xml_hash(xml_file) : 0;
+
+	header.topology_hash = cache_topology_hash(cfg_Source);
+
+	// Count records.
+	header.device_count = cfg_Bound->device_list_count;
+	for (i = 0; i < cfg_Bound->device_list_count; i++)
+	{
+		device = cfg_Bound->device_list[i];
+		header.subdevice_count += device->subdevice_list_count;
+		for (s = 0; s < device->subdevice_list_count; s++)
+		{
+			header.range_count += device->subdevice_list[s]->info.range_list_count;
+		}
+	}
+
+	devices = calloc(header.device_count + 1, sizeof(me_cache_device_t));
+	subdevices = calloc(header.subdevice_count + 1, sizeof(me_cache_subdevice_t));
+	ranges = calloc(header.range_count + 1, sizeof(me_cache_range_t));
+	if (!devices || !subdevices || !ranges)
+	{
+		LIBPERROR("Can not get requestet memory for config cache.\n");
+		err = ME_ERRNO_INTERNAL;
+		goto EXIT;
+	}
+
+	header.subdevice_count = 0;
+	header.range_count = 0;
+	for (i = 0; i < cfg_Bound->device_list_count; i++)
+	{
+		device = cfg_Bound->device_list[i];
+
+		devices[i].context_index = cache_context_index(cfg_Source, device->context);
+		if (device->context && (devices[i].context_index == ME_CACHE_NO_CONTEXT))
+		{// Context that hardware doesn't know can not be restored.
+			LIBPWARNING("Entry %d has unknown context. Not cached.\n", i);
+			err = ME_ERRNO_INTERNAL;
+			goto EXIT;
+		}
+
+		devices[i].access_type = device->access_type;
+		devices[i].logical_device_no = device->logical_device_no;
+		devices[i].plugged = device->plugged;
+		devices[i].vendor_id = device->info.vendor_id;
+		devices[i].device_id = device->info.device_id;
+		devices[i].serial_no = device->info.serial_no;
+		devices[i].device_no = device->info.device_no;
+		devices[i].device_name = cache_put_string(&strings, &header.strings_size, device->info.device_name);
+		devices[i].device_description = cache_put_string(&strings, &header.strings_size, device->info.device_description);
+		devices[i].remote_host = ME_CACHE_NO_STRING;
+
+		switch (device->access_type)
+		{
+			case me_access_type_PCI:
+				devices[i].hw_info[0] = device->info.pci.bus_no;
+				devices[i].hw_info[1] = device->info.pci.device_no;
+				devices[i].hw_info[2] = device->info.pci.function_no;
+				break;
+
+			case me_access_type_USB:
+				devices[i].hw_info[0] = device->info.usb.root_hub_no;
+				break;
+
+			case me_access_type_TCPIP:
+				devices[i].remote_host = cache_put_string(&strings, &header.strings_size, device->info.tcpip.remote_host);
+				break;
+
+			default:
+				break;
+		}
+
+		devices[i].subdevice_first = header.subdevice_count;
+		devices[i].subdevice_count = device->subdevice_list_count;
+
+		for (s = 0; s < device->subdevice_list_count; s++)
+		{
+			subdevice = device->subdevice_list[s];
+
+			subdevices[header.subdevice_count].locked = subdevice->locked;
+			subdevices[header.subdevice_count].type = subdevice->info.type;
+			subdevices[header.subdevice_count].sub_type = subdevice->info.sub_type;
+			subdevices[header.subdevice_count].channels = subdevice->info.channels;
+			subdevices[header.subdevice_count].extention = subdevice->extention;
+			subdevices[header.subdevice_count].range_first = header.range_count;
+			subdevices[header.subdevice_count].range_count = subdevice->info.range_list_count;
+
+			for (r = 0; r < subdevice->info.range_list_count; r++)
+			{
+				range = subdevice->info.range_list[r];
+
+				ranges[header.range_count].unit = range->unit;
+				ranges[header.range_count].max_data = range->max_data;
+				ranges[header.range_count].min = range->min;
+				ranges[header.range_count].max = range->max;
+				header.range_count++;
+			}
+			header.subdevice_count++;
+		}
+	}
+
+	header.device_offset = sizeof(me_cache_header_t);
+	header.subdevice_offset = header.device_offset + header.device_count * sizeof(me_cache_device_t);
+	header.range_offset = header.subdevice_offset + header.subdevice_count * sizeof(me_cache_subdevice_t);
+	header.strings_offset = header.range_offset + header.range_count * sizeof(me_cache_range_t);
+	header.size = header.strings_offset + header.strings_size;
+
+	// Write to temporary file and replace the old one. Readers never see half written cache.
+	snprintf(tmp_name, sizeof(tmp_name), "%s.%d", name, (int)getpid());
+	fd = open(tmp_name, O_WRONLY | O_CREAT | O_TRUNC | O_EXCL, 0600);
+	if (fd < 0)
+	{
+		LIBPWARNING("Can not create %s: %s\n", tmp_name, strerror(errno));
+		err = ME_ERRNO_OPEN;
+		goto EXIT;
+	}
+
+	file = fdopen(fd, "w");
+	if (!file)
+	{
+		close(fd);
+		unlink(tmp_name);
+		err = ME_ERRNO_OPEN;
+		goto EXIT;
+	}
+
+	if ((fwrite(&header, sizeof(me_cache_header_t), 1, file) != 1)
+		|| (fwrite(devices, sizeof(me_cache_device_t), header.device_count, file) != header.device_count)
+		|| (fwrite(subdevices, sizeof(me_cache_subdevice_t), header.subdevice_count, file) != header.subdevice_count)
+		|| (fwrite(ranges, sizeof(me_cache_range_t), header.range_count, file) != header.range_count)
+		|| (header.strings_size && (fwrite(strings, header.strings_size, 1, file) != 1)))
+	{
+		err = ME_ERRNO_INTERNAL;
+	}
+
+	if (fclose(file))
+	{
+		err = ME_ERRNO_INTERNAL;
+	}
+
+	if (!err && rename(tmp_name, name))
+	{
+		LIBPWARNING("Can not replace %s: %s\n", name, strerror(errno));
+		err = ME_ERRNO_OPEN;
+	}
+
+	if (err)
+	{
+		unlink(tmp_name);
+	}
+
+EXIT:
+	free(devices);
+	free(subdevices);
+	free(ranges);
+	free(strings);
+
+	LIBPDEBUG("ConfigCacheStore(%s)=%d\n", name, err);
+	return err;
+}
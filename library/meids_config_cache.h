@@ -0,0 +1,23 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_CONFIG_CACHE_H_
+#  define _MEIDS_CONFIG_CACHE_H_
+
+#  include "meids_structs.h"
+
+/**
+ * Binary snapshot of bound configuration (XML + hardware).
+ *
+ * File is valid only for the same XML file (mtime/size or content hash) and the same hardware topology.
+ * Contexts are not stored. Every entry keeps index of hardware entry that it shares context with.
+ *
+ * MEIDS_CONFIG_CACHE	Path of cache file. Empty string or "0" disables cache.	(/tmp/meids_config_<uid>.cache)
+ */
+#  define MEIDS_CONFIG_CACHE_FILE		"/tmp/meids_config_%u.cache"
+
+/// Restore bound config from cache. cfg_Source is hardware's config, that contexts are taken from.
+int  ConfigCacheLoad(const char* xml_file, const me_config_t* cfg_Source, me_config_t* cfg_Dest, int flags);
+/// Save bound config for next start.
+int  ConfigCacheStore(const char* xml_file, const me_config_t* cfg_Source, const me_config_t* cfg_Bound, int flags);
+
+# endif	//_MEIDS_CONFIG_CACHE_H_
+#endif	//__KERNEL__
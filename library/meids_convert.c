@@ -0,0 +1,386 @@
+/* Batch conversion kernels for Meilhaus driver system.
+ * ====================================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <syslog.h>
+
+# if defined(__x86_64__) || defined(__i386__)
+#  define MEIDS_CONVERT_X86
+#  include <immintrin.h>
+# endif
+
+# include "meids_debug.h"
+# include "meids_convert.h"
+
+/// Init of the shared object - kernels selection.
+void __attribute__((constructor)) meids_convert_init(void);
+
+/// Scalar kernels. Always available and used for the tails of vector loops.
+static void IntToDouble_Scalar(const int* in, double* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	int value;
+
+	for (i = 0; i < count; i++)
+	{
+		value = in[i];
+		if (value < 0)
+			value = 0;
+		else if (value > max_data)
+			value = max_data;
+
+		out[i] = value * scale + offset;
+	}
+}
+
+static void IntToFloat_Scalar(const int* in, float* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	int value;
+
+	for (i = 0; i < count; i++)
+	{
+		value = in[i];
+		if (value < 0)
+			value = 0;
+		else if (value > max_data)
+			value = max_data;
+
+		out[i] = (float)(value * scale + offset);
+	}
+}
+
+static inline int PhysicalToDigital_Scalar(double physical, int max_data, double scale, double offset)
+{
+	double value = physical * scale + offset;
+
+	// Negated compare: NaN lands on 0, the same as in vector kernels.
+	if (!(value > 0.0))
+		return 0;
+
+	if (value >= max_data)
+		return max_data;
+
+	return (int)value;
+}
+
+static void DoubleToInt_Scalar(const double* in, int* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		out[i] = PhysicalToDigital_Scalar(in[i], max_data, scale, offset);
+	}
+}
+
+static void FloatToInt_Scalar(const float* in, int* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		out[i] = PhysicalToDigital_Scalar(in[i], max_data, scale, offset);
+	}
+}
+
+static const meids_convert_calls_t Convert_Scalar =
+{
+	IntToDouble_Scalar,
+	IntToFloat_Scalar,
+	DoubleToInt_Scalar,
+	FloatToInt_Scalar,
+	"scalar"
+};
+
+# ifdef MEIDS_CONVERT_X86
+/// SSE2 kernels - 4 samples per iteration.
+__attribute__((target("sse2")))
+static void IntToDouble_SSE2(const int* in, double* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	__m128i data;
+	__m128d lo;
+	__m128d hi;
+	const __m128d vmin = _mm_setzero_pd();
+	const __m128d vmax = _mm_set1_pd(max_data);
+	const __m128d vscale = _mm_set1_pd(scale);
+	const __m128d voffset = _mm_set1_pd(offset);
+
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		data = _mm_loadu_si128((const __m128i*)(in + i));
+		lo = _mm_cvtepi32_pd(data);
+		hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)));
+
+		lo = _mm_min_pd(_mm_max_pd(lo, vmin), vmax);
+		hi = _mm_min_pd(_mm_max_pd(hi, vmin), vmax);
+
+		_mm_storeu_pd(out + i, _mm_add_pd(_mm_mul_pd(lo, vscale), voffset));
+		_mm_storeu_pd(out + i + 2, _mm_add_pd(_mm_mul_pd(hi, vscale), voffset));
+	}
+
+	IntToDouble_Scalar(in + i, out + i, count - i, max_data, scale, offset);
+}
+
+__attribute__((target("sse2")))
+static void IntToFloat_SSE2(const int* in, float* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	__m128i data;
+	__m128d lo;
+	__m128d hi;
+	const __m128d vmin = _mm_setzero_pd();
+	const __m128d vmax = _mm_set1_pd(max_data);
+	const __m128d vscale = _mm_set1_pd(scale);
+	const __m128d voffset = _mm_set1_pd(offset);
+
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		data = _mm_loadu_si128((const __m128i*)(in + i));
+		lo = _mm_cvtepi32_pd(data);
+		hi = _mm_cvtepi32_pd(_mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2)));
+
+		lo = _mm_min_pd(_mm_max_pd(lo, vmin), vmax);
+		hi = _mm_min_pd(_mm_max_pd(hi, vmin), vmax);
+
+		lo = _mm_add_pd(_mm_mul_pd(lo, vscale), voffset);
+		hi = _mm_add_pd(_mm_mul_pd(hi, vscale), voffset);
+
+		_mm_storeu_ps(out + i, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+	}
+
+	IntToFloat_Scalar(in + i, out + i, count - i, max_data, scale, offset);
+}
+
+__attribute__((target("sse2")))
+static void DoubleToInt_SSE2(const double* in, int* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	__m128d lo;
+	__m128d hi;
+	const __m128d vmin = _mm_setzero_pd();
+	const __m128d vmax = _mm_set1_pd(max_data);
+	const __m128d vscale = _mm_set1_pd(scale);
+	const __m128d voffset = _mm_set1_pd(offset);
+
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		lo = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(in + i), vscale), voffset);
+		hi = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(in + i + 2), vscale), voffset);
+
+		lo = _mm_min_pd(_mm_max_pd(lo, vmin), vmax);
+		hi = _mm_min_pd(_mm_max_pd(hi, vmin), vmax);
+
+		_mm_storeu_si128((__m128i*)(out + i), _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi)));
+	}
+
+	DoubleToInt_Scalar(in + i, out + i, count - i, max_data, scale, offset);
+}
+
+__attribute__((target("sse2")))
+static void FloatToInt_SSE2(const float* in, int* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	__m128 data;
+	__m128d lo;
+	__m128d hi;
+	const __m128d vmin = _mm_setzero_pd();
+	const __m128d vmax = _mm_set1_pd(max_data);
+	const __m128d vscale = _mm_set1_pd(scale);
+	const __m128d voffset = _mm_set1_pd(offset);
+
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		data = _mm_loadu_ps(in + i);
+		lo = _mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(data), vscale), voffset);
+		hi = _mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(data, data)), vscale), voffset);
+
+		lo = _mm_min_pd(_mm_max_pd(lo, vmin), vmax);
+		hi = _mm_min_pd(_mm_max_pd(hi, vmin), vmax);
+
+		_mm_storeu_si128((__m128i*)(out + i), _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi)));
+	}
+
+	FloatToInt_Scalar(in + i, out + i, count - i, max_data, scale, offset);
+}
+
+static const meids_convert_calls_t Convert_SSE2 =
+{
+	IntToDouble_SSE2,
+	IntToFloat_SSE2,
+	DoubleToInt_SSE2,
+	FloatToInt_SSE2,
+	"sse2"
+};
+
+/// AVX2 kernels - 8 samples per iteration.
+__attribute__((target("avx2")))
+static void IntToDouble_AVX2(const int* in, double* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	__m256d lo;
+	__m256d hi;
+	const __m256d vmin = _mm256_setzero_pd();
+	const __m256d vmax = _mm256_set1_pd(max_data);
+	const __m256d vscale = _mm256_set1_pd(scale);
+	const __m256d voffset = _mm256_set1_pd(offset);
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		lo = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(in + i)));
+		hi = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(in + i + 4)));
+
+		lo = _mm256_min_pd(_mm256_max_pd(lo, vmin), vmax);
+		hi = _mm256_min_pd(_mm256_max_pd(hi, vmin), vmax);
+
+		_mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(lo, vscale), voffset));
+		_mm256_storeu_pd(out + i + 4, _mm256_add_pd(_mm256_mul_pd(hi, vscale), voffset));
+	}
+
+	IntToDouble_Scalar(in + i, out + i, count - i, max_data, scale, offset);
+}
+
+__attribute__((target("avx2")))
+static void IntToFloat_AVX2(const int* in, float* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	__m256d lo;
+	__m256d hi;
+	const __m256d vmin = _mm256_setzero_pd();
+	const __m256d vmax = _mm256_set1_pd(max_data);
+	const __m256d vscale = _mm256_set1_pd(scale);
+	const __m256d voffset = _mm256_set1_pd(offset);
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		lo = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(in + i)));
+		hi = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(in + i + 4)));
+
+		lo = _mm256_min_pd(_mm256_max_pd(lo, vmin), vmax);
+		hi = _mm256_min_pd(_mm256_max_pd(hi, vmin), vmax);
+
+		lo = _mm256_add_pd(_mm256_mul_pd(lo, vscale), voffset);
+		hi = _mm256_add_pd(_mm256_mul_pd(hi, vscale), voffset);
+
+		_mm256_storeu_ps(out + i, _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1));
+	}
+
+	IntToFloat_Scalar(in + i, out + i, count - i, max_data, scale, offset);
+}
+
+__attribute__((target("avx2")))
+static void DoubleToInt_AVX2(const double* in, int* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	__m256d lo;
+	__m256d hi;
+	const __m256d vmin = _mm256_setzero_pd();
+	const __m256d vmax = _mm256_set1_pd(max_data);
+	const __m256d vscale = _mm256_set1_pd(scale);
+	const __m256d voffset = _mm256_set1_pd(offset);
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		lo = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(in + i), vscale), voffset);
+		hi = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(in + i + 4), vscale), voffset);
+
+		lo = _mm256_min_pd(_mm256_max_pd(lo, vmin), vmax);
+		hi = _mm256_min_pd(_mm256_max_pd(hi, vmin), vmax);
+
+		_mm_storeu_si128((__m128i*)(out + i), _mm256_cvttpd_epi32(lo));
+		_mm_storeu_si128((__m128i*)(out + i + 4), _mm256_cvttpd_epi32(hi));
+	}
+
+	DoubleToInt_Scalar(in + i, out + i, count - i, max_data, scale, offset);
+}
+
+__attribute__((target("avx2")))
+static void FloatToInt_AVX2(const float* in, int* out, int count, int max_data, double scale, double offset)
+{
+	int i;
+	__m256 data;
+	__m256d lo;
+	__m256d hi;
+	const __m256d vmin = _mm256_setzero_pd();
+	const __m256d vmax = _mm256_set1_pd(max_data);
+	const __m256d vscale = _mm256_set1_pd(scale);
+	const __m256d voffset = _mm256_set1_pd(offset);
+
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		data = _mm256_loadu_ps(in + i);
+		lo = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(data)), vscale), voffset);
+		hi = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(data, 1)), vscale), voffset);
+
+		lo = _mm256_min_pd(_mm256_max_pd(lo, vmin), vmax);
+		hi = _mm256_min_pd(_mm256_max_pd(hi, vmin), vmax);
+
+		_mm_storeu_si128((__m128i*)(out + i), _mm256_cvttpd_epi32(lo));
+		_mm_storeu_si128((__m128i*)(out + i + 4), _mm256_cvttpd_epi32(hi));
+	}
+
+	FloatToInt_Scalar(in + i, out + i, count - i, max_data, scale, offset);
+}
+
+static const meids_convert_calls_t Convert_AVX2 =
+{
+	IntToDouble_AVX2,
+	IntToFloat_AVX2,
+	DoubleToInt_AVX2,
+	FloatToInt_AVX2,
+	"avx2"
+};
+# endif	//MEIDS_CONVERT_X86
+
+/// Scalar kernels are in use until the constructor checks the CPU.
+static const meids_convert_calls_t* Convert_Calls = &Convert_Scalar;
+
+void meids_convert_init(void)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+# ifdef MEIDS_CONVERT_X86
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2"))
+	{
+		Convert_Calls = &Convert_AVX2;
+	}
+	else if (__builtin_cpu_supports("sse2"))
+	{
+		Convert_Calls = &Convert_SSE2;
+	}
+# endif
+
+	LIBPDEBUG("Conversion kernels: %s\n", Convert_Calls->name);
+}
+
+const meids_convert_calls_t* meids_convert_get_calls(void)
+{
+	return Convert_Calls;
+}
@@ -0,0 +1,24 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_CONVERT_H_
+#  define _MEIDS_CONVERT_H_
+
+/// Batch conversion kernels. Linear transformation only: out = in * scale + offset.
+/// Digital -> physical: input is saturated to [0, max_data] before scaling.
+/// Physical -> digital: result is truncated and saturated to [0, max_data].
+typedef struct meids_convert_calls
+{
+	void (*IntToDouble)(const int* in, double* out, int count, int max_data, double scale, double offset);
+	void (*IntToFloat)(const int* in, float* out, int count, int max_data, double scale, double offset);
+	void (*DoubleToInt)(const double* in, int* out, int count, int max_data, double scale, double offset);
+	void (*FloatToInt)(const float* in, int* out, int count, int max_data, double scale, double offset);
+
+	const char* name;
+} meids_convert_calls_t;
+
+/// Kernels selected for this CPU (scalar, SSE2 or AVX2).
+const meids_convert_calls_t* meids_convert_get_calls(void);
+
+# endif	//_MEIDS_CONVERT_H_
+#else
+# error KERNEL???
+#endif	//__KERNEL__
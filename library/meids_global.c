@@ -55,17 +55,10 @@
 /// Standard header file for library.
 # include "medriver.h"
 
-# include "pt_100.h"
-# include "te_type_b.h"
-# include "te_type_e.h"
-# include "te_type_j.h"
-# include "te_type_k.h"
-# include "te_type_n.h"
-# include "te_type_r.h"
-# include "te_type_s.h"
-# include "te_type_t.h"
-
 # include "meids_init.h"
+# include "meids_convert.h"
+# include "meids_linearize.h"
+# include "meids_statistics.h"
 
 /* Hardware context. Default values. */
 #ifndef LIBMEDRIVER_MAX_DEVICES
@@ -78,10 +71,23 @@
 
 static int   doSingle(meIOSingle_t* pSingleList, int iCount, int iFlags);
 
-static double meCalcPT100Temp(double resistance, int iIMeasured);
-static double meCalcTCTemp(double dVoltage, double dTeGain,
-							double* pdTable, unsigned long ulTableSize,
-							double dMinTemp, double dTempOffset);
+static int   doModuleConversion(double dVoltage, int iModuleType, double dRefValue, double* pdPhysical);
+static int   getLinearModuleFactors(int iModuleType, double* pdGain, double* pdOffset);
+static int   checkModuleType(int iModuleType);
+static int   doDigitalToPhysicalV(double dMin, double dMax, int iMaxData,
+								int* piDataBuffer, int iCount,
+								int iModuleType, double dRefValue,
+								double* pdPhysicalBuffer, float* pfPhysicalBuffer);
+static int   doPhysicalToDigitalV(double dMin, double dMax, int iMaxData,
+								double* pdPhysicalBuffer, float* pfPhysicalBuffer, int iCount,
+								int* piDataBuffer);
+static void  doLinearizeV(double dMin, double dMax, int iMaxData,
+								int* piDataBuffer, int iCount,
+								const meids_linearizer_t* pLinearizer, double dScale, double dValueOffset, double dTempOffset,
+								double* pdPhysicalBuffer, float* pfPhysicalBuffer);
+static void  doDeinterleaveValue(meDeinterleave_t* pEntry, int iValue);
+static void  doDeinterleaveFrames(int* piAIBuffer, int iFrames,
+								meDeinterleave_t* pChannelList, int iChannelListCount);
 
 typedef struct globalContext
 {
@@ -149,15 +155,15 @@ int meOpen(int iFlags)
 {
 	addr_list_t* config = NULL;
 	addr_list_t* nconf;
+	char* sim_address;
 	int err;
 	int err_ret = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	pthread_mutex_lock(&open_count_mutex);
 		if (open_count < 0)
@@ -179,14 +185,25 @@ int meOpen(int iFlags)
 				}
 				DestroyInit(&config);
 			}
+
+			// Simulated devices, e.g. MEIDS_SIMULATION="sim:devices=2,waveform=ramp". Works without config file and hardware.
+			sim_address = getenv("MEIDS_SIMULATION");
+			if (sim_address && *sim_address)
+			{
+				err = ME_Open(sim_address, ME_OPEN_NO_FLAGS);
+				if (err)
+				{
+					LIBPERROR("Can not open simulation '%s'.\n", sim_address);
+					err_ret = err;
+				}
+			}
 		}
 		open_count++;
 	pthread_mutex_unlock(&open_count_mutex);
 
 	meErrorProc("meOpen()", err_ret);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err_ret);
 
 	return err_ret;
 }
@@ -195,12 +212,11 @@ int meClose(int iFlags)
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	pthread_mutex_lock(&open_count_mutex);
@@ -225,8 +241,7 @@ int meClose(int iFlags)
 
 	meErrorProc("meClose()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -235,12 +250,11 @@ int meLockDriver(int iLock, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	LIBPDEBUG("iLock=%d iFlags=0x%x", iLock, iFlags);
 
@@ -248,8 +262,7 @@ int meLockDriver(int iLock, int iFlags)
 
 	meErrorProc("meLockDriver()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -258,12 +271,11 @@ int meLockDevice(int iDevice, int iLock, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	LIBPDEBUG("device=%d lock=%d flags=0x%x", iDevice,  iLock , iFlags);
 
@@ -271,8 +283,7 @@ int meLockDevice(int iDevice, int iLock, int iFlags)
 
 	meErrorProc("meLockDevice()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -281,12 +292,11 @@ int meLockSubdevice(int iDevice, int iSubdevice, int iLock, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	LIBPDEBUG("iDevice=%d iSubdevice=%d iLock=%d iFlags=0x%x", iDevice, iSubdevice, iLock, iFlags);
 
@@ -294,8 +304,7 @@ int meLockSubdevice(int iDevice, int iSubdevice, int iLock, int iFlags)
 
 	meErrorProc("meLockSubdevice()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -315,26 +324,28 @@ static int GetErrno(void)
 
 int meErrorGetLast(int* piErrorCode, int iFlags)
 {
+	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	LIBPDEBUG("iErrorCode=%d iFlags=%d", *piErrorCode, iFlags);
 
 	if (iFlags & ~ME_ERRNO_CLEAR_FLAGS)
 	{
-		meErrorProc("meErrorGetLast()", ME_ERRNO_INVALID_FLAGS);
-		return ME_ERRNO_INVALID_FLAGS;
+		err = ME_ERRNO_INVALID_FLAGS;
+		meErrorProc("meErrorGetLast()", err);
+		goto EXIT;
 	}
 
 	if (!piErrorCode)
 	{
-		meErrorProc("meErrorGetLast()", ME_ERRNO_INVALID_POINTER);
-		return ME_ERRNO_INVALID_POINTER;
+		err = ME_ERRNO_INVALID_POINTER;
+		meErrorProc("meErrorGetLast()", err);
+		goto EXIT;
 	}
 
 	*piErrorCode =  GetErrno();
@@ -343,10 +354,10 @@ int meErrorGetLast(int* piErrorCode, int iFlags)
 		meErrno = ME_ERRNO_SUCCESS;
 	}
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
-	return ME_ERRNO_SUCCESS;
+	return err;
 }
 
 int meErrorGetLastMessage(char* pcErrorMsg, int iCount)
@@ -358,25 +369,26 @@ int meErrorGetMessage(int iErrorCode, char* pcErrorMsg, int iCount)
 {
 	int ret = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	LIBPDEBUG("iErrorCode=%d iCount=%d", iErrorCode, iCount);
 
 	if (!pcErrorMsg)
 	{
-		meErrorProc("meErrorGetMessage()", ME_ERRNO_INVALID_POINTER);
-		return ME_ERRNO_INVALID_POINTER;
+		ret = ME_ERRNO_INVALID_POINTER;
+		meErrorProc("meErrorGetMessage()", ret);
+		goto EXIT;
 	}
 
 	if (iCount <= 0)
 	{
-		meErrorProc("meErrorGetMessage()", ME_ERRNO_INVALID_ERROR_MSG_COUNT);
-		return ME_ERRNO_INVALID_ERROR_MSG_COUNT;
+		ret = ME_ERRNO_INVALID_ERROR_MSG_COUNT;
+		meErrorProc("meErrorGetMessage()", ret);
+		goto EXIT;
 	}
 
 
@@ -403,8 +415,8 @@ int meErrorGetMessage(int iErrorCode, char* pcErrorMsg, int iCount)
 	// This is pure paranoia, but to be sure...
 	pcErrorMsg[iCount - 1] = '\0';
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, ret);
 
 	return ret;
 }
@@ -413,12 +425,11 @@ int meErrorSetDefaultProc(int iSwitch)
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	LIBPDEBUG("iSwitch=%d", iSwitch);
 
@@ -436,38 +447,34 @@ int meErrorSetDefaultProc(int iSwitch)
 		err = ME_ERRNO_INVALID_SWITCH;
 	}
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
 
 int meErrorSetUserProc(meErrorCB_t pErrorProc)
 {
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	meErrorUserProc = pErrorProc;
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, ME_ERRNO_SUCCESS);
 
 	return ME_ERRNO_SUCCESS;
 }
 
 void meErrorDefaultProc(char* pcFunction, int iErrorCode)
 {
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	char msg[ME_ERROR_MSG_MAX_COUNT] = {0};
@@ -476,8 +483,7 @@ void meErrorDefaultProc(char* pcFunction, int iErrorCode)
 
 	LIBPDEBUG("Error (%d) in function %s: %s \n", iErrorCode, pcFunction, msg);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, ME_ERRNO_SUCCESS);
 }
 
 ///Functions to perform I/O on a device
@@ -486,20 +492,18 @@ int meIOIrqStart(int iDevice, int iSubdevice, int iChannel, int iIrqSource, int
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_IrqStart(iDevice, iSubdevice, iChannel, iIrqSource, iIrqEdge, iIrqArg, iFlags);
 
 	meErrorProc("meIOIrqStart()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -508,20 +512,18 @@ int meIOIrqStop(int iDevice, int iSubdevice, int iChannel, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_IrqStop(iDevice, iSubdevice, iChannel, iFlags);
 
 	meErrorProc("meIOIrqStop()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -535,12 +537,11 @@ int meIOIrqWait(int iDevice, int iSubdevice, int iChannel, int* piIrqCount, int*
 	int IrqCount_local = 0;
 	int Value_local = 0;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	piIrqCount_local = (piIrqCount) ? piIrqCount: &IrqCount_local;
@@ -559,8 +560,7 @@ int meIOIrqWait(int iDevice, int iSubdevice, int iChannel, int* piIrqCount, int*
 
 	meErrorProc("meIOIrqWait()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -569,20 +569,18 @@ int meIOIrqSetCallback(int iDevice, int iSubdevice, meIOIrqCB_t pIrqCB, void* pC
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_IrqSetCallback(iDevice, iSubdevice, pIrqCB, pContext, iFlags);
 
 	meErrorProc("meIOIrqSetCallback()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -592,20 +590,18 @@ int meIOResetDevice(int iDevice, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_ResetDevice(iDevice, iFlags);
 
 	meErrorProc("meIOResetDevice()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -614,20 +610,18 @@ int meIOResetSubdevice(int iDevice, int iSubdevice, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_ResetSubdevice(iDevice, iSubdevice, iFlags);
 
 	meErrorProc("meIOResetSubdevice()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -636,19 +630,19 @@ static int doSingle(meIOSingle_t* pSingleList, int iCount, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	LIBPDEBUG("pSingleList=%p iCount=%d iFlags=0x%x", pSingleList, iCount, iFlags);
 
 	if (iCount <= 0)
 	{
 		LIBPDEBUG("No items in list.");
-		return ME_ERRNO_INVALID_SINGLE_LIST;
+		err = ME_ERRNO_INVALID_SINGLE_LIST;
+		goto EXIT;
 	}
 
 	if (iCount == 1)
@@ -656,7 +650,8 @@ static int doSingle(meIOSingle_t* pSingleList, int iCount, int iFlags)
 		if (iFlags)
 		{
 			LIBPDEBUG("Invalid flags specified.");
-			return ME_ERRNO_INVALID_FLAGS;
+			err = ME_ERRNO_INVALID_FLAGS;
+			goto EXIT;
 		}
 
 		err = ME_Single(pSingleList[0].iDevice, pSingleList[0].iSubdevice, pSingleList[0].iChannel,
@@ -667,8 +662,8 @@ static int doSingle(meIOSingle_t* pSingleList, int iCount, int iFlags)
 		err = ME_SingleList(pSingleList, iCount, iFlags);
 	}
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, ((pSingleList && (iCount > 0)) ? pSingleList[0].iDevice : ME_STAT_NO_DEVICE), err);
 
 	return err;
 }
@@ -677,23 +672,25 @@ int meIOSingle(meIOSingle_t* pSingleList, int iCount, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if (!pSingleList)
-		return ME_ERRNO_INVALID_POINTER;
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto EXIT;
+	}
 
 	err = doSingle(pSingleList, iCount, iFlags);
 
 	meErrorProc("meIOSingle()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, ((pSingleList && (iCount > 0)) ? pSingleList[0].iDevice : ME_STAT_NO_DEVICE), err);
 
 	return err;
 }
@@ -702,20 +699,18 @@ int meIOSingleConfig(int iDevice, int iSubdevice, int iChannel, int iSingleConfi
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_SingleConfig(iDevice, iSubdevice, iChannel, iSingleConfig, iRef, iTrigChan, iTrigType, iTrigEdge, iFlags);
 
 	meErrorProc("meIOSingleConfig()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -724,20 +719,18 @@ int meIOStreamConfig(int iDevice, int iSubdevice, meIOStreamConfig_t* pConfigLis
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamConfig(iDevice, iSubdevice, pConfigList, iCount, pTrigger, iFifoIrqThreshold, iFlags);
 
 	meErrorProc("meIOStreamConfig()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -746,20 +739,18 @@ int meIOStreamNewValues(int iDevice, int iSubdevice, int iTimeOut, int* piCount,
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamNewValues(iDevice, iSubdevice, iTimeOut, piCount, iFlags);
 
 	meErrorProc("meIOStreamConfig()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -768,20 +759,18 @@ int meIOStreamRead(int iDevice, int iSubdevice, int iReadMode, int* piValues, in
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamRead(iDevice, iSubdevice, iReadMode, piValues, piCount, 0, iFlags);
 
 	meErrorProc("meIOStreamRead()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -790,20 +779,18 @@ int meIOStreamWrite(int iDevice, int iSubdevice, int iWriteMode, int* piValues,
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamWrite(iDevice, iSubdevice, iWriteMode, piValues, piCount, 0, iFlags);
 
 	meErrorProc("meIOStreamWrite()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -816,12 +803,11 @@ int meIOStreamSetCallbacks(int iDevice, int iSubdevice,
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamSetCallbacks(iDevice, iSubdevice,
@@ -832,8 +818,7 @@ int meIOStreamSetCallbacks(int iDevice, int iSubdevice,
 
 	meErrorProc("meIOStreamSetCallbacks()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -842,20 +827,18 @@ int meIOStreamStart(meIOStreamStart_t* pStartList, int iCount, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamStartList(pStartList, iCount, iFlags);
 
 	meErrorProc("meIOStreamStart()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ((pStartList && (iCount > 0)) ? pStartList[0].iDevice : ME_STAT_NO_DEVICE), err);
 
 	return err;
 }
@@ -866,15 +849,15 @@ int meIOStreamStatus(int iDevice, int iSubdevice, int iWait, int* piStatus, int*
 
 	int* piStatus_local;
 	int* piCount_local;
-	int Status_local;
-	int Count_local;
+	// In batch mode outputs are written by meBatchCommit(). Must outlive this call.
+	static __thread int Status_local;
+	static __thread int Count_local;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	piStatus_local = (piStatus) ? piStatus : &Status_local;
@@ -884,8 +867,32 @@ int meIOStreamStatus(int iDevice, int iSubdevice, int iWait, int* piStatus, int*
 
 	meErrorProc("meIOStreamStatus()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
+
+	return err;
+}
+
+int meIOStreamReader(int iDevice, int iSubdevice, int iMode, int iPolicy, int* piDropped, int iFlags)
+{
+	int err;
+
+	int* piDropped_local;
+	int Dropped_local;
+
+	uint64_t stat_start;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	stat_start = ME_STAT_BEGIN();
+
+
+	piDropped_local = (piDropped) ? piDropped : &Dropped_local;
+
+	err = ME_StreamReader(iDevice, iSubdevice, iMode, iPolicy, piDropped_local, iFlags);
+
+	meErrorProc("meIOStreamReader()", err);
+
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -894,20 +901,18 @@ int meIOStreamStop(meIOStreamStop_t* pStopList, int iCount, int iFlags)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamStopList(pStopList, iCount, iFlags);
 
 	meErrorProc("meIOStreamStop()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ((pStopList && (iCount > 0)) ? pStopList[0].iDevice : ME_STAT_NO_DEVICE), err);
 
 	return err;
 }
@@ -916,20 +921,18 @@ int meIOStreamTimeToTicks(int iDevice, int iSubdevice, int iTimer, double* pdTim
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamTimeToTicks(iDevice, iSubdevice, iTimer, pdTime, piTicksLow, piTicksHigh, iFlags);
 
 	meErrorProc("meIOStreamTimeToTicks()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -945,20 +948,18 @@ int meIOSingleTimeToTicks(
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamTimeToTicks(iDevice, iSubdevice, iTimer, pdTime, piTicksLow, piTicksHigh, iFlags);
 
 	meErrorProc("meIOSingleTimeToTicks()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -967,20 +968,63 @@ int meIOStreamFrequencyToTicks(int iDevice, int iSubdevice, int iTimer, double*
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_StreamFrequencyToTicks(iDevice, iSubdevice, iTimer, pdFrequency, piTicksLow, piTicksHigh, iFlags);
 
 	meErrorProc("meIOStreamFrequencyToTicks()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
+
+	return err;
+}
+
+int meBatchBegin(int iFlags)
+{
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	err = ME_BatchBegin(iFlags);
+
+	meErrorProc("meBatchBegin()", err);
+
+	return err;
+}
+
+int meBatchCommit(int* piErrorIndex, int iFlags)
+{/// @note On error *piErrorIndex is position (order of recording) of failed call. Calls recorded after it were not executed.
+	int err;
+
+	uint64_t stat_start;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	stat_start = ME_STAT_BEGIN();
+
+	err = ME_BatchCommit(piErrorIndex, iFlags);
+
+	meErrorProc("meBatchCommit()", err);
+
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
+
+	return err;
+}
+
+int meBatchAbort(int iFlags)
+{
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	err = ME_BatchAbort(iFlags);
+
+	meErrorProc("meBatchAbort()", err);
 
 	return err;
 }
@@ -1002,12 +1046,11 @@ int meIOSingleTicksToTime(
 	long long unsigned int single_second_ticks;
 	long long unsigned int ticks;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	*pdTime =  0.0;
 	if (!(iTicksLow < 0 || iTicksLow < 0))
@@ -1026,8 +1069,7 @@ int meIOSingleTicksToTime(
 
 	meErrorProc("meIOSingleTicksToTime()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1037,20 +1079,18 @@ int meIOSetChannelOffset(int iDevice, int iSubdevice, int iChannel, int iRange,
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_SetOffset(iDevice, iSubdevice, iChannel, iRange, pdOffset, iFlags);
 
 	meErrorProc("meIOSetChannelOffset()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1061,18 +1101,16 @@ int meQueryVersionLibrary(int* piVersion)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryLibraryVersion(piVersion, ME_QUERY_NO_FLAGS);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -1082,20 +1120,18 @@ int meQueryDescriptionDevice(int iDevice, char* pcDescription, int iCount)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryDeviceDescription(iDevice, pcDescription, iCount, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryDescriptionDevice()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1104,12 +1140,11 @@ int meQueryNameDevice(int iDevice, char* pcName, int iCount)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	LIBPINFO("ID:%d\n", iDevice);
 
@@ -1117,8 +1152,7 @@ int meQueryNameDevice(int iDevice, char* pcName, int iCount)
 
 	meErrorProc("meQueryNameDevice()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1127,20 +1161,18 @@ int meQueryNameDeviceDriver(int iDevice, char* pcName, int iCount)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QuerySubdriverName(iDevice, pcName, iCount, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryNameDeviceDriver()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1152,12 +1184,11 @@ int meQueryInfoDevice(int iDevice,
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryDeviceInfo(iDevice,
@@ -1168,8 +1199,7 @@ int meQueryInfoDevice(int iDevice,
 
 	meErrorProc("meQueryInfoDevice()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1178,20 +1208,18 @@ int meQueryVersionDeviceDriver(int iDevice, int* piVersion)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QuerySubdriverVersion(iDevice, piVersion, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryVersionDeviceDriver()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1200,20 +1228,18 @@ int meQueryVersionMainDriver(int* piVersion)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryDriverVersion(0, piVersion, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryVersionMainDriver()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -1222,12 +1248,11 @@ int meQueryNumberDevices(int* piNumber)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryDevicesNumber(piNumber, ME_QUERY_NO_FLAGS);
@@ -1235,8 +1260,7 @@ int meQueryNumberDevices(int* piNumber)
 
 	meErrorProc("meQueryNumberDevices()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -1245,20 +1269,18 @@ int meQueryNumberSubdevices(int iDevice, int* piNumber)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QuerySubdevicesNumber(iDevice, piNumber, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryNumberSubdevices()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1267,20 +1289,18 @@ int meQueryNumberChannels(int iDevice, int iSubdevice, int* piNumber)
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryChannelsNumber(iDevice, iSubdevice, (unsigned int *)piNumber, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryNumberChannels()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1289,20 +1309,18 @@ int meQueryNumberRanges(int iDevice, int iSubdevice, int iUnit, int* piNumber)
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryRangesNumber(iDevice, iSubdevice, iUnit, piNumber, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryNumberRanges()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1311,20 +1329,18 @@ int meQueryRangeByMinMax(int iDevice, int iSubdevice, int iUnit, double* pdMin,
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryRangeByMinMax(iDevice, iSubdevice, iUnit, pdMin, pdMax, piMaxData, piRange, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryRangeByMinMax()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1333,20 +1349,18 @@ int meQueryRangeInfo(int iDevice, int iSubdevice, int iRange, int* piUnit, doubl
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QueryRangeInfo(iDevice, iSubdevice, iRange, piUnit, pdMin, pdMax, (unsigned int *)piMaxData, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQueryRangeInfo()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1355,20 +1369,18 @@ int meQuerySubdeviceByType(int iDevice, int iStartSubdevice, int iType, int iSub
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QuerySubdeviceByType(iDevice, (iStartSubdevice < 0) ? 0 : iStartSubdevice, iType, iSubtype, piSubdevice, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQuerySubdeviceByType()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1377,20 +1389,18 @@ int meQuerySubdeviceType(int iDevice, int iSubdevice, int* piType, int* piSubtyp
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QuerySubdeviceType(iDevice, iSubdevice, piType, piSubtype, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQuerySubdeviceType()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1399,20 +1409,18 @@ int meQuerySubdeviceCaps(int iDevice, int iSubdevice, int* piCaps)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QuerySubdeviceCaps(iDevice, iSubdevice, piCaps, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQuerySubdeviceCaps()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
 
 	return err;
 }
@@ -1421,20 +1429,101 @@ int meQuerySubdeviceCapsArgs(int iDevice, int iSubdevice, int iCap, int* piArgs,
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_QuerySubdeviceCapsArgs(iDevice, iSubdevice, iCap, piArgs, iCount, ME_QUERY_NO_FLAGS);
 
 	meErrorProc("meQuerySubdeviceCapsArgs()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, iDevice, err);
+
+	return err;
+}
+
+int meQueryLatencyProbe(int iDevice, int iSubdevice, meLatencyProbe_t* pProbe, int iFlags)
+{
+	int err;
+
+	uint64_t stat_start;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	stat_start = ME_STAT_BEGIN();
+
+
+	err = ME_QueryLatencyProbe(iDevice, iSubdevice, pProbe, iFlags);
+
+	meErrorProc("meQueryLatencyProbe()", err);
+
+	ME_STAT_END(stat_start, iDevice, err);
+
+	return err;
+}
+
+int meQueryStatistics(meStatistics_t* pStatistics, int* piCount, int iFlags)
+{/// @note pStatistics == NULL: only number of available entries is returned in *piCount.
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (!piCount)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
+	}
+
+	if (iFlags & ~ME_QUERY_STATISTICS_RESET)
+	{
+		err = ME_ERRNO_INVALID_FLAGS;
+		goto ERROR;
+	}
+
+	if (pStatistics && (*piCount < 0))
+	{
+		err = ME_ERRNO_INVALID_VALUE_COUNT;
+		goto ERROR;
+	}
+
+	err = meids_statistics_query(pStatistics, piCount, iFlags);
+
+ERROR:
+	meErrorProc("meQueryStatistics()", err);
+
+	return err;
+}
+
+int meStatisticsEnable(int iSwitch, int iFlags)
+{
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	LIBPDEBUG("iSwitch=%d", iSwitch);
+
+	if (iFlags)
+	{
+		err = ME_ERRNO_INVALID_FLAGS;
+	}
+	else if (iSwitch == ME_SWITCH_ENABLE)
+	{
+		meids_statistics_enabled = 1;
+	}
+	else if (iSwitch == ME_SWITCH_DISABLE)
+	{
+		meids_statistics_enabled = 0;
+	}
+	else
+	{
+		LIBPWARNING("ME_ERRNO_INVALID_SWITCH");
+		err = ME_ERRNO_INVALID_SWITCH;
+	}
+
+	meErrorProc("meStatisticsEnable()", err);
 
 	return err;
 }
@@ -1450,19 +1539,20 @@ int meUtilityExtractValues(	int iChannel,
 	int i = 0;
 	int j = 0;
 	int k = 0;
+	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if (!piAIBuffer || !piChanBufferCount || !piChanBuffer)
 	{
-		meErrorProc("meUtilityExtractValues()", ME_ERRNO_INVALID_POINTER);
-		return ME_ERRNO_INVALID_POINTER;
+		err = ME_ERRNO_INVALID_POINTER;
+		meErrorProc("meUtilityExtractValues()", err);
+		goto EXIT;
 	}
 
 	while (iConfigListCount > 0)
@@ -1472,7 +1562,7 @@ int meUtilityExtractValues(	int iChannel,
 			if ((k >= *piChanBufferCount) || (i * iConfigListCount + j >= iAIBufferCount))
 			{
 				*piChanBufferCount = k;
-				return ME_ERRNO_SUCCESS;
+				goto EXIT;
 			}
 
 			if (pConfigList[j].iChannel == iChannel)
@@ -1491,42 +1581,256 @@ int meUtilityExtractValues(	int iChannel,
 
 	*piChanBufferCount = 0;
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
-	return ME_ERRNO_SUCCESS;
+	return err;
+}
+
+int meUtilityDeinterleave(	int* piAIBuffer, int* piAIBufferCount,
+							meDeinterleave_t* pChannelList, int iChannelListCount,
+							int* piFramePosition, int iFlags)
+{/// @note Output counters (iCount) are set to number of values written. Values that do not fit into outputs are left in input (*piAIBufferCount returns number of consumed values).
+ /// @note Whole channel list is checked first. On error outputs (iCount included) are not touched.
+	int err = ME_ERRNO_SUCCESS;
+	int iCapacity[iChannelListCount > 0 ? iChannelListCount : 1];
+	int iPosition;
+	int iConsumed = 0;
+	int iFrames;
+	int iFree;
+	int i;
+
+	uint64_t stat_start;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	stat_start = ME_STAT_BEGIN();
+
+
+	if (!piAIBuffer || !piAIBufferCount || !pChannelList || !piFramePosition)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
+	}
+
+	if (iFlags)
+	{
+		err = ME_ERRNO_INVALID_FLAGS;
+		goto ERROR;
+	}
+
+	if (iChannelListCount <= 0)
+	{
+		err = ME_ERRNO_INVALID_CONFIG_LIST_COUNT;
+		goto ERROR;
+	}
+
+	iPosition = *piFramePosition;
+	if ((iPosition < 0) || (iPosition >= iChannelListCount))
+	{
+		err = ME_ERRNO_VALUE_OUT_OF_RANGE;
+		goto ERROR;
+	}
+
+	for (i = 0; i < iChannelListCount; i++)
+	{
+		if (pChannelList[i].iFlags != ME_DEINTERLEAVE_NO_FLAGS)
+		{
+			err = ME_ERRNO_INVALID_FLAGS;
+			goto ERROR;
+		}
+
+		if (!pChannelList[i].pvBuffer)
+			continue;
+
+		if (pChannelList[i].iCount < 0)
+		{
+			err = ME_ERRNO_INVALID_VALUE_COUNT;
+			goto ERROR;
+		}
+
+		switch (pChannelList[i].iFormat)
+		{
+			case ME_DEINTERLEAVE_FORMAT_INT:
+				break;
+
+			case ME_DEINTERLEAVE_FORMAT_DOUBLE:
+			case ME_DEINTERLEAVE_FORMAT_FLOAT:
+				if (pChannelList[i].iMaxData <= 0)
+				{
+					err = ME_ERRNO_INVALID_MIN_MAX;
+					goto ERROR;
+				}
+				break;
+
+			default:
+				err = ME_ERRNO_INVALID_FLAGS;
+				goto ERROR;
+		}
+	}
+
+	for (i = 0; i < iChannelListCount; i++)
+	{
+		iCapacity[i] = pChannelList[i].iCount;
+		pChannelList[i].iCount = 0;
+	}
+
+	// Rest of frame started in previous call.
+	while (iPosition && (iConsumed < *piAIBufferCount))
+	{
+		if (pChannelList[iPosition].pvBuffer && (pChannelList[iPosition].iCount >= iCapacity[iPosition]))
+			goto EXIT;
+
+		doDeinterleaveValue(&pChannelList[iPosition], piAIBuffer[iConsumed]);
+		iConsumed++;
+		iPosition = (iPosition + 1) % iChannelListCount;
+	}
+
+	// Full frames in one pass.
+	iFrames = (*piAIBufferCount - iConsumed) / iChannelListCount;
+	for (i = 0; i < iChannelListCount; i++)
+	{
+		if (pChannelList[i].pvBuffer)
+		{
+			iFree = iCapacity[i] - pChannelList[i].iCount;
+			if (iFrames > iFree)
+				iFrames = iFree;
+		}
+	}
+
+	if (iFrames > 0)
+	{
+		doDeinterleaveFrames(piAIBuffer + iConsumed, iFrames, pChannelList, iChannelListCount);
+		iConsumed += iFrames * iChannelListCount;
+	}
+
+	// Beginning of frame that will be continued in next call.
+	while (iConsumed < *piAIBufferCount)
+	{
+		if (pChannelList[iPosition].pvBuffer && (pChannelList[iPosition].iCount >= iCapacity[iPosition]))
+			goto EXIT;
+
+		doDeinterleaveValue(&pChannelList[iPosition], piAIBuffer[iConsumed]);
+		iConsumed++;
+		iPosition = (iPosition + 1) % iChannelListCount;
+	}
+
+EXIT:
+	*piAIBufferCount = iConsumed;
+	*piFramePosition = iPosition;
+
+ERROR:
+	meErrorProc("meUtilityDeinterleave()", err);
+
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
+
+	return err;
+}
+
+static void doDeinterleaveValue(meDeinterleave_t* pEntry, int iValue)
+{/// @note Single value. Scaling is the same as in vector kernels: saturate to [0, iMaxData], then scale.
+	double dValue;
+
+	if (!pEntry->pvBuffer)
+		return;
+
+	if (pEntry->iFormat == ME_DEINTERLEAVE_FORMAT_INT)
+	{
+		((int *)pEntry->pvBuffer)[pEntry->iCount++] = iValue;
+		return;
+	}
+
+	if (iValue < 0)
+		iValue = 0;
+	else if (iValue > pEntry->iMaxData)
+		iValue = pEntry->iMaxData;
+
+	dValue = iValue * ((pEntry->dMax - pEntry->dMin) / pEntry->iMaxData) + pEntry->dMin;
+
+	if (pEntry->iFormat == ME_DEINTERLEAVE_FORMAT_DOUBLE)
+		((double *)pEntry->pvBuffer)[pEntry->iCount++] = dValue;
+	else
+		((float *)pEntry->pvBuffer)[pEntry->iCount++] = dValue;
+}
+
+# define ME_DEINTERLEAVE_BLOCK	256
+
+static void doDeinterleaveFrames(int* piAIBuffer, int iFrames,
+								meDeinterleave_t* pChannelList, int iChannelListCount)
+{/// @note Input is processed in blocks of frames. Block stays in cache while all channels are gathered from it.
+	const meids_convert_calls_t* calls = meids_convert_get_calls();
+	int iValues[ME_DEINTERLEAVE_BLOCK];
+	meDeinterleave_t* pEntry;
+	int* piSource;
+	int* piTarget;
+	int iBlock;
+	int iFrame;
+	int i;
+	int j;
+
+	for (iFrame = 0; iFrame < iFrames; iFrame += iBlock)
+	{
+		iBlock = ((iFrames - iFrame) > ME_DEINTERLEAVE_BLOCK) ? ME_DEINTERLEAVE_BLOCK : (iFrames - iFrame);
+
+		for (i = 0; i < iChannelListCount; i++)
+		{
+			pEntry = &pChannelList[i];
+			if (!pEntry->pvBuffer)
+				continue;
+
+			piSource = piAIBuffer + iFrame * iChannelListCount + i;
+			piTarget = (pEntry->iFormat == ME_DEINTERLEAVE_FORMAT_INT) ? ((int *)pEntry->pvBuffer + pEntry->iCount) : iValues;
+
+			for (j = 0; j < iBlock; j++)
+			{
+				piTarget[j] = piSource[j * iChannelListCount];
+			}
+
+			if (pEntry->iFormat == ME_DEINTERLEAVE_FORMAT_DOUBLE)
+			{
+				calls->IntToDouble(iValues, (double *)pEntry->pvBuffer + pEntry->iCount, iBlock, pEntry->iMaxData,
+									(pEntry->dMax - pEntry->dMin) / pEntry->iMaxData, pEntry->dMin);
+			}
+			else if (pEntry->iFormat == ME_DEINTERLEAVE_FORMAT_FLOAT)
+			{
+				calls->IntToFloat(iValues, (float *)pEntry->pvBuffer + pEntry->iCount, iBlock, pEntry->iMaxData,
+									(pEntry->dMax - pEntry->dMin) / pEntry->iMaxData, pEntry->dMin);
+			}
+
+			pEntry->iCount += iBlock;
+		}
+	}
 }
 
 int meUtilityPhysicalToDigital(double dMin, double dMax, int iMaxData, double dPhysical, int* piData)
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if (!piData)
 	{
 		err = ME_ERRNO_INVALID_POINTER;
 		meErrorProc("meUtilityPhysicalToDigital()", err);
-		return err;
+		goto EXIT;
 	}
 
 	if (iMaxData < 0)
 	{
 		err = ME_ERRNO_INVALID_MIN_MAX;
 		meErrorProc("meUtilityPhysicalToDigital()", err);
-		return err;
+		goto EXIT;
 	}
 
 	if (iMaxData == 0)
 	{
 		*piData = 0;
-		return err;
+		goto EXIT;
 	}
 
 
@@ -1549,8 +1853,8 @@ int meUtilityPhysicalToDigital(double dMin, double dMax, int iMaxData, double dP
 
 	meErrorProc("meUtilityPhysicalToDigital()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -1558,19 +1862,20 @@ int meUtilityPhysicalToDigital(double dMin, double dMax, int iMaxData, double dP
 int meUtilityDigitalToPhysical(double dMin, double dMax, int iMaxData, int iData, int iModuleType, double dRefValue, double* pdPhysical)
 {
 	int err = ME_ERRNO_SUCCESS;
-	double dResistance;
 	double dVoltage;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if (!pdPhysical)
-		return ME_ERRNO_INVALID_POINTER;
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto EXIT;
+	}
 
 	if (iMaxData <= 0)
 	{
@@ -1597,167 +1902,278 @@ int meUtilityDigitalToPhysical(double dMin, double dMax, int iMaxData, int iData
 		dVoltage /= iMaxData;
 		dVoltage += dMin;
 
-		if (dRefValue == 0)
-		{
-			switch (iModuleType)
-			{
-				case ME_MODULE_TYPE_MULTISIG_RTD8_PT100:
-				case ME_MODULE_TYPE_MULTISIG_RTD8_PT500:
-				case ME_MODULE_TYPE_MULTISIG_RTD8_PT1000:
-					dRefValue = 0.0005;
-			}
-		}
+		err = doModuleConversion(dVoltage, iModuleType, dRefValue, pdPhysical);
+
+		meErrorProc("meUtilityDigitalToPhysical()", err);
+	}
+
+EXIT:
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
+
+	return err;
+}
+
+static int doModuleConversion(double dVoltage, int iModuleType, double dRefValue, double* pdPhysical)
+{
+	int err = ME_ERRNO_SUCCESS;
+	const meids_linearizer_t* pLinearizer;
+	double dResistance;
 
+	if (dRefValue == 0)
+	{
 		switch (iModuleType)
 		{
+			case ME_MODULE_TYPE_MULTISIG_RTD8_PT100:
+			case ME_MODULE_TYPE_MULTISIG_RTD8_PT500:
+			case ME_MODULE_TYPE_MULTISIG_RTD8_PT1000:
+				dRefValue = 0.0005;
+		}
+	}
 
-			case ME_MODULE_TYPE_MULTISIG_NONE:
+	switch (iModuleType)
+	{
 
-			case ME_MODULE_TYPE_MULTISIG_DIFF16_10V:
-				*pdPhysical = dVoltage;
+		case ME_MODULE_TYPE_MULTISIG_NONE:
 
-				break;
+		case ME_MODULE_TYPE_MULTISIG_DIFF16_10V:
+			*pdPhysical = dVoltage;
 
-			case ME_MODULE_TYPE_MULTISIG_DIFF16_20V:
-				*pdPhysical = dVoltage * 2;
+			break;
 
-				break;
+		case ME_MODULE_TYPE_MULTISIG_DIFF16_20V:
+			*pdPhysical = dVoltage * 2;
 
-			case ME_MODULE_TYPE_MULTISIG_DIFF16_50V:
-				*pdPhysical = dVoltage * 5;
+			break;
 
-				break;
+		case ME_MODULE_TYPE_MULTISIG_DIFF16_50V:
+			*pdPhysical = dVoltage * 5;
 
-			case ME_MODULE_TYPE_MULTISIG_CURRENT16_0_20MA:
-				*pdPhysical = 20E-3 / 10 * dVoltage;
+			break;
 
-				break;
+		case ME_MODULE_TYPE_MULTISIG_CURRENT16_0_20MA:
+			*pdPhysical = 20E-3 / 10 * dVoltage;
 
-			case ME_MODULE_TYPE_MULTISIG_RTD8_PT100:
-				dResistance = dVoltage / 40 / dRefValue;
+			break;
 
-				*pdPhysical = meCalcPT100Temp(dResistance, dRefValue);
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT100:
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT500:
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT1000:
+			pLinearizer = meids_linearizer_get(iModuleType);
+			dResistance = dVoltage / pLinearizer->gain / dRefValue;
 
-				break;
+			*pdPhysical = meids_linearize(pLinearizer, dResistance);
 
-			case ME_MODULE_TYPE_MULTISIG_RTD8_PT500:
-				dResistance = dVoltage / 8 / dRefValue;
+			break;
 
-				*pdPhysical = meCalcPT100Temp(dResistance, dRefValue);
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_B:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_E:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_J:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_K:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_N:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_R:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_S:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_T:
+			pLinearizer = meids_linearizer_get(iModuleType);
 
-				break;
+			// The table holds the voltage in uV. dRefValue is added to result.
+			*pdPhysical = meids_linearize(pLinearizer, dVoltage / pLinearizer->gain * 1E6) + dRefValue;
 
-			case ME_MODULE_TYPE_MULTISIG_RTD8_PT1000:
-				dResistance = dVoltage / 4 / dRefValue;
+			break;
 
-				*pdPhysical = meCalcPT100Temp(dResistance, dRefValue);
+		case ME_MODULE_TYPE_MULTISIG_TE8_TEMP_SENSOR:
+			*pdPhysical = (dVoltage / 4 - 500E-3) / 10E-3;
 
-				break;
+			break;
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_B:
-				*pdPhysical = meCalcTCTemp(
-								dVoltage,
-								ME_TE_TYPE_B_GAIN,
-								te_type_b,
-								sizeof(te_type_b) / sizeof(double),
-								ME_TE_TYPE_B_MIN_TEMP,
-								dRefValue);
+		default:
+			err = ME_ERRNO_INVALID_MODULE_TYPE;
+	}
 
-				break;
+	return err;
+}
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_E:
-				*pdPhysical = meCalcTCTemp(
-								dVoltage,
-								ME_TE_TYPE_E_GAIN,
-								te_type_e,
-								sizeof(te_type_e) / sizeof(double),
-								ME_TE_TYPE_E_MIN_TEMP,
-								dRefValue);
+static int getLinearModuleFactors(int iModuleType, double* pdGain, double* pdOffset)
+{/// @note Returns 1 when module's characteristic is linear: physical = voltage * gain + offset.
+	*pdGain = 1.0;
+	*pdOffset = 0.0;
 
-				break;
+	switch (iModuleType)
+	{
+		case ME_MODULE_TYPE_MULTISIG_NONE:
+		case ME_MODULE_TYPE_MULTISIG_DIFF16_10V:
+			return 1;
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_J:
-				*pdPhysical = meCalcTCTemp(
-								dVoltage,
-								ME_TE_TYPE_J_GAIN,
-								te_type_j,
-								sizeof(te_type_j) / sizeof(double),
-								ME_TE_TYPE_J_MIN_TEMP,
-								dRefValue);
+		case ME_MODULE_TYPE_MULTISIG_DIFF16_20V:
+			*pdGain = 2;
+			return 1;
 
-				break;
+		case ME_MODULE_TYPE_MULTISIG_DIFF16_50V:
+			*pdGain = 5;
+			return 1;
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_K:
-				*pdPhysical = meCalcTCTemp(
-								dVoltage,
-								ME_TE_TYPE_K_GAIN,
-								te_type_k,
-								sizeof(te_type_k) / sizeof(double),
-								ME_TE_TYPE_K_MIN_TEMP,
-								dRefValue);
+		case ME_MODULE_TYPE_MULTISIG_CURRENT16_0_20MA:
+			*pdGain = 20E-3 / 10;
+			return 1;
 
-				break;
+		case ME_MODULE_TYPE_MULTISIG_TE8_TEMP_SENSOR:
+			*pdGain = 1 / 4.0 / 10E-3;
+			*pdOffset = -500E-3 / 10E-3;
+			return 1;
+	}
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_N:
-				*pdPhysical = meCalcTCTemp(
-								dVoltage,
-								ME_TE_TYPE_N_GAIN,
-								te_type_n,
-								sizeof(te_type_n) / sizeof(double),
-								ME_TE_TYPE_N_MIN_TEMP,
-								dRefValue);
+	return 0;
+}
 
-				break;
+static int doDigitalToPhysicalV(double dMin, double dMax, int iMaxData,
+								int* piDataBuffer, int iCount,
+								int iModuleType, double dRefValue,
+								double* pdPhysicalBuffer, float* pfPhysicalBuffer)
+{/// @note Exactly one of output buffers is used. Values out of range are saturated to range's limits.
+	const meids_convert_calls_t* calls = meids_convert_get_calls();
+	const meids_linearizer_t* pLinearizer;
+	double dGain;
+	double dOffset;
+	double dVoltage;
+	double dPhysical;
+	int iData;
+	int i;
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_R:
-				*pdPhysical = meCalcTCTemp(
-								dVoltage,
-								ME_TE_TYPE_R_GAIN,
-								te_type_r,
-								sizeof(te_type_r) / sizeof(double),
-								ME_TE_TYPE_R_MIN_TEMP,
-								dRefValue);
+	if (iMaxData <= 0)
+	{
+		for (i = 0; i < iCount; i++)
+		{
+			if (pdPhysicalBuffer)
+				pdPhysicalBuffer[i] = 0;
+			else
+				pfPhysicalBuffer[i] = 0;
+		}
+		return ME_ERRNO_INVALID_MIN_MAX;
+	}
 
-				break;
+	if (getLinearModuleFactors(iModuleType, &dGain, &dOffset))
+	{// Linear modules: one multiply-add per sample in vector kernels.
+		dOffset += dMin * dGain;
+		dGain *= (dMax - dMin) / iMaxData;
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_S:
-				*pdPhysical = meCalcTCTemp(
-								dVoltage,
-								ME_TE_TYPE_S_GAIN,
-								te_type_s,
-								sizeof(te_type_s) / sizeof(double),
-								ME_TE_TYPE_S_MIN_TEMP,
-								dRefValue);
+		if (pdPhysicalBuffer)
+			calls->IntToDouble(piDataBuffer, pdPhysicalBuffer, iCount, iMaxData, dGain, dOffset);
+		else
+			calls->IntToFloat(piDataBuffer, pfPhysicalBuffer, iCount, iMaxData, dGain, dOffset);
 
-				break;
+		return ME_ERRNO_SUCCESS;
+	}
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_T:
-				*pdPhysical = meCalcTCTemp(
-								dVoltage,
-								ME_TE_TYPE_T_GAIN,
-								te_type_t,
-								sizeof(te_type_t) / sizeof(double),
-								ME_TE_TYPE_T_MIN_TEMP,
-								dRefValue);
+	pLinearizer = meids_linearizer_get(iModuleType);
+	if (pLinearizer)
+	{
+		if ((iModuleType == ME_MODULE_TYPE_MULTISIG_RTD8_PT100)
+			|| (iModuleType == ME_MODULE_TYPE_MULTISIG_RTD8_PT500)
+			|| (iModuleType == ME_MODULE_TYPE_MULTISIG_RTD8_PT1000))
+		{// RTD: resistance = voltage / gain / current
+			if (dRefValue == 0)
+				dRefValue = 0.0005;
 
-				break;
+			doLinearizeV(dMin, dMax, iMaxData, piDataBuffer, iCount, pLinearizer, 1 / pLinearizer->gain / dRefValue, 0, 0, pdPhysicalBuffer, pfPhysicalBuffer);
+		}
+		else
+		{// Thermocouples: voltage in uV, dRefValue is added to temperature.
+			doLinearizeV(dMin, dMax, iMaxData, piDataBuffer, iCount, pLinearizer, 1E6 / pLinearizer->gain, 0, dRefValue, pdPhysicalBuffer, pfPhysicalBuffer);
+		}
 
-			case ME_MODULE_TYPE_MULTISIG_TE8_TEMP_SENSOR:
-				*pdPhysical = (dVoltage / 4 - 500E-3) / 10E-3;
+		return ME_ERRNO_SUCCESS;
+	}
 
-				break;
+	for (i = 0; i < iCount; i++)
+	{
+		iData = piDataBuffer[i];
+		if (iData < 0)
+			iData = 0;
+		else if (iData > iMaxData)
+			iData = iMaxData;
 
-			default:
-				err = ME_ERRNO_INVALID_MODULE_TYPE;
+		dVoltage = dMax - dMin;
+		dVoltage *= iData;
+		dVoltage /= iMaxData;
+		dVoltage += dMin;
+
+		doModuleConversion(dVoltage, iModuleType, dRefValue, &dPhysical);
+
+		if (pdPhysicalBuffer)
+			pdPhysicalBuffer[i] = dPhysical;
+		else
+			pfPhysicalBuffer[i] = dPhysical;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+# define ME_LINEARIZE_CHUNK	256
+
+static void doLinearizeV(double dMin, double dMax, int iMaxData,
+								int* piDataBuffer, int iCount,
+								const meids_linearizer_t* pLinearizer, double dScale, double dValueOffset, double dTempOffset,
+								double* pdPhysicalBuffer, float* pfPhysicalBuffer)
+{/// @note Sensor's value = voltage * dScale + dValueOffset is computed in vector kernels, then looked up in table.
+	const meids_convert_calls_t* calls = meids_convert_get_calls();
+	double dValues[ME_LINEARIZE_CHUNK];
+	double dGain;
+	double dOffset;
+	int chunk;
+	int i;
+	int j;
+
+	dGain = (dMax - dMin) / iMaxData * dScale;
+	dOffset = dMin * dScale + dValueOffset;
+
+	if (pdPhysicalBuffer)
+	{// In place.
+		calls->IntToDouble(piDataBuffer, pdPhysicalBuffer, iCount, iMaxData, dGain, dOffset);
+		meids_linearize_v(pLinearizer, pdPhysicalBuffer, iCount, dTempOffset);
+		return;
+	}
+
+	for (i = 0; i < iCount; i += chunk)
+	{
+		chunk = ((iCount - i) > ME_LINEARIZE_CHUNK) ? ME_LINEARIZE_CHUNK : (iCount - i);
+
+		calls->IntToDouble(piDataBuffer + i, dValues, chunk, iMaxData, dGain, dOffset);
+		meids_linearize_v(pLinearizer, dValues, chunk, dTempOffset);
+
+		for (j = 0; j < chunk; j++)
+		{
+			pfPhysicalBuffer[i + j] = dValues[j];
 		}
+	}
+}
 
-		meErrorProc("meUtilityDigitalToPhysical()", err);
+static int doPhysicalToDigitalV(double dMin, double dMax, int iMaxData,
+								double* pdPhysicalBuffer, float* pfPhysicalBuffer, int iCount,
+								int* piDataBuffer)
+{/// @note Exactly one of input buffers is used. Values out of range are saturated to [0, iMaxData].
+	const meids_convert_calls_t* calls = meids_convert_get_calls();
+	double dScale;
+	double dOffset;
+
+	if ((iMaxData < 0) || (dMax == dMin))
+	{
+		return ME_ERRNO_INVALID_MIN_MAX;
 	}
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	if (iMaxData == 0)
+	{
+		memset(piDataBuffer, 0, iCount * sizeof(int));
+		return ME_ERRNO_SUCCESS;
+	}
 
-	return err;
+	dScale = iMaxData / (dMax - dMin);
+	dOffset = 0.5 - dMin * dScale;
+
+	if (pdPhysicalBuffer)
+		calls->DoubleToInt(pdPhysicalBuffer, piDataBuffer, iCount, iMaxData, dScale, dOffset);
+	else
+		calls->FloatToInt(pfPhysicalBuffer, piDataBuffer, iCount, iMaxData, dScale, dOffset);
+
+	return ME_ERRNO_SUCCESS;
 }
 
 int meUtilityPhysicalToDigitalV(double dMin, double dMax, int iMaxData,
@@ -1765,54 +2181,67 @@ int meUtilityPhysicalToDigitalV(double dMin, double dMax, int iMaxData,
 								int* piDataBuffer)
 {
 	int err = ME_ERRNO_SUCCESS;
-	int i;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if (!pdPhysicalBuffer || !piDataBuffer)
 	{
-		return ME_ERRNO_INVALID_POINTER;
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
 	}
 
-	for (i=0; i<iCount; i++)
+	if (iCount > 0)
 	{
-		meUtilityPhysicalToDigital(dMin, dMax, iMaxData, pdPhysicalBuffer[i], &piDataBuffer[i]);
+		err = doPhysicalToDigitalV(dMin, dMax, iMaxData, pdPhysicalBuffer, NULL, iCount, piDataBuffer);
 	}
 
-	meErrorProc("meUtilityDigitalToPhysical()", err);
+ERROR:
+	meErrorProc("meUtilityPhysicalToDigitalV()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
 
-int meUtilityDigitalToPhysicalV(double dMin, double dMax, int iMaxData,
-								int* piDataBuffer, int iCount,
-								int iModuleType, double dRefValue, double* pdPhysicalBuffer)
+int meUtilityPhysicalToDigitalFloatV(double dMin, double dMax, int iMaxData,
+								float* pfPhysicalBuffer, int iCount,
+								int* piDataBuffer)
 {
 	int err = ME_ERRNO_SUCCESS;
-	int i;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
-	if (!pdPhysicalBuffer || !piDataBuffer)
+	if (!pfPhysicalBuffer || !piDataBuffer)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
+	}
+
+	if (iCount > 0)
 	{
-		return ME_ERRNO_INVALID_POINTER;
+		err = doPhysicalToDigitalV(dMin, dMax, iMaxData, NULL, pfPhysicalBuffer, iCount, piDataBuffer);
 	}
 
+ERROR:
+	meErrorProc("meUtilityPhysicalToDigitalFloatV()", err);
+
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
+
+	return err;
+}
+
+static int checkModuleType(int iModuleType)
+{
 	switch (iModuleType)
 	{
 		case ME_MODULE_TYPE_MULTISIG_NONE:
@@ -1832,121 +2261,172 @@ int meUtilityDigitalToPhysicalV(double dMin, double dMax, int iMaxData,
 		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_S:
 		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_T:
 		case ME_MODULE_TYPE_MULTISIG_TE8_TEMP_SENSOR:
-			break;
+			return ME_ERRNO_SUCCESS;
+	}
 
-		default:
-			err = ME_ERRNO_INVALID_MODULE_TYPE;
-			iModuleType = ME_MODULE_TYPE_MULTISIG_NONE;
+	return ME_ERRNO_INVALID_MODULE_TYPE;
+}
+
+int meUtilityDigitalToPhysicalV(double dMin, double dMax, int iMaxData,
+								int* piDataBuffer, int iCount,
+								int iModuleType, double dRefValue, double* pdPhysicalBuffer)
+{
+	int err = ME_ERRNO_SUCCESS;
+	int tmp_err;
+
+	uint64_t stat_start;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	stat_start = ME_STAT_BEGIN();
+
+
+	if (!pdPhysicalBuffer || !piDataBuffer)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
 	}
 
-	for (i = 0; i < iCount; i++)
+	err = checkModuleType(iModuleType);
+	if (err)
+	{// Unknown module - deliver plain voltages.
+		iModuleType = ME_MODULE_TYPE_MULTISIG_NONE;
+	}
+
+	if (iCount > 0)
 	{
-		meUtilityDigitalToPhysical(dMin, dMax, iMaxData, piDataBuffer[i], iModuleType, dRefValue, &pdPhysicalBuffer[i]);
+		tmp_err = doDigitalToPhysicalV(dMin, dMax, iMaxData, piDataBuffer, iCount, iModuleType, dRefValue, pdPhysicalBuffer, NULL);
+		if (tmp_err)
+			err = tmp_err;
 	}
 
-	meErrorProc("meUtilityDigitalToPhysical()", err);
+ERROR:
+	meErrorProc("meUtilityDigitalToPhysicalV()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
 
-static double meCalcPT100Temp(double resistance, int iIMeasured)
+int meUtilityDigitalToPhysicalFloatV(double dMin, double dMax, int iMaxData,
+								int* piDataBuffer, int iCount,
+								int iModuleType, double dRefValue, float* pfPhysicalBuffer)
 {
-	int i = 0;
-	double grad = ME_PT_100_TEMP_OFFSET;
+	int err = ME_ERRNO_SUCCESS;
+	int tmp_err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
-	if (resistance < pt_100[i])
+	if (!pfPhysicalBuffer || !piDataBuffer)
 	{
-		grad = ME_PT_100_TEMP_OFFSET;
-		return grad;
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
 	}
 
-	for (i = 0; i < ME_PT_100_TABLE_COUNT; i++)
-	{
-		if (resistance > pt_100[i])
-		{
-			continue;
-		}
-		else if (resistance == pt_100[i])
-		{
-			grad = i + ME_PT_100_TEMP_OFFSET;
-			break;
-		}
-		else if (resistance < pt_100[i])
-		{
-			grad = (i - 1) + (1 / (pt_100[i] - pt_100[i - 1])) * (resistance - pt_100[i - 1]) + ME_PT_100_TEMP_OFFSET;
-			break;
-		}
+	err = checkModuleType(iModuleType);
+	if (err)
+	{// Unknown module - deliver plain voltages.
+		iModuleType = ME_MODULE_TYPE_MULTISIG_NONE;
 	}
 
-	if (i == ME_PT_100_TABLE_COUNT)
+	if (iCount > 0)
 	{
-		grad = ME_PT_100_TABLE_COUNT - 1 + ME_PT_100_TEMP_OFFSET;
+		tmp_err = doDigitalToPhysicalV(dMin, dMax, iMaxData, piDataBuffer, iCount, iModuleType, dRefValue, NULL, pfPhysicalBuffer);
+		if (tmp_err)
+			err = tmp_err;
 	}
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+ERROR:
+	meErrorProc("meUtilityDigitalToPhysicalFloatV()", err);
+
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
-	return grad;
+	return err;
 }
 
-static double meCalcTCTemp(double dVoltage, double dTeGain,
-							double* pdTable, unsigned long ulTableSize,
-							double dMinTemp, double dTempOffset)
+int meUtilityTemperatureV(double dMin, double dMax, int iMaxData,
+								int* piDataBuffer, int iCount,
+								int iModuleType, double dRefValue, double* pdTemperatureBuffer)
 {
+	int err = ME_ERRNO_SUCCESS;
+	const meids_linearizer_t* pLinearizer;
 	int i;
-	double tevoltage;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
-	tevoltage = dVoltage / dTeGain * 1E6; // The table holds the voltage in uV
+	if (!pdTemperatureBuffer || !piDataBuffer)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto EXIT;
+	}
 
-	if (tevoltage <= pdTable[0])
+	if (iMaxData <= 0)
 	{
-		return pdTable[0];
+		for (i = 0; i < iCount; i++)
+		{
+			pdTemperatureBuffer[i] = 0;
+		}
+		err = ME_ERRNO_INVALID_MIN_MAX;
+		goto EXIT;
 	}
 
-	if (tevoltage >= pdTable[ulTableSize - 1])
+	if (iCount <= 0)
 	{
-		return pdTable[ulTableSize - 1];
+		goto EXIT;
 	}
 
-	for (i = 0; i < ulTableSize; i++)
+	pLinearizer = meids_linearizer_get(iModuleType);
+	switch (iModuleType)
 	{
-		if (tevoltage == pdTable[i])
-		{
-			return dMinTemp + i + dTempOffset;
-		}
-		else if (tevoltage > pdTable[i])
-		{
-			continue;
-		}
-		else
-		{
-			return (((dMinTemp + i) + (tevoltage - pdTable[i]) / (pdTable[i + 1] - pdTable[i])) + dTempOffset);
-		}
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT100:
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT500:
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT1000:
+			// dRefValue: excitation current.
+			if (dRefValue == 0)
+				dRefValue = 0.0005;
+
+			doLinearizeV(dMin, dMax, iMaxData, piDataBuffer, iCount, pLinearizer, 1 / pLinearizer->gain / dRefValue, 0, 0, pdTemperatureBuffer, NULL);
+
+			break;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_B:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_E:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_J:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_K:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_N:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_R:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_S:
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_T:
+			// dRefValue: cold junction temperature. Compensation is done in voltage domain (thermocouples are not linear).
+			doLinearizeV(dMin, dMax, iMaxData, piDataBuffer, iCount, pLinearizer, 1E6 / pLinearizer->gain, meids_linearize_inverse(pLinearizer, dRefValue), 0, pdTemperatureBuffer, NULL);
+
+			break;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TEMP_SENSOR:
+			err = doDigitalToPhysicalV(dMin, dMax, iMaxData, piDataBuffer, iCount, iModuleType, dRefValue, pdTemperatureBuffer, NULL);
+
+			break;
+
+		default:
+			err = ME_ERRNO_INVALID_MODULE_TYPE;
 	}
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	meErrorProc("meUtilityTemperatureV()", err);
 
-	return 0.0;
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
+
+	return err;
 }
 
 int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdevice3, int iRef, int iPrescaler, int iDutyCycle, int iFlag)
@@ -1959,46 +2439,45 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 	meIOSingle_t list[3];
 	int caps;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	// Check if all of them are counters.
 	err = meQuerySubdeviceType(iDevice, iSubdevice1, &type, &subtype);
 	if (err)
-		return err;
+		goto EXIT;
 
 	if (type != ME_TYPE_CTR)
 	{
 		err = ME_ERRNO_NOT_SUPPORTED;
 		meErrorProc("meUtilityPWMStart()", err);
-		return err;
+		goto EXIT;
 	}
 
 	err = meQuerySubdeviceType(iDevice, iSubdevice2, &type, &subtype);
 	if (err)
-		return err;
+		goto EXIT;
 
 	if (type != ME_TYPE_CTR)
 	{
 		err = ME_ERRNO_NOT_SUPPORTED;
 		meErrorProc("meUtilityPWMStart()", err);
-		return err;
+		goto EXIT;
 	}
 
 	err = meQuerySubdeviceType(iDevice, iSubdevice3, &type, &subtype);
 	if (err)
-		return err;
+		goto EXIT;
 
 	if (type != ME_TYPE_CTR)
 	{
 		err = ME_ERRNO_NOT_SUPPORTED;
 		meErrorProc("meUtilityPWMStart()", err);
-		return err;
+		goto EXIT;
 	}
 
 
@@ -2011,20 +2490,20 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 		{
 			err = ME_ERRNO_NOT_SUPPORTED;
 			meErrorProc("meUtilityPWMStart()", err);
-			return err;
+			goto EXIT;
 		}
 
 		// Check if internal connections supported by hardware
 		// Counter1 >> Counter2
 		err = meQuerySubdeviceCaps(iDevice, iSubdevice2, &caps);
 		if (err)
-			return err;
+			goto EXIT;
 
 		if ((caps & ME_CAPS_CTR_CLK_PREVIOUS) != ME_CAPS_CTR_CLK_PREVIOUS)
 		{
 			err = ME_ERRNO_NOT_SUPPORTED;
 			meErrorProc("meUtilityPWMStart()", err);
-			return err;
+			goto EXIT;
 		}
 
 		iRef_C2 = ME_REF_CTR_PREVIOUS;
@@ -2040,7 +2519,7 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 		err = ME_ERRNO_INVALID_FLAGS;
 
 		meErrorProc("meUtilityPWMStart()", err);
-		return err;
+		goto EXIT;
 	}
 
 	if (iRef != ME_REF_CTR_EXTERNAL)
@@ -2048,7 +2527,7 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 		// Check if choosen clock source is supported
 		err = meQuerySubdeviceCaps(iDevice, iSubdevice1, &caps);
 		if (err)
-			return err;
+			goto EXIT;
 
 		if (iRef == ME_REF_CTR_INTERNAL_1MHZ)
 		{
@@ -2056,7 +2535,7 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 			{
 				err = ME_ERRNO_INVALID_REF;
 				meErrorProc("meUtilityPWMStart()", err);
-				return err;
+				goto EXIT;
 			}
 		}
 		else if (iRef == ME_REF_CTR_INTERNAL_10MHZ)
@@ -2065,7 +2544,7 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 			{
 				err = ME_ERRNO_INVALID_REF;
 				meErrorProc("meUtilityPWMStart()", err);
-				return err;
+				goto EXIT;
 			}
 		}
 		else if (iRef == ME_REF_CTR_PREVIOUS)
@@ -2076,7 +2555,7 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 			{
 				err = ME_ERRNO_INVALID_REF;
 				meErrorProc("meUtilityPWMStart()", err);
-				return err;
+				goto EXIT;
 			}
 		}
 		else
@@ -2084,7 +2563,7 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 			//error - no more internal signal's sources!
 			err = ME_ERRNO_INVALID_REF;
 			meErrorProc("meUtilityPWMStart()", err);
-			return err;
+			goto EXIT;
 		}
 	}
 
@@ -2092,20 +2571,20 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 	{
 		err = ME_ERRNO_INVALID_DUTY_CYCLE;
 		meErrorProc("meUtilityPWMStart()", err);
-		return err;
+		goto EXIT;
 	}
 
 	err = meIOSingleConfig(iDevice, iSubdevice1, 0, ME_SINGLE_CONFIG_CTR_8254_MODE_RATE_GENERATOR, iRef, ME_TRIG_CHAN_DEFAULT, ME_TRIG_TYPE_SW, 0, ME_IO_SINGLE_CONFIG_NO_FLAGS);
 	if (err)
-		return err;
+		goto EXIT;
 
 	err = meIOSingleConfig( iDevice, iSubdevice2, 0, ME_SINGLE_CONFIG_CTR_8254_MODE_RATE_GENERATOR, iRef_C2, ME_TRIG_CHAN_DEFAULT, ME_TRIG_TYPE_SW, 0, ME_IO_SINGLE_CONFIG_NO_FLAGS);
 	if (err)
-		return err;
+		goto EXIT;
 
 	err = meIOSingleConfig(iDevice, iSubdevice3, 0, ME_SINGLE_CONFIG_CTR_8254_MODE_INTERRUPT_ON_TERMINAL_COUNT, ME_REF_CTR_EXTERNAL, ME_TRIG_CHAN_DEFAULT, ME_TRIG_TYPE_SW, 0, ME_IO_SINGLE_CONFIG_NO_FLAGS);
 	if (err)
-		return err;
+		goto EXIT;
 
 	for (i = 0; i < 3; i++)
 	{
@@ -2127,12 +2606,12 @@ int meUtilityPWMStart(int iDevice, int iSubdevice1, int iSubdevice2, int iSubdev
 
 	err = meIOSingle(list, 3, ME_IO_SINGLE_NO_FLAGS);
 	if (err)
-		return err;
+		goto EXIT;
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, iDevice, err);
 
-	return ME_ERRNO_SUCCESS;
+	return err;
 }
 
 int meUtilityPWMStop(int iDevice, int iSubdevice1)
@@ -2141,34 +2620,33 @@ int meUtilityPWMStop(int iDevice, int iSubdevice1)
 	int type;
 	int subtype;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = meQuerySubdeviceType(iDevice, iSubdevice1, &type, &subtype);
 	if (err)
-		return err;
+		goto EXIT;
 
 	if ((type != ME_TYPE_CTR))
 	{
 		err = ME_ERRNO_NOT_SUPPORTED;
 		meErrorProc("meUtilityPWMStop()", err);
-		return err;
+		goto EXIT;
 	}
 
 	//Reset prescaler -> block it
 	err = meIOResetSubdevice(iDevice, iSubdevice1,ME_IO_RESET_SUBDEVICE_NO_FLAGS);
 	if (err)
-		return err;
+		goto EXIT;
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, iDevice, err);
 
-	return ME_ERRNO_SUCCESS;
+	return err;
 }
 
 int meUtilityPWMRestart(int iDevice, int iSubdevice1, int iRef, int iPrescaler)
@@ -2179,24 +2657,23 @@ int meUtilityPWMRestart(int iDevice, int iSubdevice1, int iRef, int iPrescaler)
 	int caps;
 	meIOSingle_t list;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	/* Check if all of them are counters */
 	err = meQuerySubdeviceType(iDevice, iSubdevice1, &type, &subtype);
 	if (err)
-		return err;
+		goto EXIT;
 
 	if (type != ME_TYPE_CTR)
 	{
 		err = ME_ERRNO_NOT_SUPPORTED;
 		meErrorProc("meUtilityPWMRestart()", err);
-		return err;
+		goto EXIT;
 	}
 
 	if (iRef != ME_REF_CTR_EXTERNAL)
@@ -2204,7 +2681,7 @@ int meUtilityPWMRestart(int iDevice, int iSubdevice1, int iRef, int iPrescaler)
 		// Check if choosen clock source is supported
 		err = meQuerySubdeviceCaps(iDevice, iSubdevice1, &caps);
 		if (err)
-			return err;
+			goto EXIT;
 
 		if (iRef == ME_REF_CTR_INTERNAL_1MHZ)
 		{
@@ -2212,7 +2689,7 @@ int meUtilityPWMRestart(int iDevice, int iSubdevice1, int iRef, int iPrescaler)
 			{
 				err = ME_ERRNO_INVALID_REF;
 				meErrorProc("meUtilityPWMRestart()", err);
-				return err;
+				goto EXIT;
 			}
 		}
 		else if (iRef == ME_REF_CTR_INTERNAL_10MHZ)
@@ -2221,7 +2698,7 @@ int meUtilityPWMRestart(int iDevice, int iSubdevice1, int iRef, int iPrescaler)
 			{
 				err = ME_ERRNO_INVALID_REF;
 				meErrorProc("meUtilityPWMRestart()", err);
-				return err;
+				goto EXIT;
 			}
 		}
 		else if (iRef == ME_REF_CTR_PREVIOUS)
@@ -2232,7 +2709,7 @@ int meUtilityPWMRestart(int iDevice, int iSubdevice1, int iRef, int iPrescaler)
 			{
 				err = ME_ERRNO_INVALID_REF;
 				meErrorProc("meUtilityPWMRestart()", err);
-				return err;
+				goto EXIT;
 			}
 		}
 		else
@@ -2240,14 +2717,14 @@ int meUtilityPWMRestart(int iDevice, int iSubdevice1, int iRef, int iPrescaler)
 			//error - no more internal signal's sources!
 			err = ME_ERRNO_INVALID_REF;
 			meErrorProc("meUtilityPWMRestart()", err);
-			return err;
+			goto EXIT;
 		}
 	}
 
 	//Set mode 2
 	err = meIOSingleConfig(iDevice, iSubdevice1, 0, ME_SINGLE_CONFIG_CTR_8254_MODE_RATE_GENERATOR, iRef, ME_TRIG_CHAN_DEFAULT, ME_TRIG_TYPE_SW, 0, ME_IO_SINGLE_CONFIG_NO_FLAGS);
 	if (err)
-		return err;
+		goto EXIT;
 
 	//Start prescaler
 	list.iDevice = iDevice;
@@ -2260,32 +2737,30 @@ int meUtilityPWMRestart(int iDevice, int iSubdevice1, int iRef, int iPrescaler)
 
 	err = meIOSingle(&list, 1, ME_IO_SINGLE_NO_FLAGS);
 	if (err)
-		return err;
+		goto EXIT;
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, iDevice, err);
 
-	return ME_ERRNO_SUCCESS;
+	return err;
 }
 
 int meConfigLoad(char* pParamSet)
 {
 	int err;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	err = ME_ParametersSet((me_extra_param_set_t *)pParamSet, ((me_extra_param_set_t *)pParamSet)->flags);
 
 	meErrorProc("meConfigLoad()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -2321,12 +2796,11 @@ int meUtilityPeriodToTicks(int iBaseFreq, double dPeriod, unsigned int* piTicks)
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if ((iBaseFreq <= 0) || (dPeriod < 0))
@@ -2341,8 +2815,7 @@ int meUtilityPeriodToTicks(int iBaseFreq, double dPeriod, unsigned int* piTicks)
 
 	meErrorProc("meUtilityPeriodToTicks()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -2351,12 +2824,11 @@ int meUtilityTicksToPeriod(int iBaseFreq, unsigned int iTicks, double* pdPeriod)
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if (iBaseFreq <= 0)
@@ -2371,8 +2843,7 @@ int meUtilityTicksToPeriod(int iBaseFreq, unsigned int iTicks, double* pdPeriod)
 
 	meErrorProc("meUtilityTicksToPeriod()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -2381,12 +2852,11 @@ int meUtilityFrequencyToTicks(int iBaseFreq, double dFrequency, unsigned int* pi
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if ((dFrequency <= 0) || (iBaseFreq <= 0))
@@ -2401,8 +2871,7 @@ int meUtilityFrequencyToTicks(int iBaseFreq, double dFrequency, unsigned int* pi
 
 	meErrorProc("meUtilityFrequencyToTicks()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -2411,12 +2880,11 @@ int meUtilityTicksToFrequency(int iBaseFreq, unsigned int iTicks, double* pdFreq
 {
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 	if (iBaseFreq <= 0)
 	{
@@ -2430,8 +2898,7 @@ int meUtilityTicksToFrequency(int iBaseFreq, unsigned int iTicks, double* pdFreq
 
 	meErrorProc("meUtilityTicksToFrequency()", err);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
 	return err;
 }
@@ -2440,18 +2907,20 @@ int meUtilityCodeDivider(double dDivider, unsigned int* piDivider)
 {
 	double tmp;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	int err = ME_ERRNO_SUCCESS;
+
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if (!piDivider)
 	{
-		meErrorProc("meUtilityCodeDivider()", ME_ERRNO_INVALID_POINTER);
-		return ME_ERRNO_INVALID_POINTER;
+		err = ME_ERRNO_INVALID_POINTER;
+		meErrorProc("meUtilityCodeDivider()", err);
+		goto EXIT;
 	}
 
 	if (dDivider < 0.0)
@@ -2471,36 +2940,38 @@ int meUtilityCodeDivider(double dDivider, unsigned int* piDivider)
 	tmp *= 0x10000;
 	*piDivider = tmp;
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
-	return ME_ERRNO_SUCCESS;
+	return err;
 }
 
 int meUtilityDecodeDivider(unsigned int iDivider, double* pdDivider)
 {
 	double tmp = (unsigned int)iDivider;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
+	int err = ME_ERRNO_SUCCESS;
+
+	uint64_t stat_start;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_pre);
+	stat_start = ME_STAT_BEGIN();
 
 
 	if (!pdDivider)
 	{
-		meErrorProc("meUtilityDecodeDivider()", ME_ERRNO_INVALID_POINTER);
-		return ME_ERRNO_INVALID_POINTER;
+		err = ME_ERRNO_INVALID_POINTER;
+		meErrorProc("meUtilityDecodeDivider()", err);
+		goto EXIT;
 	}
 
 	tmp /= 0x10000;
 	tmp /= 0x10000;
 	*pdDivider = (tmp > 0) ? tmp : 1 + tmp;
 
-	clock_gettime(CLOCK_MONOTONIC, &ts_post);
-	LIBPEXECTIME("executed in %ld us\n", (ts_post.tv_nsec - ts_pre.tv_nsec) / 1000 + (ts_post.tv_sec - ts_pre.tv_sec) * 1000000);
+EXIT:
+	ME_STAT_END(stat_start, ME_STAT_NO_DEVICE, err);
 
-	return ME_ERRNO_SUCCESS;
+	return err;
 }
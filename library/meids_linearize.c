@@ -0,0 +1,201 @@
+/* Temperature sensors' linearization for Meilhaus driver system.
+ * ==============================================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <syslog.h>
+
+# include "me_defines.h"
+
+# include "meids_debug.h"
+# include "meids_linearize.h"
+
+# include "pt_100.h"
+# include "te_type_b.h"
+# include "te_type_e.h"
+# include "te_type_j.h"
+# include "te_type_k.h"
+# include "te_type_n.h"
+# include "te_type_r.h"
+# include "te_type_s.h"
+# include "te_type_t.h"
+
+# define ME_LINEARIZER_TABLE(table) table, sizeof(table) / sizeof(double)
+
+/// Init of the shared object - building linearizers.
+void __attribute__((constructor)) meids_linearize_init(void);
+
+static meids_linearizer_t Linearizer_PT100 = { ME_LINEARIZER_TABLE(pt_100), ME_PT_100_TEMP_OFFSET, 40, 0 };
+static meids_linearizer_t Linearizer_PT500 = { ME_LINEARIZER_TABLE(pt_100), ME_PT_100_TEMP_OFFSET, 8, 0 };
+static meids_linearizer_t Linearizer_PT1000 = { ME_LINEARIZER_TABLE(pt_100), ME_PT_100_TEMP_OFFSET, 4, 0 };
+
+static meids_linearizer_t Linearizer_TE_B = { ME_LINEARIZER_TABLE(te_type_b), ME_TE_TYPE_B_MIN_TEMP, ME_TE_TYPE_B_GAIN, 0 };
+static meids_linearizer_t Linearizer_TE_E = { ME_LINEARIZER_TABLE(te_type_e), ME_TE_TYPE_E_MIN_TEMP, ME_TE_TYPE_E_GAIN, 0 };
+static meids_linearizer_t Linearizer_TE_J = { ME_LINEARIZER_TABLE(te_type_j), ME_TE_TYPE_J_MIN_TEMP, ME_TE_TYPE_J_GAIN, 0 };
+static meids_linearizer_t Linearizer_TE_K = { ME_LINEARIZER_TABLE(te_type_k), ME_TE_TYPE_K_MIN_TEMP, ME_TE_TYPE_K_GAIN, 0 };
+static meids_linearizer_t Linearizer_TE_N = { ME_LINEARIZER_TABLE(te_type_n), ME_TE_TYPE_N_MIN_TEMP, ME_TE_TYPE_N_GAIN, 0 };
+static meids_linearizer_t Linearizer_TE_R = { ME_LINEARIZER_TABLE(te_type_r), ME_TE_TYPE_R_MIN_TEMP, ME_TE_TYPE_R_GAIN, 0 };
+static meids_linearizer_t Linearizer_TE_S = { ME_LINEARIZER_TABLE(te_type_s), ME_TE_TYPE_S_MIN_TEMP, ME_TE_TYPE_S_GAIN, 0 };
+static meids_linearizer_t Linearizer_TE_T = { ME_LINEARIZER_TABLE(te_type_t), ME_TE_TYPE_T_MIN_TEMP, ME_TE_TYPE_T_GAIN, 0 };
+
+static void build_linearizer(meids_linearizer_t* lin)
+{/// @note Binary search needs strictly increasing table. Search starts at table's minimum.
+	unsigned int i;
+
+	lin->first = 0;
+	for (i = 1; i < lin->count; i++)
+	{
+		if (lin->table[i] < lin->table[lin->first])
+			lin->first = i;
+	}
+
+	for (i = lin->first + 1; i < lin->count; i++)
+	{
+		if (lin->table[i] <= lin->table[i - 1])
+		{
+			LIBPERROR("Linearization table not monotonic at entry %d.\n", i);
+		}
+	}
+}
+
+void meids_linearize_init(void)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	build_linearizer(&Linearizer_PT100);
+	build_linearizer(&Linearizer_PT500);
+	build_linearizer(&Linearizer_PT1000);
+
+	build_linearizer(&Linearizer_TE_B);
+	build_linearizer(&Linearizer_TE_E);
+	build_linearizer(&Linearizer_TE_J);
+	build_linearizer(&Linearizer_TE_K);
+	build_linearizer(&Linearizer_TE_N);
+	build_linearizer(&Linearizer_TE_R);
+	build_linearizer(&Linearizer_TE_S);
+	build_linearizer(&Linearizer_TE_T);
+}
+
+const meids_linearizer_t* meids_linearizer_get(int module_type)
+{
+	switch (module_type)
+	{
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT100:
+			return &Linearizer_PT100;
+
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT500:
+			return &Linearizer_PT500;
+
+		case ME_MODULE_TYPE_MULTISIG_RTD8_PT1000:
+			return &Linearizer_PT1000;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_B:
+			return &Linearizer_TE_B;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_E:
+			return &Linearizer_TE_E;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_J:
+			return &Linearizer_TE_J;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_K:
+			return &Linearizer_TE_K;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_N:
+			return &Linearizer_TE_N;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_R:
+			return &Linearizer_TE_R;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_S:
+			return &Linearizer_TE_S;
+
+		case ME_MODULE_TYPE_MULTISIG_TE8_TYPE_T:
+			return &Linearizer_TE_T;
+	}
+
+	return NULL;
+}
+
+double meids_linearize(const meids_linearizer_t* lin, double value)
+{
+	const double* table = lin->table;
+	unsigned int low = lin->first;
+	unsigned int high = lin->count - 1;
+	unsigned int middle;
+
+	if (!(value > table[low]))
+	{
+		return lin->min_temp + low;
+	}
+
+	if (value >= table[high])
+	{
+		return lin->min_temp + high;
+	}
+
+	// Invariant: table[low] < value < table[high]
+	while (high - low > 1)
+	{
+		middle = (low + high) >> 1;
+		if (table[middle] <= value)
+			low = middle;
+		else
+			high = middle;
+	}
+
+	return lin->min_temp + low + (value - table[low]) / (table[high] - table[low]);
+}
+
+void meids_linearize_v(const meids_linearizer_t* lin, double* values, int count, double offset)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		values[i] = meids_linearize(lin, values[i]) + offset;
+	}
+}
+
+double meids_linearize_inverse(const meids_linearizer_t* lin, double temperature)
+{/// @note Whole table is used. Only the search (value to temperature) is limited to the monotonic part.
+	double position = temperature - lin->min_temp;
+	unsigned int index;
+
+	if (!(position > 0))
+	{
+		return lin->table[0];
+	}
+
+	if (position >= lin->count - 1)
+	{
+		return lin->table[lin->count - 1];
+	}
+
+	index = (unsigned int)position;
+
+	return lin->table[index] + (position - index) * (lin->table[index + 1] - lin->table[index]);
+}
@@ -0,0 +1,27 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_LINEARIZE_H_
+#  define _MEIDS_LINEARIZE_H_
+
+/// Temperature sensors' linearization. Tables have 1 degree Celsius step.
+typedef struct meids_linearizer
+{
+	const double* table;	// Thermocouples: voltage in uV. RTD: PT100 resistance in ohms.
+	unsigned int count;
+	double min_temp;		// Temperature of the first entry.
+	double gain;			// Module's amplification (thermocouples) or resistance scale (RTD).
+	unsigned int first;		// First entry of monotonic part of the table (type B dips below 0uV).
+} meids_linearizer_t;
+
+/// Linearizer for multisig module type. NULL when module is not a temperature sensor.
+const meids_linearizer_t* meids_linearizer_get(int module_type);
+/// Sensor's value (uV or ohms) to temperature. Binary search, values out of table are saturated.
+double meids_linearize(const meids_linearizer_t* lin, double value);
+/// In place: values[i] = temperature(values[i]) + offset.
+void meids_linearize_v(const meids_linearizer_t* lin, double* values, int count, double offset);
+/// Temperature to sensor's value (uV or ohms). Used for cold junction compensation.
+double meids_linearize_inverse(const meids_linearizer_t* lin, double temperature);
+
+# endif	//_MEIDS_LINEARIZE_H_
+#else
+# error KERNEL???
+#endif	//__KERNEL__
@@ -666,6 +666,11 @@ int ME_QuerySubdeviceTimer(int device, int subdevice,
 	return ME_virtual_QuerySubdeviceTimer(Loc_Config, device, subdevice, timer, base, min_ticks_low, min_ticks_high, max_ticks_low, max_ticks_high, iFlags);
 }
 
+int ME_QueryLatencyProbe(int device, int subdevice, meLatencyProbe_t* probe, int iFlags)
+{
+	return ME_virtual_QueryLatencyProbe(Loc_Config, device, subdevice, probe, iFlags);
+}
+
 
 //Input/Output
 int ME_IrqStart(int device, int subdevice, int channel, int source, int edge, int arg, int iFlags)
@@ -763,6 +768,11 @@ int ME_StreamStatus(int device, int subdevice, int wait, int* status, int* count
 	return ME_virtual_StreamStatus(Loc_Config, device, subdevice, wait, status, count, iFlags);
 }
 
+int ME_StreamReader(int device, int subdevice, int mode, int policy, int* dropped, int iFlags)
+{
+	return ME_virtual_StreamReader(Loc_Config, device, subdevice, mode, policy, dropped, iFlags);
+}
+
 int ME_StreamStop(int device, int subdevice, int mode, int timeout, int iFlags)
 {
 	return ME_virtual_StreamStop(Loc_Config, device, subdevice, mode, timeout, iFlags);
@@ -807,6 +817,21 @@ int  ME_SetOffset(int device, int subdevice, int channel, int range, double* off
 	return ME_virtual_SetOffset(Loc_Config, device, subdevice, channel, range, offset, iFlags);
 }
 
+int  ME_BatchBegin(int iFlags)
+{// Local calls are executed immediately. Nothing to batch.
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+int  ME_BatchCommit(int* index, int iFlags)
+{
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+int  ME_BatchAbort(int iFlags)
+{
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
 void ME_ConfigPrint(void)
 {
 	LIBPDEBUG("Loc_Config=%p\n", Loc_Config);
@@ -856,6 +881,7 @@ static int local_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->QueryRangeInfo			= QueryRangeInfo_Local;
 	(*context_calls)->QueryRangeByMinMax		= QueryRangeByMinMax_Local;
 	(*context_calls)->QuerySubdeviceTimer		= QuerySubdeviceTimer_Local;
+	(*context_calls)->QueryLatencyProbe			= QueryLatencyProbe_Local;
 
 //Input/Output
 	(*context_calls)->IrqStart					= IrqStart_Local;
@@ -881,6 +907,7 @@ static int local_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->StreamStart				= StreamStart_Local;
 	(*context_calls)->StreamStartList			= StreamStartList_Local;
 	(*context_calls)->StreamStatus				= StreamStatus_Local;
+	(*context_calls)->StreamReader				= StreamReader_Local;
 	(*context_calls)->StreamStop				= StreamStop_Local;
 	(*context_calls)->StreamStopList			= StreamStopList_Local;
 
@@ -114,3 +114,31 @@ int meRQuerySubdeviceType(
 {
 	return ME_ERRNO_NOT_SUPPORTED;
 }
+
+int meRQueryTopology(
+		char *location,
+		char *pcBuffer,
+		int *piSize)
+{
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+int meRQueryDiscover(
+		meRQueryHost_t *pHosts,
+		int iCount,
+		int iTimeout)
+{
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+int meRQueryDiscoverFree(
+		meRQueryHost_t *pHosts,
+		int iCount)
+{
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+int meRQueryClose(char *location)
+{
+	return ME_ERRNO_NOT_SUPPORTED;
+}
@@ -1179,6 +1179,98 @@ int QueryRangeByMinMax_Local(void* context, int device, int subdevice, int unit,
 	return err;
 }
 
+int QueryTopology_Local(void* context, char* buffer, int* size, int iFlags)
+{
+	me_local_context_t* local_context = (me_local_context_t *)context;
+	int err = ME_ERRNO_SUCCESS;
+	me_query_topology_t query;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (iFlags)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	CHECK_POINTER(context);
+	CHECK_POINTER(size);
+
+	LIBPDEBUG("fd=%d buffer=%p size=%d\n", local_context->fd, buffer, *size);
+
+	query.buffer = buffer;
+	query.size = *size;
+	query.err_no = ME_ERRNO_SUCCESS;
+
+	err = ioctl(local_context->fd, ME_QUERY_TOPOLOGY, &query);
+	if (!err)
+	{
+		*size = query.size;
+		if (query.err_no)
+		{
+			LIBPWARNING("ioctl(ME_QUERY_TOPOLOGY,...)=%d\n", query.err_no);
+			err = query.err_no;
+		}
+	}
+	else
+	{
+		// Older drivers don't know this call. Caller has to use single queries.
+		LIBPWARNING("ioctl(%d, ME_QUERY_TOPOLOGY,...)=%d errno=%d\n", local_context->fd, err, errno);
+		err = ME_ERRNO_NOT_SUPPORTED;
+	}
+
+	LIBPDEBUG("size=%d err=%d\n", *size, err);
+	return err;
+}
+
+int QueryLatencyProbe_Local(void* context, int device, int subdevice, meLatencyProbe_t* probe, int iFlags)
+{
+	me_local_context_t* local_context = (me_local_context_t *)context;
+	int err;
+	me_query_latency_probe_t query;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (iFlags != ME_QUERY_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	CHECK_POINTER(context);
+	CHECK_POINTER(probe);
+
+	LIBPDEBUG("fd=%d iDevice=%d iSubdevice=%d pProbe=%p\n",
+			local_context->fd, device, subdevice, probe);
+
+	query.device = device;
+	query.subdevice = subdevice;
+	query.err_no = ME_ERRNO_SUCCESS;
+
+	err = ioctl(local_context->fd, ME_QUERY_LATENCY_PROBE, &query);
+	if (!err)
+	{
+		probe->ullWriteTime = query.write_time;
+		probe->ullIrqTime = query.irq_time;
+		probe->ullWakeTime = query.wake_time;
+		probe->iIrqCount = query.irq_count;
+
+		if (query.err_no)
+		{
+			LIBPWARNING("ioctl((iDevice=%d iSubdevice=%d), ME_QUERY_LATENCY_PROBE,...)=%d\n", device, subdevice, query.err_no);
+			err = query.err_no;
+		}
+	}
+	else
+	{
+		// Older drivers don't know this call.
+		LIBPWARNING("ioctl(%d, ME_QUERY_LATENCY_PROBE,...)=%d errno=%d\n", local_context->fd, err, errno);
+		err = ME_ERRNO_NOT_SUPPORTED;
+	}
+
+	return err;
+}
+
 //Input/Output
 int IrqStart_Local(void* context, int device, int subdevice, int channel, int source, int edge, int arg, int iFlags)
 {
@@ -2094,6 +2186,49 @@ int StreamStatus_Local(void* context, int device, int subdevice, int wait, int*
 	return err;
 }
 
+int StreamReader_Local(void* context, int device, int subdevice, int mode, int policy, int* dropped, int iFlags)
+{
+	me_local_context_t* local_context = (me_local_context_t *)context;
+	int err;
+	me_io_stream_reader_t stream_reader;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(context);
+	CHECK_POINTER(dropped);
+
+	LIBPDEBUG("fd=%d iDevice=%d iSubdevice=%d iMode=0x%x iPolicy=0x%x piDropped=%p iFlags=0x%x\n",
+			local_context->fd, device, subdevice, mode, policy, dropped, iFlags);
+
+	stream_reader.device = device;
+	stream_reader.subdevice = subdevice;
+	stream_reader.mode = mode;
+	stream_reader.policy = policy;
+	stream_reader.dropped = 0;
+	stream_reader.flags = iFlags;
+	stream_reader.err_no = ME_ERRNO_SUCCESS;
+
+	err = ioctl(local_context->fd, ME_IO_STREAM_READER, &stream_reader);
+	if (!err)
+	{
+		*dropped = stream_reader.dropped;
+
+		if (stream_reader.err_no)
+		{
+			LIBPWARNING("ioctl((iDevice=%d, iSubdevice=%d), ME_IO_STREAM_READER,...)=%d\n", device, subdevice, stream_reader.err_no);
+			err = stream_reader.err_no;
+		}
+	}
+	else
+	{
+		// Older drivers don't know this call.
+		LIBPWARNING("ioctl(%d, ME_IO_STREAM_READER,...)=%d errno=%d\n", local_context->fd, err, errno);
+		err = ME_ERRNO_NOT_SUPPORTED;
+	}
+
+	return err;
+}
+
 int StreamTimeToTicks_Local(void* context, int device, int subdevice, int timer, double* stream_time, int* ticks_low, int* ticks_high, int iFlags)
 {
 	int err;
@@ -37,6 +37,7 @@ int  QuerySubdeviceCaps_Local(void* context, int device, int subdevice, int* cap
 int  QuerySubdeviceCapsArgs_Local(void* context, int device, int subdevice, int cap, int* args, int count, int iFlags);
 int  QuerySubdeviceTimer_Local(void* context, int device, int subdevice, int timer,
 															int* base, int* min_ticks_low, int* min_ticks_high, int* max_ticks_low, int* max_ticks_high, int iFlags);
+int  QueryLatencyProbe_Local(void* context, int device, int subdevice, meLatencyProbe_t* probe, int iFlags);
 
 int  QueryChannelsNumber_Local(void* context, int device, int subdevice, unsigned int* number, int iFlags);
 
@@ -44,6 +45,9 @@ int  QueryRangesNumber_Local(void* context, int device, int subdevice, int unit,
 int  QueryRangeInfo_Local(void* context, int device, int subdevice, int range, int* unit, double *min, double *max, unsigned int* max_data, int iFlags);
 int  QueryRangeByMinMax_Local(void* context, int device, int subdevice, int unit, double *min, double *max, int* max_data, int* range, int iFlags);
 
+/// Fills buffer with snapshot of all static information (me_topology_*_t records). On ME_ERRNO_USER_BUFFER_SIZE size is set to needed one.
+int  QueryTopology_Local(void* context, char* buffer, int* size, int iFlags);
+
 //Input/Output
 int  IrqStart_Local(void* context, int device, int subdevice, int channel, int source, int edge, int arg, int iFlags);
 int  IrqWait_Local(void* context, int device, int subdevice, int channel, int* count, int* value, int timeout, int iFlags);
@@ -71,6 +75,7 @@ int  StreamNewValues_Local(void* context, int device, int subdevice, int timeout
 int  StreamRead_Local(void* context,  int device, int subdevice, int mode, int* values, int* count, int timeout, int iFlags);
 int  StreamWrite_Local(void* context, int device, int subdevice, int mode, int* values, int* count, int timeout, int iFlags);
 int  StreamStatus_Local(void* context, int device, int subdevice, int wait, int* status, int* count, int iFlags);
+int  StreamReader_Local(void* context, int device, int subdevice, int mode, int policy, int* dropped, int iFlags);
 
 int  StreamSetCallbacks_Local(void* context,
 							int device, int subdevice,
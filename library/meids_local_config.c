@@ -21,8 +21,12 @@
 # include "meids_local_calls.h"
 # include "meids_debug.h"
 
+# include "meids_config.h"
 # include "meids_local_config.h"
 
+/// First guess of topology snapshot's size. Enough for a few boards.
+# define ME_TOPOLOGY_BUFFER_SIZE	0x10000
+
 static int  build_me_drv_device_list(me_local_context_t* context, me_cfg_device_entry_t** device_list, unsigned int *count, int max_dev);
 static int  build_me_drv_device_entry(me_local_context_t* context, me_cfg_device_entry_t* device, int number);
 static int  build_me_drv_device_info(me_local_context_t* context, me_cfg_device_entry_t *device, int number);
@@ -32,10 +36,17 @@ static int  build_me_drv_subdevice_info(me_local_context_t* context, me_cfg_subd
 static int  build_me_drv_range_list(me_local_context_t* context, me_cfg_range_info_t** range_list, unsigned int *count, int number, int subnumber, int max_ranges);
 static int  build_me_drv_range_entry(me_local_context_t* context, me_cfg_range_info_t *range, int number, int subnumber, int rangenumber);
 
+static int  read_me_drv_topology(me_local_context_t* context, char** topology, int* size);
+static int  build_me_drv_topology(me_local_context_t* context, me_config_t* cfg, char* topology, int size);
+static int  build_me_drv_topology_device(me_local_context_t* context, me_cfg_device_entry_t* device, int number, char* topology, int size, int* offset);
+static int  build_me_drv_topology_subdevice(me_cfg_subdevice_entry_t* subdevice, char* topology, int size, int* offset);
+
 int ConfigRead_Local(me_local_context_t* context, me_config_t* cfg, int iFlags)
 {
 	int err=ME_ERRNO_SUCCESS;
 	int no_devices = 0;
+	char* topology = NULL;
+	int size = 0;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
@@ -45,6 +56,14 @@ int ConfigRead_Local(me_local_context_t* context, me_config_t* cfg, int iFlags)
 		err = ME_ERRNO_INVALID_FLAGS;
 	}
 
+	// Whole topology in one call. Older drivers have to be asked query by query.
+	if (!read_me_drv_topology(context, &topology, &size))
+	{
+		err = build_me_drv_topology(context, cfg, topology, size);
+		free(topology);
+		return err;
+	}
+
 	err = QueryDevicesNumber_Local(context, &no_devices, ME_QUERY_NO_FLAGS);
 	if (!err)
 	{
@@ -317,7 +336,10 @@ static int build_me_drv_subdevice_entry(me_local_context_t* context, me_cfg_subd
 			}
 		}
 
-
+		if (!err)
+		{
+			ConfigQueryCacheFill(subdevice);
+		}
 	}
 	else if (err == ME_ERRNO_NOT_SUPPORTED)
 	{
@@ -397,3 +419,326 @@ static int build_me_drv_range_entry(me_local_context_t* context, me_cfg_range_in
 	return err;
 }
 
+static int read_me_drv_topology(me_local_context_t* context, char** topology, int* size)
+{
+	int err;
+	int buffer_size = ME_TOPOLOGY_BUFFER_SIZE;
+	me_topology_header_t header;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	*topology = NULL;
+	*size = 0;
+
+	// Snapshot size is unknown. Start with typical size and repeat with the one returned by driver.
+	do
+	{
+		free(*topology);
+		*topology = malloc(buffer_size);
+		if (!*topology)
+		{
+			LIBPERROR("Can not get requestet memory for topology.");
+			return ME_ERRNO_INTERNAL;
+		}
+
+		*size = buffer_size;
+		err = QueryTopology_Local(context, *topology, size, ME_QUERY_NO_FLAGS);
+		buffer_size = *size;
+	}
+	while (err == ME_ERRNO_USER_BUFFER_SIZE);
+
+	if (!err)
+	{
+		if (*size < sizeof(me_topology_header_t))
+		{
+			err = ME_ERRNO_NOT_SUPPORTED;
+		}
+		else
+		{
+			memcpy(&header, *topology, sizeof(me_topology_header_t));
+			if ((header.magic != ME_TOPOLOGY_MAGIC) || (header.version != ME_TOPOLOGY_VERSION) || (header.size != *size))
+			{
+				LIBPWARNING("Unknown topology format: magic=0x%08x version=0x%08x size=%d\n", header.magic, header.version, header.size);
+				err = ME_ERRNO_NOT_SUPPORTED;
+			}
+		}
+	}
+
+	if (err)
+	{
+		free(*topology);
+		*topology = NULL;
+		*size = 0;
+	}
+
+	return err;
+}
+
+static int build_me_drv_topology(me_local_context_t* context, me_config_t* cfg, char* topology, int size)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_topology_header_t header;
+	me_cfg_device_entry_t* cur_device;
+	int offset = sizeof(me_topology_header_t);
+	unsigned int cnt;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	memcpy(&header, topology, sizeof(me_topology_header_t));
+
+	if (!header.number_devices)
+	{
+		LIBPERROR("No devices in system.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+
+	cfg->device_list = calloc(header.number_devices, sizeof(me_cfg_device_entry_t*));
+	if (!cfg->device_list)
+	{
+		LIBPERROR("Can not get requestet memory for device_list structure.");
+		return ME_ERRNO_INTERNAL;
+	}
+
+	for (cnt = 0; cnt < header.number_devices; )
+	{
+		cur_device = calloc(1, sizeof(me_cfg_device_entry_t));
+		if (cur_device)
+		{
+			cur_device->context = context;
+			cfg->device_list[cnt] = cur_device;
+
+			err = build_me_drv_topology_device(context, cur_device, cnt, topology, size, &offset);
+			cnt++;
+		}
+		else
+		{
+			LIBPERROR("Can not get requestet memory for device_entry.");
+			err = ME_ERRNO_INTERNAL;
+		}
+
+		if (err)
+			break;
+	}
+	cfg->device_list_count = cnt;
+
+	return err;
+}
+
+static int build_me_drv_topology_device(me_local_context_t* context, me_cfg_device_entry_t* device, int number, char* topology, int size, int* offset)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_topology_device_t record;
+	me_cfg_subdevice_entry_t* cur_subdevice;
+	unsigned int cnt;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (*offset + sizeof(me_topology_device_t) > size)
+	{
+		LIBPERROR("Topology truncated.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+	memcpy(&record, topology + *offset, sizeof(me_topology_device_t));
+	*offset += sizeof(me_topology_device_t);
+
+	device->subdevice_list_count = 0;
+	device->subdevice_list = NULL;
+	device->info.device_name = NULL;
+	device->info.device_description = NULL;
+	device->logical_device_no = -1;
+	device->info.device_no = number;
+
+	if (record.err_no)
+	{
+		LIBPWARNING("Device %d: err=%d\n", number, record.err_no);
+		return record.err_no;
+	}
+
+	device->info.vendor_id = record.vendor_id;
+	device->info.device_id = record.device_id;
+	device->info.serial_no = record.serial_no;
+	device->info.pci.bus_no = record.bus_no;
+	device->info.pci.device_no = record.dev_no;
+	device->info.pci.function_no = record.func_no;
+
+	switch (record.bus_type)
+	{
+		case ME_BUS_TYPE_PCI:
+			device->access_type = me_access_type_PCI;
+			break;
+
+		case ME_BUS_TYPE_USB:
+			device->access_type = me_access_type_USB;
+			break;
+
+		default:
+			device->access_type = me_access_type_invalid;
+			LIBPERROR("Wrong bus type returned: 0x%x(%d)\n", record.bus_type, record.bus_type);
+			err = ME_ERRNO_INTERNAL;
+	}
+
+	switch (record.plugged)
+	{
+		case ME_PLUGGED_IN:
+			device->plugged = me_plugged_type_IN;
+			break;
+
+		case ME_PLUGGED_OUT:
+			device->plugged = me_plugged_type_OUT;
+			break;
+
+		default:
+			device->plugged = me_plugged_type_invalid;
+	}
+
+	record.name[ME_TOPOLOGY_NAME_COUNT - 1] = '\0';
+	if (!err && strlen(record.name))
+	{
+		device->info.device_name = strdup(record.name);
+		if (!device->info.device_name)
+		{
+			LIBPERROR("Can not get requestet memory for device_name.");
+			err = ME_ERRNO_INTERNAL;
+		}
+	}
+
+	record.description[ME_TOPOLOGY_DESCRIPTION_COUNT - 1] = '\0';
+	if (!err && strlen(record.description))
+	{
+		device->info.device_description = strdup(record.description);
+		if (!device->info.device_description)
+		{
+			LIBPERROR("Can not get requestet memory for device_description.");
+			err = ME_ERRNO_INTERNAL;
+		}
+	}
+
+	if (!err && record.number_subdevices)
+	{
+		device->subdevice_list = calloc(record.number_subdevices, sizeof(me_cfg_subdevice_entry_t*));
+		if (!device->subdevice_list)
+		{
+			LIBPERROR("Can not get requestet memory for subdevice_list structure.\n");
+			err = ME_ERRNO_INTERNAL;
+		}
+	}
+
+	for (cnt = 0; !err && (cnt < record.number_subdevices); )
+	{
+		cur_subdevice = calloc(1, sizeof(me_cfg_subdevice_entry_t));
+		if (cur_subdevice)
+		{
+			device->subdevice_list[cnt] = cur_subdevice;
+
+			err = build_me_drv_topology_subdevice(cur_subdevice, topology, size, offset);
+			cnt++;
+		}
+		else
+		{
+			LIBPERROR("Can not get requestet memory for subdevice_entry.");
+			err = ME_ERRNO_INTERNAL;
+		}
+	}
+	device->subdevice_list_count = cnt;
+
+	return err;
+}
+
+static int build_me_drv_topology_subdevice(me_cfg_subdevice_entry_t* subdevice, char* topology, int size, int* offset)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_topology_subdevice_t record;
+	me_topology_range_t range;
+	me_cfg_range_info_t* cur_range;
+	unsigned int cnt;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	subdevice->info.range_list_count = 0;
+	subdevice->info.range_list = NULL;
+
+	subdevice->extention.type = me_cfg_extention_type_none;
+	subdevice->locked = ME_LOCK_RELEASE;
+
+	if (*offset + sizeof(me_topology_subdevice_t) > size)
+	{
+		LIBPERROR("Topology truncated.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+	memcpy(&record, topology + *offset, sizeof(me_topology_subdevice_t));
+	*offset += sizeof(me_topology_subdevice_t);
+
+	if (*offset + record.number_ranges * sizeof(me_topology_range_t) > size)
+	{
+		LIBPERROR("Topology truncated.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+
+	subdevice->info.type = record.type;
+	subdevice->info.sub_type = record.subtype;
+	subdevice->info.channels = record.number_channels;
+
+	if (record.err_no)
+	{
+		LIBPWARNING("Subdevice: err=%d\n", record.err_no);
+		*offset += record.number_ranges * sizeof(me_topology_range_t);
+		return record.err_no;
+	}
+
+	if (record.number_ranges)
+	{
+		subdevice->info.range_list = calloc(record.number_ranges, sizeof(me_cfg_range_info_t*));
+		if (!subdevice->info.range_list)
+		{
+			LIBPERROR("Can not get requestet memory for range_list.");
+			return ME_ERRNO_INTERNAL;
+		}
+	}
+
+	for (cnt = 0; cnt < record.number_ranges; cnt++)
+	{
+		memcpy(&range, topology + *offset, sizeof(me_topology_range_t));
+		*offset += sizeof(me_topology_range_t);
+
+		cur_range = calloc(1, sizeof(me_cfg_range_info_t));
+		if (!cur_range)
+		{
+			LIBPERROR("Can not get requestet memory for range_entry.");
+			err = ME_ERRNO_INTERNAL;
+			break;
+		}
+		subdevice->info.range_list[cnt] = cur_range;
+
+		cur_range->unit = (enum me_units_type) range.unit;
+		cur_range->min = (double) range.min / 1E6;
+		cur_range->max = (double) range.max / 1E6;
+		cur_range->max_data = range.max_data;
+	}
+	subdevice->info.range_list_count = cnt;
+
+	if (!err)
+	{
+		ConfigQueryCacheFill(subdevice);
+
+		if (record.caps)
+		{
+			subdevice->cache.caps = record.caps;
+			subdevice->cache.valid |= ME_CFG_CACHE_CAPS;
+		}
+
+		for (cnt = 0; (cnt < ME_TOPOLOGY_TIMERS) && (cnt < ME_CFG_CACHE_TIMERS); cnt++)
+		{
+			if (record.timer[cnt].err_no)
+				continue;
+
+			subdevice->cache.timers[cnt].base = record.timer[cnt].base_frequency;
+			subdevice->cache.timers[cnt].min_ticks_low = record.timer[cnt].min_ticks_low;
+			subdevice->cache.timers[cnt].min_ticks_high = record.timer[cnt].min_ticks_high;
+			subdevice->cache.timers[cnt].max_ticks_low = record.timer[cnt].max_ticks_low;
+			subdevice->cache.timers[cnt].max_ticks_high = record.timer[cnt].max_ticks_high;
+			subdevice->cache.valid |= ME_CFG_CACHE_TIMER << cnt;
+		}
+	}
+
+	return err;
+}
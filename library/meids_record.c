@@ -0,0 +1,683 @@
+/* Stream recorder for Meilhaus driver system.
+ * ==========================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE	/* O_DIRECT */
+#endif
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <errno.h>
+# include <syslog.h>
+# include <unistd.h>
+# include <fcntl.h>
+# include <time.h>
+# include <stdint.h>
+# include <pthread.h>
+
+# include "me_error.h"
+# include "me_defines.h"
+# include "meids.h"
+# include "meids_debug.h"
+# include "meids_utility.h"
+# include "medriver.h"
+
+/// Timeout of single read from stream [ms]. Recorder checks stop request after each read.
+# define ME_RECORD_READ_TIMEOUT		100
+
+typedef enum me_record_block_state
+{
+	ME_RECORD_BLOCK_FREE = 0,
+	ME_RECORD_BLOCK_FILLED,
+} me_record_block_state_t;
+
+typedef struct me_record_block
+{
+	meRecordBlockHeader_t* header;	// Aligned memory: header followed by samples.
+	me_record_block_state_t state;
+} me_record_block_t;
+
+typedef struct me_recorder
+{
+	struct me_recorder* next;
+
+	int device;
+	int subdevice;
+	int fd;
+	int channels;
+
+	int block_size;
+	int block_samples;
+	int block_count;
+	me_record_block_t* blocks;
+	int* read_buffer;
+
+	meRecordFileHeader_t* file_header;
+	int header_size;
+
+	pthread_t reader;
+	pthread_t writer;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+
+	// Protected by mutex.
+	int fill_index;		// Next block for reader.
+	int write_index;	// Next block for writer.
+	int queued;
+	int stop;
+	int reader_done;
+	meRecordStatus_t status;
+} me_recorder_t;
+
+static me_recorder_t* recorders = NULL;
+static pthread_mutex_t recorders_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void* recordReaderTask(void* arg);
+static void* recordWriterTask(void* arg);
+static void recordFree(me_recorder_t* recorder);
+
+static uint64_t recordTime(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static me_recorder_t* recordFind(int iDevice, int iSubdevice)
+{/// @note Call with recorders_mutex locked.
+	me_recorder_t* recorder;
+
+	for (recorder = recorders; recorder; recorder = recorder->next)
+	{
+		if ((recorder->device == iDevice) && (recorder->subdevice == iSubdevice))
+			break;
+	}
+
+	return recorder;
+}
+
+static int recordWrite(int fd, void* buffer, size_t size, off_t offset)
+{
+	ssize_t done;
+
+	while (size)
+	{
+		done = pwrite(fd, buffer, size, offset);
+		if (done < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			LIBPERROR("pwrite() failed: %s\n", strerror(errno));
+			return ME_ERRNO_INTERNAL;
+		}
+
+		buffer = (char *)buffer + done;
+		size -= done;
+		offset += done;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static int recordOpen(char* pcPath, int iFlags)
+{
+	int fd = -1;
+
+	if (!(iFlags & ME_RECORD_BUFFERED_IO))
+	{
+		fd = open(pcPath, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+		if ((fd < 0) && (errno == EINVAL))
+		{
+			LIBPWARNING("O_DIRECT not supported for %s. Buffered IO used.\n", pcPath);
+		}
+	}
+
+	if (fd < 0)
+	{
+		fd = open(pcPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+
+	return fd;
+}
+
+int meRecordStart(int iDevice, int iSubdevice, char* pcPath, meRecordOptions_t* pOptions)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_recorder_t* recorder = NULL;
+	me_recorder_t** link;
+	meRecordFileChannel_t* channel;
+	unsigned int max_data;
+	double min;
+	double max;
+	int unit;
+	int i;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (!pcPath || !pOptions || !pOptions->pConfigList)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
+	}
+
+	if (pOptions->iConfigListCount <= 0)
+	{
+		err = ME_ERRNO_INVALID_CONFIG_LIST_COUNT;
+		goto ERROR;
+	}
+
+	if (pOptions->iFlags & ~ME_RECORD_BUFFERED_IO)
+	{
+		err = ME_ERRNO_INVALID_FLAGS;
+		goto ERROR;
+	}
+
+	if ((pOptions->iBlockSize < 0) || (pOptions->iBlockSize % ME_RECORD_ALIGNMENT)
+		|| ((pOptions->iBlockSize > 0) && (pOptions->iBlockSize <= sizeof(meRecordBlockHeader_t)))
+		|| (pOptions->iBlockCount < 0) || (pOptions->iBlockCount == 1))
+	{
+		err = ME_ERRNO_INVALID_VALUE_COUNT;
+		goto ERROR;
+	}
+
+	recorder = calloc(1, sizeof(me_recorder_t));
+	if (!recorder)
+	{
+		err = -ENOMEM;
+		goto ERROR;
+	}
+
+	recorder->device = iDevice;
+	recorder->subdevice = iSubdevice;
+	recorder->fd = -1;
+	recorder->channels = pOptions->iConfigListCount;
+	recorder->block_size = pOptions->iBlockSize ? pOptions->iBlockSize : ME_RECORD_DEFAULT_BLOCK_SIZE;
+	recorder->block_count = pOptions->iBlockCount ? pOptions->iBlockCount : ME_RECORD_DEFAULT_BLOCK_COUNT;
+	recorder->block_samples = (recorder->block_size - sizeof(meRecordBlockHeader_t)) / sizeof(uint16_t);
+	recorder->status.iStatus = ME_STATUS_BUSY;
+
+	// File header: aligned, so that blocks can be written with O_DIRECT.
+	recorder->header_size = sizeof(meRecordFileHeader_t) + recorder->channels * sizeof(meRecordFileChannel_t);
+	recorder->header_size = (recorder->header_size + ME_RECORD_ALIGNMENT - 1) & ~(ME_RECORD_ALIGNMENT - 1);
+	if (posix_memalign((void **)&recorder->file_header, ME_RECORD_ALIGNMENT, recorder->header_size))
+	{
+		err = -ENOMEM;
+		goto ERROR;
+	}
+	memset(recorder->file_header, 0, recorder->header_size);
+
+	memcpy(recorder->file_header->cMagic, ME_RECORD_FILE_MAGIC, sizeof(recorder->file_header->cMagic));
+	recorder->file_header->iVersion = ME_RECORD_FILE_VERSION;
+	recorder->file_header->iHeaderSize = recorder->header_size;
+	recorder->file_header->iBlockSize = recorder->block_size;
+	recorder->file_header->iDevice = iDevice;
+	recorder->file_header->iSubdevice = iSubdevice;
+	recorder->file_header->iChannelCount = recorder->channels;
+	recorder->file_header->dScanRate = pOptions->dScanRate;
+	recorder->file_header->dConvRate = pOptions->dConvRate;
+
+	for (i = 0; i < recorder->channels; i++)
+	{
+		channel = &recorder->file_header->Channels[i];
+		channel->iChannel = pOptions->pConfigList[i].iChannel;
+		channel->iStreamConfig = pOptions->pConfigList[i].iStreamConfig;
+		channel->iRef = pOptions->pConfigList[i].iRef;
+		channel->dCalibrationGain = pOptions->pdCalibrationGain ? pOptions->pdCalibrationGain[i] : 1.0;
+		channel->dCalibrationOffset = pOptions->pdCalibrationOffset ? pOptions->pdCalibrationOffset[i] : 0.0;
+
+		err = ME_QueryRangeInfo(iDevice, iSubdevice, channel->iStreamConfig,
+								&unit, &min, &max, &max_data, ME_QUERY_NO_FLAGS);
+		if (err)
+			goto ERROR;
+
+		channel->iUnit = unit;
+		channel->dMin = min;
+		channel->dMax = max;
+		channel->iMaxData = max_data;
+		if (!max_data || (max_data > 0xFFFF))
+		{// Samples are packed to 16 bits.
+			err = ME_ERRNO_NOT_SUPPORTED;
+			goto ERROR;
+		}
+	}
+
+	recorder->blocks = calloc(recorder->block_count, sizeof(me_record_block_t));
+	recorder->read_buffer = malloc(recorder->block_samples * sizeof(int));
+	if (!recorder->blocks || !recorder->read_buffer)
+	{
+		err = -ENOMEM;
+		goto ERROR;
+	}
+
+	for (i = 0; i < recorder->block_count; i++)
+	{
+		if (posix_memalign((void **)&recorder->blocks[i].header, ME_RECORD_ALIGNMENT, recorder->block_size))
+		{
+			err = -ENOMEM;
+			goto ERROR;
+		}
+	}
+
+	pthread_mutex_lock(&recorders_mutex);
+		if (recordFind(iDevice, iSubdevice))
+		{
+			err = ME_ERRNO_SUBDEVICE_BUSY;
+		}
+		else
+		{
+			recorder->next = recorders;
+			recorders = recorder;
+		}
+	pthread_mutex_unlock(&recorders_mutex);
+	if (err)
+		goto ERROR;
+
+	recorder->fd = recordOpen(pcPath, pOptions->iFlags);
+	if (recorder->fd < 0)
+	{
+		LIBPERROR("Can not open %s: %s\n", pcPath, strerror(errno));
+		err = ME_ERRNO_INTERNAL;
+		goto UNREGISTER;
+	}
+
+	recorder->file_header->ullStartRealtime = recordTime(CLOCK_REALTIME);
+	recorder->file_header->ullStartMonotonic = recordTime(CLOCK_MONOTONIC);
+	err = recordWrite(recorder->fd, recorder->file_header, recorder->header_size, 0);
+	if (err)
+		goto UNREGISTER;
+
+	pthread_mutex_init(&recorder->mutex, NULL);
+	pthread_cond_init(&recorder->cond, NULL);
+
+	if (pthread_create(&recorder->writer, NULL, recordWriterTask, recorder))
+	{
+		err = ME_ERRNO_START_THREAD;
+		goto DESTROY;
+	}
+
+	if (pthread_create(&recorder->reader, NULL, recordReaderTask, recorder))
+	{
+		pthread_mutex_lock(&recorder->mutex);
+			recorder->stop = 1;
+			recorder->reader_done = 1;
+			pthread_cond_broadcast(&recorder->cond);
+		pthread_mutex_unlock(&recorder->mutex);
+		pthread_join(recorder->writer, NULL);
+
+		err = ME_ERRNO_START_THREAD;
+		goto DESTROY;
+	}
+
+	return ME_ERRNO_SUCCESS;
+
+DESTROY:
+	pthread_cond_destroy(&recorder->cond);
+	pthread_mutex_destroy(&recorder->mutex);
+
+UNREGISTER:
+	pthread_mutex_lock(&recorders_mutex);
+		for (link = &recorders; *link; link = &(*link)->next)
+		{
+			if (*link == recorder)
+			{
+				*link = recorder->next;
+				break;
+			}
+		}
+	pthread_mutex_unlock(&recorders_mutex);
+
+ERROR:
+	if (recorder)
+		recordFree(recorder);
+
+	ME_SetErrno("meRecordStart()", err);
+
+	return err;
+}
+
+static void recordFree(me_recorder_t* recorder)
+{
+	int i;
+
+	if (recorder->fd >= 0)
+		close(recorder->fd);
+
+	if (recorder->blocks)
+	{
+		for (i = 0; i < recorder->block_count; i++)
+		{
+			free(recorder->blocks[i].header);
+		}
+		free(recorder->blocks);
+	}
+
+	free(recorder->read_buffer);
+	free(recorder->file_header);
+	free(recorder);
+}
+
+static void recordQueueBlock(me_recorder_t* recorder, meRecordBlockHeader_t* header)
+{
+	pthread_mutex_lock(&recorder->mutex);
+		recorder->blocks[recorder->fill_index].state = ME_RECORD_BLOCK_FILLED;
+		recorder->fill_index = (recorder->fill_index + 1) % recorder->block_count;
+		recorder->queued++;
+		if (recorder->queued > recorder->status.iQueueHighWater)
+			recorder->status.iQueueHighWater = recorder->queued;
+		pthread_cond_broadcast(&recorder->cond);
+	pthread_mutex_unlock(&recorder->mutex);
+}
+
+static int recordRead(me_recorder_t* recorder, int* count)
+{/// @note Timeout is not an error (values read so far are returned). End of stream is ME_ERRNO_SUBDEVICE_NOT_RUNNING.
+	int err;
+
+	err = ME_StreamRead(recorder->device, recorder->subdevice, ME_READ_MODE_BLOCKING,
+						recorder->read_buffer, count, ME_RECORD_READ_TIMEOUT, ME_IO_STREAM_READ_NO_FLAGS);
+	switch (err)
+	{
+		case ME_ERRNO_SUCCESS:
+		case ME_ERRNO_TIMEOUT:
+			return ME_ERRNO_SUCCESS;
+
+		case ME_ERRNO_SUBDEVICE_NOT_RUNNING:
+		case ME_ERRNO_CANCELLED:
+			// Finite stream finished or stream stopped by application.
+			LIBPINFO("Recorder: end of stream (device=%d, subdevice=%d).\n", recorder->device, recorder->subdevice);
+			return ME_ERRNO_SUBDEVICE_NOT_RUNNING;
+
+		default:
+			LIBPERROR("Recorder: ME_StreamRead(device=%d, subdevice=%d)=%d\n", recorder->device, recorder->subdevice, err);
+			return err;
+	}
+}
+
+static void* recordReaderTask(void* arg)
+{/// @note When no block is free (disk is too slow) data is read anyway and dropped, so driver's buffer does not overflow.
+ /// Free block is checked again after every read, so only values read while no block was free are dropped. All of them are counted.
+	me_recorder_t* recorder = arg;
+	meRecordBlockHeader_t* header;
+	uint16_t* samples;
+	uint64_t sample_index = 0;
+	uint64_t dropped = 0;
+	unsigned int sequence = 0;
+	int stop = 0;
+	int filled;
+	int count;
+	int err = ME_ERRNO_SUCCESS;
+	int i;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	do
+	{
+		pthread_mutex_lock(&recorder->mutex);
+			header = (recorder->blocks[recorder->fill_index].state == ME_RECORD_BLOCK_FREE) ? recorder->blocks[recorder->fill_index].header : NULL;
+		pthread_mutex_unlock(&recorder->mutex);
+
+		filled = 0;
+		samples = header ? (uint16_t *)(header + 1) : NULL;
+
+		while (filled < recorder->block_samples)
+		{
+			pthread_mutex_lock(&recorder->mutex);
+				stop = recorder->stop;
+			pthread_mutex_unlock(&recorder->mutex);
+			if (stop)
+				break;
+
+			count = recorder->block_samples - filled;
+			err = recordRead(recorder, &count);
+
+			if ((count > 0) && samples)
+			{
+				if (!filled)
+					header->ullTimeFirst = recordTime(CLOCK_MONOTONIC);
+
+				for (i = 0; i < count; i++)
+				{
+					samples[filled + i] = recorder->read_buffer[i];
+				}
+				filled += count;
+			}
+			else if (count > 0)
+			{
+				pthread_mutex_lock(&recorder->mutex);
+					if (!dropped)
+						recorder->status.ullDroppedBlocks++;
+					recorder->status.ullDroppedSamples += count;
+				pthread_mutex_unlock(&recorder->mutex);
+
+				dropped += count;
+				sample_index += count;
+			}
+
+			if (err || !samples)
+				break;
+		}
+
+		if (filled)
+		{
+			header->uiMagic = ME_RECORD_BLOCK_MAGIC;
+			header->uiSequence = sequence++;
+			header->uiSampleCount = filled;
+			header->uiReserved = 0;
+			header->ullFirstSample = sample_index;
+			header->ullDroppedBefore = dropped;
+			header->ullTimeLast = recordTime(CLOCK_MONOTONIC);
+			header->ullReserved[0] = 0;
+			header->ullReserved[1] = 0;
+
+			// Partial block (end of recording): rest is cleared. Size of blocks stays constant.
+			memset(samples + filled, 0, (recorder->block_samples - filled) * sizeof(uint16_t));
+
+			recordQueueBlock(recorder, header);
+
+			sample_index += filled;
+			dropped = 0;
+		}
+
+		if (err == ME_ERRNO_SUBDEVICE_NOT_RUNNING)
+		{// End of stream is normal end of recording.
+			err = ME_ERRNO_SUCCESS;
+			stop = 1;
+		}
+	}
+	while (!stop && !err);
+
+	pthread_mutex_lock(&recorder->mutex);
+		if (err && !recorder->status.iErrno)
+			recorder->status.iErrno = err;
+		recorder->reader_done = 1;
+		pthread_cond_broadcast(&recorder->cond);
+	pthread_mutex_unlock(&recorder->mutex);
+
+	return NULL;
+}
+
+static void* recordWriterTask(void* arg)
+{
+	me_recorder_t* recorder = arg;
+	meRecordBlockHeader_t* header;
+	off_t offset = recorder->header_size;
+	uint64_t start;
+	uint64_t time = 0;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	for (;;)
+	{
+		pthread_mutex_lock(&recorder->mutex);
+			while (!recorder->queued && !recorder->reader_done)
+			{
+				pthread_cond_wait(&recorder->cond, &recorder->mutex);
+			}
+
+			if (!recorder->queued)
+			{
+				pthread_mutex_unlock(&recorder->mutex);
+				break;
+			}
+
+			header = recorder->blocks[recorder->write_index].header;
+		pthread_mutex_unlock(&recorder->mutex);
+
+		if (!err)
+		{
+			start = recordTime(CLOCK_MONOTONIC);
+			err = recordWrite(recorder->fd, header, recorder->block_size, offset);
+			time = recordTime(CLOCK_MONOTONIC) - start;
+			offset += recorder->block_size;
+		}
+
+		pthread_mutex_lock(&recorder->mutex);
+			if (!err)
+			{
+				if (!recorder->status.ullBlocks || (time < recorder->status.ullWriteTimeMin))
+					recorder->status.ullWriteTimeMin = time;
+				if (time > recorder->status.ullWriteTimeMax)
+					recorder->status.ullWriteTimeMax = time;
+				recorder->status.ullWriteTimeTotal += time;
+				recorder->status.ullBlocks++;
+				recorder->status.ullSamples += header->uiSampleCount;
+			}
+			else
+			{// Disk error: recording is stopped, queued data is lost.
+				if (!recorder->status.iErrno)
+					recorder->status.iErrno = err;
+				recorder->stop = 1;
+			}
+
+			recorder->blocks[recorder->write_index].state = ME_RECORD_BLOCK_FREE;
+			recorder->write_index = (recorder->write_index + 1) % recorder->block_count;
+			recorder->queued--;
+		pthread_mutex_unlock(&recorder->mutex);
+	}
+
+	return NULL;
+}
+
+int meRecordStatus(int iDevice, int iSubdevice, meRecordStatus_t* pStatus)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_recorder_t* recorder;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (!pStatus)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
+	}
+
+	pthread_mutex_lock(&recorders_mutex);
+		recorder = recordFind(iDevice, iSubdevice);
+		if (recorder)
+		{
+			pthread_mutex_lock(&recorder->mutex);
+				*pStatus = recorder->status;
+				if (recorder->reader_done)
+					pStatus->iStatus = pStatus->iErrno ? ME_STATUS_ERROR : ME_STATUS_IDLE;
+			pthread_mutex_unlock(&recorder->mutex);
+		}
+		else
+		{
+			err = ME_ERRNO_SUBDEVICE_NOT_RUNNING;
+		}
+	pthread_mutex_unlock(&recorders_mutex);
+
+ERROR:
+	ME_SetErrno("meRecordStatus()", err);
+
+	return err;
+}
+
+int meRecordStop(int iDevice, int iSubdevice, meRecordStatus_t* pStatus)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_recorder_t* recorder;
+	me_recorder_t** link;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	pthread_mutex_lock(&recorders_mutex);
+		recorder = NULL;
+		for (link = &recorders; *link; link = &(*link)->next)
+		{
+			if (((*link)->device == iDevice) && ((*link)->subdevice == iSubdevice))
+			{
+				recorder = *link;
+				*link = recorder->next;
+				break;
+			}
+		}
+	pthread_mutex_unlock(&recorders_mutex);
+
+	if (!recorder)
+	{
+		err = ME_ERRNO_SUBDEVICE_NOT_RUNNING;
+		goto ERROR;
+	}
+
+	pthread_mutex_lock(&recorder->mutex);
+		recorder->stop = 1;
+	pthread_mutex_unlock(&recorder->mutex);
+
+	pthread_join(recorder->reader, NULL);
+	pthread_join(recorder->writer, NULL);
+
+	// Final header: totals.
+	recorder->file_header->ullBlocks = recorder->status.ullBlocks;
+	recorder->file_header->ullSamples = recorder->status.ullSamples;
+	recorder->file_header->ullDroppedSamples = recorder->status.ullDroppedSamples;
+	recorder->file_header->iErrno = recorder->status.iErrno;
+	err = recordWrite(recorder->fd, recorder->file_header, recorder->header_size, 0);
+	if (!err && fsync(recorder->fd))
+	{
+		LIBPERROR("fsync() failed: %s\n", strerror(errno));
+		err = ME_ERRNO_INTERNAL;
+	}
+
+	recorder->status.iStatus = recorder->status.iErrno ? ME_STATUS_ERROR : ME_STATUS_IDLE;
+	if (!err)
+		err = recorder->status.iErrno;
+
+	if (pStatus)
+		*pStatus = recorder->status;
+
+	pthread_cond_destroy(&recorder->cond);
+	pthread_mutex_destroy(&recorder->mutex);
+	recordFree(recorder);
+
+ERROR:
+	ME_SetErrno("meRecordStop()", err);
+
+	return err;
+}
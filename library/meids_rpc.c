@@ -50,6 +50,7 @@
 # include "meids_structs.h"
 
 # include "meids_rpc_calls.h"
+# include "meids_rpc_batch.h"
 # include "meids_rpc_config.h"
 
 # include "meids_vrt.h"
@@ -623,6 +624,11 @@ int ME_QuerySubdeviceTimer(int device, int subdevice,
 	return ME_virtual_QuerySubdeviceTimer(RPC_Config, device, subdevice, timer, base, min_ticks_low, min_ticks_high, max_ticks_low, max_ticks_high, iFlags);
 }
 
+int ME_QueryLatencyProbe(int device, int subdevice, meLatencyProbe_t* probe, int iFlags)
+{
+	return ME_virtual_QueryLatencyProbe(RPC_Config, device, subdevice, probe, iFlags);
+}
+
 
 //Input/Output
 int ME_IrqStart(int device, int subdevice, int channel, int source, int edge, int arg, int iFlags)
@@ -720,6 +726,11 @@ int ME_StreamStatus(int device, int subdevice, int wait, int* status, int* count
 	return ME_virtual_StreamStatus(RPC_Config, device, subdevice, wait, status, count, iFlags);
 }
 
+int ME_StreamReader(int device, int subdevice, int mode, int policy, int* dropped, int iFlags)
+{
+	return ME_virtual_StreamReader(RPC_Config, device, subdevice, mode, policy, dropped, iFlags);
+}
+
 int ME_StreamStop(int device, int subdevice, int mode, int timeout, int iFlags)
 {
 	return ME_virtual_StreamStop(RPC_Config, device, subdevice, mode, timeout, iFlags);
@@ -764,6 +775,21 @@ int  ME_SetOffset(int device, int subdevice, int channel, int range, double* off
 	return ME_virtual_SetOffset(RPC_Config, device, subdevice, channel, range, offset, iFlags);
 }
 
+int  ME_BatchBegin(int iFlags)
+{
+	return BatchBegin_RPC(iFlags);
+}
+
+int  ME_BatchCommit(int* index, int iFlags)
+{
+	return BatchCommit_RPC(index, iFlags);
+}
+
+int  ME_BatchAbort(int iFlags)
+{
+	return BatchAbort_RPC(iFlags);
+}
+
 
 void ME_ConfigPrint(void)
 {
@@ -814,6 +840,7 @@ static int rpc_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->QueryRangeInfo			= QueryRangeInfo_RPC;
 	(*context_calls)->QueryRangeByMinMax		= QueryRangeByMinMax_RPC;
 	(*context_calls)->QuerySubdeviceTimer		= QuerySubdeviceTimer_RPC;
+	(*context_calls)->QueryLatencyProbe			= QueryLatencyProbe_RPC;
 
 //Input/Output
 	(*context_calls)->IrqStart					= IrqStart_RPC;
@@ -839,6 +866,7 @@ static int rpc_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->StreamStart				= StreamStart_RPC;
 	(*context_calls)->StreamStartList			= StreamStartList_RPC;
 	(*context_calls)->StreamStatus				= StreamStatus_RPC;
+	(*context_calls)->StreamReader				= StreamReader_RPC;
 	(*context_calls)->StreamStop				= StreamStop_RPC;
 	(*context_calls)->StreamStopList			= StreamStopList_RPC;
 
@@ -25,45 +25,211 @@
 #endif	//__KERNEL__
 
 # include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <time.h>
+# include <pthread.h>
 
 # include "me_error.h"
+# include "me_structs.h"
 # include "rmedriver.h"
 
 # include "meids_rpc_RQuery.h"
 
-/// Functions to query a remote driver system. No context mode. They are only to use in MEiDC.
+/// Connections are kept open between calls. Every query costs one round trip instead of connect, open, query and close.
+typedef struct rquery_connection
+{
+	struct rquery_connection* next;
 
-int meRQueryDescriptionDevice(	char* host, int iDevice,
-								char* pcDescription, int iCount)
+	char* host;
+	CLIENT* clnt;			// Opened with me_open_proc_1().
+	time_t used;			// Time of return to pool.
+} rquery_connection_t;
+
+static rquery_connection_t* rquery_pool = NULL;
+static pthread_mutex_t rquery_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void rquery_disconnect(CLIENT* clnt)
 {
 	int flags = ME_VALUE_NOT_USED;
-	CLIENT* clnt = NULL;
-	int* rpc_err = NULL;
-	me_query_description_device_res* result = NULL;
+	int* rpc_err;
+
+	rpc_err = me_close_proc_1(&flags, clnt);
+	if (rpc_err)
+	{
+		free(rpc_err);
+	}
+
+	clnt_destroy(clnt);
+}
+
+static void rquery_free_list(rquery_connection_t* list)
+{
+	rquery_connection_t* connection;
+
+	while (list)
+	{
+		connection = list;
+		list = list->next;
+
+		rquery_disconnect(connection->clnt);
+		free(connection->host);
+		free(connection);
+	}
+}
+
+/// Takes idle connection to host from pool or opens a new one. Timeout is in ms.
+static int rquery_connect(const char* host, int timeout, CLIENT** clnt)
+{
+	int flags = ME_VALUE_NOT_USED;
+	int* rpc_err;
+	rquery_connection_t* expired = NULL;
+	rquery_connection_t* connection = NULL;
+	rquery_connection_t** link;
+	struct timeval tv;
+	time_t now = time(NULL);
 	int err = ME_ERRNO_SUCCESS;
 
-	if (iCount <= 0)
+	if (!host)
 	{
-		return ME_ERRNO_USER_BUFFER_SIZE;
+		return ME_ERRNO_INVALID_POINTER;
+	}
+
+	*clnt = NULL;
+
+	pthread_mutex_lock(&rquery_pool_mutex);
+		link = &rquery_pool;
+		while (*link)
+		{
+			if (now - (*link)->used > ME_RQUERY_POOL_IDLE)
+			{// Server may have dropped it already.
+				connection = *link;
+				*link = connection->next;
+				connection->next = expired;
+				expired = connection;
+			}
+			else if (!*clnt && !strcmp((*link)->host, host))
+			{
+				connection = *link;
+				*link = connection->next;
+				*clnt = connection->clnt;
+				free(connection->host);
+				free(connection);
+			}
+			else
+			{
+				link = &(*link)->next;
+			}
+		}
+	pthread_mutex_unlock(&rquery_pool_mutex);
+
+	rquery_free_list(expired);
+
+	if (!*clnt)
+	{
+		*clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
+		if (!*clnt)
+		{
+			return ME_ERRNO_CONNECT_REMOTE;
+		}
+
+		rpc_err = me_open_proc_1(&flags, *clnt);
+		if (!rpc_err)
+		{
+			err = ME_ERRNO_COMMUNICATION;
+		}
+		else
+		{
+			err = *rpc_err;
+			free(rpc_err);
+		}
+
+		if (err)
+		{
+			clnt_destroy(*clnt);
+			*clnt = NULL;
+			return err;
+		}
 	}
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
+	tv.tv_sec = timeout / 1000;
+	tv.tv_usec = (timeout % 1000) * 1000;
+	clnt_control(*clnt, CLSET_TIMEOUT, (char *)&tv);
+
+	return err;
+}
+
+/// Returns connection to pool. Broken connections (ME_ERRNO_COMMUNICATION) are closed.
+static void rquery_release(const char* host, CLIENT* clnt, int err)
+{
+	rquery_connection_t* connection;
+	rquery_connection_t* cur;
+	int count = 0;
+
+	if (err == ME_ERRNO_COMMUNICATION)
 	{
-		return ME_ERRNO_CONNECT_REMOTE;
+		clnt_destroy(clnt);
+		return;
 	}
 
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
+	connection = calloc(1, sizeof(rquery_connection_t));
+	if (connection)
 	{
-		err = ME_ERRNO_COMMUNICATION;
+		connection->host = strdup(host);
 	}
-	else
+
+	if (!connection || !connection->host)
 	{
-		err = *rpc_err;
-		free(rpc_err);
+		free(connection);
+		rquery_disconnect(clnt);
+		return;
+	}
+
+	connection->clnt = clnt;
+	connection->used = time(NULL);
+
+	pthread_mutex_lock(&rquery_pool_mutex);
+		for (cur = rquery_pool; cur; cur = cur->next)
+		{
+			if (!strcmp(cur->host, host))
+				count++;
+		}
+
+		if (count < ME_RQUERY_POOL_SIZE)
+		{
+			connection->next = rquery_pool;
+			rquery_pool = connection;
+			connection = NULL;
+		}
+	pthread_mutex_unlock(&rquery_pool_mutex);
+
+	if (connection)
+	{// Pool for this host is full.
+		rquery_free_list(connection);
+	}
+}
+
+static void rquery_pool_destructor(void) __attribute__((destructor));
+static void rquery_pool_destructor(void)
+{
+	meRQueryClose(NULL);
+}
+
+/// Functions to query a remote driver system. No context mode. They are only to use in MEiDC.
+
+int meRQueryDescriptionDevice(	char* host, int iDevice,
+								char* pcDescription, int iCount)
+{
+	CLIENT* clnt = NULL;
+	me_query_description_device_res* result = NULL;
+	int err = ME_ERRNO_SUCCESS;
+
+	if (iCount <= 0)
+	{
+		return ME_ERRNO_USER_BUFFER_SIZE;
 	}
 
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		result = me_query_description_device_proc_1(&iDevice, clnt);
@@ -87,20 +253,9 @@ int meRQueryDescriptionDevice(	char* host, int iDevice,
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
-		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
-		}
-
-		if (rpc_err)
-		{
-			free(rpc_err);
-		}
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
-
 	return err;
 }
 
@@ -110,30 +265,11 @@ int meRQueryInfoDevice(	char* host, int iDevice,
 						int* piBusType, int* piBusNo, int* piDevNo, int* piFuncNo,
 						int* piPlugged)
 {
-	int flags = ME_VALUE_NOT_USED;
-	int* rpc_err = NULL;
 	CLIENT* clnt = NULL;
 	me_query_info_device_res* result = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
-	{
-		return ME_ERRNO_CONNECT_REMOTE;
-
-	}
-
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
-	{
-		err = ME_ERRNO_COMMUNICATION;
-	}
-	else
-	{
-		err = *rpc_err;
-		free(rpc_err);
-	}
-
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		result = me_query_info_device_proc_1(&iDevice, clnt);
@@ -158,28 +294,15 @@ int meRQueryInfoDevice(	char* host, int iDevice,
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
-		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
-		}
-
-		if (rpc_err)
-		{
-			free(rpc_err);
-		}
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
-
 	return err;
 }
 
 int meRQueryNameDevice(	char* host, int iDevice,
 						char* pcName, int iCount)
 {
-	int flags = ME_VALUE_NOT_USED;
-	int* rpc_err = NULL;
 	CLIENT* clnt = NULL;
 	me_query_name_device_res* result = NULL;
 	int err = ME_ERRNO_SUCCESS;
@@ -189,23 +312,7 @@ int meRQueryNameDevice(	char* host, int iDevice,
 		return ME_ERRNO_USER_BUFFER_SIZE;
 	}
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
-	{
-		return ME_ERRNO_CONNECT_REMOTE;
-	}
-
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
-	{
-		err = ME_ERRNO_COMMUNICATION;
-	}
-	else
-	{
-		err = *rpc_err;
-		free(rpc_err);
-	}
-
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		result = me_query_name_device_proc_1(&iDevice, clnt);
@@ -229,48 +336,19 @@ int meRQueryNameDevice(	char* host, int iDevice,
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
-		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
-		}
-
-		if (rpc_err)
-		{
-			free(rpc_err);
-		}
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
-
 	return err;
 }
 
 int meRQueryNumberDevices(char* host, int* piNumber)
 {
-	int flags = ME_VALUE_NOT_USED;
 	CLIENT* clnt = NULL;
-	int* rpc_err = NULL;
 	me_query_number_devices_res* result = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
-	{
-		return ME_ERRNO_CONNECT_REMOTE;
-	}
-
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
-	{
-		err = ME_ERRNO_COMMUNICATION;
-	}
-	else
-	{
-		err = *rpc_err;
-		free(rpc_err);
-	}
-
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		result = me_query_number_devices_proc_1(NULL, clnt);
@@ -287,49 +365,20 @@ int meRQueryNumberDevices(char* host, int* piNumber)
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
-		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
-		}
-
-		if (rpc_err)
-		{
-			free(rpc_err);
-		}
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
-
 	return err;
 }
 
 int meRQueryNumberSubdevices(	char* host, int iDevice,
 								int* piNumber)
 {
-	int flags = ME_VALUE_NOT_USED;
 	CLIENT* clnt = NULL;
-	int* rpc_err = NULL;
 	me_query_number_subdevices_res* result = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
-	{
-		return ME_ERRNO_CONNECT_REMOTE;
-	}
-
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
-	{
-		err = ME_ERRNO_COMMUNICATION;
-	}
-	else
-	{
-		err = *rpc_err;
-		free(rpc_err);
-	}
-
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		result = me_query_number_subdevices_proc_1(&iDevice, clnt);
@@ -346,50 +395,21 @@ int meRQueryNumberSubdevices(	char* host, int iDevice,
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
-		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
-		}
-
-		if (rpc_err)
-		{
-			free(rpc_err);
-		}
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
-
 	return err;
 }
 
 int meRQueryNumberChannels(	char* host, int iDevice, int iSubdevice,
 							int* piNumber)
 {
-	int flags = ME_VALUE_NOT_USED;
 	CLIENT* clnt = NULL;
-	int* rpc_err = NULL;
 	me_query_number_channels_params query_params;
 	me_query_number_channels_res* result = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
-	{
-		return ME_ERRNO_CONNECT_REMOTE;
-	}
-
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
-	{
-		err = ME_ERRNO_COMMUNICATION;
-	}
-	else
-	{
-		err = *rpc_err;
-		free(rpc_err);
-	}
-
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		query_params.device = iDevice;
@@ -409,50 +429,21 @@ int meRQueryNumberChannels(	char* host, int iDevice, int iSubdevice,
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
-		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
-		}
-
-		if (rpc_err)
-		{
-			free(rpc_err);
-		}
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
-
 	return err;
 }
 
 int meRQueryNumberRanges(	char* host, int iDevice, int iSubdevice,
 							int iUnit, int* piNumber)
 {
-	int flags = ME_VALUE_NOT_USED;
 	CLIENT* clnt = NULL;
-	int* rpc_err = NULL;
 	me_query_number_ranges_params query_params;
 	me_query_number_ranges_res* result = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
-	{
-		return ME_ERRNO_CONNECT_REMOTE;
-	}
-
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
-	{
-		err = ME_ERRNO_COMMUNICATION;
-	}
-	else
-	{
-		err = *rpc_err;
-		free(rpc_err);
-	}
-
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		query_params.device = iDevice;
@@ -473,50 +464,21 @@ int meRQueryNumberRanges(	char* host, int iDevice, int iSubdevice,
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
-		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
-		}
-
-		if (rpc_err)
-		{
-			free(rpc_err);
-		}
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
-
 	return err;
 }
 
 int meRQueryRangeInfo(	char* host, int iDevice, int iSubdevice, int iRange,
 						int* piUnit, double* pdMin, double* pdMax, int* piMaxData)
 {
-	int flags = ME_VALUE_NOT_USED;
 	CLIENT* clnt = NULL;
-	int* rpc_err = NULL;
 	me_query_range_info_params query_params;
 	me_query_range_info_res* result = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
-	{
-		return ME_ERRNO_CONNECT_REMOTE;
-	}
-
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
-	{
-		err = ME_ERRNO_COMMUNICATION;
-	}
-	else
-	{
-		err = *rpc_err;
-		free(rpc_err);
-	}
-
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		query_params.device = iDevice;
@@ -540,50 +502,21 @@ int meRQueryRangeInfo(	char* host, int iDevice, int iSubdevice, int iRange,
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
-		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
-		}
-
-		if (rpc_err)
-		{
-			free(rpc_err);
-		}
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
-
 	return err;
 }
 
 int meRQuerySubdeviceType(	char* host, int iDevice, int iSubdevice,
 							int* piType, int* piSubtype)
 {
-	int flags = ME_VALUE_NOT_USED;
 	CLIENT* clnt = NULL;
-	int* rpc_err = NULL;
 	me_query_subdevice_type_params query_params;
 	me_query_subdevice_type_res* result = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	clnt = clnt_create(host, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
-	if (!clnt)
-	{
-		return ME_ERRNO_CONNECT_REMOTE;
-	}
-
-	rpc_err = me_open_proc_1(&flags, clnt);
-	if (!rpc_err)
-	{
-		err = ME_ERRNO_COMMUNICATION;
-	}
-	else
-	{
-		err = *rpc_err;
-		free(rpc_err);
-	}
-
+	err = rquery_connect(host, ME_RQUERY_TIMEOUT, &clnt);
 	if (!err)
 	{
 		query_params.device = iDevice;
@@ -604,19 +537,439 @@ int meRQuerySubdeviceType(	char* host, int iDevice, int iSubdevice,
 			free(result);
 		}
 
-		rpc_err = me_close_proc_1(&flags, clnt);
-		if (!err)
+		rquery_release(host, clnt, err);
+	}
+
+	return err;
+}
+
+int meRQueryClose(char* host)
+{
+	rquery_connection_t* closed = NULL;
+	rquery_connection_t* connection;
+	rquery_connection_t** link;
+
+	pthread_mutex_lock(&rquery_pool_mutex);
+		link = &rquery_pool;
+		while (*link)
 		{
-			err = (!rpc_err) ? ME_ERRNO_COMMUNICATION : *rpc_err;
+			if (!host || !strcmp((*link)->host, host))
+			{
+				connection = *link;
+				*link = connection->next;
+				connection->next = closed;
+				closed = connection;
+			}
+			else
+			{
+				link = &(*link)->next;
+			}
+		}
+	pthread_mutex_unlock(&rquery_pool_mutex);
+
+	rquery_free_list(closed);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+/// Serializes RPC topology to ME_TOPOLOGY snapshot (me_structs.h). Returns needed size. Buffer is filled only when it is big enough.
+static int rquery_topology_pack(me_query_topology_res* topology, char* buffer, int size)
+{
+	me_topology_header_t header;
+	me_topology_device_t device;
+	me_topology_subdevice_t subdevice;
+	me_topology_range_t range;
+	me_topology_device_res* device_res;
+	me_topology_subdevice_res* subdevice_res;
+	me_query_range_info_res* range_res;
+	unsigned int i, s, r, t;
+	int needed;
+	char* pos;
+
+	needed = sizeof(me_topology_header_t);
+	for (i = 0; i < topology->devices.devices_len; i++)
+	{
+		device_res = &topology->devices.devices_val[i];
+		needed += sizeof(me_topology_device_t);
+		for (s = 0; s < device_res->subdevices.subdevices_len; s++)
+		{
+			needed += sizeof(me_topology_subdevice_t);
+			needed += device_res->subdevices.subdevices_val[s].ranges.ranges_len * sizeof(me_topology_range_t);
+		}
+	}
+
+	if (!buffer || (size < needed))
+	{
+		return needed;
+	}
+
+	pos = buffer;
+
+	header.magic = ME_TOPOLOGY_MAGIC;
+	header.version = ME_TOPOLOGY_VERSION;
+	header.size = needed;
+	header.number_devices = topology->devices.devices_len;
+	memcpy(pos, &header, sizeof(me_topology_header_t));
+	pos += sizeof(me_topology_header_t);
+
+	for (i = 0; i < topology->devices.devices_len; i++)
+	{
+		device_res = &topology->devices.devices_val[i];
+
+		memset(&device, 0, sizeof(me_topology_device_t));
+		device.err_no = device_res->info.error;
+		device.vendor_id = device_res->info.vendor_id;
+		device.device_id = device_res->info.device_id;
+		device.serial_no = device_res->info.serial_no;
+		device.bus_type = device_res->info.bus_type;
+		device.bus_no = device_res->info.bus_no;
+		device.dev_no = device_res->info.dev_no;
+		device.func_no = device_res->info.func_no;
+		device.plugged = device_res->info.plugged;
+		device.version = device_res->driver_version;
+		if (device_res->name)
+			strncpy(device.name, device_res->name, ME_TOPOLOGY_NAME_COUNT - 1);
+		if (device_res->description)
+			strncpy(device.description, device_res->description, ME_TOPOLOGY_DESCRIPTION_COUNT - 1);
+		if (device_res->driver_name)
+			strncpy(device.driver_name, device_res->driver_name, ME_TOPOLOGY_NAME_COUNT - 1);
+		device.number_subdevices = device_res->subdevices.subdevices_len;
+		memcpy(pos, &device, sizeof(me_topology_device_t));
+		pos += sizeof(me_topology_device_t);
+
+		for (s = 0; s < device_res->subdevices.subdevices_len; s++)
+		{
+			subdevice_res = &device_res->subdevices.subdevices_val[s];
+
+			memset(&subdevice, 0, sizeof(me_topology_subdevice_t));
+			subdevice.err_no = subdevice_res->error;
+			subdevice.type = subdevice_res->type;
+			subdevice.subtype = subdevice_res->subtype;
+			subdevice.number_channels = subdevice_res->channels;
+			subdevice.caps = subdevice_res->caps;
+			for (t = 0; t < ME_TOPOLOGY_TIMERS; t++)
+			{
+				if (t < subdevice_res->timers.timers_len)
+				{
+					subdevice.timer[t].err_no = subdevice_res->timers.timers_val[t].error;
+					subdevice.timer[t].base_frequency = subdevice_res->timers.timers_val[t].base_frequency;
+					subdevice.timer[t].min_ticks_low = subdevice_res->timers.timers_val[t].min_ticks_low;
+					subdevice.timer[t].min_ticks_high = subdevice_res->timers.timers_val[t].min_ticks_high;
+					subdevice.timer[t].max_ticks_low = subdevice_res->timers.timers_val[t].max_ticks_low;
+					subdevice.timer[t].max_ticks_high = subdevice_res->timers.timers_val[t].max_ticks_high;
+				}
+				else
+				{
+					subdevice.timer[t].err_no = ME_ERRNO_INVALID_TIMER;
+				}
+			}
+			subdevice.number_ranges = subdevice_res->ranges.ranges_len;
+			memcpy(pos, &subdevice, sizeof(me_topology_subdevice_t));
+			pos += sizeof(me_topology_subdevice_t);
+
+			for (r = 0; r < subdevice_res->ranges.ranges_len; r++)
+			{
+				range_res = &subdevice_res->ranges.ranges_val[r];
+
+				range.unit = range_res->unit;
+				range.min = (int)(range_res->min * 1E6 + ((range_res->min < 0) ? -0.5 : 0.5));
+				range.max = (int)(range_res->max * 1E6 + ((range_res->max < 0) ? -0.5 : 0.5));
+				range.max_data = range_res->max_data;
+				memcpy(pos, &range, sizeof(me_topology_range_t));
+				pos += sizeof(me_topology_range_t);
+			}
 		}
+	}
+
+	return needed;
+}
+
+/// Whole remote topology in one round trip. Result has to be released with rquery_topology_free().
+static int rquery_topology(const char* host, int timeout, me_query_topology_res** topology)
+{
+	CLIENT* clnt = NULL;
+	me_query_topology_res* result = NULL;
+	int err;
 
-		if (rpc_err)
+	*topology = NULL;
+
+	err = rquery_connect(host, timeout, &clnt);
+	if (!err)
+	{
+		result = me_query_topology_proc_1(NULL, clnt);
+		if (!result)
+		{// Also older servers, that don't know this procedure.
+			err = ME_ERRNO_COMMUNICATION;
+		}
+		else
 		{
-			free(rpc_err);
+			err = result->error;
+			*topology = result;
 		}
+
+		rquery_release(host, clnt, err);
 	}
 
-	clnt_destroy(clnt);
+	return err;
+}
+
+static void rquery_topology_free(me_query_topology_res* topology)
+{
+	if (topology)
+	{
+		xdr_free((xdrproc_t) xdr_me_query_topology_res, (char *)topology);
+		free(topology);
+	}
+}
+
+int meRQueryTopology(char* host, char* pcBuffer, int* piSize)
+{
+	me_query_topology_res* topology = NULL;
+	int size;
+	int err;
+
+	if (!piSize)
+	{
+		return ME_ERRNO_INVALID_POINTER;
+	}
+
+	err = rquery_topology(host, ME_RQUERY_TIMEOUT, &topology);
+	if (!err)
+	{
+		size = rquery_topology_pack(topology, pcBuffer, *piSize);
+		if (!pcBuffer || (size > *piSize))
+		{
+			err = ME_ERRNO_USER_BUFFER_SIZE;
+		}
+		*piSize = size;
+	}
+
+	rquery_topology_free(topology);
 
 	return err;
 }
+
+/// Parallel discovery. Workers can outlive meRQueryDiscover(), so the shared block is released by the last user.
+typedef struct rquery_discovery rquery_discovery_t;
+
+typedef struct rquery_discovery_job
+{
+	rquery_discovery_t* discovery;
+	pthread_t thread;
+
+	char* host;
+	int timeout;
+	int done;
+
+	int err;
+	char* topology;
+	int size;
+} rquery_discovery_job_t;
+
+struct rquery_discovery
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t done_cond;
+	int pending;				// Jobs not done yet.
+	int users;					// Running workers + caller.
+
+	int count;
+	rquery_discovery_job_t jobs[];
+};
+
+static void rquery_discovery_put(rquery_discovery_t* discovery)
+{/// @note Call with discovery->mutex locked. Mutex is unlocked on return.
+	int i;
+	int last = !--discovery->users;
+
+	pthread_mutex_unlock(&discovery->mutex);
+
+	if (last)
+	{
+		for (i = 0; i < discovery->count; i++)
+		{
+			free(discovery->jobs[i].host);
+			free(discovery->jobs[i].topology);
+		}
+
+		pthread_cond_destroy(&discovery->done_cond);
+		pthread_mutex_destroy(&discovery->mutex);
+		free(discovery);
+	}
+}
+
+static void* rquery_discovery_thread(void* arg)
+{
+	rquery_discovery_job_t* job = (rquery_discovery_job_t *)arg;
+	rquery_discovery_t* discovery = job->discovery;
+	me_query_topology_res* topology = NULL;
+	char* buffer = NULL;
+	int size = 0;
+	int err;
+
+	err = rquery_topology(job->host, job->timeout, &topology);
+	if (!err)
+	{
+		size = rquery_topology_pack(topology, NULL, 0);
+		buffer = malloc(size);
+		if (buffer)
+		{
+			rquery_topology_pack(topology, buffer, size);
+		}
+		else
+		{
+			err = ME_ERRNO_INTERNAL;
+			size = 0;
+		}
+	}
+	rquery_topology_free(topology);
+
+	pthread_mutex_lock(&discovery->mutex);
+		job->err = err;
+		job->topology = buffer;
+		job->size = size;
+		job->done = 1;
+		if (!--discovery->pending)
+		{
+			pthread_cond_signal(&discovery->done_cond);
+		}
+	rquery_discovery_put(discovery);
+
+	return NULL;
+}
+
+int meRQueryDiscover(meRQueryHost_t* pHosts, int iCount, int iTimeout)
+{
+	rquery_discovery_t* discovery;
+	rquery_discovery_job_t* job;
+	pthread_attr_t attr;
+	pthread_condattr_t cond_attr;
+	struct timespec deadline;
+	int i;
+
+	if (!pHosts)
+	{
+		return ME_ERRNO_INVALID_POINTER;
+	}
+
+	if (iCount <= 0)
+	{
+		return ME_ERRNO_INVALID_VALUE_COUNT;
+	}
+
+	if (iTimeout < 0)
+	{
+		return ME_ERRNO_INVALID_TIMEOUT;
+	}
+
+	for (i = 0; i < iCount; i++)
+	{
+		pHosts[i].iErrno = ME_ERRNO_TIMEOUT;
+		pHosts[i].pcTopology = NULL;
+		pHosts[i].iSize = 0;
+	}
+
+	discovery = calloc(1, sizeof(rquery_discovery_t) + iCount * sizeof(rquery_discovery_job_t));
+	if (!discovery)
+	{
+		return ME_ERRNO_INTERNAL;
+	}
+
+	pthread_mutex_init(&discovery->mutex, NULL);
+	// Deadline must not move with wall clock.
+	pthread_condattr_init(&cond_attr);
+	pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&discovery->done_cond, &cond_attr);
+	pthread_condattr_destroy(&cond_attr);
+	discovery->count = iCount;
+	discovery->pending = iCount;
+	discovery->users = 1;
+
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	deadline.tv_sec += iTimeout / 1000;
+	deadline.tv_nsec += (iTimeout % 1000) * 1000000L;
+	if (deadline.tv_nsec >= 1000000000L)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000L;
+	}
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	pthread_mutex_lock(&discovery->mutex);
+		for (i = 0; i < iCount; i++)
+		{
+			job = &discovery->jobs[i];
+			job->discovery = discovery;
+			// Every single call is bounded by the shared timeout.
+			job->timeout = (iTimeout) ? iTimeout : ME_RQUERY_TIMEOUT;
+			job->host = (pHosts[i].pcLocation) ? strdup(pHosts[i].pcLocation) : NULL;
+			if (!job->host)
+			{
+				job->err = (pHosts[i].pcLocation) ? ME_ERRNO_INTERNAL : ME_ERRNO_INVALID_POINTER;
+				job->done = 1;
+				discovery->pending--;
+				continue;
+			}
+
+			discovery->users++;
+			if (pthread_create(&job->thread, &attr, rquery_discovery_thread, job))
+			{
+				discovery->users--;
+				job->err = ME_ERRNO_INTERNAL;
+				job->done = 1;
+				discovery->pending--;
+			}
+		}
+
+		while (discovery->pending)
+		{
+			if (iTimeout)
+			{
+				if (pthread_cond_timedwait(&discovery->done_cond, &discovery->mutex, &deadline))
+					break;
+			}
+			else
+			{
+				pthread_cond_wait(&discovery->done_cond, &discovery->mutex);
+			}
+		}
+
+		// Hosts that are not done keep ME_ERRNO_TIMEOUT. Their workers finish in background.
+		for (i = 0; i < iCount; i++)
+		{
+			job = &discovery->jobs[i];
+			if (job->done)
+			{
+				pHosts[i].iErrno = job->err;
+				pHosts[i].pcTopology = job->topology;
+				pHosts[i].iSize = job->size;
+				job->topology = NULL;
+			}
+		}
+	rquery_discovery_put(discovery);
+
+	pthread_attr_destroy(&attr);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int meRQueryDiscoverFree(meRQueryHost_t* pHosts, int iCount)
+{
+	int i;
+
+	if (!pHosts)
+	{
+		return ME_ERRNO_INVALID_POINTER;
+	}
+
+	for (i = 0; i < iCount; i++)
+	{
+		free(pHosts[i].pcTopology);
+		pHosts[i].pcTopology = NULL;
+		pHosts[i].iSize = 0;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
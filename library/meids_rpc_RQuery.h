@@ -17,5 +17,12 @@
 /// Standard header file for library.
 #include <medriver.h>
 
+/// Idle connections kept open per host.
+#  define ME_RQUERY_POOL_SIZE		4
+/// Idle connections older than this [s] are closed on next use of pool.
+#  define ME_RQUERY_POOL_IDLE		60
+/// Timeout of single call [ms]. Same as default of rmedriver_clnt.c.
+#  define ME_RQUERY_TIMEOUT		5000
+
 # endif	//_MEIDS_RPC_RQUERY_H_
 #endif	//__KERNEL__
@@ -0,0 +1,435 @@
+/* Shared library for Meilhaus driver system (RPC).
+ * ==========================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <pthread.h>
+
+# include <rpc/rpc.h>
+
+# include "rmedriver.h"
+
+# include "me_error.h"
+# include "me_defines.h"
+
+# include "meids_debug.h"
+# include "meids_rpc_batch.h"
+
+# define ME_RPC_BATCH_QUEUE_SIZE	16
+
+typedef struct me_rpc_batch_output
+{
+	int index;				// Position in whole batch.
+	int* values;
+	int* count;
+	int* status;
+	int requested;			// StreamRead: size of values buffer.
+} me_rpc_batch_output_t;
+
+/// Calls for one remote context.
+typedef struct me_rpc_batch_queue
+{
+	struct me_rpc_batch_queue* next;
+
+	me_rpc_context_t* context;
+	me_batch_params params;
+	me_rpc_batch_output_t* outputs;
+	unsigned int size;		// Allocated entries.
+} me_rpc_batch_queue_t;
+
+typedef struct me_rpc_batch
+{
+	me_rpc_batch_queue_t* queues;	// In order of first use.
+	int count;
+	int err;						// First error of flushed queue. Reported on commit.
+	int failed;						// Position of failed call.
+} me_rpc_batch_t;
+
+static __thread me_rpc_batch_t* rpc_batch = NULL;
+
+static void batchFreeQueue(me_rpc_batch_queue_t* queue)
+{
+	xdr_free((xdrproc_t) xdr_me_batch_params, (char *)&queue->params);
+	free(queue->outputs);
+	free(queue);
+}
+
+static void batchFree(me_rpc_batch_t* batch)
+{
+	me_rpc_batch_queue_t* queue;
+
+	while (batch->queues)
+	{
+		queue = batch->queues;
+		batch->queues = queue->next;
+		batchFreeQueue(queue);
+	}
+
+	free(batch);
+}
+
+/// Deep copy through XDR. Parameters of calls point to buffers of caller.
+static int batchCopy(me_batch_op* src, me_batch_op* dst)
+{
+	XDR xdrs;
+	char* buffer;
+	unsigned long size;
+	int ok;
+
+	size = xdr_sizeof((xdrproc_t) xdr_me_batch_op, src);
+	buffer = malloc(size);
+	if (!buffer)
+	{
+		return ME_ERRNO_INTERNAL;
+	}
+
+	xdrmem_create(&xdrs, buffer, size, XDR_ENCODE);
+	ok = xdr_me_batch_op(&xdrs, src);
+	xdr_destroy(&xdrs);
+
+	if (ok)
+	{
+		memset(dst, 0, sizeof(me_batch_op));
+		xdrmem_create(&xdrs, buffer, size, XDR_DECODE);
+		ok = xdr_me_batch_op(&xdrs, dst);
+		xdr_destroy(&xdrs);
+		if (!ok)
+		{
+			xdr_free((xdrproc_t) xdr_me_batch_op, (char *)dst);
+		}
+	}
+
+	free(buffer);
+
+	return (ok) ? ME_ERRNO_SUCCESS : ME_ERRNO_INTERNAL;
+}
+
+static void batchOutput(me_batch_op_res* res, me_rpc_batch_output_t* output)
+{
+	int count;
+
+	switch (res->type)
+	{
+		case ME_BATCH_SINGLE:
+			if (output->values && res->me_batch_op_res_u.single.single_list.single_list_len)
+			{
+				*output->values = res->me_batch_op_res_u.single.single_list.single_list_val[0].value;
+			}
+			break;
+
+		case ME_BATCH_STREAM_NEW_VALUES:
+			*output->count = res->me_batch_op_res_u.stream_new_values.count;
+			break;
+
+		case ME_BATCH_STREAM_READ:
+			count = res->me_batch_op_res_u.stream_read.values.values_len;
+			if (count > output->requested)
+			{
+				count = output->requested;
+			}
+			memcpy(output->values, res->me_batch_op_res_u.stream_read.values.values_val, count * sizeof(int));
+			*output->count = count;
+			break;
+
+		case ME_BATCH_STREAM_WRITE:
+			*output->count = res->me_batch_op_res_u.stream_write.count;
+			break;
+
+		case ME_BATCH_STREAM_STATUS:
+			*output->status = res->me_batch_op_res_u.stream_status.status;
+			*output->count = res->me_batch_op_res_u.stream_status.count;
+			break;
+
+		default:
+			break;
+	}
+}
+
+static int batchSend(me_rpc_batch_queue_t* queue, int* index)
+{
+	me_rpc_context_t* context = queue->context;
+	me_batch_res* RPC_res = NULL;
+	unsigned int count;
+	unsigned int i;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPDEBUG("Sending %d calls.\n", queue->params.ops.ops_len);
+
+	pthread_mutex_lock(&context->rpc_mutex);
+		RPC_res = me_batch_proc_1(&queue->params, context->fd);
+	pthread_mutex_unlock(&context->rpc_mutex);
+
+	if (!RPC_res)
+	{// Also older servers, that don't know this procedure.
+		LIBPERROR("me_batch_proc_1()=ME_ERRNO_COMMUNICATION\n");
+		*index = queue->outputs[0].index;
+		return ME_ERRNO_COMMUNICATION;
+	}
+
+	count = RPC_res->results.results_len;
+	if (count > queue->params.ops.ops_len)
+	{
+		count = queue->params.ops.ops_len;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		batchOutput(&RPC_res->results.results_val[i], &queue->outputs[i]);
+	}
+
+	if (RPC_res->error)
+	{
+		err = RPC_res->error;
+		*index = queue->outputs[(count) ? count - 1 : 0].index;
+		LIBPERROR("me_batch_proc_1()=%d at call %d\n", err, *index);
+	}
+
+	xdr_free((xdrproc_t) xdr_me_batch_res, (char *)RPC_res);
+	free(RPC_res);
+
+	return err;
+}
+
+int BatchBegin_RPC(int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (iFlags != ME_BATCH_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (rpc_batch)
+	{
+		LIBPERROR("Batch already open.\n");
+		return ME_ERRNO_USED;
+	}
+
+	rpc_batch = calloc(1, sizeof(me_rpc_batch_t));
+	if (!rpc_batch)
+	{
+		return ME_ERRNO_INTERNAL;
+	}
+	rpc_batch->failed = -1;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int BatchCommit_RPC(int* index, int iFlags)
+{
+	me_rpc_batch_t* batch = rpc_batch;
+	me_rpc_batch_queue_t* queue;
+	int failed = -1;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (index)
+	{
+		*index = -1;
+	}
+
+	if (iFlags != ME_BATCH_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (!batch)
+	{
+		LIBPERROR("No open batch.\n");
+		return ME_ERRNO_NOT_OPEN;
+	}
+
+	// Calls made from now on are sent immediately.
+	rpc_batch = NULL;
+
+	// Nothing is sent after failed flush.
+	err = batch->err;
+	failed = batch->failed;
+
+	for (queue = batch->queues; queue && !err; queue = queue->next)
+	{
+		err = batchSend(queue, &failed);
+	}
+
+	batchFree(batch);
+
+	if (index)
+	{
+		*index = failed;
+	}
+
+	return err;
+}
+
+int BatchAbort_RPC(int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (iFlags != ME_BATCH_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (rpc_batch)
+	{
+		batchFree(rpc_batch);
+		rpc_batch = NULL;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int BatchActive_RPC(void)
+{
+	return (rpc_batch != NULL);
+}
+
+int BatchFlush_RPC(me_rpc_context_t* context)
+{
+	me_rpc_batch_t* batch = rpc_batch;
+	me_rpc_batch_queue_t* queue;
+	me_rpc_batch_queue_t** link;
+	int failed = -1;
+	int err;
+
+	if (!batch)
+	{
+		return ME_ERRNO_SUCCESS;
+	}
+
+	if (batch->err)
+	{// Calls recorded before failed one are not executed.
+		return batch->err;
+	}
+
+	for (link = &batch->queues; *link; link = &(*link)->next)
+	{
+		if ((*link)->context == context)
+			break;
+	}
+
+	queue = *link;
+	if (!queue)
+	{
+		return ME_ERRNO_SUCCESS;
+	}
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	*link = queue->next;
+	err = batchSend(queue, &failed);
+	batchFreeQueue(queue);
+
+	if (err)
+	{
+		batch->err = err;
+		batch->failed = failed;
+	}
+
+	return err;
+}
+
+int BatchRecord_RPC(me_rpc_context_t* context, me_batch_op* op, int* values, int* count, int* status)
+{
+	me_rpc_batch_t* batch = rpc_batch;
+	me_rpc_batch_queue_t* queue;
+	me_rpc_batch_queue_t** link;
+	me_rpc_batch_output_t* output;
+	void* ops;
+	void* outputs;
+	unsigned int size;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (!batch)
+	{
+		return ME_ERRNO_INTERNAL;
+	}
+
+	for (link = &batch->queues; *link; link = &(*link)->next)
+	{
+		if ((*link)->context == context)
+			break;
+	}
+
+	queue = *link;
+	if (!queue)
+	{
+		queue = calloc(1, sizeof(me_rpc_batch_queue_t));
+		if (!queue)
+		{
+			return ME_ERRNO_INTERNAL;
+		}
+		queue->context = context;
+		queue->params.flags = ME_VALUE_NOT_USED;
+		*link = queue;
+	}
+
+	if (queue->params.ops.ops_len == queue->size)
+	{
+		size = (queue->size) ? 2 * queue->size : ME_RPC_BATCH_QUEUE_SIZE;
+
+		ops = realloc(queue->params.ops.ops_val, size * sizeof(me_batch_op));
+		if (!ops)
+		{
+			return ME_ERRNO_INTERNAL;
+		}
+		queue->params.ops.ops_val = ops;
+
+		outputs = realloc(queue->outputs, size * sizeof(me_rpc_batch_output_t));
+		if (!outputs)
+		{
+			return ME_ERRNO_INTERNAL;
+		}
+		queue->outputs = outputs;
+
+		queue->size = size;
+	}
+
+	err = batchCopy(op, &queue->params.ops.ops_val[queue->params.ops.ops_len]);
+	if (err)
+	{
+		return err;
+	}
+
+	output = &queue->outputs[queue->params.ops.ops_len];
+	output->index = batch->count;
+	output->values = values;
+	output->count = count;
+	output->status = status;
+	output->requested = (op->type == ME_BATCH_STREAM_READ) ? op->me_batch_op_u.stream_read.count : 0;
+
+	queue->params.ops.ops_len++;
+	batch->count++;
+
+	return ME_ERRNO_SUCCESS;
+}
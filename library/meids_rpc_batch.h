@@ -0,0 +1,32 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_RPC_BATCH_H_
+#  define _MEIDS_RPC_BATCH_H_
+
+#  include "meids_config_structs.h"
+
+struct me_batch_op;
+
+/**
+ * Compound requests.
+ *
+ * Between BatchBegin_RPC() and BatchCommit_RPC() calls of one thread on remote contexts are not sent.
+ * They are recorded and shipped with one ME_BATCH_PROC call per context.
+ * Output arguments of recorded calls are written on commit, so they have to stay valid till then.
+ * Calls that can not be recorded (queries, IRQ, reset, ...) keep program order:
+ * they first send calls already recorded for the same context (BatchFlush_RPC()).
+ * When this fails, the call returns the error without being executed and BatchCommit_RPC() reports it.
+ */
+int  BatchBegin_RPC(int iFlags);
+/// Sends all recorded calls. On error index is set to position (order of recording) of failed call.
+int  BatchCommit_RPC(int* index, int iFlags);
+int  BatchAbort_RPC(int iFlags);
+
+/// True when calling thread records.
+int  BatchActive_RPC(void);
+/// Sends calls recorded for context. Success when calling thread does not record.
+int  BatchFlush_RPC(me_rpc_context_t* context);
+/// Adds call to batch. Operation is copied. Outputs (can be NULL) are filled on commit.
+int  BatchRecord_RPC(me_rpc_context_t* context, struct me_batch_op* op, int* values, int* count, int* status);
+
+# endif	//_MEIDS_RPC_BATCH_H_
+#endif	//__KERNEL__
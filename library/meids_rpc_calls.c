@@ -47,6 +47,9 @@
 # include "meids_internal.h"
 # include "meids_debug.h"
 # include "meids_rpc_calls.h"
+# include "meids_rpc_batch.h"
+# include "meids_rpc_codec.h"
+# include "meids_rpc_event.h"
 
 static int   doCreateThread_RPC(me_rpc_context_t* context, int device, int subdevice, void* fnThread, void* fnCB, void* contextCB, int iFlags);
 static int   doDestroyAllThreads_RPC(me_rpc_context_t* context);
@@ -58,6 +61,9 @@ static void* streamStartThread_RPC(void* arg);
 static void* streamStopThread_RPC(void* arg);
 static void* streamNewValuesThread_RPC(void* arg);
 static int   checkRPC(me_rpc_context_t* rpc_context);
+static void  negotiateEncodings_RPC(me_rpc_context_t* rpc_context);
+static int   streamReadPacked_RPC(me_rpc_context_t* rpc_context, me_io_stream_read_params* params, int* values, int* count);
+static int   streamWritePacked_RPC(me_rpc_context_t* rpc_context, me_io_stream_write_params* params, int* count);
 
 // Open synchronization
 static pthread_mutex_t condition_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -198,6 +204,11 @@ static int Open_Context(me_rpc_context_t* context, const char* address, int iFla
 		RPC_open_res = NULL;
 	}
 
+	if (!err)
+	{
+		negotiateEncodings_RPC(context);
+	}
+
 #if defined RPC_USE_SUBCONTEXT
 	if (!err)
 	{
@@ -252,6 +263,35 @@ ERROR:
 	return err;
 }
 
+static void negotiateEncodings_RPC(me_rpc_context_t* rpc_context)
+{/// @note Servers without ME_STREAM_ENCODINGS_PROC answer PROC_UNAVAIL. Plain XDR transfers are used then.
+	int* RPC_res;
+	int offer = ME_RPC_ENCODINGS;
+	char* env;
+
+	env = getenv("MEIDS_RPC_ENCODINGS");
+	if (env && *env)
+	{
+		offer = strtol(env, NULL, 0) & ME_RPC_ENCODINGS;
+	}
+
+	rpc_context->stream_encodings = 0;
+	if (!offer)
+		return;
+
+	pthread_mutex_lock(&rpc_context->rpc_mutex);
+		RPC_res = me_stream_encodings_proc_1(&offer, rpc_context->fd);
+	pthread_mutex_unlock(&rpc_context->rpc_mutex);
+
+	if (RPC_res)
+	{
+		rpc_context->stream_encodings = *RPC_res & offer;
+		free(RPC_res);
+	}
+
+	LIBPINFO("Stream encodings for %s: 0x%x\n", rpc_context->access_point_addr, rpc_context->stream_encodings);
+}
+
 void Test_RPC(const char* address)
 {
 	CLIENT* clnt = NULL;
@@ -454,6 +494,7 @@ static int Close_Context(me_rpc_context_t* context, int iFlags)
 	CHECK_POINTER(context);
 
 	doDestroyAllThreads_RPC(context);
+	EventClose_RPC(context);
 
 	if (!context->fd)
 		return err;
@@ -554,6 +595,10 @@ int LockDriver_RPC(void* context, int lock, int iFlags)
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	params.lock = lock ;
 	params.flags = iFlags;
 
@@ -595,6 +640,10 @@ int LockDevice_RPC(void* context, int device, int lock, int iFlags)
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	params.device = device;
 	params.lock = lock ;
 	params.flags = iFlags;
@@ -637,6 +686,10 @@ int LockSubdevice_RPC(void* context, int device, int subdevice, int lock, int iF
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	params.device = device;
 	params.subdevice = subdevice;
 	params.lock = lock ;
@@ -679,6 +732,10 @@ int  QueryDriverVersion_RPC(void* context, int* version, int iFlags)
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 	CHECK_POINTER(version);
 
@@ -743,6 +800,10 @@ int  QuerySubdriverVersion_RPC(void* context, int device, int* version, int iFla
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 	CHECK_POINTER(version);
 
@@ -787,6 +848,10 @@ int  QuerySubdriverName_RPC(void* context, int device, char* name, int count, in
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -840,6 +905,10 @@ int  QueryDeviceName_RPC(void* context, int device, char* name, int count, int i
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -892,6 +961,10 @@ int  QueryDeviceDescription_RPC(void* context, int device, char* description, in
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -944,6 +1017,10 @@ int  QueryDevicesNumber_RPC(void* context, int* no_devices, int iFlags)
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -996,6 +1073,10 @@ int  QueryDeviceInfo_RPC(void* context, int device, unsigned int* vendor_id, uns
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1068,6 +1149,10 @@ int  QuerySubdevicesNumber_RPC(void* context, int device, int* no_subdevices, in
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1172,6 +1257,10 @@ int  QuerySubdeviceType_RPC(void* context, int device, int subdevice, int* type,
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1229,6 +1318,10 @@ int  QuerySubdeviceByType_RPC(void* context, int device, int subdevice, int type
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1285,6 +1378,10 @@ int  QuerySubdeviceCaps_RPC(void* context, int device, int subdevice, int* caps,
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1340,6 +1437,10 @@ int  QuerySubdeviceCapsArgs_RPC(void* context, int device, int subdevice, int ca
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 	CHECK_POINTER(args);
 
@@ -1404,6 +1505,10 @@ int  QuerySubdeviceTimer_RPC(void* context, int device, int subdevice, int timer
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags & ~ME_MEPHISTO_SCOPE_OSCILLOSCOPE_FLAG)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1527,6 +1632,14 @@ int  QuerySubdeviceTimer_RPC(void* context, int device, int subdevice, int timer
 	return err;
 }
 
+int  QueryLatencyProbe_RPC(void* context, int device, int subdevice, meLatencyProbe_t* probe, int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	// Time stamps are taken with remote host's clock. They can not be compared with local time.
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
 
 int  QueryChannelsNumber_RPC(void* context, int device, int subdevice, unsigned int* number, int iFlags)
 {
@@ -1541,6 +1654,10 @@ int  QueryChannelsNumber_RPC(void* context, int device, int subdevice, unsigned
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1596,6 +1713,10 @@ int  QueryRangesNumber_RPC(void* context, int device, int subdevice, int unit, i
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1651,6 +1772,10 @@ int  QueryRangeInfo_RPC(void* context, int device, int subdevice, int range, int
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1715,6 +1840,10 @@ int  QueryRangeByMinMax_RPC(void* context, int device, int subdevice, int unit,
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	if (iFlags != ME_QUERY_NO_FLAGS)
 	{
 		LIBPERROR("Invalid flag specified.\n");
@@ -1768,6 +1897,66 @@ int  QueryRangeByMinMax_RPC(void* context, int device, int subdevice, int unit,
 	return err;
 }
 
+int  QueryTopology_RPC(void* context, struct me_query_topology_res** topology, int iFlags)
+{
+	me_query_topology_res* RPC_res = NULL;
+	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	err = checkRPC(rpc_context);
+	if (err)
+		return err;
+
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
+	if (iFlags != ME_QUERY_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	CHECK_POINTER(context);
+	CHECK_POINTER(topology);
+
+	*topology = NULL;
+
+	pthread_mutex_lock(&rpc_context->rpc_mutex);
+		RPC_res = me_query_topology_proc_1(NULL, rpc_context->fd);
+	pthread_mutex_unlock(&rpc_context->rpc_mutex);
+
+	if (!RPC_res)
+	{
+		// Older servers don't know this procedure. Caller has to use single queries.
+		LIBPWARNING("me_query_topology_proc_1()=ME_ERRNO_COMMUNICATION\n");
+		err = ME_ERRNO_COMMUNICATION;
+	}
+	else if (RPC_res->error)
+	{
+		err = RPC_res->error;
+		LIBPERROR("me_query_topology_proc_1()=%d\n", err);
+		QueryTopologyFree_RPC(RPC_res);
+	}
+	else
+	{
+		*topology = RPC_res;
+	}
+
+	return err;
+}
+
+void QueryTopologyFree_RPC(struct me_query_topology_res* topology)
+{
+	if (topology)
+	{
+		xdr_free((xdrproc_t) xdr_me_query_topology_res, (char *)topology);
+		free(topology);
+	}
+}
+
 
 //Input/Output
 int  IrqStart_RPC(void* context, int device, int subdevice, int channel, int source, int edge, int arg, int iFlags)
@@ -1783,6 +1972,10 @@ int  IrqStart_RPC(void* context, int device, int subdevice, int channel, int sou
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 
 	params.device = device;
@@ -1830,6 +2023,10 @@ int  IrqWait_RPC(void* context, int device, int subdevice, int channel, int* cou
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 	CHECK_POINTER(value);
 	CHECK_POINTER(count);
@@ -1884,6 +2081,10 @@ int  IrqStop_RPC(void* context, int device, int subdevice, int channel, int iFla
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 
 	params.device = device;
@@ -1928,6 +2129,10 @@ int  IrqTest_RPC(void* context, int device, int subdevice, int channel, int iFla
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	params.device = device;
 	params.subdevice = subdevice;
 	params.channel = channel;
@@ -1973,7 +2178,11 @@ int IrqSetCallback_RPC(void* context, int device, int subdevice, meIOIrqCB_t irq
 		err = IrqTest_RPC(context, device, subdevice, 0, iFlags);
 		if (!err)
 		{
-			err = doCreateThread_RPC(context, device, subdevice, irqThread_RPC, irq_fn, irq_context, iFlags);
+			err = EventSubscribe_RPC(context, ME_EVENT_IRQ, device, subdevice, irq_fn, irq_context, iFlags);
+			if (err == ME_ERRNO_NOT_SUPPORTED)
+			{// Old server. Polling thread.
+				err = doCreateThread_RPC(context, device, subdevice, irqThread_RPC, irq_fn, irq_context, iFlags);
+			}
 		}
 	}
 	else
@@ -1997,6 +2206,10 @@ int  ResetDevice_RPC(void* context, int device, int iFlags)
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 
 	doDestroyThreads_RPC(context, device);
@@ -2041,6 +2254,10 @@ int  ResetSubdevice_RPC(void* context, int device, int subdevice, int iFlags)
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 
 	doDestroyThread_RPC(context, device, subdevice);
@@ -2079,6 +2296,7 @@ int  SingleConfig_RPC(void* context, int device, int subdevice, int channel,
                      	int trigger, int edge, int iFlags)
 {
 	me_io_single_config_params params;
+	me_batch_op op;
 	int* RPC_res = NULL;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
 	int err = ME_ERRNO_SUCCESS;
@@ -2101,6 +2319,13 @@ int  SingleConfig_RPC(void* context, int device, int subdevice, int channel,
 	params.trig_edge = edge;
 	params.flags = iFlags;
 
+	if (BatchActive_RPC())
+	{// Sent on meBatchCommit().
+		op.type = ME_BATCH_SINGLE_CONFIG;
+		op.me_batch_op_u.single_config = params;
+		return BatchRecord_RPC(rpc_context, &op, NULL, NULL, NULL);
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_single_config_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2128,8 +2353,31 @@ int  SingleConfig_RPC(void* context, int device, int subdevice, int channel,
 int  Single_RPC(void* context, int device, int subdevice, int channel, int direction, int* value, int timeout, int iFlags)
 {
 	meIOSingle_t list;
+	me_io_single_entry_params entry;
+	me_batch_op op;
 	int err = ME_ERRNO_SUCCESS;
 
+	if (BatchActive_RPC())
+	{// Value is written on meBatchCommit().
+		CHECK_POINTER(context);
+		CHECK_POINTER(value);
+
+		memset(&entry, 0, sizeof(me_io_single_entry_params));
+		entry.device = device;
+		entry.subdevice = subdevice;
+		entry.channel = channel;
+		entry.dir = direction;
+		entry.value = *value;
+		entry.time_out = timeout;
+		entry.flags = iFlags;
+
+		op.type = ME_BATCH_SINGLE;
+		op.me_batch_op_u.single.single_list.single_list_len = 1;
+		op.me_batch_op_u.single.single_list.single_list_val = &entry;
+		op.me_batch_op_u.single.flags = ME_VALUE_NOT_USED;
+		return BatchRecord_RPC((me_rpc_context_t *)context, &op, (direction == ME_DIR_INPUT) ? value : NULL, NULL, NULL);
+	}
+
 	list.iDevice = device;
 	list.iSubdevice = subdevice;
 	list.iChannel = channel;
@@ -2156,6 +2404,7 @@ int  SingleList_RPC(void* context, meIOSingle_t* list, int count, int iFlags)
 */
 	me_io_single_params params;
 	me_io_single_res* RPC_res = NULL;
+	me_batch_op op;
 	int i;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
 	int err = ME_ERRNO_SUCCESS;
@@ -2190,6 +2439,25 @@ int  SingleList_RPC(void* context, meIOSingle_t* list, int count, int iFlags)
 		params.single_list.single_list_val[i].flags = list[i].iFlags;
 	}
 
+	if (BatchActive_RPC())
+	{// Only outputs. Values read by a list can not be returned after list is gone.
+		for (i = 0; i < count; i++)
+		{
+			if (list[i].iDir == ME_DIR_INPUT)
+			{
+				LIBPERROR("Input in batched single list.\n");
+				free(params.single_list.single_list_val);
+				return ME_ERRNO_NOT_SUPPORTED;
+			}
+		}
+
+		op.type = ME_BATCH_SINGLE;
+		op.me_batch_op_u.single = params;
+		err = BatchRecord_RPC(rpc_context, &op, NULL, NULL, NULL);
+		free(params.single_list.single_list_val);
+		return err;
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_single_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2282,6 +2550,7 @@ int  StreamConfigure_RPC(void* context, int device, int subdevice, meIOStreamSim
 int  StreamConfig_RPC(void* context, int device,int subdevice, meIOStreamConfig_t* list, int count, meIOStreamTrigger_t* trigger, int threshold, int iFlags)
 {
 	me_io_stream_config_params params;
+	me_batch_op op;
 	int* RPC_res = NULL;
 	int i;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
@@ -2350,6 +2619,15 @@ int  StreamConfig_RPC(void* context, int device,int subdevice, meIOStreamConfig_
 
 	params.trigger.flags = trigger->iFlags;
 
+	if (BatchActive_RPC())
+	{
+		op.type = ME_BATCH_STREAM_CONFIG;
+		op.me_batch_op_u.stream_config = params;
+		err = BatchRecord_RPC(rpc_context, &op, NULL, NULL, NULL);
+		free(params.config_list.config_list_val);
+		return err;
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_stream_config_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2408,6 +2686,7 @@ int  StreamStartList_RPC(void* context, meIOStreamStart_t* list, int count, int
 */
 	me_io_stream_start_params params;
 	me_io_stream_start_res* RPC_res = NULL;
+	me_batch_op op;
 	int i;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
 	int err = ME_ERRNO_SUCCESS;
@@ -2440,6 +2719,15 @@ int  StreamStartList_RPC(void* context, meIOStreamStart_t* list, int count, int
 		params.start_list.start_list_val[i].flags = list[i].iFlags;
 	}
 
+	if (BatchActive_RPC())
+	{// Errors of entries are reported by meBatchCommit().
+		op.type = ME_BATCH_STREAM_START;
+		op.me_batch_op_u.stream_start = params;
+		err = BatchRecord_RPC(rpc_context, &op, NULL, NULL, NULL);
+		free(params.start_list.start_list_val);
+		return err;
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_stream_start_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2511,6 +2799,7 @@ int  StreamStopList_RPC(void* context, meIOStreamStop_t* list, int count, int iF
 */
 	me_io_stream_stop_params params;
 	me_io_stream_stop_res* RPC_res = NULL;
+	me_batch_op op;
 	int i;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
 	int err = ME_ERRNO_SUCCESS;
@@ -2542,6 +2831,15 @@ int  StreamStopList_RPC(void* context, meIOStreamStop_t* list, int count, int iF
 		params.stop_list.stop_list_val[i].flags = list[i].iFlags;
 	}
 
+	if (BatchActive_RPC())
+	{// Errors of entries are reported by meBatchCommit().
+		op.type = ME_BATCH_STREAM_STOP;
+		op.me_batch_op_u.stream_stop = params;
+		err = BatchRecord_RPC(rpc_context, &op, NULL, NULL, NULL);
+		free(params.stop_list.stop_list_val);
+		return err;
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_stream_stop_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2589,6 +2887,7 @@ int  StreamNewValues_RPC(void* context, int device, int subdevice, int timeout,
 {
 	me_io_stream_new_values_params params;
 	me_io_stream_new_values_res* RPC_res = NULL;
+	me_batch_op op;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
 	int err = ME_ERRNO_SUCCESS;
 
@@ -2606,6 +2905,13 @@ int  StreamNewValues_RPC(void* context, int device, int subdevice, int timeout,
 	params.time_out = timeout;
 	params.flags = iFlags;
 
+	if (BatchActive_RPC())
+	{
+		op.type = ME_BATCH_STREAM_NEW_VALUES;
+		op.me_batch_op_u.stream_new_values = params;
+		return BatchRecord_RPC(rpc_context, &op, NULL, count, NULL);
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_stream_new_values_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2639,6 +2945,7 @@ int  StreamRead_RPC(void* context, int device, int subdevice, int mode, int* val
 {
 	me_io_stream_read_res* RPC_res = NULL;
 	me_io_stream_read_params params;
+	me_batch_op op;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
 	int err = ME_ERRNO_SUCCESS;
 
@@ -2658,6 +2965,18 @@ int  StreamRead_RPC(void* context, int device, int subdevice, int mode, int* val
 	params.count = *count;
 	params.flags = iFlags;
 
+	if (BatchActive_RPC())
+	{
+		op.type = ME_BATCH_STREAM_READ;
+		op.me_batch_op_u.stream_read = params;
+		return BatchRecord_RPC(rpc_context, &op, values, count, NULL);
+	}
+
+	if (rpc_context->stream_encodings)
+	{
+		return streamReadPacked_RPC(rpc_context, &params, values, count);
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_stream_read_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2696,6 +3015,7 @@ int  StreamWrite_RPC(void* context, int device, int subdevice, int mode, int* va
 {
 	me_io_stream_write_res* RPC_res = NULL;
 	me_io_stream_write_params params;
+	me_batch_op op;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
 	int err = ME_ERRNO_SUCCESS;
 
@@ -2716,6 +3036,18 @@ int  StreamWrite_RPC(void* context, int device, int subdevice, int mode, int* va
 	params.values.values_len = *count;
 	params.flags = iFlags;
 
+	if (BatchActive_RPC())
+	{// Values are copied.
+		op.type = ME_BATCH_STREAM_WRITE;
+		op.me_batch_op_u.stream_write = params;
+		return BatchRecord_RPC(rpc_context, &op, NULL, count, NULL);
+	}
+
+	if (rpc_context->stream_encodings)
+	{
+		return streamWritePacked_RPC(rpc_context, &params, count);
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_stream_write_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2745,6 +3077,116 @@ int  StreamWrite_RPC(void* context, int device, int subdevice, int mode, int* va
 	return err;
 }
 
+static int streamReadPacked_RPC(me_rpc_context_t* rpc_context, me_io_stream_read_params* params, int* values, int* count)
+{
+	me_io_stream_read_packed_res* RPC_res = NULL;
+	me_io_stream_read_packed_params packed_params;
+	int err = ME_ERRNO_SUCCESS;
+
+	packed_params.device = params->device;
+	packed_params.subdevice = params->subdevice;
+	packed_params.read_mode = params->read_mode;
+	packed_params.count = params->count;
+	packed_params.encodings = rpc_context->stream_encodings;
+	packed_params.flags = params->flags;
+
+	pthread_mutex_lock(&rpc_context->rpc_mutex);
+		RPC_res = me_io_stream_read_packed_proc_1(&packed_params, rpc_context->fd);
+	pthread_mutex_unlock(&rpc_context->rpc_mutex);
+
+	if (!RPC_res)
+	{
+		LIBPERROR("me_io_stream_read_packed_proc_1()=ME_ERRNO_COMMUNICATION\n");
+		err = ME_ERRNO_COMMUNICATION;
+		*count = 0;
+	}
+	else
+	{
+		if (RPC_res->error)
+		{
+			err = RPC_res->error;
+			LIBPERROR("me_io_stream_read_packed_proc_1()=%d\n", err);
+		}
+
+		if ((RPC_res->count < 0) || (RPC_res->count > *count))
+		{
+			LIBPERROR("me_io_stream_read_packed_proc_1() returned %d values for %d requested.\n", RPC_res->count, *count);
+			err = ME_ERRNO_COMMUNICATION;
+			*count = 0;
+		}
+		else if (StreamDecode_RPC(RPC_res->data.data_val, RPC_res->data.data_len, RPC_res->encoding, values, RPC_res->count))
+		{
+			err = ME_ERRNO_COMMUNICATION;
+			*count = 0;
+		}
+		else
+		{
+			*count = RPC_res->count;
+		}
+	}
+
+	if (RPC_res)
+	{
+		xdr_free((xdrproc_t) xdr_me_io_stream_read_packed_res, (char *)RPC_res);
+		free(RPC_res);
+		RPC_res = NULL;
+	}
+
+	return err;
+}
+
+static int streamWritePacked_RPC(me_rpc_context_t* rpc_context, me_io_stream_write_params* params, int* count)
+{
+	me_io_stream_write_res* RPC_res = NULL;
+	me_io_stream_write_packed_params packed_params;
+	int err = ME_ERRNO_SUCCESS;
+
+	packed_params.device = params->device;
+	packed_params.subdevice = params->subdevice;
+	packed_params.write_mode = params->write_mode;
+	packed_params.count = params->values.values_len;
+	packed_params.flags = params->flags;
+
+	packed_params.data.data_val = malloc(ME_RPC_ENCODED_SIZE(packed_params.count) + 1);
+	if (!packed_params.data.data_val)
+	{
+		LIBPERROR("Can not get requested memory for encoded values.\n");
+		*count = 0;
+		return ME_ERRNO_INTERNAL;
+	}
+	packed_params.encoding = StreamEncode_RPC(params->values.values_val, packed_params.count, rpc_context->stream_encodings, packed_params.data.data_val, &packed_params.data.data_len);
+
+	pthread_mutex_lock(&rpc_context->rpc_mutex);
+		RPC_res = me_io_stream_write_packed_proc_1(&packed_params, rpc_context->fd);
+	pthread_mutex_unlock(&rpc_context->rpc_mutex);
+
+	free(packed_params.data.data_val);
+
+	if (!RPC_res)
+	{
+		LIBPERROR("me_io_stream_write_packed_proc_1()=ME_ERRNO_COMMUNICATION\n");
+		err = ME_ERRNO_COMMUNICATION;
+		*count = 0;
+	}
+	else
+	{
+		if (RPC_res->error)
+		{
+			err = RPC_res->error;
+			LIBPERROR("me_io_stream_write_packed_proc_1()=%d\n", err);
+		}
+		*count = RPC_res->count;
+	}
+
+	if (RPC_res)
+	{
+		free(RPC_res);
+		RPC_res = NULL;
+	}
+
+	return err;
+}
+
 int StreamSetCallbacks_RPC(void* context,
 							int device, int subdevice,
 							meIOStreamCB_t start, void* start_context,
@@ -2765,9 +3207,18 @@ int StreamSetCallbacks_RPC(void* context,
 		return ME_ERRNO_INVALID_FLAGS;
 	}
 
+	// Threads and events see stream configured by recorded calls.
+	err_ret = BatchFlush_RPC((me_rpc_context_t *)context);
+	if (err_ret)
+		return err_ret;
+
 	if (new_values)
 	{	// create
-		err = doCreateThread_RPC(context, device, subdevice, streamNewValuesThread_RPC, new_values, new_value_context, ME_NO_FLAGS);
+		err = EventSubscribe_RPC(context, ME_EVENT_STREAM_NEW_VALUES, device, subdevice, new_values, new_value_context, ME_NO_FLAGS);
+		if (err == ME_ERRNO_NOT_SUPPORTED)
+		{// Old server. Polling thread.
+			err = doCreateThread_RPC(context, device, subdevice, streamNewValuesThread_RPC, new_values, new_value_context, ME_NO_FLAGS);
+		}
 		if (!err_ret)
 			err_ret = err;
 	}
@@ -2798,6 +3249,7 @@ int  StreamStatus_RPC(void* context, int device, int subdevice, int wait, int* s
 {
 	me_io_stream_status_res* RPC_res = NULL;
 	me_io_stream_status_params params;
+	me_batch_op op;
 	me_rpc_context_t* rpc_context = (me_rpc_context_t *)context;
 	int err = ME_ERRNO_SUCCESS;
 
@@ -2816,6 +3268,13 @@ int  StreamStatus_RPC(void* context, int device, int subdevice, int wait, int* s
 	params.wait = wait;
 	params.flags = iFlags;
 
+	if (BatchActive_RPC())
+	{
+		op.type = ME_BATCH_STREAM_STATUS;
+		op.me_batch_op_u.stream_status = params;
+		return BatchRecord_RPC(rpc_context, &op, NULL, count, status);
+	}
+
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		RPC_res = me_io_stream_status_proc_1(&params, rpc_context->fd);
 	pthread_mutex_unlock(&rpc_context->rpc_mutex);
@@ -2847,6 +3306,14 @@ int  StreamStatus_RPC(void* context, int device, int subdevice, int wait, int* s
 	return err;
 }
 
+int  StreamReader_RPC(void* context, int device, int subdevice, int mode, int policy, int* dropped, int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	// Reader belongs to file handle of remote server, not to this client.
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
 int  StreamTimeToTicks_RPC(void* context, int device, int subdevice, int timer, double* stream_time, int* ticks_low, int* ticks_high, int iFlags)
 {
 	me_io_stream_time_to_ticks_res* RPC_res = NULL;
@@ -2860,6 +3327,10 @@ int  StreamTimeToTicks_RPC(void* context, int device, int subdevice, int timer,
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 	CHECK_POINTER(ticks_high);
 	CHECK_POINTER(ticks_low);
@@ -2917,6 +3388,10 @@ int  StreamFrequencyToTicks_RPC(void* context, int device, int subdevice, int ti
 	if (err)
 		return err;
 
+	err = BatchFlush_RPC(rpc_context);
+	if (err)
+		return err;
+
 	CHECK_POINTER(context);
 	CHECK_POINTER(ticks_high);
 	CHECK_POINTER(ticks_low);
@@ -3052,6 +3527,8 @@ static int doDestroyThread_RPC(me_rpc_context_t* local_context, int device, int
 
 	selfID = pthread_self();
 	pthread_mutex_lock(&local_context->callbackContextMutex);
+		EventUnsubscribe_RPC(local_context, device, subdevice);
+
 		while (*activeThread)
 		{
 			if ((device < 0) || (((*activeThread)->device == device) && ((subdevice < 0) || ((*activeThread)->subdevice == subdevice))))
@@ -3757,6 +4234,8 @@ static int checkRPC(me_rpc_context_t* rpc_context)
 
 	LIBPDEBUG("New thread detected! PID: %d\n", pid);
 	rpc_context->pid = pid;
+	// Event channel (socket and dispatcher) belongs to parent.
+	rpc_context->event_channel = NULL;
 
 	pthread_mutex_lock(&rpc_context->rpc_mutex);
 		rpc_context->fd = clnt_create(rpc_context->access_point_addr, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
@@ -36,6 +36,7 @@ int  QuerySubdeviceCaps_RPC(void* context, int device, int subdevice, int* caps,
 int  QuerySubdeviceCapsArgs_RPC(void* context, int device, int subdevice, int cap, int* args, int count, int iFlags);
 int  QuerySubdeviceTimer_RPC(void* context, int device, int subdevice, int timer,
 															int* base, int* min_ticks_low, int* min_ticks_high, int* max_ticks_low, int* max_ticks_high, int iFlags);
+int  QueryLatencyProbe_RPC(void* context, int device, int subdevice, meLatencyProbe_t* probe, int iFlags);
 
 int  QueryChannelsNumber_RPC(void* context, int device, int subdevice, unsigned int* number, int iFlags);
 
@@ -43,6 +44,11 @@ int  QueryRangesNumber_RPC(void* context, int device, int subdevice, int unit, i
 int  QueryRangeInfo_RPC(void* context, int device, int subdevice, int range, int* unit, double *min, double *max, unsigned int* max_data, int iFlags);
 int  QueryRangeByMinMax_RPC(void* context, int device, int subdevice, int unit, double *min, double *max, int* max_data, int* range, int iFlags);
 
+struct me_query_topology_res;
+/// Whole remote topology in one call. Result has to be released with QueryTopologyFree_RPC().
+int  QueryTopology_RPC(void* context, struct me_query_topology_res** topology, int iFlags);
+void QueryTopologyFree_RPC(struct me_query_topology_res* topology);
+
 //Input/Output
 int  IrqStart_RPC(void* context, int device, int subdevice, int channel, int source, int edge, int arg, int iFlags);
 int  IrqWait_RPC(void* context, int device, int subdevice, int channel, int* count, int* value, int timeout, int iFlags);
@@ -70,6 +76,7 @@ int  StreamNewValues_RPC(void* context, int device, int subdevice, int timeout,
 int  StreamRead_RPC(void* context,  int device, int subdevice, int mode, int* values, int* count, int timeout, int iFlags);
 int  StreamWrite_RPC(void* context, int device, int subdevice, int mode, int* values, int* count, int timeout, int iFlags);
 int  StreamStatus_RPC(void* context, int device, int subdevice, int wait, int* status, int* count, int iFlags);
+int  StreamReader_RPC(void* context, int device, int subdevice, int mode, int policy, int* dropped, int iFlags);
 
 int  StreamSetCallbacks_RPC(void* context,
 							int device, int subdevice,
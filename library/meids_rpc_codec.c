@@ -0,0 +1,206 @@
+/* Shared library for Meilhaus driver system (RPC).
+ * ==========================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <stdint.h>
+# include <syslog.h>
+
+# include <rpc/rpc.h>
+
+# include "rmedriver.h"
+
+# include "me_error.h"
+
+# include "meids_debug.h"
+# include "meids_rpc_codec.h"
+
+static void encodeInt32(const int* values, int count, char* data)
+{
+	uint8_t* out = (uint8_t *)data;
+	uint32_t value;
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		value = values[i];
+		*out++ = value;
+		*out++ = value >> 8;
+		*out++ = value >> 16;
+		*out++ = value >> 24;
+	}
+}
+
+static void encodePacked16(const int* values, int count, char* data)
+{
+	uint8_t* out = (uint8_t *)data;
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		*out++ = values[i];
+		*out++ = values[i] >> 8;
+	}
+}
+
+static int encodeDelta(const int* values, int count, char* data, unsigned int limit, unsigned int* size)
+{/// @note Returns 0 when result would be longer than limit.
+	uint8_t* out = (uint8_t *)data;
+	uint8_t* end = out + limit;
+	uint32_t prev = 0;
+	uint32_t delta;
+	uint32_t zigzag;
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		delta = (uint32_t)values[i] - prev;
+		prev = values[i];
+		zigzag = (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+
+		do
+		{
+			if (out >= end)
+				return 0;
+
+			*out++ = (zigzag & 0x7F) | ((zigzag > 0x7F) ? 0x80 : 0x00);
+			zigzag >>= 7;
+		}
+		while (zigzag);
+	}
+
+	*size = out - (uint8_t *)data;
+	return 1;
+}
+
+int StreamEncode_RPC(const int* values, int count, int encodings, char* data, unsigned int* size)
+{
+	int fits16 = 1;
+	unsigned int limit;
+	int i;
+
+	if (count <= 0)
+	{
+		*size = 0;
+		return ME_RPC_ENCODING_INT32;
+	}
+
+	if (encodings & ME_RPC_ENCODING_PACKED16)
+	{
+		for (i = 0; i < count; i++)
+		{
+			if ((unsigned int)values[i] > 0xFFFF)
+			{
+				fits16 = 0;
+				break;
+			}
+		}
+	}
+	else
+	{
+		fits16 = 0;
+	}
+
+	limit = (fits16) ? count * 2 : ME_RPC_ENCODED_SIZE(count);
+
+	// Delta coding is used only when it is shorter than the fixed width one.
+	if ((encodings & ME_RPC_ENCODING_DELTA) && encodeDelta(values, count, data, limit, size))
+		return ME_RPC_ENCODING_DELTA;
+
+	if (fits16)
+	{
+		encodePacked16(values, count, data);
+		*size = count * 2;
+		return ME_RPC_ENCODING_PACKED16;
+	}
+
+	encodeInt32(values, count, data);
+	*size = ME_RPC_ENCODED_SIZE(count);
+	return ME_RPC_ENCODING_INT32;
+}
+
+int StreamDecode_RPC(const char* data, unsigned int size, int encoding, int* values, int count)
+{
+	const uint8_t* in = (const uint8_t *)data;
+	const uint8_t* end = in + size;
+	uint32_t prev = 0;
+	uint32_t zigzag;
+	int shift;
+	int i;
+
+	if (count <= 0)
+		return (size) ? ME_ERRNO_COMMUNICATION : ME_ERRNO_SUCCESS;
+
+	switch (encoding)
+	{
+		case ME_RPC_ENCODING_INT32:
+			if (size != (unsigned int)count * 4)
+				break;
+
+			for (i = 0; i < count; i++, in += 4)
+			{
+				values[i] = (int)((uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24));
+			}
+			return ME_ERRNO_SUCCESS;
+
+		case ME_RPC_ENCODING_PACKED16:
+			if (size != (unsigned int)count * 2)
+				break;
+
+			for (i = 0; i < count; i++, in += 2)
+			{
+				values[i] = in[0] | (in[1] << 8);
+			}
+			return ME_ERRNO_SUCCESS;
+
+		case ME_RPC_ENCODING_DELTA:
+			for (i = 0; i < count; i++)
+			{
+				zigzag = 0;
+				shift = 0;
+				do
+				{
+					if ((in >= end) || (shift > 28))
+					{
+						LIBPERROR("Malformed delta coded stream data.\n");
+						return ME_ERRNO_COMMUNICATION;
+					}
+
+					zigzag |= (uint32_t)(*in & 0x7F) << shift;
+					shift += 7;
+				}
+				while (*in++ & 0x80);
+
+				prev += (zigzag >> 1) ^ (0 - (zigzag & 0x1));
+				values[i] = (int)prev;
+			}
+
+			if (in == end)
+				return ME_ERRNO_SUCCESS;
+			break;
+	}
+
+	LIBPERROR("Stream data do not match encoding %d (%u bytes for %d values).\n", encoding, size, count);
+	return ME_ERRNO_COMMUNICATION;
+}
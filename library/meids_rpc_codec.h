@@ -0,0 +1,25 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_RPC_CODEC_H_
+#  define _MEIDS_RPC_CODEC_H_
+
+/**
+ * Compact encodings of stream samples (ME_IO_STREAM_READ_PACKED_PROC / ME_IO_STREAM_WRITE_PACKED_PROC).
+ *
+ * ME_RPC_ENCODING_INT32		4 bytes per value. Fallback, always possible.
+ * ME_RPC_ENCODING_PACKED16	2 bytes per value. Only when all values are in range [0, 0xFFFF].
+ * ME_RPC_ENCODING_DELTA		Zigzag coded differences, 7 bits per byte. Slow changing signals need 1-2 bytes per value.
+ *
+ * MEIDS_RPC_ENCODINGS	Mask of encodings offered to server. 0 disables packed transfers.	(all)
+ */
+#  define ME_RPC_ENCODINGS			(ME_RPC_ENCODING_PACKED16 | ME_RPC_ENCODING_DELTA)
+
+/// Size of buffer, that is always big enough for count encoded values.
+#  define ME_RPC_ENCODED_SIZE(count)	((count) * 4)
+
+/// Encodes values with the smallest of allowed encodings. Returns used encoding. data must have ME_RPC_ENCODED_SIZE(count) bytes.
+int  StreamEncode_RPC(const int* values, int count, int encodings, char* data, unsigned int* size);
+/// Decodes exactly count values. Returns ME_ERRNO_COMMUNICATION on malformed data.
+int  StreamDecode_RPC(const char* data, unsigned int size, int encoding, int* values, int count);
+
+# endif	//_MEIDS_RPC_CODEC_H_
+#endif	//__KERNEL__
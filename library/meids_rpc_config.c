@@ -8,6 +8,9 @@
 # include <sys/ioctl.h>
 # include <string.h>
 
+# include <rpc/rpc.h>
+# include "rmedriver.h"
+
 # include "me_error.h"
 # include "me_types.h"
 # include "me_defines.h"
@@ -21,6 +24,7 @@
 # include "meids_rpc_calls.h"
 # include "meids_debug.h"
 
+# include "meids_config.h"
 # include "meids_rpc_config.h"
 
 static int  build_me_drv_device_list(me_rpc_context_t* context, me_cfg_device_entry_t** device_list, unsigned int *count, int max_dev, const char* address);
@@ -32,10 +36,15 @@ static int  build_me_drv_subdevice_info(me_rpc_context_t* context, me_cfg_subdev
 static int  build_me_drv_range_list(me_rpc_context_t* context, me_cfg_range_info_t** range_list, unsigned int *count, int number, int subnumber, int max_ranges);
 static int  build_me_drv_range_entry(me_rpc_context_t* context, me_cfg_range_info_t *range, int number, int subnumber, int rangenumber);
 
+static int  build_me_drv_topology(me_rpc_context_t* context, me_config_t* cfg, me_query_topology_res* topology, const char* address);
+static int  build_me_drv_topology_device(me_rpc_context_t* context, me_cfg_device_entry_t* device, int number, me_topology_device_res* topology, const char* address);
+static int  build_me_drv_topology_subdevice(me_cfg_subdevice_entry_t* subdevice, me_topology_subdevice_res* topology);
+
 int ConfigRead_RPC(me_rpc_context_t* context, me_config_t *cfg, const char* address, int iFlags)
 {
 	int err=ME_ERRNO_SUCCESS;
 	int no_devices = 0;
+	me_query_topology_res* topology = NULL;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
@@ -45,6 +54,18 @@ int ConfigRead_RPC(me_rpc_context_t* context, me_config_t *cfg, const char* addr
 		err = ME_ERRNO_INVALID_FLAGS;
 	}
 
+	// Whole topology in one round trip. Older servers have to be asked query by query.
+	err = QueryTopology_RPC(context, &topology, ME_QUERY_NO_FLAGS);
+	if (err != ME_ERRNO_COMMUNICATION)
+	{
+		if (!err)
+		{
+			err = build_me_drv_topology(context, cfg, topology, address);
+		}
+		QueryTopologyFree_RPC(topology);
+		return err;
+	}
+
 	err = QueryDevicesNumber_RPC(context, &no_devices, ME_QUERY_NO_FLAGS);
 	if (!err)
 	{
@@ -338,7 +359,10 @@ static int build_me_drv_subdevice_entry(me_rpc_context_t* context, me_cfg_subdev
 			}
 		}
 
-
+		if (!err)
+		{
+			ConfigQueryCacheFill(subdevice);
+		}
 	}
 	else if (err == ME_ERRNO_NOT_SUPPORTED)
 	{
@@ -418,3 +442,243 @@ static int build_me_drv_range_entry(me_rpc_context_t* context, me_cfg_range_info
 	return err;
 }
 
+static int build_me_drv_topology(me_rpc_context_t* context, me_config_t* cfg, me_query_topology_res* topology, const char* address)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_cfg_device_entry_t* cur_device;
+	unsigned int cnt;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (!topology->devices.devices_len)
+	{
+		LIBPERROR("No devices in system.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+
+	cfg->device_list = calloc(topology->devices.devices_len, sizeof(me_cfg_device_entry_t*));
+	if (!cfg->device_list)
+	{
+		LIBPERROR("Can not get requestet memory for device_list structure.");
+		return ME_ERRNO_INTERNAL;
+	}
+
+	for (cnt = 0; cnt < topology->devices.devices_len; )
+	{
+		cur_device = calloc(1, sizeof(me_cfg_device_entry_t));
+		if (cur_device)
+		{
+			cur_device->context = context;
+			cfg->device_list[cnt] = cur_device;
+
+			err = build_me_drv_topology_device(context, cur_device, cnt, &topology->devices.devices_val[cnt], address);
+			cnt++;
+		}
+		else
+		{
+			LIBPERROR("Can not get requestet memory for device_entry.");
+			err = ME_ERRNO_INTERNAL;
+		}
+
+		if (err)
+			break;
+	}
+	cfg->device_list_count = cnt;
+
+	return err;
+}
+
+static int build_me_drv_topology_device(me_rpc_context_t* context, me_cfg_device_entry_t* device, int number, me_topology_device_res* topology, const char* address)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_cfg_subdevice_entry_t* cur_subdevice;
+	unsigned int cnt;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	device->subdevice_list_count = 0;
+	device->subdevice_list = NULL;
+	device->info.device_name = NULL;
+	device->info.device_description = NULL;
+	device->logical_device_no = -1;
+	device->info.device_no = number;
+
+	if (topology->info.error)
+	{
+		LIBPERROR("Device %d: err=%d\n", number, topology->info.error);
+		return topology->info.error;
+	}
+
+	device->info.vendor_id = topology->info.vendor_id;
+	device->info.device_id = topology->info.device_id;
+	device->info.serial_no = topology->info.serial_no;
+
+	switch (topology->info.bus_type)
+	{
+		case ME_BUS_TYPE_PCI:
+			device->access_type = me_access_type_PCI;
+			device->info.pci.bus_no = topology->info.bus_no;
+			device->info.pci.device_no = topology->info.dev_no;
+			device->info.pci.function_no = topology->info.func_no;
+			break;
+
+		case ME_BUS_TYPE_USB:
+			device->access_type = me_access_type_USB;
+			device->info.usb.root_hub_no = topology->info.bus_no;
+			break;
+
+		case ME_BUS_TYPE_LAN_PCI:
+		case ME_BUS_TYPE_LAN_USB:
+			device->access_type = me_access_type_TCPIP;
+			device->info.tcpip.remote_host = strdup(address);
+			break;
+
+		default:
+			device->access_type = me_access_type_invalid;
+			LIBPERROR("Wrong bus type returned: 0x%x(%d)\n", topology->info.bus_type, topology->info.bus_type);
+			err = ME_ERRNO_INTERNAL;
+	}
+
+	switch (topology->info.plugged)
+	{
+		case ME_PLUGGED_IN:
+			device->plugged = me_plugged_type_IN;
+			break;
+
+		case ME_PLUGGED_OUT:
+			device->plugged = me_plugged_type_OUT;
+			break;
+
+		default:
+			device->plugged = me_plugged_type_invalid;
+	}
+
+	if (!err && topology->name && strlen(topology->name))
+	{
+		device->info.device_name = strdup(topology->name);
+		if (!device->info.device_name)
+		{
+			LIBPERROR("Can not get requestet memory for device_name.");
+			err = ME_ERRNO_INTERNAL;
+		}
+	}
+
+	if (!err && topology->description && strlen(topology->description))
+	{
+		device->info.device_description = strdup(topology->description);
+		if (!device->info.device_description)
+		{
+			LIBPERROR("Can not get requestet memory for device_description.");
+			err = ME_ERRNO_INTERNAL;
+		}
+	}
+
+	if (!err && topology->subdevices.subdevices_len)
+	{
+		device->subdevice_list = calloc(topology->subdevices.subdevices_len, sizeof(me_cfg_subdevice_entry_t*));
+		if (!device->subdevice_list)
+		{
+			LIBPERROR("Can not get requestet memory for subdevice_list structure.\n");
+			err = ME_ERRNO_INTERNAL;
+		}
+	}
+
+	for (cnt = 0; !err && (cnt < topology->subdevices.subdevices_len); )
+	{
+		cur_subdevice = calloc(1, sizeof(me_cfg_subdevice_entry_t));
+		if (cur_subdevice)
+		{
+			device->subdevice_list[cnt] = cur_subdevice;
+
+			err = build_me_drv_topology_subdevice(cur_subdevice, &topology->subdevices.subdevices_val[cnt]);
+			cnt++;
+		}
+		else
+		{
+			LIBPERROR("Can not get requestet memory for subdevice_entry.");
+			err = ME_ERRNO_INTERNAL;
+		}
+	}
+	device->subdevice_list_count = cnt;
+
+	return err;
+}
+
+static int build_me_drv_topology_subdevice(me_cfg_subdevice_entry_t* subdevice, me_topology_subdevice_res* topology)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_cfg_range_info_t* cur_range;
+	unsigned int cnt;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	subdevice->info.range_list_count = 0;
+	subdevice->info.range_list = NULL;
+
+	subdevice->extention.type = me_cfg_extention_type_none;
+	subdevice->locked = ME_LOCK_RELEASE;
+
+	subdevice->info.type = topology->type;
+	subdevice->info.sub_type = topology->subtype;
+	subdevice->info.channels = topology->channels;
+
+	if (topology->error)
+	{
+		LIBPERROR("Subdevice: err=%d\n", topology->error);
+		return topology->error;
+	}
+
+	if (topology->ranges.ranges_len)
+	{
+		subdevice->info.range_list = calloc(topology->ranges.ranges_len, sizeof(me_cfg_range_info_t*));
+		if (!subdevice->info.range_list)
+		{
+			LIBPERROR("Can not get requestet memory for range_list.");
+			return ME_ERRNO_INTERNAL;
+		}
+	}
+
+	for (cnt = 0; cnt < topology->ranges.ranges_len; cnt++)
+	{
+		cur_range = calloc(1, sizeof(me_cfg_range_info_t));
+		if (!cur_range)
+		{
+			LIBPERROR("Can not get requestet memory for range_entry.");
+			err = ME_ERRNO_INTERNAL;
+			break;
+		}
+		subdevice->info.range_list[cnt] = cur_range;
+
+		cur_range->unit = (enum me_units_type) topology->ranges.ranges_val[cnt].unit;
+		cur_range->min = topology->ranges.ranges_val[cnt].min;
+		cur_range->max = topology->ranges.ranges_val[cnt].max;
+		cur_range->max_data = topology->ranges.ranges_val[cnt].max_data;
+	}
+	subdevice->info.range_list_count = cnt;
+
+	if (!err)
+	{
+		ConfigQueryCacheFill(subdevice);
+
+		if (topology->caps)
+		{
+			subdevice->cache.caps = topology->caps;
+			subdevice->cache.valid |= ME_CFG_CACHE_CAPS;
+		}
+
+		for (cnt = 0; (cnt < topology->timers.timers_len) && (cnt < ME_CFG_CACHE_TIMERS); cnt++)
+		{
+			if (topology->timers.timers_val[cnt].error)
+				continue;
+
+			subdevice->cache.timers[cnt].base = topology->timers.timers_val[cnt].base_frequency;
+			subdevice->cache.timers[cnt].min_ticks_low = topology->timers.timers_val[cnt].min_ticks_low;
+			subdevice->cache.timers[cnt].min_ticks_high = topology->timers.timers_val[cnt].min_ticks_high;
+			subdevice->cache.timers[cnt].max_ticks_low = topology->timers.timers_val[cnt].max_ticks_low;
+			subdevice->cache.timers[cnt].max_ticks_high = topology->timers.timers_val[cnt].max_ticks_high;
+			subdevice->cache.valid |= ME_CFG_CACHE_TIMER << cnt;
+		}
+	}
+
+	return err;
+}
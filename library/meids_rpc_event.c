@@ -0,0 +1,558 @@
+/* Shared library for Meilhaus driver system (RPC).
+ * ==========================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <unistd.h>
+# include <errno.h>
+# include <syslog.h>
+# include <pthread.h>
+# include <sys/socket.h>
+
+# include <rpc/rpc.h>
+
+# include "rmedriver.h"
+
+# include "me_error.h"
+# include "me_types.h"
+# include "me_defines.h"
+
+# include "meids_debug.h"
+# include "meids_rpc_calls.h"
+# include "meids_rpc_event.h"
+
+typedef struct me_rpc_event_sub
+{
+	struct me_rpc_event_sub* next;
+
+	me_event_type type;
+	int device;
+	int subdevice;
+	int flags;
+
+	void* fnCB;
+	void* contextCB;
+} me_rpc_event_sub_t;
+
+typedef struct me_rpc_event_channel
+{
+	me_rpc_context_t* context;
+
+	pthread_mutex_t mutex;		// Subscriptions and writes to socket.
+	pthread_cond_t stopped;
+
+	int sock;					// -1: not connected.
+	XDR xdrs_in;				// Used only by dispatcher.
+	XDR xdrs_out;
+
+	int threads;				// Running dispatchers. Old one can still report lost connection.
+	int closing;
+	int orphan;					// Closed from callback. Last dispatcher frees channel.
+	int unsupported;			// Server without ME_EVENT_CHANNEL_PROC.
+
+	me_rpc_event_sub_t* subs;
+} me_rpc_event_channel_t;
+
+static pthread_mutex_t channels_mutex = PTHREAD_MUTEX_INITIALIZER;
+/// Channel served by calling thread.
+static __thread me_rpc_event_channel_t* dispatching = NULL;
+
+static void* eventThread_RPC(void* arg);
+
+static int eventRead(void* ctx, void* buf, int len)
+{
+	me_rpc_event_channel_t* channel = (me_rpc_event_channel_t *)ctx;
+	int ret;
+
+	do
+	{
+		ret = read(channel->sock, buf, len);
+	}
+	while ((ret < 0) && (errno == EINTR));
+
+	return (ret > 0) ? ret : -1;
+}
+
+static int eventWrite(void* ctx, void* buf, int len)
+{
+	me_rpc_event_channel_t* channel = (me_rpc_event_channel_t *)ctx;
+	char* data = (char *)buf;
+	int cnt;
+	int ret;
+
+	for (cnt = len; cnt > 0; cnt -= ret, data += ret)
+	{
+		ret = send(channel->sock, data, cnt, MSG_NOSIGNAL);
+		if (ret < 0)
+		{
+			if (errno == EINTR)
+			{
+				ret = 0;
+				continue;
+			}
+			return -1;
+		}
+	}
+
+	return len;
+}
+
+static int eventSend(me_rpc_event_channel_t* channel, me_rpc_event_sub_t* sub, int subscribe)
+{/// @note Call with channel's mutex locked.
+	me_event_subscribe record;
+
+	record.type = sub->type;
+	record.device = sub->device;
+	record.subdevice = sub->subdevice;
+	record.subscribe = subscribe;
+	record.flags = sub->flags;
+
+	channel->xdrs_out.x_op = XDR_ENCODE;
+	if (!xdr_me_event_subscribe(&channel->xdrs_out, &record) || !xdrrec_endofrecord(&channel->xdrs_out, 1))
+	{
+		LIBPERROR("Can not send subscription to event channel.\n");
+		return ME_ERRNO_COMMUNICATION;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static void eventDisconnect(me_rpc_event_channel_t* channel)
+{/// @note Call with channel's mutex locked.
+	if (channel->sock >= 0)
+	{
+		xdr_destroy(&channel->xdrs_in);
+		xdr_destroy(&channel->xdrs_out);
+		close(channel->sock);
+		channel->sock = -1;
+	}
+}
+
+static int eventConnect(me_rpc_event_channel_t* channel)
+{/// @note Call with channel's mutex locked.
+	me_rpc_context_t* context = channel->context;
+	CLIENT* clnt;
+	struct rpc_err rpc_err;
+	pthread_t thread;
+	int* RPC_res;
+	int iFlags = 0;
+	me_rpc_event_sub_t* sub;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	clnt = clnt_create(context->access_point_addr, RMEDRIVER_PROG, RMEDRIVER_VERS, "tcp");
+	if (!clnt)
+	{
+		LIBPERROR("Connection not possible: clnt_create(%s)=ME_ERRNO_COMMUNICATION\n", context->access_point_addr);
+		return ME_ERRNO_COMMUNICATION;
+	}
+
+	RPC_res = me_open_proc_1(&iFlags, clnt);
+	if (!RPC_res)
+	{
+		LIBPERROR("me_open_proc_1()=ME_ERRNO_COMMUNICATION\n");
+		err = ME_ERRNO_COMMUNICATION;
+	}
+	else
+	{
+		err = *RPC_res;
+		free(RPC_res);
+	}
+
+	if (!err)
+	{
+		RPC_res = me_event_channel_proc_1(&iFlags, clnt);
+		if (!RPC_res)
+		{
+			clnt_geterr(clnt, &rpc_err);
+			if (rpc_err.re_status == RPC_PROCUNAVAIL)
+			{
+				LIBPINFO("Server %s has no event channel.\n", context->access_point_addr);
+				channel->unsupported = 1;
+				err = ME_ERRNO_NOT_SUPPORTED;
+			}
+			else
+			{
+				LIBPERROR("me_event_channel_proc_1()=ME_ERRNO_COMMUNICATION\n");
+				err = ME_ERRNO_COMMUNICATION;
+			}
+		}
+		else
+		{
+			err = *RPC_res;
+			free(RPC_res);
+		}
+	}
+
+	if (!err)
+	{// Socket is taken over from RPC client.
+		clnt_control(clnt, CLGET_FD, (char *)&channel->sock);
+		clnt_control(clnt, CLSET_FD_NCLOSE, NULL);
+	}
+	clnt_destroy(clnt);
+
+	if (err)
+		return err;
+
+	xdrrec_create(&channel->xdrs_in, 0, 0, (void *)channel, eventRead, eventWrite);
+	xdrrec_create(&channel->xdrs_out, 0, 0, (void *)channel, eventRead, eventWrite);
+
+	// Restore subscriptions after reconnection.
+	for (sub = channel->subs; sub && !err; sub = sub->next)
+	{
+		err = eventSend(channel, sub, 1);
+	}
+
+	if (!err)
+	{
+		if (pthread_create(&thread, NULL, eventThread_RPC, channel))
+		{
+			LIBPERROR("Can not create event channel's thread.\n");
+			err = ME_ERRNO_START_THREAD;
+		}
+		else
+		{
+			pthread_detach(thread);
+			channel->threads++;
+		}
+	}
+
+	if (err)
+	{
+		eventDisconnect(channel);
+	}
+
+	return err;
+}
+
+static void eventRemove(me_rpc_event_channel_t* channel, me_rpc_event_sub_t* sub)
+{/// @note Call with channel's mutex locked. Only unlinks.
+	me_rpc_event_sub_t** link;
+
+	for (link = &channel->subs; *link; link = &(*link)->next)
+	{
+		if (*link == sub)
+		{
+			*link = sub->next;
+			break;
+		}
+	}
+}
+
+static void eventFree(me_rpc_event_channel_t* channel)
+{
+	me_rpc_event_sub_t* sub;
+
+	eventDisconnect(channel);
+
+	while (channel->subs)
+	{
+		sub = channel->subs;
+		channel->subs = sub->next;
+		free(sub);
+	}
+
+	pthread_cond_destroy(&channel->stopped);
+	pthread_mutex_destroy(&channel->mutex);
+	free(channel);
+}
+
+static void eventDispatch(me_rpc_event_channel_t* channel, me_event* event)
+{
+	me_rpc_context_t* context = channel->context;
+	me_rpc_event_sub_t* sub;
+	void* fnCB = NULL;
+	void* contextCB = NULL;
+	int ret = 0;
+
+	// Same lock as cancel: no callback after subscription is removed.
+	pthread_mutex_lock(&context->callbackContextMutex);
+		pthread_mutex_lock(&channel->mutex);
+			for (sub = channel->subs; sub; sub = sub->next)
+			{
+				if ((sub->type == event->type) && (sub->device == event->device) && (sub->subdevice == event->subdevice))
+				{
+					fnCB = sub->fnCB;
+					contextCB = sub->contextCB;
+					break;
+				}
+			}
+		pthread_mutex_unlock(&channel->mutex);
+
+		if (fnCB)
+		{
+			LIBPDEBUG("device[%d,%d] =>> CALLBACK type=%d\n", event->device, event->subdevice, event->type);
+			if (event->type == ME_EVENT_IRQ)
+			{
+				ret = ((meIOIrqCB_t)fnCB)(event->device, event->subdevice, 0, event->count, event->value, contextCB, event->error);
+			}
+			else
+			{
+				ret = ((meIOStreamCB_t)fnCB)(event->device, event->subdevice, event->count, contextCB, event->error);
+			}
+		}
+	pthread_mutex_unlock(&context->callbackContextMutex);
+
+	if (!fnCB)
+		return;
+
+	if ((event->type == ME_EVENT_IRQ) && ret && !event->error)
+	{/// Interrupt ONLY.
+		IrqStop_RPC(context, event->device, event->subdevice, 0, ME_IO_IRQ_STOP_NO_FLAGS);
+	}
+	else if ((event->type == ME_EVENT_STREAM_NEW_VALUES) && !ret)
+	{
+		StreamStop_RPC(context, event->device, event->subdevice, ME_STOP_MODE_IMMEDIATE, 0, ME_IO_STREAM_STOP_NO_FLAGS);
+	}
+}
+
+static void* eventThread_RPC(void* arg)
+{
+	me_rpc_event_channel_t* channel = (me_rpc_event_channel_t *)arg;
+	me_rpc_event_sub_t* sub;
+	me_event* lost = NULL;
+	me_event event;
+	int count = 0;
+	int i;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	dispatching = channel;
+
+	while (!channel->orphan)
+	{
+		channel->xdrs_in.x_op = XDR_DECODE;
+		if (!xdrrec_skiprecord(&channel->xdrs_in) || !xdr_me_event(&channel->xdrs_in, &event))
+			break;
+
+		eventDispatch(channel, &event);
+	}
+
+	pthread_mutex_lock(&channel->mutex);
+		if (!channel->closing)
+		{// Connection lost. Every subscriber gets error once. Next subscription reconnects.
+			LIBPERROR("Event channel to %s lost.\n", channel->context->access_point_addr);
+			eventDisconnect(channel);
+
+			for (sub = channel->subs; sub; sub = sub->next)
+				count++;
+
+			lost = calloc(count + 1, sizeof(me_event));
+			for (sub = channel->subs, i = 0; sub && lost; sub = sub->next, i++)
+			{
+				lost[i].type = sub->type;
+				lost[i].device = sub->device;
+				lost[i].subdevice = sub->subdevice;
+				lost[i].error = ME_ERRNO_COMMUNICATION;
+			}
+		}
+	pthread_mutex_unlock(&channel->mutex);
+
+	if (lost)
+	{// List can change in callbacks. Dispatch looks for subscriber again.
+		for (i = 0; (i < count) && !channel->closing; i++)
+		{
+			eventDispatch(channel, lost + i);
+		}
+		free(lost);
+	}
+
+	pthread_mutex_lock(&channel->mutex);
+		channel->threads--;
+		if (channel->orphan && !channel->threads)
+		{
+			pthread_mutex_unlock(&channel->mutex);
+			eventFree(channel);
+			return NULL;
+		}
+		pthread_cond_broadcast(&channel->stopped);
+	pthread_mutex_unlock(&channel->mutex);
+
+	return NULL;
+}
+
+int EventSubscribe_RPC(me_rpc_context_t* context, int type, int device, int subdevice, void* fnCB, void* contextCB, int iFlags)
+{
+	me_rpc_event_channel_t* channel;
+	me_rpc_event_sub_t* sub;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+	LIBPDEBUG("type=%d device=%d subdevice=%d fnCB=%p contextCB=%p iFlags=0x%x\n", type, device, subdevice, fnCB, contextCB, iFlags);
+
+	pthread_mutex_lock(&channels_mutex);
+		channel = context->event_channel;
+		if (!channel)
+		{
+			channel = calloc(1, sizeof(me_rpc_event_channel_t));
+			if (channel)
+			{
+				pthread_mutex_init(&channel->mutex, NULL);
+				pthread_cond_init(&channel->stopped, NULL);
+				channel->context = context;
+				channel->sock = -1;
+				context->event_channel = channel;
+			}
+		}
+	pthread_mutex_unlock(&channels_mutex);
+
+	if (!channel)
+	{
+		LIBPERROR("Can not get requested memory for event channel.\n");
+		return -ENOMEM;
+	}
+
+	pthread_mutex_lock(&channel->mutex);
+		if (channel->unsupported)
+		{
+			err = ME_ERRNO_NOT_SUPPORTED;
+			goto EXIT;
+		}
+
+		for (sub = channel->subs; sub; sub = sub->next)
+		{
+			if ((sub->type == type) && (sub->device == device) && (sub->subdevice == subdevice))
+				break;
+		}
+
+		if (sub)
+		{// Replaced. Registered again at the head of list.
+			eventRemove(channel, sub);
+		}
+		else
+		{
+			sub = calloc(1, sizeof(me_rpc_event_sub_t));
+			if (!sub)
+			{
+				err = -ENOMEM;
+				goto EXIT;
+			}
+
+		}
+
+		sub->type = type;
+		sub->device = device;
+		sub->subdevice = subdevice;
+		sub->next = channel->subs;
+		channel->subs = sub;
+
+		sub->fnCB = fnCB;
+		sub->contextCB = contextCB;
+		sub->flags = iFlags;
+
+		if (channel->sock < 0)
+		{// Sends all subscriptions.
+			err = eventConnect(channel);
+		}
+		else
+		{
+			err = eventSend(channel, sub, 1);
+		}
+
+		if (err)
+		{// Not registered.
+			channel->subs = sub->next;
+			free(sub);
+		}
+EXIT:
+	pthread_mutex_unlock(&channel->mutex);
+
+	return err;
+}
+
+int EventUnsubscribe_RPC(me_rpc_context_t* context, int device, int subdevice)
+{
+	me_rpc_event_channel_t* channel = context->event_channel;
+	me_rpc_event_sub_t** link;
+	me_rpc_event_sub_t* sub;
+
+	if (!channel)
+		return ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	pthread_mutex_lock(&channel->mutex);
+		link = &channel->subs;
+		while (*link)
+		{
+			sub = *link;
+			if ((device < 0) || ((sub->device == device) && ((subdevice < 0) || (sub->subdevice == subdevice))))
+			{
+				*link = sub->next;
+				if (channel->sock >= 0)
+				{
+					eventSend(channel, sub, 0);
+				}
+				free(sub);
+			}
+			else
+			{
+				link = &sub->next;
+			}
+		}
+	pthread_mutex_unlock(&channel->mutex);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+void EventClose_RPC(me_rpc_context_t* context)
+{
+	me_rpc_event_channel_t* channel;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	pthread_mutex_lock(&channels_mutex);
+		channel = context->event_channel;
+		context->event_channel = NULL;
+	pthread_mutex_unlock(&channels_mutex);
+
+	if (!channel)
+		return;
+
+	pthread_mutex_lock(&channel->mutex);
+		channel->closing = 1;
+		if (channel->sock >= 0)
+		{// Wakes dispatcher.
+			shutdown(channel->sock, SHUT_RDWR);
+		}
+
+		if (dispatching == channel)
+		{// Called from callback. Dispatcher can not wait for itself.
+			channel->orphan = 1;
+			pthread_mutex_unlock(&channel->mutex);
+			return;
+		}
+
+		while (channel->threads)
+		{
+			pthread_cond_wait(&channel->stopped, &channel->mutex);
+		}
+	pthread_mutex_unlock(&channel->mutex);
+
+	eventFree(channel);
+}
@@ -0,0 +1,21 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_RPC_EVENT_H_
+#  define _MEIDS_RPC_EVENT_H_
+
+#  include "meids_config_structs.h"
+
+/**
+ * Event channel of remote context.
+ *
+ * One extra connection per context. Server pushes IRQ and new values events on it,
+ * one thread dispatches them to registered callbacks. Other calls on the context are not blocked.
+ * Servers without ME_EVENT_CHANNEL_PROC return ME_ERRNO_NOT_SUPPORTED. Callers use polling threads then.
+ */
+int  EventSubscribe_RPC(me_rpc_context_t* context, int type, int device, int subdevice, void* fnCB, void* contextCB, int iFlags);
+/// Negative device or subdevice matches all.
+int  EventUnsubscribe_RPC(me_rpc_context_t* context, int device, int subdevice);
+/// Closes channel. Subscriptions have to be removed before.
+void EventClose_RPC(me_rpc_context_t* context);
+
+# endif	//_MEIDS_RPC_EVENT_H_
+#endif	//__KERNEL__
@@ -0,0 +1,423 @@
+/* Scan sessions for Meilhaus driver system.
+ * ==========================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <errno.h>
+# include <syslog.h>
+# include <pthread.h>
+
+# include "me_error.h"
+# include "me_defines.h"
+# include "me_types.h"
+# include "meids.h"
+# include "meids_debug.h"
+# include "meids_convert.h"
+# include "meids_utility.h"
+# include "medriver.h"
+
+typedef struct me_scan_session
+{
+	struct me_scan_session* next;
+
+	int device;
+	int subdevice;
+	int count;			// Values in one scan.
+	int flags;
+
+	int* buffer;		// One scan.
+	int filled;			// Armed mode: values of current scan already read.
+	int opening;		// Listed to keep subdevice reserved, stream not configured yet.
+
+	// Scaling: value = raw * gain + offset. Raw is saturated to [0, max_data].
+	int max_data;
+	double gain;
+	double offset;
+
+	pthread_mutex_t mutex;	// Serializes scans.
+} me_scan_session_t;
+
+static me_scan_session_t* sessions = NULL;
+static pthread_mutex_t sessions_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static me_scan_session_t* scanFind(int iDevice, int iSubdevice)
+{/// @note Call with sessions_mutex locked.
+	me_scan_session_t* session;
+
+	for (session = sessions; session; session = session->next)
+	{
+		if ((session->device == iDevice) && (session->subdevice == iSubdevice))
+			break;
+	}
+
+	return session;
+}
+
+static void scanUnlink(me_scan_session_t* session)
+{/// @note Call with sessions_mutex locked.
+	me_scan_session_t** link;
+
+	for (link = &sessions; *link; link = &(*link)->next)
+	{
+		if (*link == session)
+		{
+			*link = session->next;
+			break;
+		}
+	}
+}
+
+static void scanFree(me_scan_session_t* session)
+{
+	free(session->buffer);
+	free(session);
+}
+
+int meScanSessionOpen(int iDevice, int iSubdevice, int* piCount, int iRange, int iTriggerType, int iTriggerEdge, int iSessionFlags, int iFlags)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_scan_session_t* session = NULL;
+	meIOStreamSimpleConfig_t* config_list = NULL;
+	meIOStreamSimpleTriggers_t trigger;
+	unsigned int channels;
+	unsigned int max_data;
+	double min;
+	double max;
+	int unit;
+	int i;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+	LIBPDEBUG("iDevice=%d iSubdevice=%d piCount=0x%p iRange=%d iTriggerType=0x%x iTriggerEdge=0x%x iSessionFlags=0x%x iFlags=0x%x\n",
+				iDevice, iSubdevice, piCount, iRange, iTriggerType, iTriggerEdge, iSessionFlags, iFlags);
+
+	if (!piCount)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
+	}
+
+	if (*piCount <= 0)
+	{
+		err = ME_ERRNO_INVALID_VALUE_COUNT;
+		goto ERROR;
+	}
+
+	if (iSessionFlags & ~ME_SCAN_SESSION_ARMED)
+	{
+		err = ME_ERRNO_INVALID_FLAGS;
+		goto ERROR;
+	}
+
+	memset(&trigger, 0, sizeof(meIOStreamSimpleTriggers_t));
+	switch (iTriggerType)
+	{
+		case ME_TRIG_TYPE_NONE:
+		case ME_TRIG_TYPE_SW:
+			if (iSessionFlags & ME_SCAN_SESSION_ARMED)
+			{// Nothing would start scans.
+				err = ME_ERRNO_INVALID_TRIG_TYPE;
+				goto ERROR;
+			}
+			trigger.trigger_type = ME_TRIGGER_TYPE_SOFTWARE;
+			break;
+
+		case ME_TRIG_TYPE_EXT_DIGITAL:
+			trigger.trigger_type = (iSessionFlags & ME_SCAN_SESSION_ARMED) ? ME_TRIGGER_TYPE_LIST_DIGITAL : ME_TRIGGER_TYPE_ACQ_DIGITAL;
+			break;
+
+		case ME_TRIG_TYPE_EXT_ANALOG:
+			trigger.trigger_type = (iSessionFlags & ME_SCAN_SESSION_ARMED) ? ME_TRIGGER_TYPE_LIST_ANALOG : ME_TRIGGER_TYPE_ACQ_ANALOG;
+			break;
+
+		default:
+			err = ME_ERRNO_INVALID_TRIG_TYPE;
+			goto ERROR;
+	}
+
+	err = ME_QueryChannelsNumber(iDevice, iSubdevice, &channels, ME_QUERY_NO_FLAGS);
+	if (err)
+		goto ERROR;
+
+	if (iFlags & ME_STREAM_CONFIG_DIFFERENTIAL)
+	{// Differential mode uses 2 channels per entry. Support for differential mode is checked in driver.
+		channels /= 2;
+	}
+
+	if ((unsigned int)*piCount > channels)
+	{
+		*piCount = channels;
+	}
+
+	if (!*piCount)
+	{
+		err = ME_ERRNO_INVALID_VALUE_COUNT;
+		goto ERROR;
+	}
+
+	err = ME_QueryRangeInfo(iDevice, iSubdevice, iRange, &unit, &min, &max, &max_data, ME_QUERY_NO_FLAGS);
+	if (err)
+		goto ERROR;
+
+	if (!max_data)
+	{
+		err = ME_ERRNO_INVALID_MIN_MAX;
+		goto ERROR;
+	}
+
+	session = calloc(1, sizeof(me_scan_session_t));
+	if (!session)
+	{
+		err = -ENOMEM;
+		goto ERROR;
+	}
+
+	session->device = iDevice;
+	session->subdevice = iSubdevice;
+	session->count = *piCount;
+	session->flags = iSessionFlags;
+	session->max_data = max_data;
+	session->gain = (max - min) / max_data;
+	session->offset = min;
+
+	session->buffer = calloc(session->count, sizeof(int));
+	config_list = calloc(session->count, sizeof(meIOStreamSimpleConfig_t));
+	if (!session->buffer || !config_list)
+	{
+		err = -ENOMEM;
+		goto ERROR;
+	}
+
+	for (i = 0; i < session->count; i++)
+	{
+		config_list[i].iRange = iRange;
+		config_list[i].iChannel = i;
+	}
+
+	trigger.trigger_edge = iTriggerEdge;
+	trigger.acq_ticks = 0;	// Maximum speed.
+	trigger.scan_ticks = 0;	// Maximum speed.
+	trigger.conv_ticks = 0;	// Maximum speed.
+	trigger.synchro = ME_TRIG_CHAN_NONE;
+	if (iSessionFlags & ME_SCAN_SESSION_ARMED)
+	{// Runs until session is closed. Every trigger starts one scan.
+		trigger.stop_type = ME_STREAM_STOP_TYPE_MANUAL;
+		trigger.stop_count = 0;
+	}
+	else
+	{
+		trigger.stop_type = ME_STREAM_STOP_TYPE_SCAN_VALUE;
+		trigger.stop_count = session->count;
+	}
+
+	// Reserve subdevice. Configuration is done outside sessions_mutex, so other devices are not blocked.
+	pthread_mutex_init(&session->mutex, NULL);
+	session->opening = 1;
+	pthread_mutex_lock(&sessions_mutex);
+		if (scanFind(iDevice, iSubdevice))
+		{
+			err = ME_ERRNO_SUBDEVICE_BUSY;
+		}
+		else
+		{
+			session->next = sessions;
+			sessions = session;
+		}
+	pthread_mutex_unlock(&sessions_mutex);
+
+	if (err)
+	{
+		pthread_mutex_destroy(&session->mutex);
+		goto ERROR;
+	}
+
+	err = ME_StreamConfigure(iDevice, iSubdevice, config_list, session->count, &trigger, ME_VALUE_NOT_USED, iFlags);
+	if (!err && (iSessionFlags & ME_SCAN_SESSION_ARMED))
+	{
+		err = ME_StreamStart(iDevice, iSubdevice, ME_START_MODE_NONBLOCKING, 0, ME_IO_STREAM_START_NO_FLAGS);
+		if (err)
+		{// Do not leave configured stream behind.
+			ME_ResetSubdevice(iDevice, iSubdevice, ME_IO_RESET_SUBDEVICE_NO_FLAGS);
+		}
+	}
+
+	pthread_mutex_lock(&sessions_mutex);
+		if (err)
+		{
+			scanUnlink(session);
+		}
+		else
+		{
+			session->opening = 0;
+		}
+	pthread_mutex_unlock(&sessions_mutex);
+
+	if (err)
+		pthread_mutex_destroy(&session->mutex);
+
+ERROR:
+	free(config_list);
+	if (err)
+	{
+		if (session)
+			scanFree(session);
+
+		if (piCount)
+			*piCount = 0;
+	}
+
+	ME_SetErrno("meScanSessionOpen()", err);
+
+	return err;
+}
+
+int meScanSessionRead(int iDevice, int iSubdevice, double* pdValue, int* piCount, int iTimeout)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_scan_session_t* session;
+	int count;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (!pdValue || !piCount)
+	{
+		err = ME_ERRNO_INVALID_POINTER;
+		goto ERROR;
+	}
+
+	pthread_mutex_lock(&sessions_mutex);
+		session = scanFind(iDevice, iSubdevice);
+		if (session && session->opening)
+		{// Not ready yet.
+			session = NULL;
+		}
+
+		if (session)
+		{
+			pthread_mutex_lock(&session->mutex);
+		}
+	pthread_mutex_unlock(&sessions_mutex);
+
+	if (!session)
+	{
+		err = ME_ERRNO_SUBDEVICE_NOT_RUNNING;
+		goto ERROR;
+	}
+
+	if (*piCount < session->count)
+	{
+		err = ME_ERRNO_USER_BUFFER_SIZE;
+		goto UNLOCK;
+	}
+
+	if (session->flags & ME_SCAN_SESSION_ARMED)
+	{// Stream is running. Part of scan read before timeout is kept for next call.
+		count = session->count - session->filled;
+		err = ME_StreamRead(iDevice, iSubdevice, ME_READ_MODE_BLOCKING, session->buffer + session->filled, &count, iTimeout, ME_IO_STREAM_READ_NO_FLAGS);
+		if (count > 0)
+			session->filled += count;
+
+		if (!err && (session->filled < session->count))
+			err = ME_ERRNO_TIMEOUT;
+
+		if (err)
+			goto UNLOCK;
+
+		session->filled = 0;
+		count = session->count;
+	}
+	else
+	{
+		err = ME_StreamStart(iDevice, iSubdevice, ME_START_MODE_BLOCKING, iTimeout, ME_IO_STREAM_START_NO_FLAGS);
+		if (err)
+			goto UNLOCK;
+
+		count = session->count;
+		err = ME_StreamRead(iDevice, iSubdevice, ME_READ_MODE_BLOCKING, session->buffer, &count, iTimeout, ME_IO_STREAM_READ_NO_FLAGS);
+		if (err)
+			goto UNLOCK;
+	}
+
+	meids_convert_get_calls()->IntToDouble(session->buffer, pdValue, count, session->max_data, session->gain, session->offset);
+	*piCount = count;
+
+UNLOCK:
+	pthread_mutex_unlock(&session->mutex);
+
+ERROR:
+	if (err)
+	{
+		if (piCount)
+			*piCount = 0;
+	}
+
+	ME_SetErrno("meScanSessionRead()", err);
+
+	return err;
+}
+
+int meScanSessionClose(int iDevice, int iSubdevice)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_scan_session_t* session;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	pthread_mutex_lock(&sessions_mutex);
+		session = scanFind(iDevice, iSubdevice);
+		if (session && session->opening)
+		{// Not ready yet. Owned by meScanSessionOpen().
+			session = NULL;
+		}
+
+		if (session)
+		{
+			scanUnlink(session);
+		}
+	pthread_mutex_unlock(&sessions_mutex);
+
+	if (!session)
+	{
+		err = ME_ERRNO_SUBDEVICE_NOT_RUNNING;
+		goto ERROR;
+	}
+
+	// Wait for scan in progress.
+	pthread_mutex_lock(&session->mutex);
+		if (session->flags & ME_SCAN_SESSION_ARMED)
+		{
+			err = ME_StreamStop(iDevice, iSubdevice, ME_STOP_MODE_IMMEDIATE, 0, ME_IO_STREAM_STOP_NO_FLAGS);
+		}
+	pthread_mutex_unlock(&session->mutex);
+
+	pthread_mutex_destroy(&session->mutex);
+	scanFree(session);
+
+ERROR:
+	ME_SetErrno("meScanSessionClose()", err);
+
+	return err;
+}
@@ -0,0 +1,3534 @@
+/* Shared library for Meilhaus driver system (simulated devices).
+ * ==============================================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <stddef.h>
+# include <stdint.h>
+# include <string.h>
+# include <errno.h>
+# include <time.h>
+# include <pthread.h>
+
+# include <float.h>
+# include <math.h>
+
+# include "me_error.h"
+# include "me_types.h"
+# include "me_defines.h"
+# include "me_structs.h"
+
+# include "meids_common.h"
+# include "meids_internal.h"
+# include "meids_debug.h"
+# include "meids_sim_calls.h"
+
+# define ME_SIM_MAX_DEVICES				64
+# define ME_SIM_MAX_CHANNELS			256
+# define ME_SIM_MAX_SUBDEVICES			64
+# define ME_SIM_AI_LIST_SIZE			1024
+# define ME_SIM_CTR_WIDTH				16
+# define ME_SIM_MAX_TICKS				0xFFFFFFFFLL
+/// Waveform's lookup table. MUST BE a power of 2.
+# define ME_SIM_WAVEFORM_SIZE			4096
+/// Longest single sleep [ns]. Waiters re-check their conditions at least this often.
+# define ME_SIM_MAX_WAIT				1000000000ULL
+/// Latency below this value [us] is made by busy waiting.
+# define ME_SIM_SPIN_LATENCY			100
+/// Callback threads check cancellation at least this often [ms].
+# define ME_SIM_THREAD_SLICE			100
+
+typedef enum me_sim_waveform
+{
+	me_sim_waveform_sine = 0,
+	me_sim_waveform_square,
+	me_sim_waveform_triangle,
+	me_sim_waveform_sawtooth,
+	me_sim_waveform_ramp,
+	me_sim_waveform_noise,
+	me_sim_waveform_dc,
+	me_sim_waveform_max
+} me_sim_waveform_t;
+
+static const char* Sim_Waveform_Names[me_sim_waveform_max] = { "sine", "square", "triangle", "sawtooth", "ramp", "noise", "dc" };
+
+typedef struct me_sim_options
+{
+	int devices;
+	int ai_channels;
+	int ao_channels;
+	int dio_ports;
+	int counters;
+	int ai_rate;
+	int ao_rate;
+	int ai_fifo;
+	int ao_fifo;
+	int buffer;
+	int latency;
+	int irq_rate;
+	int waveform;
+	double frequency;
+	double amplitude;
+	double noise;
+} me_sim_options_t;
+
+typedef struct me_sim_option
+{
+	const char* name;
+	int is_double;
+	size_t offset;
+	double min;
+	double max;
+} me_sim_option_t;
+
+# define ME_SIM_INT_OPTION(name, min, max)		{ #name, 0, offsetof(me_sim_options_t, name), min, max }
+# define ME_SIM_DOUBLE_OPTION(name, min, max)	{ #name, 1, offsetof(me_sim_options_t, name), min, max }
+
+static const me_sim_option_t Sim_Options[] =
+{
+	ME_SIM_INT_OPTION(devices, 1, ME_SIM_MAX_DEVICES),
+	ME_SIM_INT_OPTION(ai_channels, 0, ME_SIM_MAX_CHANNELS),
+	ME_SIM_INT_OPTION(ao_channels, 0, ME_SIM_MAX_CHANNELS),
+	ME_SIM_INT_OPTION(dio_ports, 0, ME_SIM_MAX_SUBDEVICES / 2),
+	ME_SIM_INT_OPTION(counters, 0, ME_SIM_MAX_SUBDEVICES / 2),
+	ME_SIM_INT_OPTION(ai_rate, 1, ME_SIM_BASE_FREQUENCY),
+	ME_SIM_INT_OPTION(ao_rate, 1, ME_SIM_BASE_FREQUENCY),
+	ME_SIM_INT_OPTION(ai_fifo, 2, 0x1000000),
+	ME_SIM_INT_OPTION(ao_fifo, 2, 0x1000000),
+	ME_SIM_INT_OPTION(buffer, 2, 0x10000000),
+	ME_SIM_INT_OPTION(latency, 0, 10000000),
+	ME_SIM_INT_OPTION(irq_rate, 0, 1000000),
+	ME_SIM_DOUBLE_OPTION(frequency, 0, 1E9),
+	ME_SIM_DOUBLE_OPTION(amplitude, 0, 1),
+	ME_SIM_DOUBLE_OPTION(noise, 0, 1),
+	{ NULL, 0, 0, 0, 0 }
+};
+
+typedef struct me_sim_range
+{
+	int unit;
+	double min;
+	double max;
+	unsigned int max_data;
+} me_sim_range_t;
+
+static const me_sim_range_t Sim_AI_Ranges[] =
+{
+	{ ME_UNIT_VOLT, -10.0, 10.0, 0xFFFF },
+	{ ME_UNIT_VOLT, 0.0, 10.0, 0xFFFF },
+	{ ME_UNIT_VOLT, -2.5, 2.5, 0xFFFF },
+	{ ME_UNIT_VOLT, 0.0, 2.5, 0xFFFF }
+};
+
+static const me_sim_range_t Sim_AO_Ranges[] =
+{
+	{ ME_UNIT_VOLT, -10.0, 10.0, 0xFFFF }
+};
+
+typedef struct ME_Sim_Device me_sim_device_t;
+
+typedef struct me_sim_subdevice
+{
+	me_sim_device_t* device;
+
+	int type;
+	int sub_type;
+	int channels;
+	const me_sim_range_t* ranges;
+	int range_count;
+	int locked;
+
+	/// Protects everything below. Condition is signalled on every change of state.
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+
+	// Single
+	int* single_range;
+	int* single_value;
+	uint64_t single_count;
+
+	int dio_value;
+	int dio_output;
+
+	int ctr_mode;
+	double ctr_clock;
+	int ctr_load;
+	uint64_t ctr_start;
+
+	// Stream
+	int configured;
+	int status;
+	int error;
+	int error_reported;
+	int empty_reads;
+
+	meIOStreamSimpleConfig_t* list;
+	int list_count;
+	int list_size;
+
+	uint64_t acq_ns;
+	uint64_t scan_ns;
+	uint64_t conv_ns;
+
+	/// Values in whole acquisition (UINT64_MAX: endless) and index where current one ends.
+	uint64_t stop_total;
+	uint64_t stop_at;
+	/// Values are visible (AI) or consumed (AO) in portions of this size.
+	uint64_t chunk;
+	int wraparound;
+
+	/// 0: never started.
+	uint64_t start_time;
+	/// AI: values read by user. AO: values written by user.
+	uint64_t position;
+	/// Last value reported by meIOStreamNewValues() with screen flag.
+	uint64_t reported;
+
+	uint64_t start_events;
+	uint64_t stop_events;
+	/// Incremented by reset. Cancels all stream's waiters.
+	uint64_t generation;
+
+	int buffer;
+	int fifo;
+	int rate;
+	int* data;
+	unsigned int seed;
+
+	// IRQ
+	int irq_enabled;
+	uint64_t irq_start;
+	uint64_t irq_soft;
+	uint64_t irq_seen;
+	/// Incremented by stop and reset. Cancels all IRQ's waiters.
+	uint64_t irq_generation;
+
+	// Latency probe (CLOCK_MONOTONIC)
+	uint64_t probe_write_time;
+	uint64_t probe_irq_time;
+	uint64_t probe_wake_time;
+	int probe_irq_count;
+} me_sim_subdevice_t;
+
+struct ME_Sim_Device
+{
+	int number;
+	int locked;
+	uint64_t open_time;
+
+	me_sim_options_t options;
+	double* waveform;
+
+	int subdevice_count;
+	me_sim_subdevice_t* subdevice_list;
+};
+
+static int   doCreateThread_Sim(me_sim_context_t* context, int device, int subdevice, void* fnThread, void* fnCB, void* contextCB, int iFlags);
+static int   doDestroyAllThreads_Sim(me_sim_context_t* context);
+static int   doDestroyThread_Sim(me_sim_context_t* context, int device, int subdevice);
+
+static void* irqThread_Sim(void* arg);
+static void* streamStartThread_Sim(void* arg);
+static void* streamStopThread_Sim(void* arg);
+static void* streamNewValuesThread_Sim(void* arg);
+
+static int QueryRangeByMinMax_calculate(void* context, int device, int subdevice, int unit, double min_val, double max_val, int* range, int iFlags);
+
+/// Set while user's callback is executed.
+static __thread int sim_in_callback;
+
+static inline uint64_t sim_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline uint64_t sim_deadline(uint64_t now, int timeout)
+{
+	return (timeout > 0) ? now + (uint64_t)timeout * 1000000ULL : UINT64_MAX;
+}
+
+static inline uint64_t sim_min(uint64_t a, uint64_t b)
+{
+	return (a < b) ? a : b;
+}
+
+static void sim_latency(me_sim_context_t* context)
+{
+	struct timespec ts;
+	uint64_t end;
+
+	if (context->latency <= 0)
+		return;
+
+	if (context->latency < ME_SIM_SPIN_LATENCY)
+	{
+		end = sim_now() + (uint64_t)context->latency * 1000;
+		while (sim_now() < end)
+			;
+	}
+	else
+	{
+		ts.tv_sec = context->latency / 1000000;
+		ts.tv_nsec = (context->latency % 1000000) * 1000;
+		while (nanosleep(&ts, &ts) && (errno == EINTR))
+			;
+	}
+}
+
+/// Sleeps on subdevice's condition until 'until' or any change of state. Mutex MUST be held.
+static void sim_wait(me_sim_subdevice_t* sub, uint64_t until)
+{
+	struct timespec ts;
+	uint64_t limit = sim_now() + ME_SIM_MAX_WAIT;
+
+	if (until > limit)
+		until = limit;
+
+	ts.tv_sec = until / 1000000000ULL;
+	ts.tv_nsec = until % 1000000000ULL;
+	pthread_cond_timedwait(&sub->cond, &sub->mutex, &ts);
+}
+
+static int sim_get_device(me_sim_context_t* context, int device, me_sim_device_t** dev)
+{
+	if (!context->device_list)
+	{
+		LIBPERROR("Simulation is not open.\n");
+		return ME_ERRNO_NOT_OPEN;
+	}
+
+	if ((device < 0) || (device >= context->device_count))
+	{
+		LIBPERROR("Invalid device number specified. device=%d\n", device);
+		return ME_ERRNO_INVALID_DEVICE;
+	}
+
+	*dev = context->device_list + device;
+	return ME_ERRNO_SUCCESS;
+}
+
+static int sim_get_subdevice(me_sim_context_t* context, int device, int subdevice, me_sim_subdevice_t** sub)
+{
+	me_sim_device_t* dev;
+	int err;
+
+	err = sim_get_device(context, device, &dev);
+	if (err)
+		return err;
+
+	if ((subdevice < 0) || (subdevice >= dev->subdevice_count))
+	{
+		LIBPERROR("Invalid subdevice number specified. device=%d subdevice=%d\n", device, subdevice);
+		return ME_ERRNO_INVALID_SUBDEVICE;
+	}
+
+	*sub = dev->subdevice_list + subdevice;
+	return ME_ERRNO_SUCCESS;
+}
+
+static int sim_copy_name(char* name, int count, const char* source)
+{
+	if (count < (int)strlen(source) + 1)
+	{
+		LIBPERROR("User buffer too small. Need %d bytes.\n", (int)strlen(source) + 1);
+		return ME_ERRNO_USER_BUFFER_SIZE;
+	}
+
+	strcpy(name, source);
+	return ME_ERRNO_SUCCESS;
+}
+
+// Signal generator
+static void sim_build_waveform(me_sim_device_t* dev)
+{
+	int i;
+	double phase;
+	double* w = dev->waveform;
+
+	for (i = 0; i < ME_SIM_WAVEFORM_SIZE; i++)
+	{
+		phase = (double)i / ME_SIM_WAVEFORM_SIZE;
+		switch (dev->options.waveform)
+		{
+			case me_sim_waveform_sine:
+				w[i] = sin(2 * M_PI * phase);
+				break;
+
+			case me_sim_waveform_square:
+				w[i] = (phase < 0.5) ? 1.0 : -1.0;
+				break;
+
+			case me_sim_waveform_triangle:
+				w[i] = (phase < 0.5) ? 4 * phase - 1 : 3 - 4 * phase;
+				break;
+
+			case me_sim_waveform_sawtooth:
+				w[i] = 2 * phase - 1;
+				break;
+
+			case me_sim_waveform_dc:
+				w[i] = 1.0;
+				break;
+
+			default:
+				w[i] = 0.0;
+		}
+	}
+}
+
+static inline double sim_random(me_sim_subdevice_t* sub)
+{/// xorshift32 -> [-1, 1)
+	unsigned int x = sub->seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	sub->seed = x;
+
+	return (double)x / 2147483648.0 - 1.0;
+}
+
+/// Sample of 'channel' at time 't' [ns] from start. Index is used by ramp.
+static int sim_sample(me_sim_subdevice_t* sub, int channel, unsigned int max_data, uint64_t t, uint64_t index)
+{
+	const me_sim_options_t* options = &sub->device->options;
+	double phase;
+	double w;
+	double v;
+
+	if (options->waveform == me_sim_waveform_ramp)
+	{
+		return (int)(index % ((uint64_t)max_data + 1));
+	}
+
+	if (options->waveform == me_sim_waveform_noise)
+	{
+		w = options->amplitude * sim_random(sub);
+	}
+	else
+	{
+		phase = t * 1E-9 * options->frequency + (double)channel / sub->channels;
+		phase -= floor(phase);
+		w = options->amplitude * sub->device->waveform[(int)(phase * ME_SIM_WAVEFORM_SIZE) & (ME_SIM_WAVEFORM_SIZE - 1)];
+	}
+
+	if (options->noise > 0)
+	{
+		w += options->noise * sim_random(sub);
+	}
+
+	v = (w + 1.0) * 0.5 * max_data + 0.5;
+	if (v < 0)
+		return 0;
+	if (v > max_data)
+		return max_data;
+	return (int)v;
+}
+
+// Stream model. All functions below expect subdevice's mutex held.
+static inline uint64_t sim_stream_index_time(me_sim_subdevice_t* sub, uint64_t index)
+{
+	return sub->start_time + sub->acq_ns + (index / sub->list_count) * sub->scan_ns + (index % sub->list_count) * sub->conv_ns;
+}
+
+/// Number of conversions made until 'now' (not limited by stop).
+static uint64_t sim_stream_done(me_sim_subdevice_t* sub, uint64_t now)
+{
+	uint64_t elapsed;
+	uint64_t in_scan;
+
+	if (!sub->start_time || (now < sub->start_time + sub->acq_ns))
+		return 0;
+
+	elapsed = now - sub->start_time - sub->acq_ns;
+	in_scan = (elapsed % sub->scan_ns) / sub->conv_ns + 1;
+	if (in_scan > sub->list_count)
+		in_scan = sub->list_count;
+
+	return (elapsed / sub->scan_ns) * sub->list_count + in_scan;
+}
+
+/// Values visible for user: AI - acquired, AO - consumed.
+static uint64_t sim_stream_visible(me_sim_subdevice_t* sub, uint64_t now)
+{
+	uint64_t done = sim_min(sim_stream_done(sub, now), sub->stop_at);
+
+	if ((sub->status == ME_STATUS_BUSY) && (done < sub->stop_at))
+	{
+		done -= done % sub->chunk;
+	}
+	return done;
+}
+
+static uint64_t sim_stream_next_event(me_sim_subdevice_t* sub, uint64_t now)
+{
+	uint64_t next;
+
+	if (sub->status != ME_STATUS_BUSY)
+		return UINT64_MAX;
+
+	next = sim_stream_visible(sub, now);
+	next = sim_min(next - next % sub->chunk + sub->chunk, sub->stop_at);
+	return sim_stream_index_time(sub, next - 1);
+}
+
+static uint64_t sim_stream_space(me_sim_subdevice_t* sub, uint64_t now)
+{
+	if (sub->wraparound)
+	{
+		return (sub->status == ME_STATUS_BUSY) ? 0 : sub->buffer - sub->position;
+	}
+	return sub->buffer - (sub->position - sim_min(sim_stream_visible(sub, now), sub->position));
+}
+
+static void sim_stream_end(me_sim_subdevice_t* sub, int status, int error)
+{
+	sub->status = status;
+	sub->error = error;
+	sub->error_reported = 0;
+	sub->stop_events++;
+	pthread_cond_broadcast(&sub->cond);
+}
+
+static void sim_stream_update(me_sim_subdevice_t* sub, uint64_t now)
+{
+	uint64_t done;
+
+	if (sub->status != ME_STATUS_BUSY)
+		return;
+
+	done = sim_min(sim_stream_done(sub, now), sub->stop_at);
+	if (sub->type == ME_TYPE_AI)
+	{
+		if (done - sub->position > sub->buffer)
+		{
+			LIBPERROR("Software buffer overflow.\n");
+			sub->stop_at = sub->position + sub->buffer;
+			sim_stream_end(sub, ME_STATUS_ERROR, ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW);
+			return;
+		}
+	}
+	else if (!sub->wraparound && (done > sub->position))
+	{
+		LIBPERROR("Software buffer underflow.\n");
+		sub->stop_at = sub->position;
+		sim_stream_end(sub, ME_STATUS_ERROR, ME_ERRNO_SOFTWARE_BUFFER_UNDERFLOW);
+		return;
+	}
+
+	if (done >= sub->stop_at)
+	{
+		sim_stream_end(sub, ME_STATUS_IDLE, ME_ERRNO_SUCCESS);
+	}
+}
+
+static void sim_stream_rearm(me_sim_subdevice_t* sub)
+{
+	sub->position = 0;
+	sub->reported = 0;
+	sub->start_time = 0;
+	sub->stop_at = sub->stop_total;
+	sub->empty_reads = 0;
+	if (sub->status == ME_STATUS_ERROR)
+		sub->status = ME_STATUS_IDLE;
+}
+
+static int sim_stream_start(me_sim_subdevice_t* sub, uint64_t t0)
+{
+	if (!sub->configured)
+	{
+		LIBPERROR("Stream not configured.\n");
+		return ME_ERRNO_PREVIOUS_CONFIG;
+	}
+
+	sim_stream_update(sub, t0);
+	if (sub->status == ME_STATUS_BUSY)
+	{
+		return ME_ERRNO_SUBDEVICE_BUSY;
+	}
+
+	if ((sub->type == ME_TYPE_AI) || sub->start_time)
+	{// AO keeps preloaded values.
+		sim_stream_rearm(sub);
+	}
+
+	sub->start_time = t0;
+	sub->status = ME_STATUS_BUSY;
+	sub->error = ME_ERRNO_SUCCESS;
+	sub->error_reported = 0;
+	sub->start_events++;
+	pthread_cond_broadcast(&sub->cond);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static int sim_stream_wait_start(me_sim_subdevice_t* sub, uint64_t deadline)
+{
+	uint64_t generation = sub->generation;
+	uint64_t first = sim_stream_index_time(sub, 0);
+	uint64_t now = sim_now();
+
+	while (now < first)
+	{
+		if (generation != sub->generation)
+			return ME_ERRNO_CANCELLED;
+
+		if (now >= deadline)
+			return ME_ERRNO_TIMEOUT;
+
+		sim_wait(sub, sim_min(first, deadline));
+		now = sim_now();
+	}
+	return ME_ERRNO_SUCCESS;
+}
+
+static int sim_stream_stop(me_sim_subdevice_t* sub, int mode, int flags, uint64_t now)
+{
+	uint64_t done;
+
+	sim_stream_update(sub, now);
+	if (sub->status != ME_STATUS_BUSY)
+		return ME_ERRNO_SUCCESS;
+
+	done = sim_min(sim_stream_done(sub, now), sub->stop_at);
+	if (mode == ME_STOP_MODE_IMMEDIATE)
+	{
+		sub->stop_at = done;
+		if ((sub->type == ME_TYPE_AI) && !(flags & ME_IO_STREAM_STOP_TYPE_PRESERVE_BUFFERS))
+		{
+			sub->position = done;
+		}
+		sim_stream_end(sub, ME_STATUS_IDLE, ME_ERRNO_SUCCESS);
+	}
+	else
+	{// Finish current scan.
+		if ((sub->type == ME_TYPE_AO) && !sub->wraparound)
+		{
+			done = sub->position;
+		}
+		else
+		{
+			done = (done / sub->list_count + 1) * sub->list_count;
+		}
+		sub->stop_at = sim_min(sub->stop_at, done);
+		sim_stream_update(sub, now);
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+/// AI: values ready to read. AO: free space in buffer.
+static int sim_stream_count(me_sim_subdevice_t* sub, uint64_t now)
+{
+	if (sub->type == ME_TYPE_AI)
+		return sim_stream_visible(sub, now) - sub->position;
+
+	return sim_stream_space(sub, now);
+}
+
+static void sim_ai_generate(me_sim_subdevice_t* sub, int* values, int count)
+{
+	uint64_t index = sub->position;
+	int p = index % sub->list_count;
+	uint64_t t = sim_stream_index_time(sub, index) - sub->start_time;
+	int i;
+
+	for (i = 0; i < count; i++, index++)
+	{
+		values[i] = sim_sample(sub, sub->list[p].iChannel, sub->ranges[sub->list[p].iRange].max_data, t, index);
+
+		if (++p == sub->list_count)
+		{
+			p = 0;
+			t += sub->scan_ns - (sub->list_count - 1) * sub->conv_ns;
+		}
+		else
+		{
+			t += sub->conv_ns;
+		}
+	}
+}
+
+static void sim_ao_store(me_sim_subdevice_t* sub, int* values, int count)
+{
+	int offset = sub->position % sub->buffer;
+	int first = sub->buffer - offset;
+
+	if (first > count)
+		first = count;
+
+	memcpy(sub->data + offset, values, first * sizeof(int));
+	memcpy(sub->data, values + first, (count - first) * sizeof(int));
+}
+
+static uint64_t sim_irq_total(me_sim_subdevice_t* sub, uint64_t now)
+{
+	uint64_t total = sub->irq_soft;
+	int rate = sub->device->options.irq_rate;
+
+	if (rate && (now > sub->irq_start))
+	{
+		total += (uint64_t)((now - sub->irq_start) * 1E-9 * rate);
+	}
+	return total;
+}
+
+static uint64_t sim_irq_next(me_sim_subdevice_t* sub, uint64_t now)
+{
+	int rate = sub->device->options.irq_rate;
+
+	if (!rate)
+		return UINT64_MAX;
+
+	return sub->irq_start + (uint64_t)((sim_irq_total(sub, now) - sub->irq_soft + 1) * 1E9 / rate);
+}
+
+static void sim_reset_subdevice(me_sim_subdevice_t* sub)
+{
+	int i;
+
+	pthread_mutex_lock(&sub->mutex);
+		if (sub->status == ME_STATUS_BUSY)
+		{
+			sub->stop_events++;
+		}
+		sub->configured = 0;
+		sub->status = ME_STATUS_IDLE;
+		sub->error = ME_ERRNO_SUCCESS;
+		sub->start_time = 0;
+		sub->position = 0;
+		sub->reported = 0;
+		sub->generation++;
+
+		sub->irq_enabled = 0;
+		sub->irq_generation++;
+
+		for (i = 0; i < sub->channels; i++)
+		{
+			sub->single_range[i] = 0;
+			sub->single_value[i] = (sub->type == ME_TYPE_AO) ? (sub->ranges[0].max_data + 1) / 2 : 0;
+		}
+		sub->dio_value = 0;
+		sub->dio_output = 0;
+		sub->ctr_mode = ME_SINGLE_CONFIG_CTR_8254_MODE_DISABLE;
+		sub->ctr_clock = 0;
+		sub->ctr_load = 0;
+
+		pthread_cond_broadcast(&sub->cond);
+	pthread_mutex_unlock(&sub->mutex);
+}
+
+// Building simulation
+static int sim_parse_options(const char* address, me_sim_options_t* options)
+{
+	const me_sim_option_t* option;
+	char* buffer;
+	char* name;
+	char* value;
+	char* end;
+	char* save = NULL;
+	double number;
+	int i;
+	int err = ME_ERRNO_SUCCESS;
+
+	memset(options, 0, sizeof(me_sim_options_t));
+	options->devices = 1;
+	options->ai_channels = 16;
+	options->ao_channels = 4;
+	options->dio_ports = 2;
+	options->counters = 3;
+	options->ai_rate = 500000;
+	options->ao_rate = 500000;
+	options->ai_fifo = 2048;
+	options->ao_fifo = 4096;
+	options->buffer = 65536;
+	options->latency = 0;
+	options->irq_rate = 0;
+	options->waveform = me_sim_waveform_sine;
+	options->frequency = 1000.0;
+	options->amplitude = 0.9;
+	options->noise = 0.0;
+
+	buffer = strdup(address + strlen(ME_SIM_ADDRESS_PREFIX));
+	if (!buffer)
+	{
+		return -ENOMEM;
+	}
+
+	for (name = strtok_r(buffer, ",", &save); name; name = strtok_r(NULL, ",", &save))
+	{
+		name = strip(name);
+		if (!name || !*name)
+			continue;
+
+		value = strchr(name, '=');
+		if (!value)
+		{
+			LIBPERROR("Simulation option '%s' without value.\n", name);
+			err = ME_ERRNO_OPEN;
+			break;
+		}
+		*value++ = '\0';
+		name = strip(name);
+		value = strip(value);
+
+		if (!strcmp(name, "waveform"))
+		{
+			for (i = 0; i < me_sim_waveform_max; i++)
+			{
+				if (!strcmp(value, Sim_Waveform_Names[i]))
+					break;
+			}
+			if (i == me_sim_waveform_max)
+			{
+				LIBPERROR("Unknown waveform '%s'.\n", value);
+				err = ME_ERRNO_OPEN;
+				break;
+			}
+			options->waveform = i;
+			continue;
+		}
+
+		for (option = Sim_Options; option->name; option++)
+		{
+			if (!strcmp(name, option->name))
+				break;
+		}
+		if (!option->name)
+		{
+			LIBPERROR("Unknown simulation option '%s'.\n", name);
+			err = ME_ERRNO_OPEN;
+			break;
+		}
+
+		number = strtod(value, &end);
+		if ((end == value) || *end || (number < option->min) || (number > option->max))
+		{
+			LIBPERROR("Invalid value '%s' for simulation option '%s'.\n", value, name);
+			err = ME_ERRNO_OPEN;
+			break;
+		}
+
+		if (option->is_double)
+			*(double *)((char *)options + option->offset) = number;
+		else
+			*(int *)((char *)options + option->offset) = (int)number;
+	}
+	free(buffer);
+
+	if (!err && (options->buffer < options->ai_fifo))
+	{
+		LIBPERROR("Simulated buffer smaller than FIFO.\n");
+		err = ME_ERRNO_OPEN;
+	}
+
+	return err;
+}
+
+static int sim_init_subdevice(me_sim_device_t* dev, me_sim_subdevice_t* sub, int type)
+{
+	pthread_condattr_t attr;
+	int channels;
+
+	sub->device = dev;
+	sub->type = type;
+	sub->seed = 0x9E3779B9 ^ (dev->number << 16) ^ (int)(sub - dev->subdevice_list);
+
+	switch (type)
+	{
+		case ME_TYPE_AI:
+			sub->sub_type = ME_SUBTYPE_STREAMING;
+			sub->channels = dev->options.ai_channels;
+			sub->ranges = Sim_AI_Ranges;
+			sub->range_count = sizeof(Sim_AI_Ranges) / sizeof(me_sim_range_t);
+			sub->list_size = ME_SIM_AI_LIST_SIZE;
+			sub->fifo = dev->options.ai_fifo;
+			sub->rate = dev->options.ai_rate;
+			break;
+
+		case ME_TYPE_AO:
+			sub->sub_type = ME_SUBTYPE_STREAMING;
+			sub->channels = dev->options.ao_channels;
+			sub->ranges = Sim_AO_Ranges;
+			sub->range_count = sizeof(Sim_AO_Ranges) / sizeof(me_sim_range_t);
+			sub->list_size = sub->channels;
+			sub->fifo = dev->options.ao_fifo;
+			sub->rate = dev->options.ao_rate;
+			break;
+
+		case ME_TYPE_DIO:
+			sub->sub_type = ME_SUBTYPE_SINGLE;
+			sub->channels = 8;
+			break;
+
+		case ME_TYPE_CTR:
+			sub->sub_type = ME_SUBTYPE_CTR_8254;
+			sub->channels = 1;
+			break;
+	}
+	sub->buffer = dev->options.buffer;
+	sub->status = ME_STATUS_IDLE;
+
+	channels = sub->channels;
+	sub->single_range = calloc(channels, sizeof(int));
+	sub->single_value = calloc(channels, sizeof(int));
+	if (sub->list_size)
+	{
+		sub->list = calloc(sub->list_size, sizeof(meIOStreamSimpleConfig_t));
+	}
+	if (type == ME_TYPE_AO)
+	{
+		sub->data = calloc(sub->buffer, sizeof(int));
+	}
+	if (!sub->single_range || !sub->single_value || (sub->list_size && !sub->list) || ((type == ME_TYPE_AO) && !sub->data))
+	{
+		LIBPERROR("Can not get requestet memory for simulated subdevice.\n");
+		return -ENOMEM;
+	}
+
+	pthread_mutex_init(&sub->mutex, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&sub->cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	sim_reset_subdevice(sub);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static void sim_free_device(me_sim_device_t* dev)
+{
+	me_sim_subdevice_t* sub;
+	int i;
+
+	if (dev->subdevice_list)
+	{
+		for (i = 0; i < dev->subdevice_count; i++)
+		{
+			sub = dev->subdevice_list + i;
+			if (sub->device)
+			{
+				pthread_mutex_destroy(&sub->mutex);
+				pthread_cond_destroy(&sub->cond);
+			}
+			free(sub->single_range);
+			free(sub->single_value);
+			free(sub->list);
+			free(sub->data);
+		}
+		free(dev->subdevice_list);
+		dev->subdevice_list = NULL;
+	}
+
+	free(dev->waveform);
+	dev->waveform = NULL;
+}
+
+static int sim_build_device(me_sim_device_t* dev, int number, const me_sim_options_t* options)
+{
+	me_sim_subdevice_t* sub;
+	int i;
+	int err = ME_ERRNO_SUCCESS;
+
+	dev->number = number;
+	dev->open_time = sim_now();
+	memcpy(&dev->options, options, sizeof(me_sim_options_t));
+
+	dev->waveform = calloc(ME_SIM_WAVEFORM_SIZE, sizeof(double));
+	dev->subdevice_count = (options->ai_channels > 0) + (options->ao_channels > 0) + options->dio_ports + options->counters;
+	dev->subdevice_list = calloc(dev->subdevice_count ? dev->subdevice_count : 1, sizeof(me_sim_subdevice_t));
+	if (!dev->waveform || !dev->subdevice_list)
+	{
+		LIBPERROR("Can not get requestet memory for simulated device.\n");
+		return -ENOMEM;
+	}
+	sim_build_waveform(dev);
+
+	sub = dev->subdevice_list;
+	if (options->ai_channels > 0)
+	{
+		err = sim_init_subdevice(dev, sub++, ME_TYPE_AI);
+	}
+	if (!err && (options->ao_channels > 0))
+	{
+		err = sim_init_subdevice(dev, sub++, ME_TYPE_AO);
+	}
+	for (i = 0; !err && (i < options->dio_ports); i++)
+	{
+		err = sim_init_subdevice(dev, sub++, ME_TYPE_DIO);
+	}
+	for (i = 0; !err && (i < options->counters); i++)
+	{
+		err = sim_init_subdevice(dev, sub++, ME_TYPE_CTR);
+	}
+
+	return err;
+}
+
+// Access
+int Open_Sim(me_sim_context_t* context, const char* address, int iFlags)
+{
+	me_sim_options_t options;
+	int i;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (iFlags != ME_OPEN_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (context->device_list)
+	{// Already open
+		LIBPDEBUG("Already open!\n");
+		return ME_ERRNO_SUCCESS;
+	}
+
+	if (!address || strncmp(address, ME_SIM_ADDRESS_PREFIX, strlen(ME_SIM_ADDRESS_PREFIX)))
+	{
+		LIBPERROR("Not a simulation address: '%s'\n", address ? address : "NULL");
+		return ME_ERRNO_OPEN;
+	}
+
+	err = sim_parse_options(address, &options);
+	if (err)
+	{
+		return err;
+	}
+
+	context->latency = options.latency;
+	context->device_list = calloc(options.devices, sizeof(me_sim_device_t));
+	if (!context->device_list)
+	{
+		LIBPERROR("Can not get requestet memory for simulated devices.\n");
+		return -ENOMEM;
+	}
+	context->device_count = options.devices;
+
+	for (i = 0; !err && (i < options.devices); i++)
+	{
+		err = sim_build_device(context->device_list + i, i, &options);
+	}
+
+	if (err)
+	{
+		for (i = 0; i < options.devices; i++)
+		{
+			sim_free_device(context->device_list + i);
+		}
+		free(context->device_list);
+		context->device_list = NULL;
+		context->device_count = 0;
+	}
+	else
+	{
+		LIBPDEBUG("Simulation '%s' open: %d device(s).\n", address, context->device_count);
+	}
+
+	return err;
+}
+
+int Close_Sim(me_sim_context_t* context, int iFlags)
+{
+	int i;
+	int j;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (iFlags != ME_CLOSE_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	doDestroyAllThreads_Sim(context);
+
+	if (!context->device_list)
+	{
+		// Already closed. This is not always an error. Standard routine call this function for every device on list.
+		LIBPDEBUG("Already close!\n");
+		return ME_ERRNO_SUCCESS;
+	}
+
+	for (i = 0; i < context->device_count; i++)
+	{
+		for (j = 0; j < context->device_list[i].subdevice_count; j++)
+		{
+			sim_reset_subdevice(context->device_list[i].subdevice_list + j);
+		}
+		sim_free_device(context->device_list + i);
+	}
+	free(context->device_list);
+	context->device_list = NULL;
+	context->device_count = 0;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+// Locks
+static int sim_lock(int* locked, int lock)
+{
+	switch (lock)
+	{
+		case ME_LOCK_SET:
+			*locked = 1;
+			break;
+
+		case ME_LOCK_RELEASE:
+			*locked = 0;
+			break;
+
+		case ME_LOCK_CHECK:
+			break;
+
+		default:
+			LIBPERROR("Invalid lock specified.\n");
+			return ME_ERRNO_INVALID_LOCK;
+	}
+	return ME_ERRNO_SUCCESS;
+}
+
+int LockDriver_Sim(void* context, int lock, int iFlags)
+{
+	me_sim_context_t* sim_context = (me_sim_context_t *)context;
+	int i;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+	LIBPDEBUG("lock=%d iFlags=0x%x\n", lock, iFlags);
+
+	sim_latency(sim_context);
+
+	for (i = 0; !err && (i < sim_context->device_count); i++)
+	{
+		err = sim_lock(&sim_context->device_list[i].locked, lock);
+	}
+
+	return err;
+}
+
+int LockDevice_Sim(void* context, int device, int lock, int iFlags)
+{
+	me_sim_context_t* sim_context = (me_sim_context_t *)context;
+	me_sim_device_t* dev;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+	LIBPDEBUG("device=%d lock=%d flags=0x%x\n", device, lock, iFlags);
+
+	sim_latency(sim_context);
+
+	err = sim_get_device(sim_context, device, &dev);
+	if (!err)
+	{
+		err = sim_lock(&dev->locked, lock);
+	}
+
+	return err;
+}
+
+int LockSubdevice_Sim(void* context, int device, int subdevice, int lock, int iFlags)
+{
+	me_sim_context_t* sim_context = (me_sim_context_t *)context;
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(context);
+
+	LIBPDEBUG("device=%d subdevice=%d lock=%d flags=0x%x\n", device, subdevice, lock, iFlags);
+
+	sim_latency(sim_context);
+
+	err = sim_get_subdevice(sim_context, device, subdevice, &sub);
+	if (!err)
+	{
+		err = sim_lock(&sub->locked, lock);
+	}
+
+	return err;
+}
+
+// Query
+int QueryDriverVersion_Sim(void* context, int* version, int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(version);
+
+	sim_latency((me_sim_context_t *)context);
+
+	*version = MEIDS_VERSION_LIBRARY;
+	return ME_ERRNO_SUCCESS;
+}
+
+int QueryDriverName_Sim(void* context, char* name, int count, int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(name);
+
+	sim_latency((me_sim_context_t *)context);
+
+	return sim_copy_name(name, count, ME_SIM_DRIVER_NAME);
+}
+
+int QuerySubdriverVersion_Sim(void* context, int device, int* version, int iFlags)
+{
+	me_sim_device_t* dev;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(version);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (!err)
+	{
+		*version = MEIDS_VERSION_LIBRARY;
+	}
+	return err;
+}
+
+int QuerySubdriverName_Sim(void* context, int device, char* name, int count, int iFlags)
+{
+	me_sim_device_t* dev;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(name);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (!err)
+	{
+		err = sim_copy_name(name, count, ME_SIM_DRIVER_NAME);
+	}
+	return err;
+}
+
+int QueryDeviceName_Sim(void* context, int device, char* name, int count, int iFlags)
+{
+	me_sim_device_t* dev;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(name);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (!err)
+	{
+		err = sim_copy_name(name, count, "ME-SIM");
+	}
+	return err;
+}
+
+int QueryDeviceDescription_Sim(void* context, int device, char* description, int count, int iFlags)
+{
+	me_sim_device_t* dev;
+	char text[128];
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(description);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (!err)
+	{
+		snprintf(text, sizeof(text), "Meilhaus simulated device (AI:%d AO:%d DIO:%d CTR:%d)",
+				dev->options.ai_channels, dev->options.ao_channels, dev->options.dio_ports, dev->options.counters);
+		err = sim_copy_name(description, count, text);
+	}
+	return err;
+}
+
+int QueryDevicesNumber_Sim(void* context, int* no_devices, int iFlags)
+{
+	me_sim_context_t* sim_context = (me_sim_context_t *)context;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(context);
+	CHECK_POINTER(no_devices);
+
+	sim_latency(sim_context);
+
+	*no_devices = sim_context->device_count;
+	return ME_ERRNO_SUCCESS;
+}
+
+int QueryDeviceInfo_Sim(void* context, int device,
+						unsigned int* vendor_id, unsigned int* device_id,
+						unsigned int* serial_no, unsigned int* bus_type, unsigned int* bus_no,
+						unsigned int* dev_no, unsigned int* func_no, int* plugged, int iFlags)
+{
+	me_sim_device_t* dev;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(vendor_id);
+	CHECK_POINTER(device_id);
+	CHECK_POINTER(serial_no);
+	CHECK_POINTER(bus_type);
+	CHECK_POINTER(bus_no);
+	CHECK_POINTER(dev_no);
+	CHECK_POINTER(func_no);
+	CHECK_POINTER(plugged);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (!err)
+	{
+		*vendor_id = ME_SIM_VENDOR_ID;
+		*device_id = ME_SIM_DEVICE_ID;
+		*serial_no = dev->number + 1;
+		*bus_type = ME_BUS_TYPE_SIMULATED;
+		*bus_no = 0;
+		*dev_no = dev->number;
+		*func_no = 0;
+		*plugged = ME_PLUGGED_IN;
+	}
+	return err;
+}
+
+int QuerySubdevicesNumber_Sim(void* context, int device, int* no_subdevices, int iFlags)
+{
+	me_sim_device_t* dev;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(no_subdevices);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (!err)
+	{
+		*no_subdevices = dev->subdevice_count;
+	}
+	return err;
+}
+
+static inline int sim_type_match(me_sim_subdevice_t* sub, int type, int subtype)
+{
+	return (sub->type == type) && ((subtype == ME_SUBTYPE_ANY) || (sub->sub_type == subtype));
+}
+
+int QuerySubdevicesNumberByType_Sim(void* context, int device, int type, int subtype, int* no_subdevices, int iFlags)
+{
+	me_sim_device_t* dev;
+	int i;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(no_subdevices);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (!err)
+	{
+		*no_subdevices = 0;
+		for (i = 0; i < dev->subdevice_count; i++)
+		{
+			if (sim_type_match(dev->subdevice_list + i, type, subtype))
+				(*no_subdevices)++;
+		}
+	}
+	return err;
+}
+
+int QuerySubdeviceType_Sim(void* context, int device, int subdevice, int* type, int* subtype, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(type);
+	CHECK_POINTER(subtype);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (!err)
+	{
+		*type = sub->type;
+		*subtype = sub->sub_type;
+	}
+	return err;
+}
+
+int QuerySubdeviceByType_Sim(void* context, int device, int subdevice, int type, int subtype, int* result, int iFlags)
+{
+	me_sim_device_t* dev;
+	int i;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(result);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (err)
+		return err;
+
+	for (i = (subdevice > 0) ? subdevice : 0; i < dev->subdevice_count; i++)
+	{
+		if (sim_type_match(dev->subdevice_list + i, type, subtype))
+		{
+			*result = i;
+			return ME_ERRNO_SUCCESS;
+		}
+	}
+
+	return ME_ERRNO_NOMORE_SUBDEVICE_TYPE;
+}
+
+int QuerySubdeviceCaps_Sim(void* context, int device, int subdevice, int* caps, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(caps);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	switch (sub->type)
+	{
+		case ME_TYPE_AI:
+			*caps = ME_CAPS_AI_TRIG_SYNCHRONOUS | ME_CAPS_AI_FIFO | ME_CAPS_AI_FIFO_THRESHOLD | ME_CAPS_AI_SAMPLE_HOLD | ME_CAPS_AI_DIFFERENTIAL
+					| ME_CAPS_AI_TRIG_DIGITAL | ME_CAPS_AI_TRIG_EDGE_RISING | ME_CAPS_AI_TRIG_EDGE_FALLING | ME_CAPS_AI_TRIG_EDGE_ANY;
+			break;
+
+		case ME_TYPE_AO:
+			*caps = ME_CAPS_AO_TRIG_SYNCHRONOUS | ME_CAPS_AO_FIFO | ME_CAPS_AO_FIFO_THRESHOLD
+					| ME_CAPS_AO_TRIG_DIGITAL | ME_CAPS_AO_TRIG_EDGE_RISING | ME_CAPS_AO_TRIG_EDGE_FALLING | ME_CAPS_AO_TRIG_EDGE_ANY;
+			break;
+
+		case ME_TYPE_DIO:
+			*caps = ME_CAPS_DIO_DIR_BIT | ME_CAPS_DIO_DIR_BYTE;
+			break;
+
+		case ME_TYPE_CTR:
+			*caps = ME_CAPS_CTR_CLK_PREVIOUS | ME_CAPS_CTR_CLK_INTERNAL_1MHZ | ME_CAPS_CTR_CLK_INTERNAL_10MHZ | ME_CAPS_CTR_CLK_EXTERNAL;
+			break;
+
+		default:
+			*caps = ME_CAPS_NONE;
+	}
+	return ME_ERRNO_SUCCESS;
+}
+
+int QuerySubdeviceCapsArgs_Sim(void* context, int device, int subdevice, int cap, int* args, int count, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(args);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if (count < 1)
+	{
+		LIBPERROR("Invalid capability argument count.\n");
+		return ME_ERRNO_INVALID_CAP_ARG_COUNT;
+	}
+
+	switch (sub->type)
+	{
+		case ME_TYPE_AI:
+			switch (cap)
+			{
+				case ME_CAP_AI_FIFO_SIZE:
+					*args = sub->fifo;
+					return ME_ERRNO_SUCCESS;
+
+				case ME_CAP_AI_BUFFER_SIZE:
+				case ME_CAP_AI_MAX_THRESHOLD_SIZE:
+					*args = sub->buffer;
+					return ME_ERRNO_SUCCESS;
+
+				case ME_CAP_AI_CHANNEL_LIST_SIZE:
+					*args = sub->list_size;
+					return ME_ERRNO_SUCCESS;
+			}
+			break;
+
+		case ME_TYPE_AO:
+			switch (cap)
+			{
+				case ME_CAP_AO_FIFO_SIZE:
+					*args = sub->fifo;
+					return ME_ERRNO_SUCCESS;
+
+				case ME_CAP_AO_BUFFER_SIZE:
+				case ME_CAP_AO_MAX_THRESHOLD_SIZE:
+					*args = sub->buffer;
+					return ME_ERRNO_SUCCESS;
+
+				case ME_CAP_AO_CHANNEL_LIST_SIZE:
+					*args = sub->list_size;
+					return ME_ERRNO_SUCCESS;
+			}
+			break;
+
+		case ME_TYPE_CTR:
+			if (cap == ME_CAP_CTR_WIDTH)
+			{
+				*args = ME_SIM_CTR_WIDTH;
+				return ME_ERRNO_SUCCESS;
+			}
+			break;
+	}
+
+	LIBPERROR("Invalid capability specified.\n");
+	return ME_ERRNO_INVALID_CAP;
+}
+
+int QuerySubdeviceTimer_Sim(void* context, int device, int subdevice, int timer,
+							int* base, int* min_ticks_low, int* min_ticks_high, int* max_ticks_low, int* max_ticks_high, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t min_ticks;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(base);
+	CHECK_POINTER(min_ticks_low);
+	CHECK_POINTER(min_ticks_high);
+	CHECK_POINTER(max_ticks_low);
+	CHECK_POINTER(max_ticks_high);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if (sub->sub_type != ME_SUBTYPE_STREAMING)
+	{
+		return ME_ERRNO_NOT_SUPPORTED;
+	}
+
+	if ((timer != ME_TIMER_ACQ_START) && (timer != ME_TIMER_SCAN_START) && (timer != ME_TIMER_CONV_START))
+	{
+		LIBPERROR("Invalid timer specified.\n");
+		return ME_ERRNO_INVALID_TIMER;
+	}
+
+	min_ticks = (ME_SIM_BASE_FREQUENCY + sub->rate - 1) / sub->rate;
+	if (timer == ME_TIMER_ACQ_START)
+	{
+		min_ticks = 0;
+	}
+
+	*base = ME_SIM_BASE_FREQUENCY;
+	*min_ticks_low = min_ticks;
+	*min_ticks_high = min_ticks >> 32;
+	*max_ticks_low = ME_SIM_MAX_TICKS & 0xFFFFFFFF;
+	*max_ticks_high = ME_SIM_MAX_TICKS >> 32;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int QueryLatencyProbe_Sim(void* context, int device, int subdevice, meLatencyProbe_t* probe, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (iFlags != ME_QUERY_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	CHECK_POINTER(probe);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	pthread_mutex_lock(&sub->mutex);
+		probe->ullWriteTime = sub->probe_write_time;
+		probe->ullIrqTime = sub->probe_irq_time;
+		probe->ullWakeTime = sub->probe_wake_time;
+		probe->iIrqCount = sub->probe_irq_count;
+	pthread_mutex_unlock(&sub->mutex);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int QueryChannelsNumber_Sim(void* context, int device, int subdevice, unsigned int* number, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(number);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (!err)
+	{
+		*number = sub->channels;
+	}
+	return err;
+}
+
+int QueryRangesNumber_Sim(void* context, int device, int subdevice, int unit, int* no_ranges, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int i;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(no_ranges);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (!err)
+	{
+		*no_ranges = 0;
+		for (i = 0; i < sub->range_count; i++)
+		{
+			if ((unit == ME_UNIT_ANY) || (sub->ranges[i].unit == unit))
+				(*no_ranges)++;
+		}
+	}
+	return err;
+}
+
+int QueryRangeInfo_Sim(void* context, int device, int subdevice, int range, int* unit, double* min, double* max, unsigned int* max_data, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (iFlags != ME_QUERY_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	CHECK_POINTER(context);
+	CHECK_POINTER(unit);
+	CHECK_POINTER(min);
+	CHECK_POINTER(max);
+	CHECK_POINTER(max_data);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if ((range < 0) || (range >= sub->range_count))
+	{
+		LIBPERROR("Invalid range specified.\n");
+		return ME_ERRNO_INVALID_RANGE;
+	}
+
+	*unit = sub->ranges[range].unit;
+	*min = sub->ranges[range].min;
+	*max = sub->ranges[range].max;
+	*max_data = sub->ranges[range].max_data;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static int QueryRangeByMinMax_calculate(void* context, int device, int subdevice, int unit, double min_val, double max_val, int* range, int iFlags)
+{
+	const float tolerance = 0.0001;	//0.1%
+
+	unsigned int i;
+	int r = -1;
+	double diff = FLT_MAX;
+	double range_diff;
+	double range_tolerance;
+
+	double			range_min;
+	double			range_max;
+	unsigned int	range_max_data;
+	int				range_unit;
+	int				no_ranges;
+
+	int err;
+
+	err = QueryRangesNumber_Sim(context, device, subdevice, unit, &no_ranges, iFlags);
+	if (err)
+	{
+		return err;
+	}
+
+	for (i = 0; i < no_ranges; ++i)
+	{
+		err = QueryRangeInfo_Sim(context, device, subdevice, i, &range_unit, &range_min, &range_max, &range_max_data, iFlags);
+		if (err)
+		{
+			return err;
+		}
+
+		range_tolerance = (range_max - range_min) * tolerance;
+		if ((range_min - range_tolerance <= min_val) && ((range_max + range_tolerance) >= max_val))
+		{
+			range_diff = ((range_max - max_val) * (range_max - max_val)) + ((range_min - min_val) * (range_min - min_val));
+			if (range_diff < diff)
+			{
+				r = i;
+				diff = range_diff;
+			}
+			if (range_diff == 0.0)
+			{// Perfect match
+				break;
+			}
+		}
+	}
+
+	*range = r;
+
+	return (r < 0) ? ME_ERRNO_NO_RANGE : ME_ERRNO_SUCCESS;
+}
+
+int QueryRangeByMinMax_Sim(void* context, int device, int subdevice, int unit, double *min, double *max, int* max_data, int* range, int iFlags)
+{
+	int err;
+	int range_unit;
+
+	if (*max < *min)
+	{
+		LIBPERROR("Invalid minimum and maximum values specified. MIN:%f > MAX:%f\n", *min, *max);
+		return ME_ERRNO_INVALID_MIN_MAX;
+	}
+
+	err = QueryRangeByMinMax_calculate(context, device, subdevice, unit, *min, *max, range, iFlags);
+	if (!err)
+	{
+		err = QueryRangeInfo_Sim(context, device, subdevice, *range, &range_unit, min, max, (unsigned int *)max_data, iFlags);
+	}
+
+	return err;
+}
+
+//Input/Output
+static int sim_get_irq_subdevice(me_sim_context_t* context, int device, int subdevice, int channel, me_sim_subdevice_t** sub)
+{
+	int err;
+
+	sim_latency(context);
+
+	err = sim_get_subdevice(context, device, subdevice, sub);
+	if (err)
+		return err;
+
+	if ((*sub)->type != ME_TYPE_DIO)
+	{
+		return ME_ERRNO_NOT_SUPPORTED;
+	}
+
+	if (channel)
+	{
+		LIBPERROR("Invalid channel specified.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int IrqStart_Sim(void* context, int device, int subdevice, int channel, int source, int edge, int arg, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+	LIBPDEBUG("device=%d subdevice=%d channel=%d source=%d edge=%d arg=%d iFlags=0x%x\n", device, subdevice, channel, source, edge, arg, iFlags);
+
+	err = sim_get_irq_subdevice((me_sim_context_t *)context, device, subdevice, channel, &sub);
+	if (err)
+		return err;
+
+	pthread_mutex_lock(&sub->mutex);
+		sub->irq_enabled = 1;
+		sub->irq_start = sim_now();
+		sub->irq_soft = 0;
+		sub->irq_seen = 0;
+		pthread_cond_broadcast(&sub->cond);
+	pthread_mutex_unlock(&sub->mutex);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int IrqWait_Sim(void* context, int device, int subdevice, int channel, int* count, int* value, int timeout, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t generation;
+	uint64_t now;
+	uint64_t deadline;
+	uint64_t total;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(count);
+	CHECK_POINTER(value);
+
+	err = sim_get_irq_subdevice((me_sim_context_t *)context, device, subdevice, channel, &sub);
+	if (err)
+		return err;
+
+	pthread_mutex_lock(&sub->mutex);
+		generation = sub->irq_generation;
+		now = sim_now();
+		deadline = sim_deadline(now, timeout);
+		while (1)
+		{
+			if (generation != sub->irq_generation)
+			{
+				err = ME_ERRNO_CANCELLED;
+				break;
+			}
+
+			if (sub->irq_enabled)
+			{
+				total = sim_irq_total(sub, now);
+				if (total > sub->irq_seen)
+				{
+					sub->irq_seen = total;
+					sub->probe_wake_time = now;
+					*count = total;
+					*value = sub->dio_value;
+					break;
+				}
+			}
+
+			if (now >= deadline)
+			{
+				err = ME_ERRNO_TIMEOUT;
+				break;
+			}
+
+			sim_wait(sub, sub->irq_enabled ? sim_min(deadline, sim_irq_next(sub, now)) : deadline);
+			now = sim_now();
+		}
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+int IrqStop_Sim(void* context, int device, int subdevice, int channel, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	err = sim_get_irq_subdevice((me_sim_context_t *)context, device, subdevice, channel, &sub);
+	if (err)
+		return err;
+
+	pthread_mutex_lock(&sub->mutex);
+		sub->irq_enabled = 0;
+		sub->irq_generation++;
+		pthread_cond_broadcast(&sub->cond);
+	pthread_mutex_unlock(&sub->mutex);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int IrqTest_Sim(void* context, int device, int subdevice, int channel, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	return sim_get_irq_subdevice((me_sim_context_t *)context, device, subdevice, channel, &sub);
+}
+
+int IrqSetCallback_Sim(void* context, int device, int subdevice, meIOIrqCB_t irq_fn, void* irq_context, int iFlags)
+{
+	me_sim_context_t* sim_context = (me_sim_context_t *)context;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+	LIBPDEBUG("device=%d subdevice=%d irq_fn=%p iFlags=0x%x", device, subdevice, irq_fn, iFlags);
+
+	if (irq_fn)
+	{	// create
+		err = IrqTest_Sim(context, device, subdevice, 0, iFlags);
+		if (!err)
+		{
+			err = doCreateThread_Sim(sim_context, device, subdevice, irqThread_Sim, irq_fn, irq_context, iFlags);
+		}
+	}
+	else
+	{	// cancel
+		err = doDestroyThread_Sim(sim_context, device, subdevice);
+	}
+
+	return err;
+}
+
+int ResetDevice_Sim(void* context, int device, int iFlags)
+{
+	me_sim_device_t* dev;
+	int i;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_device((me_sim_context_t *)context, device, &dev);
+	if (!err)
+	{
+		for (i = 0; i < dev->subdevice_count; i++)
+		{
+			sim_reset_subdevice(dev->subdevice_list + i);
+		}
+	}
+	return err;
+}
+
+int ResetSubdevice_Sim(void* context, int device, int subdevice, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (!err)
+	{
+		sim_reset_subdevice(sub);
+	}
+	return err;
+}
+
+int SingleConfig_Sim(void* context, int device, int subdevice, int channel,
+						int config, int reference, int synchro,
+						int trigger, int edge, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int mask;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+	LIBPDEBUG("device=%d subdevice=%d channel=%d config=0x%x reference=0x%x iFlags=0x%x\n", device, subdevice, channel, config, reference, iFlags);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if ((channel < 0) || (channel >= sub->channels))
+	{
+		LIBPERROR("Invalid channel specified.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	pthread_mutex_lock(&sub->mutex);
+		sim_stream_update(sub, sim_now());
+		switch (sub->type)
+		{
+			case ME_TYPE_AI:
+			case ME_TYPE_AO:
+				if (sub->status == ME_STATUS_BUSY)
+				{
+					err = ME_ERRNO_SUBDEVICE_BUSY;
+				}
+				else if ((config < 0) || (config >= sub->range_count))
+				{
+					LIBPERROR("Invalid range specified.\n");
+					err = ME_ERRNO_INVALID_SINGLE_CONFIG;
+				}
+				else
+				{
+					sub->single_range[channel] = config;
+				}
+				break;
+
+			case ME_TYPE_DIO:
+				if (iFlags & ME_IO_SINGLE_CONFIG_DIO_BIT)
+				{
+					mask = 1 << channel;
+				}
+				else if (channel)
+				{
+					LIBPERROR("Invalid channel specified.\n");
+					err = ME_ERRNO_INVALID_CHANNEL;
+					break;
+				}
+				else
+				{
+					mask = 0xFF;
+				}
+
+				if (config == ME_SINGLE_CONFIG_DIO_OUTPUT)
+				{
+					sub->dio_output |= mask;
+				}
+				else if (config == ME_SINGLE_CONFIG_DIO_INPUT)
+				{
+					sub->dio_output &= ~mask;
+				}
+				else
+				{
+					LIBPERROR("Invalid configuration specified.\n");
+					err = ME_ERRNO_INVALID_SINGLE_CONFIG;
+				}
+				break;
+
+			case ME_TYPE_CTR:
+				if ((config < ME_SINGLE_CONFIG_CTR_8254_MODE_DISABLE) || (config > ME_SINGLE_CONFIG_CTR_8254_MODE_5))
+				{
+					LIBPERROR("Invalid configuration specified.\n");
+					err = ME_ERRNO_INVALID_SINGLE_CONFIG;
+					break;
+				}
+
+				switch (reference)
+				{
+					case ME_REF_CTR_INTERNAL_1MHZ:
+						sub->ctr_clock = 1E6;
+						break;
+
+					case ME_REF_CTR_INTERNAL_10MHZ:
+						sub->ctr_clock = 1E7;
+						break;
+
+					case ME_REF_CTR_PREVIOUS:
+					case ME_REF_CTR_EXTERNAL:
+						// Nothing is connected.
+						sub->ctr_clock = 0;
+						break;
+
+					default:
+						LIBPERROR("Invalid reference specified.\n");
+						err = ME_ERRNO_INVALID_REF;
+				}
+				if (!err)
+				{
+					sub->ctr_mode = config;
+					sub->ctr_start = sim_now();
+				}
+				break;
+		}
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+static int sim_ctr_value(me_sim_subdevice_t* sub, uint64_t now)
+{
+	uint64_t ticks;
+	uint64_t period;
+
+	if ((sub->ctr_mode == ME_SINGLE_CONFIG_CTR_8254_MODE_DISABLE) || !sub->ctr_clock)
+		return sub->ctr_load;
+
+	ticks = (uint64_t)((now - sub->ctr_start) * 1E-9 * sub->ctr_clock);
+	period = sub->ctr_load ? sub->ctr_load : 0x10000;
+	switch (sub->ctr_mode)
+	{
+		case ME_SINGLE_CONFIG_CTR_8254_MODE_2:
+		case ME_SINGLE_CONFIG_CTR_8254_MODE_3:
+			return (period - ticks % period) & 0xFFFF;
+
+		default:
+			return (ticks >= period) ? 0 : (period - ticks) & 0xFFFF;
+	}
+}
+
+/// Single operation. Subdevice's mutex MUST be held.
+static int sim_single(me_sim_subdevice_t* sub, int channel, int direction, int* value, int iFlags)
+{
+	uint64_t now = sim_now();
+	int mask;
+	int old;
+
+	if ((direction != ME_DIR_INPUT) && (direction != ME_DIR_OUTPUT))
+	{
+		LIBPERROR("Invalid direction specified.\n");
+		return ME_ERRNO_INVALID_DIR;
+	}
+
+	if ((channel < 0) || (channel >= sub->channels))
+	{
+		LIBPERROR("Invalid channel specified.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	sim_stream_update(sub, now);
+	switch (sub->type)
+	{
+		case ME_TYPE_AI:
+			if (direction != ME_DIR_INPUT)
+				return ME_ERRNO_INVALID_DIR;
+
+			if (sub->status == ME_STATUS_BUSY)
+				return ME_ERRNO_SUBDEVICE_BUSY;
+
+			*value = sim_sample(sub, channel, sub->ranges[sub->single_range[channel]].max_data, now - sub->device->open_time, sub->single_count++);
+			break;
+
+		case ME_TYPE_AO:
+			if (sub->status == ME_STATUS_BUSY)
+				return ME_ERRNO_SUBDEVICE_BUSY;
+
+			if (direction == ME_DIR_INPUT)
+			{
+				*value = sub->single_value[channel];
+			}
+			else if ((*value < 0) || (*value > sub->ranges[sub->single_range[channel]].max_data))
+			{
+				LIBPERROR("Value out of range.\n");
+				return ME_ERRNO_VALUE_OUT_OF_RANGE;
+			}
+			else
+			{
+				sub->single_value[channel] = *value;
+			}
+			break;
+
+		case ME_TYPE_DIO:
+			if (iFlags & ME_IO_SINGLE_TYPE_DIO_BIT)
+			{
+				mask = 1 << channel;
+			}
+			else if (iFlags & (ME_IO_SINGLE_TYPE_DIO_WORD | ME_IO_SINGLE_TYPE_DIO_DWORD))
+			{
+				LIBPERROR("Invalid flag specified.\n");
+				return ME_ERRNO_INVALID_FLAGS;
+			}
+			else if (channel)
+			{
+				LIBPERROR("Invalid channel specified.\n");
+				return ME_ERRNO_INVALID_CHANNEL;
+			}
+			else
+			{
+				mask = 0xFF;
+			}
+
+			if (direction == ME_DIR_INPUT)
+			{// Outputs are looped back to inputs.
+				*value = (sub->dio_value & mask) >> ((mask == 0xFF) ? 0 : channel);
+				break;
+			}
+
+			if ((sub->dio_output & mask) != mask)
+			{
+				LIBPERROR("Port not configured as output.\n");
+				return ME_ERRNO_PREVIOUS_CONFIG;
+			}
+
+			old = sub->dio_value;
+			sub->probe_write_time = sim_now();
+			if (mask == 0xFF)
+				sub->dio_value = *value & 0xFF;
+			else
+				sub->dio_value = (*value) ? (sub->dio_value | mask) : (sub->dio_value & ~mask);
+
+			if (sub->irq_enabled && (old != sub->dio_value))
+			{
+				sub->irq_soft++;
+				sub->probe_irq_time = sim_now();
+				sub->probe_irq_count = sim_irq_total(sub, sub->probe_irq_time);
+				pthread_cond_broadcast(&sub->cond);
+			}
+			break;
+
+		case ME_TYPE_CTR:
+			if (direction == ME_DIR_INPUT)
+			{
+				*value = sim_ctr_value(sub, now);
+			}
+			else if ((*value < 0) || (*value > 0xFFFF))
+			{
+				LIBPERROR("Value out of range.\n");
+				return ME_ERRNO_VALUE_OUT_OF_RANGE;
+			}
+			else
+			{
+				sub->ctr_load = *value;
+				sub->ctr_start = now;
+			}
+			break;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int Single_Sim(void* context, int device, int subdevice, int channel, int direction, int* value, int timeout, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(value);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (!err)
+	{
+		pthread_mutex_lock(&sub->mutex);
+			err = sim_single(sub, channel, direction, value, iFlags);
+		pthread_mutex_unlock(&sub->mutex);
+	}
+
+	return err;
+}
+
+int SingleList_Sim(void* context, meIOSingle_t* list, int count, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	int i;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(list);
+
+	sim_latency((me_sim_context_t *)context);
+
+	for (i = 0; i < count; i++)
+	{
+		list[i].iErrno = sim_get_subdevice((me_sim_context_t *)context, list[i].iDevice, list[i].iSubdevice, &sub);
+		if (!list[i].iErrno)
+		{
+			pthread_mutex_lock(&sub->mutex);
+				list[i].iErrno = sim_single(sub, list[i].iChannel, list[i].iDir, &list[i].iValue, list[i].iFlags);
+			pthread_mutex_unlock(&sub->mutex);
+		}
+
+		if (list[i].iErrno && !err)
+		{
+			err = list[i].iErrno;
+		}
+	}
+
+	return err;
+}
+
+int StreamConfigure_Sim(void* context, int device, int subdevice,
+						meIOStreamSimpleConfig_t* list, int count,
+						meIOStreamSimpleTriggers_t* trigger, int threshold, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t min_ticks;
+	uint64_t conv_ticks;
+	uint64_t stop_total;
+	int allowed;
+	int i;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(list);
+	CHECK_POINTER(trigger);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if (sub->sub_type != ME_SUBTYPE_STREAMING)
+	{
+		return ME_ERRNO_NOT_SUPPORTED;
+	}
+
+	allowed = (sub->type == ME_TYPE_AI)
+				? (ME_STREAM_CONFIG_DIFFERENTIAL | ME_IO_STREAM_CONFIG_SAMPLE_AND_HOLD)
+				: (ME_IO_STREAM_CONFIG_WRAPAROUND | ME_IO_STREAM_CONFIG_HARDWARE_ONLY);
+	if (iFlags & ~allowed)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((count < 1) || (count > sub->list_size))
+	{
+		LIBPERROR("Invalid channel list count specified.\n");
+		return ME_ERRNO_INVALID_CONFIG_LIST_COUNT;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if ((list[i].iChannel < 0) || (list[i].iChannel >= sub->channels))
+		{
+			LIBPERROR("Invalid channel in entry %d.\n", i);
+			return ME_ERRNO_INVALID_CHANNEL;
+		}
+		if ((list[i].iRange < 0) || (list[i].iRange >= sub->range_count))
+		{
+			LIBPERROR("Invalid range in entry %d.\n", i);
+			return ME_ERRNO_INVALID_RANGE;
+		}
+	}
+
+	min_ticks = (ME_SIM_BASE_FREQUENCY + sub->rate - 1) / sub->rate;
+	conv_ticks = trigger->conv_ticks;
+	if ((trigger->trigger_type & ME_TRIGGER_TYPE_CONV) || !conv_ticks)
+	{// External conversion trigger and 0 ticks run at maximum rate (same as ME-4600).
+		conv_ticks = min_ticks;
+	}
+	else if ((conv_ticks < min_ticks) || (conv_ticks > ME_SIM_MAX_TICKS))
+	{
+		LIBPERROR("Invalid conversion timer specified.\n");
+		return ME_ERRNO_INVALID_CONV_START_ARG;
+	}
+
+	if (trigger->scan_ticks && !(trigger->trigger_type & ME_TRIGGER_TYPE_LIST)
+		&& ((trigger->scan_ticks < conv_ticks * count) || (trigger->scan_ticks > ME_SIM_MAX_TICKS)))
+	{
+		LIBPERROR("Invalid scan timer specified.\n");
+		return ME_ERRNO_INVALID_SCAN_START_ARG;
+	}
+
+	if (trigger->acq_ticks > ME_SIM_MAX_TICKS)
+	{
+		LIBPERROR("Invalid acquisition timer specified.\n");
+		return ME_ERRNO_INVALID_ACQ_START_ARG;
+	}
+
+	switch (trigger->stop_type)
+	{
+		case ME_STREAM_STOP_TYPE_MANUAL:
+			stop_total = UINT64_MAX;
+			break;
+
+		case ME_STREAM_STOP_TYPE_ACQ_LIST:
+			stop_total = (uint64_t)trigger->stop_count * count;
+			break;
+
+		case ME_STREAM_STOP_TYPE_SCAN_VALUE:
+			stop_total = trigger->stop_count;
+			break;
+
+		default:
+			LIBPERROR("Invalid stop trigger specified.\n");
+			return ME_ERRNO_INVALID_SCAN_STOP_TRIG_TYPE;
+	}
+	if (!stop_total)
+	{
+		LIBPERROR("Invalid stop count specified.\n");
+		return ME_ERRNO_INVALID_SCAN_STOP_ARG;
+	}
+
+	if ((threshold < 0) || (threshold > sub->buffer))
+	{
+		LIBPERROR("Invalid threshold specified.\n");
+		return ME_ERRNO_INVALID_FIFO_IRQ_THRESHOLD;
+	}
+
+	pthread_mutex_lock(&sub->mutex);
+		sim_stream_update(sub, sim_now());
+		if (sub->status == ME_STATUS_BUSY)
+		{
+			err = ME_ERRNO_SUBDEVICE_BUSY;
+		}
+		else
+		{
+			memcpy(sub->list, list, count * sizeof(meIOStreamSimpleConfig_t));
+			sub->list_count = count;
+			sub->conv_ns = (uint64_t)(conv_ticks * 1E9 / ME_SIM_BASE_FREQUENCY);
+			if (!sub->conv_ns)
+				sub->conv_ns = 1;
+			sub->scan_ns = (trigger->scan_ticks && !(trigger->trigger_type & ME_TRIGGER_TYPE_LIST))
+							? (uint64_t)(trigger->scan_ticks * 1E9 / ME_SIM_BASE_FREQUENCY)
+							: count * sub->conv_ns;
+			sub->acq_ns = (uint64_t)(trigger->acq_ticks * 1E9 / ME_SIM_BASE_FREQUENCY);
+			sub->stop_total = stop_total;
+			sub->chunk = threshold ? threshold : ((sub->fifo / 2) ? sub->fifo / 2 : 1);
+			sub->wraparound = (iFlags & ME_IO_STREAM_CONFIG_WRAPAROUND) ? 1 : 0;
+
+			sub->status = ME_STATUS_IDLE;
+			sub->configured = 1;
+			sim_stream_rearm(sub);
+			pthread_cond_broadcast(&sub->cond);
+		}
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+int StreamConfig_Sim(void* context, int device, int subdevice,
+					meIOStreamConfig_t* list, int count,
+					meIOStreamTrigger_t* trigger, int threshold, int iFlags)
+{
+	int err;
+	meIOStreamSimpleTriggers_t	simple_triggers;
+	meIOStreamSimpleConfig_t*	simple_config = NULL;
+	int flags;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(context);
+	CHECK_POINTER(trigger);
+	CHECK_POINTER(list);
+
+	simple_config = calloc(count, sizeof(meIOStreamSimpleConfig_t));
+	if (!simple_config)
+	{
+		LIBPERROR("Can not get requestet memory for simple_config list.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+
+	err = me_translate_triggers_to_simple(trigger, &simple_triggers);
+	if (!err)
+	{
+		err =  me_translate_config_to_simple(list, count, iFlags, simple_config, &flags);
+	}
+	if (!err)
+	{
+		err = StreamConfigure_Sim(context, device, subdevice, simple_config, count, &simple_triggers, threshold, flags);
+	}
+
+	free (simple_config);
+
+	return err;
+}
+
+int StreamStart_Sim(void* context, int device, int subdevice, int mode, int timeout, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t now;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	sim_latency((me_sim_context_t *)context);
+
+	if (iFlags & ~ME_IO_STREAM_START_TYPE_TRIG_SYNCHRONOUS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((mode != ME_START_MODE_BLOCKING) && (mode != ME_START_MODE_NONBLOCKING))
+	{
+		LIBPERROR("Invalid start mode specified.\n");
+		return ME_ERRNO_INVALID_START_MODE;
+	}
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if (sub->sub_type != ME_SUBTYPE_STREAMING)
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	pthread_mutex_lock(&sub->mutex);
+		now = sim_now();
+		err = sim_stream_start(sub, now);
+		if (!err && (mode == ME_START_MODE_BLOCKING))
+		{
+			err = sim_stream_wait_start(sub, sim_deadline(now, timeout));
+		}
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+int StreamStartList_Sim(void* context, meIOStreamStart_t* list, int count, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t t0;
+	int i;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(list);
+
+	sim_latency((me_sim_context_t *)context);
+
+	// All subdevices start at the same moment.
+	t0 = sim_now();
+	for (i = 0; i < count; i++)
+	{
+		list[i].iErrno = sim_get_subdevice((me_sim_context_t *)context, list[i].iDevice, list[i].iSubdevice, &sub);
+		if (!list[i].iErrno && (sub->sub_type != ME_SUBTYPE_STREAMING))
+		{
+			list[i].iErrno = ME_ERRNO_NOT_SUPPORTED;
+		}
+		if (!list[i].iErrno && (list[i].iStartMode != ME_START_MODE_BLOCKING) && (list[i].iStartMode != ME_START_MODE_NONBLOCKING))
+		{
+			list[i].iErrno = ME_ERRNO_INVALID_START_MODE;
+		}
+		if (!list[i].iErrno)
+		{
+			pthread_mutex_lock(&sub->mutex);
+				list[i].iErrno = sim_stream_start(sub, t0);
+			pthread_mutex_unlock(&sub->mutex);
+		}
+
+		if (list[i].iErrno && !err)
+		{
+			err = list[i].iErrno;
+		}
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if (!list[i].iErrno && (list[i].iStartMode == ME_START_MODE_BLOCKING)
+			&& !sim_get_subdevice((me_sim_context_t *)context, list[i].iDevice, list[i].iSubdevice, &sub))
+		{
+			pthread_mutex_lock(&sub->mutex);
+				list[i].iErrno = sim_stream_wait_start(sub, sim_deadline(t0, list[i].iTimeOut));
+			pthread_mutex_unlock(&sub->mutex);
+
+			if (list[i].iErrno && !err)
+			{
+				err = list[i].iErrno;
+			}
+		}
+	}
+
+	return err;
+}
+
+static int sim_stream_wait_idle(me_sim_subdevice_t* sub, uint64_t deadline)
+{
+	uint64_t generation = sub->generation;
+	uint64_t now = sim_now();
+
+	while (1)
+	{
+		sim_stream_update(sub, now);
+		if (sub->status != ME_STATUS_BUSY)
+			return ME_ERRNO_SUCCESS;
+
+		if (generation != sub->generation)
+			return ME_ERRNO_CANCELLED;
+
+		if (now >= deadline)
+			return ME_ERRNO_TIMEOUT;
+
+		sim_wait(sub, sim_min(deadline, sim_stream_next_event(sub, now)));
+		now = sim_now();
+	}
+}
+
+int StreamStop_Sim(void* context, int device, int subdevice, int mode, int timeout, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t now;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	sim_latency((me_sim_context_t *)context);
+
+	if (iFlags & ~(ME_IO_STREAM_STOP_TYPE_PRESERVE_BUFFERS | ME_IO_STREAM_STOP_NONBLOCKING))
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((mode != ME_STOP_MODE_IMMEDIATE) && (mode != ME_STOP_MODE_LAST_VALUE))
+	{
+		LIBPERROR("Invalid stop mode specified.\n");
+		return ME_ERRNO_INVALID_STOP_MODE;
+	}
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if (sub->sub_type != ME_SUBTYPE_STREAMING)
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	pthread_mutex_lock(&sub->mutex);
+		now = sim_now();
+		err = sim_stream_stop(sub, mode, iFlags, now);
+		if (!err && (mode == ME_STOP_MODE_LAST_VALUE) && !(iFlags & ME_IO_STREAM_STOP_NONBLOCKING))
+		{
+			err = sim_stream_wait_idle(sub, sim_deadline(now, timeout));
+		}
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+int StreamStopList_Sim(void* context, meIOStreamStop_t* list, int count, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t now;
+	int i;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(list);
+
+	sim_latency((me_sim_context_t *)context);
+
+	now = sim_now();
+	for (i = 0; i < count; i++)
+	{
+		list[i].iErrno = sim_get_subdevice((me_sim_context_t *)context, list[i].iDevice, list[i].iSubdevice, &sub);
+		if (!list[i].iErrno && (sub->sub_type != ME_SUBTYPE_STREAMING))
+		{
+			list[i].iErrno = ME_ERRNO_NOT_SUPPORTED;
+		}
+		if (!list[i].iErrno && (list[i].iStopMode != ME_STOP_MODE_IMMEDIATE) && (list[i].iStopMode != ME_STOP_MODE_LAST_VALUE))
+		{
+			list[i].iErrno = ME_ERRNO_INVALID_STOP_MODE;
+		}
+		if (!list[i].iErrno)
+		{
+			pthread_mutex_lock(&sub->mutex);
+				list[i].iErrno = sim_stream_stop(sub, list[i].iStopMode, list[i].iFlags, now);
+			pthread_mutex_unlock(&sub->mutex);
+		}
+
+		if (list[i].iErrno && !err)
+		{
+			err = list[i].iErrno;
+		}
+	}
+
+	return err;
+}
+
+int StreamSetCallbacks_Sim(void* context,
+							int device, int subdevice,
+							meIOStreamCB_t start, void* start_context,
+							meIOStreamCB_t new_values, void* new_value_context,
+							meIOStreamCB_t end, void* end_context,
+							int iFlags)
+{
+	me_sim_context_t* sim_context = (me_sim_context_t *)context;
+	me_sim_subdevice_t* sub;
+	int err;
+	int err_ret = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+	LIBPDEBUG("device=%d dubdevice=%d start=%p start_context=%p new_values=%p new_value_context=%p end=%p end_context=%p iFlags=0x%x",
+			device, subdevice, start, start_context, new_values, new_value_context, end, end_context, iFlags);
+
+	if (iFlags)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (!new_values && !start && !end)
+	{	// cancel
+		return doDestroyThread_Sim(sim_context, device, subdevice);
+	}
+
+	err = sim_get_subdevice(sim_context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if (sub->sub_type != ME_SUBTYPE_STREAMING)
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	if (new_values)
+	{	// create
+		err = doCreateThread_Sim(sim_context, device, subdevice, streamNewValuesThread_Sim, new_values, new_value_context, ME_NO_FLAGS);
+		if (!err_ret)
+			err_ret = err;
+	}
+
+	if (start)
+	{	// create
+		err = doCreateThread_Sim(sim_context, device, subdevice, streamStartThread_Sim, start, start_context, ME_NO_FLAGS);
+		if (!err_ret)
+			err_ret = err;
+	}
+
+	if (end)
+	{	// create
+		err = doCreateThread_Sim(sim_context, device, subdevice, streamStopThread_Sim, end, end_context, ME_NO_FLAGS);
+		if (!err_ret)
+			err_ret = err;
+	}
+
+	return err_ret;
+}
+
+int StreamNewValues_Sim(void* context, int device, int subdevice, int timeout, int* count, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t generation;
+	uint64_t now;
+	uint64_t deadline;
+	uint64_t visible;
+	int status;
+	int ready;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(count);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if (sub->sub_type != ME_SUBTYPE_STREAMING)
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	pthread_mutex_lock(&sub->mutex);
+		now = sim_now();
+		deadline = sim_deadline(now, timeout);
+		generation = sub->generation;
+		sim_stream_update(sub, now);
+		status = sub->status;
+		while (1)
+		{
+			sim_stream_update(sub, now);
+			if (generation != sub->generation)
+			{
+				err = ME_ERRNO_CANCELLED;
+				break;
+			}
+
+			if ((iFlags & ME_IO_STREAM_NEW_VALUES_ERROR_REPORT_FLAG) && (sub->status == ME_STATUS_ERROR) && !sub->error_reported)
+			{
+				sub->error_reported = 1;
+				err = sub->error;
+				break;
+			}
+
+			visible = sub->configured ? sim_stream_visible(sub, now) : 0;
+			if (iFlags & ME_IO_STREAM_NEW_VALUES_SCREEN_FLAG)
+				ready = (visible > sub->reported);
+			else
+				ready = (sub->configured && (sim_stream_count(sub, now) > 0));
+
+			if (ready || (status != sub->status))
+			{
+				sub->reported = visible;
+				break;
+			}
+
+			if (now >= deadline)
+			{
+				err = ME_ERRNO_TIMEOUT;
+				break;
+			}
+
+			sim_wait(sub, sim_min(deadline, sim_stream_next_event(sub, now)));
+			now = sim_now();
+		}
+		*count = sub->configured ? sim_stream_count(sub, now) : 0;
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+int StreamRead_Sim(void* context, int device, int subdevice, int mode, int* values, int* count, int timeout, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t generation;
+	uint64_t now;
+	uint64_t deadline;
+	int available;
+	int wanted;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(values);
+	CHECK_POINTER(count);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if ((sub->type != ME_TYPE_AI) || (sub->sub_type != ME_SUBTYPE_STREAMING))
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	if (iFlags & ~ME_IO_STREAM_READ_FRAMES)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((mode != ME_READ_MODE_BLOCKING) && (mode != ME_READ_MODE_NONBLOCKING))
+	{
+		LIBPERROR("Invalid read mode specified.\n");
+		return ME_ERRNO_INVALID_READ_MODE;
+	}
+
+	if (*count < 0)
+	{
+		LIBPERROR("Invalid value count specified.\n");
+		return ME_ERRNO_INVALID_VALUE_COUNT;
+	}
+
+	wanted = *count;
+	*count = 0;
+	if (!wanted)
+		return ME_ERRNO_SUCCESS;
+
+	pthread_mutex_lock(&sub->mutex);
+		if (!sub->configured)
+		{
+			err = ME_ERRNO_PREVIOUS_CONFIG;
+			goto ERROR;
+		}
+
+		if (iFlags & ME_IO_STREAM_READ_FRAMES)
+		{
+			wanted -= wanted % sub->list_count;
+			if (!wanted)
+			{
+				LIBPERROR("Buffer smaller than frame.\n");
+				err = ME_ERRNO_INVALID_VALUE_COUNT;
+				goto ERROR;
+			}
+		}
+
+		now = sim_now();
+		deadline = sim_deadline(now, timeout);
+		generation = sub->generation;
+		while (1)
+		{
+			sim_stream_update(sub, now);
+			available = sim_stream_visible(sub, now) - sub->position;
+			if ((available >= wanted) || (sub->status != ME_STATUS_BUSY) || (mode == ME_READ_MODE_NONBLOCKING))
+				break;
+
+			if (now >= deadline)
+			{
+				err = ME_ERRNO_TIMEOUT;
+				break;
+			}
+
+			sim_wait(sub, sim_min(deadline, sim_stream_next_event(sub, now)));
+			now = sim_now();
+
+			if (generation != sub->generation)
+			{
+				err = ME_ERRNO_CANCELLED;
+				goto ERROR;
+			}
+		}
+
+		if (available > wanted)
+			available = wanted;
+		if (iFlags & ME_IO_STREAM_READ_FRAMES)
+			available -= available % sub->list_count;
+
+		if (available)
+		{
+			sim_ai_generate(sub, values, available);
+			sub->position += available;
+			sub->empty_reads = 0;
+			*count = available;
+		}
+		else if (!err)
+		{
+			if (sub->status == ME_STATUS_ERROR)
+			{// Report error once.
+				err = sub->error;
+				sub->status = ME_STATUS_IDLE;
+			}
+			else if ((sub->status != ME_STATUS_BUSY) && sub->empty_reads++)
+			{
+				err = ME_ERRNO_SUBDEVICE_NOT_RUNNING;
+			}
+		}
+ERROR:
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+int StreamWrite_Sim(void* context, int device, int subdevice, int mode, int* values, int* count, int timeout, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t generation;
+	uint64_t now;
+	uint64_t deadline;
+	int space;
+	int wanted;
+	int written = 0;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(values);
+	CHECK_POINTER(count);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if ((sub->type != ME_TYPE_AO) || (sub->sub_type != ME_SUBTYPE_STREAMING))
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	if (iFlags != ME_IO_STREAM_WRITE_NO_FLAGS)
+	{
+		LIBPERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((mode != ME_WRITE_MODE_BLOCKING) && (mode != ME_WRITE_MODE_NONBLOCKING) && (mode != ME_WRITE_MODE_PRELOAD))
+	{
+		LIBPERROR("Invalid write mode specified.\n");
+		return ME_ERRNO_INVALID_WRITE_MODE;
+	}
+
+	if (*count < 0)
+	{
+		LIBPERROR("Invalid value count specified.\n");
+		return ME_ERRNO_INVALID_VALUE_COUNT;
+	}
+
+	wanted = *count;
+	*count = 0;
+
+	pthread_mutex_lock(&sub->mutex);
+		if (!sub->configured)
+		{
+			err = ME_ERRNO_PREVIOUS_CONFIG;
+			goto ERROR;
+		}
+
+		now = sim_now();
+		sim_stream_update(sub, now);
+		if (sub->status == ME_STATUS_ERROR)
+		{// Report underflow once.
+			err = sub->error;
+			sub->status = ME_STATUS_IDLE;
+			goto ERROR;
+		}
+
+		if (sub->status == ME_STATUS_BUSY)
+		{
+			if ((mode == ME_WRITE_MODE_PRELOAD) || sub->wraparound)
+			{
+				err = ME_ERRNO_SUBDEVICE_BUSY;
+				goto ERROR;
+			}
+		}
+		else if (sub->start_time)
+		{// Previous run is over. Start with empty buffer.
+			sim_stream_rearm(sub);
+		}
+
+		deadline = sim_deadline(now, timeout);
+		generation = sub->generation;
+		while (1)
+		{
+			sim_stream_update(sub, now);
+			space = sim_stream_space(sub, now);
+			if (space > wanted - written)
+				space = wanted - written;
+
+			if (space > 0)
+			{
+				sim_ao_store(sub, values + written, space);
+				sub->position += space;
+				written += space;
+			}
+
+			if ((written == wanted) || (sub->status != ME_STATUS_BUSY) || (mode != ME_WRITE_MODE_BLOCKING))
+				break;
+
+			if (now >= deadline)
+			{
+				err = ME_ERRNO_TIMEOUT;
+				break;
+			}
+
+			sim_wait(sub, sim_min(deadline, sim_stream_next_event(sub, now)));
+			now = sim_now();
+
+			if (generation != sub->generation)
+			{
+				err = ME_ERRNO_CANCELLED;
+				break;
+			}
+		}
+		*count = written;
+ERROR:
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+/// Waits for start or stop event. Used by public status call and by callback threads.
+static int sim_stream_wait_event(me_sim_subdevice_t* sub, int wait, uint64_t* seen, uint64_t deadline)
+{
+	uint64_t generation = sub->generation;
+	uint64_t now = sim_now();
+	uint64_t* events = (wait == ME_WAIT_START) ? &sub->start_events : &sub->stop_events;
+
+	while (1)
+	{
+		sim_stream_update(sub, now);
+		if (*events != *seen)
+		{
+			*seen = *events;
+			if (generation != sub->generation)
+				return ME_ERRNO_CANCELLED;
+
+			return (wait == ME_WAIT_STOP) ? sub->error : ME_ERRNO_SUCCESS;
+		}
+
+		if (generation != sub->generation)
+			return ME_ERRNO_CANCELLED;
+
+		if (now >= deadline)
+			return ME_ERRNO_TIMEOUT;
+
+		sim_wait(sub, sim_min(deadline, sim_stream_next_event(sub, now)));
+		now = sim_now();
+	}
+}
+
+int StreamStatus_Sim(void* context, int device, int subdevice, int wait, int* status, int* count, int iFlags)
+{
+	me_sim_subdevice_t* sub;
+	uint64_t now;
+	uint64_t seen;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	CHECK_POINTER(status);
+	CHECK_POINTER(count);
+
+	sim_latency((me_sim_context_t *)context);
+
+	err = sim_get_subdevice((me_sim_context_t *)context, device, subdevice, &sub);
+	if (err)
+		return err;
+
+	if (sub->sub_type != ME_SUBTYPE_STREAMING)
+		return ME_ERRNO_NOT_SUPPORTED;
+
+	pthread_mutex_lock(&sub->mutex);
+		now = sim_now();
+		sim_stream_update(sub, now);
+		switch (wait)
+		{
+			case ME_WAIT_NONE:
+				break;
+
+			case ME_WAIT_IDLE:
+				err = sim_stream_wait_idle(sub, UINT64_MAX);
+				break;
+
+			case ME_WAIT_BUSY:
+				while (sub->configured && (sub->status != ME_STATUS_BUSY))
+				{
+					sim_wait(sub, UINT64_MAX);
+				}
+				break;
+
+			case ME_WAIT_START:
+				seen = sub->start_events;
+				err = sim_stream_wait_event(sub, wait, &seen, UINT64_MAX);
+				break;
+
+			case ME_WAIT_STOP:
+				seen = sub->stop_events;
+				err = sim_stream_wait_event(sub, wait, &seen, UINT64_MAX);
+				break;
+
+			default:
+				LIBPERROR("Invalid wait specified.\n");
+				err = ME_ERRNO_INVALID_WAIT;
+		}
+		now = sim_now();
+		sim_stream_update(sub, now);
+		*status = sub->status;
+		*count = sub->configured ? sim_stream_count(sub, now) : 0;
+	pthread_mutex_unlock(&sub->mutex);
+
+	return err;
+}
+
+int StreamReader_Sim(void* context, int device, int subdevice, int mode, int policy, int* dropped, int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	// Simulated stream has only one consumer.
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+int StreamTimeToTicks_Sim(void* context, int device, int subdevice, int timer, double* stream_time, int* ticks_low, int* ticks_high, int iFlags)
+{
+	int err;
+	int base;
+	int min_ticks_low, min_ticks_high;
+	double min_ticks;
+	int max_ticks_low, max_ticks_high;
+	double max_ticks;
+
+	uint64_t ticks;
+
+	err = QuerySubdeviceTimer_Sim(context, device, subdevice, timer, &base, &min_ticks_low, &min_ticks_high, &max_ticks_low, &max_ticks_high, iFlags);
+	if (!err)
+	{
+		min_ticks = (double)((uint64_t)(unsigned int)min_ticks_low + ((uint64_t)min_ticks_high << 32));
+		max_ticks = (double)((uint64_t)(unsigned int)max_ticks_low + ((uint64_t)max_ticks_high << 32));
+
+		if ((max_ticks != 0) && (base != 0))
+		{
+			if (*stream_time < (min_ticks / (double)base))
+			{
+				*stream_time = min_ticks / (double)base;
+				*ticks_low = min_ticks_low;
+				*ticks_high = min_ticks_high;
+			}
+			else if (*stream_time > (max_ticks / (double)base))
+			{
+				*stream_time = max_ticks / (double)base;
+				*ticks_low = max_ticks_low;
+				*ticks_high = max_ticks_high;
+			}
+			else
+			{
+				ticks = *stream_time * base + 0.5;
+				*ticks_low = ticks;
+				*ticks_high = ticks >> 32;
+				*stream_time = ticks / (double)base;
+			}
+		}
+		else
+		{
+			*stream_time = HUGE_VAL;
+			*ticks_low = 0;
+			*ticks_high = 0;
+		}
+	}
+	else
+	{
+		*stream_time = HUGE_VAL;
+		*ticks_low = 0;
+		*ticks_high = 0;
+	}
+
+	return err;
+}
+
+int StreamFrequencyToTicks_Sim(void* context, int device, int subdevice, int timer, double* frequency, int *ticks_low, int *ticks_high, int iFlags)
+{
+	int err;
+	double stream_time;
+
+	if (*frequency <= 0)
+	{
+		LIBPERROR("Invalid frequency specified.\n");
+		*ticks_low = 0;
+		*ticks_high = 0;
+		return ME_ERRNO_VALUE_OUT_OF_RANGE;
+	}
+
+	stream_time = 1.0 / *frequency;
+	err = StreamTimeToTicks_Sim(context, device, subdevice, timer, &stream_time, ticks_low, ticks_high, iFlags);
+	*frequency = (stream_time == HUGE_VAL) ? 0 : 1.0 / stream_time;
+
+	return err;
+}
+
+int ParametersSet_Sim(void* context, int device, me_extra_param_set_t* paramset, int flags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+int SetOffset_Sim(void* context, int device, int subdevice, int channel, int range, double* offset, int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+/// Callback threads. Unlike local ones they are joinable and never cancelled asynchronously:
+/// every wait is limited to ME_SIM_THREAD_SLICE, so the cancel flag is checked regularly.
+static int doCreateThread_Sim(me_sim_context_t* sim_context, int device, int subdevice, void* fnThread, void* fnCB, void* contextCB, int iFlags)
+{
+	threadContext_t* threadArgs;
+	threadsList_t* newThread;
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	threadArgs = (threadContext_t *)calloc(1, sizeof(threadContext_t));
+	if (!threadArgs)
+	{
+		LIBPERROR("Can not get requestet memory for new thread's arguments.\n");
+		return -ENOMEM;
+	}
+
+	newThread = (threadsList_t *)calloc(1, sizeof(threadsList_t));
+	if (!newThread)
+	{
+		free (threadArgs);
+		LIBPERROR("Can not get requestet memory for new thread.\n");
+		return -ENOMEM;
+	}
+
+	pthread_mutex_lock(&sim_context->callbackContextMutex);
+		newThread->device = device;
+		newThread->subdevice = subdevice;
+		newThread->context = sim_context;
+		newThread->cancel = 0;
+
+		threadArgs->instance = newThread;
+		threadArgs->fnCB = fnCB;
+		threadArgs->contextCB = contextCB;
+		threadArgs->flags = iFlags;
+
+		if (pthread_create(&newThread->threadID, NULL, fnThread, threadArgs))
+		{
+			LIBPERROR("device[%d,%d]=>> CREATING THREAD FAILED\n", device, subdevice);
+			err = ME_ERRNO_START_THREAD;
+			free (newThread);
+			free (threadArgs);
+		}
+		else
+		{
+			newThread->next = sim_context->activeThreads;
+			sim_context->activeThreads = newThread;
+		}
+	pthread_mutex_unlock(&sim_context->callbackContextMutex);
+
+	return err;
+}
+
+static int doDestroyAllThreads_Sim(me_sim_context_t* sim_context)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	return doDestroyThread_Sim(sim_context, -1, -1);
+}
+
+static int doDestroyThread_Sim(me_sim_context_t* sim_context, int device, int subdevice)
+{
+	threadsList_t**	activeThread = &sim_context->activeThreads;
+	threadsList_t*	deleteList = NULL;
+	threadsList_t*	deleteThread;
+	pthread_t		selfID;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	selfID = pthread_self();
+	pthread_mutex_lock(&sim_context->callbackContextMutex);
+		while (*activeThread)
+		{
+			if ((device < 0) || (((*activeThread)->device == device) && ((subdevice < 0) || ((*activeThread)->subdevice == subdevice))))
+			{
+				deleteThread = (*activeThread);
+				*activeThread = deleteThread->next;
+
+				deleteThread->next = deleteList;
+				deleteList = deleteThread;
+			}
+			else
+			{
+				activeThread = &((*activeThread)->next);
+			}
+		}
+	pthread_mutex_unlock(&sim_context->callbackContextMutex);
+
+	// Threads can not be joined with callback mutex held - they take it for every callback.
+	while (deleteList)
+	{
+		deleteThread = deleteList;
+		deleteList = deleteThread->next;
+
+		if (pthread_equal(deleteThread->threadID, selfID) || sim_in_callback)
+		{	// Called from callback. Joining could deadlock - thread frees its entry itself.
+			pthread_detach(deleteThread->threadID);
+			deleteThread->cancel = 1;
+		}
+		else
+		{
+			deleteThread->cancel = 2;
+			pthread_join(deleteThread->threadID, NULL);
+			free (deleteThread);
+		}
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static threadsList_t* sim_thread_init(void* arg, threadContext_t* threadArgs)
+{
+	threadsList_t* context;
+
+	if (!arg)
+	{
+		LIBPCRITICALERROR("No thread context provided!\n");
+		return NULL;
+	}
+
+	memcpy(threadArgs, arg, sizeof(threadContext_t));
+	free (arg);
+	context = threadArgs->instance;
+
+	LIBPDEBUG("iDevice=%d iSubdevice=%d\n", context->device, context->subdevice);
+
+	if (!threadArgs->fnCB)
+	{
+		LIBPERROR("device=[%d,%d] ThreadID=%lld =>> No callback registred!\n", context->device, context->subdevice, (long long)context->threadID);
+	}
+
+	return context;
+}
+
+static void* irqThread_Sim(void* arg)
+{
+	me_sim_context_t* sim_context;
+	threadContext_t	threadArgs;
+	threadsList_t*	context;
+
+	int irq_count = 0;
+	int value = 0;
+
+	int ret;
+	int err;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	context = sim_thread_init(arg, &threadArgs);
+	if (!context)
+		return NULL;
+	sim_context = context->context;
+
+	while (!context->cancel)
+	{
+		err = IrqWait_Sim(sim_context, context->device, context->subdevice, 0, &irq_count, &value, ME_SIM_THREAD_SLICE, threadArgs.flags);
+		if (context->cancel)
+			break;
+
+		if (err == ME_ERRNO_TIMEOUT)
+			continue;
+
+		/// Interrupt or STOP/RESET -> call callback function.
+		if (threadArgs.irqCB)
+		{
+			pthread_mutex_lock(&sim_context->callbackContextMutex);
+				sim_in_callback = 1;
+				ret = threadArgs.irqCB(context->device, context->subdevice, 0, irq_count, value, threadArgs.contextCB, err);
+				sim_in_callback = 0;
+				if (ret)
+				{
+					if (!err && !context->cancel)
+					{/// Interrupt ONLY.
+						IrqStop_Sim(sim_context, context->device, context->subdevice, 0, ME_IO_IRQ_STOP_NO_FLAGS);
+					}
+				}
+			pthread_mutex_unlock(&sim_context->callbackContextMutex);
+		}
+	}
+
+	if (context->cancel == 1)
+		free (context);
+	return NULL;
+}
+
+static void* sim_stream_event_thread(void* arg, int wait)
+{
+	me_sim_context_t* sim_context;
+	me_sim_subdevice_t* sub;
+	threadContext_t	threadArgs;
+	threadsList_t*	context;
+
+	uint64_t seen;
+	int value;
+	int ret;
+	int err;
+
+	context = sim_thread_init(arg, &threadArgs);
+	if (!context)
+		return NULL;
+	sim_context = context->context;
+
+	if (sim_get_subdevice(sim_context, context->device, context->subdevice, &sub))
+		goto EXIT;
+
+	pthread_mutex_lock(&sub->mutex);
+		seen = (wait == ME_WAIT_START) ? sub->start_events : sub->stop_events;
+	pthread_mutex_unlock(&sub->mutex);
+
+	while (!context->cancel)
+	{
+		pthread_mutex_lock(&sub->mutex);
+			err = sim_stream_wait_event(sub, wait, &seen, sim_deadline(sim_now(), ME_SIM_THREAD_SLICE));
+			value = sub->configured ? sim_stream_count(sub, sim_now()) : 0;
+		pthread_mutex_unlock(&sub->mutex);
+
+		if (context->cancel)
+			break;
+
+		if (err == ME_ERRNO_TIMEOUT)
+			continue;
+
+		/// Start/stop or RESET -> call callback function.
+		if (threadArgs.streamCB)
+		{
+			pthread_mutex_lock(&sim_context->callbackContextMutex);
+				sim_in_callback = 1;
+				ret = threadArgs.streamCB(context->device, context->subdevice, value, threadArgs.contextCB, err);
+				sim_in_callback = 0;
+				if (ret && !err && (wait == ME_WAIT_START) && !context->cancel)
+				{/// Start ONLY.
+					StreamStop_Sim(sim_context, context->device, context->subdevice, ME_STOP_MODE_IMMEDIATE, 0, ME_IO_STREAM_STOP_NO_FLAGS);
+				}
+			pthread_mutex_unlock(&sim_context->callbackContextMutex);
+		}
+	}
+
+EXIT:
+	if (context->cancel == 1)
+		free (context);
+	return NULL;
+}
+
+static void* streamStartThread_Sim(void* arg)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	return sim_stream_event_thread(arg, ME_WAIT_START);
+}
+
+static void* streamStopThread_Sim(void* arg)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	return sim_stream_event_thread(arg, ME_WAIT_STOP);
+}
+
+static void* streamNewValuesThread_Sim(void* arg)
+{
+	me_sim_context_t* sim_context;
+	threadContext_t	threadArgs;
+	threadsList_t*	context;
+
+	int value = 0;
+
+	int ret;
+	int err = ME_ERRNO_SUCCESS;
+	int flag;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	context = sim_thread_init(arg, &threadArgs);
+	if (!context)
+		return NULL;
+	sim_context = context->context;
+
+	while (!context->cancel)
+	{
+		flag = ME_IO_STREAM_NEW_VALUES_SCREEN_FLAG | ME_IO_STREAM_NEW_VALUES_ERROR_REPORT_FLAG;
+
+		err = StreamNewValues_Sim(sim_context, context->device, context->subdevice, ME_SIM_THREAD_SLICE, &value, flag);
+		if (context->cancel)
+			break;
+
+		if ((err == ME_ERRNO_TIMEOUT) || (!err && !value))
+			continue;
+
+		/// New values or RESET -> call callback function.
+		if (threadArgs.streamCB)
+		{
+			pthread_mutex_lock(&sim_context->callbackContextMutex);
+				sim_in_callback = 1;
+				ret = threadArgs.streamCB(context->device, context->subdevice, value, threadArgs.contextCB, err);
+				sim_in_callback = 0;
+			pthread_mutex_unlock(&sim_context->callbackContextMutex);
+			if (context->cancel)
+				break;
+
+			if (!ret)
+			{
+				StreamStop_Sim(sim_context, context->device, context->subdevice, ME_STOP_MODE_IMMEDIATE, 0, ME_IO_STREAM_STOP_NO_FLAGS);
+			}
+		}
+	}
+
+	if (context->cancel == 1)
+		free (context);
+	return NULL;
+}
@@ -0,0 +1,127 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_SIM_CALLS_H_
+#  define _MEIDS_SIM_CALLS_H_
+
+#  include "meids_config_structs.h"
+
+/**
+ * Simulated devices.
+ *
+ * Address: "sim:" followed by comma separated list of options, e.g.
+ *	"sim:devices=2,ai_rate=1000000,waveform=ramp,latency=20"
+ *
+ *	devices		Number of devices.							(1)
+ *	ai_channels	AI channels. 0: no AI subdevice.			(16)
+ *	ao_channels	AO channels. 0: no AO subdevice.			(4)
+ *	dio_ports	8 bit DIO subdevices.						(2)
+ *	counters	8254 counter subdevices.					(3)
+ *	ai_rate		Maximum AI conversion rate [Hz].			(500000)
+ *	ao_rate		Maximum AO update rate [Hz].				(500000)
+ *	ai_fifo		AI FIFO [values]. Values are delivered in halves of FIFO.	(2048)
+ *	ao_fifo		AO FIFO [values].							(4096)
+ *	buffer		Stream's software buffer [values].			(65536)
+ *	latency		Time spent in every call [us].				(0)
+ *	waveform	sine, square, triangle, sawtooth, ramp, noise or dc.	(sine)
+ *	frequency	Signal frequency [Hz].						(1000)
+ *	amplitude	Fraction of range.							(0.9)
+ *	noise		Fraction of range.							(0.0)
+ *	irq_rate	DIO interrupts per second. 0: only on output.	(0)
+ *
+ * Samples are computed from time when they are read. There is no producer thread.
+ * Waveform 'ramp' returns sample's index (modulo max_data) - good for checking continuity.
+ * External triggers fire immediately after start.
+ * Callbacks are not serialized.
+ */
+#  define ME_SIM_ADDRESS_PREFIX			"sim:"
+
+#  define ME_SIM_VENDOR_ID				0x1402
+#  define ME_SIM_DEVICE_ID				0xFF00
+#  define ME_SIM_DRIVER_NAME			"mesim"
+
+#  define ME_SIM_BASE_FREQUENCY			33000000
+
+/// Library for "INTERNAL" calls
+//Access
+int  Open_Sim(me_sim_context_t* context, const char* address, int iFlags);
+int  Close_Sim(me_sim_context_t* context, int iFlags);
+
+//Lock
+int  LockDriver_Sim(void* context, int lock, int iFlags);
+int  LockDevice_Sim(void* context, int device, int lock, int iFlags);
+int  LockSubdevice_Sim(void* context, int device, int subdevice, int lock, int iFlags);
+
+//Query
+int  QueryDriverVersion_Sim(void* context, int* version, int iFlags);
+int  QueryDriverName_Sim(void* context, char *name, int count, int iFlags);
+
+int  QuerySubdriverVersion_Sim(void* context, int device, int* version, int iFlags);
+int  QuerySubdriverName_Sim(void* context, int device, char *name, int count, int iFlags);
+
+int  QueryDeviceName_Sim(void* context, int device, char *name, int count, int iFlags);
+int  QueryDeviceDescription_Sim(void* context, int device, char *description, int count, int iFlags);
+int  QueryDevicesNumber_Sim(void* context, int* no_devices, int iFlags);
+int  QueryDeviceInfo_Sim(void* context, int device, unsigned int* vendor_id, unsigned int* device_id,
+						unsigned int* serial_no, unsigned int* bus_type, unsigned int* bus_no,
+						unsigned int* dev_no, unsigned int* func_no, int* plugged, int iFlags);
+
+int  QuerySubdevicesNumber_Sim(void* context, int device, int* no_subdevice, int iFlags);
+int  QuerySubdevicesNumberByType_Sim(void* context, int device, int type, int subtype, int* no_subdevices, int iFlags);
+int  QuerySubdeviceType_Sim(void* context, int device, int subdevice, int* type, int* subtype, int iFlags);
+int  QuerySubdeviceByType_Sim(void* context, int device, int subdevice, int type, int subtype, int* result, int iFlags);
+int  QuerySubdeviceCaps_Sim(void* context, int device, int subdevice, int* caps, int iFlags);
+int  QuerySubdeviceCapsArgs_Sim(void* context, int device, int subdevice, int cap, int* args, int count, int iFlags);
+int  QuerySubdeviceTimer_Sim(void* context, int device, int subdevice, int timer,
+															int* base, int* min_ticks_low, int* min_ticks_high, int* max_ticks_low, int* max_ticks_high, int iFlags);
+int  QueryLatencyProbe_Sim(void* context, int device, int subdevice, meLatencyProbe_t* probe, int iFlags);
+
+int  QueryChannelsNumber_Sim(void* context, int device, int subdevice, unsigned int* number, int iFlags);
+
+int  QueryRangesNumber_Sim(void* context, int device, int subdevice, int unit, int* no_ranges, int iFlags);
+int  QueryRangeInfo_Sim(void* context, int device, int subdevice, int range, int* unit, double *min, double *max, unsigned int* max_data, int iFlags);
+int  QueryRangeByMinMax_Sim(void* context, int device, int subdevice, int unit, double *min, double *max, int* max_data, int* range, int iFlags);
+
+//Input/Output
+int  IrqStart_Sim(void* context, int device, int subdevice, int channel, int source, int edge, int arg, int iFlags);
+int  IrqWait_Sim(void* context, int device, int subdevice, int channel, int* count, int* value, int timeout, int iFlags);
+int  IrqStop_Sim(void* context, int device, int subdevice, int channel, int iFlags);
+int  IrqTest_Sim(void* context, int device, int subdevice, int channel, int iFlags);
+
+int  IrqSetCallback_Sim(void* context, int device, int subdevice, meIOIrqCB_t irq_fn, void* irq_context, int iFlags);
+
+int  ResetDevice_Sim(void* context, int device, int iFlags);
+int  ResetSubdevice_Sim(void* context, int device, int subdevice, int iFlags);
+
+int  SingleConfig_Sim(void* context, int device, int subdevice, int channel,
+                		int config, int reference, int synchro,
+                     	int trigger, int edge,	int iFlags);
+int  Single_Sim(void* context, int device, int subdevice, int channel, int direction, int* value, int timeout, int iFlags);
+int  SingleList_Sim(void* context, meIOSingle_t* list, int count, int iFlags);
+
+int  StreamConfigure_Sim(void* context, int device,int subdevice, meIOStreamSimpleConfig_t* list, int count, meIOStreamSimpleTriggers_t* trigger, int threshold, int iFlags);
+int  StreamConfig_Sim(void* context, int device,int subdevice, meIOStreamConfig_t* list, int count, meIOStreamTrigger_t* trigger, int threshold, int iFlags);
+int  StreamStart_Sim(void* context, int device, int subdevice, int mode, int timeout, int iFlags);
+int  StreamStartList_Sim(void* context, meIOStreamStart_t* list, int count, int iFlags);
+int  StreamStop_Sim(void* context, int device, int subdevice, int mode, int timeout, int iFlags);
+int  StreamStopList_Sim(void* context, meIOStreamStop_t* list, int count, int iFlags);
+int  StreamNewValues_Sim(void* context, int device, int subdevice, int timeout, int* count, int iFlags);
+int  StreamRead_Sim(void* context,  int device, int subdevice, int mode, int* values, int* count, int timeout, int iFlags);
+int  StreamWrite_Sim(void* context, int device, int subdevice, int mode, int* values, int* count, int timeout, int iFlags);
+int  StreamStatus_Sim(void* context, int device, int subdevice, int wait, int* status, int* count, int iFlags);
+int  StreamReader_Sim(void* context, int device, int subdevice, int mode, int policy, int* dropped, int iFlags);
+
+int  StreamSetCallbacks_Sim(void* context,
+							int device, int subdevice,
+							meIOStreamCB_t start, void* start_context,
+							meIOStreamCB_t new_values, void* new_value_context,
+							meIOStreamCB_t end, void* end_context,
+							int iFlags);
+
+int  StreamTimeToTicks_Sim(void* context, int device, int subdevice, int timer, double* stream_time, int* ticks_low, int* ticks_high, int iFlags);
+int  StreamFrequencyToTicks_Sim(void* context, int device, int subdevice, int timer, double* frequency, int* ticks_low, int* ticks_high, int iFlags);
+
+int  ParametersSet_Sim(void* context, int device, me_extra_param_set_t* paramset, int flags);
+
+int SetOffset_Sim(void* context, int device, int subdevice, int channel, int range, double* offset, int iFlags);
+
+# endif	//_MEIDS_SIM_CALLS_H_
+#endif	//__KERNEL__
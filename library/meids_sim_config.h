@@ -0,0 +1,12 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_SIM_CONFIG_H_
+#  define _MEIDS_SIM_CONFIG_H_
+
+#  include "meids_structs.h"
+#  include "meids_config.h"
+
+/// Read config from simulated devices (context).
+int  ConfigRead_Sim(me_sim_context_t* context, me_config_t *cfg, int flags);
+
+# endif	//_MEIDS_SIM_CONFIG_H_
+#endif	//__KERNEL__
@@ -0,0 +1,544 @@
+/* API instrumentation for Meilhaus driver system.
+ * ==============================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space library!
+#endif	//__KERNEL__
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <errno.h>
+# include <syslog.h>
+# include <signal.h>
+# include <pthread.h>
+# include <semaphore.h>
+
+# include "me_error.h"
+# include "me_types.h"
+# include "me_defines.h"
+
+# include "meids_debug.h"
+# include "meids_statistics.h"
+
+/// Counters of one function on one device.
+typedef struct meids_stat_entry
+{
+	uint64_t calls;
+	uint64_t errors;
+	uint64_t total;
+	uint64_t min;
+	uint64_t max;
+	uint64_t histogram[ME_STATISTICS_HISTOGRAM_COUNT];
+} meids_stat_entry_t;
+
+/// Counters of one function on all devices. Entries are allocated on first call.
+typedef meids_stat_entry_t* meids_stat_row_t[ME_STAT_MAX_DEVICES + 1];
+
+/// Per-thread storage. Only owner writes to it, so recording needs no locks.
+/// Rows and entries are allocated on first use and published with release stores, readers load them with acquire.
+typedef struct meids_stat_thread
+{
+	struct meids_stat_thread* next;
+	/// Reset generation the counters belong to. Owner clears its counters when it differs from stat_generation.
+	unsigned int generation;
+	meids_stat_row_t* rows[ME_STAT_MAX_APIS];
+} meids_stat_thread_t;
+
+/// Init of the shared object - environment: MEIDS_STATISTICS, MEIDS_STATISTICS_SIGNAL, MEIDS_STATISTICS_FILE.
+void __attribute__((constructor)) meids_statistics_init(void);
+
+volatile int meids_statistics_enabled = 0;
+
+static pthread_mutex_t stat_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t stat_key;
+static __thread meids_stat_thread_t* stat_thread = NULL;
+/// Threads alive. Protected by stat_mutex.
+static meids_stat_thread_t* stat_threads = NULL;
+/// Counters of finished threads. Protected by stat_mutex.
+static meids_stat_thread_t* stat_retired = NULL;
+/// Incremented by reset (under stat_mutex). Threads apply it to their own counters.
+static unsigned int stat_generation = 0;
+
+static const char* stat_names[ME_STAT_MAX_APIS];
+static int stat_names_count = 0;
+
+static sem_t stat_dump_sem;
+static char* stat_dump_file = NULL;
+
+static void stat_thread_exit(void* arg);
+static meids_stat_entry_t* stat_entry_peek(meids_stat_thread_t* thread, int id, int device);
+static meids_stat_entry_t* stat_entry_get(meids_stat_thread_t* thread, int id, int device);
+static void stat_thread_clear(meids_stat_thread_t* thread);
+static void stat_thread_free(meids_stat_thread_t* thread);
+static void stat_merge(meids_stat_entry_t* target, meids_stat_entry_t* source);
+static void* stat_dump_task(void* arg);
+static void stat_signal_handler(int signum);
+
+static int stat_register(meids_stat_site_t* site)
+{
+	int id;
+
+	pthread_mutex_lock(&stat_mutex);
+		id = __atomic_load_n(&site->id, __ATOMIC_ACQUIRE);
+		if (id < 0)
+		{
+			if (stat_names_count < ME_STAT_MAX_APIS)
+			{
+				id = stat_names_count;
+				stat_names[id] = site->name;
+				stat_names_count++;
+			}
+			else
+			{
+				LIBPERROR("Too many instrumented functions. %s not registered.\n", site->name);
+				id = ME_STAT_MAX_APIS;
+			}
+			__atomic_store_n(&site->id, id, __ATOMIC_RELEASE);
+		}
+	pthread_mutex_unlock(&stat_mutex);
+
+	return id;
+}
+
+static meids_stat_thread_t* stat_thread_get(void)
+{
+	meids_stat_thread_t* thread = stat_thread;
+
+	if (!thread)
+	{
+		thread = calloc(1, sizeof(meids_stat_thread_t));
+		if (!thread)
+			return NULL;
+
+		pthread_mutex_lock(&stat_mutex);
+			thread->generation = stat_generation;
+			thread->next = stat_threads;
+			stat_threads = thread;
+		pthread_mutex_unlock(&stat_mutex);
+
+		stat_thread = thread;
+		pthread_setspecific(stat_key, thread);
+	}
+
+	return thread;
+}
+
+static meids_stat_entry_t* stat_entry_peek(meids_stat_thread_t* thread, int id, int device)
+{/// @note Any thread. NULL when entry was never hit.
+	meids_stat_row_t* row;
+
+	row = __atomic_load_n(&thread->rows[id], __ATOMIC_ACQUIRE);
+	if (!row)
+		return NULL;
+
+	return __atomic_load_n(&(*row)[device], __ATOMIC_ACQUIRE);
+}
+
+static meids_stat_entry_t* stat_entry_get(meids_stat_thread_t* thread, int id, int device)
+{/// @note Owner of thread's storage only (or stat_mutex holder for stat_retired). NULL when out of memory.
+	meids_stat_row_t* row;
+	meids_stat_entry_t* entry;
+
+	row = thread->rows[id];
+	if (!row)
+	{
+		row = calloc(1, sizeof(meids_stat_row_t));
+		if (!row)
+			return NULL;
+		__atomic_store_n(&thread->rows[id], row, __ATOMIC_RELEASE);
+	}
+
+	entry = (*row)[device];
+	if (!entry)
+	{
+		entry = calloc(1, sizeof(meids_stat_entry_t));
+		if (!entry)
+			return NULL;
+		__atomic_store_n(&(*row)[device], entry, __ATOMIC_RELEASE);
+	}
+
+	return entry;
+}
+
+static void stat_thread_clear(meids_stat_thread_t* thread)
+{/// @note Owner of thread's storage only (or stat_mutex holder for stat_retired). Allocated entries are kept.
+	int a;
+	int d;
+
+	for (a = 0; a < ME_STAT_MAX_APIS; a++)
+	{
+		if (!thread->rows[a])
+			continue;
+
+		for (d = 0; d <= ME_STAT_MAX_DEVICES; d++)
+		{
+			if ((*thread->rows[a])[d])
+				memset((*thread->rows[a])[d], 0, sizeof(meids_stat_entry_t));
+		}
+	}
+}
+
+static void stat_thread_free(meids_stat_thread_t* thread)
+{
+	int a;
+	int d;
+
+	for (a = 0; a < ME_STAT_MAX_APIS; a++)
+	{
+		if (!thread->rows[a])
+			continue;
+
+		for (d = 0; d <= ME_STAT_MAX_DEVICES; d++)
+		{
+			free((*thread->rows[a])[d]);
+		}
+		free(thread->rows[a]);
+	}
+
+	free(thread);
+}
+
+static void stat_thread_exit(void* arg)
+{/// @note Counters of finished thread are kept in stat_retired. Counters from before last reset are dropped.
+	meids_stat_thread_t* thread = arg;
+	meids_stat_thread_t** link;
+	meids_stat_entry_t* source;
+	meids_stat_entry_t* target;
+	int a;
+	int d;
+
+	stat_thread = NULL;
+
+	pthread_mutex_lock(&stat_mutex);
+		for (link = &stat_threads; *link; link = &(*link)->next)
+		{
+			if (*link == thread)
+			{
+				*link = thread->next;
+				break;
+			}
+		}
+
+		if (thread->generation != stat_generation)
+		{
+			stat_thread_clear(thread);
+			thread->generation = stat_generation;
+		}
+
+		if (!stat_retired)
+		{
+			stat_retired = thread;
+			thread->next = NULL;
+			thread = NULL;
+		}
+		else
+		{
+			for (a = 0; a < stat_names_count; a++)
+			{
+				for (d = 0; d <= ME_STAT_MAX_DEVICES; d++)
+				{
+					source = stat_entry_peek(thread, a, d);
+					if (!source || !source->calls)
+						continue;
+
+					target = stat_entry_get(stat_retired, a, d);
+					if (target)
+						stat_merge(target, source);
+				}
+			}
+		}
+	pthread_mutex_unlock(&stat_mutex);
+
+	if (thread)
+		stat_thread_free(thread);
+}
+
+void meids_statistics_record(meids_stat_site_t* site, int device, int err, uint64_t time)
+{
+	meids_stat_thread_t* thread;
+	meids_stat_entry_t* entry;
+	unsigned int generation;
+	int id;
+	int bucket;
+
+	id = __atomic_load_n(&site->id, __ATOMIC_ACQUIRE);
+	if (id < 0)
+		id = stat_register(site);
+
+	if (id >= ME_STAT_MAX_APIS)
+		return;
+
+	thread = stat_thread_get();
+	if (!thread)
+		return;
+
+	if ((device < 0) || (device >= ME_STAT_MAX_DEVICES))
+		device = ME_STAT_MAX_DEVICES;
+
+	generation = __atomic_load_n(&stat_generation, __ATOMIC_ACQUIRE);
+	if (thread->generation != generation)
+	{// Reset requested. Readers skip this thread until new generation is stored.
+		stat_thread_clear(thread);
+		__atomic_store_n(&thread->generation, generation, __ATOMIC_RELEASE);
+	}
+
+	entry = stat_entry_get(thread, id, device);
+	if (!entry)
+		return;
+
+	// Bucket n: [2^n, 2^(n+1)) ns.
+	bucket = 63 - __builtin_clzll(time | 1);
+	if (bucket >= ME_STATISTICS_HISTOGRAM_COUNT)
+		bucket = ME_STATISTICS_HISTOGRAM_COUNT - 1;
+
+	if (!entry->calls || (time < entry->min))
+		entry->min = time;
+	if (time > entry->max)
+		entry->max = time;
+
+	entry->calls++;
+	entry->total += time;
+	entry->histogram[bucket]++;
+	if (err)
+		entry->errors++;
+}
+
+static void stat_merge(meids_stat_entry_t* target, meids_stat_entry_t* source)
+{
+	int i;
+
+	if (!source || !source->calls)
+		return;
+
+	if (!target->calls || (source->min < target->min))
+		target->min = source->min;
+	if (source->max > target->max)
+		target->max = source->max;
+
+	target->calls += source->calls;
+	target->errors += source->errors;
+	target->total += source->total;
+	for (i = 0; i < ME_STATISTICS_HISTOGRAM_COUNT; i++)
+	{
+		target->histogram[i] += source->histogram[i];
+	}
+}
+
+int meids_statistics_query(meStatistics_t* statistics, int* count, int flags)
+{/// @note Counters of running threads are read without locking them. Result is a snapshot, not an atomic one.
+ /// @note Reset does not touch counters of running threads. It starts new generation, each thread clears its own counters on next call.
+ /// Threads that did not apply it yet are skipped, their counters belong to old generation.
+	meids_stat_thread_t* thread;
+	meids_stat_entry_t sum;
+	int err = ME_ERRNO_SUCCESS;
+	int entries = 0;
+	int a;
+	int d;
+
+	pthread_mutex_lock(&stat_mutex);
+		for (a = 0; a < stat_names_count; a++)
+		{
+			for (d = 0; d <= ME_STAT_MAX_DEVICES; d++)
+			{
+				memset(&sum, 0, sizeof(meids_stat_entry_t));
+
+				if (stat_retired)
+					stat_merge(&sum, stat_entry_peek(stat_retired, a, d));
+
+				for (thread = stat_threads; thread; thread = thread->next)
+				{
+					if (__atomic_load_n(&thread->generation, __ATOMIC_ACQUIRE) == stat_generation)
+						stat_merge(&sum, stat_entry_peek(thread, a, d));
+				}
+
+				if (!sum.calls)
+					continue;
+
+				if (statistics && (entries < *count))
+				{
+					strncpy(statistics[entries].cName, stat_names[a], ME_STATISTICS_NAME_MAX_COUNT - 1);
+					statistics[entries].cName[ME_STATISTICS_NAME_MAX_COUNT - 1] = '\0';
+					statistics[entries].iDevice = (d < ME_STAT_MAX_DEVICES) ? d : ME_VALUE_INVALID;
+					statistics[entries].ullCalls = sum.calls;
+					statistics[entries].ullErrors = sum.errors;
+					statistics[entries].ullTotalTime = sum.total;
+					statistics[entries].ullMinTime = sum.min;
+					statistics[entries].ullMaxTime = sum.max;
+					memcpy(statistics[entries].ullHistogram, sum.histogram, sizeof(sum.histogram));
+				}
+				else if (statistics)
+				{
+					err = ME_ERRNO_INVALID_VALUE_COUNT;
+				}
+
+				entries++;
+			}
+		}
+
+		if (flags & ME_QUERY_STATISTICS_RESET)
+		{
+			if (stat_retired)
+				stat_thread_clear(stat_retired);
+
+			__atomic_store_n(&stat_generation, stat_generation + 1, __ATOMIC_RELEASE);
+		}
+	pthread_mutex_unlock(&stat_mutex);
+
+	// Returns number of entries available. Without buffer it is only a size query.
+	*count = entries;
+
+	return err;
+}
+
+void meids_statistics_dump(FILE* stream)
+{
+	meStatistics_t* statistics;
+	int count = 0;
+	int i;
+	int b;
+
+	meids_statistics_query(NULL, &count, ME_QUERY_NO_FLAGS);
+	if (!count)
+	{
+		fprintf(stream, "ME-iDS statistics: no calls recorded.\n");
+		return;
+	}
+
+	statistics = calloc(count, sizeof(meStatistics_t));
+	if (!statistics)
+		return;
+
+	meids_statistics_query(statistics, &count, ME_QUERY_NO_FLAGS);
+
+	fprintf(stream, "ME-iDS statistics: %-36s %6s %12s %8s %12s %12s %12s\n", "function", "device", "calls", "errors", "min [ns]", "avg [ns]", "max [ns]");
+	for (i = 0; i < count; i++)
+	{
+		fprintf(stream, "ME-iDS statistics: %-36s %6d %12llu %8llu %12llu %12llu %12llu\n",
+				statistics[i].cName, statistics[i].iDevice,
+				statistics[i].ullCalls, statistics[i].ullErrors,
+				statistics[i].ullMinTime, statistics[i].ullTotalTime / statistics[i].ullCalls, statistics[i].ullMaxTime);
+
+		fprintf(stream, "ME-iDS statistics: %-36s histogram", "");
+		for (b = 0; b < ME_STATISTICS_HISTOGRAM_COUNT; b++)
+		{
+			if (statistics[i].ullHistogram[b])
+				fprintf(stream, " 2^%d:%llu", b, statistics[i].ullHistogram[b]);
+		}
+		fprintf(stream, "\n");
+	}
+	fflush(stream);
+
+	free(statistics);
+}
+
+static void stat_signal_handler(int signum)
+{/// @note Only async-signal-safe call here. Dump is done by stat_dump_task.
+	sem_post(&stat_dump_sem);
+}
+
+static void* stat_dump_task(void* arg)
+{
+	FILE* stream;
+	sigset_t mask;
+
+	// Signal has to be handled by application's threads.
+	sigfillset(&mask);
+	pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+	for (;;)
+	{
+		while (sem_wait(&stat_dump_sem) && (errno == EINTR))
+			;
+
+		stream = stat_dump_file ? fopen(stat_dump_file, "a") : stderr;
+		if (!stream)
+		{
+			LIBPERROR("Can not open %s: %s\n", stat_dump_file, strerror(errno));
+			continue;
+		}
+
+		meids_statistics_dump(stream);
+
+		if (stream != stderr)
+			fclose(stream);
+	}
+
+	return NULL;
+}
+
+void meids_statistics_init(void)
+{
+	struct sigaction action;
+	pthread_attr_t attr;
+	pthread_t dump_thread;
+	char* env;
+	int signum;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	pthread_key_create(&stat_key, stat_thread_exit);
+
+	env = getenv("MEIDS_STATISTICS");
+	if (env && atoi(env))
+	{
+		meids_statistics_enabled = 1;
+	}
+
+	env = getenv("MEIDS_STATISTICS_SIGNAL");
+	if (!env)
+		return;
+
+	signum = atoi(env);
+	if ((signum <= 0) || (signum >= NSIG))
+	{
+		LIBPERROR("MEIDS_STATISTICS_SIGNAL=%s is not valid signal.\n", env);
+		return;
+	}
+
+	stat_dump_file = getenv("MEIDS_STATISTICS_FILE");
+
+	if (sem_init(&stat_dump_sem, 0, 0))
+	{
+		LIBPERROR("sem_init() failed: %s\n", strerror(errno));
+		return;
+	}
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	if (pthread_create(&dump_thread, &attr, stat_dump_task, NULL))
+	{
+		LIBPERROR("Can not create statistics' dump thread.\n");
+		pthread_attr_destroy(&attr);
+		return;
+	}
+	pthread_attr_destroy(&attr);
+
+	memset(&action, 0, sizeof(struct sigaction));
+	action.sa_handler = stat_signal_handler;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	if (sigaction(signum, &action, NULL))
+	{
+		LIBPERROR("sigaction(%d) failed: %s\n", signum, strerror(errno));
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef __KERNEL__
+# ifndef _MEIDS_STATISTICS_H_
+#  define _MEIDS_STATISTICS_H_
+
+#  include <stdio.h>
+#  include <stdint.h>
+#  include <time.h>
+
+#  include "me_types.h"
+#  include "meids_debug.h"
+
+/// Maximum number of instrumented functions.
+#  define ME_STAT_MAX_APIS			96
+/// Devices with higher numbers (and calls without device) are counted together.
+#  define ME_STAT_MAX_DEVICES		16
+#  define ME_STAT_NO_DEVICE			-1
+
+/// Call site. One per instrumented function, registered on first recorded call.
+typedef struct meids_stat_site
+{
+	const char* name;
+	int id;
+} meids_stat_site_t;
+
+/// Run time switch. Hot path only checks this flag when instrumentation is disabled.
+extern volatile int meids_statistics_enabled;
+
+static inline uint64_t meids_stat_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void meids_statistics_record(meids_stat_site_t* site, int device, int err, uint64_t time);
+/// Sums counters of all threads. *count: in - size of statistics, out - number of available entries.
+int meids_statistics_query(meStatistics_t* statistics, int* count, int flags);
+void meids_statistics_dump(FILE* stream);
+
+/// LIBMEDEBUG_TIMESTAMPS builds always measure execution time.
+#  ifdef LIBMEDEBUG_TIMESTAMPS
+#   define ME_STAT_ACTIVE()	1
+#  else
+#   define ME_STAT_ACTIVE()	__builtin_expect(meids_statistics_enabled, 0)
+#  endif
+
+/// Start of measurement. Returns 0 when instrumentation is disabled (no timing call).
+#  define ME_STAT_BEGIN() (ME_STAT_ACTIVE() ? meids_stat_now() : 0)
+
+/// End of measurement. Execution time goes to syslog (LIBMEDEBUG_TIMESTAMPS) and to statistics.
+#  define ME_STAT_END(start, device, err) \
+	do \
+	{ \
+		if (start) \
+		{ \
+			static meids_stat_site_t stat_site = { __FUNCTION__, -1 }; \
+			uint64_t stat_time = meids_stat_now() - (start); \
+			LIBPEXECTIME("executed in %ld us\n", (long)(stat_time / 1000)); \
+			if (meids_statistics_enabled) \
+				meids_statistics_record(&stat_site, (device), (err), stat_time); \
+		} \
+	} while (0)
+
+# endif	//_MEIDS_STATISTICS_H_
+#else
+# error KERNEL???
+#endif	//__KERNEL__
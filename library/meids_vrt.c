@@ -26,8 +26,10 @@
 
 # include <stdio.h>
 # include <stdlib.h>
+# include <string.h>
 # include <errno.h>
 # include <syslog.h>
+# include <pthread.h>
 
 # include "me_error.h"
 # include "me_types.h"
@@ -41,6 +43,72 @@
 # include "meids_config.h"
 # include "meids_vrt.h"
 
+/// Query cache. Readers are lock free. Writers (fill and invalidate) are serialized.
+static pthread_mutex_t vrt_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static me_cfg_query_cache_t* vrt_cache_get(me_cfg_device_entry_t* device, int subdevice, int iFlags);
+static int  vrt_cache_valid(me_cfg_query_cache_t* cache, unsigned int mask);
+static void vrt_cache_set_valid(me_cfg_query_cache_t* cache, unsigned int mask);
+static void vrt_cache_invalidate(me_cfg_device_entry_t* device, int subdevice);
+static void vrt_cache_check(me_cfg_device_entry_t* device, int err);
+
+static me_cfg_query_cache_t* vrt_cache_get(me_cfg_device_entry_t* device, int subdevice, int iFlags)
+{
+	// Flags change the answer (egz. oscilloscope timers). Those are not cached.
+	if (iFlags != ME_QUERY_NO_FLAGS)
+		return NULL;
+
+	if ((subdevice < 0) || (subdevice >= device->subdevice_list_count))
+		return NULL;
+
+	if (!device->subdevice_list || !device->subdevice_list[subdevice])
+		return NULL;
+
+	return &device->subdevice_list[subdevice]->cache;
+}
+
+static int vrt_cache_valid(me_cfg_query_cache_t* cache, unsigned int mask)
+{
+	return ((__atomic_load_n(&cache->valid, __ATOMIC_ACQUIRE) & mask) == mask);
+}
+
+/// Call under vrt_cache_mutex, after data is written.
+static void vrt_cache_set_valid(me_cfg_query_cache_t* cache, unsigned int mask)
+{
+	__atomic_store_n(&cache->valid, cache->valid | mask, __ATOMIC_RELEASE);
+}
+
+static void vrt_cache_invalidate(me_cfg_device_entry_t* device, int subdevice)
+{
+	me_cfg_query_cache_t* cache;
+	int i;
+
+	pthread_mutex_lock(&vrt_cache_mutex);
+	for (i = 0; i < device->subdevice_list_count; i++)
+	{
+		if ((subdevice >= 0) && (subdevice != i))
+			continue;
+
+		if (!device->subdevice_list || !device->subdevice_list[i])
+			continue;
+
+		cache = &device->subdevice_list[i]->cache;
+		__atomic_store_n(&cache->valid, 0, __ATOMIC_RELEASE);
+		__atomic_store_n(&cache->ranges_valid, 0, __ATOMIC_RELEASE);
+		__atomic_store_n(&cache->caps_args_count, 0, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&vrt_cache_mutex);
+}
+
+/// Device was unplugged. Cached answers can belong to other device after replug.
+static void vrt_cache_check(me_cfg_device_entry_t* device, int err)
+{
+	if (err == ME_ERRNO_DEVICE_UNPLUGGED)
+	{
+		vrt_cache_invalidate(device, -1);
+	}
+}
+
 int  ME_virtual_LockDriver(void* context, int lock, int iFlags)
 {
 	int err;
@@ -55,6 +123,10 @@ int  ME_virtual_LockDriver(void* context, int lock, int iFlags)
 			err =  ((me_rpc_context_t*)context)->context_calls->LockDriver((me_rpc_context_t*)context, lock, iFlags);
 			break;
 
+		case me_context_type_simulated:		//Simulation
+			err =  ((me_sim_context_t*)context)->context_calls->LockDriver((me_sim_context_t*)context, lock, iFlags);
+			break;
+
 		default:
 			err = ME_ERRNO_INVALID_LOCK;
 	}
@@ -225,6 +297,10 @@ int  ME_virtual_QueryDeviceInfo(const me_config_t* cfg, int device, unsigned int
 				*bus_type	= ME_BUS_TYPE_ANY;
 				break;
 
+			case me_access_type_simulated:				//Simulation
+				*bus_type	= ME_BUS_TYPE_SIMULATED;
+				break;
+
 			default:
 				*bus_type	= ME_BUS_TYPE_INVALID;
 
@@ -273,11 +349,29 @@ int  ME_virtual_QuerySubdeviceType(const me_config_t* cfg, int device, int subde
 {
 	int err;
 	me_cfg_device_entry_t* cfg_reference;
+	me_cfg_query_cache_t* cache;
 
 	err = ConfigResolve(cfg, device, &cfg_reference);
 	if (!err)
 	{
+		cache = vrt_cache_get(cfg_reference, subdevice, iFlags);
+		if (cache && type && subtype && vrt_cache_valid(cache, ME_CFG_CACHE_TYPE))
+		{
+			*type = cache->type;
+			*subtype = cache->sub_type;
+			return ME_ERRNO_SUCCESS;
+		}
+
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->QuerySubdeviceType(cfg_reference->context, cfg_reference->info.device_no, subdevice, type, subtype, iFlags);
+		if (!err && cache)
+		{
+			pthread_mutex_lock(&vrt_cache_mutex);
+			cache->type = *type;
+			cache->sub_type = *subtype;
+			vrt_cache_set_valid(cache, ME_CFG_CACHE_TYPE);
+			pthread_mutex_unlock(&vrt_cache_mutex);
+		}
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -301,11 +395,27 @@ int  ME_virtual_QuerySubdeviceCaps(const me_config_t* cfg, int device, int subde
 {
 	int err;
 	me_cfg_device_entry_t* cfg_reference;
+	me_cfg_query_cache_t* cache;
 
 	err = ConfigResolve(cfg, device, &cfg_reference);
 	if (!err)
 	{
+		cache = vrt_cache_get(cfg_reference, subdevice, iFlags);
+		if (cache && caps && vrt_cache_valid(cache, ME_CFG_CACHE_CAPS))
+		{
+			*caps = cache->caps;
+			return ME_ERRNO_SUCCESS;
+		}
+
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->QuerySubdeviceCaps(cfg_reference->context, cfg_reference->info.device_no, subdevice, caps, iFlags);
+		if (!err && cache)
+		{
+			pthread_mutex_lock(&vrt_cache_mutex);
+			cache->caps = *caps;
+			vrt_cache_set_valid(cache, ME_CFG_CACHE_CAPS);
+			pthread_mutex_unlock(&vrt_cache_mutex);
+		}
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -315,11 +425,53 @@ int  ME_virtual_QuerySubdeviceCapsArgs(const me_config_t* cfg, int device, int s
 {
 	int err;
 	me_cfg_device_entry_t* cfg_reference;
+	me_cfg_query_cache_t* cache;
+	unsigned int caps_args_count;
+	unsigned int i;
 
 	err = ConfigResolve(cfg, device, &cfg_reference);
 	if (!err)
 	{
+		cache = vrt_cache_get(cfg_reference, subdevice, iFlags);
+		if ((count <= 0) || (count > ME_CFG_CACHE_ARGS))
+		{
+			cache = NULL;
+		}
+
+		if (cache && args)
+		{
+			caps_args_count = __atomic_load_n(&cache->caps_args_count, __ATOMIC_ACQUIRE);
+			for (i = 0; i < caps_args_count; i++)
+			{
+				if ((cache->caps_args[i].cap == cap) && (cache->caps_args[i].count == count))
+				{
+					memcpy(args, cache->caps_args[i].args, count * sizeof(int));
+					return ME_ERRNO_SUCCESS;
+				}
+			}
+		}
+
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->QuerySubdeviceCapsArgs(cfg_reference->context, cfg_reference->info.device_no, subdevice, cap, args, count, iFlags);
+		if (!err && cache)
+		{
+			pthread_mutex_lock(&vrt_cache_mutex);
+			caps_args_count = cache->caps_args_count;
+			for (i = 0; i < caps_args_count; i++)
+			{
+				if ((cache->caps_args[i].cap == cap) && (cache->caps_args[i].count == count))
+					break;
+			}
+
+			if ((i == caps_args_count) && (caps_args_count < ME_CFG_CACHE_CAPS_ARGS))
+			{
+				cache->caps_args[i].cap = cap;
+				cache->caps_args[i].count = count;
+				memcpy(cache->caps_args[i].args, args, count * sizeof(int));
+				__atomic_store_n(&cache->caps_args_count, caps_args_count + 1, __ATOMIC_RELEASE);
+			}
+			pthread_mutex_unlock(&vrt_cache_mutex);
+		}
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -330,11 +482,27 @@ int  ME_virtual_QueryChannelsNumber(const me_config_t* cfg, int device, int subd
 {
 	int err;
 	me_cfg_device_entry_t* cfg_reference;
+	me_cfg_query_cache_t* cache;
 
 	err = ConfigResolve(cfg, device, &cfg_reference);
 	if (!err)
 	{
+		cache = vrt_cache_get(cfg_reference, subdevice, iFlags);
+		if (cache && number && vrt_cache_valid(cache, ME_CFG_CACHE_CHANNELS))
+		{
+			*number = cache->channels;
+			return ME_ERRNO_SUCCESS;
+		}
+
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->QueryChannelsNumber(cfg_reference->context, cfg_reference->info.device_no, subdevice, number, iFlags);
+		if (!err && cache)
+		{
+			pthread_mutex_lock(&vrt_cache_mutex);
+			cache->channels = *number;
+			vrt_cache_set_valid(cache, ME_CFG_CACHE_CHANNELS);
+			pthread_mutex_unlock(&vrt_cache_mutex);
+		}
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -345,11 +513,47 @@ int  ME_virtual_QueryRangesNumber(const me_config_t* cfg, int device, int subdev
 {
 	int err;
 	me_cfg_device_entry_t* cfg_reference;
+	me_cfg_query_cache_t* cache;
+	unsigned int ranges_valid;
+	int i;
 
 	err = ConfigResolve(cfg, device, &cfg_reference);
 	if (!err)
 	{
+		cache = vrt_cache_get(cfg_reference, subdevice, iFlags);
+		if (cache && no_ranges && vrt_cache_valid(cache, ME_CFG_CACHE_RANGES_NUMBER))
+		{
+			if (unit == ME_UNIT_ANY)
+			{
+				*no_ranges = cache->ranges_number;
+				return ME_ERRNO_SUCCESS;
+			}
+
+			// Other known units are counted from cached ranges, when all of them are known.
+			ranges_valid = __atomic_load_n(&cache->ranges_valid, __ATOMIC_ACQUIRE);
+			if ((unit > me_units_type_min) && (unit < me_units_type_max)
+				&& (cache->ranges_number <= ME_CFG_CACHE_RANGES)
+				&& ((ranges_valid & ((0x1ULL << cache->ranges_number) - 1)) == ((0x1ULL << cache->ranges_number) - 1)))
+			{
+				*no_ranges = 0;
+				for (i = 0; i < cache->ranges_number; i++)
+				{
+					if (cache->ranges[i].unit == unit)
+						(*no_ranges)++;
+				}
+				return ME_ERRNO_SUCCESS;
+			}
+		}
+
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->QueryRangesNumber(cfg_reference->context, cfg_reference->info.device_no, subdevice, unit, no_ranges, iFlags);
+		if (!err && cache && (unit == ME_UNIT_ANY))
+		{
+			pthread_mutex_lock(&vrt_cache_mutex);
+			cache->ranges_number = *no_ranges;
+			vrt_cache_set_valid(cache, ME_CFG_CACHE_RANGES_NUMBER);
+			pthread_mutex_unlock(&vrt_cache_mutex);
+		}
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -359,11 +563,39 @@ int  ME_virtual_QueryRangeInfo(const me_config_t* cfg, int device, int subdevice
 {
 	int err;
 	me_cfg_device_entry_t* cfg_reference;
+	me_cfg_query_cache_t* cache;
 
 	err = ConfigResolve(cfg, device, &cfg_reference);
 	if (!err)
 	{
+		cache = vrt_cache_get(cfg_reference, subdevice, iFlags);
+		if ((range < 0) || (range >= ME_CFG_CACHE_RANGES))
+		{
+			cache = NULL;
+		}
+
+		if (cache && unit && min && max && max_data
+			&& (__atomic_load_n(&cache->ranges_valid, __ATOMIC_ACQUIRE) & (0x1 << range)))
+		{
+			*unit = cache->ranges[range].unit;
+			*min = cache->ranges[range].min;
+			*max = cache->ranges[range].max;
+			*max_data = cache->ranges[range].max_data;
+			return ME_ERRNO_SUCCESS;
+		}
+
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->QueryRangeInfo(cfg_reference->context, cfg_reference->info.device_no, subdevice, range, unit, min, max, max_data, iFlags);
+		if (!err && cache)
+		{
+			pthread_mutex_lock(&vrt_cache_mutex);
+			cache->ranges[range].unit = (enum me_units_type) *unit;
+			cache->ranges[range].min = *min;
+			cache->ranges[range].max = *max;
+			cache->ranges[range].max_data = *max_data;
+			__atomic_store_n(&cache->ranges_valid, cache->ranges_valid | (0x1 << range), __ATOMIC_RELEASE);
+			pthread_mutex_unlock(&vrt_cache_mutex);
+		}
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -387,11 +619,57 @@ int  ME_virtual_QuerySubdeviceTimer(const me_config_t* cfg, int device, int subd
 {
 	int err;
 	me_cfg_device_entry_t* cfg_reference;
+	me_cfg_query_cache_t* cache;
+	me_cfg_timer_cache_t* cached_timer = NULL;
+	unsigned int mask = 0;
 
 	err = ConfigResolve(cfg, device, &cfg_reference);
 	if (!err)
 	{
+		cache = vrt_cache_get(cfg_reference, subdevice, iFlags);
+		if (cache && (timer >= ME_TIMER_ACQ_START) && (timer < ME_TIMER_ACQ_START + ME_CFG_CACHE_TIMERS))
+		{
+			cached_timer = &cache->timers[timer - ME_TIMER_ACQ_START];
+			mask = ME_CFG_CACHE_TIMER << (timer - ME_TIMER_ACQ_START);
+		}
+
+		if (cached_timer && base && min_ticks_low && min_ticks_high && max_ticks_low && max_ticks_high && vrt_cache_valid(cache, mask))
+		{
+			*base = cached_timer->base;
+			*min_ticks_low = cached_timer->min_ticks_low;
+			*min_ticks_high = cached_timer->min_ticks_high;
+			*max_ticks_low = cached_timer->max_ticks_low;
+			*max_ticks_high = cached_timer->max_ticks_high;
+			return ME_ERRNO_SUCCESS;
+		}
+
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->QuerySubdeviceTimer(cfg_reference->context, cfg_reference->info.device_no, subdevice, timer, base, min_ticks_low, min_ticks_high, max_ticks_low, max_ticks_high, iFlags);
+		if (!err && cached_timer)
+		{
+			pthread_mutex_lock(&vrt_cache_mutex);
+			cached_timer->base = *base;
+			cached_timer->min_ticks_low = *min_ticks_low;
+			cached_timer->min_ticks_high = *min_ticks_high;
+			cached_timer->max_ticks_low = *max_ticks_low;
+			cached_timer->max_ticks_high = *max_ticks_high;
+			vrt_cache_set_valid(cache, mask);
+			pthread_mutex_unlock(&vrt_cache_mutex);
+		}
+		vrt_cache_check(cfg_reference, err);
+	}
+
+	return err;
+}
+
+int  ME_virtual_QueryLatencyProbe(const me_config_t* cfg, int device, int subdevice, meLatencyProbe_t* probe, int iFlags)
+{
+	int err;
+	me_cfg_device_entry_t* cfg_reference;
+
+	err = ConfigResolve(cfg, device, &cfg_reference);
+	if (!err)
+	{
+		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->QueryLatencyProbe(cfg_reference->context, cfg_reference->info.device_no, subdevice, probe, iFlags);
 	}
 
 	return err;
@@ -479,6 +757,7 @@ int  ME_virtual_ResetDevice(const me_config_t* cfg, int device, int iFlags)
 	if (!err)
 	{
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->ResetDevice(cfg_reference->context, cfg_reference->info.device_no, iFlags);
+		vrt_cache_invalidate(cfg_reference, -1);
 	}
 
 	return err;
@@ -493,6 +772,7 @@ int  ME_virtual_ResetSubdevice(const me_config_t* cfg, int device, int subdevice
 	if (!err)
 	{
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->ResetSubdevice(cfg_reference->context, cfg_reference->info.device_no, subdevice, iFlags);
+		vrt_cache_invalidate(cfg_reference, subdevice);
 	}
 
 	return err;
@@ -510,6 +790,7 @@ int  ME_virtual_SingleConfig(const me_config_t* cfg, int device, int subdevice,
 	if (!err)
 	{
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->SingleConfig(cfg_reference->context, cfg_reference->info.device_no, subdevice, channel, config, reference, synchro, trigger, edge, iFlags);
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -652,6 +933,7 @@ int  ME_virtual_StreamConfig(const me_config_t* cfg, int device, int subdevice,
 	if (!err)
 	{
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->StreamConfig(cfg_reference->context, cfg_reference->info.device_no, subdevice, list, count, trigger, threshold, iFlags);
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -666,6 +948,7 @@ int  ME_virtual_StreamConfigure(const me_config_t* cfg, int device, int subdevic
 	if (!err)
 	{
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->StreamConfigure(cfg_reference->context, cfg_reference->info.device_no, subdevice, list, count, trigger, threshold, iFlags);
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -722,6 +1005,7 @@ int  ME_virtual_StreamStart(const me_config_t* cfg, int device, int subdevice, i
 	if (!err)
 	{
 		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->StreamStart(cfg_reference->context, cfg_reference->info.device_no, subdevice, mode, timeout, iFlags);
+		vrt_cache_check(cfg_reference, err);
 	}
 
 	return err;
@@ -856,6 +1140,20 @@ int  ME_virtual_StreamStatus(const me_config_t* cfg, int device, int subdevice,
 	return err;
 }
 
+int  ME_virtual_StreamReader(const me_config_t* cfg, int device, int subdevice, int mode, int policy, int* dropped, int iFlags)
+{
+	int err;
+	me_cfg_device_entry_t* cfg_reference;
+
+	err = ConfigResolve(cfg, device, &cfg_reference);
+	if (!err)
+	{
+		err = ((me_dummy_context_t *)cfg_reference->context)->context_calls->StreamReader(cfg_reference->context, cfg_reference->info.device_no, subdevice, mode, policy, dropped, iFlags);
+	}
+
+	return err;
+}
+
 int  ME_virtual_StreamStop(const me_config_t* cfg, int device, int subdevice, int mode, int timeout, int iFlags)
 {
 	int err;
@@ -36,6 +36,7 @@ int  ME_virtual_QueryRangesNumber(const me_config_t* cfg, int device, int subdev
 int  ME_virtual_QueryRangeInfo(const me_config_t* cfg, int device, int subdevice, int range, int* unit, double* min, double* max, unsigned int* max_data, int iFlags);
 int  ME_virtual_QueryRangeByMinMax(const me_config_t* cfg, int device, int subdevice, int unit, double* min, double* max, int* max_data, int* range, int iFlags);
 int  ME_virtual_QuerySubdeviceTimer(const me_config_t* cfg, int device, int subdevice, int timer, int* base, int* min_ticks_low, int* min_ticks_high, int* max_ticks_low, int* max_ticks_high, int iFlags);
+int  ME_virtual_QueryLatencyProbe(const me_config_t* cfg, int device, int subdevice, meLatencyProbe_t* probe, int iFlags);
 
 //Input/Output
 int  ME_virtual_IrqStart(const me_config_t* cfg, int device, int subdevice, int channel, int source, int edge, int arg, int iFlags);
@@ -64,6 +65,7 @@ int  ME_virtual_StreamWrite(const me_config_t* cfg, int device, int subdevice, i
 int  ME_virtual_StreamStart(const me_config_t* cfg, int device, int subdevice, int mode, int timeout, int iFlags);
 int  ME_virtual_StreamStartList(const me_config_t* cfg, meIOStreamStart_t* list, int count, int iFlags);
 int  ME_virtual_StreamStatus(const me_config_t* cfg, int device, int subdevice, int wait, int* status, int* count, int iFlags);
+int  ME_virtual_StreamReader(const me_config_t* cfg, int device, int subdevice, int mode, int policy, int* dropped, int iFlags);
 int  ME_virtual_StreamStop(const me_config_t* cfg, int device, int subdevice, int mode, int timeout, int iFlags);
 int  ME_virtual_StreamStopList(const me_config_t* cfg, meIOStreamStop_t* list, int count, int iFlags);
 
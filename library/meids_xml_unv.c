@@ -49,8 +49,12 @@
 # include "meids_local_calls.h"
 # include "meids_local_config.h"
 # include "meids_rpc_calls.h"
+# include "meids_rpc_batch.h"
 # include "meids_rpc_config.h"
+# include "meids_sim_calls.h"
+# include "meids_sim_config.h"
 # include "meids_xml.h"
+# include "meids_config_cache.h"
 
 # include "meids_vrt.h"
 
@@ -59,12 +63,17 @@
 static int unv_xml_init(void);
 static int local_init_calltable(meids_calls_t** context_calls);
 static int rpc_init_calltable(meids_calls_t** context_calls);
+static int sim_init_calltable(meids_calls_t** context_calls);
 static int local_OpenDriver(const char* address, me_config_t** new_driver, me_local_context_t** new_context, int iFlags);
 static int local_CloseDriver(void* context, int iFlags);
 static int local_LockDriver(me_local_context_t* context, int lock, int iFlags);
 static int rpc_OpenDriver(const char* address, me_config_t** new_driver, me_rpc_context_t** new_context, int iFlags);
 static int rpc_CloseDriver(void* context, int iFlags);
 static int rpc_LockDriver(me_rpc_context_t* context, int lock, int iFlags);
+static int sim_OpenDriver(const char* address, me_config_t** new_driver, me_sim_context_t** new_context, int iFlags);
+static int sim_CloseDriver(void* context, int iFlags);
+static int sim_LockDriver(me_sim_context_t* context, int lock, int iFlags);
+static int sim_ConfigRead(me_config_t* cfg, const char* address, int flags);
 
 // Global variables - keep context and necessary references.
 static me_context_list_t*			Unv_Context;
@@ -74,6 +83,7 @@ static me_config_t*					Unv_Config;
 
 static meids_calls_t* Loc_Calls;
 static meids_calls_t* Rpc_Calls;
+static meids_calls_t* Sim_Calls;
 
 /// Init and exit of the shared object
 void __attribute__((constructor)) meids_unv_xml_init(void);
@@ -100,6 +110,7 @@ void meids_unv_xml_fini(void)
 	free(Unv_Context);
 	free(Loc_Calls);
 	free(Rpc_Calls);
+	free(Sim_Calls);
 }
 
 static int unv_xml_init(void)
@@ -110,6 +121,7 @@ static int unv_xml_init(void)
 	int cfg_raw_err;
 	int loc_err;
 	int rpc_err;
+	int sim_err;
 
 	LIBPINFO("executed: %s\n", __FUNCTION__);
 
@@ -118,8 +130,9 @@ static int unv_xml_init(void)
 	cnx_err = context_list_init(&Unv_Context);
 	loc_err = local_init_calltable(&Loc_Calls);
 	rpc_err = rpc_init_calltable(&Rpc_Calls);
+	sim_err = sim_init_calltable(&Sim_Calls);
 
-	if (cnx_err || cfg_raw_err  || cfg_err || loc_err || rpc_err)
+	if (cnx_err || cfg_raw_err  || cfg_err || loc_err || rpc_err || sim_err)
 	{
 		LIBPCRITICALERROR("Can not initialize library!\n");
 
@@ -138,6 +151,9 @@ static int unv_xml_init(void)
 		if (Rpc_Calls)
 			free(Rpc_Calls);
 
+		if (Sim_Calls)
+			free(Sim_Calls);
+
 		err = -ENOMEM;
 	}
 
@@ -315,12 +331,93 @@ static int rpc_LockDriver(me_rpc_context_t* context, int lock, int iFlags)
  	return LockDriver_RPC(context, lock, iFlags);
 }
 
+static int sim_OpenDriver(const char* address, me_config_t** new_driver, me_sim_context_t** new_context, int iFlags)
+{
+	me_config_t* cfg = NULL;
+	me_sim_context_t* context = NULL;
+	pthread_mutexattr_t attr;
+
+	int err = ME_ERRNO_SUCCESS;
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (!new_driver)
+		return ME_ERRNO_INVALID_POINTER;
+	if (!new_context)
+		return ME_ERRNO_INVALID_POINTER;
+
+	context = calloc(1, sizeof(me_sim_context_t));
+	if (!context)
+	{
+		err = -ENOMEM;
+		goto ERROR;
+	}
+	context->context_type = me_context_type_simulated;
+	context->context_calls = Sim_Calls;
+
+	// Callbacks may cancel themselves.
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&context->callbackContextMutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+	context->activeThreads = NULL;
+
+	cfg = calloc(1, sizeof(me_config_t));
+	if (!cfg)
+	{
+		err = -ENOMEM;
+		goto ERROR;
+	}
+	cfg->device_list = NULL;
+	cfg->device_list_count = 0;
+
+	err = Open_Sim(context, address, ME_OPEN_NO_FLAGS);
+	if (!err)
+	{
+		ConfigRead_Sim(context, cfg, ME_VALUE_NOT_USED);
+		ConfigEnumerate(cfg, 0, ME_VALUE_NOT_USED);
+
+		*new_driver = cfg;
+		*new_context = context;
+	}
+	else
+	{
+		*new_driver = NULL;
+		*new_context = NULL;
+	}
+
+ERROR:
+	if (err)
+	{
+		if (cfg)
+			free(cfg);
+
+		if (context)
+			free(context);
+	}
+
+	return err;
+}
+
+static int sim_CloseDriver(void* context, int iFlags)
+{
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	return Close_Sim(context, ME_CLOSE_NO_FLAGS);
+}
+
+static int sim_LockDriver(me_sim_context_t* context, int lock, int iFlags)
+{
+ 	return LockDriver_Sim(context, lock, iFlags);
+}
+
 /// Protected section
 int ME_unv_xml_OpenDriver(const char* address, me_config_t** new_driver, void** new_context, int iFlags)
 {
 	me_config_t* cfg = NULL;
 	me_local_context_t* context_local;
 	me_rpc_context_t* context_rpc;
+	me_sim_context_t* context_sim = NULL;
 
 	int err = ME_ERRNO_OPEN;
 
@@ -331,6 +428,14 @@ int ME_unv_xml_OpenDriver(const char* address, me_config_t** new_driver, void**
 		return err;
 	}
 
+	if (!strncmp(address, ME_SIM_ADDRESS_PREFIX, strlen(ME_SIM_ADDRESS_PREFIX)))
+	{// Simulated devices. Not a device file nor a host name.
+		err = sim_OpenDriver(address, &cfg, &context_sim, iFlags);
+		*new_driver = cfg;
+		*new_context = context_sim;
+		return err;
+	}
+
 	if (iFlags == ME_OPEN_NO_FLAGS)
 		iFlags = ME_OPEN_ALL;
 
@@ -381,6 +486,10 @@ int ME_unv_xml_CloseDriver(void* context, int iFlags)
 			err = rpc_CloseDriver(context, iFlags);
 			break;
 
+		case me_context_type_simulated:
+			err = sim_CloseDriver(context, iFlags);
+			break;
+
 		default:
 			LIBPERROR("Wrong context type. context_type=%d\n", ((me_dummy_context_t *)context)->context_type);
 			err = ME_ERRNO_CLOSE;
@@ -405,6 +514,10 @@ int ME_unv_xml_LockDriver(void* context, int lock, int iFlags)
 			err =  rpc_LockDriver((me_rpc_context_t*)context, lock, iFlags);
 			break;
 
+		case me_context_type_simulated:		//Simulation
+			err =  sim_LockDriver((me_sim_context_t*)context, lock, iFlags);
+			break;
+
 		default:
 			err = ME_ERRNO_INVALID_LOCK;
 	}
@@ -523,18 +636,26 @@ int ME_Open(char* address, int iFlags)
 
 	if (!err)
 	{
-		ConfigLoad_XML_ALL(&cfg_XML, MEIDS_XML_FILE, ME_VALUE_NOT_USED);
-
 		ConfigClean(Unv_Config, ME_VALUE_NOT_USED);
-		ConfigDuplicate(Unv_Config_Raw, &Tmp_Config, ME_VALUE_NOT_USED);
 
-		ConfigBind(&cfg_XML, Tmp_Config, Unv_Config, ME_VALUE_NOT_USED);
+		// XML parsing is the slowest part of open. Use bound config from last run when neither XML nor hardware changed.
+		if (ConfigCacheLoad(MEIDS_XML_FILE, Unv_Config_Raw, Unv_Config, ME_VALUE_NOT_USED))
+		{
+			ConfigLoad_XML_ALL(&cfg_XML, MEIDS_XML_FILE, ME_VALUE_NOT_USED);
+
+			ConfigDuplicate(Unv_Config_Raw, &Tmp_Config, ME_VALUE_NOT_USED);
+
+			if (!ConfigBind(&cfg_XML, Tmp_Config, Unv_Config, ME_VALUE_NOT_USED))
+			{
+				ConfigCacheStore(MEIDS_XML_FILE, Unv_Config_Raw, Unv_Config, ME_VALUE_NOT_USED);
+			}
 
-		ConfigClean(Tmp_Config, ME_VALUE_NOT_USED);
-		free(Tmp_Config);
-		Tmp_Config = NULL;
+			ConfigClean(Tmp_Config, ME_VALUE_NOT_USED);
+			free(Tmp_Config);
+			Tmp_Config = NULL;
 
-		ConfigClean(&cfg_XML, ME_VALUE_NOT_USED);
+			ConfigClean(&cfg_XML, ME_VALUE_NOT_USED);
+		}
 	}
 	return err;
 }
@@ -560,6 +681,7 @@ int ME_Close(int iFlags)
 				case me_access_type_PCI:						//Local PCI and ePCI boards
 				case me_access_type_USB:						//Synapse-USB & Mephisto-Family
 				case me_access_type_TCPIP:						//Synapse-LAN
+				case me_access_type_simulated:					//Simulation
 					err = ME_unv_xml_CloseDriver((*device_list)->context, iFlags);
 					break;
 
@@ -601,6 +723,32 @@ int ME_QueryLibraryVersion(int* version, int iFlags)
 	return ME_ERRNO_SUCCESS;
 }
 
+static int sim_ConfigRead(me_config_t* cfg, const char* address, int flags)
+{
+	me_sim_context_t* context_sim = NULL;
+	int err;
+
+	context_sim = calloc(1, sizeof(me_sim_context_t));
+	if (!context_sim)
+		return -ENOMEM;
+
+	context_sim->context_type = me_context_type_simulated;
+	context_sim->context_calls = Sim_Calls;
+	pthread_mutex_init(&context_sim->callbackContextMutex, NULL);
+
+	err = Open_Sim(context_sim, address, ME_OPEN_NO_FLAGS);
+	if (!err)
+	{
+		err = ConfigRead_Sim(context_sim, cfg, flags);
+		Close_Sim(context_sim, ME_CLOSE_NO_FLAGS);
+	}
+
+	pthread_mutex_destroy(&context_sim->callbackContextMutex);
+	free(context_sim);
+
+	return err;
+}
+
 int ME_ConfigRead(me_config_t* cfg, const char* address, int flags)
 {
 	me_local_context_t*	context_loc = NULL;
@@ -611,6 +759,11 @@ int ME_ConfigRead(me_config_t* cfg, const char* address, int flags)
 
 	CHECK_POINTER(cfg);
 
+	if (address && !strncmp(address, ME_SIM_ADDRESS_PREFIX, strlen(ME_SIM_ADDRESS_PREFIX)))
+	{
+		return sim_ConfigRead(cfg, address, flags);
+	}
+
 	context_loc = calloc(1, sizeof(me_local_context_t));
 	if (!context_loc)
 	{
@@ -832,6 +985,11 @@ int ME_QuerySubdeviceTimer(int device, int subdevice,
 	return ME_virtual_QuerySubdeviceTimer(Unv_Config, device, subdevice, timer, base, min_ticks_low, min_ticks_high, max_ticks_low, max_ticks_high, iFlags);
 }
 
+int ME_QueryLatencyProbe(int device, int subdevice, meLatencyProbe_t* probe, int iFlags)
+{
+	return ME_virtual_QueryLatencyProbe(Unv_Config, device, subdevice, probe, iFlags);
+}
+
 
 //Input/Output
 int ME_IrqStart(int device, int subdevice, int channel, int source, int edge, int arg, int iFlags)
@@ -929,6 +1087,11 @@ int ME_StreamStatus(int device, int subdevice, int wait, int* status, int* count
 	return ME_virtual_StreamStatus(Unv_Config, device, subdevice, wait, status, count, iFlags);
 }
 
+int ME_StreamReader(int device, int subdevice, int mode, int policy, int* dropped, int iFlags)
+{
+	return ME_virtual_StreamReader(Unv_Config, device, subdevice, mode, policy, dropped, iFlags);
+}
+
 int ME_StreamStop(int device, int subdevice, int mode, int timeout, int iFlags)
 {
 	return ME_virtual_StreamStop(Unv_Config, device, subdevice, mode, timeout, iFlags);
@@ -968,6 +1131,21 @@ int  ME_SetOffset(int device, int subdevice, int channel, int range, double* off
 	return ME_virtual_SetOffset(Unv_Config, device, subdevice, channel, range, offset, iFlags);
 }
 
+int  ME_BatchBegin(int iFlags)
+{
+	return BatchBegin_RPC(iFlags);
+}
+
+int  ME_BatchCommit(int* index, int iFlags)
+{
+	return BatchCommit_RPC(index, iFlags);
+}
+
+int  ME_BatchAbort(int iFlags)
+{
+	return BatchAbort_RPC(iFlags);
+}
+
 int  ME_ParametersSet(me_extra_param_set_t* paramset, int flags)
 {
 	return ME_virtual_ParametersSet(Unv_Config, paramset, flags);
@@ -1022,6 +1200,7 @@ static int local_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->QueryRangeInfo			= QueryRangeInfo_Local;
 	(*context_calls)->QueryRangeByMinMax		= QueryRangeByMinMax_Local;
 	(*context_calls)->QuerySubdeviceTimer		= QuerySubdeviceTimer_Local;
+	(*context_calls)->QueryLatencyProbe			= QueryLatencyProbe_Local;
 
 //Input/Output
 	(*context_calls)->IrqStart					= IrqStart_Local;
@@ -1047,6 +1226,7 @@ static int local_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->StreamStart				= StreamStart_Local;
 	(*context_calls)->StreamStartList			= StreamStartList_Local;
 	(*context_calls)->StreamStatus				= StreamStatus_Local;
+	(*context_calls)->StreamReader				= StreamReader_Local;
 	(*context_calls)->StreamStop				= StreamStop_Local;
 	(*context_calls)->StreamStopList			= StreamStopList_Local;
 
@@ -1102,6 +1282,7 @@ static int rpc_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->QueryRangeInfo			= QueryRangeInfo_RPC;
 	(*context_calls)->QueryRangeByMinMax		= QueryRangeByMinMax_RPC;
 	(*context_calls)->QuerySubdeviceTimer		= QuerySubdeviceTimer_RPC;
+	(*context_calls)->QueryLatencyProbe			= QueryLatencyProbe_RPC;
 
 //Input/Output
 	(*context_calls)->IrqStart					= IrqStart_RPC;
@@ -1127,6 +1308,7 @@ static int rpc_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->StreamStart				= StreamStart_RPC;
 	(*context_calls)->StreamStartList			= StreamStartList_RPC;
 	(*context_calls)->StreamStatus				= StreamStatus_RPC;
+	(*context_calls)->StreamReader				= StreamReader_RPC;
 	(*context_calls)->StreamStop				= StreamStop_RPC;
 	(*context_calls)->StreamStopList			= StreamStopList_RPC;
 
@@ -1140,3 +1322,85 @@ static int rpc_init_calltable(meids_calls_t** context_calls)
 	(*context_calls)->ParametersSet				= ParametersSet_RPC;
 	return 0;
 }
+
+static int sim_init_calltable(meids_calls_t** context_calls)
+{
+	if (!context_calls)
+		return ME_ERRNO_INTERNAL;
+
+	*context_calls = calloc(1, sizeof(meids_calls_t));
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	if (!*context_calls)
+		return -ENOMEM;
+
+//Lock
+	(*context_calls)->LockDriver				= LockDriver_Sim;
+	(*context_calls)->LockDevice				= LockDevice_Sim;
+	(*context_calls)->LockSubdevice				= LockSubdevice_Sim;
+
+//Query
+	(*context_calls)->QueryDriverVersion		= QueryDriverVersion_Sim;
+	(*context_calls)->QueryDriverName			= QueryDriverName_Sim;
+
+	(*context_calls)->QuerySubdriverVersion		= QuerySubdriverVersion_Sim;
+	(*context_calls)->QuerySubdriverName		= QuerySubdriverName_Sim;
+
+	(*context_calls)->QueryDeviceName			= QueryDeviceName_Sim;
+	(*context_calls)->QueryDeviceDescription	= QueryDeviceDescription_Sim;
+	(*context_calls)->QueryDeviceInfo			= QueryDeviceInfo_Sim;
+
+	(*context_calls)->QuerySubdevicesNumber		= QuerySubdevicesNumber_Sim;
+	(*context_calls)->QuerySubdevicesNumberByType= QuerySubdevicesNumberByType_Sim;
+	(*context_calls)->QuerySubdeviceType		= QuerySubdeviceType_Sim;
+	(*context_calls)->QuerySubdeviceByType		= QuerySubdeviceByType_Sim;
+	(*context_calls)->QuerySubdeviceCaps		= QuerySubdeviceCaps_Sim;
+	(*context_calls)->QuerySubdeviceCapsArgs	= QuerySubdeviceCapsArgs_Sim;
+
+	(*context_calls)->QueryChannelsNumber		= QueryChannelsNumber_Sim;
+
+	(*context_calls)->QueryRangesNumber			= QueryRangesNumber_Sim;
+	(*context_calls)->QueryRangeInfo			= QueryRangeInfo_Sim;
+	(*context_calls)->QueryRangeByMinMax		= QueryRangeByMinMax_Sim;
+	(*context_calls)->QuerySubdeviceTimer		= QuerySubdeviceTimer_Sim;
+	(*context_calls)->QueryLatencyProbe			= QueryLatencyProbe_Sim;
+
+//Input/Output
+	(*context_calls)->IrqStart					= IrqStart_Sim;
+	(*context_calls)->IrqWait					= IrqWait_Sim;
+	(*context_calls)->IrqStop					= IrqStop_Sim;
+	(*context_calls)->IrqTest					= IrqTest_Sim;
+
+	(*context_calls)->IrqSetCallback			= IrqSetCallback_Sim;
+
+	(*context_calls)->ResetDevice				= ResetDevice_Sim;
+	(*context_calls)->ResetSubdevice			= ResetSubdevice_Sim;
+
+	(*context_calls)->SingleConfig				= SingleConfig_Sim;
+	(*context_calls)->Single					= Single_Sim;
+	(*context_calls)->SingleList				= SingleList_Sim;
+
+	(*context_calls)->StreamConfig				= StreamConfig_Sim;
+	(*context_calls)->StreamConfigure			= StreamConfigure_Sim;
+
+	(*context_calls)->StreamNewValues			= StreamNewValues_Sim;
+	(*context_calls)->StreamRead				= StreamRead_Sim;
+	(*context_calls)->StreamWrite				= StreamWrite_Sim;
+	(*context_calls)->StreamStart				= StreamStart_Sim;
+	(*context_calls)->StreamStartList			= StreamStartList_Sim;
+	(*context_calls)->StreamStatus				= StreamStatus_Sim;
+	(*context_calls)->StreamReader				= StreamReader_Sim;
+	(*context_calls)->StreamStop				= StreamStop_Sim;
+	(*context_calls)->StreamStopList			= StreamStopList_Sim;
+
+	(*context_calls)->StreamSetCallbacks		= StreamSetCallbacks_Sim;
+
+	(*context_calls)->StreamTimeToTicks			= StreamTimeToTicks_Sim;
+	(*context_calls)->StreamFrequencyToTicks	= StreamFrequencyToTicks_Sim;
+
+	(*context_calls)->SetOffset					= SetOffset_Sim;
+
+	(*context_calls)->ParametersSet				= ParametersSet_Sim;
+	return 0;
+}
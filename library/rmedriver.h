@@ -523,6 +523,181 @@ struct me_query_version_device_driver_res {
 };
 typedef struct me_query_version_device_driver_res me_query_version_device_driver_res;
 
+struct me_topology_timer_res {
+	int error;
+	int base_frequency;
+	int min_ticks_low;
+	int min_ticks_high;
+	int max_ticks_low;
+	int max_ticks_high;
+};
+typedef struct me_topology_timer_res me_topology_timer_res;
+
+struct me_topology_subdevice_res {
+	int error;
+	int type;
+	int subtype;
+	int channels;
+	int caps;
+	struct {
+		u_int timers_len;
+		me_topology_timer_res *timers_val;
+	} timers;
+	struct {
+		u_int ranges_len;
+		me_query_range_info_res *ranges_val;
+	} ranges;
+};
+typedef struct me_topology_subdevice_res me_topology_subdevice_res;
+
+struct me_topology_device_res {
+	me_query_info_device_res info;
+	int driver_version;
+	char *name;
+	char *description;
+	char *driver_name;
+	struct {
+		u_int subdevices_len;
+		me_topology_subdevice_res *subdevices_val;
+	} subdevices;
+};
+typedef struct me_topology_device_res me_topology_device_res;
+
+struct me_query_topology_res {
+	int error;
+	struct {
+		u_int devices_len;
+		me_topology_device_res *devices_val;
+	} devices;
+};
+typedef struct me_query_topology_res me_query_topology_res;
+
+enum me_batch_op_type {
+	ME_BATCH_SINGLE_CONFIG = 1,
+	ME_BATCH_SINGLE = 2,
+	ME_BATCH_STREAM_CONFIG = 3,
+	ME_BATCH_STREAM_NEW_VALUES = 4,
+	ME_BATCH_STREAM_READ = 5,
+	ME_BATCH_STREAM_WRITE = 6,
+	ME_BATCH_STREAM_START = 7,
+	ME_BATCH_STREAM_STOP = 8,
+	ME_BATCH_STREAM_STATUS = 9,
+};
+typedef enum me_batch_op_type me_batch_op_type;
+
+struct me_batch_op {
+	me_batch_op_type type;
+	union {
+		me_io_single_config_params single_config;
+		me_io_single_params single;
+		me_io_stream_config_params stream_config;
+		me_io_stream_new_values_params stream_new_values;
+		me_io_stream_read_params stream_read;
+		me_io_stream_write_params stream_write;
+		me_io_stream_start_params stream_start;
+		me_io_stream_stop_params stream_stop;
+		me_io_stream_status_params stream_status;
+	} me_batch_op_u;
+};
+typedef struct me_batch_op me_batch_op;
+
+struct me_batch_op_res {
+	me_batch_op_type type;
+	union {
+		int single_config;
+		me_io_single_res single;
+		int stream_config;
+		me_io_stream_new_values_res stream_new_values;
+		me_io_stream_read_res stream_read;
+		me_io_stream_write_res stream_write;
+		me_io_stream_start_res stream_start;
+		me_io_stream_stop_res stream_stop;
+		me_io_stream_status_res stream_status;
+	} me_batch_op_res_u;
+};
+typedef struct me_batch_op_res me_batch_op_res;
+
+struct me_batch_params {
+	struct {
+		u_int ops_len;
+		me_batch_op *ops_val;
+	} ops;
+	int flags;
+};
+typedef struct me_batch_params me_batch_params;
+
+struct me_batch_res {
+	int error;
+	struct {
+		u_int results_len;
+		me_batch_op_res *results_val;
+	} results;
+};
+typedef struct me_batch_res me_batch_res;
+#define ME_RPC_ENCODING_INT32 0x0
+#define ME_RPC_ENCODING_PACKED16 0x1
+#define ME_RPC_ENCODING_DELTA 0x2
+
+struct me_io_stream_read_packed_params {
+	int device;
+	int subdevice;
+	int read_mode;
+	int count;
+	int encodings;
+	int flags;
+};
+typedef struct me_io_stream_read_packed_params me_io_stream_read_packed_params;
+
+struct me_io_stream_read_packed_res {
+	int error;
+	int count;
+	int encoding;
+	struct {
+		u_int data_len;
+		char *data_val;
+	} data;
+};
+typedef struct me_io_stream_read_packed_res me_io_stream_read_packed_res;
+
+struct me_io_stream_write_packed_params {
+	int device;
+	int subdevice;
+	int write_mode;
+	int count;
+	int encoding;
+	struct {
+		u_int data_len;
+		char *data_val;
+	} data;
+	int flags;
+};
+typedef struct me_io_stream_write_packed_params me_io_stream_write_packed_params;
+
+enum me_event_type {
+	ME_EVENT_IRQ = 1,
+	ME_EVENT_STREAM_NEW_VALUES = 2,
+};
+typedef enum me_event_type me_event_type;
+
+struct me_event_subscribe {
+	me_event_type type;
+	int device;
+	int subdevice;
+	int subscribe;
+	int flags;
+};
+typedef struct me_event_subscribe me_event_subscribe;
+
+struct me_event {
+	me_event_type type;
+	int device;
+	int subdevice;
+	int count;
+	int value;
+	int error;
+};
+typedef struct me_event me_event;
+
 #define RMEDRIVER_PROG 0x20000001
 #define RMEDRIVER_VERS 1
 
@@ -641,6 +816,24 @@ extern  me_query_version_main_driver_res* me_query_version_main_driver_proc_1_sv
 #define ME_QUERY_VERSION_DEVICE_DRIVER_PROC 38
 extern  me_query_version_device_driver_res* me_query_version_device_driver_proc_1(int*, CLIENT*);
 extern  me_query_version_device_driver_res* me_query_version_device_driver_proc_1_svc(int*, struct svc_req*);
+#define ME_QUERY_TOPOLOGY_PROC 39
+extern  me_query_topology_res* me_query_topology_proc_1(void*, CLIENT*);
+extern  me_query_topology_res* me_query_topology_proc_1_svc(void*, struct svc_req*);
+#define ME_BATCH_PROC 40
+extern  me_batch_res* me_batch_proc_1(me_batch_params*, CLIENT*);
+extern  me_batch_res* me_batch_proc_1_svc(me_batch_params*, struct svc_req*);
+#define ME_STREAM_ENCODINGS_PROC 41
+extern  int* me_stream_encodings_proc_1(int*, CLIENT*);
+extern  int* me_stream_encodings_proc_1_svc(int*, struct svc_req*);
+#define ME_IO_STREAM_READ_PACKED_PROC 42
+extern  me_io_stream_read_packed_res* me_io_stream_read_packed_proc_1(me_io_stream_read_packed_params*, CLIENT*);
+extern  me_io_stream_read_packed_res* me_io_stream_read_packed_proc_1_svc(me_io_stream_read_packed_params*, struct svc_req*);
+#define ME_IO_STREAM_WRITE_PACKED_PROC 43
+extern  me_io_stream_write_res* me_io_stream_write_packed_proc_1(me_io_stream_write_packed_params*, CLIENT*);
+extern  me_io_stream_write_res* me_io_stream_write_packed_proc_1_svc(me_io_stream_write_packed_params*, struct svc_req*);
+#define ME_EVENT_CHANNEL_PROC 44
+extern  int* me_event_channel_proc_1(int*, CLIENT*);
+extern  int* me_event_channel_proc_1_svc(int*, struct svc_req*);
 extern int rmedriver_prog_1_freeresult (SVCXPRT*, xdrproc_t, caddr_t);
 
 #else /* K&R C */
@@ -758,6 +951,24 @@ extern  me_query_version_main_driver_res* me_query_version_main_driver_proc_1_sv
 #define ME_QUERY_VERSION_DEVICE_DRIVER_PROC 38
 extern  me_query_version_device_driver_res* me_query_version_device_driver_proc_1();
 extern  me_query_version_device_driver_res* me_query_version_device_driver_proc_1_svc();
+#define ME_QUERY_TOPOLOGY_PROC 39
+extern  me_query_topology_res* me_query_topology_proc_1();
+extern  me_query_topology_res* me_query_topology_proc_1_svc();
+#define ME_BATCH_PROC 40
+extern  me_batch_res* me_batch_proc_1();
+extern  me_batch_res* me_batch_proc_1_svc();
+#define ME_STREAM_ENCODINGS_PROC 41
+extern  int* me_stream_encodings_proc_1();
+extern  int* me_stream_encodings_proc_1_svc();
+#define ME_IO_STREAM_READ_PACKED_PROC 42
+extern  me_io_stream_read_packed_res* me_io_stream_read_packed_proc_1();
+extern  me_io_stream_read_packed_res* me_io_stream_read_packed_proc_1_svc();
+#define ME_IO_STREAM_WRITE_PACKED_PROC 43
+extern  me_io_stream_write_res* me_io_stream_write_packed_proc_1();
+extern  me_io_stream_write_res* me_io_stream_write_packed_proc_1_svc();
+#define ME_EVENT_CHANNEL_PROC 44
+extern  int* me_event_channel_proc_1();
+extern  int* me_event_channel_proc_1_svc();
 extern int rmedriver_prog_1_freeresult ();
 #endif /* K&R C */
 
@@ -824,6 +1035,21 @@ extern  bool_t xdr_me_query_subdevice_caps_args_res (XDR*, me_query_subdevice_ca
 extern  bool_t xdr_me_query_version_library_res (XDR*, me_query_version_library_res*);
 extern  bool_t xdr_me_query_version_main_driver_res (XDR*, me_query_version_main_driver_res*);
 extern  bool_t xdr_me_query_version_device_driver_res (XDR*, me_query_version_device_driver_res*);
+extern  bool_t xdr_me_topology_timer_res (XDR*, me_topology_timer_res*);
+extern  bool_t xdr_me_topology_subdevice_res (XDR*, me_topology_subdevice_res*);
+extern  bool_t xdr_me_topology_device_res (XDR*, me_topology_device_res*);
+extern  bool_t xdr_me_query_topology_res (XDR*, me_query_topology_res*);
+extern  bool_t xdr_me_batch_op_type (XDR*, me_batch_op_type*);
+extern  bool_t xdr_me_batch_op (XDR*, me_batch_op*);
+extern  bool_t xdr_me_batch_op_res (XDR*, me_batch_op_res*);
+extern  bool_t xdr_me_batch_params (XDR*, me_batch_params*);
+extern  bool_t xdr_me_batch_res (XDR*, me_batch_res*);
+extern  bool_t xdr_me_io_stream_read_packed_params (XDR*, me_io_stream_read_packed_params*);
+extern  bool_t xdr_me_io_stream_read_packed_res (XDR*, me_io_stream_read_packed_res*);
+extern  bool_t xdr_me_io_stream_write_packed_params (XDR*, me_io_stream_write_packed_params*);
+extern  bool_t xdr_me_event_type (XDR*, me_event_type*);
+extern  bool_t xdr_me_event_subscribe (XDR*, me_event_subscribe*);
+extern  bool_t xdr_me_event (XDR*, me_event*);
 
 #else /* K&R C */
 extern bool_t xdr_me_lock_driver_params ();
@@ -886,6 +1112,21 @@ extern bool_t xdr_me_query_subdevice_caps_args_res ();
 extern bool_t xdr_me_query_version_library_res ();
 extern bool_t xdr_me_query_version_main_driver_res ();
 extern bool_t xdr_me_query_version_device_driver_res ();
+extern bool_t xdr_me_topology_timer_res ();
+extern bool_t xdr_me_topology_subdevice_res ();
+extern bool_t xdr_me_topology_device_res ();
+extern bool_t xdr_me_query_topology_res ();
+extern bool_t xdr_me_batch_op_type ();
+extern bool_t xdr_me_batch_op ();
+extern bool_t xdr_me_batch_op_res ();
+extern bool_t xdr_me_batch_params ();
+extern bool_t xdr_me_batch_res ();
+extern bool_t xdr_me_io_stream_read_packed_params ();
+extern bool_t xdr_me_io_stream_read_packed_res ();
+extern bool_t xdr_me_io_stream_write_packed_params ();
+extern bool_t xdr_me_event_type ();
+extern bool_t xdr_me_event_subscribe ();
+extern bool_t xdr_me_event ();
 
 #endif /* K&R C */
 
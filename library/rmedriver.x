@@ -86,7 +86,7 @@ struct me_io_single_config_params {
 	int channel;
 	int single_config;
 	int ref;
-	int trig_chan;
+	int trig_chain;
 	int trig_type;
 	int trig_edge;
 	int flags;
@@ -134,7 +134,7 @@ struct me_io_stream_config_entry_params {
 struct me_io_stream_trigger_params {
 	int acq_start_trig_type;
 	int acq_start_trig_edge;
-	int acq_start_trig_chan;
+	int acq_start_trig_chain;
 	int acq_start_ticks_low;
 	int acq_start_ticks_high;
 	int acq_start_args<10>;
@@ -452,6 +452,174 @@ struct me_query_version_device_driver_res {
 	int ver;
 };
 
+/*===========================================================================
+  Data types for topology snapshot
+  =========================================================================*/
+
+struct me_topology_timer_res {
+	int error;
+	int base_frequency;
+	int min_ticks_low;
+	int min_ticks_high;
+	int max_ticks_low;
+	int max_ticks_high;
+};
+
+struct me_topology_subdevice_res {
+	int error;
+	int type;
+	int subtype;
+	int channels;
+	int caps;
+	me_topology_timer_res timers<>;
+	me_query_range_info_res ranges<>;
+};
+
+struct me_topology_device_res {
+	me_query_info_device_res info;
+	int driver_version;
+	string name<>;
+	string description<>;
+	string driver_name<>;
+	me_topology_subdevice_res subdevices<>;
+};
+
+struct me_query_topology_res {
+	int error;
+	me_topology_device_res devices<>;
+};
+
+/*===========================================================================
+  Data types for compound requests
+  =========================================================================*/
+
+enum me_batch_op_type {
+	ME_BATCH_SINGLE_CONFIG = 1,
+	ME_BATCH_SINGLE = 2,
+	ME_BATCH_STREAM_CONFIG = 3,
+	ME_BATCH_STREAM_NEW_VALUES = 4,
+	ME_BATCH_STREAM_READ = 5,
+	ME_BATCH_STREAM_WRITE = 6,
+	ME_BATCH_STREAM_START = 7,
+	ME_BATCH_STREAM_STOP = 8,
+	ME_BATCH_STREAM_STATUS = 9
+};
+
+union me_batch_op switch (me_batch_op_type type) {
+	case ME_BATCH_SINGLE_CONFIG:
+		me_io_single_config_params single_config;
+	case ME_BATCH_SINGLE:
+		me_io_single_params single;
+	case ME_BATCH_STREAM_CONFIG:
+		me_io_stream_config_params stream_config;
+	case ME_BATCH_STREAM_NEW_VALUES:
+		me_io_stream_new_values_params stream_new_values;
+	case ME_BATCH_STREAM_READ:
+		me_io_stream_read_params stream_read;
+	case ME_BATCH_STREAM_WRITE:
+		me_io_stream_write_params stream_write;
+	case ME_BATCH_STREAM_START:
+		me_io_stream_start_params stream_start;
+	case ME_BATCH_STREAM_STOP:
+		me_io_stream_stop_params stream_stop;
+	case ME_BATCH_STREAM_STATUS:
+		me_io_stream_status_params stream_status;
+};
+
+union me_batch_op_res switch (me_batch_op_type type) {
+	case ME_BATCH_SINGLE_CONFIG:
+		int single_config;
+	case ME_BATCH_SINGLE:
+		me_io_single_res single;
+	case ME_BATCH_STREAM_CONFIG:
+		int stream_config;
+	case ME_BATCH_STREAM_NEW_VALUES:
+		me_io_stream_new_values_res stream_new_values;
+	case ME_BATCH_STREAM_READ:
+		me_io_stream_read_res stream_read;
+	case ME_BATCH_STREAM_WRITE:
+		me_io_stream_write_res stream_write;
+	case ME_BATCH_STREAM_START:
+		me_io_stream_start_res stream_start;
+	case ME_BATCH_STREAM_STOP:
+		me_io_stream_stop_res stream_stop;
+	case ME_BATCH_STREAM_STATUS:
+		me_io_stream_status_res stream_status;
+};
+
+/* Operations are executed in order. Execution stops on first error. */
+struct me_batch_params {
+	me_batch_op ops<>;
+	int flags;
+};
+
+/* One result for every executed operation. Error is the error of last one. */
+struct me_batch_res {
+	int error;
+	me_batch_op_res results<>;
+};
+
+/* Compact sample encodings of stream transfers. Accepted set is negotiated with ME_STREAM_ENCODINGS_PROC when context is opened. */
+const ME_RPC_ENCODING_INT32 = 0x0;		/* Little-endian 32-bit values. Always accepted. */
+const ME_RPC_ENCODING_PACKED16 = 0x1;	/* Little-endian 16-bit values. Only when every value fits. */
+const ME_RPC_ENCODING_DELTA = 0x2;		/* Differences of consecutive values. Zigzag, variable length (7 bits per byte). */
+
+struct me_io_stream_read_packed_params {
+	int device;
+	int subdevice;
+	int read_mode;
+	int count;
+	int encodings;
+	int flags;
+};
+
+
+struct me_io_stream_read_packed_res {
+	int error;
+	int count;
+	int encoding;
+	opaque data<>;
+};
+
+
+struct me_io_stream_write_packed_params {
+	int device;
+	int subdevice;
+	int write_mode;
+	int count;
+	int encoding;
+	opaque data<>;
+	int flags;
+};
+
+/*
+ * Event channel. After ME_EVENT_CHANNEL_PROC the connection serves no more calls.
+ * Client sends me_event_subscribe records, server pushes me_event records (XDR record marking).
+ */
+enum me_event_type {
+	ME_EVENT_IRQ = 1,
+	ME_EVENT_STREAM_NEW_VALUES = 2
+};
+
+struct me_event_subscribe {
+	me_event_type type;
+	int device;
+	int subdevice;
+	int subscribe;
+	int flags;
+};
+
+/* IRQ: count is irq_count. New values: count is number of new values.
+ * Error ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW: client did not read, count events of this subscription were dropped. */
+struct me_event {
+	me_event_type type;
+	int device;
+	int subdevice;
+	int count;
+	int value;
+	int error;
+};
+
 program RMEDRIVER_PROG {
 	version RMEDRIVER_VERS {
 		int ME_CLOSE_PROC(int) = 1;
@@ -495,5 +663,15 @@ program RMEDRIVER_PROG {
 		me_query_version_library_res ME_QUERY_VERSION_LIBRARY_PROC() = 36;
 		me_query_version_main_driver_res ME_QUERY_VERSION_MAIN_DRIVER_PROC() = 37;
 		me_query_version_device_driver_res ME_QUERY_VERSION_DEVICE_DRIVER_PROC(int) = 38;
+
+		me_query_topology_res ME_QUERY_TOPOLOGY_PROC() = 39;
+
+		me_batch_res ME_BATCH_PROC(me_batch_params) = 40;
+
+		int ME_STREAM_ENCODINGS_PROC(int) = 41;
+		me_io_stream_read_packed_res ME_IO_STREAM_READ_PACKED_PROC(me_io_stream_read_packed_params) = 42;
+		me_io_stream_write_res ME_IO_STREAM_WRITE_PACKED_PROC(me_io_stream_write_packed_params) = 43;
+
+		int ME_EVENT_CHANNEL_PROC(int) = 44;
 	} = 1;
 } = 0x20000001;
@@ -1044,3 +1044,166 @@ me_query_version_device_driver_res * me_query_version_device_driver_proc_1(int*
 
 	return clnt_res;
 }
+
+me_query_topology_res * me_query_topology_proc_1(void* argp, CLIENT* clnt)
+{
+	me_query_topology_res *clnt_res;
+
+	if (!clnt)
+	{
+		return NULL;
+	}
+
+	clnt_res = calloc(1, sizeof(*clnt_res));
+	if (!clnt_res)
+	{
+		return NULL;
+	}
+
+	if (clnt_call(clnt, ME_QUERY_TOPOLOGY_PROC,
+	              (xdrproc_t) xdr_void, (caddr_t) argp,
+	              (xdrproc_t) xdr_me_query_topology_res, (caddr_t) clnt_res,
+	              TIMEOUT) != RPC_SUCCESS)
+	{
+		free(clnt_res);
+		return NULL;
+	}
+
+	return clnt_res;
+}
+
+me_batch_res * me_batch_proc_1(me_batch_params* argp, CLIENT* clnt)
+{
+	me_batch_res *clnt_res;
+
+	if (!clnt)
+	{
+		return NULL;
+	}
+
+	clnt_res = calloc(1, sizeof(*clnt_res));
+	if (!clnt_res)
+	{
+		return NULL;
+	}
+
+	// Batch can contain blocking calls.
+	if (clnt_call(clnt, ME_BATCH_PROC,
+	              (xdrproc_t) xdr_me_batch_params, (caddr_t) argp,
+	              (xdrproc_t) xdr_me_batch_res, (caddr_t) clnt_res,
+	              LONG_TIMEOUT) != RPC_SUCCESS)
+	{
+		free(clnt_res);
+		return NULL;
+	}
+
+	return clnt_res;
+}
+
+int* me_stream_encodings_proc_1(int* argp, CLIENT* clnt)
+{
+	int* clnt_res;
+
+	if (!clnt)
+	{
+		return NULL;
+	}
+
+	clnt_res = calloc(1, sizeof(*clnt_res));
+	if (!clnt_res)
+	{
+		return NULL;
+	}
+
+	if (clnt_call(clnt, ME_STREAM_ENCODINGS_PROC,
+	              (xdrproc_t) xdr_int, (caddr_t) argp,
+	              (xdrproc_t) xdr_int, (caddr_t) clnt_res,
+	              TIMEOUT) != RPC_SUCCESS)
+	{
+		free(clnt_res);
+		return NULL;
+	}
+
+	return clnt_res;
+}
+
+me_io_stream_read_packed_res * me_io_stream_read_packed_proc_1(me_io_stream_read_packed_params* argp, CLIENT* clnt)
+{
+	me_io_stream_read_packed_res *clnt_res;
+
+	if (!clnt)
+	{
+		return NULL;
+	}
+
+	clnt_res = calloc(1, sizeof(*clnt_res));
+	if (!clnt_res)
+	{
+		return NULL;
+	}
+
+	if (clnt_call(clnt, ME_IO_STREAM_READ_PACKED_PROC,
+	              (xdrproc_t) xdr_me_io_stream_read_packed_params, (caddr_t) argp,
+	              (xdrproc_t) xdr_me_io_stream_read_packed_res, (caddr_t) clnt_res,
+	              LONG_TIMEOUT) != RPC_SUCCESS)
+	{
+		free(clnt_res);
+		return NULL;
+	}
+
+	return clnt_res;
+}
+
+me_io_stream_write_res * me_io_stream_write_packed_proc_1(me_io_stream_write_packed_params* argp, CLIENT* clnt)
+{
+	me_io_stream_write_res *clnt_res;
+
+	if (!clnt)
+	{
+		return NULL;
+	}
+
+	clnt_res = calloc(1, sizeof(*clnt_res));
+	if (!clnt_res)
+	{
+		return NULL;
+	}
+
+	if (clnt_call(clnt, ME_IO_STREAM_WRITE_PACKED_PROC,
+	              (xdrproc_t) xdr_me_io_stream_write_packed_params, (caddr_t) argp,
+	              (xdrproc_t) xdr_me_io_stream_write_res, (caddr_t) clnt_res,
+	              LONG_TIMEOUT) != RPC_SUCCESS)
+	{
+		free(clnt_res);
+		return NULL;
+	}
+
+	return clnt_res;
+}
+
+int* me_event_channel_proc_1(int* argp, CLIENT* clnt)
+{
+	int* clnt_res;
+
+	if (!clnt)
+	{
+		return NULL;
+	}
+
+	clnt_res = calloc(1, sizeof(*clnt_res));
+	if (!clnt_res)
+	{
+		return NULL;
+	}
+
+	if (clnt_call(clnt, ME_EVENT_CHANNEL_PROC,
+	              (xdrproc_t) xdr_int, (caddr_t) argp,
+	              (xdrproc_t) xdr_int, (caddr_t) clnt_res,
+	              TIMEOUT) != RPC_SUCCESS)
+	{
+		free(clnt_res);
+		return NULL;
+	}
+
+	return clnt_res;
+}
@@ -0,0 +1,289 @@
+/* RPC server demon for ME-iDS (event channel)
+ * ===========================================
+ *
+ *  Copyright (C) 2009 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ *  This file is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ *  Author:	Krzysztof Gantzke	<k.gantzke@meilhaus.de>
+ */
+
+#ifdef __KERNEL__
+# error This is user space demon!
+#endif	//__KERNEL__
+
+/**
+ * Every connection is served by its own process. Connection that asked for ME_EVENT_CHANNEL_PROC
+ * registers local callbacks for client's subscriptions. Callbacks (library's threads) pass events
+ * through a pipe to the main loop, that writes them to the socket as soon as they come.
+ * Nobody waits for client: when pipe is full, event is dropped and counted. Main loop reports
+ * the loss to subscriber as event with error ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <syslog.h>
+#include <pthread.h>
+#include <sys/select.h>
+
+#include "rmedriver.h"
+#include "medriver.h"
+
+#include "meids_debug.h"
+#include "rmedriver_event.h"
+
+static int event_pipe[2] = {-1, -1};
+
+/// Dropped events. Entry per subscription, count is number of lost events.
+static me_event* dropped = NULL;
+static int dropped_number = 0;
+static int dropped_size = 0;
+static pthread_mutex_t dropped_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void eventDrop(me_event* event)
+{
+	me_event* list;
+	int i;
+
+	pthread_mutex_lock(&dropped_mutex);
+		for (i = 0; i < dropped_number; i++)
+		{
+			if ((dropped[i].type == event->type) && (dropped[i].device == event->device) && (dropped[i].subdevice == event->subdevice))
+				break;
+		}
+
+		if (i == dropped_number)
+		{
+			if (dropped_number == dropped_size)
+			{
+				list = realloc(dropped, ((dropped_size) ? 2 * dropped_size : 8) * sizeof(me_event));
+				if (list)
+				{
+					dropped = list;
+					dropped_size = (dropped_size) ? 2 * dropped_size : 8;
+				}
+			}
+
+			if (dropped_number < dropped_size)
+			{
+				dropped[i].type = event->type;
+				dropped[i].device = event->device;
+				dropped[i].subdevice = event->subdevice;
+				dropped[i].count = 0;
+				dropped[i].value = 0;
+				dropped[i].error = ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
+				dropped_number++;
+			}
+		}
+
+		if (i < dropped_number)
+		{
+			dropped[i].count++;
+		}
+	pthread_mutex_unlock(&dropped_mutex);
+}
+
+static int eventSendDropped(XDR* xdrs)
+{
+	me_event* list;
+	int number;
+	int i;
+
+	pthread_mutex_lock(&dropped_mutex);
+		list = dropped;
+		number = dropped_number;
+		dropped = NULL;
+		dropped_number = 0;
+		dropped_size = 0;
+	pthread_mutex_unlock(&dropped_mutex);
+
+	for (i = 0; i < number; i++)
+	{
+		LIBPERROR("Events lost: type=%d device=%d subdevice=%d count=%d\n", list[i].type, list[i].device, list[i].subdevice, list[i].count);
+
+		xdrs->x_op = XDR_ENCODE;
+		if (!xdr_me_event(xdrs, list + i) || !xdrrec_endofrecord(xdrs, 1))
+		{
+			LIBPERROR("Can't send event.\n");
+			free(list);
+			return 1;
+		}
+	}
+
+	free(list);
+
+	return 0;
+}
+
+static void eventPush(me_event_type type, int device, int subdevice, int count, int value, int error)
+{
+	me_event event;
+
+	event.type = type;
+	event.device = device;
+	event.subdevice = subdevice;
+	event.count = count;
+	event.value = value;
+	event.error = error;
+
+	// Smaller than PIPE_BUF: written at once or not at all.
+	if (write(event_pipe[1], &event, sizeof(me_event)) != sizeof(me_event))
+	{
+		eventDrop(&event);
+	}
+}
+
+static int eventIrqCB(int iDevice, int iSubdevice, int iChannel, int iIrqCount, int iValue, void* pvContext, int iErrorCode)
+{
+	eventPush(ME_EVENT_IRQ, iDevice, iSubdevice, iIrqCount, iValue, iErrorCode);
+
+	// Client decides about stopping interrupts.
+	return 0;
+}
+
+static int eventNewValuesCB(int iDevice, int iSubdevice, int iCount, void* pvContext, int iErrorCode)
+{
+	eventPush(ME_EVENT_STREAM_NEW_VALUES, iDevice, iSubdevice, iCount, 0, iErrorCode);
+
+	// Client decides about stopping stream.
+	return 1;
+}
+
+static void eventSubscribe(me_event_subscribe* subscribe)
+{
+	int err;
+
+	LIBPDEBUG("type=%d device=%d subdevice=%d subscribe=%d flags=0x%x\n",
+				subscribe->type, subscribe->device, subscribe->subdevice, subscribe->subscribe, subscribe->flags);
+
+	switch (subscribe->type)
+	{
+		case ME_EVENT_IRQ:
+			err = meIOIrqSetCallback(subscribe->device, subscribe->subdevice,
+										(subscribe->subscribe) ? eventIrqCB : NULL, NULL,
+										subscribe->flags);
+			break;
+
+		case ME_EVENT_STREAM_NEW_VALUES:
+			err = meIOStreamSetCallbacks(subscribe->device, subscribe->subdevice,
+										NULL, NULL,
+										(subscribe->subscribe) ? eventNewValuesCB : NULL, NULL,
+										NULL, NULL,
+										subscribe->flags);
+			break;
+
+		default:
+			err = ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (err && subscribe->subscribe)
+	{// Reported like every other error of callback.
+		eventPush(subscribe->type, subscribe->device, subscribe->subdevice, 0, 0, err);
+	}
+}
+
+int * me_event_channel_proc_1_svc(int *flags, struct svc_req *dummy)
+{
+	int* err = malloc(sizeof(int));
+
+	if (err)
+	{
+		*err = ME_ERRNO_SUCCESS;
+		if (*flags)
+		{
+			*err = ME_ERRNO_INVALID_FLAGS;
+		}
+		else if ((event_pipe[0] < 0) && pipe(event_pipe))
+		{
+			LIBPERROR("Error in pipe() %d:%s", errno, strerror(errno));
+			*err = ME_ERRNO_INTERNAL;
+		}
+		else
+		{// Callbacks and main loop never wait for client.
+			fcntl(event_pipe[0], F_SETFL, O_NONBLOCK);
+			fcntl(event_pipe[1], F_SETFL, O_NONBLOCK);
+		}
+	}
+
+	return err;
+}
+
+int EventChannelActive(void)
+{
+	return (event_pipe[0] >= 0);
+}
+
+int EventChannelServe(XDR* xdrs, int sock)
+{
+	me_event event;
+	me_event_subscribe subscribe;
+	fd_set readfds;
+	int max_fd = (sock > event_pipe[0]) ? sock : event_pipe[0];
+
+	LIBPINFO("executed: %s\n", __FUNCTION__);
+
+	while (1)
+	{
+		FD_ZERO(&readfds);
+		FD_SET(sock, &readfds);
+		FD_SET(event_pipe[0], &readfds);
+
+		if (select(max_fd + 1, &readfds, NULL, NULL, NULL) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			LIBPERROR("Error in select() %d:%s", errno, strerror(errno));
+			break;
+		}
+
+		if (FD_ISSET(event_pipe[0], &readfds))
+		{
+			while (read(event_pipe[0], &event, sizeof(me_event)) == sizeof(me_event))
+			{
+				xdrs->x_op = XDR_ENCODE;
+				if (!xdr_me_event(xdrs, &event) || !xdrrec_endofrecord(xdrs, 1))
+				{
+					LIBPERROR("Can't send event.\n");
+					return 1;
+				}
+			}
+
+			// Pipe is empty now. Loss is reported after events, that came before.
+			if (eventSendDropped(xdrs))
+				return 1;
+		}
+
+		if (FD_ISSET(sock, &readfds))
+		{
+			do
+			{// Records already buffered by XDR are not visible to select().
+				xdrs->x_op = XDR_DECODE;
+				if (!xdrrec_skiprecord(xdrs) || !xdr_me_event_subscribe(xdrs, &subscribe))
+				{// Client closed channel.
+					return 1;
+				}
+
+				eventSubscribe(&subscribe);
+			}
+			while (!xdrrec_eof(xdrs));
+		}
+	}
+
+	return 1;
+}
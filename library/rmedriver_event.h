@@ -0,0 +1,13 @@
+#ifndef __KERNEL__
+# ifndef _RMEDRIVER_EVENT_H_
+#  define _RMEDRIVER_EVENT_H_
+
+#  include <rpc/rpc.h>
+
+/// True after ME_EVENT_CHANNEL_PROC was served on this connection.
+int  EventChannelActive(void);
+/// Pushes subscribed events to client till connection is closed. Returns exit code of connection's process.
+int  EventChannelServe(XDR* xdrs, int sock);
+
+# endif	//_RMEDRIVER_EVENT_H_
+#endif	//__KERNEL__
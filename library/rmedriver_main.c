@@ -37,6 +37,7 @@
 #include <rpc/rpc.h>
 #include <rpc/pmap_clnt.h>
 #include "rmedriver.h"
+#include "rmedriver_event.h"
 
 #include "meids_debug.h"
 
@@ -159,12 +160,19 @@ static int dispatch(XDR *xdrs)
 		me_query_subdevice_caps_params me_query_subdevice_caps_proc_1_arg;
 		me_query_subdevice_caps_args_params me_query_subdevice_caps_args_proc_1_arg;
 		int me_query_version_device_driver_proc_1_arg;
+		me_batch_params me_batch_proc_1_arg;
+		int me_stream_encodings_proc_1_arg;
+		me_io_stream_read_packed_params me_io_stream_read_packed_proc_1_arg;
+		me_io_stream_write_packed_params me_io_stream_write_packed_proc_1_arg;
+		int me_event_channel_proc_1_arg;
 	} argument;
 
 // 	char *result;
 	void* result = NULL;
 
 	xdrproc_t _xdr_argument, _xdr_result;
+	/// Results with allocated content. Most procedures return static buffers.
+	xdrproc_t _xdr_free_result = NULL;
 
 	char *(*local)(char *, struct svc_req *);
 
@@ -529,6 +537,57 @@ static int dispatch(XDR *xdrs)
 
 			break;
 
+		case ME_QUERY_TOPOLOGY_PROC:
+			_xdr_argument = (xdrproc_t) xdr_void;
+			_xdr_result = (xdrproc_t) xdr_me_query_topology_res;
+			_xdr_free_result = (xdrproc_t) xdr_me_query_topology_res;
+
+			local = (char * (*)(char *, struct svc_req *)) me_query_topology_proc_1_svc;
+
+			break;
+
+		case ME_BATCH_PROC:
+			_xdr_argument = (xdrproc_t) xdr_me_batch_params;
+			_xdr_result = (xdrproc_t) xdr_me_batch_res;
+			_xdr_free_result = (xdrproc_t) xdr_me_batch_res;
+
+			local = (char * (*)(char *, struct svc_req *)) me_batch_proc_1_svc;
+
+			break;
+
+		case ME_STREAM_ENCODINGS_PROC:
+			_xdr_argument = (xdrproc_t) xdr_int;
+			_xdr_result = (xdrproc_t) xdr_int;
+
+			local = (char * (*)(char *, struct svc_req *)) me_stream_encodings_proc_1_svc;
+
+			break;
+
+		case ME_IO_STREAM_READ_PACKED_PROC:
+			_xdr_argument = (xdrproc_t) xdr_me_io_stream_read_packed_params;
+			_xdr_result = (xdrproc_t) xdr_me_io_stream_read_packed_res;
+			_xdr_free_result = (xdrproc_t) xdr_me_io_stream_read_packed_res;
+
+			local = (char * (*)(char *, struct svc_req *)) me_io_stream_read_packed_proc_1_svc;
+
+			break;
+
+		case ME_IO_STREAM_WRITE_PACKED_PROC:
+			_xdr_argument = (xdrproc_t) xdr_me_io_stream_write_packed_params;
+			_xdr_result = (xdrproc_t) xdr_me_io_stream_write_res;
+
+			local = (char * (*)(char *, struct svc_req *)) me_io_stream_write_packed_proc_1_svc;
+
+			break;
+
+		case ME_EVENT_CHANNEL_PROC:
+			_xdr_argument = (xdrproc_t) xdr_int;
+			_xdr_result = (xdrproc_t) xdr_int;
+
+			local = (char * (*)(char *, struct svc_req *)) me_event_channel_proc_1_svc;
+
+			break;
+
 		default:
 			LIBPERROR("Invalid procedure number.\n");
 
@@ -599,6 +658,10 @@ static int dispatch(XDR *xdrs)
 
 	if (result)
 	{
+		if (_xdr_free_result)
+		{
+			xdr_free(_xdr_free_result, (char *)result);
+		}
 		free(result);
 	}
 
@@ -713,6 +776,11 @@ int main(int argc, char **argv)
 
 				if (err)
 					break;
+
+				if (EventChannelActive())
+				{// Connection serves only pushed events from now.
+					return EventChannelServe(&xdrs, connfd);
+				}
 			}
 
 			return 1;
@@ -1,9 +1,12 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "rmedriver.h"
 #include "medriver.h"
+#include "meids.h"
 
 #include "meids_debug.h"
+#include "meids_rpc_codec.h"
 
 int * me_open_proc_1_svc(int *flags, struct svc_req *dummy)
 {
@@ -309,6 +312,7 @@ me_io_stream_read_res * me_io_stream_read_proc_1_svc(me_io_stream_read_params *p
 								result->values.values_val,
 								&lenght,
 								params->flags);
+			result->values.values_len = lenght;
 		}
 		else
 		{
@@ -805,3 +809,395 @@ me_query_version_device_driver_res * me_query_version_device_driver_proc_1_svc(i
 
 	return result;
 }
+
+
+static void me_query_topology_subdevice(int device, int subdevice, me_topology_subdevice_res* result)
+{
+	int number = 0;
+	int err;
+	int i;
+
+	result->error = meQuerySubdeviceType(device, subdevice, &result->type, &result->subtype);
+	if (!result->error)
+	{
+		result->error = meQueryNumberChannels(device, subdevice, &result->channels);
+	}
+
+	if (meQuerySubdeviceCaps(device, subdevice, &result->caps))
+	{
+		result->caps = 0;
+	}
+
+	result->timers.timers_val = calloc(3, sizeof(me_topology_timer_res));
+	if (result->timers.timers_val)
+	{
+		result->timers.timers_len = 3;
+		for (i = 0; i < 3; i++)
+		{
+			result->timers.timers_val[i].error = ME_QuerySubdeviceTimer(
+													device,
+													subdevice,
+													ME_TIMER_ACQ_START + i,
+													&result->timers.timers_val[i].base_frequency,
+													&result->timers.timers_val[i].min_ticks_low,
+													&result->timers.timers_val[i].min_ticks_high,
+													&result->timers.timers_val[i].max_ticks_low,
+													&result->timers.timers_val[i].max_ticks_high,
+													ME_QUERY_NO_FLAGS);
+		}
+	}
+
+	if (result->error)
+		return;
+
+	err = meQueryNumberRanges(device, subdevice, ME_UNIT_ANY, &number);
+	if (err)
+	{
+		// Subdevices without ranges are not an error.
+		if (err != ME_ERRNO_NOT_SUPPORTED)
+		{
+			result->error = err;
+		}
+		return;
+	}
+
+	if (number)
+	{
+		result->ranges.ranges_val = calloc(number, sizeof(me_query_range_info_res));
+		if (!result->ranges.ranges_val)
+		{
+			result->error = ME_ERRNO_INTERNAL;
+			return;
+		}
+	}
+
+	for (i = 0; i < number; i++)
+	{
+		result->ranges.ranges_val[i].error = meQueryRangeInfo(
+												device,
+												subdevice,
+												i,
+												&result->ranges.ranges_val[i].unit,
+												&result->ranges.ranges_val[i].min,
+												&result->ranges.ranges_val[i].max,
+												&result->ranges.ranges_val[i].max_data);
+		if (result->ranges.ranges_val[i].error)
+		{
+			result->error = result->ranges.ranges_val[i].error;
+			break;
+		}
+	}
+	result->ranges.ranges_len = i;
+}
+
+
+static void me_query_topology_device(int device, me_topology_device_res* result)
+{
+	char name[ME_DEVICE_DESCRIPTION_MAX_COUNT];
+	int number = 0;
+	int i;
+
+	result->info.error = meQueryInfoDevice(
+							device,
+							&result->info.vendor_id,
+							&result->info.device_id,
+							&result->info.serial_no,
+							&result->info.bus_type,
+							&result->info.bus_no,
+							&result->info.dev_no,
+							&result->info.func_no,
+							&result->info.plugged);
+
+	if (!result->info.error)
+	{
+		result->info.error = meQueryNumberSubdevices(device, &number);
+	}
+
+	meQueryVersionDeviceDriver(device, &result->driver_version);
+
+	// Strings are freed by XDR, so they can not be NULL.
+	name[0] = '\0';
+	meQueryNameDevice(device, name, ME_DEVICE_NAME_MAX_COUNT);
+	result->name = strdup(name);
+
+	name[0] = '\0';
+	meQueryDescriptionDevice(device, name, ME_DEVICE_DESCRIPTION_MAX_COUNT);
+	result->description = strdup(name);
+
+	name[0] = '\0';
+	meQueryNameDeviceDriver(device, name, ME_DEVICE_DRIVER_NAME_MAX_COUNT);
+	result->driver_name = strdup(name);
+
+	if (!result->name || !result->description || !result->driver_name)
+	{
+		result->info.error = ME_ERRNO_INTERNAL;
+		return;
+	}
+
+	if (result->info.error || !number)
+		return;
+
+	result->subdevices.subdevices_val = calloc(number, sizeof(me_topology_subdevice_res));
+	if (!result->subdevices.subdevices_val)
+	{
+		result->info.error = ME_ERRNO_INTERNAL;
+		return;
+	}
+
+	result->subdevices.subdevices_len = number;
+	for (i = 0; i < number; i++)
+	{
+		me_query_topology_subdevice(device, i, &result->subdevices.subdevices_val[i]);
+	}
+}
+
+
+me_query_topology_res * me_query_topology_proc_1_svc(void *params, struct svc_req *dummy)
+{
+	me_query_topology_res* result = calloc(1, sizeof(me_query_topology_res));
+	int number = 0;
+	int i;
+
+	if (result)
+	{
+		result->error = meQueryNumberDevices(&number);
+		if (!result->error && number)
+		{
+			result->devices.devices_val = calloc(number, sizeof(me_topology_device_res));
+			if (result->devices.devices_val)
+			{
+				result->devices.devices_len = number;
+				for (i = 0; i < number; i++)
+				{
+					me_query_topology_device(i, &result->devices.devices_val[i]);
+				}
+			}
+			else
+			{
+				result->error = ME_ERRNO_INTERNAL;
+			}
+		}
+	}
+
+	return result;
+}
+
+
+me_batch_res * me_batch_proc_1_svc(me_batch_params *params, struct svc_req *dummy)
+{
+	me_batch_res* result = calloc(1, sizeof(me_batch_res));
+	me_batch_op* op;
+	me_batch_op_res* op_res;
+	void* res;
+	int i;
+
+	if (!result)
+	{
+		return NULL;
+	}
+
+	if (params->ops.ops_len)
+	{
+		result->results.results_val = calloc(params->ops.ops_len, sizeof(me_batch_op_res));
+		if (!result->results.results_val)
+		{
+			result->error = ME_ERRNO_INTERNAL;
+			return result;
+		}
+	}
+
+	/// Every operation runs through its own procedure. Results are moved into batch result.
+	for (i = 0; i < params->ops.ops_len; i++)
+	{
+		op = &params->ops.ops_val[i];
+		op_res = &result->results.results_val[i];
+		op_res->type = op->type;
+		result->results.results_len = i + 1;
+
+		switch (op->type)
+		{
+			case ME_BATCH_SINGLE_CONFIG:
+				res = me_io_single_config_proc_1_svc(&op->me_batch_op_u.single_config, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.single_config = *(int *)res;
+					result->error = op_res->me_batch_op_res_u.single_config;
+				}
+				break;
+
+			case ME_BATCH_SINGLE:
+				res = me_io_single_proc_1_svc(&op->me_batch_op_u.single, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.single = *(me_io_single_res *)res;
+					result->error = op_res->me_batch_op_res_u.single.error;
+				}
+				break;
+
+			case ME_BATCH_STREAM_CONFIG:
+				res = me_io_stream_config_proc_1_svc(&op->me_batch_op_u.stream_config, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.stream_config = *(int *)res;
+					result->error = op_res->me_batch_op_res_u.stream_config;
+				}
+				break;
+
+			case ME_BATCH_STREAM_NEW_VALUES:
+				res = me_io_stream_new_values_proc_1_svc(&op->me_batch_op_u.stream_new_values, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.stream_new_values = *(me_io_stream_new_values_res *)res;
+					result->error = op_res->me_batch_op_res_u.stream_new_values.error;
+				}
+				break;
+
+			case ME_BATCH_STREAM_READ:
+				res = me_io_stream_read_proc_1_svc(&op->me_batch_op_u.stream_read, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.stream_read = *(me_io_stream_read_res *)res;
+					result->error = op_res->me_batch_op_res_u.stream_read.error;
+				}
+				break;
+
+			case ME_BATCH_STREAM_WRITE:
+				res = me_io_stream_write_proc_1_svc(&op->me_batch_op_u.stream_write, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.stream_write = *(me_io_stream_write_res *)res;
+					result->error = op_res->me_batch_op_res_u.stream_write.error;
+				}
+				break;
+
+			case ME_BATCH_STREAM_START:
+				res = me_io_stream_start_proc_1_svc(&op->me_batch_op_u.stream_start, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.stream_start = *(me_io_stream_start_res *)res;
+					result->error = op_res->me_batch_op_res_u.stream_start.error;
+				}
+				break;
+
+			case ME_BATCH_STREAM_STOP:
+				res = me_io_stream_stop_proc_1_svc(&op->me_batch_op_u.stream_stop, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.stream_stop = *(me_io_stream_stop_res *)res;
+					result->error = op_res->me_batch_op_res_u.stream_stop.error;
+				}
+				break;
+
+			case ME_BATCH_STREAM_STATUS:
+				res = me_io_stream_status_proc_1_svc(&op->me_batch_op_u.stream_status, dummy);
+				if (res)
+				{
+					op_res->me_batch_op_res_u.stream_status = *(me_io_stream_status_res *)res;
+					result->error = op_res->me_batch_op_res_u.stream_status.error;
+				}
+				break;
+
+			default:
+				LIBPERROR("Invalid batch operation %d.\n", op->type);
+				res = NULL;
+		}
+
+		if (!res)
+		{
+			result->error = ME_ERRNO_INTERNAL;
+		}
+		free(res);
+
+		if (result->error)
+		{
+			LIBPDEBUG("Batch stopped at operation %d: %d\n", i, result->error);
+			break;
+		}
+	}
+
+	return result;
+}
+
+
+int * me_stream_encodings_proc_1_svc(int *encodings, struct svc_req *dummy)
+{
+	int* result = malloc(sizeof(int));
+
+	if (result)
+	{// Client's offer limited to known encodings.
+		*result = *encodings & ME_RPC_ENCODINGS;
+	}
+
+	return result;
+}
+
+
+me_io_stream_read_packed_res * me_io_stream_read_packed_proc_1_svc(me_io_stream_read_packed_params *params, struct svc_req *dummy)
+{
+	me_io_stream_read_packed_res* result = calloc(1, sizeof(me_io_stream_read_packed_res));
+	int* values;
+	int lenght;
+
+	if (result)
+	{
+		lenght = (params->count > 0) ? params->count : 0;
+		values = malloc(sizeof(int) * lenght + 1);
+		result->data.data_val = malloc(ME_RPC_ENCODED_SIZE(lenght) + 1);
+		if (values && result->data.data_val)
+		{
+			result->error = meIOStreamRead(
+								params->device,
+								params->subdevice,
+								params->read_mode,
+								values,
+								&lenght,
+								params->flags);
+			result->count = lenght;
+			result->encoding = StreamEncode_RPC(values, lenght, params->encodings & ME_RPC_ENCODINGS, result->data.data_val, &result->data.data_len);
+		}
+		else
+		{
+			result->error = ME_ERRNO_INTERNAL;
+		}
+
+		if (values)
+			free(values);
+	}
+
+	return result;
+}
+
+
+me_io_stream_write_res * me_io_stream_write_packed_proc_1_svc(me_io_stream_write_packed_params *params, struct svc_req *dummy)
+{
+	me_io_stream_write_res* result = malloc(sizeof(me_io_stream_write_res));
+	int* values;
+
+	if (result)
+	{
+		result->count = 0;
+		values = malloc(sizeof(int) * ((params->count > 0) ? params->count : 0) + 1);
+		if (!values)
+		{
+			result->error = ME_ERRNO_INTERNAL;
+		}
+		else
+		{
+			result->error = StreamDecode_RPC(params->data.data_val, params->data.data_len, params->encoding, values, params->count);
+			if (!result->error)
+			{
+				result->count = params->count;
+				result->error = meIOStreamWrite(
+									params->device,
+									params->subdevice,
+									params->write_mode,
+									values,
+									&result->count,
+									params->flags);
+			}
+			free(values);
+		}
+	}
+
+	return result;
+}
@@ -2725,3 +2725,886 @@ xdr_me_query_version_device_driver_res(XDR *xdrs, me_query_version_device_driver
 
 	return TRUE;
 }
+
+bool_t
+xdr_me_topology_timer_res(XDR *xdrs, me_topology_timer_res *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE)
+	{
+		buf = XDR_INLINE(xdrs, 6 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->error))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->base_frequency))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->min_ticks_low))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->min_ticks_high))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->max_ticks_low))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->max_ticks_high))
+				return FALSE;
+		}
+		else
+		{
+			IXDR_PUT_LONG(buf, objp->error);
+			IXDR_PUT_LONG(buf, objp->base_frequency);
+			IXDR_PUT_LONG(buf, objp->min_ticks_low);
+			IXDR_PUT_LONG(buf, objp->min_ticks_high);
+			IXDR_PUT_LONG(buf, objp->max_ticks_low);
+			IXDR_PUT_LONG(buf, objp->max_ticks_high);
+		}
+
+		return TRUE;
+	}
+	else if (xdrs->x_op == XDR_DECODE)
+	{
+		buf = XDR_INLINE(xdrs, 6 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->error))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->base_frequency))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->min_ticks_low))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->min_ticks_high))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->max_ticks_low))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->max_ticks_high))
+				return FALSE;
+		}
+		else
+		{
+			objp->error = IXDR_GET_LONG(buf);
+			objp->base_frequency = IXDR_GET_LONG(buf);
+			objp->min_ticks_low = IXDR_GET_LONG(buf);
+			objp->min_ticks_high = IXDR_GET_LONG(buf);
+			objp->max_ticks_low = IXDR_GET_LONG(buf);
+			objp->max_ticks_high = IXDR_GET_LONG(buf);
+		}
+
+		return TRUE;
+	}
+
+	if (!xdr_int(xdrs, &objp->error))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->base_frequency))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->min_ticks_low))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->min_ticks_high))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->max_ticks_low))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->max_ticks_high))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_topology_subdevice_res(XDR *xdrs, me_topology_subdevice_res *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE)
+	{
+		buf = XDR_INLINE(xdrs, 5 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->error))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->type))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subtype))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->channels))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->caps))
+				return FALSE;
+		}
+		else
+		{
+			IXDR_PUT_LONG(buf, objp->error);
+			IXDR_PUT_LONG(buf, objp->type);
+			IXDR_PUT_LONG(buf, objp->subtype);
+			IXDR_PUT_LONG(buf, objp->channels);
+			IXDR_PUT_LONG(buf, objp->caps);
+		}
+
+		if (!xdr_array(xdrs, (char **) &objp->timers.timers_val, (u_int *) &objp->timers.timers_len, ~0,
+		               sizeof(me_topology_timer_res), (xdrproc_t) xdr_me_topology_timer_res))
+			return FALSE;
+
+		if (!xdr_array(xdrs, (char **) &objp->ranges.ranges_val, (u_int *) &objp->ranges.ranges_len, ~0,
+		               sizeof(me_query_range_info_res), (xdrproc_t) xdr_me_query_range_info_res))
+			return FALSE;
+
+		return TRUE;
+	}
+	else if (xdrs->x_op == XDR_DECODE)
+	{
+		buf = XDR_INLINE(xdrs, 5 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->error))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->type))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subtype))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->channels))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->caps))
+				return FALSE;
+		}
+		else
+		{
+			objp->error = IXDR_GET_LONG(buf);
+			objp->type = IXDR_GET_LONG(buf);
+			objp->subtype = IXDR_GET_LONG(buf);
+			objp->channels = IXDR_GET_LONG(buf);
+			objp->caps = IXDR_GET_LONG(buf);
+		}
+
+		if (!xdr_array(xdrs, (char **) &objp->timers.timers_val, (u_int *) &objp->timers.timers_len, ~0,
+		               sizeof(me_topology_timer_res), (xdrproc_t) xdr_me_topology_timer_res))
+			return FALSE;
+
+		if (!xdr_array(xdrs, (char **) &objp->ranges.ranges_val, (u_int *) &objp->ranges.ranges_len, ~0,
+		               sizeof(me_query_range_info_res), (xdrproc_t) xdr_me_query_range_info_res))
+			return FALSE;
+
+		return TRUE;
+	}
+
+	if (!xdr_int(xdrs, &objp->error))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->type))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->subtype))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->channels))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->caps))
+		return FALSE;
+
+	if (!xdr_array(xdrs, (char **) &objp->timers.timers_val, (u_int *) &objp->timers.timers_len, ~0,
+	               sizeof(me_topology_timer_res), (xdrproc_t) xdr_me_topology_timer_res))
+		return FALSE;
+
+	if (!xdr_array(xdrs, (char **) &objp->ranges.ranges_val, (u_int *) &objp->ranges.ranges_len, ~0,
+	               sizeof(me_query_range_info_res), (xdrproc_t) xdr_me_query_range_info_res))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_topology_device_res(XDR *xdrs, me_topology_device_res *objp)
+{
+	if (!xdr_me_query_info_device_res(xdrs, &objp->info))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->driver_version))
+		return FALSE;
+
+	if (!xdr_string(xdrs, &objp->name, ~0))
+		return FALSE;
+
+	if (!xdr_string(xdrs, &objp->description, ~0))
+		return FALSE;
+
+	if (!xdr_string(xdrs, &objp->driver_name, ~0))
+		return FALSE;
+
+	if (!xdr_array(xdrs, (char **) &objp->subdevices.subdevices_val, (u_int *) &objp->subdevices.subdevices_len, ~0,
+	               sizeof(me_topology_subdevice_res), (xdrproc_t) xdr_me_topology_subdevice_res))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_query_topology_res(XDR *xdrs, me_query_topology_res *objp)
+{
+	if (!xdr_int(xdrs, &objp->error))
+		return FALSE;
+
+	if (!xdr_array(xdrs, (char **) &objp->devices.devices_val, (u_int *) &objp->devices.devices_len, ~0,
+	               sizeof(me_topology_device_res), (xdrproc_t) xdr_me_topology_device_res))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_batch_op_type(XDR *xdrs, me_batch_op_type *objp)
+{
+	if (!xdr_enum(xdrs, (enum_t *) objp))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_batch_op(XDR *xdrs, me_batch_op *objp)
+{
+	if (!xdr_me_batch_op_type(xdrs, &objp->type))
+		return FALSE;
+
+	switch (objp->type)
+	{
+		case ME_BATCH_SINGLE_CONFIG:
+			if (!xdr_me_io_single_config_params(xdrs, &objp->me_batch_op_u.single_config))
+				return FALSE;
+			break;
+
+		case ME_BATCH_SINGLE:
+			if (!xdr_me_io_single_params(xdrs, &objp->me_batch_op_u.single))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_CONFIG:
+			if (!xdr_me_io_stream_config_params(xdrs, &objp->me_batch_op_u.stream_config))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_NEW_VALUES:
+			if (!xdr_me_io_stream_new_values_params(xdrs, &objp->me_batch_op_u.stream_new_values))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_READ:
+			if (!xdr_me_io_stream_read_params(xdrs, &objp->me_batch_op_u.stream_read))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_WRITE:
+			if (!xdr_me_io_stream_write_params(xdrs, &objp->me_batch_op_u.stream_write))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_START:
+			if (!xdr_me_io_stream_start_params(xdrs, &objp->me_batch_op_u.stream_start))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_STOP:
+			if (!xdr_me_io_stream_stop_params(xdrs, &objp->me_batch_op_u.stream_stop))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_STATUS:
+			if (!xdr_me_io_stream_status_params(xdrs, &objp->me_batch_op_u.stream_status))
+				return FALSE;
+			break;
+
+		default:
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_batch_op_res(XDR *xdrs, me_batch_op_res *objp)
+{
+	if (!xdr_me_batch_op_type(xdrs, &objp->type))
+		return FALSE;
+
+	switch (objp->type)
+	{
+		case ME_BATCH_SINGLE_CONFIG:
+			if (!xdr_int(xdrs, &objp->me_batch_op_res_u.single_config))
+				return FALSE;
+			break;
+
+		case ME_BATCH_SINGLE:
+			if (!xdr_me_io_single_res(xdrs, &objp->me_batch_op_res_u.single))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_CONFIG:
+			if (!xdr_int(xdrs, &objp->me_batch_op_res_u.stream_config))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_NEW_VALUES:
+			if (!xdr_me_io_stream_new_values_res(xdrs, &objp->me_batch_op_res_u.stream_new_values))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_READ:
+			if (!xdr_me_io_stream_read_res(xdrs, &objp->me_batch_op_res_u.stream_read))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_WRITE:
+			if (!xdr_me_io_stream_write_res(xdrs, &objp->me_batch_op_res_u.stream_write))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_START:
+			if (!xdr_me_io_stream_start_res(xdrs, &objp->me_batch_op_res_u.stream_start))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_STOP:
+			if (!xdr_me_io_stream_stop_res(xdrs, &objp->me_batch_op_res_u.stream_stop))
+				return FALSE;
+			break;
+
+		case ME_BATCH_STREAM_STATUS:
+			if (!xdr_me_io_stream_status_res(xdrs, &objp->me_batch_op_res_u.stream_status))
+				return FALSE;
+			break;
+
+		default:
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_batch_params(XDR *xdrs, me_batch_params *objp)
+{
+	if (!xdr_array(xdrs, (char **) &objp->ops.ops_val, (u_int *) &objp->ops.ops_len, ~0,
+	               sizeof(me_batch_op), (xdrproc_t) xdr_me_batch_op))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->flags))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_batch_res(XDR *xdrs, me_batch_res *objp)
+{
+	if (!xdr_int(xdrs, &objp->error))
+		return FALSE;
+
+	if (!xdr_array(xdrs, (char **) &objp->results.results_val, (u_int *) &objp->results.results_len, ~0,
+	               sizeof(me_batch_op_res), (xdrproc_t) xdr_me_batch_op_res))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_io_stream_read_packed_params(XDR *xdrs, me_io_stream_read_packed_params *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE)
+	{
+		buf = XDR_INLINE(xdrs, 6 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->device))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subdevice))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->read_mode))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->count))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->encodings))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->flags))
+				return FALSE;
+		}
+		else
+		{
+			IXDR_PUT_LONG(buf, objp->device);
+			IXDR_PUT_LONG(buf, objp->subdevice);
+			IXDR_PUT_LONG(buf, objp->read_mode);
+			IXDR_PUT_LONG(buf, objp->count);
+			IXDR_PUT_LONG(buf, objp->encodings);
+			IXDR_PUT_LONG(buf, objp->flags);
+		}
+
+		return TRUE;
+	}
+	else if (xdrs->x_op == XDR_DECODE)
+	{
+		buf = XDR_INLINE(xdrs, 6 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->device))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subdevice))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->read_mode))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->count))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->encodings))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->flags))
+				return FALSE;
+		}
+		else
+		{
+			objp->device = IXDR_GET_LONG(buf);
+			objp->subdevice = IXDR_GET_LONG(buf);
+			objp->read_mode = IXDR_GET_LONG(buf);
+			objp->count = IXDR_GET_LONG(buf);
+			objp->encodings = IXDR_GET_LONG(buf);
+			objp->flags = IXDR_GET_LONG(buf);
+		}
+
+		return TRUE;
+	}
+
+	if (!xdr_int(xdrs, &objp->device))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->subdevice))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->read_mode))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->count))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->encodings))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->flags))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_io_stream_read_packed_res(XDR *xdrs, me_io_stream_read_packed_res *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE)
+	{
+		buf = XDR_INLINE(xdrs, 3 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->error))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->count))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->encoding))
+				return FALSE;
+		}
+		else
+		{
+			IXDR_PUT_LONG(buf, objp->error);
+			IXDR_PUT_LONG(buf, objp->count);
+			IXDR_PUT_LONG(buf, objp->encoding);
+		}
+
+		if (!xdr_bytes(xdrs, (char **) &objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+			return FALSE;
+
+		return TRUE;
+	}
+	else if (xdrs->x_op == XDR_DECODE)
+	{
+		buf = XDR_INLINE(xdrs, 3 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->error))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->count))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->encoding))
+				return FALSE;
+		}
+		else
+		{
+			objp->error = IXDR_GET_LONG(buf);
+			objp->count = IXDR_GET_LONG(buf);
+			objp->encoding = IXDR_GET_LONG(buf);
+		}
+
+		if (!xdr_bytes(xdrs, (char **) &objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+			return FALSE;
+
+		return TRUE;
+	}
+
+	if (!xdr_int(xdrs, &objp->error))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->count))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->encoding))
+		return FALSE;
+
+	if (!xdr_bytes(xdrs, (char **) &objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_io_stream_write_packed_params(XDR *xdrs, me_io_stream_write_packed_params *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE)
+	{
+		buf = XDR_INLINE(xdrs, 5 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->device))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subdevice))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->write_mode))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->count))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->encoding))
+				return FALSE;
+		}
+		else
+		{
+			IXDR_PUT_LONG(buf, objp->device);
+			IXDR_PUT_LONG(buf, objp->subdevice);
+			IXDR_PUT_LONG(buf, objp->write_mode);
+			IXDR_PUT_LONG(buf, objp->count);
+			IXDR_PUT_LONG(buf, objp->encoding);
+		}
+
+		if (!xdr_bytes(xdrs, (char **) &objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+			return FALSE;
+
+		if (!xdr_int(xdrs, &objp->flags))
+			return FALSE;
+
+		return TRUE;
+	}
+	else if (xdrs->x_op == XDR_DECODE)
+	{
+		buf = XDR_INLINE(xdrs, 5 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->device))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subdevice))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->write_mode))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->count))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->encoding))
+				return FALSE;
+		}
+		else
+		{
+			objp->device = IXDR_GET_LONG(buf);
+			objp->subdevice = IXDR_GET_LONG(buf);
+			objp->write_mode = IXDR_GET_LONG(buf);
+			objp->count = IXDR_GET_LONG(buf);
+			objp->encoding = IXDR_GET_LONG(buf);
+		}
+
+		if (!xdr_bytes(xdrs, (char **) &objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+			return FALSE;
+
+		if (!xdr_int(xdrs, &objp->flags))
+			return FALSE;
+
+		return TRUE;
+	}
+
+	if (!xdr_int(xdrs, &objp->device))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->subdevice))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->write_mode))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->count))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->encoding))
+		return FALSE;
+
+	if (!xdr_bytes(xdrs, (char **) &objp->data.data_val, (u_int *) &objp->data.data_len, ~0))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->flags))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_event_type(XDR *xdrs, me_event_type *objp)
+{
+	if (!xdr_enum(xdrs, (enum_t *) objp))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_event_subscribe(XDR *xdrs, me_event_subscribe *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE)
+	{
+		if (!xdr_me_event_type(xdrs, &objp->type))
+			return FALSE;
+
+		buf = XDR_INLINE(xdrs, 4 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->device))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subdevice))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subscribe))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->flags))
+				return FALSE;
+		}
+		else
+		{
+			IXDR_PUT_LONG(buf, objp->device);
+			IXDR_PUT_LONG(buf, objp->subdevice);
+			IXDR_PUT_LONG(buf, objp->subscribe);
+			IXDR_PUT_LONG(buf, objp->flags);
+		}
+
+		return TRUE;
+	}
+	else if (xdrs->x_op == XDR_DECODE)
+	{
+		if (!xdr_me_event_type(xdrs, &objp->type))
+			return FALSE;
+
+		buf = XDR_INLINE(xdrs, 4 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->device))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subdevice))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subscribe))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->flags))
+				return FALSE;
+		}
+		else
+		{
+			objp->device = IXDR_GET_LONG(buf);
+			objp->subdevice = IXDR_GET_LONG(buf);
+			objp->subscribe = IXDR_GET_LONG(buf);
+			objp->flags = IXDR_GET_LONG(buf);
+		}
+
+		return TRUE;
+	}
+
+	if (!xdr_me_event_type(xdrs, &objp->type))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->device))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->subdevice))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->subscribe))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->flags))
+		return FALSE;
+
+	return TRUE;
+}
+
+bool_t
+xdr_me_event(XDR *xdrs, me_event *objp)
+{
+	register int32_t *buf;
+
+
+	if (xdrs->x_op == XDR_ENCODE)
+	{
+		if (!xdr_me_event_type(xdrs, &objp->type))
+			return FALSE;
+
+		buf = XDR_INLINE(xdrs, 5 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->device))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subdevice))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->count))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->value))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->error))
+				return FALSE;
+		}
+		else
+		{
+			IXDR_PUT_LONG(buf, objp->device);
+			IXDR_PUT_LONG(buf, objp->subdevice);
+			IXDR_PUT_LONG(buf, objp->count);
+			IXDR_PUT_LONG(buf, objp->value);
+			IXDR_PUT_LONG(buf, objp->error);
+		}
+
+		return TRUE;
+	}
+	else if (xdrs->x_op == XDR_DECODE)
+	{
+		if (!xdr_me_event_type(xdrs, &objp->type))
+			return FALSE;
+
+		buf = XDR_INLINE(xdrs, 5 * BYTES_PER_XDR_UNIT);
+
+		if (buf == NULL)
+		{
+			if (!xdr_int(xdrs, &objp->device))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->subdevice))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->count))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->value))
+				return FALSE;
+
+			if (!xdr_int(xdrs, &objp->error))
+				return FALSE;
+		}
+		else
+		{
+			objp->device = IXDR_GET_LONG(buf);
+			objp->subdevice = IXDR_GET_LONG(buf);
+			objp->count = IXDR_GET_LONG(buf);
+			objp->value = IXDR_GET_LONG(buf);
+			objp->error = IXDR_GET_LONG(buf);
+		}
+
+		return TRUE;
+	}
+
+	if (!xdr_me_event_type(xdrs, &objp->type))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->device))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->subdevice))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->count))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->value))
+		return FALSE;
+
+	if (!xdr_int(xdrs, &objp->error))
+		return FALSE;
+
+	return TRUE;
+}
@@ -48,6 +48,11 @@
 
 #include "me0600_device.h"
 
+// Tracepoints of this module (me_trace.h).
+#define ME_TRACE_SYSTEM me0600
+#define CREATE_TRACE_POINTS
+#include "me_trace.h"
+
 # define ME_MODULE_NAME			ME0600_NAME
 # define ME_MODULE_VERSION		ME0600_VERSION
 
@@ -260,7 +265,7 @@ static irqreturn_t me0600_isr(int irq, void* context
 	{//Interrupt line 1
 		PINFO("IRQ line A.\n");
 		instance = irq_context->subdevice[0];
-		if(!instance->me_subdevice_irq_handle(instance, status))
+		if(!me_subdevice_irq_dispatch(instance, status))
 			ret = IRQ_HANDLED;
 	}
 
@@ -268,7 +273,7 @@ static irqreturn_t me0600_isr(int irq, void* context
 	{//Interrupt line 2
 		PINFO("IRQ line B.\n");
 		instance = irq_context->subdevice[1];
-			if(!instance->me_subdevice_irq_handle(instance, status))
+			if(!me_subdevice_irq_dispatch(instance, status))
 				ret = IRQ_HANDLED;
 	}
 
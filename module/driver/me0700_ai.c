@@ -76,6 +76,7 @@ static int me0700_ai_io_stream_start(me_subdevice_t* subdevice, struct file* fil
 static int me0700_ai_io_stream_stop(me_subdevice_t* subdevice, struct file* filep, int stop_mode, int time_out, int flags);
 static int me0700_ai_io_stream_status(me_subdevice_t* subdevice, struct file* filep, int wait, int* status, int* values, int flags);
 static int me0700_ai_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep, int time_out, int* count, int flags);
+static int me0700_ai_io_stream_reader(me_subdevice_t* subdevice, struct file* filep, int mode, int policy, int* dropped, int flags);
 
 static int me0700_ai_query_range_by_min_max(me_subdevice_t* subdevice, int unit, int* min, int* max, int* maxdata, int* range);
 static int me0700_ai_query_number_ranges(me_subdevice_t* subdevice, int unit, int* count);
@@ -437,6 +438,15 @@ static int me0700_ai_io_stream_new_values(me_subdevice_t* subdevice, struct file
 	return instance->ai_instance->base.me_subdevice_io_stream_new_values((struct me_subdevice* )instance->ai_instance, filep, time_out, count, flags);
 }
 
+static int me0700_ai_io_stream_reader(me_subdevice_t* subdevice, struct file* filep, int mode, int policy, int* dropped, int flags)
+{
+	me0700_ai_subdevice_t* instance = (me0700_ai_subdevice_t *) subdevice;
+
+	PDEBUG("executed. idx=0\n");
+
+	return instance->ai_instance->base.me_subdevice_io_stream_reader((struct me_subdevice* )instance->ai_instance, filep, mode, policy, dropped, flags);
+}
+
 static int me0700_ai_io_stream_config_check(me0700_ai_subdevice_t* instance, meIOStreamSimpleConfig_t* config_list, int count, int flags)
 {
 	int i;
@@ -1034,6 +1044,7 @@ me0700_ai_subdevice_t* me0700_ai_constr(void* reg_base,
 	subdevice->base.me_subdevice_io_stream_start = me0700_ai_io_stream_start;
 	subdevice->base.me_subdevice_io_stream_status = me0700_ai_io_stream_status;
 	subdevice->base.me_subdevice_io_stream_stop = me0700_ai_io_stream_stop;
+	subdevice->base.me_subdevice_io_stream_reader = me0700_ai_io_stream_reader;
 	subdevice->base.me_subdevice_io_irq_start = me0700_ai_io_irq_start;
 	subdevice->base.me_subdevice_io_irq_wait = me0700_ai_io_irq_wait;
 	subdevice->base.me_subdevice_io_irq_stop = me0700_ai_io_irq_stop;
@@ -51,6 +51,11 @@
 
 # include "me0700_device.h"
 
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM me0700
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
 # define ME_MODULE_NAME		ME0700_NAME
 # define ME_MODULE_VERSION	ME0700_VERSION
 # define RESERVED_DIO_PORTS	2
@@ -439,7 +444,7 @@ static irqreturn_t me0700_isr(int irq, void* context
 		{
 			PINFO("Interrupt for AI_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
@@ -452,7 +457,7 @@ static irqreturn_t me0700_isr(int irq, void* context
 		{
 			PINFO("Interrupt for AO_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
@@ -46,6 +46,11 @@
 #include "me0900_do.h"
 #include "me0900_di.h"
 
+// Tracepoints of this module (me_trace.h).
+#define ME_TRACE_SYSTEM me0900
+#define CREATE_TRACE_POINTS
+#include "me_trace.h"
+
 # define ME_MODULE_NAME		ME0900_NAME
 # define ME_MODULE_VERSION	ME0900_VERSION
 
@@ -52,6 +52,11 @@
 
 #include "me1000_device.h"
 
+// Tracepoints of this module (me_trace.h).
+#define ME_TRACE_SYSTEM me1000
+#define CREATE_TRACE_POINTS
+#include "me_trace.h"
+
 # define ME_MODULE_NAME		ME1000_NAME
 # define ME_MODULE_VERSION	ME1000_VERSION
 
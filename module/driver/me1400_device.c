@@ -50,6 +50,11 @@
 
 #include "me1400_device.h"
 
+// Tracepoints of this module (me_trace.h).
+#define ME_TRACE_SYSTEM me1400
+#define CREATE_TRACE_POINTS
+#include "me_trace.h"
+
 # define ME_MODULE_NAME		ME1400_NAME
 # define ME_MODULE_VERSION	ME1400_VERSION
 
@@ -370,14 +375,14 @@ static irqreturn_t me1400_isr(int irq, void* context
 	{//Interrupt line (first line available)
 		PINFO("IRQ line A.\n");
 		instance = irq_context->subdevice[0];
-		if(!instance->me_subdevice_irq_handle(instance, status))
+		if(!me_subdevice_irq_dispatch(instance, status))
 			ret = IRQ_HANDLED;
 	}
 	if ((status & (PLX9052_INTCSR_LOCAL_INT2_STATE | PLX9052_INTCSR_LOCAL_INT2_EN)) == (PLX9052_INTCSR_LOCAL_INT2_STATE | PLX9052_INTCSR_LOCAL_INT2_EN))
 	{//Interrupt line (second line available)
 		PINFO("IRQ line B.\n");
 		instance = irq_context->subdevice[1];
-		if(!instance->me_subdevice_irq_handle(instance, status))
+		if(!me_subdevice_irq_dispatch(instance, status))
 			ret = IRQ_HANDLED;
 	}
 
@@ -865,6 +865,8 @@ static void me1600_ao_work_control_task(
 		return;
 	}
 
+	trace_me_control_task(instance, instance->base.idx, instance->status);
+
 	if (signal_pending(current))
 	{
 		PERROR("Control task interrupted.\n");
@@ -46,6 +46,11 @@
 
 #include "me1600_device.h"
 
+// Tracepoints of this module (me_trace.h).
+#define ME_TRACE_SYSTEM me1600
+#define CREATE_TRACE_POINTS
+#include "me_trace.h"
+
 # define ME_MODULE_NAME		ME1600_NAME
 # define ME_MODULE_VERSION	ME1600_VERSION
 
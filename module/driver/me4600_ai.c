@@ -82,10 +82,12 @@ int me4600_ai_io_stream_read(me_subdevice_t* subdevice, struct file* filep, int
 int me4600_ai_io_stream_start(me_subdevice_t* subdevice, struct file* filep, int start_mode, int time_out, int flags);
 int me4600_ai_io_stream_stop(me_subdevice_t* subdevice, struct file* filep, int stop_mode, int time_out, int flags);
 int me4600_ai_io_stream_status(me_subdevice_t* subdevice, struct file* filep, int wait, int* status, int* values, int flags);
+int me4600_ai_io_stream_reader(me_subdevice_t* subdevice, struct file* filep, int mode, int policy, int* dropped, int flags);
 
 static int me4600_ai_FSM_test(me4600_ai_subdevice_t* instance);
 int me4600_ai_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep, int time_out, int* count, int flags);
-static int inline me4600_ai_io_stream_read_get_value(me4600_ai_subdevice_t* instance, int* values, const int count, const int flags);
+static int inline me4600_ai_io_stream_read_get_value(me4600_ai_subdevice_t* instance, struct file* filep, me_seg_buf_t* buf, me_seg_buf_reader_t* reader, int* values, const int count, const int flags);
+static unsigned int inline me4600_ai_stream_values(me4600_ai_subdevice_t* instance, struct file* filep);
 
 int me4600_ai_query_range_by_min_max(me_subdevice_t* subdevice, int unit, int* min, int* max, int* maxdata, int* range);
 int me4600_ai_query_number_ranges(me_subdevice_t* subdevice, int unit, int* count);
@@ -258,6 +260,7 @@ int me4600_ai_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep,
 			me_writel(instance->base.dev, 0xEFFFFFFF, instance->sample_counter_reg);
 
 			me_seg_buf_reset(instance->seg_buf);
+			me_seg_buf_set_mode(instance->seg_buf, 0, 0);
 			instance->ISM.next = 0;
 
 			instance->fifo_irq_threshold = 0;
@@ -622,6 +625,7 @@ int me4600_ai_io_single_read(me_subdevice_t* subdevice, struct file* filep, int
 
 			// Mark that StreamConfig is removed.
 			instance->chan_list_len = 0;
+			me_seg_buf_set_mode(instance->seg_buf, 0, 0);
 			if (instance->chan_list_copy)
 			{
 				memset(instance->chan_list_copy, 0, instance->LE_size * sizeof(uint16_t));
@@ -743,9 +747,15 @@ static int me4600_ai_io_stream_config_check(me4600_ai_subdevice_t* instance, meI
 	int i;
 	int err = ME_ERRNO_SUCCESS;
 
-	if (flags & ~(ME_IO_STREAM_CONFIG_SAMPLE_AND_HOLD | ME_STREAM_CONFIG_DIFFERENTIAL))
+	if (flags & ~(ME_IO_STREAM_CONFIG_SAMPLE_AND_HOLD | ME_STREAM_CONFIG_DIFFERENTIAL | ME_IO_STREAM_CONFIG_FLIGHT_RECORDER))
 	{
-		PERROR("Invalid flags. Should be ME_IO_STREAM_CONFIG_NO_FLAGS, ME_STREAM_CONFIG_DIFFERENTIAL or ME_IO_STREAM_CONFIG_SAMPLE_AND_HOLD.\n");
+		PERROR("Invalid flags. Should be ME_IO_STREAM_CONFIG_NO_FLAGS, ME_STREAM_CONFIG_DIFFERENTIAL, ME_IO_STREAM_CONFIG_SAMPLE_AND_HOLD or ME_IO_STREAM_CONFIG_FLIGHT_RECORDER.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((flags & ME_IO_STREAM_CONFIG_FLIGHT_RECORDER) && (me_seg_buf_size(instance->seg_buf) < 2 * count))
+	{// Ring overwrites whole frames. Buffer must keep at least one frame beside the dropped one.
+		PERROR("Buffer too small for flight recorder mode. Must hold 2 channel lists (%d values).\n", 2 * count);
 		return ME_ERRNO_INVALID_FLAGS;
 	}
 
@@ -1247,6 +1257,8 @@ int me4600_ai_io_stream_config(me_subdevice_t* subdevice, struct file* filep,
 			//Set the global parameters end exit.
 			instance->chan_list_len = count;
 			instance->fifo_irq_threshold = fifo_irq_threshold;
+			// Frames are dropped only as whole channel lists.
+			me_seg_buf_set_mode(instance->seg_buf, count, (flags & ME_IO_STREAM_CONFIG_FLIGHT_RECORDER) ? 1 : 0);
 
 
 			switch (trigger->stop_type)
@@ -1368,7 +1380,7 @@ int me4600_ai_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep
 				wait_event_interruptible_timeout(
 					instance->wait_queue,
 					(
-						me_seg_buf_values(instance->seg_buf)
+						me4600_ai_stream_values(instance, filep)
 						||
 						(status != instance->status)
 					),
@@ -1401,7 +1413,7 @@ int me4600_ai_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep
 				err = ME_ERRNO_TIMEOUT;
 			}
 
-			if ((writes_count != instance->seg_buf->header.writes_count) || (!flags && me_seg_buf_values(instance->seg_buf)))
+			if ((writes_count != instance->seg_buf->header.writes_count) || (!flags && me4600_ai_stream_values(instance, filep)))
 			{// New data in buffer.
 				break;
 			}
@@ -1414,7 +1426,7 @@ int me4600_ai_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep
 			delay -= jiffies - j;
 		}
 
-		*count = me_seg_buf_values(instance->seg_buf);
+		*count = me4600_ai_stream_values(instance, filep);
 ERROR:
 	ME_SUBDEVICE_EXIT;
 
@@ -1422,15 +1434,48 @@ ERROR:
 	return err;
 }
 
-static int inline me4600_ai_io_stream_read_get_value(me4600_ai_subdevice_t* instance, int* values, const int count, const int flags)
+/// Values waiting for file handle. Attached readers have own cursor.
+/// Close detaches readers and config_load replaces buffer, both under protector lock. So reader is looked up under it too.
+static unsigned int inline me4600_ai_stream_values(me4600_ai_subdevice_t* instance, struct file* filep)
 {
+	me_seg_buf_reader_t* reader;
 	unsigned int n;
+
+	ME_LOCK_PROTECTOR;
+		reader = me_seg_buf_reader_find(instance->seg_buf, filep);
+		n = (reader) ? me_seg_buf_reader_values(instance->seg_buf, reader) : me_seg_buf_values(instance->seg_buf);
+	ME_UNLOCK_PROTECTOR;
+
+	return n;
+}
+
+/// Buffer and reader found by read are still in use. Call under protector lock.
+static int inline me4600_ai_stream_cursor_valid(me4600_ai_subdevice_t* instance, struct file* filep, me_seg_buf_t* buf, me_seg_buf_reader_t* reader)
+{
+	if (instance->seg_buf != buf)
+		return 0;
+
+	return !reader || ((reader->owner == filep) && !reader->detached);
+}
+
+static int inline me4600_ai_io_stream_read_get_value(me4600_ai_subdevice_t* instance, struct file* filep, me_seg_buf_t* buf, me_seg_buf_reader_t* reader, int* values, const int count, const int flags)
+{
+	unsigned int n = 0;
+	unsigned int left = 0;
 	int i;
 	uint16_t tmp;
 	int value;
+	unsigned int gap = 0;
+	int valid;
+	int err = ME_ERRNO_SUCCESS;
 
 	///Checking how many datas can be copied.
-	n = me_seg_buf_values(instance->seg_buf);
+	ME_LOCK_PROTECTOR;
+		if (me4600_ai_stream_cursor_valid(instance, filep, buf, reader))
+		{
+			n = (reader) ? me_seg_buf_reader_values(buf, reader) : me_seg_buf_values(buf);
+		}
+	ME_UNLOCK_PROTECTOR;
 	if (n <= 0)
 		return 0;
 
@@ -1447,8 +1492,64 @@ static int inline me4600_ai_io_stream_read_get_value(me4600_ai_subdevice_t* inst
 	for (i=0; i<n; i++)
 	{
 		ME_LOCK_PROTECTOR;
-			me_seg_buf_get(instance->seg_buf, &tmp);
+			// Buffer can be replaced (config_load) and reader detached (close, producer) between values.
+			valid = me4600_ai_stream_cursor_valid(instance, filep, buf, reader);
+			if (!valid)
+			{
+				gap = 0;
+			}
+			else if ((gap = me_seg_buf_gap(buf, reader)))
+			{// Values before and after gap are never returned together.
+				if (!i && (count >= ME_IO_STREAM_READ_GAP_RECORD_SIZE))
+				{
+					me_seg_buf_gap_clear(buf, reader);
+				}
+			}
+			else if (reader)
+			{// Producer can take values away from dropping reader.
+				err = me_seg_buf_reader_get(buf, reader, &tmp);
+			}
+			else
+			{
+				me_seg_buf_get(buf, &tmp);
+			}
+			if (valid)
+			{
+				left = me_seg_buf_values(buf);
+			}
 		ME_UNLOCK_PROTECTOR;
+		if (!valid)
+		{
+			n = i;
+			break;
+		}
+		if (gap)
+		{
+			if (i)
+			{
+				n = i;
+				break;
+			}
+
+			if (count < ME_IO_STREAM_READ_GAP_RECORD_SIZE)
+			{
+				PERROR("Gap record needs place for %d values.\n", ME_IO_STREAM_READ_GAP_RECORD_SIZE);
+				return -ME_ERRNO_INVALID_VALUE_COUNT;
+			}
+
+			PDEBUG("Gap record: %u values lost.\n", gap);
+			if (put_user(ME_IO_STREAM_READ_GAP_MARKER, values) || put_user((int)gap, values + 1))
+			{
+				PERROR("Cannot copy gap record to user.\n");
+				return -ME_ERRNO_INTERNAL;
+			}
+			return ME_IO_STREAM_READ_GAP_RECORD_SIZE;
+		}
+		if (err)
+		{
+			n = i;
+			break;
+		}
 		value = tmp;
 		if(put_user(value, values + i))
 		{
@@ -1456,6 +1557,7 @@ static int inline me4600_ai_io_stream_read_get_value(me4600_ai_subdevice_t* inst
 			return -ME_ERRNO_INTERNAL;
 		}
 	}
+	trace_me_seg_buf_get(instance, instance->base.idx, n, left);
 	return n;
 }
 
@@ -1495,6 +1597,10 @@ int me4600_ai_io_stream_read(me_subdevice_t* subdevice, struct file* filep, int
 	uint32_t tmp;
 	unsigned long int delay = LONG_MAX - 2;
 	unsigned long int j;
+	uint64_t stall;
+	me_seg_buf_t* buf;
+	me_seg_buf_reader_t* reader;
+	int detached;
 	int err = ME_ERRNO_SUCCESS;
 
 	int c = *count;
@@ -1567,13 +1673,15 @@ int me4600_ai_io_stream_read(me_subdevice_t* subdevice, struct file* filep, int
 		if ((tmp & ME4600_AI_STATUS_BIT_FSM))
 		{//Working
 			//If blocking mode -> wait for data.
-			if ((me_seg_buf_values(instance->seg_buf) < min) && (read_mode == ME_READ_MODE_BLOCKING))
+			if ((me4600_ai_stream_values(instance, filep) < min) && (read_mode == ME_READ_MODE_BLOCKING))
 			{
 				j = jiffies;
+				stall = me_subdevice_stats_time(&instance->base);
 				wait_event_interruptible_timeout(
 					instance->wait_queue,
-					((me_seg_buf_values(instance->seg_buf) >= min) || !(me4600_ai_FSM_test(instance) & ME4600_AI_STATUS_BIT_FSM)),
+					((me4600_ai_stream_values(instance, filep) >= min) || !(me4600_ai_FSM_test(instance) & ME4600_AI_STATUS_BIT_FSM)),
 					delay);
+				me_subdevice_stats_stall(&instance->base, stall);
 
 				if (signal_pending(current))
 				{
@@ -1589,7 +1697,20 @@ int me4600_ai_io_stream_read(me_subdevice_t* subdevice, struct file* filep, int
 			}
 		}
 
-		ret = me4600_ai_io_stream_read_get_value(instance, values, c, flags);
+		ME_LOCK_PROTECTOR;
+			buf = instance->seg_buf;
+			reader = me_seg_buf_reader_find(buf, filep);
+			detached = (reader) ? reader->detached : ME_ERRNO_SUCCESS;
+		ME_UNLOCK_PROTECTOR;
+		if (detached)
+		{
+			PERROR("Reader is detached. Error %d.\n", detached);
+			err = detached;
+			*count = 0;
+			goto ERROR;
+		}
+
+		ret = me4600_ai_io_stream_read_get_value(instance, filep, buf, reader, values, c, flags);
 		if (ret < 0)
 		{
 			err = -ret;
@@ -2072,14 +2193,79 @@ int me4600_ai_io_stream_status(me_subdevice_t* subdevice, struct file* filep, in
 			case ME_WAIT_IDLE:
 			case ME_WAIT_BUSY:
 			default:
-				*values = me_seg_buf_values(instance->seg_buf);
-				PDEBUG("me_seg_buf_values(instance->seg_buf)=%d.\n", *values);
+				*values = me4600_ai_stream_values(instance, filep);
+				PDEBUG("me4600_ai_stream_values(instance, filep)=%d.\n", *values);
 		}
 	ME_SUBDEVICE_EXIT;
 
 	return err;
 }
 
+int me4600_ai_io_stream_reader(me_subdevice_t* subdevice, struct file* filep, int mode, int policy, int* dropped, int flags)
+{
+	me4600_ai_subdevice_t* instance;
+	me_seg_buf_reader_t* reader;
+	int err = ME_ERRNO_SUCCESS;
+
+	PDEBUG("executed. idx=0\n");
+
+	instance = (me4600_ai_subdevice_t *) subdevice;
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_STREAM_READER_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	*dropped = 0;
+
+	switch (mode)
+	{
+		case ME_IO_STREAM_READER_ATTACH:
+			switch (policy)
+			{
+				case ME_IO_STREAM_READER_POLICY_BLOCK:
+				case ME_IO_STREAM_READER_POLICY_DROP:
+				case ME_IO_STREAM_READER_POLICY_DETACH:
+					break;
+
+				default:
+					PERROR("Invalid policy specified.\n");
+					return ME_ERRNO_VALUE_OUT_OF_RANGE;
+			}
+
+			ME_SUBDEVICE_ENTER;
+				ME_LOCK_PROTECTOR;
+					err = me_seg_buf_reader_attach(instance->seg_buf, filep, policy);
+				ME_UNLOCK_PROTECTOR;
+			ME_SUBDEVICE_EXIT;
+			break;
+
+		case ME_IO_STREAM_READER_DETACH:
+			// Called also on close. Subdevice can be locked by other process, so no entering here.
+			ME_LOCK_PROTECTOR;
+				reader = me_seg_buf_reader_find(instance->seg_buf, filep);
+				if (reader)
+				{
+					*dropped = me_seg_buf_reader_detach(instance->seg_buf, reader);
+				}
+			ME_UNLOCK_PROTECTOR;
+
+			if (!reader)
+			{
+				PDEBUG("File handle is not attached as reader.\n");
+				err = ME_ERRNO_PREVIOUS_CONFIG;
+			}
+			break;
+
+		default:
+			PERROR("Invalid mode specified.\n");
+			return ME_ERRNO_INVALID_READ_MODE;
+	}
+
+	return err;
+}
+
 int me4600_ai_io_stream_stop(me_subdevice_t* subdevice, struct file* filep, int stop_mode, int time_out, int flags)
 {
 /**
@@ -2670,6 +2856,7 @@ static int me4600_ai_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 	me4600_ai_subdevice_t* instance = (me4600_ai_subdevice_t *)subdevice;
 	int err = ME_ERRNO_SUCCESS;
 	int signal_irq = 0;
+	uint64_t isr_start = me_subdevice_stats_time(subdevice);
 
 #ifdef MEDEBUG_SPEED_TEST
 	uint64_t execuction_time;
@@ -2795,6 +2982,7 @@ static int me4600_ai_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 			if (tmp_status & ME4600_IRQ_STATUS_BIT_AI_OF)
 			{
 				int needed_values;
+				me_subdevice_stats_overflow(&instance->base);
 				instance->stream_stop_count++;
 				//Signal it.
 				signal_irq = 1;
@@ -2859,6 +3047,11 @@ END:
 ERROR:
 	ME_FREE_HANDLER_PROTECTOR;
 
+	if (!err)
+	{// Shared interrupts are not counted.
+		me_subdevice_stats_isr(&instance->base, isr_start);
+	}
+
 	if (signal_irq)
 	{
 		//Signal it.
@@ -2914,6 +3107,10 @@ static int inline ai_read_data(me4600_ai_subdevice_t* instance, const int count)
 	}
 
 	empty_space = me_seg_buf_space(instance->seg_buf);
+	if (empty_space < count)
+	{
+		me_subdevice_stats_overflow(&instance->base);
+	}
 	if (empty_space <= 0)
 	{
 		PERROR("Circular buffer full.\n");
@@ -2921,6 +3118,8 @@ static int inline ai_read_data(me4600_ai_subdevice_t* instance, const int count)
 	}
 
 	local_count = (count < empty_space) ? count : empty_space;
+	// Space is checked above. Readers make place for whole batch at once.
+	(void)me_seg_buf_reserve(instance->seg_buf, local_count);
 
 	buffer = (uint32_t *)kzalloc(local_count * sizeof(uint32_t), GFP_KERNEL);
 	if (!buffer)
@@ -2952,6 +3151,9 @@ static int inline ai_read_data(me4600_ai_subdevice_t* instance, const int count)
 		instance->chan_list_copy_pos %= instance->chan_list_len;
 	}
 
+	me_subdevice_stats_samples(&instance->base, local_count, me_seg_buf_values(instance->seg_buf));
+	trace_me_seg_buf_put(instance, instance->base.idx, local_count, me_seg_buf_values(instance->seg_buf));
+
 	PINFO("FAST: DOWNLOADED %d values\n", local_count);
 	kfree(buffer);
 	return local_count;
@@ -2972,12 +3174,18 @@ static int inline ai_read_data(me4600_ai_subdevice_t* instance, const int count)
 	}
 
 	empty_space = me_seg_buf_space(instance->seg_buf);
+	if (empty_space < count)
+	{
+		me_subdevice_stats_overflow(&instance->base);
+	}
 	if (empty_space == 0)
 	{
 		PDEBUG("Segmented buffer full.\n");
 		return -ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
 	}
 	local_count = (count < empty_space) ? count : empty_space;
+	// Space is checked above. Readers make place for whole batch at once.
+	(void)me_seg_buf_reserve(instance->seg_buf, local_count);
 
 	for (copied = 0; copied < local_count; ++copied)
 	{
@@ -2994,6 +3202,9 @@ static int inline ai_read_data(me4600_ai_subdevice_t* instance, const int count)
 		instance->chan_list_copy_pos %= instance->chan_list_len;
 	}
 
+	me_subdevice_stats_samples(&instance->base, copied, me_seg_buf_values(instance->seg_buf));
+	trace_me_seg_buf_put(instance, instance->base.idx, copied, me_seg_buf_values(instance->seg_buf));
+
 	PINFO("FAST: DOWNLOADED %d values.\n", copied);
 	return copied;
 }
@@ -3314,6 +3525,8 @@ static int inline ai_read_data_pooling(me4600_ai_subdevice_t* instance)
 			break;
 		}
 		me_readw(instance->base.dev, &tmp, instance->data_reg);
+		// Number of values is not known in advance. Status read above costs more than this.
+		(void)me_seg_buf_reserve(instance->seg_buf, 1);
 		if (instance->chan_list_copy)
 		{
 			me_seg_buf_put(instance->seg_buf, ai_calculate_calibrated_value(instance, instance->chan_list_copy[instance->chan_list_copy_pos], tmp));
@@ -3327,6 +3540,13 @@ static int inline ai_read_data_pooling(me4600_ai_subdevice_t* instance)
 		++copied;
 	}
 
+	me_subdevice_stats_samples(&instance->base, copied, me_seg_buf_values(instance->seg_buf));
+	trace_me_seg_buf_put(instance, instance->base.idx, copied, me_seg_buf_values(instance->seg_buf));
+	if (status)
+	{
+		me_subdevice_stats_overflow(&instance->base);
+	}
+
 #ifdef MEDEBUG_ERROR
 	if(!status)
 		PINFO("SLOW: DOWNLOADED %d values\n", copied);
@@ -3365,6 +3585,9 @@ static void me4600_ai_work_control_task(
 		return;
 	}
 
+	me_subdevice_stats_task(&instance->base);
+	trace_me_control_task(instance, instance->base.idx, instance->status);
+
 	if (signal_pending(current))
 	{
 		PERROR("Control task interrupted.\n");
@@ -3457,6 +3680,7 @@ static void me4600_ai_work_control_task(
 					instance->me4600_ai_error_confirm++;
 					if (instance->me4600_ai_error_confirm > me4600_AI_ERROR_TIMEOUT)
 					{
+						me_subdevice_stats_overflow(&instance->base);
 						instance->status = ai_status_stream_fifo_error;
 						instance->stream_stop_count++;
 						// Signal the end of wait for stop.
@@ -3665,6 +3889,7 @@ me4600_ai_subdevice_t* me4600_ai_constr(void* reg_base,
 	subdevice->base.me_subdevice_io_stream_start = me4600_ai_io_stream_start;
 	subdevice->base.me_subdevice_io_stream_status = me4600_ai_io_stream_status;
 	subdevice->base.me_subdevice_io_stream_stop = me4600_ai_io_stream_stop;
+	subdevice->base.me_subdevice_io_stream_reader = me4600_ai_io_stream_reader;
 	subdevice->base.me_subdevice_query_number_channels = me4600_ai_query_number_channels;
 	subdevice->base.me_subdevice_query_subdevice_type = me4600_ai_query_subdevice_type;
 	subdevice->base.me_subdevice_query_subdevice_caps = me4600_ai_query_subdevice_caps;
@@ -4149,6 +4374,8 @@ static int me4600_ai_config_load(me_subdevice_t* subdevice, struct file* filep,
 {
 	me4600_ai_subdevice_t* instance;
 	me4600_config_load_t* ai_config;
+	me_seg_buf_t* new_buf;
+	me_seg_buf_t* old_buf = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
 	PDEBUG("executed. idx=0\n");
@@ -4166,10 +4393,28 @@ static int me4600_ai_config_load(me_subdevice_t* subdevice, struct file* filep,
 	if (!err)
 	{
 		ME_SUBDEVICE_ENTER;
+			// Allocation can sleep. Only exchange of buffers is done under lock.
+			new_buf = create_seg_buffer(ai_config->config.chunks_count, ai_config->config.chunk_size);
 			ME_LOCK_PROTECTOR;
-			destroy_seg_buffer(&instance->seg_buf);
-			instance->seg_buf = create_seg_buffer(ai_config->config.chunks_count, ai_config->config.chunk_size);
+				if (new_buf)
+				{
+					old_buf = instance->seg_buf;
+					instance->seg_buf = new_buf;
+					// Attached readers stay attached.
+					me_seg_buf_readers_inherit(new_buf, old_buf);
+				}
+				else
+				{// Old buffer stays. Attached readers are not moved: they are detached and get error on next read.
+					me_seg_buf_readers_abort(instance->seg_buf, ME_ERRNO_CONFIG_LOAD_FAILED);
+				}
 			ME_UNLOCK_PROTECTOR;
+			destroy_seg_buffer(&old_buf);
+
+			if (!new_buf)
+			{
+				PERROR("Cannot create buffer of %u chunks.\n", ai_config->config.chunks_count);
+				err = ME_ERRNO_CONFIG_LOAD_FAILED;
+			}
 		ME_SUBDEVICE_EXIT;
 	}
 
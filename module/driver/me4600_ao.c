@@ -2227,6 +2227,7 @@ int me4600_ao_io_stream_write(me_subdevice_t* subdevice, struct file* filep, int
 	long j_timeout = 0;	// Timeout in jiffies
 	long j_timeout_left = 0; // Timeout (in jiffies) that left after pre-load.
 	long j_start;
+	uint64_t stall;
 	int err = ME_ERRNO_SUCCESS;
 
 	int copied_from_user = 0;
@@ -2409,6 +2410,7 @@ int me4600_ao_io_stream_write(me_subdevice_t* subdevice, struct file* filep, int
 						j_timeout_left = 1;
 
 					ME_UNLOCK_PROTECTOR;
+					stall = me_subdevice_stats_time(&instance->base);
 					wait_event_interruptible_timeout(instance->wait_queue,
 													me_circ_buf_space(&instance->circ_buf)
 													||
@@ -2418,6 +2420,7 @@ int me4600_ao_io_stream_write(me_subdevice_t* subdevice, struct file* filep, int
 														(instance->status > ao_status_stream_run)
 													),
 													j_timeout_left);
+					me_subdevice_stats_stall(&instance->base, stall);
 
 					ME_LOCK_PROTECTOR;
 
@@ -2506,6 +2509,8 @@ int me4600_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 	uint32_t status;
 	int count = 0;
 	int signal_irq = 0;
+	int data_count;
+	uint64_t isr_start = me_subdevice_stats_time(subdevice);
 
 	ME_HANDLER_PROTECTOR;
 		PDEBUG("executed. idx=%d\n", instance->base.idx);
@@ -2562,6 +2567,7 @@ int me4600_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 			ctrl |= ME4600_AO_CTRL_BIT_RESET_IRQ;
 			me_writel(instance->base.dev, ctrl, instance->ctrl_reg);
 
+			data_count = instance->data_count;
 			do
 			{
 				//Calculate how many should be copied.
@@ -2619,6 +2625,8 @@ int me4600_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 			}//Repeat if is still under half fifo
 			while ((status = me4600_ao_FSM_test(instance)) & ME4600_AO_STATUS_BIT_HF);
 
+			me_subdevice_stats_samples(&instance->base, instance->data_count - data_count, me_circ_buf_values(&instance->circ_buf));
+
 			//Unblock interrupts
 			me_readl(instance->base.dev, &ctrl, instance->ctrl_reg);
 
@@ -2643,6 +2651,7 @@ int me4600_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 			}
 			else
 			{//Error during copy.
+				me_subdevice_stats_overflow(&instance->base);
 				instance->status = ao_status_stream_fifo_error;
 				instance->stream_stop_count++;
 			}
@@ -2672,6 +2681,8 @@ int me4600_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 ERROR:
 	ME_FREE_HANDLER_PROTECTOR;
 
+	me_subdevice_stats_isr(&instance->base, isr_start);
+
 	if (signal_irq)
 	{
 		PDEBUG("Signal. me_circ_buf_space(&instance->circ_buf)=%d\n", me_circ_buf_space(&instance->circ_buf));
@@ -3176,6 +3187,9 @@ void me4600_ao_work_control_task(
 		return;
 	}
 
+	me_subdevice_stats_task(&instance->base);
+	trace_me_control_task(instance, instance->base.idx, instance->status);
+
 	if (signal_pending(current))
 	{
 		PERROR("Control task interrupted.\n");
@@ -3402,6 +3416,7 @@ void me4600_ao_work_control_task(
 							else
 							{
 								PERROR("Output stream has been broken. ISM stoped. No data in FIFO. Buffer is not empty.\n");
+								me_subdevice_stats_overflow(&instance->base);
 								instance->status = ao_status_stream_buffer_error;
 							}
 						}
@@ -3421,6 +3436,7 @@ void me4600_ao_work_control_task(
 						{// Software buffer is empty.
 							PERROR("Output stream has been broken. ISM stoped but some data in FIFO. Buffer is empty.\n");
 						}
+						me_subdevice_stats_overflow(&instance->base);
 						instance->status = ao_status_stream_fifo_error;
 					}
 
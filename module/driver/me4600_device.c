@@ -55,6 +55,11 @@
 
 # include "me4600_device.h"
 
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM me4600
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
 # define ME_MODULE_NAME		ME4600_NAME
 # define ME_MODULE_VERSION	ME4600_VERSION
 
@@ -648,7 +653,7 @@ static irqreturn_t me4600_isr(int irq, void* context
 		{
 			PINFO("Interrupt for AI_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
@@ -661,7 +666,7 @@ static irqreturn_t me4600_isr(int irq, void* context
 		{
 			PINFO("Interrupt for AO_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
@@ -674,7 +679,7 @@ static irqreturn_t me4600_isr(int irq, void* context
 		{
 			PINFO("Interrupt for EXT_IRQ_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
@@ -433,6 +433,7 @@ int me4600_dio_io_single_write(me_subdevice_t* subdevice, struct file* filep, in
 				default:
 					tmp = value & 0xFF;
 			}
+			me_latency_probe_write(&instance->base, me_latency_probe_time());
 			me_writel(instance->base.dev, tmp, instance->port_reg);
 ERROR:
 		ME_SUBDEVICE_UNLOCK;
@@ -169,6 +169,7 @@ int me4600_ext_irq_io_irq_wait(me_subdevice_t* subdevice, struct file *filep, in
 	unsigned long int delay = LONG_MAX - 2;
 	int old_count;
 	int old_reset_count;
+	uint64_t stall;
 	int err = ME_ERRNO_SUCCESS;
 
 	PDEBUG("executed.\n");
@@ -201,11 +202,17 @@ int me4600_ext_irq_io_irq_wait(me_subdevice_t* subdevice, struct file *filep, in
 
 		if (old_count == instance->count)
 		{
+			stall = me_subdevice_stats_time(&instance->base);
 			if (wait_event_interruptible_timeout(instance->wait_queue, ((old_count != instance->count) || (old_reset_count != instance->reset_count)), delay) <= 0)
 			{
 				PDEBUG("Wait on external interrupt timed out.\n");
 				err = ME_ERRNO_TIMEOUT;
 			}
+			else
+			{
+				me_latency_probe_wake(&instance->base, me_latency_probe_time());
+			}
+			me_subdevice_stats_stall(&instance->base, stall);
 
 			if (instance->status == irq_status_none)
 			{
@@ -321,8 +328,10 @@ static int me4600_ext_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 {
 	me4600_ext_irq_subdevice_t* instance;
 	uint32_t tmp;
+	uint64_t irq_time;
 
 	instance = (me4600_ext_irq_subdevice_t *) subdevice;
+	irq_time = me_latency_probe_time();
 
 #ifdef MEDEBUG_SPEED_TEST
 	uint64_t execuction_time;
@@ -335,11 +344,15 @@ static int me4600_ext_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 		me_readl(instance->base.dev, &tmp, instance->ext_irq_value_reg);
 		instance->value = (tmp >> ME4600_EXT_IRQ_VALUE_SHIFT) & 0x01;
 		instance->count++;
+		me_latency_probe_irq(&instance->base, irq_time, instance->count);
 		PINFO("IRQ count=%d\n", instance->count);
 
 		me_writel(instance->base.dev, instance->mode | ME4600_EXT_IRQ_RESET, instance->ext_irq_config_reg);
 		me_writel(instance->base.dev, instance->mode, instance->ext_irq_config_reg);
 	ME_FREE_HANDLER_PROTECTOR;
+
+	me_subdevice_stats_isr(&instance->base, irq_time);
+
 	if (instance->status == irq_status_run)
 	{
 		wake_up_interruptible_all(&instance->wait_queue);
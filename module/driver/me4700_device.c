@@ -55,6 +55,11 @@
 
 # include "me4700_device.h"
 
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM me4700
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
 # define ME_MODULE_NAME  ME4700_NAME
 # define ME_MODULE_VERSION	ME4700_VERSION
 
@@ -714,7 +719,7 @@ static irqreturn_t me4700_isr(int irq, void* context
 		{
 			PINFO("Interrupt for AI_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
@@ -727,7 +732,7 @@ static irqreturn_t me4700_isr(int irq, void* context
 		{
 			PINFO("Interrupt for AO_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
@@ -740,7 +745,7 @@ static irqreturn_t me4700_isr(int irq, void* context
 		{
 			PINFO("Interrupt for FI_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
@@ -753,7 +758,7 @@ static irqreturn_t me4700_isr(int irq, void* context
 		{
 			PINFO("Interrupt for EXT_IRQ_subdevice %d\n", i);
 			instance = irq_context->subdevice[gi];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			{
 				ret = IRQ_HANDLED;
 			}
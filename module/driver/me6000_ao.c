@@ -2270,6 +2270,7 @@ int me6000_ao_io_stream_write(me_subdevice_t* subdevice, struct file* filep, int
 	long j_timeout = 0;	// Timeout in jiffies
 	long j_timeout_left = 0; // Timeout (in jiffies) that left after pre-load.
 	long j_start;
+	uint64_t stall;
 	int err = ME_ERRNO_SUCCESS;
 
 	int copied_from_user = 0;
@@ -2453,6 +2454,7 @@ int me6000_ao_io_stream_write(me_subdevice_t* subdevice, struct file* filep, int
 						j_timeout_left = 1;
 
 					ME_UNLOCK_PROTECTOR;
+					stall = me_subdevice_stats_time(&instance->base);
 					wait_event_interruptible_timeout(instance->wait_queue,
 													me_circ_buf_space(&instance->circ_buf)
 													||
@@ -2462,6 +2464,7 @@ int me6000_ao_io_stream_write(me_subdevice_t* subdevice, struct file* filep, int
 														(instance->status > ao_status_stream_run)
 													),
 													j_timeout_left);
+					me_subdevice_stats_stall(&instance->base, stall);
 					ME_LOCK_PROTECTOR;
 
 					if (signal_pending(current))
@@ -2551,6 +2554,8 @@ static int me6000_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 	int count = 0;
 	int err = ME_ERRNO_SUCCESS;
 	int signal_irq = 0;
+	int data_count;
+	uint64_t isr_start = me_subdevice_stats_time(subdevice);
 
 	ME_HANDLER_PROTECTOR;
 		PDEBUG("executed. idx=%d\n", instance->base.idx);
@@ -2608,6 +2613,7 @@ static int me6000_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 			ctrl &= ~ME6000_AO_CTRL_BIT_ENABLE_IRQ;
 			me_writel(instance->base.dev, ctrl, instance->ctrl_reg);
 
+			data_count = instance->data_count;
 			do
 			{
 				//Calculate how many should be copied.
@@ -2665,6 +2671,8 @@ static int me6000_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 			}//Repeat if still is under half fifo
 			while ((status = me6000_ao_FSM_test(instance)) & ME6000_AO_STATUS_BIT_HF);
 
+			me_subdevice_stats_samples(&instance->base, instance->data_count - data_count, me_circ_buf_values(&instance->circ_buf));
+
 			//Unblock interrupts
 			me_readl(instance->base.dev, &ctrl, instance->ctrl_reg);
 			if (count >= 0)
@@ -2686,6 +2694,7 @@ static int me6000_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 			}
 			else
 			{//Error during copy.
+				me_subdevice_stats_overflow(&instance->base);
 				instance->status = ao_status_stream_fifo_error;
 				instance->stream_stop_count++;
 			}
@@ -2710,6 +2719,8 @@ ERROR:
 		me_readl(instance->base.dev, &tmp, instance->irq_reset_reg);
 	ME_FREE_HANDLER_PROTECTOR;
 
+	me_subdevice_stats_isr(&instance->base, isr_start);
+
 	if (signal_irq)
 	{
 		//Signal it.
@@ -3214,6 +3225,9 @@ static void me6000_ao_work_control_task(
 		return;
 	}
 
+	me_subdevice_stats_task(&instance->base);
+	trace_me_control_task(instance, instance->base.idx, instance->status);
+
 	if (signal_pending(current))
 	{
 		PERROR("Control task interrupted.\n");
@@ -3501,6 +3515,7 @@ static void me6000_ao_work_control_task(
 							else
 							{
 								PERROR("Output stream has been broken. ISM stoped. No data in FIFO. Buffer is not empty.\n");
+								me_subdevice_stats_overflow(&instance->base);
 								instance->status = ao_status_stream_buffer_error;
 							}
 						}
@@ -3520,6 +3535,7 @@ static void me6000_ao_work_control_task(
 						{// Software buffer is empty.
 							PERROR("Output stream has been broken. ISM stoped but some data in FIFO. Buffer is empty.\n");
 						}
+						me_subdevice_stats_overflow(&instance->base);
 						instance->status = ao_status_stream_fifo_error;
 					}
 
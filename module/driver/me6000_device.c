@@ -49,6 +49,11 @@
 
 # include "me6000_device.h"
 
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM me6000
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
 # define ME_MODULE_NAME		ME6000_NAME
 # define ME_MODULE_VERSION	ME6000_VERSION
 
@@ -568,7 +573,7 @@ static irqreturn_t me6000_isr(int irq, void* context
 		{//Interrupt line X
 			PINFO("Interrupt for AO_subdevice %d\n", i);
 			instance = irq_context->subdevice[i];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 				ret = IRQ_HANDLED;
 		}
 	}
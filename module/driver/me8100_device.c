@@ -52,6 +52,11 @@
 
 # include "me8100_device.h"
 
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM me8100
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
 # define ME_MODULE_NAME		ME8100_NAME
 # define ME_MODULE_VERSION	ME8100_VERSION
 
@@ -280,7 +285,7 @@ static irqreturn_t me8100_isr(int irq, void* context
 	{//Interrupt line 1
 		PINFO("IRQ line A.\n");
 		instance = irq_context->subdevice[0];
-		if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+		if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 			ret = IRQ_HANDLED;
 	}
 
@@ -290,7 +295,7 @@ static irqreturn_t me8100_isr(int irq, void* context
 		{//Interrupt line 2
 			PINFO("IRQ line B.\n");
 			instance = irq_context->subdevice[1];
-				if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+				if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 					ret = IRQ_HANDLED;
 		}
 	}
@@ -53,6 +53,11 @@
 
 # include "me8200_device.h"
 
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM me8200
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
 # define ME_MODULE_NAME		ME8200_NAME
 # define ME_MODULE_VERSION	ME8200_VERSION
 
@@ -285,7 +290,7 @@ static irqreturn_t me8200_isr(int irq, void* context
 	for (input_index = 0; input_index < me8200_versions[version_idx].di_subdevices; input_index++)
 	{
 		instance = irq_context->subdevice[input_index];
-		if(!instance->me_subdevice_irq_handle(instance, 0))
+		if(!me_subdevice_irq_dispatch(instance, 0))
 		{
 			PINFO("DI IRQ port %d\n", input_index);
 			ret = IRQ_HANDLED;
@@ -300,7 +305,7 @@ static irqreturn_t me8200_isr(int irq, void* context
 		{
 			PINFO("DO IRQ port %d\n", output_index);
 			instance = irq_context->subdevice[output_index+input_index];
-			if(!instance->me_subdevice_irq_handle(instance, irq_status_val))
+			if(!me_subdevice_irq_dispatch(instance, irq_status_val))
 				ret = IRQ_HANDLED;
 		}
 	}
@@ -251,6 +251,7 @@ int me8200_di_io_irq_wait(me_subdevice_t* subdevice, struct file* filep, int cha
 	int err = ME_ERRNO_SUCCESS;
 	unsigned long int delay = LONG_MAX -2;
 	int count;
+	uint64_t stall;
 
 	PDEBUG("executed.\n");
 
@@ -284,11 +285,17 @@ int me8200_di_io_irq_wait(me_subdevice_t* subdevice, struct file* filep, int cha
 			instance->rised = 0;
 			count = instance->count;
 
+			stall = me_subdevice_stats_time(&instance->base);
 			if (wait_event_interruptible_timeout(instance->wait_queue, ((count != instance->count) || (instance->rised<0)), delay) <= 0)
 			{
 				PERROR("Wait on interrupt timed out.\n");
 				err = ME_ERRNO_TIMEOUT;
 			}
+			else
+			{
+				me_latency_probe_wake(&instance->base, me_latency_probe_time());
+			}
+			me_subdevice_stats_stall(&instance->base, stall);
 
 			if (instance->rised < 0)
 			{
@@ -578,9 +585,11 @@ static int me8200_di_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 
 	unsigned int status_val;
 	unsigned int status_val_EX;
+	uint64_t irq_time;
 	int err = ME_ERRNO_SUCCESS;
 
 	instance = (me8200_di_subdevice_t *) subdevice;
+	irq_time = me_latency_probe_time();
 
 	ME_HANDLER_PROTECTOR;
 		PDEBUG("executed.\n");
@@ -646,11 +655,13 @@ static int me8200_di_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
 				instance->rised = 1;
 				instance->count++;
 			}
+			me_latency_probe_irq(&instance->base, irq_time, instance->count);
 		}
 	ME_FREE_HANDLER_PROTECTOR;
 
 	if (!err)
 	{
+		me_subdevice_stats_isr(&instance->base, irq_time);
 		wake_up_interruptible_all(&instance->wait_queue);
 	}
 
@@ -665,9 +676,11 @@ static int me8200_di_irq_handle_EX(me_subdevice_t* subdevice, uint32_t irq_statu
 	uint16_t irq_status_EX = 0;
 	uint32_t status_val = 0;
 	int i, j;
+	uint64_t irq_time;
 	int err = ME_ERRNO_SUCCESS;
 
 	instance = (me8200_di_subdevice_t *) subdevice;
+	irq_time = me_latency_probe_time();
 
 	ME_HANDLER_PROTECTOR;
 		PDEBUG("executed.\n");
@@ -720,11 +733,13 @@ static int me8200_di_irq_handle_EX(me_subdevice_t* subdevice, uint32_t irq_statu
 				instance->rised = 1;
 				instance->count++;
 			}
+			me_latency_probe_irq(&instance->base, irq_time, instance->count);
 		}
 	ME_FREE_HANDLER_PROTECTOR;
 
 	if (!err)
 	{
+		me_subdevice_stats_isr(&instance->base, irq_time);
 		wake_up_interruptible_all(&instance->wait_queue);
 	}
 
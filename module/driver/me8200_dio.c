@@ -306,6 +306,7 @@ int me8200_dio_io_single_write(me_subdevice_t* subdevice, struct file* filep, in
 							tmp = value;
 							break;
 					}
+					me_latency_probe_write(&instance->base, me_latency_probe_time());
 					me_writeb(instance->base.dev, tmp, instance->port_reg);
 				}
 			ME_SPIN_UNLOCK(instance->ctrl_reg_lock);
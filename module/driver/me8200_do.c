@@ -449,6 +449,7 @@ int me8200_do_io_single_write(me_subdevice_t* subdevice, struct file* filep, int
 					tmp = value;
 					break;
 			}
+			me_latency_probe_write(&instance->base, me_latency_probe_time());
 			me_writeb(instance->base.dev, tmp, instance->port_reg);
 		ME_SUBDEVICE_UNLOCK;
 	ME_SUBDEVICE_EXIT;
@@ -92,6 +92,8 @@
 # define ME_DRV "ME_PCI"
 #elif defined (ME_USB)
 # define ME_DRV "ME_USB"
+#elif defined (ME_VIRTUAL)
+# define ME_DRV "ME_VIRTUAL"
 #else
 # define ME_DRV "MEiDS"
 #endif
@@ -220,5 +222,28 @@
 # define PEXECTIME(fmt, args...)
 #endif
 
+//Execution time of a call. Without MEDEBUG_TIMESTAMPS the clock is not read at all. Use tracepoints (me_trace.h) instead.
+#ifdef MEDEBUG_TIMESTAMPS
+# define PEXECTIME_DECLARE \
+	struct timespec ts_pre; \
+	struct timespec ts_post; \
+	struct timespec ts_exec
+# define PEXECTIME_BEGIN() \
+	getnstimeofday(&ts_pre)
+# define PEXECTIME_END() \
+	do { \
+		getnstimeofday(&ts_post); \
+		ts_exec = timespec_sub(ts_post, ts_pre); \
+		PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC); \
+	} while (0)
+#else
+# define PEXECTIME_DECLARE \
+	struct timespec ts_pre __maybe_unused
+# define PEXECTIME_BEGIN() \
+	do { } while (0)
+# define PEXECTIME_END() \
+	do { } while (0)
+#endif
+
 # endif	//_MEDEBUG_H_
 #endif	//__KERNEL__
@@ -39,7 +39,7 @@
 # include "me_debug.h"
 
 ///*************************************  PCI  *********************************///
-#if defined(ME_PCI) || defined(SCALE_RT)
+#if defined(ME_PCI) || defined(ME_VIRTUAL) || defined(SCALE_RT)
 #if !defined(SCALE_RT)
 # if !defined(ME_ATRENATIVE_LOCKS)
 
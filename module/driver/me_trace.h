@@ -0,0 +1,184 @@
+/**
+ * @file me_trace.h
+ *
+ * @brief Tracepoints of the driver system (ioctl, interrupt handlers, segmented buffers and control tasks).
+ * @note Copyright (C) 2007 Meilhaus Electronic GmbH (support@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2007 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+/*
+ * Disabled tracepoint is a static key (jump label): one nop in the code path, arguments are not evaluated.
+ * Enable with perf or ftrace, e.g.: echo 1 > /sys/kernel/debug/tracing/events/me4600_pci/enable
+ *
+ * Every module creates own copy of the events: exactly one file per module defines ME_TRACE_SYSTEM
+ * (module name without bus) and CREATE_TRACE_POINTS before including this header.
+ * Bus is appended to the name, because PCI and USB modules can be loaded at the same time.
+ */
+
+#ifdef __KERNEL__
+
+# include <linux/version.h>
+
+# if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,33)
+#  ifndef _ME_TRACE_H_
+#   define _ME_TRACE_H_
+// No event classes in this kernel. Tracepoints compiled out.
+static inline void trace_me_ioctl_entry(unsigned int service) {}
+static inline void trace_me_ioctl_exit(unsigned int service, long ret) {}
+static inline void trace_me_isr_entry(const void* subdevice, unsigned int idx, uint32_t irq_status) {}
+static inline void trace_me_isr_exit(const void* subdevice, unsigned int idx, int err) {}
+static inline void trace_me_seg_buf_put(const void* subdevice, unsigned int idx, int count, unsigned int values) {}
+static inline void trace_me_seg_buf_get(const void* subdevice, unsigned int idx, int count, unsigned int values) {}
+static inline void trace_me_control_task(const void* subdevice, unsigned int idx, int status) {}
+#  endif	//_ME_TRACE_H_
+# else
+
+#  define __ME_TRACE_PASTE(a, b)	a##b
+#  define ME_TRACE_PASTE(a, b)		__ME_TRACE_PASTE(a, b)
+
+#  undef TRACE_SYSTEM
+#  if !defined(ME_TRACE_SYSTEM)
+#   define TRACE_SYSTEM meids
+#  elif defined(ME_PCI)
+#   define TRACE_SYSTEM ME_TRACE_PASTE(ME_TRACE_SYSTEM, _pci)
+#  elif defined(ME_USB)
+#   define TRACE_SYSTEM ME_TRACE_PASTE(ME_TRACE_SYSTEM, _usb)
+#  else
+#   define TRACE_SYSTEM ME_TRACE_SYSTEM
+#  endif
+
+#  if !defined(_ME_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#   define _ME_TRACE_H_
+
+#   include <linux/tracepoint.h>
+
+TRACE_EVENT(me_ioctl_entry,
+	TP_PROTO(unsigned int service),
+	TP_ARGS(service),
+	TP_STRUCT__entry(
+		__field(unsigned int, service)
+	),
+	TP_fast_assign(
+		__entry->service = service;
+	),
+	TP_printk("nr=%u", _IOC_NR(__entry->service))
+);
+
+TRACE_EVENT(me_ioctl_exit,
+	TP_PROTO(unsigned int service, long ret),
+	TP_ARGS(service, ret),
+	TP_STRUCT__entry(
+		__field(unsigned int, service)
+		__field(long, ret)
+	),
+	TP_fast_assign(
+		__entry->service = service;
+		__entry->ret = ret;
+	),
+	TP_printk("nr=%u ret=%ld", _IOC_NR(__entry->service), __entry->ret)
+);
+
+TRACE_EVENT(me_isr_entry,
+	TP_PROTO(const void* subdevice, unsigned int idx, uint32_t irq_status),
+	TP_ARGS(subdevice, idx, irq_status),
+	TP_STRUCT__entry(
+		__field(const void*, subdevice)
+		__field(unsigned int, idx)
+		__field(uint32_t, irq_status)
+	),
+	TP_fast_assign(
+		__entry->subdevice = subdevice;
+		__entry->idx = idx;
+		__entry->irq_status = irq_status;
+	),
+	TP_printk("subdevice=%p idx=%u irq_status=0x%08x", __entry->subdevice, __entry->idx, __entry->irq_status)
+);
+
+TRACE_EVENT(me_isr_exit,
+	TP_PROTO(const void* subdevice, unsigned int idx, int err),
+	TP_ARGS(subdevice, idx, err),
+	TP_STRUCT__entry(
+		__field(const void*, subdevice)
+		__field(unsigned int, idx)
+		__field(int, err)
+	),
+	TP_fast_assign(
+		__entry->subdevice = subdevice;
+		__entry->idx = idx;
+		__entry->err = err;
+	),
+	TP_printk("subdevice=%p idx=%u err=%d", __entry->subdevice, __entry->idx, __entry->err)
+);
+
+/// One event per batch of values moved into/out of segmented buffer. 'values' is buffer's fill level after the batch.
+DECLARE_EVENT_CLASS(me_seg_buf,
+	TP_PROTO(const void* subdevice, unsigned int idx, int count, unsigned int values),
+	TP_ARGS(subdevice, idx, count, values),
+	TP_STRUCT__entry(
+		__field(const void*, subdevice)
+		__field(unsigned int, idx)
+		__field(int, count)
+		__field(unsigned int, values)
+	),
+	TP_fast_assign(
+		__entry->subdevice = subdevice;
+		__entry->idx = idx;
+		__entry->count = count;
+		__entry->values = values;
+	),
+	TP_printk("subdevice=%p idx=%u count=%d values=%u", __entry->subdevice, __entry->idx, __entry->count, __entry->values)
+);
+
+DEFINE_EVENT(me_seg_buf, me_seg_buf_put,
+	TP_PROTO(const void* subdevice, unsigned int idx, int count, unsigned int values),
+	TP_ARGS(subdevice, idx, count, values)
+);
+
+DEFINE_EVENT(me_seg_buf, me_seg_buf_get,
+	TP_PROTO(const void* subdevice, unsigned int idx, int count, unsigned int values),
+	TP_ARGS(subdevice, idx, count, values)
+);
+
+TRACE_EVENT(me_control_task,
+	TP_PROTO(const void* subdevice, unsigned int idx, int status),
+	TP_ARGS(subdevice, idx, status),
+	TP_STRUCT__entry(
+		__field(const void*, subdevice)
+		__field(unsigned int, idx)
+		__field(int, status)
+	),
+	TP_fast_assign(
+		__entry->subdevice = subdevice;
+		__entry->idx = idx;
+		__entry->status = status;
+	),
+	TP_printk("subdevice=%p idx=%u status=%d", __entry->subdevice, __entry->idx, __entry->status)
+);
+
+#  endif	//_ME_TRACE_H_ || TRACE_HEADER_MULTI_READ
+
+#  undef TRACE_INCLUDE_PATH
+#  define TRACE_INCLUDE_PATH .
+#  undef TRACE_INCLUDE_FILE
+#  define TRACE_INCLUDE_FILE me_trace
+#  include <trace/define_trace.h>
+
+# endif	//LINUX_VERSION_CODE
+#endif	//__KERNEL__
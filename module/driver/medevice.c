@@ -89,6 +89,8 @@ static int me_device_io_stream_stop(me_device_t* device, struct file* filep, int
 static int me_device_io_stream_write(me_device_t* device, struct file* filep, int subdevice, int write_mode, int* values, int* count, int flags);
 static int me_device_io_stream_timeout_write(me_device_t* device, struct file* filep, int subdevice,
 												int write_mode, int* values, int* count, int time_out, int flags);
+static int me_device_io_stream_reader(me_device_t* device, struct file* filep, int subdevice, int mode, int policy, int* dropped, int flags);
+static void me_device_close(me_device_t* device, struct file* filep);
 
 static int me_device_lock_device( me_device_t* device, struct file* filep, int lock, int flags);
 static int me_device_lock_subdevice(me_device_t* device, struct file* filep, int subdevice, int lock, int flags);
@@ -112,6 +114,8 @@ static int me_device_query_timer(me_device_t* device, int subdevice, int timer,
 static int me_device_query_version_device_driver( me_device_t* device, int* version);
 static int me_device_query_device_release(me_device_t* device, int* version);
 static int me_device_query_version_firmware(me_device_t* device, int subdevice, int* version);
+static int me_device_query_latency_probe(me_device_t* device, int subdevice, uint64_t* write_time, uint64_t* irq_time, uint64_t* wake_time, int* irq_count);
+static int me_device_query_stats(me_device_t* device, int subdevice, me_subdevice_stats_t* stats, int flags);
 
 static int me_device_config_load(me_device_t* device, struct file* filep, void* config, unsigned int size);
 static int me_device_set_offset(me_device_t* device, struct file* filep, int subdevice, int channel, int range, int* offset, int flags);
@@ -973,6 +977,73 @@ static int me_device_io_stream_write(me_device_t* device, struct file* filep, in
 	return me_device_io_stream_timeout_write(device, filep, subdevice, write_mode, values, count, 0, flags);
 }
 
+static int me_device_io_stream_reader(me_device_t* device, struct file* filep, int subdevice, int mode, int policy, int* dropped, int flags)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_subdevice_t* s;
+
+	PDEBUG("executed.\n");
+
+	// Check subdevice index.
+	if ((subdevice < 0) || (subdevice >= me_slist_get_number_subdevices(&device->slist)))
+	{
+		PERROR("Invalid subdevice.\n");
+		return ME_ERRNO_INVALID_SUBDEVICE;
+	}
+
+	// Enter device.
+	err = me_dlock_enter(&device->dlock, filep);
+	if (err)
+	{
+		PERROR("Cannot enter device.\n");
+		return err;
+	}
+
+	// Get subdevice instance.
+	s = me_slist_get_subdevice(&device->slist, subdevice);
+	if (s)
+	{
+		// Call subdevice method.
+		err = s->me_subdevice_io_stream_reader(
+				s,
+				filep,
+				mode,
+				policy,
+				dropped,
+				flags);
+	}
+	else
+	{
+		// Something really bad happened.
+		PERROR("Cannot get subdevice instance.\n");
+		err = ME_ERRNO_INTERNAL;
+	}
+
+	// Exit device.
+	me_dlock_exit(&device->dlock, filep);
+
+	return err;
+}
+
+static void me_device_close(me_device_t* device, struct file* filep)
+{
+	int i;
+	int dropped;
+	me_subdevice_t* s;
+
+	PDEBUG("executed.\n");
+
+	// File handle is going away. Detach it from all streams it reads. Locks are not checked here.
+	for (i = 0; i < me_slist_get_number_subdevices(&device->slist); i++)
+	{
+		s = me_slist_get_subdevice(&device->slist, i);
+		if (s)
+		{
+			s->me_subdevice_io_stream_reader(s, filep, ME_IO_STREAM_READER_DETACH, 0, &dropped, ME_IO_STREAM_READER_NO_FLAGS);
+		}
+	}
+}
+
 static int me_device_set_offset(me_device_t* device, struct file* filep, int subdevice, int channel, int range, int* offset, int flags)
 {
 	int err = ME_ERRNO_SUCCESS;
@@ -1116,6 +1187,9 @@ static int me_device_query_info_device(me_device_t* device, int* vendor_id, int*
 	*bus_type = ME_BUS_TYPE_PCI;
 #elif defined(ME_MEPHISTO)
 	*bus_type = ME_BUS_TYPE_USB;
+#elif defined(ME_VIRTUAL)
+	// Virtual board is presented to user space as a PCI board.
+	*bus_type = ME_BUS_TYPE_PCI;
 #else
 	//Only PCI and USB supported!
 	*bus_type = ME_BUS_TYPE_INVALID;
@@ -1484,6 +1558,68 @@ static int me_device_query_version_firmware(me_device_t* device, int subdevice,
 	return err;
 }
 
+static int me_device_query_latency_probe(me_device_t* device, int subdevice, uint64_t* write_time, uint64_t* irq_time, uint64_t* wake_time, int* irq_count)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_subdevice_t* s;
+
+	PDEBUG("executed.\n");
+
+	// Check subdevice index.
+	if ((subdevice < 0) || (subdevice >= me_slist_get_number_subdevices(&device->slist)))
+	{
+		PERROR("Invalid subdevice.\n");
+		return ME_ERRNO_INVALID_SUBDEVICE;
+	}
+
+	// Get subdevice instance.
+	s = me_slist_get_subdevice(&device->slist, subdevice);
+	if (s)
+	{
+		// Time stamps are kept by base class. Subdevices without probe points report zeros.
+		me_latency_probe_read(s, write_time, irq_time, wake_time, irq_count);
+	}
+	else
+	{
+		// Something really bad happened.
+		PERROR("Cannot get subdevice instance.\n");
+		err = ME_ERRNO_INTERNAL;
+	}
+
+	return err;
+}
+
+static int me_device_query_stats(me_device_t* device, int subdevice, me_subdevice_stats_t* stats, int flags)
+{
+	int err = ME_ERRNO_SUCCESS;
+	me_subdevice_t* s;
+
+	PDEBUG("executed.\n");
+
+	// Check subdevice index.
+	if ((subdevice < 0) || (subdevice >= me_slist_get_number_subdevices(&device->slist)))
+	{
+		PERROR("Invalid subdevice.\n");
+		return ME_ERRNO_INVALID_SUBDEVICE;
+	}
+
+	// Get subdevice instance.
+	s = me_slist_get_subdevice(&device->slist, subdevice);
+	if (s)
+	{
+		// Counters are kept by base class. Subdevices without statistic points report zeros.
+		me_subdevice_stats_read(s, stats, flags);
+	}
+	else
+	{
+		// Something really bad happened.
+		PERROR("Cannot get subdevice instance.\n");
+		err = ME_ERRNO_INTERNAL;
+	}
+
+	return err;
+}
+
 static int me_device_config_load(me_device_t* device, struct file* filep, void* config, unsigned int size)
 {
 	PDEBUG("executed.\n");
@@ -1705,6 +1841,14 @@ int me_device_init(me_device_t* me_device, me_general_dev_t* hw_device)
 	me_device->bus.dev_no = 0;
 	me_device->bus.func_no = 0;
 	me_device->bus.bus_no = hw_device->dev->bus->busnum;
+
+#elif defined(ME_VIRTUAL)
+	//Dummy. Clears warning.
+	i=0;
+	// No bus. Instance index is used as slot number.
+	me_device->bus.dev_no = hw_device->serial_no;
+	me_device->bus.func_no = 0;
+	me_device->bus.bus_no = 0;
 # endif
 
 	PINFO("PCI SLOT     = %d\n", me_device->bus.dev_no);
@@ -1748,6 +1892,8 @@ void me_install_default_routines(me_device_t* me_device)
 	me_device->me_device_io_stream_stop						= me_device_io_stream_stop;
 	me_device->me_device_io_stream_write					= me_device_io_stream_write;
 	me_device->me_device_io_stream_timeout_write			= me_device_io_stream_timeout_write;
+	me_device->me_device_io_stream_reader					= me_device_io_stream_reader;
+	me_device->me_device_close								= me_device_close;
 
 	me_device->me_device_set_offset							= me_device_set_offset;
 
@@ -1772,6 +1918,8 @@ void me_install_default_routines(me_device_t* me_device)
 	me_device->me_device_query_version_device_driver		= me_device_query_version_device_driver;
 	me_device->me_device_query_device_release				= me_device_query_device_release;
 	me_device->me_device_query_version_firmware				= me_device_query_version_firmware;
+	me_device->me_device_query_latency_probe				= me_device_query_latency_probe;
+	me_device->me_device_query_stats						= me_device_query_stats;
 
 	me_device->me_device_config_load						= me_device_config_load;
 	me_device->me_device_postinit							= me_device_postinit;
@@ -1979,6 +2127,16 @@ int me_device_reinit(me_device_t* me_device, me_general_dev_t* hw_device)
 	me_device->bus.dev_no = 0;
 	me_device->bus.func_no = 0;
 
+# elif defined(ME_VIRTUAL)
+	memcpy(&me_device->bus.local_dev, hw_device, sizeof(struct virtual_local_dev));
+
+	// Dummy. Clears warning
+	i=0;
+
+	me_device->bus.bus_no = 0;
+	me_device->bus.dev_no = hw_device->serial_no;
+	me_device->bus.func_no = 0;
+
 # endif
 
 	PINFO("PCI SLOT     = %d\n", me_device->bus.dev_no);
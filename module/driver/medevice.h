@@ -27,7 +27,7 @@
 
 #ifdef __KERNEL__
 
-# if !defined(ME_PCI) && !defined(ME_USB) && !defined(ME_COMEDI) && !defined(ME_MEPHISTO)
+# if !defined(ME_PCI) && !defined(ME_USB) && !defined(ME_COMEDI) && !defined(ME_MEPHISTO) && !defined(ME_VIRTUAL)
 #  error NO VALID DRIVER TYPE declared!
 # endif
 
@@ -106,6 +106,21 @@ struct comedi_local_dev
 	unsigned int	irq_no;					/// Used interrupt number.
 };
 typedef struct comedi_local_dev me_general_dev_t;
+# elif defined(ME_VIRTUAL)
+/**
+	* @brief Struct virtual_local_dev holds the virtual (loopback) device information.
+	*/
+struct virtual_local_dev
+{
+	void*			dev;					/// Not used. Only to keep common code happy.
+
+	uint16_t 		vendor;					/// Meilhaus PCI vendor id.
+	uint16_t		device;					/// Virtual device id.
+	uint8_t			hw_revision;			/// Hardware revision of the device.
+	uint32_t		serial_no;				/// Serial number of the device (instance index).
+	unsigned int	irq_no;					/// Always 0. Interrupts are generated by timers.
+};
+typedef struct virtual_local_dev me_general_dev_t;
 
 # endif
 
@@ -348,6 +363,19 @@ typedef struct me_device
 			int timeout,
 			int flags);
 
+	int (*me_device_io_stream_reader)(
+			struct me_device* device,
+			struct file* filep,
+			int subdevice,
+			int mode,
+			int policy,
+			int *dropped,
+			int flags);
+
+	void (*me_device_close)(
+			struct me_device* device,
+			struct file* filep);
+
 	int (*me_device_set_offset)(
 			struct me_device* device,
 			struct file* filep,
@@ -476,6 +504,20 @@ typedef struct me_device
 			int subdevice,
 			int *version);
 
+	int (*me_device_query_latency_probe)(
+			struct me_device* device,
+			int subdevice,
+			uint64_t *write_time,
+			uint64_t *irq_time,
+			uint64_t *wake_time,
+			int *irq_count);
+
+	int (*me_device_query_stats)(
+			struct me_device* device,
+			int subdevice,
+			me_subdevice_stats_t* stats,
+			int flags);
+
 	int (*me_device_config_load)(
 			struct me_device* device,
 			struct file* filep,
@@ -58,6 +58,11 @@
 #include "memain_common.h"
 #include "memain_pci.h"
 
+// Tracepoints of this module (me_trace.h).
+#define ME_TRACE_SYSTEM memain
+#define CREATE_TRACE_POINTS
+#include "me_trace.h"
+
 static int me_probe_pci(struct pci_dev* raw_dev, const struct pci_device_id* id);
 static void me_remove_pci(struct pci_dev *raw_dev);
 static int me_pci_board_check(struct pci_local_dev* dev, struct pci_dev* raw_dev);
@@ -313,6 +318,9 @@ static int __init memain_pci_init(void)
 #endif
 								ME_NAME_NODE);
 
+	// Export statistics.
+	me_debugfs_init();
+
 	return 0;
 
 // INIT_ERROR_4:
@@ -334,6 +342,8 @@ static void __exit memain_pci_exit(void)
 
  	PDEBUG("executed.\n");
 
+	me_debugfs_exit();
+
 	// Remove all boards
 	pci_unregister_driver(&me_pci_driver);
 
@@ -64,6 +64,11 @@
 # include "memain_common.h"
 # include "memain_usb.h"
 
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM memain
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
 ///Globals
 struct file* me_filep = NULL;
 int me_count = 0;
@@ -379,6 +384,9 @@ static int __init memain_usb_init(void)
 #endif
 								ME_NAME_NODE);
 
+	// Export statistics.
+	me_debugfs_init();
+
 	return 0;
 
 INIT_ERROR_5:
@@ -400,6 +408,8 @@ static void __exit memain_usb_exit(void)
 
  	PDEBUG("executed.\n");
 
+	me_debugfs_exit();
+
 	// Remove all instances.
 	clear_device_list();
 
@@ -42,12 +42,16 @@
 # include "me_internal.h"
 # include "me_spin_lock.h"
 # include "medevice.h"
+# include "me_trace.h"
 
 # include <linux/time.h>
 # include <linux/errno.h>
 # include <linux/fs.h>
 # include <asm/uaccess.h>
 # include <linux/cdev.h>
+# include <linux/vmalloc.h>
+# include <linux/debugfs.h>
+# include <linux/seq_file.h>
 
 # include "memain_common.h"
 # include "memain_common_templates.h"
@@ -170,7 +174,7 @@ void insert_to_device_list(me_device_t* n_device)
 
 void release_instance(me_device_t* device)
 {
-# if defined(ME_MEPHISTO)
+# if defined(ME_MEPHISTO) || defined(ME_VIRTUAL)
  	PDEBUG("executed.\n");
 
  	if (!device)
@@ -188,7 +192,7 @@ void release_instance(me_device_t* device)
 		PERROR("Destructor not registred! device=0x%p device->me_device_destructor=0x%p\n", device, device->me_device_destructor);
 	}
 
-# else	//ME_MEPHISTO
+# else	//ME_MEPHISTO || ME_VIRTUAL
 
 	uint32_t dev_id;
 
@@ -257,11 +261,7 @@ void clear_device_list(void)
 	up_write(&me_rwsem);
 }
 
-#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,36)
-int me_ioctl(struct inode *inodep, struct file* filep, unsigned int service, unsigned long arg)
-#else
-long me_ioctl(struct file* filep, unsigned int service, unsigned long arg)
-#endif
+static long me_ioctl_service(struct file* filep, unsigned int service, unsigned long arg)
 {
 	PDEBUG("executed.\n");
 
@@ -337,6 +337,9 @@ long me_ioctl(struct file* filep, unsigned int service, unsigned long arg)
 		case ME_IO_STREAM_STATUS:
 			return me_io_stream_status(filep, (me_io_stream_status_t *)arg);
 
+		case ME_IO_STREAM_READER:
+			return me_io_stream_reader(filep, (me_io_stream_reader_t *)arg);
+
 		case ME_SET_OFFSET:
 			return me_set_offset(filep, (me_set_offset_t *)arg);
 
@@ -417,6 +420,12 @@ long me_ioctl(struct file* filep, unsigned int service, unsigned long arg)
 		case ME_QUERY_TYPE_DRIVER:
 			return me_query_type(filep, (me_query_type_driver_t *)arg);
 
+		case ME_QUERY_TOPOLOGY:
+			return me_query_topology(filep, (me_query_topology_t *)arg);
+
+		case ME_QUERY_LATENCY_PROBE:
+			return me_query_latency_probe(filep, (me_query_latency_probe_t *)arg);
+
 		///CONFIG
 		case ME_CONFIG_LOAD:
 			return me_config_load(filep, (me_extra_param_set_t *)arg);
@@ -426,6 +435,21 @@ long me_ioctl(struct file* filep, unsigned int service, unsigned long arg)
 	return -ENOTTY;
 }
 
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,36)
+int me_ioctl(struct inode *inodep, struct file* filep, unsigned int service, unsigned long arg)
+#else
+long me_ioctl(struct file* filep, unsigned int service, unsigned long arg)
+#endif
+{
+	long ret;
+
+	trace_me_ioctl_entry(service);
+	ret = me_ioctl_service(filep, service, arg);
+	trace_me_ioctl_exit(service, ret);
+
+	return ret;
+}
+
 
 #ifdef ME_IO_MULTIPLEX_TEMPLATE
 ME_IO_MULTIPLEX_TEMPLATE(
@@ -565,6 +589,19 @@ ME_IO_MULTIPLEX_TEMPLATE(
      &karg.count,
      karg.flags))
 
+ME_IO_MULTIPLEX_TEMPLATE(
+    "me_io_stream_reader",
+    me_io_stream_reader_t,
+    me_io_stream_reader,
+    me_device_io_stream_reader,
+    (dev,
+     filep,
+     karg.subdevice,
+     karg.mode,
+     karg.policy,
+     &karg.dropped,
+     karg.flags))
+
 ME_IO_MULTIPLEX_TEMPLATE(
     "me_io_stream_write",
     me_io_stream_write_t,
@@ -710,6 +747,18 @@ ME_QUERY_MULTIPLEX_TEMPLATE(
     karg.subdevice,
     &karg.caps))
 
+ME_QUERY_MULTIPLEX_TEMPLATE(
+    "me_query_latency_probe",
+    me_query_latency_probe_t,
+    me_query_latency_probe,
+    me_device_query_latency_probe,
+    (dev,
+    karg.subdevice,
+    &karg.write_time,
+    &karg.irq_time,
+    &karg.wake_time,
+    &karg.irq_count))
+
 ME_QUERY_MULTIPLEX_TEMPLATE(
     "me_query_number_ranges",
     me_query_number_ranges_t,
@@ -791,13 +840,11 @@ int me_lock_driver(struct file* filep, me_lock_driver_t* arg)
 	me_lock_driver_t lock ;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed. filep=%p\n", filep);
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&lock, arg, sizeof(me_lock_driver_t)))
 	{
@@ -816,10 +863,7 @@ int me_lock_driver(struct file* filep, me_lock_driver_t* arg)
 	}
 
 EXIT:
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -830,13 +874,11 @@ static int lock_driver(struct file* filep, int lock , int flags)
 	int err_no;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	ME_SPIN_LOCK(&me_lock);
 		if (!(flags & ME_LOCK_FORCE) || (lock == ME_LOCK_CHECK))
@@ -920,10 +962,7 @@ EXIT:
 		}
 	ME_SPIN_UNLOCK(&me_lock);
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -933,13 +972,11 @@ int me_lock_device(struct file* filep, me_lock_device_t* arg)
 	me_lock_device_t lock ;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed. filep=%p\n", filep);
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&lock, arg, sizeof(me_lock_device_t)))
 	{
@@ -958,10 +995,7 @@ int me_lock_device(struct file* filep, me_lock_device_t* arg)
 	}
 
 EXIT:
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -971,13 +1005,11 @@ static int lock_device(struct file* filep, int device, int lock , int flags)
 	me_device_t* dev = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	ME_SPIN_LOCK(&me_lock);
 		if ((me_filep != NULL) && (me_filep != filep))
@@ -999,10 +1031,7 @@ static int lock_device(struct file* filep, int device, int lock , int flags)
 		}
 	ME_SPIN_UNLOCK(&me_lock);
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1012,13 +1041,11 @@ int me_lock_subdevice(struct file* filep, me_lock_subdevice_t* arg)
 	me_lock_subdevice_t lock ;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed. filep=%p\n", filep);
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&lock, arg, sizeof(me_lock_subdevice_t)))
 	{
@@ -1037,10 +1064,7 @@ int me_lock_subdevice(struct file* filep, me_lock_subdevice_t* arg)
 	}
 
 EXIT:
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1050,13 +1074,11 @@ static int lock_subdevice(struct file* filep, int device, int subdevice, int loc
 	me_device_t* dev = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	ME_SPIN_LOCK(&me_lock);
 		if ((me_filep != NULL) && (me_filep != filep))
@@ -1078,10 +1100,7 @@ static int lock_subdevice(struct file* filep, int device, int subdevice, int loc
 		}
 	ME_SPIN_UNLOCK(&me_lock);
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1097,20 +1116,25 @@ int me_open(struct inode* inode_ptr, struct file* filep)
 
 int me_release(struct inode* inode_ptr, struct file* filep)
 {
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	me_device_t* dev;
+
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
-	lock_driver(filep, ME_LOCK_RELEASE, ME_LOCK_DRIVER_NO_FLAGS);
+	// Detach file handle from streams it was reading.
+	down_read(&me_rwsem);
+		list_for_each_entry(dev, &me_device_list, list)
+		{
+			dev->me_device_close(dev, filep);
+		}
+	up_read(&me_rwsem);
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
+	lock_driver(filep, ME_LOCK_RELEASE, ME_LOCK_DRIVER_NO_FLAGS);
 
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return ME_ERRNO_SUCCESS;
 }
@@ -1120,13 +1144,11 @@ int me_config_load(struct file* filep, me_extra_param_set_t* arg)
 	me_extra_param_set_t config_entry;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	// Copy argument to kernel space.
 	if (copy_from_user(&config_entry, arg, sizeof(me_extra_param_set_t)))
@@ -1161,10 +1183,7 @@ int me_config_load(struct file* filep, me_extra_param_set_t* arg)
 		err = -EFAULT;
 	}
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1174,13 +1193,11 @@ static int config_load(struct file* filep, me_extra_param_set_t* config)
 	me_device_t* dev = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	ME_SPIN_LOCK(&me_lock);
 		if ((me_filep != NULL) && (me_filep != filep))
@@ -1217,10 +1234,7 @@ static int config_load(struct file* filep, me_extra_param_set_t* config)
 		}
 	ME_SPIN_UNLOCK(&me_lock);
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1249,13 +1263,11 @@ static int custom_driver(struct file* filep, me_extra_param_set_t* config)
 
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	/// Allocate structures.
 	dev = kzalloc(sizeof(me_general_dev_t), GFP_KERNEL);
@@ -1387,10 +1399,7 @@ static int custom_driver(struct file* filep, me_extra_param_set_t* config)
 	}
 
 ERROR:
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1404,13 +1413,11 @@ int me_io_stream_start(struct file* filep, me_io_stream_start_t* arg)
 	me_io_stream_start_t karg;
 	meIOStreamStart_t* start_list = NULL;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&karg, arg, sizeof(me_io_stream_start_t)))
 	{
@@ -1512,10 +1519,7 @@ ERROR:
 		kfree(start_list);
 	start_list = NULL;
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1526,13 +1530,11 @@ int me_io_stream_start_simple(struct file* filep, me_io_stream_start_simple_t* a
 	me_io_stream_start_simple_t karg;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&karg, arg, sizeof(me_io_stream_start_simple_t)))
 	{
@@ -1575,10 +1577,7 @@ int me_io_stream_start_simple(struct file* filep, me_io_stream_start_simple_t* a
 		err = -EFAULT;
 	}
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1591,13 +1590,11 @@ int me_io_single(struct file* filep, me_io_single_t* arg)
 	meIOSingle_t* single_list = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&karg, arg, sizeof(me_io_single_t)))
 	{
@@ -1721,10 +1718,7 @@ ERROR:
 		kfree(single_list);
 	single_list = NULL;
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1735,13 +1729,11 @@ int me_io_single_simple(struct file* filep, me_io_single_simple_t* arg)
 	me_io_single_simple_t karg;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&karg, arg, sizeof(me_io_single_simple_t)))
 	{
@@ -1806,10 +1798,7 @@ int me_io_single_simple(struct file* filep, me_io_single_simple_t* arg)
 		err = -EFAULT;
 	}
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1821,13 +1810,11 @@ int me_io_stream_config(struct file* filep, me_io_stream_config_t* arg)
 	meIOStreamSimpleConfig_t* config_list = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&karg, arg, sizeof(me_io_stream_config_t)))
 	{
@@ -1899,10 +1886,7 @@ ERROR:
 		kfree(config_list);
 	config_list = NULL;
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -1915,13 +1899,11 @@ int me_io_stream_stop(struct file* filep, me_io_stream_stop_t* arg)
 	meIOStreamStop_t* stop_list = NULL;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&karg, arg, sizeof(me_io_stream_stop_t)))
 	{
@@ -2017,10 +1999,7 @@ ERROR:
 		kfree(stop_list);
 	stop_list = NULL;
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -2031,9 +2010,7 @@ int me_io_stream_stop_simple(struct file* filep, me_io_stream_stop_simple_t* arg
 	me_io_stream_stop_simple_t karg;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
@@ -2043,7 +2020,7 @@ int me_io_stream_stop_simple(struct file* filep, me_io_stream_stop_simple_t* arg
 		return -EFAULT;
 	}
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	ME_SPIN_LOCK(&me_lock);
 		if ((me_filep != NULL) && (me_filep != filep))
@@ -2075,10 +2052,7 @@ int me_io_stream_stop_simple(struct file* filep, me_io_stream_stop_simple_t* arg
 		}
 	ME_SPIN_UNLOCK(&me_lock);
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	if (copy_to_user(arg, &karg, sizeof(me_io_stream_stop_simple_t)))
 	{
@@ -2094,13 +2068,11 @@ int me_query_name_main_driver(struct file* filep, me_query_name_main_driver_t* a
 	me_query_name_main_driver_t karg;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if (copy_from_user(&karg, arg, sizeof(me_query_name_main_driver_t)))
 	{
@@ -2132,10 +2104,7 @@ int me_query_name_main_driver(struct file* filep, me_query_name_main_driver_t* a
 	}
 
 EXIT:
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -2146,13 +2115,11 @@ int me_query_number_devices(struct file* filep, me_query_number_devices_t* arg)
 	struct list_head* pos;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	karg.err_no = ME_ERRNO_SUCCESS;
 	karg.number = 0;
@@ -2163,10 +2130,7 @@ int me_query_number_devices(struct file* filep, me_query_number_devices_t* arg)
 		}
 	up_read(&me_rwsem);
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	if (copy_to_user(arg, &karg, sizeof(me_query_number_devices_t)))
 	{
@@ -2182,13 +2146,11 @@ int me_query_version_main_driver(struct file* filep, me_query_version_main_drive
 	me_query_version_main_driver_t karg;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	karg.version = ME_VERSION_DRIVER;
 	karg.err_no = ME_ERRNO_SUCCESS;
@@ -2199,10 +2161,7 @@ int me_query_version_main_driver(struct file* filep, me_query_version_main_drive
 		err = -EFAULT;
 	}
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -2212,13 +2171,11 @@ static int me_query_type(struct file* filep, me_query_type_driver_t* arg)
 	me_query_type_driver_t karg;
 	int err = ME_ERRNO_SUCCESS;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 # if defined(ME_PCI)
 	karg.type = ME_DRIVER_PCI;
@@ -2234,10 +2191,7 @@ static int me_query_type(struct file* filep, me_query_type_driver_t* arg)
 		err = -EFAULT;
 	}
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
-
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+	PEXECTIME_END();
 
 	return err;
 }
@@ -2250,13 +2204,11 @@ int me_query_subdevice_caps_args(struct file* filep, me_query_subdevice_caps_arg
 	int* k_args_buf;
 	int buff_size;
 
-	struct timespec ts_pre;
-	struct timespec ts_post;
-	struct timespec ts_exec;
+	PEXECTIME_DECLARE;
 
 	PDEBUG("executed.\n");
 
-	getnstimeofday(&ts_pre);
+	PEXECTIME_BEGIN();
 
 	if(copy_from_user(&karg, arg, sizeof(me_query_subdevice_caps_args_t)))
 	{
@@ -2296,10 +2248,430 @@ int me_query_subdevice_caps_args(struct file* filep, me_query_subdevice_caps_arg
 		err = -EFAULT;
 	}
 
-	getnstimeofday(&ts_post);
-	ts_exec = timespec_sub(ts_post, ts_pre);
+	PEXECTIME_END();
+
+	return err;
+}
+
+/// Topology snapshot built in one pass. Buffer grows when estimate was too small.
+typedef struct //me_topology_snapshot
+{
+	char* buffer;
+	unsigned int size;		// Allocated.
+	unsigned int offset;	// Used.
+	int err_no;
+} me_topology_snapshot_t;
 
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC);
+/// Estimate of one device's records. Real size is known only after querying device.
+# define ME_TOPOLOGY_ESTIMATE_DEVICE	(sizeof(me_topology_device_t) + 8 * (sizeof(me_topology_subdevice_t) + 8 * sizeof(me_topology_range_t)))
+
+/// Writes record at offset of snapshot. Record may be placed behind current end (see reserved subdevice records).
+static void me_topology_put(me_topology_snapshot_t* snapshot, unsigned int offset, const void* record, unsigned int record_size)
+{
+	char* buffer;
+	unsigned int size;
+
+	if (snapshot->err_no)
+		return;
+
+	if ((offset + record_size) > snapshot->size)
+	{
+		size = snapshot->size * 2;
+		if (size < offset + record_size)
+			size = offset + record_size;
+
+		buffer = vmalloc(size);
+		if (!buffer)
+		{
+			PERROR("Cannot get memory for topology snapshot.\n");
+			snapshot->err_no = -ENOMEM;
+			return;
+		}
+
+		if (snapshot->buffer)
+		{
+			memcpy(buffer, snapshot->buffer, snapshot->size);
+			vfree(snapshot->buffer);
+		}
+		snapshot->buffer = buffer;
+		snapshot->size = size;
+	}
+
+	memcpy(snapshot->buffer + offset, record, record_size);
+}
+
+static void me_topology_put_string(char* dest, const char* src, unsigned int count)
+{
+	if (src)
+	{
+		strncpy(dest, src, count - 1);
+		dest[count - 1] = '\0';
+	}
+}
+
+/// Serializes device's static information. Call under me_rwsem.
+static void me_topology_put_device(me_device_t* dev, me_topology_snapshot_t* snapshot)
+{
+	me_topology_device_t device;
+	me_topology_subdevice_t subdevice;
+	me_topology_range_t range;
+	unsigned int subdevice_offset;
+	char* str;
+	int number_subdevices = 0;
+	int number_ranges;
+	int base_frequency;
+	uint64_t min_ticks;
+	uint64_t max_ticks;
+	int s;
+	int r;
+	int t;
+	int err;
+
+	memset(&device, 0, sizeof(me_topology_device_t));
+
+	device.err_no = dev->me_device_query_info_device(dev,
+													&device.vendor_id,
+													&device.device_id,
+													&device.serial_no,
+													&device.bus_type,
+													&device.bus_no,
+													&device.dev_no,
+													&device.func_no,
+													&device.plugged);
+	if (!device.err_no)
+	{
+		device.err_no = dev->me_device_query_number_subdevices(dev, &number_subdevices);
+	}
+
+	if (!dev->me_device_query_name_device(dev, &str))
+	{
+		me_topology_put_string(device.name, str, ME_TOPOLOGY_NAME_COUNT);
+	}
+
+	if (!dev->me_device_query_description_device(dev, &str))
+	{
+		me_topology_put_string(device.description, str, ME_TOPOLOGY_DESCRIPTION_COUNT);
+	}
+
+	if (!dev->me_device_query_name_device_driver(dev, &str))
+	{
+		me_topology_put_string(device.driver_name, str, ME_TOPOLOGY_NAME_COUNT);
+	}
+
+	dev->me_device_query_version_device_driver(dev, &device.version);
+
+	device.number_subdevices = (device.err_no) ? 0 : number_subdevices;
+
+	me_topology_put(snapshot, snapshot->offset, &device, sizeof(me_topology_device_t));
+	snapshot->offset += sizeof(me_topology_device_t);
+
+	for (s = 0; s < device.number_subdevices; s++)
+	{
+		memset(&subdevice, 0, sizeof(me_topology_subdevice_t));
+
+		subdevice.err_no = dev->me_device_query_subdevice_type(dev, s, &subdevice.type, &subdevice.subtype);
+		if (!subdevice.err_no)
+		{
+			subdevice.err_no = dev->me_device_query_number_channels(dev, s, &subdevice.number_channels);
+		}
+
+		if (dev->me_device_query_subdevice_caps(dev, s, &subdevice.caps))
+		{
+			subdevice.caps = 0;
+		}
+
+		for (t = 0; t < ME_TOPOLOGY_TIMERS; t++)
+		{
+			min_ticks = 0;
+			max_ticks = 0;
+			base_frequency = 0;
+			subdevice.timer[t].err_no = dev->me_device_query_timer(dev, s, ME_TIMER_ACQ_START + t, &base_frequency, &min_ticks, &max_ticks);
+			subdevice.timer[t].base_frequency = base_frequency;
+			subdevice.timer[t].min_ticks_low = (unsigned int)(min_ticks & 0xFFFFFFFF);
+			subdevice.timer[t].min_ticks_high = (unsigned int)(min_ticks >> 32);
+			subdevice.timer[t].max_ticks_low = (unsigned int)(max_ticks & 0xFFFFFFFF);
+			subdevice.timer[t].max_ticks_high = (unsigned int)(max_ticks >> 32);
+		}
+
+		number_ranges = 0;
+		if (!subdevice.err_no)
+		{
+			err = dev->me_device_query_number_ranges(dev, s, ME_UNIT_ANY, &number_ranges);
+			if (err)
+			{
+				// Subdevices without ranges are not an error.
+				number_ranges = 0;
+				if (err != ME_ERRNO_NOT_SUPPORTED)
+				{
+					subdevice.err_no = err;
+				}
+			}
+		}
+
+		// Ranges follow subdevice. Record is written when the number of valid ranges is known.
+		subdevice_offset = snapshot->offset;
+		snapshot->offset += sizeof(me_topology_subdevice_t);
+
+		for (r = 0; r < number_ranges; r++)
+		{
+			memset(&range, 0, sizeof(me_topology_range_t));
+			err = dev->me_device_query_range_info(dev, s, r, &range.unit, &range.min, &range.max, &range.max_data);
+			if (err)
+			{
+				subdevice.err_no = err;
+				break;
+			}
+
+			me_topology_put(snapshot, snapshot->offset, &range, sizeof(me_topology_range_t));
+			snapshot->offset += sizeof(me_topology_range_t);
+		}
+		subdevice.number_ranges = r;
+
+		me_topology_put(snapshot, subdevice_offset, &subdevice, sizeof(me_topology_subdevice_t));
+	}
+}
+
+/// Serializes all devices in one pass. Every device is queried once. Call under me_rwsem.
+static void me_topology_put_all(me_topology_snapshot_t* snapshot)
+{
+	me_topology_header_t header;
+	struct list_head* pos;
+	me_device_t* dev;
+	unsigned int number_devices = 0;
+
+	list_for_each(pos, &me_device_list)
+	{
+		number_devices++;
+	}
+
+	snapshot->size = sizeof(me_topology_header_t) + number_devices * ME_TOPOLOGY_ESTIMATE_DEVICE;
+	snapshot->buffer = vmalloc(snapshot->size);
+	if (!snapshot->buffer)
+	{
+		PERROR("Cannot get memory for topology snapshot.\n");
+		snapshot->size = 0;
+		snapshot->err_no = -ENOMEM;
+		return;
+	}
+	snapshot->offset = sizeof(me_topology_header_t);
+
+	header.magic = ME_TOPOLOGY_MAGIC;
+	header.version = ME_TOPOLOGY_VERSION;
+	header.number_devices = 0;
+
+	list_for_each(pos, &me_device_list)
+	{
+		dev = list_entry(pos, me_device_t, list);
+		me_topology_put_device(dev, snapshot);
+		header.number_devices++;
+	}
+
+	header.size = snapshot->offset;
+	me_topology_put(snapshot, 0, &header, sizeof(me_topology_header_t));
+}
+
+int me_query_topology(struct file* filep, me_query_topology_t* arg)
+{
+	me_query_topology_t karg;
+	me_topology_snapshot_t snapshot;
+	int err = ME_ERRNO_SUCCESS;
+
+	PEXECTIME_DECLARE;
+
+	PDEBUG("executed.\n");
+
+	PEXECTIME_BEGIN();
+
+	if(copy_from_user(&karg, arg, sizeof(me_query_topology_t)))
+	{
+		PERROR("Can't copy arguments from user space\n");
+		return -EFAULT;
+	}
+
+	memset(&snapshot, 0, sizeof(me_topology_snapshot_t));
+
+	down_read(&me_rwsem);
+		me_topology_put_all(&snapshot);
+	up_read(&me_rwsem);
+
+	karg.err_no = snapshot.err_no;
+	if (!karg.err_no)
+	{
+		if (!karg.buffer || (karg.size < snapshot.offset))
+		{
+			PDEBUG("User buffer is to short. Snapshot needs %d bytes.\n", snapshot.offset);
+			karg.err_no = ME_ERRNO_USER_BUFFER_SIZE;
+		}
+		else if (copy_to_user(karg.buffer, snapshot.buffer, snapshot.offset))
+		{
+			PERROR("Cannot copy topology snapshot to user.\n");
+			err = -EFAULT;
+		}
+	}
+	karg.size = snapshot.offset;
+
+	if (snapshot.buffer)
+	{
+		vfree(snapshot.buffer);
+	}
+
+	if(copy_to_user(arg, &karg, sizeof(me_query_topology_t)))
+	{
+		PERROR("Can't copy arguments to user space\n");
+		err = -EFAULT;
+	}
+
+	PEXECTIME_END();
 
 	return err;
 }
+
+/// Statistics of subdevices in debugfs: <debugfs>/<driver name>/stats
+/// Reading lists all subdevices. Writing "<device> <subdevice>" resets one subdevice, anything else resets all.
+/// Writing "timing 1" starts measuring of ISR and stall durations ("timing 0" stops it). Off after load: clock is not read.
+static struct dentry* me_debugfs_dir = NULL;
+
+static int me_debugfs_stats_show(struct seq_file* m, void* v)
+{
+	struct list_head* pos;
+	me_device_t* dev;
+	me_subdevice_stats_t stats;
+	int number_subdevices;
+	int d = 0;
+	int s;
+
+	seq_printf(m, "%3s %3s %12s %10s %10s %14s %10s %12s %10s %14s\n",
+				"dev", "sub", "isr", "isr_min_ns", "isr_max_ns", "samples", "buffer_hwm", "task_wakeups", "overflows", "stall_ns");
+
+	down_read(&me_rwsem);
+		list_for_each(pos, &me_device_list)
+		{
+			dev = list_entry(pos, me_device_t, list);
+
+			if (dev->me_device_query_number_subdevices(dev, &number_subdevices))
+			{
+				number_subdevices = 0;
+			}
+
+			for (s = 0; s < number_subdevices; s++)
+			{
+				if (dev->me_device_query_stats(dev, s, &stats, ME_VALUE_NOT_USED))
+					continue;
+
+				seq_printf(m, "%3d %3d %12llu %10llu %10llu %14llu %10u %12llu %10llu %14llu\n",
+							d, s,
+							(unsigned long long)stats.isr_count,
+							(unsigned long long)stats.isr_time_min,
+							(unsigned long long)stats.isr_time_max,
+							(unsigned long long)stats.samples,
+							stats.buffer_hwm,
+							(unsigned long long)stats.task_wakeups,
+							(unsigned long long)stats.overflows,
+							(unsigned long long)stats.stall_time);
+			}
+			d++;
+		}
+	up_read(&me_rwsem);
+
+	return 0;
+}
+
+static int me_debugfs_stats_open(struct inode* inode_ptr, struct file* filep)
+{
+	return single_open(filep, me_debugfs_stats_show, NULL);
+}
+
+static ssize_t me_debugfs_stats_write(struct file* filep, const char __user* buf, size_t count, loff_t* ppos)
+{
+	char cmd[32];
+	size_t size = (count < sizeof(cmd) - 1) ? count : sizeof(cmd) - 1;
+	struct list_head* pos;
+	me_device_t* dev;
+	me_subdevice_stats_t stats;
+	int number_subdevices;
+	int device = -1;
+	int subdevice = -1;
+	int timing;
+	int flags = ME_SUBDEVICE_STATS_RESET;
+	int d = 0;
+	int s;
+
+	if (copy_from_user(cmd, buf, size))
+	{
+		return -EFAULT;
+	}
+	cmd[size] = '\0';
+
+	if (sscanf(cmd, "timing %d", &timing) == 1)
+	{// All subdevices. Counters are kept.
+		flags = (timing) ? ME_SUBDEVICE_STATS_TIMING_ON : ME_SUBDEVICE_STATS_TIMING_OFF;
+	}
+	else if (sscanf(cmd, "%d %d", &device, &subdevice) != 2)
+	{// Reset all.
+		device = -1;
+		subdevice = -1;
+	}
+
+	down_read(&me_rwsem);
+		list_for_each(pos, &me_device_list)
+		{
+			dev = list_entry(pos, me_device_t, list);
+
+			if ((device < 0) || (device == d))
+			{
+				if (dev->me_device_query_number_subdevices(dev, &number_subdevices))
+				{
+					number_subdevices = 0;
+				}
+
+				for (s = 0; s < number_subdevices; s++)
+				{
+					if ((subdevice < 0) || (subdevice == s))
+					{
+						dev->me_device_query_stats(dev, s, &stats, flags);
+					}
+				}
+			}
+			d++;
+		}
+	up_read(&me_rwsem);
+
+	return count;
+}
+
+static struct file_operations me_debugfs_stats_fops =
+{
+	.owner = THIS_MODULE,
+	.open = me_debugfs_stats_open,
+	.read = seq_read,
+	.write = me_debugfs_stats_write,
+	.llseek = seq_lseek,
+	.release = single_release
+};
+
+void me_debugfs_init(void)
+{
+	PDEBUG("executed.\n");
+
+	// Statistics are optional. Driver works without debugfs.
+	me_debugfs_dir = debugfs_create_dir(ME_NAME_DRIVER, NULL);
+	if (!me_debugfs_dir || IS_ERR(me_debugfs_dir))
+	{
+		PINFO("debugfs not available. No statistics exported.\n");
+		me_debugfs_dir = NULL;
+		return;
+	}
+
+	debugfs_create_file("stats", S_IRUGO | S_IWUSR, me_debugfs_dir, NULL, &me_debugfs_stats_fops);
+}
+
+void me_debugfs_exit(void)
+{
+	PDEBUG("executed.\n");
+
+	if (me_debugfs_dir)
+	{
+		debugfs_remove_recursive(me_debugfs_dir);
+		me_debugfs_dir = NULL;
+	}
+}
@@ -27,7 +27,7 @@
 
 #ifdef __KERNEL__
 
-# if !defined(ME_PCI) && !defined(ME_USB) && !defined(ME_MEPHISTO)
+# if !defined(ME_PCI) && !defined(ME_USB) && !defined(ME_MEPHISTO) && !defined(ME_VIRTUAL)
 #  error NO VALID DRIVER TYPE declared!
 # endif
 
@@ -58,9 +58,11 @@ extern struct list_head me_device_list;
 	me_device_t* find_device_on_list(struct NET2282_usb_device* n_device, int state);
 	#elif defined(ME_MEPHISTO)
 	me_device_t* find_device_on_list(struct mephisto_usb_device* n_device, int state);
+	#elif defined(ME_VIRTUAL)
+	me_device_t* find_device_on_list(struct virtual_local_dev* n_device, int state);
 	#else
 		//Only to mask parser warning.
-		#error neither ME_PCI, ME_USB nor ME_MEPHISTO defined!
+		#error neither ME_PCI, ME_USB, ME_MEPHISTO nor ME_VIRTUAL defined!
 	#endif
 
 	void insert_to_device_list(me_device_t *n_device);
@@ -103,6 +105,7 @@ extern struct list_head me_device_list;
 	int me_io_stream_start(struct file* filep, me_io_stream_start_t* arg);
 	int me_io_stream_stop(struct file* filep, me_io_stream_stop_t* arg);
 	int me_io_stream_status(struct file* filep, me_io_stream_status_t* arg);
+	int me_io_stream_reader(struct file* filep, me_io_stream_reader_t* arg);
 
 	int me_set_offset(struct file* filep, me_set_offset_t* arg);
 
@@ -133,8 +136,14 @@ extern struct list_head me_device_list;
 	int me_query_version_device_driver(struct file* filep, me_query_version_device_driver_t* arg);
 	int me_query_device_release(struct file* filep, me_query_device_release_t* arg);
 	int me_query_version_firmware(struct file* filep, me_query_version_firmware_t* arg);
+	int me_query_topology(struct file* filep, me_query_topology_t* arg);
+	int me_query_latency_probe(struct file* filep, me_query_latency_probe_t* arg);
 
 	int me_config_load(struct file* filep, me_extra_param_set_t* arg);
 
+	//STATISTICS (debugfs)
+	void me_debugfs_init(void);
+	void me_debugfs_exit(void);
+
 # endif	//_MEMAIN_COMMON_H_
 #endif	//__KERNEL__
@@ -30,13 +30,11 @@ int CALL(struct file* filep, TYPE *arg){	\
 	me_device_t* dev = NULL; \
 	TYPE karg; \
 	int err = ME_ERRNO_SUCCESS; \
-	struct timespec ts_pre; \
-	struct timespec ts_post; \
-	struct timespec ts_exec; \
+	PEXECTIME_DECLARE; \
 	\
 	PDEBUG("executed.\n"); \
 	\
-	getnstimeofday(&ts_pre); \
+	PEXECTIME_BEGIN(); \
 	\
 	if(copy_from_user(&karg, arg, sizeof(TYPE))){ \
 		PERROR("Can't copy arguments to kernel space\n"); \
@@ -72,10 +70,7 @@ int CALL(struct file* filep, TYPE *arg){	\
 		err = -EFAULT; \
 	} \
 	\
-	getnstimeofday(&ts_post); \
-	ts_exec = timespec_sub(ts_post, ts_pre); \
-	\
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC); \
+	PEXECTIME_END(); \
 	\
 	return err; \
 }
@@ -88,13 +83,11 @@ int CALL(struct file* filep, TYPE *arg){	\
 	TYPE karg;	\
 	int err = ME_ERRNO_SUCCESS; \
 	\
-	struct timespec ts_pre; \
-	struct timespec ts_post; \
-	struct timespec ts_exec; \
+	PEXECTIME_DECLARE; \
 	\
 	PDEBUG("executed.\n"); \
 	\
-	getnstimeofday(&ts_pre); \
+	PEXECTIME_BEGIN(); \
 	\
 	if(copy_from_user(&karg, arg, sizeof(TYPE))){	\
 		PERROR("Can't copy arguments to kernel space\n");	\
@@ -134,10 +127,7 @@ int CALL(struct file* filep, TYPE *arg){	\
 		}	\
 	} \
 	\
-	getnstimeofday(&ts_post); \
-	ts_exec = timespec_sub(ts_post, ts_pre); \
-	\
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC); \
+	PEXECTIME_END(); \
 	\
 	return err;	\
 }
@@ -150,13 +140,11 @@ int CALL(struct file* filep, TYPE *arg){	\
 	TYPE karg;	\
 	int err = ME_ERRNO_SUCCESS; \
 		\
-	struct timespec ts_pre; \
-	struct timespec ts_post; \
-	struct timespec ts_exec; \
+	PEXECTIME_DECLARE; \
 	\
 	PDEBUG("executed.\n"); \
 	\
-	getnstimeofday(&ts_pre); \
+	PEXECTIME_BEGIN(); \
 	 \
 	if(copy_from_user(&karg, arg, sizeof(TYPE)))	\
 	{	\
@@ -178,10 +166,7 @@ int CALL(struct file* filep, TYPE *arg){	\
 		err = -EFAULT;	\
 	}	\
 	\
-	getnstimeofday(&ts_post); \
-	ts_exec = timespec_sub(ts_post, ts_pre); \
-	\
-	PEXECTIME("executed in %ld us\n", ts_exec.tv_nsec / NSEC_PER_USEC + ts_exec.tv_sec * USEC_PER_SEC); \
+	PEXECTIME_END(); \
 	\
 	return err;	\
 }
@@ -56,6 +56,11 @@
 # include "mephisto.h"
 # include "mephisto_device.h"
 
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM mephisto
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
 ///Globals
 struct file* me_filep = NULL;
 int me_count = 0;
@@ -303,6 +308,9 @@ static int __init mephisto_init(void)
 #endif
 								ME_NAME_NODE);
 
+	// Export statistics.
+	me_debugfs_init();
+
 	return 0;
 
 INIT_ERROR_5:
@@ -324,6 +332,8 @@ static void __exit mephisto_exit(void)
 
  	PDEBUG("executed.\n");
 
+	me_debugfs_exit();
+
 	// Remove all instances.
 	clear_device_list();
 
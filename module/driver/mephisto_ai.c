@@ -1049,6 +1049,7 @@ static int inline mephisto_ai_io_stream_read_get_value(mephisto_ai_subdevice_t*
 			return -ME_ERRNO_INTERNAL;
 		}
 	}
+	trace_me_seg_buf_get(instance, instance->base.idx, n, me_seg_buf_values(instance->seg_buf));
 	return n;
 }
 
@@ -1087,6 +1088,7 @@ int mephisto_ai_io_stream_read(me_subdevice_t* subdevice, struct file* filep, in
 	int ret;
 	unsigned long int delay = LONG_MAX - 2;
 	unsigned long int j;
+	uint64_t stall;
 	int err = ME_ERRNO_SUCCESS;
 
 	int c = *count;
@@ -1161,10 +1163,12 @@ int mephisto_ai_io_stream_read(me_subdevice_t* subdevice, struct file* filep, in
 			if ((me_seg_buf_values(instance->seg_buf) < min) && (read_mode == ME_READ_MODE_BLOCKING))
 			{
 				j = jiffies;
+				stall = me_subdevice_stats_time(&instance->base);
 				wait_event_interruptible_timeout(
 					instance->wait_queue,
 					((me_seg_buf_values(instance->seg_buf) >= min) || (*instance->status < MEPHISTO_AI_STATUS_start)),
 					delay);
+				me_subdevice_stats_stall(&instance->base, stall);
 
 				if (signal_pending(current))
 				{
@@ -1932,6 +1936,8 @@ void mephisto_stream(
 	unsigned long long int stream_start;
 
 	unsigned int signal_event;
+	unsigned int data_recived;
+	int overflow;
 
 	uint64_t data_required;
 
@@ -2058,6 +2064,11 @@ void mephisto_stream(
 		down(instance->device_semaphore);
 			if (ret_val == USB_PACKET_RECIVED)
 			{
+				// Stream task has no interrupt. Every packet is counted as wake-up.
+				me_subdevice_stats_task(&instance->base);
+				data_recived = instance->data_recived;
+				overflow = 0;
+
 				signals_count = instance->data_recived - ((instance->threshold > 0) ? (instance->data_recived % instance->threshold) : (instance->data_recived % 1000));
 				//Copy results to buffer.
 				for (i=1; i<count; ++i)
@@ -2069,7 +2080,10 @@ void mephisto_stream(
 					if (instance->range[recived % 2] >= 0)
 					{
 						down(&instance->buffer_semaphore);
-							me_seg_buf_put(instance->seg_buf, buf[i]);
+							if (me_seg_buf_put(instance->seg_buf, buf[i]))
+							{
+								overflow = 1;
+							}
 							++instance->data_recived;
 						up(&instance->buffer_semaphore);
 					}
@@ -2103,6 +2117,13 @@ void mephisto_stream(
 					}
 				}
 
+				me_subdevice_stats_samples(&instance->base, instance->data_recived - data_recived, me_seg_buf_values(instance->seg_buf));
+				trace_me_seg_buf_put(instance, instance->base.idx, instance->data_recived - data_recived, me_seg_buf_values(instance->seg_buf));
+				if (overflow)
+				{
+					me_subdevice_stats_overflow(&instance->base);
+				}
+
 				if (*instance->status == MEPHISTO_AI_STATUS_start)
 				{
 					*instance->status = MEPHISTO_AI_STATUS_run;
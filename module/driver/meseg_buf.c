@@ -186,6 +186,40 @@ int inline me_seg_buf_get(me_seg_buf_t* const buf, uint16_t* const value)
 	return ME_ERRNO_SUCCESS;
 }
 
+/// Values from cursor ('values' behind head) to end of its frame. Whole frame, when cursor is on frame boundary.
+static unsigned int inline me_seg_buf_frame_rest(me_seg_buf_t* const buf, const unsigned int values)
+{
+	unsigned int pos;
+
+	if (buf->frame_size <= 1)
+		return 1;
+
+	pos = (buf->head_frame_pos + buf->frame_size - (values % buf->frame_size)) % buf->frame_size;
+	return buf->frame_size - pos;
+}
+
+/// Ring mode: overwrite oldest frame (or rest of frame already partially read).
+static void inline me_seg_buf_drop(me_seg_buf_t* const buf)
+{
+	unsigned int count;
+	unsigned int offset;
+
+	count = me_seg_buf_frame_rest(buf, buf->header.values_count);
+	if (count > buf->header.values_count)
+		count = buf->header.values_count;
+
+	offset = buf->header.tail.offset + count;
+	buf->header.tail.chunk = (buf->header.tail.chunk + offset / buf->header.chunk_size) % buf->chunks_count;
+	buf->header.tail.offset = offset % buf->header.chunk_size;
+
+	buf->header.values_count -= count;
+	buf->header.reads_count += count;
+
+	buf->gap += count;
+	buf->dropped += count;
+	PDEBUG_BUF("Ring mode: %u values dropped.\n", count);
+}
+
 int inline me_seg_buf_put(me_seg_buf_t* const buf, const uint16_t value)
 {
 	uint16_t* addr;
@@ -200,8 +234,12 @@ int inline me_seg_buf_put(me_seg_buf_t* const buf, const uint16_t value)
 
 	if (buf->header.values_count == buf->header.total_size)
 	{
-		PERROR("ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW (%d values in buffer)\n", buf->header.values_count);
-		return ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
+		if (!buf->ring)
+		{
+			PERROR("ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW (%d values in buffer)\n", buf->header.values_count);
+			return ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
+		}
+		me_seg_buf_drop(buf);
 	}
 
 	PDEBUG_BUF("PUT segment: %u(%p) offset: %u <= 0x%04x\n", buf->header.head.chunk, buf->buffers[buf->header.head.chunk].segment, buf->header.head.offset, value);
@@ -221,6 +259,15 @@ int inline me_seg_buf_put(me_seg_buf_t* const buf, const uint16_t value)
 	++buf->header.values_count;
 
 	++buf->header.writes_count;
+
+	if (buf->frame_size)
+	{
+		++buf->head_frame_pos;
+		if (buf->head_frame_pos == buf->frame_size)
+		{
+			buf->head_frame_pos = 0;
+		}
+	}
 	return ME_ERRNO_SUCCESS;
 }
 
@@ -240,6 +287,13 @@ int inline me_seg_buf_unget(me_seg_buf_t* const buf)
 		return ME_ERRNO_INTERNAL;
 	}
 
+	// Frame position and readers' drops can not be rolled back.
+	if (buf->frame_size || buf->readers_count)
+	{
+		PERROR("Unget not allowed with frames or readers.\n");
+		return ME_ERRNO_INTERNAL;
+	}
+
 	if (buf->header.head.offset)
 	{
 		--buf->header.head.offset;
@@ -366,3 +420,277 @@ int inline me_seg_buf_read(me_seg_buf_t* const buf, unsigned int pos, uint16_t*
 
 	return ME_ERRNO_SUCCESS;
 }
+
+static void inline me_seg_buf_reader_skip(me_seg_buf_t* const buf, me_seg_buf_reader_t* const reader, const unsigned int count)
+{
+	unsigned int offset;
+
+	offset = reader->tail.offset + count;
+	reader->tail.chunk = (reader->tail.chunk + offset / buf->header.chunk_size) % buf->chunks_count;
+	reader->tail.offset = offset % buf->header.chunk_size;
+
+	reader->reads_count += count;
+}
+
+unsigned int me_seg_buf_readers_space(me_seg_buf_t* const buf)
+{
+	unsigned int idx;
+	unsigned int values;
+	unsigned int used = buf->header.values_count;
+	me_seg_buf_reader_t* reader;
+
+	// Only blocking readers hold producer.
+	for (idx=0; idx<ME_SEG_BUF_READERS_MAX; ++idx)
+	{
+		reader = &buf->readers[idx];
+		if (!reader->owner || reader->detached || (reader->policy != ME_IO_STREAM_READER_POLICY_BLOCK))
+			continue;
+
+		values = me_seg_buf_reader_values(buf, reader);
+		if (values > used)
+			used = values;
+	}
+
+	return buf->header.total_size - used;
+}
+
+int me_seg_buf_readers_reserve(me_seg_buf_t* const buf, const unsigned int count)
+{
+	unsigned int idx;
+	unsigned int values;
+	unsigned int skip;
+	me_seg_buf_reader_t* reader;
+
+	// Blocking readers first. Nobody loses anything, when there is no place for new values.
+	// In ring mode nobody holds producer.
+	for (idx=0; (idx<ME_SEG_BUF_READERS_MAX) && !buf->ring; ++idx)
+	{
+		reader = &buf->readers[idx];
+		if (!reader->owner || reader->detached || (reader->policy != ME_IO_STREAM_READER_POLICY_BLOCK))
+			continue;
+
+		if (me_seg_buf_reader_values(buf, reader) + count > buf->header.total_size)
+			return ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
+	}
+
+	for (idx=0; idx<ME_SEG_BUF_READERS_MAX; ++idx)
+	{
+		reader = &buf->readers[idx];
+		if (!reader->owner || reader->detached)
+			continue;
+
+		values = me_seg_buf_reader_values(buf, reader);
+		if (values + count <= buf->header.total_size)
+			continue;
+
+		switch (reader->policy)
+		{
+			case ME_IO_STREAM_READER_POLICY_BLOCK:
+			case ME_IO_STREAM_READER_POLICY_DROP:
+				// Oldest frames are lost for this reader.
+				while (values + count > buf->header.total_size)
+				{
+					skip = me_seg_buf_frame_rest(buf, values);
+					if (skip > values)
+						skip = values;
+
+					me_seg_buf_reader_skip(buf, reader, skip);
+					reader->dropped += skip;
+					reader->gap += skip;
+					values -= skip;
+				}
+				break;
+
+			case ME_IO_STREAM_READER_POLICY_DETACH:
+				PDEBUG_BUF("Reader %p too slow. Detached.\n", reader->owner);
+				reader->detached = ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+me_seg_buf_reader_t* me_seg_buf_reader_find(me_seg_buf_t* const buf, void* owner)
+{
+	unsigned int idx;
+
+	if (!buf || !owner || !buf->readers_count)
+		return NULL;
+
+	for (idx=0; idx<ME_SEG_BUF_READERS_MAX; ++idx)
+	{
+		if (buf->readers[idx].owner == owner)
+			return &buf->readers[idx];
+	}
+
+	return NULL;
+}
+
+int me_seg_buf_reader_attach(me_seg_buf_t* const buf, void* owner, int policy)
+{
+	unsigned int idx;
+	unsigned int back;
+	unsigned int pos;
+	me_seg_buf_reader_t* reader = NULL;
+
+	PDEBUG_BUF("executed.\n");
+
+	if (!buf || !owner)
+	{
+		PERROR("buf == NULL\n");
+		return ME_ERRNO_INVALID_POINTER;
+	}
+
+	if (me_seg_buf_reader_find(buf, owner))
+	{
+		PERROR("Reader %p is already attached.\n", owner);
+		return ME_ERRNO_USED;
+	}
+
+	for (idx=0; idx<ME_SEG_BUF_READERS_MAX; ++idx)
+	{
+		if (!buf->readers[idx].owner)
+		{
+			reader = &buf->readers[idx];
+			break;
+		}
+	}
+
+	if (!reader)
+	{
+		PERROR("No free slot for reader. %d readers attached.\n", ME_SEG_BUF_READERS_MAX);
+		return ME_ERRNO_LACK_OF_RESOURCES;
+	}
+
+	// Reader is rewound to begin of frame being written (head_frame_pos values back), so its first value is frame's first channel.
+	// Values of this frame written before attach are seen too. No rewind, when they are not in buffer any more.
+	back = 0;
+	if ((buf->head_frame_pos <= buf->header.writes_count) && (buf->head_frame_pos < buf->header.total_size))
+	{
+		back = buf->head_frame_pos;
+	}
+	pos = (buf->header.head.chunk * buf->header.chunk_size + buf->header.head.offset + buf->header.total_size - back) % buf->header.total_size;
+
+	reader->policy = policy;
+	reader->detached = 0;
+	reader->dropped = 0;
+	reader->gap = 0;
+	reader->tail.chunk = pos / buf->header.chunk_size;
+	reader->tail.offset = pos % buf->header.chunk_size;
+	reader->reads_count = buf->header.writes_count - back;
+	reader->owner = owner;
+
+	++buf->readers_count;
+	PDEBUG_BUF("Reader %p attached. %d readers.\n", owner, buf->readers_count);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+unsigned int me_seg_buf_reader_detach(me_seg_buf_t* const buf, me_seg_buf_reader_t* const reader)
+{
+	PDEBUG_BUF("executed.\n");
+
+	if (!buf || !reader || !reader->owner)
+	{
+		return 0;
+	}
+
+	reader->owner = NULL;
+	--buf->readers_count;
+	PDEBUG_BUF("Reader detached. %d readers.\n", buf->readers_count);
+
+	return reader->dropped;
+}
+
+int inline me_seg_buf_reader_get(me_seg_buf_t* const buf, me_seg_buf_reader_t* const reader, uint16_t* const value)
+{
+	uint16_t* volatile addr;
+
+	PDEBUG_BUF("executed.\n");
+
+	if (!buf || !reader)
+	{
+		PERROR("buf == NULL\n");
+		return ME_ERRNO_INVALID_POINTER;
+	}
+
+	if (!value)
+	{
+		PERROR("value == NULL\n");
+		return ME_ERRNO_INVALID_POINTER;
+	}
+
+	if (!me_seg_buf_reader_values(buf, reader))
+	{
+		PERROR("ME_ERRNO_SOFTWARE_BUFFER_UNDERFLOW\n");
+		*value = 0x0000;
+		return ME_ERRNO_SOFTWARE_BUFFER_UNDERFLOW;
+	}
+
+	addr = buf->buffers[reader->tail.chunk].segment + reader->tail.offset;
+	*value = *addr;
+	PDEBUG_BUF("READER GET segment: %u(%p) offset: %u => 0x%04x\n", reader->tail.chunk, buf->buffers[reader->tail.chunk].segment, reader->tail.offset, *addr);
+	++reader->tail.offset;
+	if (reader->tail.offset == buf->header.chunk_size)
+	{
+		reader->tail.offset = 0;
+		++reader->tail.chunk;
+		if (reader->tail.chunk == buf->chunks_count)
+		{
+			reader->tail.chunk = 0;
+		}
+	}
+
+	++reader->reads_count;
+	return ME_ERRNO_SUCCESS;
+}
+
+void me_seg_buf_readers_inherit(me_seg_buf_t* const buf, me_seg_buf_t* const old)
+{
+	unsigned int idx;
+
+	PDEBUG_BUF("executed.\n");
+
+	if (!buf || !old)
+	{
+		return;
+	}
+
+	// New buffer is empty. Readers start at its begin.
+	for (idx=0; idx<ME_SEG_BUF_READERS_MAX; ++idx)
+	{
+		buf->readers[idx].owner = old->readers[idx].owner;
+		buf->readers[idx].policy = old->readers[idx].policy;
+		buf->readers[idx].detached = old->readers[idx].detached;
+		buf->readers[idx].dropped = old->readers[idx].dropped;
+	}
+	buf->readers_count = old->readers_count;
+
+	buf->frame_size = old->frame_size;
+	buf->ring = old->ring;
+}
+
+void me_seg_buf_readers_abort(me_seg_buf_t* const buf, int err)
+{
+	unsigned int idx;
+
+	PDEBUG_BUF("executed.\n");
+
+	if (!buf)
+	{
+		return;
+	}
+
+	for (idx=0; idx<ME_SEG_BUF_READERS_MAX; ++idx)
+	{
+		if (buf->readers[idx].owner && !buf->readers[idx].detached)
+		{
+			PDEBUG_BUF("Reader %p detached. Error %d.\n", buf->readers[idx].owner, err);
+			buf->readers[idx].detached = err;
+		}
+	}
+}
@@ -29,6 +29,7 @@
 # ifndef _MESEG_BUF_H_
 #  define _MESEG_BUF_H_
 
+#  include "me_error.h"
 
 typedef struct
 {
@@ -59,14 +60,64 @@ typedef struct
 	chunk_addr_t volatile tail;
 } me_seg_buf_header_t;
 
+/// Number of readers, which can be attached to buffer beside stream's owner.
+#  define ME_SEG_BUF_READERS_MAX	4
+
+/// Additional reader with own cursor. Reader sees values from begin of frame being written at attach.
+typedef struct
+{
+	// file handle of reader (NULL: free slot)
+	void* owner;
+	// ME_IO_STREAM_READER_POLICY_*: what happens, when producer needs reader's values
+	int policy;
+	// error reported to reader on next read, when reader was detached by producer (too slow) or by failed buffer resize. 0: attached
+	int volatile detached;
+
+	// number of values read. Reader's values are header.writes_count - reads_count.
+	unsigned int volatile reads_count;
+	// number of values lost by reader (ME_IO_STREAM_READER_POLICY_DROP)
+	unsigned int volatile dropped;
+	// values lost before reader's next value, not reported yet
+	unsigned int volatile gap;
+
+	chunk_addr_t volatile tail;
+} me_seg_buf_reader_t;
+
 typedef struct
 {
 	me_seg_buf_header_t volatile header;
 	//number of chunk size in number of values
 	unsigned int chunks_count;
 	single_chunk_t* buffers;
+
+	//number of attached readers
+	unsigned int volatile readers_count;
+	me_seg_buf_reader_t readers[ME_SEG_BUF_READERS_MAX];
+
+	//number of values in frame (channel list). Values are dropped only as whole frames.
+	unsigned int frame_size;
+	//position of head in frame
+	unsigned int volatile head_frame_pos;
+	//ring mode ("flight recorder"): oldest frames are overwritten instead of overflow
+	int ring;
+	//values lost before tail, not reported yet
+	unsigned int volatile gap;
+	//number of values lost in ring mode
+	unsigned int volatile dropped;
 } me_seg_buf_t;
 
+/// Space left, when readers are attached.
+unsigned int me_seg_buf_readers_space(me_seg_buf_t* const buf);
+/// Makes place for 'count' new values. Readers too slow for it lose their oldest values or are detached.
+/// Returns ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW, when blocking reader has no place.
+int me_seg_buf_readers_reserve(me_seg_buf_t* const buf, const unsigned int count);
+
+/// Producer calls it once per batch, before putting 'count' values. Nothing to do without readers.
+static int inline me_seg_buf_reserve(me_seg_buf_t* const buf, const unsigned int count)
+{
+	return (buf->readers_count) ? me_seg_buf_readers_reserve(buf, count) : ME_ERRNO_SUCCESS;
+}
+
 
 /// How many values is in buffer.
 static unsigned int inline me_seg_buf_size(me_seg_buf_t* const buf)
@@ -83,11 +134,26 @@ static unsigned int inline me_seg_buf_values(me_seg_buf_t* const buf)
 /// How many space left.
 static unsigned int inline me_seg_buf_space(me_seg_buf_t* const buf)
 {
+	// Producer never runs out of space in ring mode.
+	if (buf->ring)
+		return buf->header.total_size;
+
+	if (buf->readers_count)
+		return me_seg_buf_readers_space(buf);
+
 	return buf->header.total_size - buf->header.values_count;
 }
 
+/// How many values is in buffer for reader.
+static unsigned int inline me_seg_buf_reader_values(me_seg_buf_t* const buf, me_seg_buf_reader_t* const reader)
+{
+	return buf->header.writes_count - reader->reads_count;
+}
+
 static void inline me_seg_buf_reset(me_seg_buf_t* const buf)
 {
+	unsigned int idx;
+
 	buf->header.head.chunk = 0;
 	buf->header.head.offset = 0;
 	buf->header.tail.chunk = 0;
@@ -96,6 +162,42 @@ static void inline me_seg_buf_reset(me_seg_buf_t* const buf)
 
 	buf->header.reads_count = 0;
 	buf->header.writes_count = 0;
+
+	buf->head_frame_pos = 0;
+	buf->gap = 0;
+	buf->dropped = 0;
+
+	// Attached readers start again with buffer.
+	for (idx=0; idx<ME_SEG_BUF_READERS_MAX; ++idx)
+	{
+		buf->readers[idx].tail.chunk = 0;
+		buf->readers[idx].tail.offset = 0;
+		buf->readers[idx].reads_count = 0;
+		buf->readers[idx].gap = 0;
+	}
+}
+
+/// Set frame size (0: no frames) and ring mode. Only for idle buffer.
+static void inline me_seg_buf_set_mode(me_seg_buf_t* const buf, const unsigned int frame_size, const int ring)
+{
+	buf->frame_size = frame_size;
+	buf->ring = ring;
+	buf->head_frame_pos = 0;
+}
+
+/// Values lost before next value of cursor (reader or, when NULL, tail).
+static unsigned int inline me_seg_buf_gap(me_seg_buf_t* const buf, me_seg_buf_reader_t* const reader)
+{
+	return (reader) ? reader->gap : buf->gap;
+}
+
+/// Gap was reported to user.
+static void inline me_seg_buf_gap_clear(me_seg_buf_t* const buf, me_seg_buf_reader_t* const reader)
+{
+	if (reader)
+		reader->gap = 0;
+	else
+		buf->gap = 0;
 }
 
 
@@ -107,14 +209,27 @@ void destroy_seg_buffer(me_seg_buf_t** buf_ptr);
 
 /// Remove value from buffer
 int inline me_seg_buf_get(me_seg_buf_t* const buf, uint16_t* const value);
-/// Add value to buffer
+/// Add value to buffer. Place for readers is made by me_seg_buf_reserve().
 int inline me_seg_buf_put(me_seg_buf_t* const buf, const uint16_t value);
-/// Remove last value from buffer.
+/// Remove last value from buffer. Not allowed with frames or readers.
 int inline me_seg_buf_unget(me_seg_buf_t* const buf);
 /// Wraparound. Read value and move it from head to tail
 int inline me_seg_buf_rotate(me_seg_buf_t* const buf, uint16_t* const value);
 
 int inline me_seg_buf_read(me_seg_buf_t* const buf, unsigned int pos, uint16_t* const value);
 
+/// Attach reader (file handle) to buffer.
+int me_seg_buf_reader_attach(me_seg_buf_t* const buf, void* owner, int policy);
+/// Detach reader. Returns number of values lost by reader.
+unsigned int me_seg_buf_reader_detach(me_seg_buf_t* const buf, me_seg_buf_reader_t* const reader);
+/// Find reader attached by file handle. NULL when this handle is not a reader.
+me_seg_buf_reader_t* me_seg_buf_reader_find(me_seg_buf_t* const buf, void* owner);
+/// Remove value from buffer for reader.
+int inline me_seg_buf_reader_get(me_seg_buf_t* const buf, me_seg_buf_reader_t* const reader, uint16_t* const value);
+/// Move attached readers and mode from old buffer to new one (buffer resize).
+void me_seg_buf_readers_inherit(me_seg_buf_t* const buf, me_seg_buf_t* const old);
+/// Detach all attached readers. 'err' is returned to each of them on next read. Slots are freed by reader's detach or close.
+void me_seg_buf_readers_abort(me_seg_buf_t* const buf, int err);
+
 # endif	//_MESEG_BUF_H_
 #endif	//__KERNEL__
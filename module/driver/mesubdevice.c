@@ -239,6 +239,19 @@ static int me_subdevice_io_stream_write(
 }
 
 
+static int me_subdevice_io_stream_reader(
+    me_subdevice_t* subdevice,
+    struct file* filep,
+    int mode,
+    int policy,
+    int* dropped,
+    int flags)
+{
+	PDEBUG("executed.\n");
+	return ME_ERRNO_NOT_SUPPORTED;
+}
+
+
 static int me_subdevice_set_offset(struct me_subdevice* subdevice, struct file* filep,
 		   								int channel, int range, int* offset, int flags)
 {
@@ -389,6 +402,18 @@ int me_subdevice_init(me_subdevice_t* subdevice)
 	// Init list head
 	INIT_LIST_HEAD(&subdevice->list);
 
+	memset(&subdevice->probe, 0, sizeof(me_latency_probe_t));
+	seqlock_init(&subdevice->probe.lock);
+
+	// Statistics are optional. Without them subdevice works as before.
+	subdevice->stats = alloc_percpu(me_subdevice_cpu_stats_t);
+	atomic_set(&subdevice->stats_generation, 0);
+	subdevice->stats_timing = 0;
+	if (!subdevice->stats)
+	{
+		PERROR("Cannot get memory for statistics.\n");
+	}
+
 	// Initialize the subdevice lock instance
 	err = me_slock_init(&subdevice->lock);
 	if (err)
@@ -413,6 +438,7 @@ int me_subdevice_init(me_subdevice_t* subdevice)
 		subdevice->me_subdevice_io_stream_status = me_subdevice_io_stream_status;
 		subdevice->me_subdevice_io_stream_stop = me_subdevice_io_stream_stop;
 		subdevice->me_subdevice_io_stream_write = me_subdevice_io_stream_write;
+		subdevice->me_subdevice_io_stream_reader = me_subdevice_io_stream_reader;
 		subdevice->me_subdevice_lock_subdevice = me_subdevice_lock_subdevice;
 		subdevice->me_subdevice_query_number_channels = me_subdevice_query_number_channels;
 		subdevice->me_subdevice_query_number_ranges = me_subdevice_query_number_ranges;
@@ -464,4 +490,53 @@ void me_subdevice_deinit(me_subdevice_t* subdevice)
 	{
 		me_slock_deinit(&subdevice->lock);
 	}
+
+	if (subdevice && subdevice->stats)
+	{
+		free_percpu(subdevice->stats);
+		subdevice->stats = NULL;
+	}
+}
+
+void me_subdevice_stats_read(me_subdevice_t* subdevice, me_subdevice_stats_t* stats, int flags)
+{
+	me_subdevice_cpu_stats_t* cpu_stats;
+	int generation;
+	int cpu;
+
+	memset(stats, 0, sizeof(me_subdevice_stats_t));
+
+	if (!subdevice->stats)
+		return;
+
+	generation = atomic_read(&subdevice->stats_generation);
+	for_each_possible_cpu(cpu)
+	{
+		cpu_stats = per_cpu_ptr(subdevice->stats, cpu);
+
+		// Cpu has not updated its counters since last reset.
+		if (cpu_stats->generation != generation)
+			continue;
+
+		stats->isr_count += cpu_stats->values.isr_count;
+		if (cpu_stats->values.isr_time_min && (!stats->isr_time_min || (cpu_stats->values.isr_time_min < stats->isr_time_min)))
+			stats->isr_time_min = cpu_stats->values.isr_time_min;
+		if (cpu_stats->values.isr_time_max > stats->isr_time_max)
+			stats->isr_time_max = cpu_stats->values.isr_time_max;
+		stats->samples += cpu_stats->values.samples;
+		stats->task_wakeups += cpu_stats->values.task_wakeups;
+		stats->overflows += cpu_stats->values.overflows;
+		stats->stall_time += cpu_stats->values.stall_time;
+		if (cpu_stats->values.buffer_hwm > stats->buffer_hwm)
+			stats->buffer_hwm = cpu_stats->values.buffer_hwm;
+	}
+
+	// Counters of other cpus are never written from here. Each cpu clears its own counters on next update.
+	if (flags & ME_SUBDEVICE_STATS_RESET)
+		atomic_inc(&subdevice->stats_generation);
+
+	if (flags & ME_SUBDEVICE_STATS_TIMING_ON)
+		subdevice->stats_timing = 1;
+	else if (flags & ME_SUBDEVICE_STATS_TIMING_OFF)
+		subdevice->stats_timing = 0;
 }
@@ -34,10 +34,14 @@
 #  include "me_types.h"
 #  include "me_ioctl.h"
 #  include "meslock.h"
+#  include "me_trace.h"
 
 #  include <linux/fs.h>
 #  include <linux/list.h>
 #  include <linux/workqueue.h>
+#  include <linux/hrtimer.h>
+#  include <linux/percpu.h>
+#  include <linux/seqlock.h>
 #  include <asm/atomic.h>
 
 #if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,27)
@@ -119,6 +123,68 @@ typedef struct// subdevice_protector
 
 } subdevice_protector_t;
 
+/**
+ * @brief Time stamps for end-to-end latency measurement (ME_QUERY_LATENCY_PROBE).
+ * Set by output's single write, interrupt handler and irq wait. Taking a stamp costs one read of monotonic clock.
+ * Writers come from process and interrupt context, so stamps are only accessed through me_latency_probe_*() helpers.
+ */
+typedef struct //me_latency_probe
+{
+	seqlock_t lock;				/**< 64-bit stamps can not be read in one access on 32-bit machines. */
+	uint64_t write_time;
+	uint64_t irq_time;
+	uint64_t wake_time;
+	int irq_count;
+} me_latency_probe_t;
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in ns. Same clock as clock_gettime(CLOCK_MONOTONIC) in user space.
+ */
+static inline uint64_t me_latency_probe_time(void)
+{
+#  if LINUX_VERSION_CODE >= KERNEL_VERSION(3,17,0)
+	return ktime_get_ns();
+#  else
+	struct timespec ts;
+
+	ktime_get_ts(&ts);
+	return timespec_to_ns(&ts);
+#  endif
+}
+
+#  ifndef __percpu
+#   define __percpu
+#  endif
+
+#  ifndef this_cpu_ptr
+#   define this_cpu_ptr(ptr) per_cpu_ptr(ptr, smp_processor_id())
+#  endif
+
+/**
+ * @brief Runtime statistics of subdevice. Kept per cpu and summed up on read (debugfs file <driver>/stats).
+ * Durations are in ns. Zero 'isr_time_min' means 'not measured yet'.
+ */
+typedef struct //me_subdevice_stats
+{
+	uint64_t isr_count;			/**< Interrupts handled by subdevice. */
+	uint64_t isr_time_min;
+	uint64_t isr_time_max;
+	uint64_t samples;			/**< Values moved between hardware FIFO and software buffer. */
+	uint64_t task_wakeups;		/**< Runs of control task. */
+	uint64_t overflows;			/**< Hardware FIFO or software buffer overflows (underflows of output). */
+	uint64_t stall_time;		/**< Time spent by readers/writers waiting for values/space. */
+	unsigned int buffer_hwm;	/**< Highest fill level of software buffer. */
+} me_subdevice_stats_t;
+
+/**
+ * @brief Statistics of one cpu. Values of older generation are stale (reset was requested) and cleared on next update.
+ */
+typedef struct //me_subdevice_cpu_stats
+{
+	me_subdevice_stats_t values;
+	int generation;
+} me_subdevice_cpu_stats_t;
+
 /**
  * @brief The subdevice base class.
  */
@@ -131,6 +197,10 @@ typedef struct me_subdevice
 	struct list_head list;		/**< Enables the subdevice to be added to a dynamic list. */
 	me_slock_t lock;			/**< Used by user application in order to lock the subdevice for exclusive usage. */
 	subdevice_protector_t subdevice_lock;	/**< Interrupt blocking lock structure to protect interrupt handler. */
+	me_latency_probe_t probe;	/**< Time stamps of last write, interrupt and wake-up. */
+	me_subdevice_cpu_stats_t __percpu* stats;	/**< Runtime statistics. NULL when allocation failed. */
+	atomic_t stats_generation;	/**< Incremented by reset. */
+	int stats_timing;			/**< Measure durations of ISR and stalls. Off by default: counters only, no clock reads. */
 
 	// Methods
 	int (*me_subdevice_io_irq_start)(struct me_subdevice* subdevice, struct file* filep,
@@ -178,6 +248,9 @@ typedef struct me_subdevice
 	int (*me_subdevice_io_stream_write)(struct me_subdevice* subdevice, struct file* filep,
 										int write_mode, int* values, int* count, int timeout, int flags);
 
+	int (*me_subdevice_io_stream_reader)(struct me_subdevice* subdevice, struct file* filep,
+										int mode, int policy, int* dropped, int flags);
+
 	int (*me_subdevice_lock_subdevice)(struct me_subdevice* subdevice, struct file* filep,
 										int lock, int flags);
 
@@ -239,6 +312,196 @@ int me_subdevice_init(me_subdevice_t* subdevice);
  */
 void me_subdevice_deinit(me_subdevice_t* subdevice);
 
+/// Flags of me_subdevice_stats_read().
+#  define ME_SUBDEVICE_STATS_RESET			0x1
+#  define ME_SUBDEVICE_STATS_TIMING_ON		0x2
+#  define ME_SUBDEVICE_STATS_TIMING_OFF		0x4
+
+/**
+ * @brief Sums up statistics of all cpus.
+ *
+ * @param subdevice The subdevice.
+ * @param stats Result.
+ * @param flags ME_SUBDEVICE_STATS_RESET: clear counters after reading.
+ *        ME_SUBDEVICE_STATS_TIMING_ON/OFF: switch measuring of durations.
+ */
+void me_subdevice_stats_read(me_subdevice_t* subdevice, me_subdevice_stats_t* stats, int flags);
+
+/**
+ * @brief Start stamp for me_subdevice_stats_isr() and me_subdevice_stats_stall().
+ * Zero when timing is off, so nobody pays for clock reads.
+ */
+static inline uint64_t me_subdevice_stats_time(me_subdevice_t* subdevice)
+{
+	return (subdevice->stats_timing) ? me_latency_probe_time() : 0;
+}
+
+static inline void me_latency_probe_write(me_subdevice_t* subdevice, uint64_t time)
+{
+	unsigned long flags;
+
+	write_seqlock_irqsave(&subdevice->probe.lock, flags);
+		subdevice->probe.write_time = time;
+	write_sequnlock_irqrestore(&subdevice->probe.lock, flags);
+}
+
+static inline void me_latency_probe_irq(me_subdevice_t* subdevice, uint64_t time, int count)
+{
+	unsigned long flags;
+
+	write_seqlock_irqsave(&subdevice->probe.lock, flags);
+		subdevice->probe.irq_time = time;
+		subdevice->probe.irq_count = count;
+	write_sequnlock_irqrestore(&subdevice->probe.lock, flags);
+}
+
+static inline void me_latency_probe_wake(me_subdevice_t* subdevice, uint64_t time)
+{
+	unsigned long flags;
+
+	write_seqlock_irqsave(&subdevice->probe.lock, flags);
+		subdevice->probe.wake_time = time;
+	write_sequnlock_irqrestore(&subdevice->probe.lock, flags);
+}
+
+/**
+ * @brief Reads consistent set of stamps. Retried when a writer (also interrupt handler on other cpu) was active.
+ */
+static inline void me_latency_probe_read(me_subdevice_t* subdevice, uint64_t* write_time, uint64_t* irq_time, uint64_t* wake_time, int* irq_count)
+{
+	unsigned int seq;
+
+	do
+	{
+		seq = read_seqbegin(&subdevice->probe.lock);
+		*write_time = subdevice->probe.write_time;
+		*irq_time = subdevice->probe.irq_time;
+		*wake_time = subdevice->probe.wake_time;
+		*irq_count = subdevice->probe.irq_count;
+	}
+	while (read_seqretry(&subdevice->probe.lock, seq));
+}
+
+/**
+ * @brief Returns statistics of current cpu, cleared when reset was requested since last update.
+ * @note Call with local interrupts disabled. Updates come from process context and interrupt handlers.
+ */
+static inline me_subdevice_stats_t* me_subdevice_stats_this_cpu(me_subdevice_t* subdevice)
+{
+	me_subdevice_cpu_stats_t* cpu_stats = this_cpu_ptr(subdevice->stats);
+	int generation = atomic_read(&subdevice->stats_generation);
+
+	if (cpu_stats->generation != generation)
+	{
+		memset(&cpu_stats->values, 0, sizeof(me_subdevice_stats_t));
+		cpu_stats->generation = generation;
+	}
+
+	return &cpu_stats->values;
+}
+
+/**
+ * @brief Counts handled interrupt. 'start' is stamp taken at begin of handler, zero when not measured.
+ */
+static inline void me_subdevice_stats_isr(me_subdevice_t* subdevice, uint64_t start)
+{
+	me_subdevice_stats_t* stats;
+	uint64_t duration = 0;
+	unsigned long flags;
+
+	if (!subdevice->stats)
+		return;
+
+	if (start && subdevice->stats_timing)
+		duration = me_latency_probe_time() - start;
+
+	local_irq_save(flags);
+		stats = me_subdevice_stats_this_cpu(subdevice);
+		stats->isr_count++;
+		if (duration)
+		{
+			if (!stats->isr_time_min || (duration < stats->isr_time_min))
+				stats->isr_time_min = duration;
+			if (duration > stats->isr_time_max)
+				stats->isr_time_max = duration;
+		}
+	local_irq_restore(flags);
+}
+
+/**
+ * @brief Counts values moved to/from software buffer. 'fill' is buffer's fill level after the transfer.
+ */
+static inline void me_subdevice_stats_samples(me_subdevice_t* subdevice, int count, unsigned int fill)
+{
+	me_subdevice_stats_t* stats;
+	unsigned long flags;
+
+	if (!subdevice->stats || (count <= 0))
+		return;
+
+	local_irq_save(flags);
+		stats = me_subdevice_stats_this_cpu(subdevice);
+		stats->samples += count;
+		if (fill > stats->buffer_hwm)
+			stats->buffer_hwm = fill;
+	local_irq_restore(flags);
+}
+
+static inline void me_subdevice_stats_task(me_subdevice_t* subdevice)
+{
+	unsigned long flags;
+
+	if (!subdevice->stats)
+		return;
+
+	local_irq_save(flags);
+		me_subdevice_stats_this_cpu(subdevice)->task_wakeups++;
+	local_irq_restore(flags);
+}
+
+static inline void me_subdevice_stats_overflow(me_subdevice_t* subdevice)
+{
+	unsigned long flags;
+
+	if (!subdevice->stats)
+		return;
+
+	local_irq_save(flags);
+		me_subdevice_stats_this_cpu(subdevice)->overflows++;
+	local_irq_restore(flags);
+}
+
+/**
+ * @brief Adds time of wait for values/space. 'start' is me_subdevice_stats_time() taken before wait.
+ */
+static inline void me_subdevice_stats_stall(me_subdevice_t* subdevice, uint64_t start)
+{
+	uint64_t duration;
+	unsigned long flags;
+
+	if (!subdevice->stats || !start)
+		return;
+
+	duration = me_latency_probe_time() - start;
+	local_irq_save(flags);
+		me_subdevice_stats_this_cpu(subdevice)->stall_time += duration;
+	local_irq_restore(flags);
+}
+
+/**
+ * @brief Calls subdevice's interrupt handler. Entry and exit are traced.
+ */
+static inline int me_subdevice_irq_dispatch(me_subdevice_t* subdevice, uint32_t irq_status)
+{
+	int err;
+
+	trace_me_isr_entry(subdevice, subdevice->idx, irq_status);
+	err = subdevice->me_subdevice_irq_handle(subdevice, irq_status);
+	trace_me_isr_exit(subdevice, subdevice->idx, err);
+
+	return err;
+}
+
 
 # endif	//_MESUBDEVICE_H_
 #endif	//__KERNEL__
@@ -0,0 +1,346 @@
+/**
+ * @file mevirtual.c
+ *
+ * @brief Virtual loopback module for Meilhaus Driver System.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+/*
+ * Boards without hardware. Every board has:
+ *	AI	- streaming, values are the sample index (ramp) - good for checking continuity.
+ *		  Single reads return value of AO with the same index.
+ *	AO	- first one is streaming.
+ *	DIO	- ports are wired in pairs (0<->1, 2<->3, ...).
+ *	EXT_IRQ	- fires on bit 0 of DIO port 0 and/or periodically ('irq_period').
+ * Interrupts are simulated with high resolution timers, so the whole driver stack
+ * (ioctl, locks, segmented buffers, wait queues) is exercised like with a real board.
+ *
+ * Example: insmod meVIRTUAL.ko devices=2 ai_channels=8 irq_period=1000
+ */
+
+#ifndef __KERNEL__
+# define __KERNEL__
+#endif
+
+#ifndef MODULE
+# define MODULE
+#endif
+
+#ifndef ME_VIRTUAL
+# error ME_VIRTUAL driver flag not defined!
+#endif
+
+# include <linux/module.h>
+
+# include <linux/cdev.h>
+# include <linux/kernel.h>
+
+# include "me_common.h"
+# include "me_internal.h"
+# include "me_defines.h"
+# include "melock_defines.h"
+# include "me_error.h"
+# include "me_debug.h"
+# include "me_ioctl.h"
+
+# include "medevice.h"
+# include "memain_common.h"
+
+# include "mevirtual_device.h"
+
+// Tracepoints of this module (me_trace.h).
+# define ME_TRACE_SYSTEM mevirtual
+# define CREATE_TRACE_POINTS
+# include "me_trace.h"
+
+# define MEVIRTUAL_MAX_DEVICES		8
+
+///Globals
+struct file* me_filep = NULL;
+int me_count = 0;
+me_lock_t me_lock;
+DECLARE_RWSEM(me_rwsem);
+
+// Board instances are kept in a global list.
+LIST_HEAD(me_device_list);
+
+/// Char device structure.
+static struct cdev *cdevp;
+
+/// File operations provided by the module
+static struct file_operations me_file_operations =
+{
+	.owner = THIS_MODULE,
+#if LINUX_VERSION_CODE < KERNEL_VERSION(2,6,36)
+	.ioctl = me_ioctl,
+#else
+	.unlocked_ioctl = me_ioctl,
+#endif
+	.open = me_open,
+	.release = me_release,
+};
+
+/// HOTPLUG (udev) support
+static struct class* memain_class = NULL;
+static struct device* memain_dev = NULL;
+
+/// Bus structures of virtual boards. Stay valid until module is removed.
+static struct virtual_local_dev mevirtual_local_devs[MEVIRTUAL_MAX_DEVICES];
+
+/// Module parameters
+static unsigned int major = 0;
+static unsigned int devices = 1;
+static unsigned int ai_channels = 16;
+static unsigned int ai_fifo = 4096;
+static unsigned int ao_channels = 4;
+static unsigned int ao_fifo = 4096;
+static unsigned int dio_ports = 2;
+static unsigned int irq_period = 0;
+static unsigned int min_irq_period = 50;
+#ifdef module_param
+module_param(major, int, S_IRUGO);
+module_param(devices, uint, S_IRUGO);
+MODULE_PARM_DESC(devices, "Number of virtual boards (1-8).");
+module_param(ai_channels, uint, S_IRUGO);
+MODULE_PARM_DESC(ai_channels, "AI channels (0-32). 0: no AI subdevice.");
+module_param(ai_fifo, uint, S_IRUGO);
+MODULE_PARM_DESC(ai_fifo, "AI FIFO size [values].");
+module_param(ao_channels, uint, S_IRUGO);
+MODULE_PARM_DESC(ao_channels, "AO subdevices (0-4).");
+module_param(ao_fifo, uint, S_IRUGO);
+MODULE_PARM_DESC(ao_fifo, "AO FIFO size [values]. 0: no streaming.");
+module_param(dio_ports, uint, S_IRUGO);
+MODULE_PARM_DESC(dio_ports, "8 bit DIO ports (0-8).");
+module_param(irq_period, uint, S_IRUGO);
+MODULE_PARM_DESC(irq_period, "Period of external interrupt [us]. 0: only DIO line.");
+module_param(min_irq_period, uint, S_IRUGO);
+MODULE_PARM_DESC(min_irq_period, "Shortest time between two simulated interrupts [us].");
+#else
+MODULE_PARM(major, "i");
+MODULE_PARM(devices, "i");
+MODULE_PARM(ai_channels, "i");
+MODULE_PARM(ai_fifo, "i");
+MODULE_PARM(ao_channels, "i");
+MODULE_PARM(ao_fifo, "i");
+MODULE_PARM(dio_ports, "i");
+MODULE_PARM(irq_period, "i");
+MODULE_PARM(min_irq_period, "i");
+#endif
+
+static int mevirtual_add_device(unsigned int idx, mevirtual_config_t* config)
+{
+	struct virtual_local_dev* dev = &mevirtual_local_devs[idx];
+	me_device_t* n_device;
+
+	PDEBUG("executed.\n");
+
+	dev->dev = dev;
+	dev->vendor = PCI_VENDOR_ID_MEILHAUS;
+	dev->device = PCI_DEVICE_ID_MEILHAUS_MEVIRTUAL;
+	dev->hw_revision = 0;
+	dev->serial_no = idx;
+	dev->irq_no = 0;
+
+	if (find_device_on_list(dev, ME_PLUGGED_ANY))
+	{
+		PERROR("Device is already on list!\n");
+		return -EEXIST;
+	}
+
+ 	PINFO("CALLING %s constructor\n", "mevirtual_constr");
+
+	n_device = mevirtual_constr(dev, NULL, config);
+	if (!n_device)
+	{
+		PERROR("Executing '%s()' failed.\n", "mevirtual_constr");
+		return -ENODEV;
+	}
+
+ 	PINFO("Adding new entry to device list.\n");
+	insert_to_device_list(n_device);
+
+	if (n_device->me_device_postinit)
+	{
+		if (n_device->me_device_postinit(n_device, NULL))
+		{
+			PERROR("Error while calling me_device_postinit().\n");
+			/// This error can be ignored.
+		}
+		else
+		{
+			PDEBUG("me_device_postinit() was sucessful.\n");
+		}
+	}
+	else
+	{
+		PERROR("me_device_postinit() not registred!\n");
+	}
+
+	return 0;
+}
+
+// Init and exit of module.
+static int __init mevirtual_init(void)
+{
+	mevirtual_config_t config;
+	int result = 0;
+	unsigned int i;
+	dev_t dev = MKDEV(major, 0);
+
+ 	PDEBUG("executed.\n");
+
+	if ((devices < 1) || (devices > MEVIRTUAL_MAX_DEVICES))
+	{
+		PERROR("Invalid number of devices. Must be between 1 and %d.\n", MEVIRTUAL_MAX_DEVICES);
+		return -EINVAL;
+	}
+
+	if ((ai_channels > MEVIRTUAL_MAX_AI_CHANNELS) || (ao_channels > MEVIRTUAL_MAX_AO_CHANNELS) || (dio_ports > MEVIRTUAL_MAX_DIO_PORTS))
+	{
+		PERROR("Invalid board shape. Maximum is %d AI channels, %d AO channels and %d DIO ports.\n",
+				MEVIRTUAL_MAX_AI_CHANNELS, MEVIRTUAL_MAX_AO_CHANNELS, MEVIRTUAL_MAX_DIO_PORTS);
+		return -EINVAL;
+	}
+
+	if (ai_channels && !ai_fifo)
+	{
+		PERROR("AI FIFO can not be empty.\n");
+		return -EINVAL;
+	}
+
+ 	ME_INIT_LOCK(&me_lock);
+
+	// Register the character device.
+	if (major)
+	{
+		result = register_chrdev_region(dev, 1, ME_NAME_DRIVER);
+	}
+	else
+	{
+		result = alloc_chrdev_region(&dev, 0, 1, ME_NAME_DRIVER);
+		major = MAJOR(dev);
+	}
+	if (result < 0)
+	{
+		PERROR("Can't get major driver no.\n");
+		goto INIT_ERROR_1;
+	}
+
+	cdevp = cdev_alloc();
+	if (!cdevp)
+	{
+		PERROR("Can't get character device structure.\n");
+		result = -ENOMEM;
+		goto INIT_ERROR_2;
+	}
+
+	cdevp->ops = &me_file_operations;
+	cdevp->owner = THIS_MODULE;
+
+	result = cdev_add(cdevp, dev, 1);
+	if (result < 0)
+	{
+		PERROR("Cannot add character device structure.\n");
+		goto INIT_ERROR_3;
+	}
+
+	// Create boards. There is no bus to probe.
+	config.ai_channels = ai_channels;
+	config.ai_fifo = ai_fifo;
+	config.ao_channels = ao_channels;
+	config.ao_fifo = ao_fifo;
+	config.dio_ports = dio_ports;
+	config.irq_period = irq_period;
+	config.min_irq_period = min_irq_period;
+
+	for (i = 0; i < devices; i++)
+	{
+		result = mevirtual_add_device(i, &config);
+		if (result)
+		{
+			goto INIT_ERROR_4;
+		}
+	}
+
+	PLOG("Loaded: %s version: 0x%08x\n", ME_NAME_DRIVER, ME_VERSION_DRIVER);
+
+	memain_class = class_create(THIS_MODULE, ME_NAME_DRIVER);
+	memain_dev = device_create(memain_class,
+								NULL,
+								dev,
+#if LINUX_VERSION_CODE > KERNEL_VERSION(2,6,26)
+								NULL,
+#endif
+								ME_NAME_NODE);
+
+	// Export statistics.
+	me_debugfs_init();
+
+	return 0;
+
+INIT_ERROR_4:
+	clear_device_list();
+
+INIT_ERROR_3:
+	cdev_del(cdevp);
+
+INIT_ERROR_2:
+	unregister_chrdev_region(dev, 1);
+
+INIT_ERROR_1:
+	return result;
+}
+
+static void __exit mevirtual_exit(void)
+{
+	dev_t dev = MKDEV(major, 0);
+
+ 	PDEBUG("executed.\n");
+
+	me_debugfs_exit();
+
+	// Remove all instances.
+	clear_device_list();
+
+	// Remove hotplug.
+	device_destroy(memain_class, dev);
+	memain_dev = NULL;
+	class_destroy(memain_class);
+	memain_class = NULL;
+
+	// Free reservations
+	unregister_chrdev_region(dev, 1);
+
+	// Deregister driver.
+	cdev_del(cdevp);
+}
+
+module_init(mevirtual_init);
+module_exit(mevirtual_exit);
+
+// Administrative stuff for modinfo.
+MODULE_AUTHOR("Krzysztof Gantzke (k.gantzke@meilhaus.de)");
+MODULE_DESCRIPTION("Virtual loopback module for Meilhaus Driver System.");
+
+MODULE_SUPPORTED_DEVICE("Meilhaus virtual loopback board.");
+MODULE_LICENSE("GPL");
+MODULE_VERSION(__stringify(ME_VERSION_DRIVER));
@@ -0,0 +1,1317 @@
+/**
+ * @file mevirtual_ai.c
+ *
+ * @brief The virtual analog input subdevice instance.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __KERNEL__
+# error Kernel only!
+#endif
+
+# ifndef MODULE
+#  define MODULE
+# endif
+
+# include <linux/fs.h>
+# include <linux/slab.h>
+# include <linux/sched.h>
+# include <linux/math64.h>
+# include <asm/uaccess.h>
+
+# include "me_debug.h"
+# include "me_error.h"
+# include "me_defines.h"
+# include "me_spin_lock.h"
+
+# include "mevirtual_ai.h"
+
+static void mevirtual_ai_destructor(me_subdevice_t* subdevice);
+int mevirtual_ai_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep, int flags);
+int mevirtual_ai_io_single_config(me_subdevice_t* subdevice, struct file* filep, int channel,
+										int single_config, int ref, int trig_chain, int trig_type, int trig_edge, int flags);
+int mevirtual_ai_io_single_read(me_subdevice_t* subdevice, struct file* filep, int channel, int* value, int time_out, int flags);
+static int mevirtual_ai_io_stream_config_check(mevirtual_ai_subdevice_t* instance,
+										meIOStreamSimpleConfig_t* config_list, int count, meIOStreamSimpleTriggers_t* trigger, int fifo_irq_threshold, int flags);
+int mevirtual_ai_io_stream_config(me_subdevice_t* subdevice, struct file* filep,
+										meIOStreamSimpleConfig_t* config_list, int count, meIOStreamSimpleTriggers_t* trigger, int fifo_irq_threshold, int flags);
+int mevirtual_ai_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep, int time_out, int* count, int flags);
+int mevirtual_ai_io_stream_read(me_subdevice_t* subdevice, struct file* filep, int read_mode, int* values, int* count, int time_out, int flags);
+int mevirtual_ai_io_stream_start(me_subdevice_t* subdevice, struct file* filep, int start_mode, int time_out, int flags);
+int mevirtual_ai_io_stream_stop(me_subdevice_t* subdevice, struct file* filep, int stop_mode, int time_out, int flags);
+int mevirtual_ai_io_stream_status(me_subdevice_t* subdevice, struct file* filep, int wait, int* status, int* values, int flags);
+int mevirtual_ai_query_number_channels(me_subdevice_t* subdevice, int* number);
+int mevirtual_ai_query_subdevice_type(me_subdevice_t* subdevice, int* type, int* subtype);
+int mevirtual_ai_query_subdevice_caps(me_subdevice_t* subdevice, int* caps);
+int mevirtual_ai_query_subdevice_caps_args(me_subdevice_t* subdevice, int cap, int* args, int* count);
+int mevirtual_ai_query_number_ranges(me_subdevice_t* subdevice, int unit, int* count);
+int mevirtual_ai_query_range_by_min_max(me_subdevice_t* subdevice, int unit, int* min, int* max, int* maxdata, int* range);
+int mevirtual_ai_query_range_info(me_subdevice_t* subdevice, int range, int* unit, int* min, int* max, int* maxdata);
+int mevirtual_ai_query_timer(me_subdevice_t* subdevice, int timer, int* base_frequency, uint64_t* min_ticks, uint64_t* max_ticks);
+
+static int mevirtual_ai_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status);
+static enum hrtimer_restart mevirtual_ai_timer(struct hrtimer* timer);
+
+static int mevirtual_ai_is_running(mevirtual_ai_subdevice_t* instance)
+{
+	return (instance->status == ai_status_stream_run) || (instance->status == ai_status_stream_end_wait);
+}
+
+static uint64_t mevirtual_ai_ticks_to_ns(uint64_t ticks)
+{
+	return div64_u64(ticks * NSEC_PER_SEC, MEVIRTUAL_BASE_FREQUENCY);
+}
+
+/** @brief Number of values that hardware would have converted until now.
+*/
+static uint64_t mevirtual_ai_values_due(mevirtual_ai_subdevice_t* instance)
+{
+	uint64_t elapsed;
+	uint64_t scans;
+	uint64_t in_scan;
+	uint64_t due;
+
+	elapsed = ktime_to_ns(ktime_sub(ktime_get(), instance->start_time));
+	if (elapsed < instance->acq_period)
+		return 0;
+	elapsed -= instance->acq_period;
+
+	scans = div64_u64(elapsed, instance->scan_period);
+	in_scan = div64_u64(elapsed - scans * instance->scan_period, instance->conv_period) + 1;
+	if (in_scan > instance->chan_list_len)
+		in_scan = instance->chan_list_len;
+
+	due = scans * instance->chan_list_len + in_scan;
+	if (instance->stop_count && (due > instance->stop_count))
+		due = instance->stop_count;
+
+	return due;
+}
+
+/** @brief Stops producer. Call without subdevice lock. Timer callback only tries the lock.
+*/
+static void mevirtual_ai_stop_timer(mevirtual_ai_subdevice_t* instance)
+{
+	hrtimer_cancel(&instance->timer);
+}
+
+static void mevirtual_ai_destructor(me_subdevice_t* subdevice)
+{
+	mevirtual_ai_subdevice_t* instance;
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	PDEBUG("executed. idx=0\n");
+
+	instance->status = ai_status_none;
+	mevirtual_ai_stop_timer(instance);
+
+	destroy_seg_buffer(&instance->seg_buf);
+	me_subdevice_deinit(&instance->base);
+}
+
+int mevirtual_ai_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	int i;
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	PDEBUG("executed. idx=0\n");
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_RESET_SUBDEVICE_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			instance->status = ai_status_none;
+			instance->chan_list_len = 0;
+			instance->stop_count = 0;
+			instance->empty_read_count = 0;
+			for (i = 0; i < MEVIRTUAL_MAX_AI_CHANNELS; i++)
+			{
+				instance->single_range[i] = 0;
+			}
+			me_seg_buf_reset(instance->seg_buf);
+		ME_UNLOCK_PROTECTOR;
+		mevirtual_ai_stop_timer(instance);
+		wake_up_interruptible_all(&instance->wait_queue);
+	ME_SUBDEVICE_EXIT;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_io_single_config(me_subdevice_t* subdevice, struct file* filep, int channel,
+										int single_config, int ref, int trig_chain, int trig_type, int trig_edge, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	PDEBUG("executed. idx=0\n");
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_SINGLE_CONFIG_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((channel < 0) || (channel >= instance->channels))
+	{
+		PERROR("Invalid channel specified. Must be between 0 and %d.\n", instance->channels - 1);
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	if ((single_config < 0) || (single_config >= instance->ranges_len))
+	{
+		PERROR("Invalid range specified. Must be between 0 and %d.\n", instance->ranges_len - 1);
+		return ME_ERRNO_INVALID_SINGLE_CONFIG;
+	}
+
+	if (ref != ME_REF_AI_GROUND)
+	{
+		PERROR("Invalid reference specified. Must be ME_REF_AI_GROUND.\n");
+		return ME_ERRNO_INVALID_REF;
+	}
+
+	if ((trig_type != ME_TRIG_TYPE_SW) || (trig_chain != ME_TRIG_CHAN_DEFAULT) || trig_edge)
+	{
+		PERROR("Invalid trigger specified. Only ME_TRIG_TYPE_SW on ME_TRIG_CHAN_DEFAULT is supported.\n");
+		return ME_ERRNO_INVALID_TRIG_TYPE;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			if (mevirtual_ai_is_running(instance))
+			{
+				PERROR("Subdevice is busy.\n");
+				err = ME_ERRNO_SUBDEVICE_BUSY;
+			}
+			else
+			{
+				instance->single_range[channel] = single_config;
+				instance->status = ai_status_single_configured;
+			}
+		ME_UNLOCK_PROTECTOR;
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ai_io_single_read(me_subdevice_t* subdevice, struct file* filep, int channel, int* value, int time_out, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	PDEBUG("executed. idx=0\n");
+
+	if (flags & ~ME_IO_SINGLE_TYPE_READ_NONBLOCKING)
+	{
+		PERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((channel < 0) || (channel >= instance->channels))
+	{
+		PERROR("Invalid channel specified. Must be between 0 and %d.\n", instance->channels - 1);
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		if (instance->status != ai_status_single_configured)
+		{
+			PERROR("Subdevice is not configured to work in single mode.\n");
+			err = (mevirtual_ai_is_running(instance)) ? ME_ERRNO_SUBDEVICE_BUSY : ME_ERRNO_PREVIOUS_CONFIG;
+		}
+		else
+		{// Channels without AO read 0V.
+			*value = (channel < instance->loopback->ao_channels) ? instance->loopback->ao_value[channel] : MEVIRTUAL_AI_MAX_DATA / 2 + 1;
+		}
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+static int mevirtual_ai_io_stream_config_check(mevirtual_ai_subdevice_t* instance, meIOStreamSimpleConfig_t* config_list, int count, meIOStreamSimpleTriggers_t* trigger, int fifo_irq_threshold, int flags)
+{
+	int i;
+
+	if (flags)
+	{
+		PERROR("Invalid flags. Must be ME_IO_STREAM_CONFIG_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (trigger->trigger_type != ME_TRIGGER_TYPE_SOFTWARE)
+	{
+		PERROR("Invalid acquisition trigger type specified. Only software trigger is supported.\n");
+		return ME_ERRNO_INVALID_ACQ_START_TRIG_TYPE;
+	}
+
+	if ((trigger->synchro != ME_TRIG_CHAN_DEFAULT) && (trigger->synchro != ME_TRIG_CHAN_NONE))
+	{
+		PERROR("Invalid acquisition start trigger channel specified. Should be ME_TRIG_CHAN_DEFAULT.\n");
+		return ME_ERRNO_INVALID_ACQ_START_TRIG_CHAN;
+	}
+
+	if (trigger->acq_ticks > (uint64_t)MEVIRTUAL_AI_MAX_ACQ_TICKS)
+	{
+		PERROR("Invalid acquisition start trigger argument specified.\n");
+		return ME_ERRNO_INVALID_ACQ_START_ARG;
+	}
+
+	if ((trigger->scan_ticks != 0) && ((trigger->scan_ticks < (uint64_t)MEVIRTUAL_AI_MIN_SCAN_TICKS) || (trigger->scan_ticks > (uint64_t)MEVIRTUAL_AI_MAX_SCAN_TICKS)))
+	{
+		PERROR("Invalid scan start argument specified.\n");
+		return ME_ERRNO_INVALID_SCAN_START_ARG;
+	}
+
+	if ((trigger->conv_ticks != 0) && ((trigger->conv_ticks < (uint64_t)MEVIRTUAL_AI_MIN_CHAN_TICKS) || (trigger->conv_ticks > (uint64_t)MEVIRTUAL_AI_MAX_CHAN_TICKS)))
+	{
+		PERROR("Invalid conv start trigger argument specified.\n");
+		return ME_ERRNO_INVALID_CONV_START_ARG;
+	}
+
+	switch (trigger->stop_type)
+	{
+		case ME_STREAM_STOP_TYPE_ACQ_LIST:
+			if (trigger->stop_count <= 0)
+			{
+				PERROR("Invalid stop count specified. Must be at least 1.\n");
+				return ME_ERRNO_INVALID_ACQ_STOP_ARG;
+			}
+			break;
+
+		case ME_STREAM_STOP_TYPE_SCAN_VALUE:
+			if (trigger->stop_count <= 0)
+			{
+				PERROR("Invalid scan stop argument specified. Must be at least 1.\n");
+				return ME_ERRNO_INVALID_SCAN_STOP_ARG;
+			}
+			break;
+
+		case ME_STREAM_STOP_TYPE_MANUAL:
+			if (trigger->stop_count != 0)
+			{
+				PERROR("Invalid stop argument specified. Must be 0.\n");
+				return ME_ERRNO_INVALID_SCAN_STOP_ARG;
+			}
+			break;
+
+		default:
+			PERROR("Invalid stop trigger type specified.\n");
+			return ME_ERRNO_INVALID_SCAN_STOP_TRIG_TYPE;
+	}
+
+	if ((count <= 0) || (count > MEVIRTUAL_AI_LIST_SIZE))
+	{
+		PERROR("Invalid channel list count specified. Must be between 1 and %d.\n", MEVIRTUAL_AI_LIST_SIZE);
+		return ME_ERRNO_INVALID_CONFIG_LIST_COUNT;
+	}
+
+	if ((fifo_irq_threshold < 0) || (fifo_irq_threshold > instance->fifo_size))
+	{
+		PERROR("Invalid fifo irq threshold specified. Must be between 0 and %d.\n", instance->fifo_size);
+		return ME_ERRNO_INVALID_FIFO_IRQ_THRESHOLD;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if ((config_list[i].iRange < 0) || (config_list[i].iRange >= instance->ranges_len))
+		{
+			PERROR("Invalid range specified. Must be between 0 and %d.\n", instance->ranges_len - 1);
+			return ME_ERRNO_INVALID_STREAM_CONFIG;
+		}
+
+		if ((config_list[i].iChannel < 0) || (config_list[i].iChannel >= instance->channels))
+		{
+			PERROR("Invalid channel specified. Must be between 0 and %d.\n", instance->channels - 1);
+			return ME_ERRNO_INVALID_CHANNEL;
+		}
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_io_stream_config(me_subdevice_t* subdevice, struct file* filep,
+										meIOStreamSimpleConfig_t* config_list, int count, meIOStreamSimpleTriggers_t* trigger, int fifo_irq_threshold, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	uint64_t conv_ticks;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	PDEBUG("executed. idx=0\n");
+
+	err = mevirtual_ai_io_stream_config_check(instance, config_list, count, trigger, fifo_irq_threshold, flags);
+	if (err)
+		return err;
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			if (mevirtual_ai_is_running(instance))
+			{
+				PERROR("Subdevice is busy.\n");
+				err = ME_ERRNO_SUBDEVICE_BUSY;
+				goto ERROR;
+			}
+
+			instance->chan_list_len = count;
+
+			conv_ticks = (trigger->conv_ticks) ? trigger->conv_ticks : MEVIRTUAL_AI_MIN_CHAN_TICKS;
+			instance->conv_period = mevirtual_ai_ticks_to_ns(conv_ticks);
+			if (!instance->conv_period)
+				instance->conv_period = 1;
+
+			instance->scan_period = mevirtual_ai_ticks_to_ns(trigger->scan_ticks);
+			if (instance->scan_period < instance->conv_period * count)
+			{// Scan timer off (or too short): lists follow each other.
+				instance->scan_period = instance->conv_period * count;
+			}
+
+			instance->acq_period = mevirtual_ai_ticks_to_ns(trigger->acq_ticks);
+
+			switch (trigger->stop_type)
+			{
+				case ME_STREAM_STOP_TYPE_ACQ_LIST:
+					instance->stop_count = (uint64_t)trigger->stop_count * count;
+					break;
+
+				case ME_STREAM_STOP_TYPE_SCAN_VALUE:
+					instance->stop_count = trigger->stop_count;
+					break;
+
+				default:
+					instance->stop_count = 0;
+			}
+
+			// Producer runs when FIFO reached threshold (default: half full).
+			instance->irq_period = instance->conv_period * ((fifo_irq_threshold) ? fifo_irq_threshold : (instance->fifo_size >> 1));
+			if (instance->irq_period < instance->min_irq_period)
+				instance->irq_period = instance->min_irq_period;
+
+			me_seg_buf_reset(instance->seg_buf);
+			instance->status = ai_status_stream_configured;
+ERROR:
+		ME_UNLOCK_PROTECTOR;
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ai_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep, int time_out, int* count, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	unsigned long int delay = LONG_MAX - 2;
+	unsigned long int j;
+	unsigned int writes_count;
+	int status;
+	int err = ME_ERRNO_SUCCESS;
+
+	PDEBUG("executed. idx=0\n");
+
+	if (flags & ~(ME_IO_STREAM_NEW_VALUES_SCREEN_FLAG | ME_IO_STREAM_NEW_VALUES_ERROR_REPORT_FLAG))
+	{
+		PERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (time_out)
+	{
+		delay = (time_out * HZ) / 1000;
+		if (!delay)
+			delay = 1;
+		if (delay>LONG_MAX - 2)
+			delay = LONG_MAX - 2;
+	}
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	ME_SUBDEVICE_ENTER;
+		j = jiffies;
+
+		while(1)
+		{
+			status = instance->status;
+			if (flags & ME_IO_STREAM_NEW_VALUES_ERROR_REPORT_FLAG)
+			{// Report errors
+				if (status == ai_status_stream_fifo_error)
+				{
+					err = ME_ERRNO_HARDWARE_BUFFER_OVERFLOW;
+				}
+				else if (status == ai_status_stream_buffer_error)
+				{
+					err = ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
+				}
+				else if (status == ai_status_none)
+				{
+					err = ME_ERRNO_CANCELLED;
+				}
+				if (err)
+				{
+					break;
+				}
+			}
+
+			writes_count = instance->seg_buf->header.writes_count;
+			if (flags & ME_IO_STREAM_NEW_VALUES_SCREEN_FLAG)
+			{
+				wait_event_interruptible_timeout(
+					instance->wait_queue,
+					((writes_count != instance->seg_buf->header.writes_count) || (status != instance->status)),
+					delay);
+			}
+			else
+			{
+				wait_event_interruptible_timeout(
+					instance->wait_queue,
+					(me_seg_buf_values(instance->seg_buf) || (status != instance->status)),
+					delay);
+			}
+
+			if (signal_pending(current))
+			{
+				PERROR("Wait on values interrupted.\n");
+				err = ME_ERRNO_SIGNAL;
+				*count = 0;
+				goto ERROR;
+			}
+
+			if (instance->status == ai_status_stream_fifo_error)
+			{
+				err = ME_ERRNO_HARDWARE_BUFFER_OVERFLOW;
+			}
+			else if (instance->status == ai_status_stream_buffer_error)
+			{
+				err = ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
+			}
+			else if (instance->status == ai_status_none)
+			{
+				err = ME_ERRNO_CANCELLED;
+			}
+			else if ((jiffies - j) >= delay)
+			{
+				PERROR("Wait on values timed out.\n");
+				err = ME_ERRNO_TIMEOUT;
+			}
+
+			if ((writes_count != instance->seg_buf->header.writes_count) || (!flags && me_seg_buf_values(instance->seg_buf)))
+			{// New data in buffer.
+				break;
+			}
+
+			if (err || (instance->status == ai_status_stream_end))
+			{
+				break;
+			}
+			// Correct timeout.
+			delay -= jiffies - j;
+		}
+
+		*count = me_seg_buf_values(instance->seg_buf);
+ERROR:
+	ME_SUBDEVICE_EXIT;
+
+	PDEBUG("count=%d err = %d\n", *count, err);
+	return err;
+}
+
+static int inline mevirtual_ai_io_stream_read_get_value(mevirtual_ai_subdevice_t* instance, int* values, const int count, const int flags)
+{
+	unsigned int n;
+	int i;
+	uint16_t tmp;
+	int value;
+
+	///Checking how many datas can be copied.
+	n = me_seg_buf_values(instance->seg_buf);
+	if (n <= 0)
+		return 0;
+
+	if (n > count)
+		n = count;
+
+	if (flags & ME_IO_STREAM_READ_FRAMES)
+	{
+		if (n < instance->chan_list_len)	//Not enough data!
+			return 0;
+		n -= n % instance->chan_list_len;
+	}
+
+	for (i=0; i<n; i++)
+	{
+		ME_LOCK_PROTECTOR;
+			me_seg_buf_get(instance->seg_buf, &tmp);
+		ME_UNLOCK_PROTECTOR;
+		value = tmp;
+		if(put_user(value, values + i))
+		{
+			PERROR("Cannot copy new values to user.\n");
+			return -ME_ERRNO_INTERNAL;
+		}
+	}
+	return n;
+}
+
+int mevirtual_ai_io_stream_read(me_subdevice_t* subdevice, struct file* filep, int read_mode, int* values, int* count, int time_out, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	int ret;
+	unsigned long int delay = LONG_MAX - 2;
+	unsigned long int j;
+	int err = ME_ERRNO_SUCCESS;
+	int c;
+	int min;
+
+	PDEBUG("executed. idx=0\n");
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	if ((flags != ME_IO_STREAM_READ_NO_FLAGS) && (flags != ME_IO_STREAM_READ_FRAMES))
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_STREAM_READ_NO_FLAGS or ME_IO_STREAM_READ_FRAMES.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (!values || !count)
+	{
+		PERROR("Request has invalid pointer.\n");
+		return ME_ERRNO_INVALID_POINTER;
+	}
+
+	if (*count < 0)
+	{
+		PERROR("Request has invalid value's counter. Should be at least 1.\n");
+		return ME_ERRNO_INVALID_VALUE_COUNT;
+	}
+
+	if ((read_mode != ME_READ_MODE_BLOCKING) && (read_mode != ME_READ_MODE_NONBLOCKING))
+	{
+		PERROR("Invalid read mode specified. Must be ME_READ_MODE_BLOCKING or ME_READ_MODE_NONBLOCKING.\n");
+		return ME_ERRNO_INVALID_READ_MODE;
+	}
+
+	c = *count;
+	min = c;
+	if (c == 0)
+	{
+		return ME_ERRNO_SUCCESS;
+	}
+
+	if (time_out)
+	{
+		delay = (time_out * HZ) / 1000;
+		if (!delay)
+			delay = 1;
+		if (delay>LONG_MAX - 2)
+			delay = LONG_MAX - 2;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		if (flags & ME_IO_STREAM_READ_FRAMES)
+		{
+			if (instance->chan_list_len <= 0)
+			{
+				PERROR("Subdevice wasn't configured.\n");
+				err = ME_ERRNO_PREVIOUS_CONFIG;
+				goto ERROR;
+			}
+
+			if (c < instance->chan_list_len)
+			{
+				PERROR("When using FRAME_READ mode minimal size is defined by channel list.\n");
+				err = ME_ERRNO_INVALID_VALUE_COUNT;
+				goto ERROR;
+			}
+
+			min = (read_mode == ME_READ_MODE_BLOCKING) ? c - (c % instance->chan_list_len) : instance->chan_list_len;
+		}
+		else if (c > me_seg_buf_size(instance->seg_buf))
+		{
+			min = me_seg_buf_size(instance->seg_buf);
+			min -= (instance->chan_list_len > 2) ? instance->chan_list_len : 2;
+		}
+
+		if (mevirtual_ai_is_running(instance) && (me_seg_buf_values(instance->seg_buf) < min) && (read_mode == ME_READ_MODE_BLOCKING))
+		{
+			j = jiffies;
+			wait_event_interruptible_timeout(
+				instance->wait_queue,
+				((me_seg_buf_values(instance->seg_buf) >= min) || !mevirtual_ai_is_running(instance)),
+				delay);
+
+			if (signal_pending(current))
+			{
+				PERROR("Wait on values interrupted from signal.\n");
+				err = ME_ERRNO_SIGNAL;
+				goto ERROR;
+			}
+			else if ((jiffies - j) >= delay)
+			{
+				PERROR("Wait on values timed out.\n");
+				err = ME_ERRNO_TIMEOUT;
+			}
+		}
+
+		ret = mevirtual_ai_io_stream_read_get_value(instance, values, c, flags);
+		if (ret < 0)
+		{
+			err = -ret;
+			*count = 0;
+		}
+		else if (ret == 0)
+		{
+			*count = 0;
+			ME_LOCK_PROTECTOR;
+				switch (instance->status)
+				{
+					case ai_status_stream_end:
+						if (instance->empty_read_count)
+						{
+							err = ME_ERRNO_SUBDEVICE_NOT_RUNNING;
+						}
+						instance->empty_read_count = 1;
+						break;
+
+					case ai_status_stream_fifo_error:
+						err = ME_ERRNO_HARDWARE_BUFFER_OVERFLOW;
+						instance->status = ai_status_stream_end;
+						break;
+
+					case ai_status_stream_buffer_error:
+						err = ME_ERRNO_SOFTWARE_BUFFER_OVERFLOW;
+						instance->status = ai_status_stream_end;
+						break;
+
+					case ai_status_none:
+						err = ME_ERRNO_CANCELLED;
+						break;
+
+					default:
+						break;
+				}
+			ME_UNLOCK_PROTECTOR;
+		}
+		else
+		{
+			*count = ret;
+		}
+
+		if (ret || (instance->status != ai_status_stream_end))
+		{
+			instance->empty_read_count = 0;
+		}
+ERROR:
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ai_io_stream_start(me_subdevice_t* subdevice, struct file* filep, int start_mode, int time_out, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	int err = ME_ERRNO_SUCCESS;
+
+	PDEBUG("executed. idx=0\n");
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	if (flags & ~ME_IO_STREAM_START_TYPE_TRIG_SYNCHRONOUS)
+	{
+		PERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((start_mode != ME_START_MODE_BLOCKING) && (start_mode != ME_START_MODE_NONBLOCKING))
+	{
+		PERROR("Invalid start mode specified. Must be ME_START_MODE_BLOCKING or ME_START_MODE_NONBLOCKING.\n");
+		return ME_ERRNO_INVALID_START_MODE;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			switch (instance->status)
+			{
+				case ai_status_stream_configured:
+				case ai_status_stream_end:
+				case ai_status_stream_fifo_error:
+				case ai_status_stream_buffer_error:
+					// OK - subdevice in idle
+					break;
+
+				case ai_status_stream_run:
+				case ai_status_stream_end_wait:
+					PERROR("Subdevice is busy.\n");
+					err = ME_ERRNO_SUBDEVICE_BUSY;
+					break;
+
+				default:
+					PERROR("Subdevice is not configured to work in stream mode!\n");
+					err = ME_ERRNO_PREVIOUS_CONFIG;
+			}
+
+			if (!err)
+			{
+				me_seg_buf_reset(instance->seg_buf);
+				instance->produced = 0;
+				instance->empty_read_count = 0;
+				instance->start_time = ktime_get();
+				// Software trigger: the state machine runs at once.
+				instance->status = ai_status_stream_run;
+				instance->stream_start_count++;
+			}
+		ME_UNLOCK_PROTECTOR;
+
+		if (!err)
+		{
+			hrtimer_start(&instance->timer, ns_to_ktime(instance->irq_period), HRTIMER_MODE_REL);
+			wake_up_interruptible_all(&instance->wait_queue);
+		}
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ai_io_stream_stop(me_subdevice_t* subdevice, struct file* filep, int stop_mode, int time_out, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	unsigned long int delay = LONG_MAX - 2;
+	uint64_t last;
+	int err = ME_ERRNO_SUCCESS;
+
+	PDEBUG("executed. idx=0\n");
+
+	if (flags & ~ME_IO_STREAM_STOP_TYPE_PRESERVE_BUFFERS)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_STREAM_STOP_TYPE_NO_FLAGS or ME_IO_STREAM_STOP_TYPE_PRESERVE_BUFFERS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((stop_mode != ME_STOP_MODE_IMMEDIATE) && (stop_mode != ME_STOP_MODE_LAST_VALUE))
+	{
+		PERROR("Invalid stop mode specified. Must be ME_STOP_MODE_IMMEDIATE or ME_STOP_MODE_LAST_VALUE.\n");
+		return ME_ERRNO_INVALID_STOP_MODE;
+	}
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	if (time_out)
+	{
+		delay = (time_out * HZ) / 1000;
+		if (!delay)
+			delay = 1;
+		if (delay>LONG_MAX - 2)
+			delay = LONG_MAX - 2;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			switch (instance->status)
+			{
+				case ai_status_stream_fifo_error:
+				case ai_status_stream_buffer_error:
+					instance->status = ai_status_stream_end;
+					break;
+
+				case ai_status_stream_run:
+				case ai_status_stream_end_wait:
+					if (stop_mode == ME_STOP_MODE_LAST_VALUE)
+					{// Finish current list.
+						last = mevirtual_ai_values_due(instance) + instance->chan_list_len - 1;
+						last -= do_div(last, instance->chan_list_len);
+						if (!last)
+							last = instance->chan_list_len;
+						if (!instance->stop_count || (last < instance->stop_count))
+							instance->stop_count = last;
+						instance->status = ai_status_stream_end_wait;
+					}
+					else
+					{
+						instance->status = ai_status_stream_end;
+						instance->stream_stop_count++;
+					}
+					break;
+
+				default:
+					break;
+			}
+		ME_UNLOCK_PROTECTOR;
+
+		if (instance->status == ai_status_stream_end_wait)
+		{
+			wait_event_interruptible_timeout(instance->wait_queue, (instance->status != ai_status_stream_end_wait), delay);
+
+			if (signal_pending(current))
+			{
+				PERROR("Wait on stop interrupted.\n");
+				err = ME_ERRNO_SIGNAL;
+			}
+			else if (instance->status == ai_status_stream_end_wait)
+			{
+				PERROR("Wait on stop timed out.\n");
+				err = ME_ERRNO_TIMEOUT;
+			}
+		}
+
+		if (instance->status != ai_status_stream_end_wait)
+		{
+			mevirtual_ai_stop_timer(instance);
+			if (!(flags & ME_IO_STREAM_STOP_TYPE_PRESERVE_BUFFERS))
+			{
+				ME_LOCK_PROTECTOR;
+					me_seg_buf_reset(instance->seg_buf);
+				ME_UNLOCK_PROTECTOR;
+			}
+		}
+		wake_up_interruptible_all(&instance->wait_queue);
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ai_io_stream_status(me_subdevice_t* subdevice, struct file* filep, int wait, int* status, int* values, int flags)
+{
+	mevirtual_ai_subdevice_t* instance;
+	int old_count;
+	int err = ME_ERRNO_SUCCESS;
+
+	PDEBUG("executed. idx=0\n");
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_STREAM_STATUS_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	switch (wait)
+	{
+		case ME_WAIT_NONE:
+		case ME_WAIT_IDLE:
+		case ME_WAIT_BUSY:
+		case ME_WAIT_START:
+		case ME_WAIT_STOP:
+			break;
+
+		default:
+			PERROR("Invalid wait argument specified.\n");
+			*status = ME_STATUS_INVALID;
+			*values = 0;
+			return ME_ERRNO_INVALID_WAIT;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		switch (wait)
+		{
+			case ME_WAIT_IDLE:
+				wait_event_interruptible(instance->wait_queue, !mevirtual_ai_is_running(instance));
+				if (instance->status != ai_status_stream_end)
+				{
+					PDEBUG("Wait for IDLE canceled. 0x%x\n", instance->status);
+					err = ME_ERRNO_CANCELLED;
+				}
+				break;
+
+			case ME_WAIT_BUSY:
+				wait_event_interruptible(instance->wait_queue, (mevirtual_ai_is_running(instance) || (instance->status == ai_status_none)));
+				if (instance->status == ai_status_none)
+				{
+					PDEBUG("Wait for BUSY canceled.\n");
+					err = ME_ERRNO_CANCELLED;
+				}
+				break;
+
+			case ME_WAIT_START:
+				old_count = (*values) ? *values : instance->stream_start_count;
+				wait_event_interruptible(instance->wait_queue, ((old_count != instance->stream_start_count) || (instance->status == ai_status_none)));
+				if (instance->status == ai_status_none)
+				{
+					PDEBUG("Wait for START canceled.\n");
+					err = ME_ERRNO_CANCELLED;
+				}
+				break;
+
+			case ME_WAIT_STOP:
+				old_count = (*values) ? *values : instance->stream_stop_count;
+				wait_event_interruptible(instance->wait_queue, ((old_count != instance->stream_stop_count) || (instance->status == ai_status_none)));
+				if (instance->status != ai_status_stream_end)
+				{
+					PDEBUG("Wait for STOP canceled. 0x%x\n", instance->status);
+					err = ME_ERRNO_CANCELLED;
+				}
+				break;
+		}
+
+		if (signal_pending(current))
+		{
+			PERROR("Wait on status interrupted.\n");
+			err = ME_ERRNO_SIGNAL;
+		}
+
+		*status = (mevirtual_ai_is_running(instance)) ? ME_STATUS_BUSY : ME_STATUS_IDLE;
+		switch (wait)
+		{
+			case ME_WAIT_START:
+				*values = instance->stream_start_count;
+				break;
+
+			case ME_WAIT_STOP:
+				*values = instance->stream_stop_count;
+				break;
+
+			default:
+				*values = me_seg_buf_values(instance->seg_buf);
+		}
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ai_query_number_channels(me_subdevice_t* subdevice, int* number)
+{
+	PDEBUG("executed. idx=0\n");
+
+	*number = ((mevirtual_ai_subdevice_t *) subdevice)->channels;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_query_subdevice_type(me_subdevice_t* subdevice, int* type, int* subtype)
+{
+	PDEBUG("executed. idx=0\n");
+
+	*type = ME_TYPE_AI;
+	*subtype = ME_SUBTYPE_STREAMING;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_query_subdevice_caps(me_subdevice_t* subdevice, int* caps)
+{
+	PDEBUG("executed. idx=0\n");
+
+	*caps = mevirtual_AI_CAPS;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_query_subdevice_caps_args(me_subdevice_t* subdevice, int cap, int* args, int* count)
+{
+	mevirtual_ai_subdevice_t* instance;
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	PDEBUG("executed. idx=0\n");
+
+	if (*count < 1)
+	{
+		PERROR("Invalid capability argument count. Should be at least 1.\n");
+		return ME_ERRNO_INVALID_CAP_ARG_COUNT;
+	}
+
+	*count = 1;
+	switch (cap)
+	{
+		case ME_CAP_AI_FIFO_SIZE:
+			*args = instance->fifo_size;
+			break;
+
+		case ME_CAP_AI_BUFFER_SIZE:
+			*args = me_seg_buf_size(instance->seg_buf);
+			break;
+
+		case ME_CAP_AI_CHANNEL_LIST_SIZE:
+			*args = MEVIRTUAL_AI_LIST_SIZE;
+			break;
+
+		default:
+			PERROR("Invalid capability.\n");
+			*count = 0;
+			*args = 0;
+			return ME_ERRNO_INVALID_CAP;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_query_number_ranges(me_subdevice_t* subdevice, int unit, int* count)
+{
+	PDEBUG("executed. idx=0\n");
+
+	*count = ((unit == ME_UNIT_VOLT) || (unit == ME_UNIT_ANY)) ? ((mevirtual_ai_subdevice_t *) subdevice)->ranges_len : 0;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_query_range_by_min_max(me_subdevice_t* subdevice, int unit, int* min, int* max, int* maxdata, int* range)
+{
+	mevirtual_ai_subdevice_t* instance;
+	int i;
+	int r = -1;
+	int diff = 21E6;
+
+	PDEBUG("executed. idx=0\n");
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	if (*max < *min)
+	{
+		PERROR("Invalid minimum and maximum values specified. MIN: %d > MAX: %d\n", *min, *max);
+		return ME_ERRNO_INVALID_MIN_MAX;
+	}
+
+	if ((unit != ME_UNIT_VOLT) && (unit != ME_UNIT_ANY))
+	{
+		PERROR("Invalid physical unit specified. Should be ME_UNIT_VOLT.\n");
+		return ME_ERRNO_INVALID_UNIT;
+	}
+
+	for (i = 0; i < instance->ranges_len; i++)
+	{
+		if ((instance->ranges[i].min <= *min) && (instance->ranges[i].max >= *max))
+		{
+			if ((instance->ranges[i].max - instance->ranges[i].min) - (*max - *min) < diff)
+			{
+				r = i;
+				diff = (instance->ranges[i].max - instance->ranges[i].min) - (*max - *min);
+			}
+		}
+	}
+
+	if (r < 0)
+	{
+		PERROR("No matching range found.\n");
+		return ME_ERRNO_NO_RANGE;
+	}
+
+	*min = instance->ranges[r].min;
+	*max = instance->ranges[r].max;
+	*maxdata = MEVIRTUAL_AI_MAX_DATA;
+	*range = r;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_query_range_info(me_subdevice_t* subdevice, int range, int* unit, int* min, int* max, int* maxdata)
+{
+	mevirtual_ai_subdevice_t* instance;
+
+	PDEBUG("executed. idx=0\n");
+
+	instance = (mevirtual_ai_subdevice_t *) subdevice;
+
+	if ((range < 0) || (range >= instance->ranges_len))
+	{
+		PERROR("Invalid range specified. Must be between 0 and %d.\n", instance->ranges_len - 1);
+		return ME_ERRNO_INVALID_RANGE;
+	}
+
+	*unit = ME_UNIT_VOLT;
+	*min = instance->ranges[range].min;
+	*max = instance->ranges[range].max;
+	*maxdata = MEVIRTUAL_AI_MAX_DATA;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ai_query_timer(me_subdevice_t* subdevice, int timer, int* base_frequency, uint64_t* min_ticks, uint64_t* max_ticks)
+{
+	PDEBUG("executed. idx=0\n");
+
+	*base_frequency = MEVIRTUAL_BASE_FREQUENCY;
+	switch (timer)
+	{
+		case ME_TIMER_ACQ_START:
+			*min_ticks = MEVIRTUAL_AI_MIN_ACQ_TICKS;
+			*max_ticks = MEVIRTUAL_AI_MAX_ACQ_TICKS;
+			break;
+
+		case ME_TIMER_SCAN_START:
+			*min_ticks = MEVIRTUAL_AI_MIN_SCAN_TICKS;
+			*max_ticks = MEVIRTUAL_AI_MAX_SCAN_TICKS;
+			break;
+
+		case ME_TIMER_CONV_START:
+			*min_ticks = MEVIRTUAL_AI_MIN_CHAN_TICKS;
+			*max_ticks = MEVIRTUAL_AI_MAX_CHAN_TICKS;
+			break;
+
+		default:
+			PERROR("Invalid timer specified. Must be ME_TIMER_ACQ_START, ME_TIMER_SCAN_START or ME_TIMER_CONV_START.\n");
+			return ME_ERRNO_INVALID_TIMER;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static int mevirtual_ai_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
+{//Dedicated IRQ handling point. Moves all values that are due since start from 'FIFO' to buffer.
+	mevirtual_ai_subdevice_t* instance = (mevirtual_ai_subdevice_t *)subdevice;
+	uint64_t due;
+
+	ME_HANDLER_PROTECTOR;
+		if (mevirtual_ai_is_running(instance))
+		{
+			due = mevirtual_ai_values_due(instance);
+
+			if (due - instance->produced > instance->fifo_size)
+			{// Interrupt came too late. Hardware would lose data.
+				PERROR("FIFO overflow. %llu values pending.\n", due - instance->produced);
+				instance->status = ai_status_stream_fifo_error;
+				instance->stream_stop_count++;
+			}
+			else
+			{
+				while (instance->produced < due)
+				{
+					if (me_seg_buf_put(instance->seg_buf, (uint16_t)(instance->produced & MEVIRTUAL_AI_MAX_DATA)))
+					{
+						PERROR("Software buffer overflow.\n");
+						instance->status = ai_status_stream_buffer_error;
+						instance->stream_stop_count++;
+						break;
+					}
+					instance->produced++;
+				}
+
+				if (instance->stop_count && (instance->produced >= instance->stop_count))
+				{
+					instance->status = ai_status_stream_end;
+					instance->stream_stop_count++;
+				}
+			}
+		}
+	ME_FREE_HANDLER_PROTECTOR;
+
+	wake_up_interruptible_all(&instance->wait_queue);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static enum hrtimer_restart mevirtual_ai_timer(struct hrtimer* timer)
+{
+	mevirtual_ai_subdevice_t* instance = container_of(timer, mevirtual_ai_subdevice_t, timer);
+
+	mevirtual_ai_irq_handle(&instance->base, 0);
+
+	if (!mevirtual_ai_is_running(instance))
+	{
+		return HRTIMER_NORESTART;
+	}
+
+	hrtimer_forward_now(timer, ns_to_ktime(instance->irq_period));
+	return HRTIMER_RESTART;
+}
+
+mevirtual_ai_subdevice_t* mevirtual_ai_constr(unsigned int idx, unsigned int channels, unsigned int fifo_size, unsigned int min_irq_period, mevirtual_loopback_t* loopback)
+{
+	mevirtual_ai_subdevice_t* subdevice;
+
+	PDEBUG("executed. idx=%d\n", idx);
+
+	if ((channels > MEVIRTUAL_MAX_AI_CHANNELS) || !fifo_size)
+	{
+		PERROR("Invalid AI shape. Maximum is %d channels and FIFO can not be empty.\n", MEVIRTUAL_MAX_AI_CHANNELS);
+		return NULL;
+	}
+
+	// Allocate memory for subdevice instance.
+	subdevice = kzalloc(sizeof(mevirtual_ai_subdevice_t), GFP_KERNEL);
+	if (!subdevice)
+	{
+		PERROR("Cannot get memory for subdevice instance.\n");
+		return NULL;
+	}
+
+	// Initialize subdevice base class.
+	if (me_subdevice_init(&subdevice->base))
+	{
+		PERROR("Cannot initialize subdevice base class instance.\n");
+		kfree(subdevice);
+		return NULL;
+	}
+
+	// Initialize circular buffer.
+	subdevice->seg_buf = create_seg_buffer(MEVIRTUAL_AI_SEG_BUF_CHUNK_COUNT, MEVIRTUAL_AI_SEG_BUF_CHUNK_SIZE);
+	if (!subdevice->seg_buf)
+	{
+		PERROR("Cannot initialize segmented buffer.\n");
+		me_subdevice_deinit(&subdevice->base);
+		kfree(subdevice);
+		return NULL;
+	}
+
+	init_waitqueue_head(&subdevice->wait_queue);
+	mevirtual_timer_init(&subdevice->timer, mevirtual_ai_timer);
+
+	subdevice->base.idx = idx;
+	subdevice->loopback = loopback;
+	subdevice->channels = channels;
+	subdevice->fifo_size = fifo_size;
+	subdevice->min_irq_period = (uint64_t)min_irq_period * NSEC_PER_USEC;
+
+	// Initialize ranges. Same as ME-4600.
+	subdevice->ranges_len = MEVIRTUAL_AI_RANGES;
+	subdevice->ranges[0].min = -10E6;
+	subdevice->ranges[0].max = 9999695;
+
+	subdevice->ranges[1].min = 0;
+	subdevice->ranges[1].max = 9999847;
+
+	subdevice->ranges[2].min = -25E5;
+	subdevice->ranges[2].max = 2499924;
+
+	subdevice->ranges[3].min = 0;
+	subdevice->ranges[3].max = 2499962;
+
+	// Override base class methods.
+	subdevice->base.me_subdevice_destructor = mevirtual_ai_destructor;
+	subdevice->base.me_subdevice_io_reset_subdevice = mevirtual_ai_io_reset_subdevice;
+	subdevice->base.me_subdevice_io_single_config = mevirtual_ai_io_single_config;
+	subdevice->base.me_subdevice_io_single_read = mevirtual_ai_io_single_read;
+	subdevice->base.me_subdevice_io_stream_config = mevirtual_ai_io_stream_config;
+	subdevice->base.me_subdevice_io_stream_new_values = mevirtual_ai_io_stream_new_values;
+	subdevice->base.me_subdevice_io_stream_read = mevirtual_ai_io_stream_read;
+	subdevice->base.me_subdevice_io_stream_start = mevirtual_ai_io_stream_start;
+	subdevice->base.me_subdevice_io_stream_status = mevirtual_ai_io_stream_status;
+	subdevice->base.me_subdevice_io_stream_stop = mevirtual_ai_io_stream_stop;
+	subdevice->base.me_subdevice_query_number_channels = mevirtual_ai_query_number_channels;
+	subdevice->base.me_subdevice_query_subdevice_type = mevirtual_ai_query_subdevice_type;
+	subdevice->base.me_subdevice_query_subdevice_caps = mevirtual_ai_query_subdevice_caps;
+	subdevice->base.me_subdevice_query_subdevice_caps_args = mevirtual_ai_query_subdevice_caps_args;
+	subdevice->base.me_subdevice_query_number_ranges = mevirtual_ai_query_number_ranges;
+	subdevice->base.me_subdevice_query_range_by_min_max = mevirtual_ai_query_range_by_min_max;
+	subdevice->base.me_subdevice_query_range_info = mevirtual_ai_query_range_info;
+	subdevice->base.me_subdevice_query_timer = mevirtual_ai_query_timer;
+
+	subdevice->base.me_subdevice_irq_handle = mevirtual_ai_irq_handle;
+
+	return subdevice;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file mevirtual_ai.h
+ *
+ * @brief The virtual analog input subdevice class.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifdef __KERNEL__
+
+# ifndef _MEVIRTUAL_AI_H_
+#  define _MEVIRTUAL_AI_H_
+
+#  include <linux/hrtimer.h>
+
+#  include "mesubdevice.h"
+#  include "meseg_buf.h"
+#  include "mevirtual_device.h"
+
+#  define MEVIRTUAL_AI_MAX_DATA			0xFFFF
+
+#  define MEVIRTUAL_AI_MIN_CHAN_TICKS	66LL
+#  define MEVIRTUAL_AI_MAX_CHAN_TICKS	0xFFFFFFFFLL
+#  define MEVIRTUAL_AI_MIN_ACQ_TICKS	0LL
+#  define MEVIRTUAL_AI_MAX_ACQ_TICKS	0xFFFFFFFFLL
+#  define MEVIRTUAL_AI_MIN_SCAN_TICKS	66LL
+#  define MEVIRTUAL_AI_MAX_SCAN_TICKS	0xFFFFFFFFFLL
+
+#  define MEVIRTUAL_AI_LIST_SIZE		1024
+#  define MEVIRTUAL_AI_RANGES			4
+
+#  define MEVIRTUAL_AI_SEG_BUF_CHUNK_SIZE	(PAGE_SIZE)
+#  define MEVIRTUAL_AI_SEG_BUF_CHUNK_COUNT	(64)
+
+#  define mevirtual_AI_CAPS				(ME_CAPS_AI_FIFO | ME_CAPS_AI_FIFO_THRESHOLD)
+
+	enum MEVIRTUAL_AI_STATUS
+	{
+		ai_status_none,
+		ai_status_single_configured,
+		ai_status_stream_configured,
+		ai_status_stream_run,
+		ai_status_stream_end_wait,
+		ai_status_stream_end,
+		ai_status_stream_fifo_error,
+		ai_status_stream_buffer_error,
+		ai_status_last
+	};
+
+	typedef struct //mevirtual_range_entry
+	{
+		int min;
+		int max;
+	} mevirtual_range_entry_t;
+
+	/**
+	* @brief The virtual analog input subdevice class.
+	*
+	* Stream is produced by a timer. Each tick puts all values due since start into buffer.
+	* Stream data is a ramp: value n of acquisition is (n & MEVIRTUAL_AI_MAX_DATA).
+	* Single reads return AO output looped back to AI channel with same number.
+	*/
+	typedef struct //mevirtual_ai_subdevice
+	{
+		// Inheritance
+		me_subdevice_t base;						/**< The subdevice base class. */
+
+		// Attributes
+		mevirtual_loopback_t* loopback;
+
+		unsigned int channels;						/**< The number of channels available on this subdevice. */
+		unsigned int fifo_size;						/**< Values that can wait for late interrupt. */
+		uint64_t min_irq_period;					/**< The shortest time between two ticks [ns]. */
+		int single_range[MEVIRTUAL_MAX_AI_CHANNELS];
+
+		volatile enum MEVIRTUAL_AI_STATUS status;	/**< The current stream status flag. */
+		wait_queue_head_t wait_queue;				/**< Wait queue for blocking calls. */
+
+		// Stream configuration
+		unsigned int chan_list_len;					/**< The length of the user defined channel list. */
+		uint64_t acq_period;						/**< Start delay [ns]. */
+		uint64_t scan_period;						/**< Time between two lists [ns]. */
+		uint64_t conv_period;						/**< Time between two values in list [ns]. */
+		uint64_t irq_period;						/**< Time between two ticks [ns]. */
+		uint64_t stop_count;						/**< Values to acquire. 0: infinite. */
+
+		// Producer
+		struct hrtimer timer;
+		ktime_t start_time;
+		volatile uint64_t produced;					/**< Values generated since start. */
+		volatile int stream_start_count;
+		volatile int stream_stop_count;
+		int empty_read_count;
+
+		unsigned int ranges_len;
+		mevirtual_range_entry_t ranges[MEVIRTUAL_AI_RANGES];
+
+		// Software buffer
+		me_seg_buf_t* seg_buf;						/**< Segmented circular buffer holding measurment data. */
+	} mevirtual_ai_subdevice_t;
+
+
+	/**
+	* @brief The constructor to generate a virtual analog input subdevice instance.
+	*
+	* @param idx The index of subdevice.
+	* @param channels The number of channels.
+	* @param fifo_size Size of FIFO in values.
+	* @param min_irq_period The shortest time between two producer ticks [us].
+	* @param loopback The wires of device.
+	*
+	* @return Pointer to new instance on success.\n
+	* NULL on error.
+	*/
+	mevirtual_ai_subdevice_t* mevirtual_ai_constr(unsigned int idx, unsigned int channels, unsigned int fifo_size, unsigned int min_irq_period, mevirtual_loopback_t* loopback);
+
+# endif
+#endif
@@ -0,0 +1,1077 @@
+/**
+ * @file mevirtual_ao.c
+ *
+ * @brief The virtual analog output subdevice instance.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __KERNEL__
+# error Kernel only!
+#endif
+
+# ifndef MODULE
+#  define MODULE
+# endif
+
+# include <linux/fs.h>
+# include <linux/slab.h>
+# include <linux/sched.h>
+# include <linux/math64.h>
+# include <asm/uaccess.h>
+
+# include "me_debug.h"
+# include "me_error.h"
+# include "me_defines.h"
+# include "me_spin_lock.h"
+
+# include "mevirtual_ao.h"
+
+static void mevirtual_ao_destructor(me_subdevice_t* subdevice);
+int mevirtual_ao_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep, int flags);
+int mevirtual_ao_io_single_config(me_subdevice_t* subdevice, struct file* filep, int channel,
+										int single_config, int ref, int trig_chain, int trig_type, int trig_edge, int flags);
+int mevirtual_ao_io_single_write(me_subdevice_t* subdevice, struct file* filep, int channel, int value, int time_out, int flags);
+int mevirtual_ao_io_stream_config(me_subdevice_t* subdevice, struct file* filep,
+										meIOStreamSimpleConfig_t* config_list, int count, meIOStreamSimpleTriggers_t* trigger, int fifo_irq_threshold, int flags);
+int mevirtual_ao_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep, int time_out, int* count, int flags);
+int mevirtual_ao_io_stream_write(me_subdevice_t* subdevice, struct file* filep, int write_mode, int* values, int* count, int time_out, int flags);
+int mevirtual_ao_io_stream_start(me_subdevice_t* subdevice, struct file* filep, int start_mode, int time_out, int flags);
+int mevirtual_ao_io_stream_stop(me_subdevice_t* subdevice, struct file* filep, int stop_mode, int time_out, int flags);
+int mevirtual_ao_io_stream_status(me_subdevice_t* subdevice, struct file* filep, int wait, int* status, int* values, int flags);
+int mevirtual_ao_query_number_channels(me_subdevice_t* subdevice, int* number);
+int mevirtual_ao_query_subdevice_type(me_subdevice_t* subdevice, int* type, int* subtype);
+int mevirtual_ao_query_subdevice_caps(me_subdevice_t* subdevice, int* caps);
+int mevirtual_ao_query_subdevice_caps_args(me_subdevice_t* subdevice, int cap, int* args, int* count);
+int mevirtual_ao_query_number_ranges(me_subdevice_t* subdevice, int unit, int* count);
+int mevirtual_ao_query_range_by_min_max(me_subdevice_t* subdevice, int unit, int* min, int* max, int* maxdata, int* range);
+int mevirtual_ao_query_range_info(me_subdevice_t* subdevice, int range, int* unit, int* min, int* max, int* maxdata);
+int mevirtual_ao_query_timer(me_subdevice_t* subdevice, int timer, int* base_frequency, uint64_t* min_ticks, uint64_t* max_ticks);
+
+static int mevirtual_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status);
+static enum hrtimer_restart mevirtual_ao_timer(struct hrtimer* timer);
+
+/// Range: -10V .. +10V [uV]
+# define MEVIRTUAL_AO_RANGE_MIN		-10000000
+# define MEVIRTUAL_AO_RANGE_MAX		9999695
+
+static int mevirtual_ao_is_running(mevirtual_ao_subdevice_t* instance)
+{
+	return (instance->status == ao_status_stream_run) || (instance->status == ao_status_stream_end_wait);
+}
+
+/** @brief Stops consumer. Call without subdevice lock. Timer callback only tries the lock.
+*/
+static void mevirtual_ao_stop_timer(mevirtual_ao_subdevice_t* instance)
+{
+	hrtimer_cancel(&instance->timer);
+}
+
+static void mevirtual_ao_destructor(me_subdevice_t* subdevice)
+{
+	mevirtual_ao_subdevice_t* instance;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	instance->status = ao_status_none;
+	mevirtual_ao_stop_timer(instance);
+
+	if (instance->seg_buf)
+	{
+		destroy_seg_buffer(&instance->seg_buf);
+	}
+	me_subdevice_deinit(&instance->base);
+}
+
+int mevirtual_ao_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags)
+	{
+		PERROR("Invalid flags specified. Must be ME_IO_RESET_SUBDEVICE_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			instance->status = ao_status_none;
+			instance->stop_on_empty = 0;
+			instance->wraparound = 0;
+			instance->stop_count = 0;
+			if (instance->seg_buf)
+			{
+				me_seg_buf_reset(instance->seg_buf);
+			}
+			instance->loopback->ao_value[instance->base.idx] = MEVIRTUAL_AO_ZERO;
+		ME_UNLOCK_PROTECTOR;
+		mevirtual_ao_stop_timer(instance);
+		wake_up_interruptible_all(&instance->wait_queue);
+	ME_SUBDEVICE_EXIT;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ao_io_single_config(me_subdevice_t* subdevice, struct file* filep, int channel,
+										int single_config, int ref, int trig_chain, int trig_type, int trig_edge, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_SINGLE_CONFIG_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (channel)
+	{
+		PERROR("Invalid channel number specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	if (single_config)
+	{
+		PERROR("Invalid range specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_SINGLE_CONFIG;
+	}
+
+	if (ref != ME_REF_AO_GROUND)
+	{
+		PERROR("Invalid reference. Must be ME_REF_AO_GROUND.\n");
+		return ME_ERRNO_INVALID_REF;
+	}
+
+	if ((trig_type != ME_TRIG_TYPE_SW) || (trig_chain != ME_TRIG_CHAN_DEFAULT) || trig_edge)
+	{
+		PERROR("Invalid trigger specified. Only ME_TRIG_TYPE_SW on ME_TRIG_CHAN_DEFAULT is supported.\n");
+		return ME_ERRNO_INVALID_TRIG_TYPE;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			if (mevirtual_ao_is_running(instance))
+			{
+				PERROR("Subdevice is busy.\n");
+				err = ME_ERRNO_SUBDEVICE_BUSY;
+			}
+			else
+			{
+				instance->status = ao_status_single_configured;
+				instance->loopback->ao_value[instance->base.idx] = MEVIRTUAL_AO_ZERO;
+			}
+		ME_UNLOCK_PROTECTOR;
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ao_io_single_write(me_subdevice_t* subdevice, struct file* filep, int channel, int value, int time_out, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags & ~ME_IO_SINGLE_TYPE_WRITE_NONBLOCKING)
+	{
+		PERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (channel)
+	{
+		PERROR("Invalid channel number specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	if ((value < 0) || (value > MEVIRTUAL_AO_MAX_DATA))
+	{
+		PERROR("Invalid value provided. Must be between 0 and 0x%x.\n", MEVIRTUAL_AO_MAX_DATA);
+		return ME_ERRNO_VALUE_OUT_OF_RANGE;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			if (instance->status != ao_status_single_configured)
+			{
+				PERROR("Subdevice is not configured to work in single mode.\n");
+				err = (mevirtual_ao_is_running(instance)) ? ME_ERRNO_SUBDEVICE_BUSY : ME_ERRNO_PREVIOUS_CONFIG;
+			}
+			else
+			{
+				instance->loopback->ao_value[instance->base.idx] = value;
+			}
+		ME_UNLOCK_PROTECTOR;
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ao_io_stream_config(me_subdevice_t* subdevice, struct file* filep,
+										meIOStreamSimpleConfig_t* config_list, int count, meIOStreamSimpleTriggers_t* trigger, int fifo_irq_threshold, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+	uint64_t conv_ticks;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags & ~ME_IO_STREAM_CONFIG_WRAPAROUND)
+	{
+		PERROR("Invalid flags. Should be ME_IO_STREAM_CONFIG_NO_FLAGS or ME_IO_STREAM_CONFIG_WRAPAROUND.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (count != 1)
+	{
+		PERROR("Invalid stream configuration list count specified. Must be 1.\n");
+		return ME_ERRNO_INVALID_CONFIG_LIST_COUNT;
+	}
+
+	if (config_list[0].iChannel)
+	{
+		PERROR("Invalid channel number specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	if (config_list[0].iRange)
+	{
+		PERROR("Invalid range specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_STREAM_CONFIG;
+	}
+
+	if (trigger->trigger_type != ME_TRIGGER_TYPE_SOFTWARE)
+	{
+		PERROR("Invalid trigger type specified. Only software trigger is supported.\n");
+		return ME_ERRNO_INVALID_ACQ_START_TRIG_TYPE;
+	}
+
+	if (trigger->acq_ticks || trigger->scan_ticks)
+	{
+		PERROR("Invalid acquisition or scan ticks specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_ACQ_START_ARG;
+	}
+
+	conv_ticks = (trigger->conv_ticks) ? trigger->conv_ticks : MEVIRTUAL_AO_MIN_CONV_TICKS;
+	if ((conv_ticks < MEVIRTUAL_AO_MIN_CONV_TICKS) || (conv_ticks > MEVIRTUAL_AO_MAX_CONV_TICKS))
+	{
+		PERROR("Invalid conv start trigger argument specified.\n");
+		return ME_ERRNO_INVALID_CONV_START_ARG;
+	}
+
+	switch (trigger->stop_type)
+	{
+		case ME_STREAM_STOP_TYPE_MANUAL:
+			break;
+
+		case ME_STREAM_STOP_TYPE_ACQ_LIST:
+		case ME_STREAM_STOP_TYPE_SCAN_VALUE:
+			if (trigger->stop_count <= 0)
+			{
+				PERROR("Invalid stop count specified. Must be at least 1.\n");
+				return ME_ERRNO_INVALID_SCAN_STOP_ARG;
+			}
+			break;
+
+		default:
+			PERROR("Invalid stop trigger type specified.\n");
+			return ME_ERRNO_INVALID_SCAN_STOP_TRIG_TYPE;
+	}
+
+	if ((fifo_irq_threshold < 0) || (fifo_irq_threshold > instance->fifo_size))
+	{
+		PERROR("Invalid fifo irq threshold specified. Must be between 0 and %d.\n", instance->fifo_size);
+		return ME_ERRNO_INVALID_FIFO_IRQ_THRESHOLD;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			if (mevirtual_ao_is_running(instance))
+			{
+				PERROR("Subdevice is busy.\n");
+				err = ME_ERRNO_SUBDEVICE_BUSY;
+			}
+			else
+			{
+				instance->conv_period = div64_u64(conv_ticks * NSEC_PER_SEC, MEVIRTUAL_BASE_FREQUENCY);
+				if (!instance->conv_period)
+					instance->conv_period = 1;
+				instance->stop_count = (trigger->stop_type == ME_STREAM_STOP_TYPE_MANUAL) ? 0 : trigger->stop_count;
+				instance->wraparound = (flags & ME_IO_STREAM_CONFIG_WRAPAROUND) ? 1 : 0;
+
+				// Consumer runs when FIFO is half (or threshold) empty.
+				instance->irq_period = instance->conv_period * ((fifo_irq_threshold) ? fifo_irq_threshold : (instance->fifo_size >> 1));
+				if (instance->irq_period < instance->min_irq_period)
+					instance->irq_period = instance->min_irq_period;
+
+				me_seg_buf_reset(instance->seg_buf);
+				instance->status = ao_status_stream_configured;
+			}
+		ME_UNLOCK_PROTECTOR;
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ao_io_stream_new_values(me_subdevice_t* subdevice, struct file* filep, int time_out, int* count, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+	unsigned long int delay = LONG_MAX - 2;
+	unsigned int reads_count;
+	int status;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags & ~(ME_IO_STREAM_NEW_VALUES_SCREEN_FLAG | ME_IO_STREAM_NEW_VALUES_ERROR_REPORT_FLAG))
+	{
+		PERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (time_out)
+	{
+		delay = (time_out * HZ) / 1000;
+		if (!delay)
+			delay = 1;
+		if (delay>LONG_MAX - 2)
+			delay = LONG_MAX - 2;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		status = instance->status;
+		reads_count = instance->seg_buf->header.reads_count;
+		if (mevirtual_ao_is_running(instance) && !me_seg_buf_space(instance->seg_buf))
+		{
+			if (wait_event_interruptible_timeout(
+					instance->wait_queue,
+					((reads_count != instance->seg_buf->header.reads_count) || (status != instance->status)),
+					delay) <= 0)
+			{
+				if (signal_pending(current))
+				{
+					PERROR("Wait on free space interrupted.\n");
+					err = ME_ERRNO_SIGNAL;
+				}
+				else
+				{
+					PERROR("Wait on free space timed out.\n");
+					err = ME_ERRNO_TIMEOUT;
+				}
+			}
+		}
+
+		if (!err && (flags & ME_IO_STREAM_NEW_VALUES_ERROR_REPORT_FLAG))
+		{
+			if (instance->status == ao_status_stream_fifo_error)
+			{
+				err = ME_ERRNO_HARDWARE_BUFFER_UNDERFLOW;
+			}
+			else if (instance->status == ao_status_none)
+			{
+				err = ME_ERRNO_CANCELLED;
+			}
+		}
+
+		*count = me_seg_buf_space(instance->seg_buf);
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ao_io_stream_write(me_subdevice_t* subdevice, struct file* filep, int write_mode, int* values, int* count, int time_out, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+	unsigned long int delay = LONG_MAX - 2;
+	unsigned long int j;
+	int c = *count;
+	int written = 0;
+	int value;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_STREAM_WRITE_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((write_mode != ME_WRITE_MODE_BLOCKING) && (write_mode != ME_WRITE_MODE_NONBLOCKING) && (write_mode != ME_WRITE_MODE_PRELOAD))
+	{
+		PERROR("Invalid write mode specified.\n");
+		return ME_ERRNO_INVALID_WRITE_MODE;
+	}
+
+	if (c < 0)
+	{
+		PERROR("Request has invalid value's counter.\n");
+		return ME_ERRNO_INVALID_VALUE_COUNT;
+	}
+
+	if (time_out)
+	{
+		delay = (time_out * HZ) / 1000;
+		if (!delay)
+			delay = 1;
+		if (delay>LONG_MAX - 2)
+			delay = LONG_MAX - 2;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		switch (instance->status)
+		{
+			case ao_status_stream_configured:
+			case ao_status_stream_end:
+				break;
+
+			case ao_status_stream_run:
+			case ao_status_stream_end_wait:
+				if (write_mode == ME_WRITE_MODE_PRELOAD)
+				{
+					PERROR("Preload is not possible while running.\n");
+					err = ME_ERRNO_SUBDEVICE_BUSY;
+					goto ERROR;
+				}
+				break;
+
+			case ao_status_stream_fifo_error:
+				err = ME_ERRNO_HARDWARE_BUFFER_UNDERFLOW;
+				goto ERROR;
+
+			default:
+				PERROR("Subdevice is not configured to work in stream mode.\n");
+				err = ME_ERRNO_PREVIOUS_CONFIG;
+				goto ERROR;
+		}
+
+		j = jiffies;
+		while (written < c)
+		{
+			if (!me_seg_buf_space(instance->seg_buf))
+			{
+				if ((write_mode != ME_WRITE_MODE_BLOCKING) || !mevirtual_ao_is_running(instance))
+					break;
+
+				wait_event_interruptible_timeout(
+					instance->wait_queue,
+					(me_seg_buf_space(instance->seg_buf) || !mevirtual_ao_is_running(instance)),
+					delay);
+
+				if (signal_pending(current))
+				{
+					PERROR("Wait on free space interrupted.\n");
+					err = ME_ERRNO_SIGNAL;
+					break;
+				}
+
+				if ((jiffies - j) >= delay)
+				{
+					PERROR("Wait on free space timed out.\n");
+					err = ME_ERRNO_TIMEOUT;
+					break;
+				}
+
+				if (instance->status == ao_status_stream_fifo_error)
+				{
+					err = ME_ERRNO_HARDWARE_BUFFER_UNDERFLOW;
+					break;
+				}
+				continue;
+			}
+
+			if (get_user(value, values + written))
+			{
+				PERROR("Cannot copy new values from user.\n");
+				err = ME_ERRNO_INTERNAL;
+				break;
+			}
+
+			ME_LOCK_PROTECTOR;
+				me_seg_buf_put(instance->seg_buf, value & MEVIRTUAL_AO_MAX_DATA);
+			ME_UNLOCK_PROTECTOR;
+			written++;
+		}
+		*count = written;
+ERROR:
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ao_io_stream_start(me_subdevice_t* subdevice, struct file* filep, int start_mode, int time_out, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags & ~ME_IO_STREAM_START_TYPE_TRIG_SYNCHRONOUS)
+	{
+		PERROR("Invalid flags specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((start_mode != ME_START_MODE_BLOCKING) && (start_mode != ME_START_MODE_NONBLOCKING))
+	{
+		PERROR("Invalid start mode specified. Must be ME_START_MODE_BLOCKING or ME_START_MODE_NONBLOCKING.\n");
+		return ME_ERRNO_INVALID_START_MODE;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			switch (instance->status)
+			{
+				case ao_status_stream_configured:
+				case ao_status_stream_end:
+					break;
+
+				case ao_status_stream_run:
+				case ao_status_stream_end_wait:
+					PERROR("Subdevice is busy.\n");
+					err = ME_ERRNO_SUBDEVICE_BUSY;
+					break;
+
+				case ao_status_stream_fifo_error:
+					err = ME_ERRNO_HARDWARE_BUFFER_UNDERFLOW;
+					break;
+
+				default:
+					PERROR("Subdevice is not configured to work in stream mode.\n");
+					err = ME_ERRNO_PREVIOUS_CONFIG;
+			}
+
+			if (!err && !me_seg_buf_values(instance->seg_buf))
+			{
+				PERROR("No values in buffer. Write (preload) first.\n");
+				err = ME_ERRNO_PREVIOUS_CONFIG;
+			}
+
+			if (!err)
+			{
+				instance->consumed = 0;
+				instance->stop_on_empty = 0;
+				instance->start_time = ktime_get();
+				instance->status = ao_status_stream_run;
+				instance->stream_start_count++;
+			}
+		ME_UNLOCK_PROTECTOR;
+
+		if (!err)
+		{
+			// Software trigger: stream starts immediately. Both start modes return at once.
+			hrtimer_start(&instance->timer, ns_to_ktime(instance->irq_period), HRTIMER_MODE_REL);
+			wake_up_interruptible_all(&instance->wait_queue);
+		}
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ao_io_stream_stop(me_subdevice_t* subdevice, struct file* filep, int stop_mode, int time_out, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+	unsigned long int delay = LONG_MAX - 2;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags & ~(ME_IO_STREAM_STOP_TYPE_PRESERVE_BUFFERS | ME_IO_STREAM_STOP_NONBLOCKING))
+	{
+		PERROR("Invalid flag specified.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if ((stop_mode != ME_STOP_MODE_IMMEDIATE) && (stop_mode != ME_STOP_MODE_LAST_VALUE))
+	{
+		PERROR("Invalid stop mode specified. Must be ME_STOP_MODE_IMMEDIATE or ME_STOP_MODE_LAST_VALUE.\n");
+		return ME_ERRNO_INVALID_STOP_MODE;
+	}
+
+	if (time_out)
+	{
+		delay = (time_out * HZ) / 1000;
+		if (!delay)
+			delay = 1;
+		if (delay>LONG_MAX - 2)
+			delay = LONG_MAX - 2;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			if (mevirtual_ao_is_running(instance))
+			{
+				if ((stop_mode == ME_STOP_MODE_LAST_VALUE) && !instance->wraparound)
+				{// Output rest of buffer.
+					instance->stop_on_empty = 1;
+					instance->status = ao_status_stream_end_wait;
+				}
+				else
+				{
+					instance->status = ao_status_stream_end;
+					instance->stream_stop_count++;
+				}
+			}
+			else if (instance->status == ao_status_stream_fifo_error)
+			{
+				instance->status = ao_status_stream_end;
+			}
+		ME_UNLOCK_PROTECTOR;
+
+		if ((instance->status == ao_status_stream_end_wait) && !(flags & ME_IO_STREAM_STOP_NONBLOCKING))
+		{
+			wait_event_interruptible_timeout(instance->wait_queue, (instance->status != ao_status_stream_end_wait), delay);
+
+			if (signal_pending(current))
+			{
+				PERROR("Wait on stop interrupted.\n");
+				err = ME_ERRNO_SIGNAL;
+			}
+			else if (instance->status == ao_status_stream_end_wait)
+			{
+				PERROR("Wait on stop timed out.\n");
+				err = ME_ERRNO_TIMEOUT;
+			}
+		}
+
+		if (instance->status != ao_status_stream_end_wait)
+		{
+			mevirtual_ao_stop_timer(instance);
+			if (!(flags & ME_IO_STREAM_STOP_TYPE_PRESERVE_BUFFERS))
+			{
+				ME_LOCK_PROTECTOR;
+					me_seg_buf_reset(instance->seg_buf);
+				ME_UNLOCK_PROTECTOR;
+			}
+		}
+		wake_up_interruptible_all(&instance->wait_queue);
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ao_io_stream_status(me_subdevice_t* subdevice, struct file* filep, int wait, int* status, int* values, int flags)
+{
+	mevirtual_ao_subdevice_t* instance;
+	int old_count;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_STREAM_STATUS_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	switch (wait)
+	{
+		case ME_WAIT_NONE:
+		case ME_WAIT_IDLE:
+		case ME_WAIT_BUSY:
+		case ME_WAIT_START:
+		case ME_WAIT_STOP:
+			break;
+
+		default:
+			PERROR("Invalid wait argument specified.\n");
+			*status = ME_STATUS_INVALID;
+			*values = 0;
+			return ME_ERRNO_INVALID_WAIT;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		switch (wait)
+		{
+			case ME_WAIT_IDLE:
+				wait_event_interruptible(instance->wait_queue, !mevirtual_ao_is_running(instance));
+				break;
+
+			case ME_WAIT_BUSY:
+				wait_event_interruptible(instance->wait_queue, (mevirtual_ao_is_running(instance) || (instance->status == ao_status_none)));
+				break;
+
+			case ME_WAIT_START:
+				old_count = (*values) ? *values : instance->stream_start_count;
+				wait_event_interruptible(instance->wait_queue, ((old_count != instance->stream_start_count) || (instance->status == ao_status_none)));
+				break;
+
+			case ME_WAIT_STOP:
+				old_count = (*values) ? *values : instance->stream_stop_count;
+				wait_event_interruptible(instance->wait_queue, ((old_count != instance->stream_stop_count) || (instance->status == ao_status_none)));
+				break;
+		}
+
+		if (signal_pending(current))
+		{
+			PERROR("Wait on status interrupted.\n");
+			err = ME_ERRNO_SIGNAL;
+		}
+		else if ((wait != ME_WAIT_NONE) && (instance->status == ao_status_none))
+		{
+			PDEBUG("Wait canceled.\n");
+			err = ME_ERRNO_CANCELLED;
+		}
+
+		*status = (mevirtual_ao_is_running(instance)) ? ME_STATUS_BUSY : ME_STATUS_IDLE;
+		switch (wait)
+		{
+			case ME_WAIT_START:
+				*values = instance->stream_start_count;
+				break;
+
+			case ME_WAIT_STOP:
+				*values = instance->stream_stop_count;
+				break;
+
+			default:
+				*values = me_seg_buf_space(instance->seg_buf);
+		}
+
+		if (!err && (instance->status == ao_status_stream_fifo_error))
+		{
+			err = ME_ERRNO_HARDWARE_BUFFER_UNDERFLOW;
+		}
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ao_query_number_channels(me_subdevice_t* subdevice, int* number)
+{
+	PDEBUG("executed idx=%d.\n", ((mevirtual_ao_subdevice_t *) subdevice)->base.idx);
+
+	*number = 1;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ao_query_subdevice_type(me_subdevice_t* subdevice, int* type, int* subtype)
+{
+	mevirtual_ao_subdevice_t* instance;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	*type = ME_TYPE_AO;
+	*subtype = (instance->fifo_size) ? ME_SUBTYPE_STREAMING : ME_SUBTYPE_SINGLE;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ao_query_subdevice_caps(me_subdevice_t* subdevice, int* caps)
+{
+	mevirtual_ao_subdevice_t* instance;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	*caps = (instance->fifo_size) ? mevirtual_AO_CAPS : 0;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ao_query_subdevice_caps_args(me_subdevice_t* subdevice, int cap, int* args, int* count)
+{
+	mevirtual_ao_subdevice_t* instance;
+
+	instance = (mevirtual_ao_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (*count < 1)
+	{
+		PERROR("Invalid capability argument count. Should be at least 1.\n");
+		return ME_ERRNO_INVALID_CAP_ARG_COUNT;
+	}
+
+	*count = 1;
+	switch (cap)
+	{
+		case ME_CAP_AO_FIFO_SIZE:
+			*args = instance->fifo_size;
+			break;
+
+		case ME_CAP_AO_BUFFER_SIZE:
+			*args = (instance->seg_buf) ? me_seg_buf_size(instance->seg_buf) : 0;
+			break;
+
+		case ME_CAP_AO_CHANNEL_LIST_SIZE:
+			*args = 1;
+			break;
+
+		default:
+			PERROR("Invalid capability.\n");
+			*count = 0;
+			*args = 0;
+			return ME_ERRNO_INVALID_CAP;
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ao_query_number_ranges(me_subdevice_t* subdevice, int unit, int* count)
+{
+	PDEBUG("executed idx=%d.\n", ((mevirtual_ao_subdevice_t *) subdevice)->base.idx);
+
+	*count = ((unit == ME_UNIT_VOLT) || (unit == ME_UNIT_ANY)) ? 1 : 0;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ao_query_range_by_min_max(me_subdevice_t* subdevice, int unit, int* min, int* max, int* maxdata, int* range)
+{
+	PDEBUG("executed idx=%d.\n", ((mevirtual_ao_subdevice_t *) subdevice)->base.idx);
+
+	if ((unit != ME_UNIT_VOLT) && (unit != ME_UNIT_ANY))
+	{
+		PERROR("Invalid physical unit specified. Should be ME_UNIT_VOLT.\n");
+		return ME_ERRNO_INVALID_UNIT;
+	}
+
+	if (*max < *min)
+	{
+		PERROR("Invalid minimum and maximum values specified. MIN: %d > MAX: %d\n", *min, *max);
+		return ME_ERRNO_INVALID_MIN_MAX;
+	}
+
+	if ((*min < MEVIRTUAL_AO_RANGE_MIN) || (*max > MEVIRTUAL_AO_RANGE_MAX))
+	{
+		PERROR("No matching range found.\n");
+		return ME_ERRNO_NO_RANGE;
+	}
+
+	*min = MEVIRTUAL_AO_RANGE_MIN;
+	*max = MEVIRTUAL_AO_RANGE_MAX;
+	*maxdata = MEVIRTUAL_AO_MAX_DATA;
+	*range = 0;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ao_query_range_info(me_subdevice_t* subdevice, int range, int* unit, int* min, int* max, int* maxdata)
+{
+	PDEBUG("executed idx=%d.\n", ((mevirtual_ao_subdevice_t *) subdevice)->base.idx);
+
+	if (range)
+	{
+		PERROR("Invalid range specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_RANGE;
+	}
+
+	*unit = ME_UNIT_VOLT;
+	*min = MEVIRTUAL_AO_RANGE_MIN;
+	*max = MEVIRTUAL_AO_RANGE_MAX;
+	*maxdata = MEVIRTUAL_AO_MAX_DATA;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ao_query_timer(me_subdevice_t* subdevice, int timer, int* base_frequency, uint64_t* min_ticks, uint64_t* max_ticks)
+{
+	PDEBUG("executed idx=%d.\n", ((mevirtual_ao_subdevice_t *) subdevice)->base.idx);
+
+	if (timer != ME_TIMER_CONV_START)
+	{
+		PERROR("Invalid timer specified. Must be ME_TIMER_CONV_START.\n");
+		return ME_ERRNO_INVALID_TIMER;
+	}
+
+	*base_frequency = MEVIRTUAL_BASE_FREQUENCY;
+	*min_ticks = MEVIRTUAL_AO_MIN_CONV_TICKS;
+	*max_ticks = MEVIRTUAL_AO_MAX_CONV_TICKS;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static int mevirtual_ao_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
+{//Dedicated IRQ handling point. Takes all values that are due since start.
+	mevirtual_ao_subdevice_t* instance = (mevirtual_ao_subdevice_t *)subdevice;
+	uint64_t due;
+	uint16_t value = 0;
+	int status;
+	int empty = 0;
+
+	ME_HANDLER_PROTECTOR;
+		status = instance->status;
+		if ((status == ao_status_stream_run) || (status == ao_status_stream_end_wait))
+		{
+			due = div64_u64(ktime_to_ns(ktime_sub(ktime_get(), instance->start_time)), instance->conv_period) + 1;
+			if (instance->stop_count && (due > instance->stop_count))
+			{
+				due = instance->stop_count;
+			}
+
+			while (instance->consumed < due)
+			{
+				empty = (instance->wraparound) ? me_seg_buf_rotate(instance->seg_buf, &value) : me_seg_buf_get(instance->seg_buf, &value);
+				if (empty)
+					break;
+				instance->consumed++;
+				// The wire is a single word. No lock needed for readers.
+				instance->loopback->ao_value[instance->base.idx] = value;
+			}
+
+			if (instance->stop_count && (instance->consumed >= instance->stop_count))
+			{
+				instance->status = ao_status_stream_end;
+				instance->stream_stop_count++;
+			}
+			else if (empty)
+			{
+				if (instance->stop_on_empty)
+				{
+					instance->status = ao_status_stream_end;
+					instance->stream_stop_count++;
+				}
+				else
+				{
+					PERROR("Output FIFO underflow. %llu values delivered.\n", instance->consumed);
+					instance->status = ao_status_stream_fifo_error;
+					instance->stream_stop_count++;
+				}
+			}
+		}
+	ME_FREE_HANDLER_PROTECTOR;
+
+	wake_up_interruptible_all(&instance->wait_queue);
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static enum hrtimer_restart mevirtual_ao_timer(struct hrtimer* timer)
+{
+	mevirtual_ao_subdevice_t* instance = container_of(timer, mevirtual_ao_subdevice_t, timer);
+
+	mevirtual_ao_irq_handle(&instance->base, 0);
+
+	if (!mevirtual_ao_is_running(instance))
+	{
+		return HRTIMER_NORESTART;
+	}
+
+	hrtimer_forward_now(timer, ns_to_ktime(instance->irq_period));
+	return HRTIMER_RESTART;
+}
+
+mevirtual_ao_subdevice_t* mevirtual_ao_constr(unsigned int idx, unsigned int fifo_size, unsigned int min_irq_period, mevirtual_loopback_t* loopback)
+{
+	mevirtual_ao_subdevice_t* subdevice;
+
+	PDEBUG("executed idx=%d.\n", idx);
+
+	if (idx >= MEVIRTUAL_MAX_AO_CHANNELS)
+	{
+		PERROR("Too many AO subdevices. Maximum is %d.\n", MEVIRTUAL_MAX_AO_CHANNELS);
+		return NULL;
+	}
+
+	// Allocate memory for subdevice instance.
+	subdevice = kzalloc(sizeof(mevirtual_ao_subdevice_t), GFP_KERNEL);
+	if (!subdevice)
+	{
+		PERROR("Cannot get memory for subdevice instance.\n");
+		return NULL;
+	}
+
+	// Initialize subdevice base class.
+	if (me_subdevice_init(&subdevice->base))
+	{
+		PERROR("Cannot initialize subdevice base class instance.\n");
+		kfree(subdevice);
+		return NULL;
+	}
+
+	subdevice->base.idx = idx;
+	subdevice->loopback = loopback;
+	subdevice->fifo_size = fifo_size;
+	subdevice->min_irq_period = (uint64_t)min_irq_period * NSEC_PER_USEC;
+	loopback->ao_value[idx] = MEVIRTUAL_AO_ZERO;
+
+	init_waitqueue_head(&subdevice->wait_queue);
+	mevirtual_timer_init(&subdevice->timer, mevirtual_ao_timer);
+
+	if (fifo_size)
+	{
+		subdevice->seg_buf = create_seg_buffer(MEVIRTUAL_AO_SEG_BUF_CHUNK_COUNT, MEVIRTUAL_AO_SEG_BUF_CHUNK_SIZE);
+		if (!subdevice->seg_buf)
+		{
+			PERROR("Cannot initialize segmented buffer.\n");
+			me_subdevice_deinit(&subdevice->base);
+			kfree(subdevice);
+			return NULL;
+		}
+	}
+
+	// Override base class methods.
+	subdevice->base.me_subdevice_destructor = mevirtual_ao_destructor;
+	subdevice->base.me_subdevice_io_reset_subdevice = mevirtual_ao_io_reset_subdevice;
+	subdevice->base.me_subdevice_io_single_config = mevirtual_ao_io_single_config;
+	subdevice->base.me_subdevice_io_single_write = mevirtual_ao_io_single_write;
+	if (fifo_size)
+	{
+		subdevice->base.me_subdevice_io_stream_config = mevirtual_ao_io_stream_config;
+		subdevice->base.me_subdevice_io_stream_new_values = mevirtual_ao_io_stream_new_values;
+		subdevice->base.me_subdevice_io_stream_write = mevirtual_ao_io_stream_write;
+		subdevice->base.me_subdevice_io_stream_start = mevirtual_ao_io_stream_start;
+		subdevice->base.me_subdevice_io_stream_status = mevirtual_ao_io_stream_status;
+		subdevice->base.me_subdevice_io_stream_stop = mevirtual_ao_io_stream_stop;
+		subdevice->base.me_subdevice_query_timer = mevirtual_ao_query_timer;
+	}
+	subdevice->base.me_subdevice_query_number_channels = mevirtual_ao_query_number_channels;
+	subdevice->base.me_subdevice_query_subdevice_type = mevirtual_ao_query_subdevice_type;
+	subdevice->base.me_subdevice_query_subdevice_caps = mevirtual_ao_query_subdevice_caps;
+	subdevice->base.me_subdevice_query_subdevice_caps_args = mevirtual_ao_query_subdevice_caps_args;
+	subdevice->base.me_subdevice_query_number_ranges = mevirtual_ao_query_number_ranges;
+	subdevice->base.me_subdevice_query_range_by_min_max = mevirtual_ao_query_range_by_min_max;
+	subdevice->base.me_subdevice_query_range_info = mevirtual_ao_query_range_info;
+
+	subdevice->base.me_subdevice_irq_handle = mevirtual_ao_irq_handle;
+
+	return subdevice;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file mevirtual_ao.h
+ *
+ * @brief The virtual analog output subdevice class.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifdef __KERNEL__
+
+# ifndef _MEVIRTUAL_AO_H_
+#  define _MEVIRTUAL_AO_H_
+
+#  include <linux/hrtimer.h>
+
+#  include "mesubdevice.h"
+#  include "meseg_buf.h"
+#  include "mevirtual_device.h"
+
+#  define MEVIRTUAL_AO_MAX_DATA			0xFFFF
+/// Output value of 0V.
+#  define MEVIRTUAL_AO_ZERO				0x8000
+
+#  define MEVIRTUAL_AO_MIN_CONV_TICKS	66LL
+#  define MEVIRTUAL_AO_MAX_CONV_TICKS	0xFFFFFFFFLL
+
+#  define MEVIRTUAL_AO_SEG_BUF_CHUNK_SIZE		(PAGE_SIZE)
+#  define MEVIRTUAL_AO_SEG_BUF_CHUNK_COUNT		(64)
+
+#  define mevirtual_AO_CAPS				(ME_CAPS_AO_FIFO)
+
+	enum MEVIRTUAL_AO_STATUS
+	{
+		ao_status_none = 0,
+		ao_status_single_configured,
+		ao_status_stream_configured,
+		ao_status_stream_run,
+		ao_status_stream_end_wait,
+		ao_status_stream_end,
+		ao_status_stream_fifo_error,
+		ao_status_last
+	};
+
+	/**
+	* @brief The virtual analog output subdevice class.
+	*
+	* Stream is consumed by a timer. Each tick takes all values due since start.
+	*/
+	typedef struct //mevirtual_ao_subdevice
+	{
+		// Inheritance
+		me_subdevice_t base;						/**< The subdevice base class. */
+
+		// Attributes
+		mevirtual_loopback_t* loopback;				/**< Output is visible on loopback->ao_value[idx]. */
+
+		unsigned int fifo_size;						/**< 0: single only. */
+		uint64_t min_irq_period;					/**< The shortest time between two ticks [ns]. */
+
+		volatile enum MEVIRTUAL_AO_STATUS status;	/**< The current stream status flag. */
+		wait_queue_head_t wait_queue;				/**< Wait queue for blocking calls. */
+
+		// Stream configuration
+		uint64_t conv_period;						/**< Time between two values [ns]. */
+		uint64_t stop_count;						/**< Values to output. 0: infinite. */
+		int wraparound;								/**< Output buffer in loop. */
+
+		// Consumer
+		struct hrtimer timer;
+		ktime_t start_time;
+		uint64_t irq_period;						/**< [ns] */
+		volatile uint64_t consumed;					/**< Values sent to output since start. */
+		volatile int stop_on_empty;					/**< Stop with last value (ME_STOP_MODE_LAST_VALUE). */
+		volatile int stream_start_count;
+		volatile int stream_stop_count;
+
+		// Software buffer
+		me_seg_buf_t* seg_buf;
+	} mevirtual_ao_subdevice_t;
+
+
+	/**
+	* @brief The constructor to generate a virtual analog output subdevice instance.
+	*
+	* @param idx The index of analog output (channel on AI loopback).
+	* @param fifo_size Size of FIFO. 0: no streaming.
+	* @param min_irq_period The shortest time between two consumer ticks [us].
+	* @param loopback The wires of device.
+	*
+	* @return Pointer to new instance on success.\n
+	* NULL on error.
+	*/
+	mevirtual_ao_subdevice_t* mevirtual_ao_constr(unsigned int idx, unsigned int fifo_size, unsigned int min_irq_period, mevirtual_loopback_t* loopback);
+
+# endif
+#endif
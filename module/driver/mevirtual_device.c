@@ -0,0 +1,231 @@
+/**
+ * @file mevirtual_device.c
+ *
+ * @brief Virtual loopback device class implementation.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __KERNEL__
+# error Kernel only!
+#endif
+
+# ifndef MODULE
+#  define MODULE
+# endif
+
+# include <linux/slab.h>
+
+# include "me_debug.h"
+# include "me_error.h"
+# include "me_defines.h"
+# include "me_common.h"
+# include "me_internal.h"
+
+# include "mesubdevice.h"
+# include "mevirtual_ai.h"
+# include "mevirtual_ao.h"
+# include "mevirtual_dio.h"
+# include "mevirtual_ext_irq.h"
+
+# include "mevirtual_device.h"
+
+# define ME_MODULE_NAME		MEVIRTUAL_NAME
+# define ME_MODULE_VERSION	MEVIRTUAL_VERSION
+
+static void mevirtual_get_device_info(mevirtual_device_t* device);
+static int mevirtual_reset_device(me_device_t* device, struct file* filep, int flags);
+static int mevirtual_device_postinit(me_device_t* device, struct file* filep);
+
+me_device_t* mevirtual_constr(me_general_dev_t* device, me_device_t* instance, mevirtual_config_t* config)
+{
+	mevirtual_device_t* mevirtual_device = NULL;
+	me_subdevice_t* subdevice;
+	unsigned int i;
+
+	PDEBUG("executed.\n");
+
+	if (!instance)
+	{
+		// Allocate structure for device instance.
+		mevirtual_device = kzalloc(sizeof(mevirtual_device_t), GFP_KERNEL);
+		if (!mevirtual_device)
+		{
+			PERROR("Cannot get memory for virtual device instance.\n");
+			return NULL;
+		}
+
+		// Initialize loopback.
+		ME_INIT_LOCK(&mevirtual_device->loopback.lock);
+		mevirtual_device->loopback.dio_ports = config->dio_ports;
+		mevirtual_device->loopback.ao_channels = config->ao_channels;
+
+		// Set constans.
+		mevirtual_get_device_info(mevirtual_device);
+
+		// Initialize base class structure.
+		if (me_device_init(&mevirtual_device->base, device))
+		{
+			PERROR("Cannot initialize device base class.\n");
+			goto ERROR;
+		}
+
+		/// Create subdevice instances.
+		// AI
+		if (config->ai_channels)
+		{
+			subdevice = (me_subdevice_t *) mevirtual_ai_constr(0, config->ai_channels, config->ai_fifo, config->min_irq_period, &mevirtual_device->loopback);
+			if (!subdevice)
+			{
+				PERROR("Cannot get memory for AI%d subdevice.\n", 0);
+				goto ERROR;
+			}
+
+			me_slist_add(&mevirtual_device->base.slist, (void *)&mevirtual_device->base.bus.local_dev, subdevice);
+		}
+
+		// AO. Only first one is streaming.
+		for (i = 0; i < config->ao_channels; i++)
+		{
+			subdevice = (me_subdevice_t *) mevirtual_ao_constr(i, (i) ? 0 : config->ao_fifo, config->min_irq_period, &mevirtual_device->loopback);
+			if (!subdevice)
+			{
+				PERROR("Cannot get memory for AO%d subdevice.\n", i);
+				goto ERROR;
+			}
+
+			me_slist_add(&mevirtual_device->base.slist, (void *)&mevirtual_device->base.bus.local_dev, subdevice);
+		}
+
+		// DIO
+		for (i = 0; i < config->dio_ports; i++)
+		{
+			subdevice = (me_subdevice_t *) mevirtual_dio_constr(i, &mevirtual_device->loopback);
+			if (!subdevice)
+			{
+				PERROR("Cannot get memory for DIO%d subdevice.\n", i);
+				goto ERROR;
+			}
+
+			me_slist_add(&mevirtual_device->base.slist, (void *)&mevirtual_device->base.bus.local_dev, subdevice);
+		}
+
+		// EXT IRQ
+		subdevice = (me_subdevice_t *) mevirtual_ext_irq_constr(0, config->irq_period, &mevirtual_device->loopback);
+		if (!subdevice)
+		{
+			PERROR("Cannot get memory for EXT_IRQ%d subdevice.\n", 0);
+			goto ERROR;
+		}
+
+		me_slist_add(&mevirtual_device->base.slist, (void *)&mevirtual_device->base.bus.local_dev, subdevice);
+	}
+	else
+	{
+		mevirtual_device = (mevirtual_device_t *)instance;
+		me_device_reinit(instance, device);
+	}
+
+	mevirtual_device->base.me_device_io_reset_device = mevirtual_reset_device;
+	mevirtual_device->base.me_device_postinit = mevirtual_device_postinit;
+
+	return (me_device_t *) mevirtual_device;
+
+ERROR:
+	PERROR_CRITICAL("Can not create instance of %s\n", ME_MODULE_NAME);
+	if(mevirtual_device)
+	{
+		if (mevirtual_device->base.me_device_destructor)
+		{
+			mevirtual_device->base.me_device_destructor((me_device_t *)mevirtual_device);
+		}
+		me_device_disconnect((me_device_t *)mevirtual_device);
+		kfree(mevirtual_device);
+		mevirtual_device = NULL;
+	}
+	return (me_device_t *) mevirtual_device;
+}
+
+static void mevirtual_get_device_info(mevirtual_device_t* device)
+{
+	device->base.info.device_version =		ME_MODULE_VERSION;
+	device->base.info.driver_name =			ME_MODULE_NAME;
+
+	device->base.info.device_name = 		MEVIRTUAL_NAME_DEVICE;
+	device->base.info.device_description =	MEVIRTUAL_DESCRIPTION_DEVICE;
+}
+
+static int mevirtual_reset_device(me_device_t* device, struct file* filep, int flags)
+{
+	me_subdevice_t* s;
+	int err = ME_ERRNO_SUCCESS;
+	int i;
+
+	PDEBUG("executed.\n");
+
+	// Enter device.
+	err = me_dlock_enter(&device->dlock, filep);
+	if (err)
+	{
+		PERROR("Cannot enter device.\n");
+		return err;
+	}
+
+	// Check subdevice locks.
+	if (!(flags & ME_IO_RESET_DEVICE_UNPROTECTED))
+	{
+		err = me_dlock_lock(&device->dlock, &device->slist, filep, ME_LOCK_CHECK, ME_NO_FLAGS);
+		if(err)
+		{
+			PERROR("Cannot reset device. Something is locked.\n");
+			me_dlock_exit(&device->dlock, filep);
+			return err;
+		}
+	}
+
+	// Reset every subdevice in list.
+	for (i = 0; i < me_slist_get_number_subdevices(&device->slist); i++)
+	{
+		s = me_slist_get_subdevice(&device->slist, i);
+		err = s->me_subdevice_io_reset_subdevice(s, filep, flags & ~ME_IO_RESET_DEVICE_UNPROTECTED);
+
+		if (err && (err != ME_ERRNO_LOCKED))
+		{
+			PERROR("Cannot reset %d subdevice.\n", i);
+		}
+	}
+
+	// Reset apply only for not blocked subdevices. err == ME_ERRNO_LOCKED is not an error.
+	if (err == ME_ERRNO_LOCKED)
+		err = ME_ERRNO_SUCCESS;
+
+	// Exit device.
+	me_dlock_exit(&device->dlock, filep);
+
+	return err;
+}
+
+static int mevirtual_device_postinit(me_device_t* device, struct file* filep)
+{
+	PLOG("Virtual device SERIAL NUMBER:0x%08x\n", device->bus.local_dev.serial_no);
+
+	return mevirtual_reset_device(device, filep, ME_NO_FLAGS);
+}
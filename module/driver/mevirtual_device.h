@@ -0,0 +1,160 @@
+/**
+ * @file mevirtual_device.h
+ *
+ * @brief Virtual loopback device class header file.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifdef __KERNEL__
+
+# if !defined(ME_VIRTUAL)
+#  error NO VALID DRIVER TYPE declared!
+# endif
+
+# ifndef _MEVIRTUAL_DEVICE_H_
+#  define _MEVIRTUAL_DEVICE_H_
+
+#  include <linux/version.h>
+#  include <linux/hrtimer.h>
+
+#  include "medevice.h"
+#  include "melock_defines.h"
+
+#  define MEVIRTUAL_VERSION				0x00010000
+
+/// Timer base of all virtual subdevices. Same as ME-4600.
+#  define MEVIRTUAL_BASE_FREQUENCY		33000000LL
+
+#  define MEVIRTUAL_MAX_AI_CHANNELS		32
+#  define MEVIRTUAL_MAX_AO_CHANNELS		4
+#  define MEVIRTUAL_MAX_DIO_PORTS		8
+
+/**
+ * @brief Module parameters passed to every device instance.
+ */
+typedef struct //mevirtual_config
+{
+	unsigned int ai_channels;		/**< 0: no AI subdevice. */
+	unsigned int ai_fifo;			/**< AI FIFO size in values. */
+	unsigned int ao_channels;		/**< 0: no AO subdevices. */
+	unsigned int ao_fifo;			/**< AO FIFO size in values. Only first AO has a FIFO. */
+	unsigned int dio_ports;			/**< Number of 8 bit ports. Port 2k is wired to port 2k+1. */
+	unsigned int irq_period;		/**< Period of the external interrupt generator [us]. 0: only DIO line. */
+	unsigned int min_irq_period;	/**< The shortest time between two simulated interrupts [us]. */
+} mevirtual_config_t;
+
+/**
+ * @brief The wires between subdevices.
+ *
+ * AO outputs are read back by AI single reads (AO n -> AI n).
+ * DIO ports are connected in pairs. Bit 0 of port 0 drives the external interrupt line.
+ */
+typedef struct //mevirtual_loopback
+{
+	me_lock_t lock;
+
+	unsigned int dio_ports;
+	uint8_t dio_latch[MEVIRTUAL_MAX_DIO_PORTS];		/**< Value written to port. */
+	int dio_output[MEVIRTUAL_MAX_DIO_PORTS];		/**< Port drives the lines. */
+
+	unsigned int ao_channels;
+	uint16_t ao_value[MEVIRTUAL_MAX_AO_CHANNELS];	/**< Last value on AO output. */
+
+	int irq_line;									/**< Current state of external interrupt line. */
+	/// Called (under lock) when state of external interrupt line changed.
+	void (*irq_line_changed)(void* context, int line);
+	void* irq_line_context;
+} mevirtual_loopback_t;
+
+/**
+ * @brief Value visible on the lines of port.
+ */
+static inline uint8_t mevirtual_loopback_dio_read(mevirtual_loopback_t* loopback, unsigned int port)
+{
+	unsigned int partner = port ^ 0x1;
+
+	if (loopback->dio_output[port])
+		return loopback->dio_latch[port];
+
+	if ((partner < loopback->dio_ports) && loopback->dio_output[partner])
+		return loopback->dio_latch[partner];
+
+	return 0;
+}
+
+/**
+ * @brief Propagates DIO change to external interrupt line. Call under loopback lock.
+ */
+static inline void mevirtual_loopback_update_irq_line(mevirtual_loopback_t* loopback)
+{
+	int line = (loopback->dio_ports) ? (mevirtual_loopback_dio_read(loopback, 0) & 0x1) : 0;
+
+	if (line != loopback->irq_line)
+	{
+		loopback->irq_line = line;
+		if (loopback->irq_line_changed)
+		{
+			loopback->irq_line_changed(loopback->irq_line_context, line);
+		}
+	}
+}
+
+/**
+ * @brief Timers are the interrupt sources of virtual subdevices.
+ */
+static inline void mevirtual_timer_init(struct hrtimer* timer, enum hrtimer_restart (*function)(struct hrtimer *))
+{
+#  if LINUX_VERSION_CODE >= KERNEL_VERSION(6,13,0)
+	hrtimer_setup(timer, function, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+#  else
+	hrtimer_init(timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+	timer->function = function;
+#  endif
+}
+
+/**
+ * @brief The virtual device class structure.
+ */
+typedef struct //mevirtual_device
+{
+	/// The Meilhaus device base class.
+	me_device_t base;
+
+	/// Child class attributes.
+	mevirtual_loopback_t loopback;
+} mevirtual_device_t;
+
+
+/**
+ * @brief The virtual device class constructor.
+ *
+ * @param device   The unified device structure created by module.
+ * @param instance The instance to init. NULL for new device, pointer for existing one.
+ * @param config   Shape of the device.
+ *
+ * @return On succes a new virtual device instance. \n
+ *         NULL on error.
+ */
+me_device_t* mevirtual_constr(me_general_dev_t* device, me_device_t* instance, mevirtual_config_t* config);
+
+# endif	//_MEVIRTUAL_DEVICE_H_
+#endif	//__KERNEL__
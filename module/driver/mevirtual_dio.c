@@ -0,0 +1,354 @@
+/**
+ * @file mevirtual_dio.c
+ *
+ * @brief The virtual digital input/output subdevice instance.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __KERNEL__
+# error Kernel only!
+#endif
+
+# ifndef MODULE
+#  define MODULE
+# endif
+
+# include <linux/slab.h>
+
+# include "me_debug.h"
+# include "me_error.h"
+# include "me_defines.h"
+# include "me_spin_lock.h"
+
+# include "mevirtual_dio.h"
+
+int mevirtual_dio_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep, int flags);
+int mevirtual_dio_io_single_config(me_subdevice_t* subdevice, struct file* filep, int channel,
+										int single_config, int ref, int trig_chain, int trig_type, int trig_edge, int flags);
+int mevirtual_dio_io_single_read(me_subdevice_t* subdevice, struct file* filep, int channel, int* value, int time_out, int flags);
+int mevirtual_dio_io_single_write(me_subdevice_t* subdevice, struct file* filep, int channel, int value, int time_out, int flags);
+int mevirtual_dio_query_number_channels(me_subdevice_t* subdevice, int* number);
+int mevirtual_dio_query_subdevice_type(me_subdevice_t* subdevice, int* type, int* subtype);
+int mevirtual_dio_query_subdevice_caps(me_subdevice_t* subdevice, int* caps);
+
+int mevirtual_dio_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep, int flags)
+{
+	mevirtual_dio_subdevice_t* instance;
+
+	instance = (mevirtual_dio_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	if (flags)
+	{
+		PERROR("Invalid flags specified. Must be ME_IO_RESET_SUBDEVICE_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_SUBDEVICE_LOCK;
+			ME_SPIN_LOCK(&instance->loopback->lock);
+				// Default settings: INPUT mode
+				instance->loopback->dio_output[instance->base.idx] = 0;
+				instance->loopback->dio_latch[instance->base.idx] = 0;
+				mevirtual_loopback_update_irq_line(instance->loopback);
+			ME_SPIN_UNLOCK(&instance->loopback->lock);
+		ME_SUBDEVICE_UNLOCK;
+	ME_SUBDEVICE_EXIT;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_dio_io_single_config(me_subdevice_t* subdevice, struct file* filep, int channel,
+										int single_config, int ref, int trig_chain, int trig_type, int trig_edge, int flags)
+{
+	mevirtual_dio_subdevice_t* instance;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_dio_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	switch (flags)
+	{
+		case ME_IO_SINGLE_CONFIG_NO_FLAGS:
+		case ME_IO_SINGLE_CONFIG_DIO_BYTE:
+			break;
+
+		default:
+			PERROR("Invalid flags specified. Should be ME_IO_SINGLE_CONFIG_DIO_BYTE.\n");
+			return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (trig_edge)
+	{
+		PERROR("Invalid trigger edge. Must be ME_TRIG_EDGE_NONE.\n");
+		return ME_ERRNO_INVALID_TRIG_EDGE;
+	}
+
+	switch (trig_type)
+	{
+		case ME_TRIG_TYPE_NONE:
+			if (trig_chain != ME_TRIG_CHAN_NONE)
+			{
+				PERROR("Invalid trigger chain specified. Must be ME_TRIG_CHAN_NONE.\n");
+				return ME_ERRNO_INVALID_TRIG_CHAN;
+			}
+			break;
+		case ME_TRIG_TYPE_SW:
+			if (trig_chain != ME_TRIG_CHAN_DEFAULT)
+			{
+				PERROR("Invalid trigger chain specified. Must be ME_TRIG_CHAN_DEFAULT.\n");
+				return ME_ERRNO_INVALID_TRIG_CHAN;
+			}
+			break;
+
+		default:
+			PERROR("Invalid trigger type. Should be ME_TRIG_TYPE_NONE.\n");
+			return ME_ERRNO_INVALID_TRIG_TYPE;
+	}
+
+	if (channel)
+	{
+		PERROR("Invalid channel number.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	if (ref != ME_REF_NONE)
+	{
+		PERROR("Invalid port reference specified. Must be ME_REF_NONE.\n");
+		return ME_ERRNO_INVALID_REF;
+	}
+
+	if ((single_config != ME_SINGLE_CONFIG_DIO_INPUT) && (single_config != ME_SINGLE_CONFIG_DIO_OUTPUT))
+	{
+		PERROR("Invalid port configuration specified. Must be ME_SINGLE_CONFIG_DIO_INPUT or ME_SINGLE_CONFIG_DIO_OUTPUT.\n");
+		return ME_ERRNO_INVALID_SINGLE_CONFIG;
+	}
+
+	ME_SUBDEVICE_ENTER
+		ME_SUBDEVICE_LOCK;
+			ME_SPIN_LOCK(&instance->loopback->lock);
+				instance->loopback->dio_output[instance->base.idx] = (single_config == ME_SINGLE_CONFIG_DIO_OUTPUT);
+				mevirtual_loopback_update_irq_line(instance->loopback);
+			ME_SPIN_UNLOCK(&instance->loopback->lock);
+		ME_SUBDEVICE_UNLOCK;
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_dio_io_single_read(me_subdevice_t* subdevice, struct file* filep, int channel, int* value, int time_out, int flags)
+{
+	mevirtual_dio_subdevice_t* instance;
+	uint8_t tmp;
+
+	instance = (mevirtual_dio_subdevice_t *)subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	switch (flags)
+	{
+		case ME_IO_SINGLE_TYPE_DIO_BIT:
+			if ((channel < 0) || (channel >= 8))
+			{
+				PERROR("Invalid bit number specified. Must be between 0 and 7.\n");
+				return ME_ERRNO_INVALID_CHANNEL;
+			}
+			break;
+
+		case ME_IO_SINGLE_TYPE_NO_FLAGS:
+		case ME_IO_SINGLE_TYPE_DIO_BYTE:
+			if (channel)
+			{
+				PERROR("Invalid byte number specified. Must be 0.\n");
+				return ME_ERRNO_INVALID_CHANNEL;
+			}
+			break;
+
+		default:
+			PERROR("Invalid flags specified.\n");
+			return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_SUBDEVICE_LOCK;
+			ME_SPIN_LOCK(&instance->loopback->lock);
+				tmp = mevirtual_loopback_dio_read(instance->loopback, instance->base.idx);
+			ME_SPIN_UNLOCK(&instance->loopback->lock);
+
+			switch (flags)
+			{
+				case ME_IO_SINGLE_TYPE_DIO_BIT:
+					*value = tmp & (0x1 << channel);
+					break;
+
+				case ME_IO_SINGLE_TYPE_NO_FLAGS:
+				case ME_IO_SINGLE_TYPE_DIO_BYTE:
+				default:
+					*value = tmp;
+			}
+		ME_SUBDEVICE_UNLOCK;
+	ME_SUBDEVICE_EXIT;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_dio_io_single_write(me_subdevice_t* subdevice, struct file* filep, int channel, int value, int time_out, int flags)
+{
+	mevirtual_dio_subdevice_t* instance;
+	uint8_t tmp;
+	int err = ME_ERRNO_SUCCESS;
+
+	instance = (mevirtual_dio_subdevice_t *) subdevice;
+
+	PDEBUG("executed idx=%d.\n", instance->base.idx);
+
+	switch (flags)
+	{
+		case ME_IO_SINGLE_TYPE_DIO_BIT:
+			if ((channel < 0) || (channel >= 8))
+			{
+				PERROR("Invalid bit number specified. Must be between 0 and 7.\n");
+				return ME_ERRNO_INVALID_CHANNEL;
+			}
+			break;
+
+		case ME_IO_SINGLE_TYPE_NO_FLAGS:
+		case ME_IO_SINGLE_TYPE_DIO_BYTE:
+			if (channel)
+			{
+				PERROR("Invalid byte number specified. Must be 0.\n");
+				return ME_ERRNO_INVALID_CHANNEL;
+			}
+			break;
+
+		default:
+			PERROR("Invalid flags specified.\n");
+			return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_SUBDEVICE_LOCK;
+			ME_SPIN_LOCK(&instance->loopback->lock);
+				if (!instance->loopback->dio_output[instance->base.idx])
+				{
+					PERROR("Port not in output mode.\n");
+					err = ME_ERRNO_PREVIOUS_CONFIG;
+				}
+				else
+				{
+					switch (flags)
+					{
+						case ME_IO_SINGLE_TYPE_DIO_BIT:
+							tmp = instance->loopback->dio_latch[instance->base.idx];
+							if (value) tmp |= 0x1 << channel;
+							else tmp &= ~(0x1 << channel);
+							break;
+
+						case ME_IO_SINGLE_TYPE_NO_FLAGS:
+						case ME_IO_SINGLE_TYPE_DIO_BYTE:
+						default:
+							tmp = value & 0xFF;
+					}
+					instance->loopback->dio_latch[instance->base.idx] = tmp;
+					me_latency_probe_write(&instance->base, me_latency_probe_time());
+					mevirtual_loopback_update_irq_line(instance->loopback);
+				}
+			ME_SPIN_UNLOCK(&instance->loopback->lock);
+		ME_SUBDEVICE_UNLOCK;
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_dio_query_number_channels(me_subdevice_t* subdevice, int* number)
+{
+	PDEBUG("executed idx=%d.\n", ((mevirtual_dio_subdevice_t *) subdevice)->base.idx);
+
+	*number = 8;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_dio_query_subdevice_type(me_subdevice_t* subdevice, int* type, int* subtype)
+{
+	PDEBUG("executed idx=%d.\n", ((mevirtual_dio_subdevice_t *) subdevice)->base.idx);
+
+	*type = ME_TYPE_DIO;
+	*subtype = ME_SUBTYPE_SINGLE;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_dio_query_subdevice_caps(me_subdevice_t* subdevice, int* caps)
+{
+	PDEBUG("executed idx=%d.\n", ((mevirtual_dio_subdevice_t *) subdevice)->base.idx);
+
+	*caps = mevirtual_DIO_CAPS;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+mevirtual_dio_subdevice_t* mevirtual_dio_constr(unsigned int idx, mevirtual_loopback_t* loopback)
+{
+	mevirtual_dio_subdevice_t* subdevice;
+
+	PDEBUG("executed idx=%d.\n", idx);
+
+	if (idx >= MEVIRTUAL_MAX_DIO_PORTS)
+	{
+		PERROR("Too many DIO ports. Maximum is %d.\n", MEVIRTUAL_MAX_DIO_PORTS);
+		return NULL;
+	}
+
+	// Allocate memory for subdevice instance.
+	subdevice = kzalloc(sizeof(mevirtual_dio_subdevice_t), GFP_KERNEL);
+	if (!subdevice)
+	{
+		PERROR("Cannot get memory for subdevice instance.\n");
+		return NULL;
+	}
+
+	// Initialize subdevice base class.
+	if (me_subdevice_init(&subdevice->base))
+	{
+		PERROR("Cannot initialize subdevice base class instance.\n");
+		kfree(subdevice);
+		return NULL;
+	}
+
+	// Save digital i/o index.
+	subdevice->base.idx = idx;
+	subdevice->loopback = loopback;
+
+	// Override base class methods.
+	subdevice->base.me_subdevice_io_reset_subdevice = mevirtual_dio_io_reset_subdevice;
+	subdevice->base.me_subdevice_io_single_config = mevirtual_dio_io_single_config;
+	subdevice->base.me_subdevice_io_single_read = mevirtual_dio_io_single_read;
+	subdevice->base.me_subdevice_io_single_write = mevirtual_dio_io_single_write;
+	subdevice->base.me_subdevice_query_number_channels = mevirtual_dio_query_number_channels;
+	subdevice->base.me_subdevice_query_subdevice_type = mevirtual_dio_query_subdevice_type;
+	subdevice->base.me_subdevice_query_subdevice_caps = mevirtual_dio_query_subdevice_caps;
+
+	return subdevice;
+}
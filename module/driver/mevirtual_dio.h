@@ -0,0 +1,62 @@
+/**
+ * @file mevirtual_dio.h
+ *
+ * @brief The virtual digital input/output subdevice class.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifdef __KERNEL__
+
+# ifndef _MEVIRTUAL_DIO_H_
+#  define _MEVIRTUAL_DIO_H_
+
+#  include "mesubdevice.h"
+#  include "mevirtual_device.h"
+
+#  define mevirtual_DIO_CAPS			ME_CAPS_DIO_DIR_BYTE
+
+/**
+ * @brief The virtual digital input/output subdevice class.
+ */
+typedef struct //mevirtual_dio_subdevice
+{
+	// Inheritance
+	me_subdevice_t base;			/**< The subdevice base class. */
+
+	// Attributes
+	mevirtual_loopback_t* loopback;	/**< Wires shared with other subdevices. Holds port's latch and direction. */
+} mevirtual_dio_subdevice_t;
+
+
+/**
+ * @brief The constructor to generate a virtual digital input/ouput subdevice instance.
+ *
+ * @param idx The index of the digital i/o port on the device.
+ * @param loopback The wires of device.
+ *
+ * @return Pointer to new instance on success.\n
+ * NULL on error.
+ */
+mevirtual_dio_subdevice_t* mevirtual_dio_constr(unsigned int idx, mevirtual_loopback_t* loopback);
+
+# endif
+#endif
@@ -0,0 +1,443 @@
+/**
+ * @file mevirtual_ext_irq.c
+ *
+ * @brief The virtual external interrupt subdevice instance.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef __KERNEL__
+# error Kernel only!
+#endif
+
+# ifndef MODULE
+#  define MODULE
+# endif
+
+# include <linux/fs.h>
+# include <linux/slab.h>
+
+# include <linux/sched.h>
+
+# include "me_debug.h"
+# include "me_error.h"
+# include "me_defines.h"
+# include "me_spin_lock.h"
+
+# include "mevirtual_ext_irq.h"
+
+static void mevirtual_ext_irq_destructor(me_subdevice_t* subdevice);
+int mevirtual_ext_irq_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep, int flags);
+int mevirtual_ext_irq_io_irq_start(me_subdevice_t* subdevice, struct file* filep, int channel, int irq_source, int irq_edge, int irq_arg, int flags);
+int mevirtual_ext_irq_io_irq_wait(me_subdevice_t* subdevice, struct file* filep, int channel, int* irq_count, int* value, int time_out, int flags);
+int mevirtual_ext_irq_io_irq_stop(me_subdevice_t* subdevice, struct file* filep, int channel, int flags);
+int mevirtual_ext_irq_io_irq_test(me_subdevice_t* subdevice, struct file* filep, int channel, int flags);
+int mevirtual_ext_irq_query_number_channels(me_subdevice_t* subdevice, int* number);
+int mevirtual_ext_irq_query_subdevice_type(me_subdevice_t* subdevice, int* type, int* subtype);
+int mevirtual_ext_irq_query_subdevice_caps(me_subdevice_t* subdevice, int* caps);
+
+static int mevirtual_ext_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status);
+static enum hrtimer_restart mevirtual_ext_irq_timer(struct hrtimer* timer);
+static void mevirtual_ext_irq_line_changed(void* context, int line);
+
+static void mevirtual_ext_irq_destructor(me_subdevice_t* subdevice)
+{
+	mevirtual_ext_irq_subdevice_t* instance;
+
+	instance = (mevirtual_ext_irq_subdevice_t *) subdevice;
+
+	PDEBUG("executed.\n");
+
+	if (!instance)
+	{
+		return;
+	}
+
+	instance->status = irq_status_none;
+	hrtimer_cancel(&instance->timer);
+
+	ME_SPIN_LOCK(&instance->loopback->lock);
+		instance->loopback->irq_line_changed = NULL;
+		instance->loopback->irq_line_context = NULL;
+	ME_SPIN_UNLOCK(&instance->loopback->lock);
+
+	me_subdevice_deinit(&instance->base);
+}
+
+int mevirtual_ext_irq_io_reset_subdevice(me_subdevice_t* subdevice, struct file* filep, int flags)
+{
+	mevirtual_ext_irq_subdevice_t* instance;
+
+	PDEBUG("executed.\n");
+
+	if (flags)
+	{
+		PERROR("Invalid flags specified. Must be ME_IO_RESET_SUBDEVICE_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	instance = (mevirtual_ext_irq_subdevice_t *) subdevice;
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			instance->status = irq_status_none;
+			instance->count = 0;
+			instance->value = 0;
+			instance->reset_count++;
+		ME_UNLOCK_PROTECTOR;
+		// Timer callback only tries the lock, it can not block on it.
+		hrtimer_cancel(&instance->timer);
+		wake_up_interruptible_all(&instance->wait_queue);
+	ME_SUBDEVICE_EXIT;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ext_irq_io_irq_start(me_subdevice_t* subdevice, struct file* filep, int channel, int irq_source, int irq_edge, int irq_arg, int flags)
+{
+	mevirtual_ext_irq_subdevice_t* instance;
+
+	PDEBUG("executed.\n");
+
+	instance = (mevirtual_ext_irq_subdevice_t *)subdevice;
+
+	if (flags & ~ME_IO_IRQ_START_DIO_BIT)
+	{
+		PERROR("Invalid flag specified. Should be ME_IO_IRQ_START_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (irq_arg)
+	{
+		PERROR("Invalid irq argument specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_IRQ_ARG;
+	}
+
+	switch (irq_edge)
+	{
+		case ME_IRQ_EDGE_RISING:
+		case ME_IRQ_EDGE_FALLING:
+		case ME_IRQ_EDGE_ANY:
+			break;
+
+		default:
+			PERROR("Invalid irq edge specified. Must be ME_IRQ_EDGE_RISING, ME_IRQ_EDGE_FALLING or ME_IRQ_EDGE_ANY.\n");
+			return ME_ERRNO_INVALID_IRQ_EDGE;
+	}
+
+	if (irq_source && (irq_source != ME_IRQ_SOURCE_DIO_LINE))
+	{
+		PERROR("Invalid irq source specified. Should be ME_IRQ_SOURCE_DIO_LINE.\n");
+		return ME_ERRNO_INVALID_IRQ_SOURCE;
+	}
+
+	if (channel)
+	{
+		PERROR("Invalid channel specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			instance->edge = irq_edge;
+			instance->status = irq_status_run;
+		ME_UNLOCK_PROTECTOR;
+
+		if (instance->period && !hrtimer_active(&instance->timer))
+		{
+			hrtimer_start(&instance->timer, ns_to_ktime((u64)instance->period * NSEC_PER_USEC), HRTIMER_MODE_REL);
+		}
+	ME_SUBDEVICE_EXIT;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ext_irq_io_irq_wait(me_subdevice_t* subdevice, struct file* filep, int channel, int* irq_count, int* value, int time_out, int flags)
+{
+	mevirtual_ext_irq_subdevice_t* instance;
+	unsigned long int delay = LONG_MAX-2;
+	int old_count;
+	int old_reset_count;
+	uint64_t stall;
+	int err = ME_ERRNO_SUCCESS;
+
+	PDEBUG("executed.\n");
+
+	instance = (mevirtual_ext_irq_subdevice_t *) subdevice;
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_IRQ_WAIT_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (channel)
+	{
+		PERROR("Invalid channel specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		if (time_out)
+		{
+			delay = (time_out * HZ) / 1000;
+
+			if (!delay)
+				delay = 1;
+			if (delay>LONG_MAX - 2)
+				delay = LONG_MAX - 2;
+		}
+
+		old_count = (*irq_count) ? *irq_count : instance->count;
+		old_reset_count = instance->reset_count;
+
+		if (old_count == instance->count)
+		{
+			stall = me_subdevice_stats_time(&instance->base);
+			if (wait_event_interruptible_timeout(instance->wait_queue, ((old_count != instance->count) || (old_reset_count != instance->reset_count)), delay) <= 0)
+			{
+				PERROR("Wait on external interrupt timed out.\n");
+				err = ME_ERRNO_TIMEOUT;
+			}
+			else
+			{
+				me_latency_probe_wake(&instance->base, me_latency_probe_time());
+			}
+			me_subdevice_stats_stall(&instance->base, stall);
+
+			if (instance->status == irq_status_none)
+			{
+				PDEBUG("Aborted by user.\n");
+				err = ME_ERRNO_CANCELLED;
+			}
+		}
+
+		if (signal_pending(current))
+		{
+			PDEBUG("Aborted by signal.\n");
+			err = ME_ERRNO_SIGNAL;
+		}
+
+		*irq_count = instance->count;
+		*value = instance->value;
+	ME_SUBDEVICE_EXIT;
+
+	return err;
+}
+
+int mevirtual_ext_irq_io_irq_stop(me_subdevice_t* subdevice, struct file* filep, int channel, int flags)
+{
+	mevirtual_ext_irq_subdevice_t* instance;
+
+	PDEBUG("executed.\n");
+
+	instance = (mevirtual_ext_irq_subdevice_t *) subdevice;
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_IO_IRQ_STOP_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (channel)
+	{
+		PERROR("Invalid channel specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	ME_SUBDEVICE_ENTER;
+		ME_LOCK_PROTECTOR;
+			instance->status = irq_status_stop;
+		ME_UNLOCK_PROTECTOR;
+		hrtimer_cancel(&instance->timer);
+	ME_SUBDEVICE_EXIT;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ext_irq_io_irq_test(me_subdevice_t* subdevice, struct file* filep, int channel, int flags)
+{
+	mevirtual_ext_irq_subdevice_t* instance;
+
+	PDEBUG("executed.\n");
+
+	instance = (mevirtual_ext_irq_subdevice_t *) subdevice;
+
+	if (flags)
+	{
+		PERROR("Invalid flag specified. Must be ME_NO_FLAGS.\n");
+		return ME_ERRNO_INVALID_FLAGS;
+	}
+
+	if (channel)
+	{
+		PERROR("Invalid channel specified. Must be 0.\n");
+		return ME_ERRNO_INVALID_CHANNEL;
+	}
+
+	ME_SUBDEVICE_ENTER;
+	ME_SUBDEVICE_EXIT;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ext_irq_query_number_channels(me_subdevice_t* subdevice, int* number)
+{
+	PDEBUG("executed.\n");
+
+	*number = 1;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ext_irq_query_subdevice_type(me_subdevice_t* subdevice, int* type, int* subtype)
+{
+	PDEBUG("executed.\n");
+
+	*type = ME_TYPE_EXT_IRQ;
+	*subtype = ME_SUBTYPE_SINGLE;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+int mevirtual_ext_irq_query_subdevice_caps(me_subdevice_t* subdevice, int* caps)
+{
+	PDEBUG("executed.\n");
+
+	*caps = mevirtual_EXT_IRQ_CAPS;
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static int mevirtual_ext_irq_handle(me_subdevice_t* subdevice, uint32_t irq_status)
+{//Dedicated IRQ handling point.
+
+	mevirtual_ext_irq_subdevice_t* instance = (mevirtual_ext_irq_subdevice_t *)subdevice;
+	uint64_t irq_time = me_latency_probe_time();
+
+	ME_HANDLER_PROTECTOR;
+		PDEBUG("executed.\n");
+
+		instance->count++;
+		instance->value = irq_status;
+		me_latency_probe_irq(&instance->base, irq_time, instance->count);
+	ME_FREE_HANDLER_PROTECTOR;
+
+	me_subdevice_stats_isr(&instance->base, irq_time);
+
+	if (instance->status == irq_status_run)
+	{
+		wake_up_interruptible_all(&instance->wait_queue);
+	}
+
+	return ME_ERRNO_SUCCESS;
+}
+
+static enum hrtimer_restart mevirtual_ext_irq_timer(struct hrtimer* timer)
+{
+	mevirtual_ext_irq_subdevice_t* instance = container_of(timer, mevirtual_ext_irq_subdevice_t, timer);
+
+	if (instance->status != irq_status_run)
+	{
+		return HRTIMER_NORESTART;
+	}
+
+	mevirtual_ext_irq_handle(&instance->base, 0x1);
+
+	hrtimer_forward_now(timer, ns_to_ktime((u64)instance->period * NSEC_PER_USEC));
+	return HRTIMER_RESTART;
+}
+
+static void mevirtual_ext_irq_line_changed(void* context, int line)
+{// Called from DIO subdevices under loopback lock.
+	mevirtual_ext_irq_subdevice_t* instance = (mevirtual_ext_irq_subdevice_t *)context;
+
+	if (instance->status != irq_status_run)
+		return;
+
+	if (	(instance->edge == ME_IRQ_EDGE_ANY)
+		||
+			((instance->edge == ME_IRQ_EDGE_RISING) && line)
+		||
+			((instance->edge == ME_IRQ_EDGE_FALLING) && !line)
+		)
+	{
+		mevirtual_ext_irq_handle(&instance->base, line);
+	}
+}
+
+mevirtual_ext_irq_subdevice_t* mevirtual_ext_irq_constr(unsigned int idx, unsigned int period, mevirtual_loopback_t* loopback)
+{
+	mevirtual_ext_irq_subdevice_t* subdevice;
+
+	PDEBUG("executed.\n");
+
+	// Allocate memory for subdevice instance.
+	subdevice = kzalloc(sizeof(mevirtual_ext_irq_subdevice_t), GFP_KERNEL);
+	if (!subdevice)
+	{
+		PERROR("Cannot get memory for virtual ext_irq instance.\n");
+		return NULL;
+	}
+
+	// Initialize subdevice base class.
+	if (me_subdevice_init(&subdevice->base))
+	{
+		PERROR("Cannot initialize subdevice base class instance.\n");
+		kfree(subdevice);
+		return NULL;
+	}
+
+	// Initialize wait queue.
+	init_waitqueue_head(&subdevice->wait_queue);
+
+	// Save the subdevice index.
+	subdevice->base.idx = idx;
+
+	// Interrupt sources.
+	subdevice->period = period;
+	mevirtual_timer_init(&subdevice->timer, mevirtual_ext_irq_timer);
+
+	subdevice->loopback = loopback;
+	ME_SPIN_LOCK(&loopback->lock);
+		loopback->irq_line_context = subdevice;
+		loopback->irq_line_changed = mevirtual_ext_irq_line_changed;
+	ME_SPIN_UNLOCK(&loopback->lock);
+
+	// Initialize the subdevice methods.
+	subdevice->base.me_subdevice_io_irq_start = mevirtual_ext_irq_io_irq_start;
+	subdevice->base.me_subdevice_io_irq_wait = mevirtual_ext_irq_io_irq_wait;
+	subdevice->base.me_subdevice_io_irq_stop = mevirtual_ext_irq_io_irq_stop;
+	subdevice->base.me_subdevice_io_irq_test = mevirtual_ext_irq_io_irq_test;
+	subdevice->base.me_subdevice_io_reset_subdevice = mevirtual_ext_irq_io_reset_subdevice;
+	subdevice->base.me_subdevice_query_number_channels = mevirtual_ext_irq_query_number_channels;
+	subdevice->base.me_subdevice_query_subdevice_type = mevirtual_ext_irq_query_subdevice_type;
+	subdevice->base.me_subdevice_query_subdevice_caps = mevirtual_ext_irq_query_subdevice_caps;
+	subdevice->base.me_subdevice_destructor = mevirtual_ext_irq_destructor;
+
+	subdevice->base.me_subdevice_irq_handle = mevirtual_ext_irq_handle;
+
+	subdevice->status = irq_status_none;
+	subdevice->count = 0;
+	subdevice->reset_count = 0;
+
+	return subdevice;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file mevirtual_ext_irq.h
+ *
+ * @brief The virtual external interrupt subdevice class.
+ * @note Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ * @author KG (Krzysztof Gantzke) (k.gantzke@meilhaus.de)
+ */
+
+/*
+ * Copyright (C) 2011 Meilhaus Electronic GmbH (support@meilhaus.de)
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifdef __KERNEL__
+
+# ifndef _MEVIRTUAL_EXT_IRQ_H_
+#  define _MEVIRTUAL_EXT_IRQ_H_
+
+#  include <linux/hrtimer.h>
+
+#  include "mesubdevice.h"
+#  include "me_interrupt_types.h"
+#  include "mevirtual_device.h"
+
+#  define mevirtual_EXT_IRQ_CAPS		(ME_CAPS_EXT_IRQ_EDGE_RISING | ME_CAPS_EXT_IRQ_EDGE_FALLING | ME_CAPS_EXT_IRQ_EDGE_ANY)
+
+/**
+ * @brief The virtual external interrupt subdevice class.
+ *
+ * Interrupt is generated by bit 0 of DIO port 0 and, when period is set, by a periodic timer.
+ */
+typedef struct //mevirtual_ext_irq_subdevice
+{
+	// Inheritance
+	me_subdevice_t base;			/**< The subdevice base class. */
+
+	// Attributes
+	mevirtual_loopback_t* loopback;	/**< Wires of device. Interrupt line is bit 0 of port 0. */
+
+	wait_queue_head_t wait_queue;	/**< Queue to put on threads waiting for an interrupt. */
+
+	volatile enum ME_IRQ_STATUS status;
+	int edge;						/**< Active edge of interrupt line. */
+	int value;
+	volatile int count;
+	volatile int reset_count;
+
+	unsigned int period;			/**< Period of interrupt generator [us]. 0: generator disabled. */
+	struct hrtimer timer;			/**< Interrupt generator. */
+} mevirtual_ext_irq_subdevice_t;
+
+
+/**
+ * @brief The constructor to generate a virtual external interrupt instance.
+ *
+ * @param idx The index of the subdevice.
+ * @param period Period of interrupt generator [us]. 0: only DIO line.
+ * @param loopback The wires of device.
+ *
+ * @return Pointer to new instance on success.\n
+ * NULL on error.
+ */
+mevirtual_ext_irq_subdevice_t* mevirtual_ext_irq_constr(unsigned int idx, unsigned int period, mevirtual_loopback_t* loopback);
+
+# endif
+#endif
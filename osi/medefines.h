@@ -286,6 +286,7 @@
 #define ME_IO_STREAM_CONFIG_WRAPAROUND				0x2
 #define ME_IO_STREAM_CONFIG_SAMPLE_AND_HOLD			0x4
 #define ME_IO_STREAM_CONFIG_HARDWARE_ONLY			0x8
+#define ME_IO_STREAM_CONFIG_FLIGHT_RECORDER			0x10
 
 #define ME_IO_STREAM_CONFIG_TYPE_NO_FLAGS			0x0
 /*
@@ -306,6 +307,10 @@
 #define ME_IO_STREAM_READ_NO_FLAGS					0x0
 #define ME_IO_STREAM_READ_FRAMES					0x1
 
+/* Gap record: {ME_IO_STREAM_READ_GAP_MARKER, number of lost values}. Returned alone, as whole read. */
+#define ME_IO_STREAM_READ_GAP_MARKER				(-0x7FFFFFFF - 1)
+#define ME_IO_STREAM_READ_GAP_RECORD_SIZE			2
+
 /*==================================================================
   Defines for meIOStreamWrite function
   ================================================================*/
@@ -357,6 +362,19 @@
 
 #define ME_IO_STREAM_STATUS_NO_FLAGS				0x00000000
 
+/*==================================================================
+  Defines for meIOStreamReader function
+  ================================================================*/
+
+#define ME_IO_STREAM_READER_ATTACH					0x00220001
+#define ME_IO_STREAM_READER_DETACH					0x00220002
+
+#define ME_IO_STREAM_READER_POLICY_BLOCK			0x00230001
+#define ME_IO_STREAM_READER_POLICY_DROP				0x00230002
+#define ME_IO_STREAM_READER_POLICY_DETACH			0x00230003
+
+#define ME_IO_STREAM_READER_NO_FLAGS				0x00000000
+
 /*==================================================================
   Defines for meIOStreamSetCallbacks function
   ================================================================*/
@@ -562,6 +580,7 @@
 #define ME_BUS_TYPE_ANY								0x001A0000
 #define ME_BUS_TYPE_PCI								0x001A0001
 #define ME_BUS_TYPE_USB								0x001A0002
+#define ME_BUS_TYPE_SIMULATED						0x001A0003
 #define ME_BUS_TYPE_LAN_PCI							0x001A0101
 #define ME_BUS_TYPE_LAN_USB							0x001A0102
 
@@ -594,6 +613,15 @@
 #define ME_FPGA_SUBDEVICE							0xFF000002
 
 
+/*==================================================================
+  Defines for meUtilityDeinterleave
+  ================================================================*/
+#define ME_DEINTERLEAVE_NO_FLAGS					0x00000000
+
+#define ME_DEINTERLEAVE_FORMAT_INT					0x00210001
+#define ME_DEINTERLEAVE_FORMAT_DOUBLE				0x00210002
+#define ME_DEINTERLEAVE_FORMAT_FLOAT				0x00210003
+
 /*==================================================================
   Defines for meUtilityPWM
   ================================================================*/
@@ -605,6 +633,22 @@
   ================================================================*/
 #define ME_QUERY_NO_FLAGS 							0x00000000
 
+/*==================================================================
+  Defines for meBatchBegin, meBatchCommit and meBatchAbort
+  ================================================================*/
+#define ME_BATCH_NO_FLAGS							0x00000000
+
+/*==================================================================
+  Defines for meQueryStatistics and meStatisticsEnable
+  ================================================================*/
+#define ME_QUERY_STATISTICS_RESET					0x00000001
+
+#define ME_STATISTICS_ENABLE_NO_FLAGS				0x00000000
+
+#define ME_STATISTICS_NAME_MAX_COUNT				64
+/// Bucket n counts calls that took [2^n, 2^(n+1)) ns. Last bucket counts also longer calls.
+#define ME_STATISTICS_HISTOGRAM_COUNT				32
+
 /*==================================================================
   Defines of flags for error handling
   ================================================================*/
@@ -125,6 +125,13 @@ extern "C" {
 			int *piStatus,
 			int *piCount,
 			int iFlags);
+	int meIOStreamReader(
+			int iDevice,
+			int iSubdevice,
+			int iMode,
+			int iPolicy,
+			int *piDropped,
+			int iFlags);
 	int meIOStreamSetCallbacks(
 			int iDevice,
 			int iSubdevice,
@@ -152,6 +159,12 @@ extern "C" {
 			int *piTicksHigh,
 			int iFlags);
 
+	/// Calls on remote devices made by this thread after meBatchBegin() are sent together by meBatchCommit().
+	/// Calls that can not be batched (queries, IRQ, reset) are executed at once, after recorded calls of same device are sent.
+	int meBatchBegin(int iFlags);
+	int meBatchCommit(int *piErrorIndex, int iFlags);
+	int meBatchAbort(int iFlags);
+
 	int meIOSetChannelOffset(
 			int iDevice,
 			int iSubdevice,
@@ -244,6 +257,18 @@ extern "C" {
 			int iCap,
 			int *piArgs,
 			int iCount);
+	int meQueryStatistics(
+			meStatistics_t *pStatistics,
+			int *piCount,
+			int iFlags);
+	int meStatisticsEnable(
+			int iSwitch,
+			int iFlags);
+	int meQueryLatencyProbe(
+			int iDevice,
+			int iSubdevice,
+			meLatencyProbe_t *pProbe,
+			int iFlags);
 
 	int meQueryVersionLibrary(int *piVersion);
 	int meQueryVersionMainDriver(int *piVersion);
@@ -262,6 +287,13 @@ extern "C" {
 			int iConfigListCount,
 			int *piChanBuffer,
 			int *piChanBufferCount);
+	int meUtilityDeinterleave(
+			int *piAIBuffer,
+			int *piAIBufferCount,
+			meDeinterleave_t *pChannelList,
+			int iChannelListCount,
+			int *piFramePosition,
+			int iFlags);
 	int meUtilityDigitalToPhysical(
 			double dMin,
 			double dMax,
@@ -292,6 +324,31 @@ extern "C" {
 			double* pdPhysicalBuffer,
 			int iCount,
 			int* piDataBuffer);
+	int meUtilityDigitalToPhysicalFloatV(
+			double dMin,
+			double dMax,
+			int iMaxData,
+			int *piDataBuffer,
+			int iCount,
+			int iModuleType,
+			double dRefValue,
+			float *pfPhysicalBuffer);
+	int meUtilityPhysicalToDigitalFloatV(
+			double dMin,
+			double dMax,
+			int iMaxData,
+			float* pfPhysicalBuffer,
+			int iCount,
+			int* piDataBuffer);
+	int meUtilityTemperatureV(
+			double dMin,
+			double dMax,
+			int iMaxData,
+			int *piDataBuffer,
+			int iCount,
+			int iModuleType,
+			double dRefValue,
+			double *pdTemperatureBuffer);
 	int meUtilityPWMStart(
 			int iDevice,
 			int iSubdevice1,
@@ -325,6 +382,21 @@ extern "C" {
 
 	int meConfigLoad(char *);
 
+	/*===========================================================================
+	  Functions to query a remote driver system
+	  =========================================================================*/
+
+	int meRQueryNumberDevices(char *location, int *piNumber);
+
+	/// Whole remote topology in one round trip. Buffer has the format of me_topology_*_t records (me_structs.h).
+	/// On ME_ERRNO_USER_BUFFER_SIZE piSize is set to needed size.
+	int meRQueryTopology(char *location, char *pcBuffer, int *piSize);
+	/// Topologies of many hosts in parallel. All hosts share one timeout [ms]. 0: no timeout.
+	int meRQueryDiscover(meRQueryHost_t *pHosts, int iCount, int iTimeout);
+	int meRQueryDiscoverFree(meRQueryHost_t *pHosts, int iCount);
+	/// Closes pooled connections to location. NULL: all hosts.
+	int meRQueryClose(char *location);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,6 +10,8 @@
 #ifndef _OSI_METYPES_H_
 # define _OSI_METYPES_H_
 
+# include "medefines.h"
+
 typedef int (*meErrorCB_t)(	char* pcFunctionName,
 							int iErrorCode);
 
@@ -92,6 +94,45 @@ typedef struct meIOStreamStop
 	int iErrno;
 } meIOStreamStop_t;
 
+typedef struct meDeinterleave
+{
+	void* pvBuffer;
+	int iFormat;
+	int iCount;
+	double dMin;
+	double dMax;
+	int iMaxData;
+	int iFlags;
+} meDeinterleave_t;
+
+typedef struct meStatistics
+{
+	char cName[ME_STATISTICS_NAME_MAX_COUNT];
+	int iDevice;
+	unsigned long long ullCalls;
+	unsigned long long ullErrors;
+	unsigned long long ullTotalTime;
+	unsigned long long ullMinTime;
+	unsigned long long ullMaxTime;
+	unsigned long long ullHistogram[ME_STATISTICS_HISTOGRAM_COUNT];
+} meStatistics_t;
+
+typedef struct meLatencyProbe
+{
+	unsigned long long ullWriteTime;
+	unsigned long long ullIrqTime;
+	unsigned long long ullWakeTime;
+	int iIrqCount;
+} meLatencyProbe_t;
+
+typedef struct meRQueryHost
+{
+	char* pcLocation;		/**< In: remote host. */
+	int iErrno;				/**< Out: ME_ERRNO_TIMEOUT when host did not answer in time. */
+	char* pcTopology;		/**< Out: topology snapshot (me_structs.h). Release with meRQueryDiscoverFree(). */
+	int iSize;				/**< Out: size of snapshot. */
+} meRQueryHost_t;
+
 typedef struct me_extra_param_set
 {
 	int device;
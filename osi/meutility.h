@@ -8,6 +8,8 @@
 #ifndef _MEUTILITY_H_
 # define _MEUTILITY_H_
 
+# include "metypes.h"
+
 # ifdef __cplusplus
 extern "C" {
 # endif
@@ -32,6 +34,102 @@ typedef struct meTypeList
 	unsigned int dummy  : 17;
 }  __attribute__((packed)) meTypeList_t;
 
+/// Stream recorder.
+#  define ME_RECORD_NO_FLAGS				0x00000000
+/// Do not use O_DIRECT (e.g. file systems that do not support it).
+#  define ME_RECORD_BUFFERED_IO			0x00000001
+
+#  define ME_RECORD_DEFAULT_BLOCK_SIZE	0x00400000
+#  define ME_RECORD_DEFAULT_BLOCK_COUNT	16
+/// File header and blocks are aligned to this size.
+#  define ME_RECORD_ALIGNMENT			0x1000
+
+typedef struct meRecordOptions
+{
+	meIOStreamConfig_t* pConfigList;	// Channel list used in meIOStreamConfig(). Stored in file header.
+	int iConfigListCount;
+	double dScanRate;					// [Hz] Stored in file header.
+	double dConvRate;					// [Hz] Stored in file header.
+	double* pdCalibrationGain;			// Per channel list entry. NULL: 1.0
+	double* pdCalibrationOffset;		// Per channel list entry. NULL: 0.0
+	int iBlockSize;						// Size of file block in bytes. 0: ME_RECORD_DEFAULT_BLOCK_SIZE
+	int iBlockCount;					// Blocks in memory. 0: ME_RECORD_DEFAULT_BLOCK_COUNT
+	int iFlags;
+} meRecordOptions_t;
+
+typedef struct meRecordStatus
+{
+	int iStatus;						// ME_STATUS_BUSY, ME_STATUS_IDLE or ME_STATUS_ERROR
+	int iErrno;							// Error that stopped recording.
+	unsigned long long ullSamples;		// Samples written to file.
+	unsigned long long ullBlocks;		// Blocks written to file.
+	unsigned long long ullDroppedBlocks;	// Gaps in file: runs of samples read from device but not written (disk too slow).
+	unsigned long long ullDroppedSamples;	// Samples in all gaps.
+	unsigned long long ullWriteTimeMin;	// [ns] Per block.
+	unsigned long long ullWriteTimeMax;
+	unsigned long long ullWriteTimeTotal;
+	int iQueueHighWater;				// Maximum number of blocks waiting for disk.
+} meRecordStatus_t;
+
+/// Scan session.
+#  define ME_SCAN_SESSION_NO_FLAGS			0x00000000
+/// Stream is started once and kept running. Every external trigger (ME_TRIG_TYPE_EXT_DIGITAL/ANALOG) starts one scan.
+#  define ME_SCAN_SESSION_ARMED				0x00000001
+
+/// File format. All values little endian.
+/// File: header (header_size bytes) followed by blocks (block_size bytes each).
+#  define ME_RECORD_FILE_MAGIC			"MERECORD"
+#  define ME_RECORD_FILE_VERSION		1
+#  define ME_RECORD_BLOCK_MAGIC			0x4B4C4252	// "RBLK"
+
+typedef struct meRecordFileChannel
+{
+	int iChannel;
+	int iStreamConfig;
+	int iRef;
+	int iUnit;
+	double dMin;
+	double dMax;
+	int iMaxData;
+	int iReserved;
+	double dCalibrationGain;
+	double dCalibrationOffset;
+} __attribute__((packed)) meRecordFileChannel_t;
+
+typedef struct meRecordFileHeader
+{
+	char cMagic[8];
+	int iVersion;
+	int iHeaderSize;
+	int iBlockSize;
+	int iDevice;
+	int iSubdevice;
+	int iChannelCount;
+	double dScanRate;
+	double dConvRate;
+	unsigned long long ullStartRealtime;	// [ns] CLOCK_REALTIME at start.
+	unsigned long long ullStartMonotonic;	// [ns] CLOCK_MONOTONIC at start. Blocks' timestamps use this clock.
+	unsigned long long ullBlocks;			// Updated when recording stops.
+	unsigned long long ullSamples;
+	unsigned long long ullDroppedSamples;
+	int iErrno;
+	int iReserved[7];
+	meRecordFileChannel_t Channels[0];
+} __attribute__((packed)) meRecordFileHeader_t;
+
+typedef struct meRecordBlockHeader
+{
+	unsigned int uiMagic;
+	unsigned int uiSequence;
+	unsigned int uiSampleCount;		// 16-bit samples following header.
+	unsigned int uiReserved;
+	unsigned long long ullFirstSample;	// Index of first sample in stream. Frame position: ullFirstSample % iChannelCount.
+	unsigned long long ullDroppedBefore;	// Samples lost directly before this block.
+	unsigned long long ullTimeFirst;	// [ns] CLOCK_MONOTONIC when first part of block was read.
+	unsigned long long ullTimeLast;		// [ns] CLOCK_MONOTONIC when block was completed.
+	unsigned long long ullReserved[2];
+} __attribute__((packed)) meRecordBlockHeader_t;
+
 /**
 	@brief Get dynamic range number assigned to pre-deffined ones.
 */
@@ -68,6 +166,21 @@ int meValueWrite(int iDevice, int iSubdevice, int iChannel, double dValue, int i
 */
 int meSingleScanRead(int iDevice, int iSubdevice, double* pdValue, int* count, int iRange, int iTriggerType, int iTriggerEdge, int iTimeout, int iFlags);
 
+/**
+	@brief Configure AI stream once for repeated scans of channels 0..*piCount-1. Parameters as in meSingleScanRead().
+	@note *piCount is reduced to number of available channels. One session per subdevice.
+*/
+int meScanSessionOpen(int iDevice, int iSubdevice, int* piCount, int iRange, int iTriggerType, int iTriggerEdge, int iSessionFlags, int iFlags);
+/**
+	@brief Do one scan of open session. Only start and read are sent to driver. Values are scaled to physical units.
+	@note In armed mode waits for next scan. On timeout part of scan already read is kept for next call.
+*/
+int meScanSessionRead(int iDevice, int iSubdevice, double* pdValue, int* piCount, int iTimeout);
+/**
+	@brief Close session. Armed stream is stopped.
+*/
+int meScanSessionClose(int iDevice, int iSubdevice);
+
 /**
 	@brief Extended version of meIOStreamRead(). Timeout added.
 */
@@ -122,6 +235,20 @@ int CheckMeSubdeviceCaps(int iDevice, int iSubdevice, int iCaps);
 */
 int CheckMeSubdeviceTypeListAndCaps(int iDevice, int iSubdevice, meTypeList_t TypesList, int iCaps);
 
+/**
+	@brief Start recording of configured AI stream to file. Recorder's thread drains stream, samples are stored as 16-bit values.
+	@note Stream has to be configured and started by application. Only ranges with iMaxData up to 0xFFFF are supported.
+*/
+int meRecordStart(int iDevice, int iSubdevice, char* pcPath, meRecordOptions_t* pOptions);
+/**
+	@brief Current statistics of recorder.
+*/
+int meRecordStatus(int iDevice, int iSubdevice, meRecordStatus_t* pStatus);
+/**
+	@brief Stop recorder. Data already read is written, file header is updated. pStatus can be NULL.
+*/
+int meRecordStop(int iDevice, int iSubdevice, meRecordStatus_t* pStatus);
+
 /**
 	@brief Set default timeout for connecting to remote devices (in ms).
 */